@@ -103,12 +103,28 @@ union __ldmath
 
 #endif /* !gcc >= 3.3  */
 
+/* With -ffast-math, let GCC vectorize loops calling the functions marked
+   with __DECL_SIMD, using the vector versions in libm/machine.  Cygwin's
+   libm does not export them.  */
+#if defined (__FAST_MATH__) && !defined (__CYGWIN__) \
+    && (defined (__x86_64__) \
+	|| (defined (__aarch64__) && __GNUC_PREREQ (9, 0)))
+# if defined (_OPENMP) && _OPENMP >= 201307
+#  define __DECL_SIMD _Pragma ("omp declare simd notinbranch")
+# elif __GNUC_PREREQ (6, 0)
+#  define __DECL_SIMD __attribute__ ((__simd__ ("notinbranch")))
+# endif
+#endif
+#ifndef __DECL_SIMD
+# define __DECL_SIMD
+#endif
+
 /* Reentrant ANSI C functions.  */
 
 #ifndef __math_68881
 extern double atan _PARAMS((double));
-extern double cos _PARAMS((double));
-extern double sin _PARAMS((double));
+__DECL_SIMD extern double cos _PARAMS((double));
+__DECL_SIMD extern double sin _PARAMS((double));
 extern double tan _PARAMS((double));
 extern double tanh _PARAMS((double));
 extern double frexp _PARAMS((double, int *));
@@ -127,11 +143,11 @@ extern double asin _PARAMS((double));
 extern double atan2 _PARAMS((double, double));
 extern double cosh _PARAMS((double));
 extern double sinh _PARAMS((double));
-extern double exp _PARAMS((double));
+__DECL_SIMD extern double exp _PARAMS((double));
 extern double ldexp _PARAMS((double, int));
-extern double log _PARAMS((double));
+__DECL_SIMD extern double log _PARAMS((double));
 extern double log10 _PARAMS((double));
-extern double pow _PARAMS((double, double));
+__DECL_SIMD extern double pow _PARAMS((double, double));
 extern double sqrt _PARAMS((double));
 extern double fmod _PARAMS((double, double));
 #endif /* ! defined (__math_68881) */
@@ -365,8 +381,8 @@ extern double hypot _PARAMS((double, double));
 /* Single precision versions of ANSI functions.  */
 
 extern float atanf _PARAMS((float));
-extern float cosf _PARAMS((float));
-extern float sinf _PARAMS((float));
+__DECL_SIMD extern float cosf _PARAMS((float));
+__DECL_SIMD extern float sinf _PARAMS((float));
 extern float tanf _PARAMS((float));
 extern float tanhf _PARAMS((float));
 extern float frexpf _PARAMS((float, int *));
@@ -381,9 +397,9 @@ extern float asinf _PARAMS((float));
 extern float atan2f _PARAMS((float, float));
 extern float coshf _PARAMS((float));
 extern float sinhf _PARAMS((float));
-extern float expf _PARAMS((float));
+__DECL_SIMD extern float expf _PARAMS((float));
 extern float ldexpf _PARAMS((float, int));
-extern float logf _PARAMS((float));
+__DECL_SIMD extern float logf _PARAMS((float));
 extern float log10f _PARAMS((float));
 extern float powf _PARAMS((float, float));
 extern float sqrtf _PARAMS((float));
@@ -518,6 +534,42 @@ extern _LONG_DOUBLE rintl _PARAMS((_LONG_DOUBLE));
 extern long int lrintl _PARAMS((_LONG_DOUBLE));
 extern long long int llrintl _PARAMS((_LONG_DOUBLE));
 #endif /* __i386__ */
+#ifdef __x86_64__
+/* Long double functions computed with the x87 unit.  */
+extern long double acosl _PARAMS((long double));
+extern long double asinl _PARAMS((long double));
+extern long double atanl _PARAMS((long double));
+extern long double atan2l _PARAMS((long double, long double));
+extern long double cosl _PARAMS((long double));
+extern long double sinl _PARAMS((long double));
+extern long double tanl _PARAMS((long double));
+extern long double coshl _PARAMS((long double));
+extern long double sinhl _PARAMS((long double));
+extern long double tanhl _PARAMS((long double));
+extern long double expl _PARAMS((long double));
+extern long double exp2l _PARAMS((long double));
+extern long double expm1l _PARAMS((long double));
+extern long double logl _PARAMS((long double));
+extern long double log2l _PARAMS((long double));
+extern long double log10l _PARAMS((long double));
+extern long double log1pl _PARAMS((long double));
+extern long double powl _PARAMS((long double, long double));
+extern long double fabsl _PARAMS((long double));
+extern long double copysignl _PARAMS((long double, long double));
+extern long double ceill _PARAMS((long double));
+extern long double floorl _PARAMS((long double));
+extern long double truncl _PARAMS((long double));
+extern long double roundl _PARAMS((long double));
+extern long double rintl _PARAMS((long double));
+extern long double nearbyintl _PARAMS((long double));
+extern long int lrintl _PARAMS((long double));
+extern long long int llrintl _PARAMS((long double));
+extern long double frexpl _PARAMS((long double, int *));
+extern long double ldexpl _PARAMS((long double, int));
+extern long double scalbnl _PARAMS((long double, int));
+extern long double fmodl _PARAMS((long double, long double));
+extern long double remainderl _PARAMS((long double, long double));
+#endif /* __x86_64__ */
 #endif /* !_LDBL_EQ_DBL && !__CYGWIN__ */
 
 #endif /* __ISO_C_VISIBLE >= 1999 */
@@ -552,9 +604,22 @@ extern float j1f _PARAMS((float));
 extern float jnf _PARAMS((int, float));
 #endif
 
+#if __MISC_VISIBLE && !defined (__CYGWIN__)
+/* Bessel functions of all the orders 0 to n at one x, or of one order
+   at each of count values of x.  cygwin1.dll does not export them.  */
+extern void jn_orders _PARAMS((int, double, double *));
+extern void yn_orders _PARAMS((int, double, double *));
+extern void jn_array _PARAMS((int, const double *, double *, int));
+extern void yn_array _PARAMS((int, const double *, double *, int));
+extern void jnf_orders _PARAMS((int, float, float *));
+extern void ynf_orders _PARAMS((int, float, float *));
+extern void jnf_array _PARAMS((int, const float *, float *, int));
+extern void ynf_array _PARAMS((int, const float *, float *, int));
+#endif
+
 /* GNU extensions */
 #if __GNU_VISIBLE
-extern void sincos _PARAMS((double, double *, double *));
+__DECL_SIMD extern void sincos _PARAMS((double, double *, double *));
 extern void sincosf _PARAMS((float, float *, float *));
 #ifdef __CYGWIN__
 extern void sincosl _PARAMS((long double, long double *, long double *));
@@ -224,6 +224,8 @@ const struct __locale_t __C_locale =
   { "C", "C", "C", "C", "C", "C", "C", },
   __ascii_wctomb,
   __ascii_mbtowc,
+  __ascii_mbsnrtowcs,
+  __ascii_wcsnrtombs,
   0,
   DEFAULT_CTYPE_PTR,
   {
@@ -261,9 +263,13 @@ struct __locale_t __global_locale =
 #ifdef __CYGWIN__
   __utf8_wctomb,
   __utf8_mbtowc,
+  __utf8_mbsnrtowcs,
+  __utf8_wcsnrtombs,
 #else
   __ascii_wctomb,
   __ascii_mbtowc,
+  __ascii_mbsnrtowcs,
+  __ascii_wcsnrtombs,
 #endif
   0,
   DEFAULT_CTYPE_PTR,
@@ -496,6 +502,8 @@ __loadlocale (struct __locale_t *loc, int category, const char *new_locale)
   int mbc_max;
   wctomb_p l_wctomb;
   mbtowc_p l_mbtowc;
+  mbsnrtowcs_p l_mbsnrtowcs;
+  wcsnrtombs_p l_wcsnrtombs;
   int cjknarrow = 0;
 
   /* Avoid doing everything twice if nothing has changed. */
@@ -623,6 +631,8 @@ restart:
       mbc_max = 6;
       l_wctomb = __utf8_wctomb;
       l_mbtowc = __utf8_mbtowc;
+      l_mbsnrtowcs = __utf8_mbsnrtowcs;
+      l_wcsnrtombs = __utf8_wcsnrtombs;
     break;
 #ifndef __CYGWIN__
     /* Cygwin does not support JIS at all. */
@@ -634,6 +644,8 @@ restart:
       mbc_max = 8;
       l_wctomb = __jis_wctomb;
       l_mbtowc = __jis_mbtowc;
+      l_mbsnrtowcs = NULL;
+      l_wcsnrtombs = NULL;
     break;
 #endif /* !__CYGWIN__ */
     case 'E':
@@ -649,6 +661,13 @@ restart:
 	  mbc_max = 3;
 	  l_wctomb = __eucjp_wctomb;
 	  l_mbtowc = __eucjp_mbtowc;
+#ifdef __CYGWIN__
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
+#else
+	  l_mbsnrtowcs = __eucjp_mbsnrtowcs;
+	  l_wcsnrtombs = __eucjp_wcsnrtombs;
+#endif
 	}
 #ifdef __CYGWIN__
       /* Newlib does neither provide EUC-KR nor EUC-CN, and Cygwin's
@@ -659,6 +678,8 @@ restart:
 	  mbc_max = 2;
 	  l_wctomb = __kr_wctomb;
 	  l_mbtowc = __kr_mbtowc;
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
 	}
       else if (!strcasecmp (c, "CN"))
 	{
@@ -666,6 +687,8 @@ restart:
 	  mbc_max = 2;
 	  l_wctomb = __gbk_wctomb;
 	  l_mbtowc = __gbk_mbtowc;
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
 	}
 #endif /* __CYGWIN__ */
       else
@@ -679,6 +702,13 @@ restart:
       mbc_max = 2;
       l_wctomb = __sjis_wctomb;
       l_mbtowc = __sjis_mbtowc;
+#ifdef __CYGWIN__
+      l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+      l_wcsnrtombs = __ascii7_wcsnrtombs;
+#else
+      l_mbsnrtowcs = __sjis_mbsnrtowcs;
+      l_wcsnrtombs = __sjis_wcsnrtombs;
+#endif
     break;
     case 'I':
     case 'i':
@@ -707,9 +737,13 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_ISO
       l_wctomb = __iso_wctomb (val);
       l_mbtowc = __iso_mbtowc (val);
+      l_mbsnrtowcs = __iso_mbsnrtowcs (val);
+      l_wcsnrtombs = __iso_wcsnrtombs (val);
 #else /* !_MB_EXTENDED_CHARSETS_ISO */
       l_wctomb = __ascii_wctomb;
       l_mbtowc = __ascii_mbtowc;
+      l_mbsnrtowcs = __ascii_mbsnrtowcs;
+      l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_ISO */
     break;
     case 'C':
@@ -748,15 +782,26 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
 	  l_wctomb = __cp_wctomb (val);
 	  l_mbtowc = __cp_mbtowc (val);
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
 #else /* !_MB_EXTENDED_CHARSETS_WINDOWS */
 	  l_wctomb = __ascii_wctomb;
 	  l_mbtowc = __ascii_mbtowc;
+	  l_mbsnrtowcs = __ascii_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_WINDOWS */
 	  break;
 	case 932:
 	  mbc_max = 2;
 	  l_wctomb = __sjis_wctomb;
 	  l_mbtowc = __sjis_mbtowc;
+#ifdef __CYGWIN__
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
+#else
+	  l_mbsnrtowcs = __sjis_mbsnrtowcs;
+	  l_wcsnrtombs = __sjis_wcsnrtombs;
+#endif
 	  break;
 	default:
 	  FAIL;
@@ -786,9 +831,13 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
       l_wctomb = __cp_wctomb (val);
       l_mbtowc = __cp_mbtowc (val);
+      l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+      l_wcsnrtombs = __ascii7_wcsnrtombs;
 #else /* !_MB_EXTENDED_CHARSETS_WINDOWS */
       l_wctomb = __ascii_wctomb;
       l_mbtowc = __ascii_mbtowc;
+      l_mbsnrtowcs = __ascii_mbsnrtowcs;
+      l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_WINDOWS */
       break;
     case 'A':
@@ -799,6 +848,8 @@ restart:
       mbc_max = 1;
       l_wctomb = __ascii_wctomb;
       l_mbtowc = __ascii_mbtowc;
+      l_mbsnrtowcs = __ascii_mbsnrtowcs;
+      l_wcsnrtombs = __ascii_wcsnrtombs;
       break;
     case 'G':
     case 'g':
@@ -812,6 +863,8 @@ restart:
 	  mbc_max = 2;
 	  l_wctomb = __gbk_wctomb;
 	  l_mbtowc = __gbk_mbtowc;
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
 	}
       else
 #endif /* __CYGWIN__ */
@@ -829,9 +882,13 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
 	  l_wctomb = __cp_wctomb (val);
 	  l_mbtowc = __cp_mbtowc (val);
+	  l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii7_wcsnrtombs;
 #else /* !_MB_EXTENDED_CHARSETS_WINDOWS */
 	  l_wctomb = __ascii_wctomb;
 	  l_mbtowc = __ascii_mbtowc;
+	  l_mbsnrtowcs = __ascii_mbsnrtowcs;
+	  l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_WINDOWS */
 	}
       else
@@ -848,9 +905,13 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
       l_wctomb = __cp_wctomb (val);
       l_mbtowc = __cp_mbtowc (val);
+      l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+      l_wcsnrtombs = __ascii7_wcsnrtombs;
 #else /* !_MB_EXTENDED_CHARSETS_WINDOWS */
       l_wctomb = __ascii_wctomb;
       l_mbtowc = __ascii_mbtowc;
+      l_mbsnrtowcs = __ascii_mbsnrtowcs;
+      l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_WINDOWS */
       break;
     case 'T':
@@ -868,9 +929,13 @@ restart:
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
       l_wctomb = __cp_wctomb (val);
       l_mbtowc = __cp_mbtowc (val);
+      l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+      l_wcsnrtombs = __ascii7_wcsnrtombs;
 #else /* !_MB_EXTENDED_CHARSETS_WINDOWS */
       l_wctomb = __ascii_wctomb;
       l_mbtowc = __ascii_mbtowc;
+      l_mbsnrtowcs = __ascii_mbsnrtowcs;
+      l_wcsnrtombs = __ascii_wcsnrtombs;
 #endif /* _MB_EXTENDED_CHARSETS_WINDOWS */
       break;
 #ifdef __CYGWIN__
@@ -884,6 +949,8 @@ restart:
       mbc_max = 2;
       l_wctomb = __big5_wctomb;
       l_mbtowc = __big5_mbtowc;
+      l_mbsnrtowcs = __ascii7_mbsnrtowcs;
+      l_wcsnrtombs = __ascii7_wcsnrtombs;
       break;
 #endif /* __CYGWIN__ */
     default:
@@ -901,6 +968,8 @@ restart:
 #endif
       loc->wctomb = l_wctomb;
       loc->mbtowc = l_mbtowc;
+      loc->mbsnrtowcs = l_mbsnrtowcs;
+      loc->wcsnrtombs = l_wcsnrtombs;
       __set_ctype (loc, charset);
       /* Determine the width for the "CJK Ambiguous Width" category of
          characters. This is used in wcwidth(). Assume single width for
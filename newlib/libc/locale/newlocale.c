@@ -146,6 +146,8 @@ _newlocale_r (struct _reent *p, int category_mask, const char *locale,
 	    {
 	      tmp_locale.wctomb = base->wctomb;
 	      tmp_locale.mbtowc = base->mbtowc;
+	      tmp_locale.mbsnrtowcs = base->mbsnrtowcs;
+	      tmp_locale.wcsnrtombs = base->wcsnrtombs;
 	      tmp_locale.cjk_lang = base->cjk_lang;
 	      tmp_locale.ctype_ptr - base->ctype_ptr;
 	    }
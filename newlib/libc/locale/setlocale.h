@@ -182,6 +182,10 @@ struct __locale_t
 				   mbstate_t *);
   int			(*mbtowc) (struct _reent *, wchar_t *,
 				   const char *, size_t, mbstate_t *);
+  size_t		(*mbsnrtowcs) (wchar_t *, const char **, size_t,
+				       size_t);
+  size_t		(*wcsnrtombs) (char *, const wchar_t **, size_t,
+				       size_t);
   int			 cjk_lang;
   char			*ctype_ptr;
   struct lconv		 lconv;
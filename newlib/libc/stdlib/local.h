@@ -52,6 +52,46 @@ mbtowc_f __big5_mbtowc;
 
 #define __MBTOWC (__get_current_locale ()->mbtowc)
 
+/* Bulk conversion kernels, registered in the locale alongside the above
+   per-character functions.  A kernel converts the longest prefix of *src
+   which it can handle in the initial shift state, reading at most nms
+   bytes (resp. wide chars) and storing at most len wide chars (resp.
+   bytes) in dst, unless dst is NULL.  It stops in front of the terminating
+   NUL and in front of anything the per-character function has to handle,
+   i.e. errors, incomplete and stateful sequences.  *src is advanced past
+   the converted input, the return value is the number of wide chars
+   (resp. bytes) produced. */
+typedef size_t mbsnrtowcs_f (wchar_t *, const char **, size_t, size_t);
+typedef mbsnrtowcs_f *mbsnrtowcs_p;
+
+mbsnrtowcs_f __ascii_mbsnrtowcs;
+#ifdef _MB_CAPABLE
+mbsnrtowcs_f __ascii7_mbsnrtowcs;
+mbsnrtowcs_f __utf8_mbsnrtowcs;
+#ifndef __CYGWIN__
+mbsnrtowcs_f __sjis_mbsnrtowcs;
+mbsnrtowcs_f __eucjp_mbsnrtowcs;
+#endif
+mbsnrtowcs_p __iso_mbsnrtowcs (int val);
+#endif
+
+typedef size_t wcsnrtombs_f (char *, const wchar_t **, size_t, size_t);
+typedef wcsnrtombs_f *wcsnrtombs_p;
+
+wcsnrtombs_f __ascii_wcsnrtombs;
+#ifdef _MB_CAPABLE
+wcsnrtombs_f __ascii7_wcsnrtombs;
+wcsnrtombs_f __utf8_wcsnrtombs;
+#ifndef __CYGWIN__
+wcsnrtombs_f __sjis_wcsnrtombs;
+wcsnrtombs_f __eucjp_wcsnrtombs;
+#endif
+wcsnrtombs_p __iso_wcsnrtombs (int val);
+#endif
+
+#define __MBSNRTOWCS (__get_current_locale ()->mbsnrtowcs)
+#define __WCSNRTOMBS (__get_current_locale ()->wcsnrtombs)
+
 extern wchar_t __iso_8859_conv[14][0x60];
 int __iso_8859_val_index (int);
 int __iso_8859_index (const char *);
@@ -102,6 +102,7 @@ PORTABILITY
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include "local.h"
 
 size_t
 _DEFUN (_mbsnrtowcs_r, (r, dst, src, nms, len, ps), 
@@ -138,6 +139,21 @@ _DEFUN (_mbsnrtowcs_r, (r, dst, src, nms, len, ps),
   max = len;
   while (len > 0)
     {
+      /* Let the charset's bulk converter handle as much as possible, and
+	 only go through mbrtowc for what it leaves over. */
+      if (__MBSNRTOWCS && (ps == NULL || ps->__count == 0))
+	{
+	  const char *start = *src;
+	  size_t n = __MBSNRTOWCS (ptr, src, nms, len);
+
+	  nms -= *src - start;
+	  count += n;
+	  len -= n;
+	  if (ptr)
+	    ptr += n;
+	  if (len == 0)
+	    break;
+	}
       bytes = _mbrtowc_r (r, ptr, *src, nms, ps);
       if (bytes > 0)
 	{
@@ -18,6 +18,22 @@ _DEFUN (_mbstowcs_r, (reent, pwcs, s, n, state),
     n = (size_t) 1; /* Value doesn't matter as long as it's not 0. */
   while (n > 0)
     {
+      if (__MBSNRTOWCS && state->__count == 0)
+	{
+	  const char *tmp = t;
+	  size_t cnt = __MBSNRTOWCS (pwcs, &tmp, (size_t) -1,
+				     pwcs ? n : (size_t) -1);
+
+	  t = (char *) tmp;
+	  ret += cnt;
+	  if (pwcs)
+	    {
+	      pwcs += cnt;
+	      n -= cnt;
+	      if (n == 0)
+		break;
+	    }
+	}
       bytes = __MBTOWC (r, pwcs, t, MB_CUR_MAX, state);
       if (bytes < 0)
 	{
@@ -5,6 +5,7 @@
 #include <wchar.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 #include "local.h"
 
 int
@@ -54,7 +55,93 @@ _DEFUN (__ascii_mbtowc, (r, pwc, s, n, state),
   return 1;
 }
 
+#define LBLOCKSIZE   (sizeof (long))
+#define UNALIGNED(X) ((long)(X) & (LBLOCKSIZE - 1))
+
+#if LONG_MAX == 2147483647L
+#define DETECTNULL(X) (((X) - 0x01010101) & ~(X) & 0x80808080)
+#define DETECTHIGH(X) ((X) & 0x80808080)
+#else
+#if LONG_MAX == 9223372036854775807L
+#define DETECTNULL(X) (((X) - 0x0101010101010101) & ~(X) & 0x8080808080808080)
+#define DETECTHIGH(X) ((X) & 0x8080808080808080)
+#else
+#error long int is not a 32bit or 64bit type.
+#endif
+#endif
+
+/* Store the leading run of 7 bit ASCII chars other than NUL in the first
+   n bytes of t as wide chars in dst, unless dst is NULL.  Returns the
+   length of the run.  Checks a word at a time to find the end of the run,
+   since that's the most common input by far. */
+static size_t
+__ascii7_run (wchar_t *dst, const unsigned char *t, size_t n)
+{
+  size_t i = 0;
+
+#if !defined(PREFER_SIZE_OVER_SPEED) && !defined(__OPTIMIZE_SIZE__)
+  while (i < n && UNALIGNED (t + i))
+    {
+      if (t[i] == '\0' || t[i] >= 0x80)
+	return i;
+      if (dst)
+	dst[i] = (wchar_t) t[i];
+      ++i;
+    }
+  while (n - i >= LBLOCKSIZE)
+    {
+      unsigned long w = *(const unsigned long *) (t + i);
+      size_t j;
+
+      if (DETECTHIGH (w) || DETECTNULL (w))
+	break;
+      if (dst)
+	for (j = 0; j < LBLOCKSIZE; ++j)
+	  dst[i + j] = (wchar_t) t[i + j];
+      i += LBLOCKSIZE;
+    }
+#endif /* !PREFER_SIZE_OVER_SPEED */
+  while (i < n && t[i] != '\0' && t[i] < 0x80)
+    {
+      if (dst)
+	dst[i] = (wchar_t) t[i];
+      ++i;
+    }
+  return i;
+}
+
+size_t
+__ascii_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len)
+{
+  const unsigned char *t = (const unsigned char *) *src;
+  size_t n = nms < len ? nms : len;
+  size_t cnt;
+
+  cnt = __ascii7_run (dst, t, n);
+#ifndef __CYGWIN__
+  /* Non-Cygwin targets map all 8 bit values 1:1 in the "C" locale. */
+  while (cnt < n && t[cnt] != '\0')
+    {
+      if (dst)
+	dst[cnt] = (wchar_t) t[cnt];
+      ++cnt;
+    }
+#endif
+  *src += cnt;
+  return cnt;
+}
+
 #ifdef _MB_CAPABLE
+size_t
+__ascii7_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len)
+{
+  size_t cnt;
+
+  cnt = __ascii7_run (dst, (const unsigned char *) *src, nms < len ? nms : len);
+  *src += cnt;
+  return cnt;
+}
+
 typedef enum { ESCAPE, DOLLAR, BRACKET, AT, B, J, 
                NUL, JIS_CHAR, OTHER, JIS_C_NUM } JIS_CHAR_TYPE;
 typedef enum { ASCII, JIS, A_ESC, A_ESC_DL, JIS_1, J_ESC, J_ESC_BR,
@@ -266,6 +353,165 @@ __iso_mbtowc (int val)
 {
   return __iso_8859_mbtowc[val];
 }
+
+static size_t
+___iso_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len,
+		   int iso_idx)
+{
+  const unsigned char *t = (const unsigned char *) *src;
+  size_t n = nms < len ? nms : len;
+  size_t cnt;
+  wchar_t wc;
+
+  cnt = __ascii7_run (dst, t, n);
+  for (; cnt < n && t[cnt] != '\0'; ++cnt)
+    {
+      wc = (wchar_t) t[cnt];
+      if (t[cnt] >= 0xa0 && iso_idx >= 0)
+	{
+	  wc = __iso_8859_conv[iso_idx][t[cnt] - 0xa0];
+	  if (wc == 0) /* Invalid character, let mbtowc handle it. */
+	    break;
+	}
+      if (dst)
+	dst[cnt] = wc;
+    }
+  *src += cnt;
+  return cnt;
+}
+
+static size_t
+__iso_8859_1_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, -1);
+}
+
+static size_t
+__iso_8859_2_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 0);
+}
+
+static size_t
+__iso_8859_3_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 1);
+}
+
+static size_t
+__iso_8859_4_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 2);
+}
+
+static size_t
+__iso_8859_5_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 3);
+}
+
+static size_t
+__iso_8859_6_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 4);
+}
+
+static size_t
+__iso_8859_7_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 5);
+}
+
+static size_t
+__iso_8859_8_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 6);
+}
+
+static size_t
+__iso_8859_9_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			 size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 7);
+}
+
+static size_t
+__iso_8859_10_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 8);
+}
+
+static size_t
+__iso_8859_11_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 9);
+}
+
+static size_t
+__iso_8859_13_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 10);
+}
+
+static size_t
+__iso_8859_14_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 11);
+}
+
+static size_t
+__iso_8859_15_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 12);
+}
+
+static size_t
+__iso_8859_16_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms,
+			  size_t len)
+{
+  return ___iso_mbsnrtowcs (dst, src, nms, len, 13);
+}
+
+static mbsnrtowcs_p __iso_8859_mbsnrtowcs[17] = {
+  NULL,
+  __iso_8859_1_mbsnrtowcs,
+  __iso_8859_2_mbsnrtowcs,
+  __iso_8859_3_mbsnrtowcs,
+  __iso_8859_4_mbsnrtowcs,
+  __iso_8859_5_mbsnrtowcs,
+  __iso_8859_6_mbsnrtowcs,
+  __iso_8859_7_mbsnrtowcs,
+  __iso_8859_8_mbsnrtowcs,
+  __iso_8859_9_mbsnrtowcs,
+  __iso_8859_10_mbsnrtowcs,
+  __iso_8859_11_mbsnrtowcs,
+  NULL,			/* No ISO 8859-12 */
+  __iso_8859_13_mbsnrtowcs,
+  __iso_8859_14_mbsnrtowcs,
+  __iso_8859_15_mbsnrtowcs,
+  __iso_8859_16_mbsnrtowcs
+};
+
+/* val *MUST* be valid!  All checks for validity are supposed to be
+   performed before calling this function. */
+mbsnrtowcs_p
+__iso_mbsnrtowcs (int val)
+{
+  return __iso_8859_mbsnrtowcs[val];
+}
 #endif /* _MB_EXTENDED_CHARSETS_ISO */
 
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
@@ -726,6 +972,64 @@ _DEFUN (__utf8_mbtowc, (r, pwc, s, n, state),
   return -1;
 }
 
+size_t
+__utf8_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len)
+{
+  const unsigned char *t = (const unsigned char *) *src;
+  size_t cnt = 0;
+  size_t n;
+  wint_t ch;
+
+  while (cnt < len && nms > 0)
+    {
+      /* Most input is plain ASCII, so convert runs of it in one go. */
+      n = __ascii7_run (dst ? dst + cnt : NULL, t,
+			nms < len - cnt ? nms : len - cnt);
+      t += n;
+      nms -= n;
+      cnt += n;
+      if (cnt >= len || nms == 0)
+	break;
+      ch = *t;
+      if (ch >= 0xc2 && ch <= 0xdf)
+	{
+	  if (nms < 2 || (t[1] & 0xc0) != 0x80)
+	    break;
+	  ch = ((ch & 0x1f) << 6) | (t[1] & 0x3f);
+	  n = 2;
+	}
+      else if (ch >= 0xe0 && ch <= 0xef)
+	{
+	  if (nms < 3 || (t[1] & 0xc0) != 0x80 || (t[2] & 0xc0) != 0x80
+	      || (ch == 0xe0 && t[1] < 0xa0))
+	    break;
+	  ch = ((ch & 0x0f) << 12) | ((t[1] & 0x3f) << 6) | (t[2] & 0x3f);
+	  n = 3;
+	}
+      /* Leave four-byte sequences to __utf8_mbtowc if they have to be
+	 split into UTF-16 surrogate pairs. */
+      else if (sizeof (wchar_t) == 4 && ch >= 0xf0 && ch <= 0xf4)
+	{
+	  if (nms < 4 || (t[1] & 0xc0) != 0x80 || (t[2] & 0xc0) != 0x80
+	      || (t[3] & 0xc0) != 0x80
+	      || (ch == 0xf0 && t[1] < 0x90) || (ch == 0xf4 && t[1] >= 0x90))
+	    break;
+	  ch = ((ch & 0x07) << 18) | ((t[1] & 0x3f) << 12)
+	       | ((t[2] & 0x3f) << 6) | (t[3] & 0x3f);
+	  n = 4;
+	}
+      else
+	break;
+      if (dst)
+	dst[cnt] = (wchar_t) ch;
+      ++cnt;
+      t += n;
+      nms -= n;
+    }
+  *src = (const char *) t;
+  return cnt;
+}
+
 /* Cygwin defines its own doublebyte charset conversion functions 
    because the underlying OS requires wchar_t == UTF-16. */
 #ifndef  __CYGWIN__
@@ -786,6 +1090,38 @@ _DEFUN (__sjis_mbtowc, (r, pwc, s, n, state),
   return 1;
 }
 
+size_t
+__sjis_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len)
+{
+  const unsigned char *t = (const unsigned char *) *src;
+  size_t cnt = 0;
+  size_t n;
+  wchar_t wc;
+
+  while (cnt < len && nms > 0 && *t != '\0')
+    {
+      if (_issjis1 (*t))
+	{
+	  if (nms < 2 || !_issjis2 (t[1]))
+	    break;
+	  wc = (((wchar_t) t[0]) << 8) + (wchar_t) t[1];
+	  n = 2;
+	}
+      else
+	{
+	  wc = (wchar_t) *t;
+	  n = 1;
+	}
+      if (dst)
+	dst[cnt] = wc;
+      ++cnt;
+      t += n;
+      nms -= n;
+    }
+  *src = (const char *) t;
+  return cnt;
+}
+
 int
 _DEFUN (__eucjp_mbtowc, (r, pwc, s, n, state),
         struct _reent *r       _AND
@@ -869,6 +1205,45 @@ _DEFUN (__eucjp_mbtowc, (r, pwc, s, n, state),
   return 1;
 }
 
+size_t
+__eucjp_mbsnrtowcs (wchar_t *dst, const char **src, size_t nms, size_t len)
+{
+  const unsigned char *t = (const unsigned char *) *src;
+  size_t cnt = 0;
+  size_t n;
+  wchar_t wc;
+
+  while (cnt < len && nms > 0 && *t != '\0')
+    {
+      if (*t == 0x8f)
+	{
+	  if (nms < 3 || !_iseucjp2 (t[1]) || !_iseucjp2 (t[2]))
+	    break;
+	  wc = (((wchar_t) t[1]) << 8) + (wchar_t) (t[2] & 0x7f);
+	  n = 3;
+	}
+      else if (_iseucjp1 (*t))
+	{
+	  if (nms < 2 || !_iseucjp2 (t[1]))
+	    break;
+	  wc = (((wchar_t) t[0]) << 8) + (wchar_t) t[1];
+	  n = 2;
+	}
+      else
+	{
+	  wc = (wchar_t) *t;
+	  n = 1;
+	}
+      if (dst)
+	dst[cnt] = wc;
+      ++cnt;
+      t += n;
+      nms -= n;
+    }
+  *src = (const char *) t;
+  return cnt;
+}
+
 int
 _DEFUN (__jis_mbtowc, (r, pwc, s, n, state),
         struct _reent *r       _AND
@@ -114,6 +114,8 @@ _wcsnrtombs_l (struct _reent *r, char *dst, const wchar_t **src, size_t nwc,
   wchar_t *pwcs;
   size_t n;
   int i;
+  int count, bytes;
+  wint_t wch;
 
 #ifdef _MB_CAPABLE
   if (ps == NULL)
@@ -130,11 +132,30 @@ _wcsnrtombs_l (struct _reent *r, char *dst, const wchar_t **src, size_t nwc,
   n = 0;
   pwcs = (wchar_t *)(*src);
 
-  while (n < len && nwc-- > 0)
+  while (n < len && nwc > 0)
     {
-      int count = ps->__count;
-      wint_t wch = ps->__value.__wch;
-      int bytes = loc->wctomb (r, buff, *pwcs, ps);
+      /* Let the charset's bulk converter handle as much as possible, and
+	 only go through wctomb for what it leaves over. */
+      if (loc->wcsnrtombs && ps->__count == 0)
+	{
+	  const wchar_t *start = pwcs;
+	  size_t cnt = loc->wcsnrtombs (ptr, &start, nwc, len - n);
+
+	  nwc -= start - pwcs;
+	  pwcs = (wchar_t *) start;
+	  n += cnt;
+	  if (dst)
+	    {
+	      ptr += cnt;
+	      *src = pwcs;
+	    }
+	  if (n >= len || nwc == 0)
+	    break;
+	}
+      --nwc;
+      count = ps->__count;
+      wch = ps->__value.__wch;
+      bytes = loc->wctomb (r, buff, *pwcs, ps);
       if (bytes == -1)
 	{
 	  r->_errno = EILSEQ;
@@ -20,6 +20,15 @@ _DEFUN (_wcstombs_r, (reent, s, pwcs, n, state),
       size_t num_bytes = 0;
       while (*pwcs != 0)
 	{
+	  if (__WCSNRTOMBS && state->__count == 0)
+	    {
+	      const wchar_t *tmp = pwcs;
+
+	      num_bytes += __WCSNRTOMBS (NULL, &tmp, (size_t) -1, (size_t) -1);
+	      pwcs = tmp;
+	      if (*pwcs == 0)
+		break;
+	    }
 	  bytes = __WCTOMB (r, buff, *pwcs++, state);
 	  if (bytes == -1)
 	    return -1;
@@ -31,6 +40,17 @@ _DEFUN (_wcstombs_r, (reent, s, pwcs, n, state),
     {
       while (n > 0)
         {
+	  if (__WCSNRTOMBS && state->__count == 0)
+	    {
+	      const wchar_t *tmp = pwcs;
+	      size_t cnt = __WCSNRTOMBS (ptr, &tmp, (size_t) -1, n);
+
+	      pwcs = tmp;
+	      ptr += cnt;
+	      n -= cnt;
+	      if (n == 0)
+		break;
+	    }
           bytes = __WCTOMB (r, buff, *pwcs, state);
           if (bytes == -1)
             return -1;
@@ -45,7 +45,44 @@ _DEFUN (__ascii_wctomb, (r, s, wchar, state),
   return 1;
 }
 
+/* Store the leading run of wide chars in the range [1,max] from src as
+   single bytes in dst, unless dst is NULL.  Returns the length of the run. */
+static size_t
+__sb_run (char *dst, const wchar_t *src, size_t n, wint_t max)
+{
+  size_t i;
+
+  for (i = 0; i < n && (wint_t) src[i] - 1 < max; ++i)
+    if (dst)
+      dst[i] = (char) src[i];
+  return i;
+}
+
+size_t
+__ascii_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc, size_t len)
+{
+  size_t cnt;
+
+#ifdef __CYGWIN__
+  cnt = __sb_run (dst, *src, nwc < len ? nwc : len, 0x7f);
+#else
+  cnt = __sb_run (dst, *src, nwc < len ? nwc : len, 0xff);
+#endif
+  *src += cnt;
+  return cnt;
+}
+
 #ifdef _MB_CAPABLE
+size_t
+__ascii7_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc, size_t len)
+{
+  size_t cnt;
+
+  cnt = __sb_run (dst, *src, nwc < len ? nwc : len, 0x7f);
+  *src += cnt;
+  return cnt;
+}
+
 /* for some conversions, we use the __count field as a place to store a state value */
 #define __state __count
 
@@ -140,6 +177,66 @@ _DEFUN (__utf8_wctomb, (r, s, wchar, state),
   return -1;
 }
 
+size_t
+__utf8_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc, size_t len)
+{
+  const wchar_t *pwcs = *src;
+  size_t cnt = 0;
+  size_t n;
+  wint_t wchar;
+
+  while (nwc > 0 && cnt < len)
+    {
+      n = __sb_run (dst ? dst + cnt : NULL, pwcs,
+		    nwc < len - cnt ? nwc : len - cnt, 0x7f);
+      pwcs += n;
+      nwc -= n;
+      cnt += n;
+      if (nwc == 0 || cnt >= len)
+	break;
+      wchar = *pwcs;
+      if (wchar >= 0x80 && wchar <= 0x7ff)
+	n = 2;
+      /* Surrogates are left to __utf8_wctomb, which keeps track of
+	 surrogate pairs in the mbstate. */
+      else if (wchar >= 0x800 && wchar <= 0xffff
+	       && (sizeof (wchar_t) == 4 || wchar < 0xd800 || wchar > 0xdfff))
+	n = 3;
+      else if (wchar >= 0x10000 && wchar <= 0x10ffff)
+	n = 4;
+      else
+	break;
+      if (len - cnt < n)
+	break;
+      if (dst)
+	{
+	  char *s = dst + cnt;
+
+	  switch (n)
+	    {
+	    case 2:
+	      *s++ = 0xc0 | ((wchar & 0x7c0) >> 6);
+	      break;
+	    case 3:
+	      *s++ = 0xe0 | ((wchar & 0xf000) >> 12);
+	      *s++ = 0x80 | ((wchar &  0xfc0) >> 6);
+	      break;
+	    case 4:
+	      *s++ = 0xf0 | ((wchar & 0x1c0000) >> 18);
+	      *s++ = 0x80 | ((wchar &  0x3f000) >> 12);
+	      *s++ = 0x80 | ((wchar &    0xfc0) >> 6);
+	      break;
+	    }
+	  *s = 0x80 | (wchar & 0x3f);
+	}
+      cnt += n;
+      ++pwcs;
+      --nwc;
+    }
+  *src = pwcs;
+  return cnt;
+}
+
 /* Cygwin defines its own doublebyte charset conversion functions 
    because the underlying OS requires wchar_t == UTF-16. */
 #ifndef __CYGWIN__
@@ -177,6 +274,40 @@ _DEFUN (__sjis_wctomb, (r, s, wchar, state),
   return 1;
 }
 
+size_t
+__sjis_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc, size_t len)
+{
+  const wchar_t *pwcs = *src;
+  size_t cnt = 0;
+  size_t n;
+  unsigned char char1, char2;
+
+  while (nwc > 0 && cnt < len && *pwcs != 0)
+    {
+      char1 = (unsigned char) (*pwcs >> 8);
+      char2 = (unsigned char) *pwcs;
+      if ((wint_t) *pwcs > 0xffff)
+	break;
+      if (char1 != 0x00)
+	{
+	  if (!_issjis1 (char1) || !_issjis2 (char2) || len - cnt < 2)
+	    break;
+	  if (dst)
+	    dst[cnt] = (char) char1;
+	  n = 2;
+	}
+      else
+	n = 1;
+      if (dst)
+	dst[cnt + n - 1] = (char) char2;
+      cnt += n;
+      ++pwcs;
+      --nwc;
+    }
+  *src = pwcs;
+  return cnt;
+}
+
 int
 _DEFUN (__eucjp_wctomb, (r, s, wchar, state),
         struct _reent *r       _AND 
@@ -217,6 +348,57 @@ _DEFUN (__eucjp_wctomb, (r, s, wchar, state),
   return 1;
 }
 
+size_t
+__eucjp_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc, size_t len)
+{
+  const wchar_t *pwcs = *src;
+  size_t cnt = 0;
+  unsigned char char1, char2;
+
+  while (nwc > 0 && cnt < len && *pwcs != 0)
+    {
+      char1 = (unsigned char) (*pwcs >> 8);
+      char2 = (unsigned char) *pwcs;
+      if ((wint_t) *pwcs > 0xffff)
+	break;
+      if (char1 == 0x00)
+	{
+	  if (dst)
+	    dst[cnt] = (char) char2;
+	  cnt += 1;
+	}
+      else if (_iseucjp1 (char1) && _iseucjp2 (char2))
+	{
+	  if (len - cnt < 2)
+	    break;
+	  if (dst)
+	    {
+	      dst[cnt] = (char) char1;
+	      dst[cnt + 1] = (char) char2;
+	    }
+	  cnt += 2;
+	}
+      else if (_iseucjp2 (char1) && _iseucjp2 (char2 | 0x80))
+	{
+	  if (len - cnt < 3)
+	    break;
+	  if (dst)
+	    {
+	      dst[cnt] = (char) 0x8f;
+	      dst[cnt + 1] = (char) char1;
+	      dst[cnt + 2] = (char) (char2 | 0x80);
+	    }
+	  cnt += 3;
+	}
+      else
+	break;
+      ++pwcs;
+      --nwc;
+    }
+  *src = pwcs;
+  return cnt;
+}
+
 int
 _DEFUN (__jis_wctomb, (r, s, wchar, state),
         struct _reent *r       _AND 
@@ -422,6 +604,26 @@ __iso_wctomb (int val)
 {
   return __iso_8859_wctomb[val];
 }
+
+static size_t
+__iso_8859_1_wcsnrtombs (char *dst, const wchar_t **src, size_t nwc,
+			 size_t len)
+{
+  size_t cnt;
+
+  cnt = __sb_run (dst, *src, nwc < len ? nwc : len, 0xff);
+  *src += cnt;
+  return cnt;
+}
+
+/* Only ISO-8859-1 maps 1:1 to Unicode.  The other charsets require a
+   reverse table lookup for chars >= 0xa0, which is left to the wctomb
+   function, so they only get the fast path for ASCII. */
+wcsnrtombs_p
+__iso_wcsnrtombs (int val)
+{
+  return val == 1 ? __iso_8859_1_wcsnrtombs : __ascii7_wcsnrtombs;
+}
 #endif /* _MB_EXTENDED_CHARSETS_ISO */
 
 #ifdef _MB_EXTENDED_CHARSETS_WINDOWS
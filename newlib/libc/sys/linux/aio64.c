@@ -2,66 +2,76 @@
 
 /* Copyright 2002, Red Hat Inc. */
 
-/* Currently asynchronous I/O is not implemented. */
+/* Asynchronous I/O needs the worker threads of linuxthreads, whose
+   aio functions override these.  Without them it is not supported. */
 
 #include <sys/types.h>
 #include <aio.h>
 #include <errno.h>
+#include <machine/weakalias.h>
 
 int
-aio_cancel64 (int fd, struct aiocb64 *cb)
+__libc_aio_cancel64 (int fd, struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_cancel64, aio_cancel64)
 
 int
-aio_error64 (const struct aiocb64 *cb)
+__libc_aio_error64 (const struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_error64, aio_error64)
 
 int
-aio_fsync64 (int op, struct aiocb64 *cb)
+__libc_aio_fsync64 (int op, struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_fsync64, aio_fsync64)
 
 int
-aio_read64 (struct aiocb64 *cb)
+__libc_aio_read64 (struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_read64, aio_read64)
 
 ssize_t
-aio_return64 (struct aiocb64 *cb)
+__libc_aio_return64 (struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_return64, aio_return64)
 
 int
-aio_suspend64 (const struct aiocb64 *const list[], int nent,
+__libc_aio_suspend64 (const struct aiocb64 *const list[], int nent,
              const struct timespec *timeout)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_suspend64, aio_suspend64)
 
 int
-aio_write64 (struct aiocb64 *cb)
+__libc_aio_write64 (struct aiocb64 *cb)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_aio_write64, aio_write64)
 
 int
-lio_listio64 (int mode, struct aiocb64 * const list[], int nent,
+__libc_lio_listio64 (int mode, struct aiocb64 * const list[], int nent,
               struct sigevent *sig)
 {
   errno = ENOSYS;
   return -1;
 }
+weak_alias (__libc_lio_listio64, lio_listio64)
@@ -121,6 +121,7 @@ typedef pthread_key_t __libc_key_t;
 #if defined _LIBC && !defined NOT_IN_libc && defined SHARED
 #define __libc_lock_init(NAME) \
   ({									      \
+    (NAME).__m_reserved = 0;						      \
     (NAME).__m_count = 0;						      \
     (NAME).__m_owner = NULL;						      \
     (NAME).__m_kind = PTHREAD_MUTEX_TIMED_NP;				      \
@@ -138,6 +139,7 @@ typedef pthread_key_t __libc_key_t;
 #if defined _LIBC && !defined NOT_IN_libc && defined SHARED
 #define __libc_lock_init_recursive(NAME) \
   ({									      \
+    (NAME).mutex.__m_reserved = 0;					      \
     (NAME).mutex.__m_count = 0;						      \
     (NAME).mutex.__m_owner = NULL;					      \
     (NAME).mutex.__m_kind = PTHREAD_MUTEX_RECURSIVE_NP;			      \
@@ -0,0 +1,420 @@
+/* libc/sys/linux/dl/dl-bindcache.c - persistent cache of symbol bindings */
+
+#include <alloca.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ldsodefs.h>
+
+/*
+ * With LD_BIND_CACHE set to a directory, the bindings the lookups of
+ * _dl_relocate_object and of lazy PLT fixups find for the symbols of an
+ * object are written there at the end of its relocation, at dlclose and
+ * at exit, and read back the next time the object is relocated, which
+ * then takes them from there instead of searching the scope.
+ *
+ * A binding only holds for the same files in the same scope, so the
+ * cache of an object is the file named by its build ID and a hash of the
+ * build IDs of all objects of its scope, in order, and it does not keep
+ * objects without one.  The file holds, for each symbol of the object
+ * and for PLT and other references, the position in the scope of the
+ * object the symbol was found in and its index there.  Once objects are
+ * added to or removed from the scope, which _dl_scope_gen tells, the
+ * cache is only used if the scope is still the same, and never again
+ * once one of its objects was unloaded.
+ *
+ * The file only tells which object to look in: its index is only used
+ * if it is within the symbols of that object, and the lookup then checks
+ * the symbol as the search checks its matches, name, version, binding
+ * and type, and searches the scope if it does not pass.
+ */
+
+#ifndef NT_GNU_BUILD_ID
+# define NT_GNU_BUILD_ID 3
+#endif
+
+#define BIND_CACHE_MAGIC	"DLBIND1"
+
+struct bind_cache_header
+{
+  char magic[8];
+  uint64_t digest;		/* Of the build IDs of the scope.  */
+  uint32_t nsyms;		/* Symbols of the object.  */
+  uint32_t nmaps;		/* Objects in the scope.  */
+};
+
+struct bind_entry
+{
+  /* One more than the position in the scope of the object defining the
+     symbol, 0 if not known.  */
+  uint32_t map;
+  uint32_t sym;
+};
+
+struct dl_bind_cache
+{
+  char *path;
+  struct r_scope_elem **scope;	/* The scope it is for ...  */
+  struct link_map **maps;	/* ... and the objects that were in it.  */
+  unsigned int nmaps;
+  /* One more than the number of symbols of each of MAPS, 0 if not
+     counted yet.  */
+  Elf32_Word *map_nsyms;
+  unsigned long int gen;	/* _dl_scope_gen when MAPS were current.  */
+  int valid;			/* Zero once the scope changed.  */
+  int dirty;			/* Nonzero if there are new bindings.  */
+  struct bind_cache_header header;
+  struct bind_entry *entries;	/* Two for each symbol.  */
+};
+
+const char *_dl_bind_cache_dir;
+unsigned long int _dl_scope_gen;
+unsigned long int _dl_num_bind_cache_hits;
+
+
+/* The build ID of MAP, or NULL.  */
+static const unsigned char *
+build_id (struct link_map *map, size_t *len)
+{
+  const ElfW(Phdr) *ph;
+
+  for (ph = map->l_phdr; ph < &map->l_phdr[map->l_phnum]; ++ph)
+    if (ph->p_type == PT_NOTE)
+      {
+	const char *p = (const char *) (map->l_addr + ph->p_vaddr);
+	const char *end = p + ph->p_memsz;
+
+	while (p + sizeof (ElfW(Nhdr)) <= end)
+	  {
+	    const ElfW(Nhdr) *note = (const ElfW(Nhdr) *) p;
+	    const char *name = p + sizeof (ElfW(Nhdr));
+	    const char *desc = name + ((note->n_namesz + 3) & ~3);
+
+	    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4
+		&& memcmp (name, "GNU", 4) == 0 && note->n_descsz != 0)
+	      {
+		*len = note->n_descsz;
+		return (const unsigned char *) desc;
+	      }
+	    p = desc + ((note->n_descsz + 3) & ~3);
+	  }
+      }
+  return NULL;
+}
+
+/* The number of symbols of MAP, from its hash table.  */
+static Elf32_Word
+count_syms (struct link_map *map)
+{
+  Elf32_Word bucket, max = 0;
+
+  if (map->l_gnu_bitmask == NULL)
+    return map->l_info[DT_HASH] != NULL
+	   ? ((const Elf_Symndx *) (map->l_addr
+				    + map->l_info[DT_HASH]->d_un.d_ptr))[1]
+	   : 0;
+
+  /* The symbols of the last chain are the last ones.  */
+  for (bucket = 0; bucket < map->l_nbuckets; ++bucket)
+    if (map->l_gnu_buckets[bucket] > max)
+      max = map->l_gnu_buckets[bucket];
+  if (max == 0)
+    return 0;
+  while ((map->l_gnu_chain_zero[max] & 1) == 0)
+    ++max;
+  return max + 1;
+}
+
+/* The objects of SCOPE in order into MAPS, if not NULL.  Returns how
+   many there are.  */
+static unsigned int
+scope_maps (struct r_scope_elem *scope[], struct link_map **maps)
+{
+  unsigned int n = 0, i;
+
+  for (; *scope != NULL; ++scope)
+    for (i = 0; i < (*scope)->r_nlist; ++i, ++n)
+      if (maps != NULL)
+	maps[n] = (*scope)->r_list[i];
+  return n;
+}
+
+static void
+hash_bytes (uint64_t *h, const void *p, size_t len)
+{
+  const unsigned char *cp = p;
+
+  /* FNV-1a */
+  while (len-- > 0)
+    *h = (*h ^ *cp++) * 0x100000001b3ULL;
+}
+
+void
+internal_function
+_dl_bind_cache_open (struct link_map *map, struct r_scope_elem *scope[])
+{
+  static const char hex[] = "0123456789abcdef";
+  struct dl_bind_cache *cache;
+  const unsigned char *id, *mid;
+  size_t idlen, midlen, dirlen, size, i;
+  unsigned int j;
+  uint64_t digest = 0xcbf29ce484222325ULL;
+  struct link_map **maps;
+  Elf32_Word nsyms;
+  char *path, *cp;
+  int fd;
+
+  if (map->l_bind_cache != NULL
+      || (id = build_id (map, &idlen)) == NULL
+      || (nsyms = count_syms (map)) == 0)
+    return;
+
+  cache = calloc (1, sizeof (*cache));
+  maps = malloc ((scope_maps (scope, NULL) + 1) * sizeof (*maps));
+  dirlen = strlen (_dl_bind_cache_dir);
+  path = malloc (dirlen + 2 * idlen + 19);
+  if (cache == NULL || maps == NULL || path == NULL)
+    goto fail;
+  cache->path = path;
+  cache->maps = maps;
+  cache->nmaps = scope_maps (scope, maps);
+  cache->map_nsyms = calloc (cache->nmaps, sizeof (Elf32_Word));
+  if (cache->map_nsyms == NULL)
+    goto fail;
+  cache->scope = scope;
+  cache->gen = _dl_scope_gen;
+  cache->valid = 1;
+
+  /* Which objects the symbols bind to also depends on this.  */
+  hash_bytes (&digest, &_dl_dynamic_weak, sizeof (_dl_dynamic_weak));
+  for (; *scope != NULL; ++scope)
+    {
+      hash_bytes (&digest, &(*scope)->r_nlist, sizeof ((*scope)->r_nlist));
+      for (j = 0; j < (*scope)->r_nlist; ++j)
+	{
+	  mid = build_id ((*scope)->r_list[j], &midlen);
+	  if (mid == NULL)
+	    goto fail;
+	  hash_bytes (&digest, &midlen, sizeof (midlen));
+	  hash_bytes (&digest, mid, midlen);
+	}
+    }
+
+  /* DIR/BUILDID-DIGEST */
+  memcpy (path, _dl_bind_cache_dir, dirlen);
+  cp = path + dirlen;
+  *cp++ = '/';
+  for (i = 0; i < idlen; ++i)
+    {
+      *cp++ = hex[id[i] >> 4];
+      *cp++ = hex[id[i] & 15];
+    }
+  *cp++ = '-';
+  for (i = 0; i < 16; ++i)
+    *cp++ = hex[(digest >> (60 - 4 * i)) & 15];
+  *cp = '\0';
+
+  memcpy (cache->header.magic, BIND_CACHE_MAGIC, sizeof (BIND_CACHE_MAGIC));
+  cache->header.digest = digest;
+  cache->header.nsyms = nsyms;
+  cache->header.nmaps = cache->nmaps;
+
+  size = 2 * (size_t) nsyms * sizeof (struct bind_entry);
+  cache->entries = calloc (1, size);
+  if (cache->entries == NULL)
+    goto fail;
+
+  /* An unusable file only means starting afresh.  */
+  fd = open (cache->path, O_RDONLY);
+  if (fd >= 0)
+    {
+      struct bind_cache_header header;
+
+      if (read (fd, &header, sizeof (header)) != sizeof (header)
+	  || memcmp (&header, &cache->header, sizeof (header)) != 0
+	  || read (fd, cache->entries, size) != (ssize_t) size)
+	memset (cache->entries, 0, size);
+      close (fd);
+    }
+
+  map->l_bind_cache = cache;
+  return;
+
+ fail:
+  if (cache != NULL)
+    {
+      free (cache->entries);
+      free (cache->map_nsyms);
+    }
+  free (cache);
+  free (maps);
+  free (path);
+}
+
+/* Whether CACHE may still be used for lookups in SCOPE.  */
+static int
+scope_current (struct dl_bind_cache *cache, struct r_scope_elem *scope[])
+{
+  struct r_scope_elem **sp;
+  unsigned int n = 0, i;
+
+  if (scope != cache->scope || !cache->valid)
+    return 0;
+  if (__builtin_expect (cache->gen == _dl_scope_gen, 1))
+    return 1;
+
+  for (sp = scope; *sp != NULL; ++sp)
+    for (i = 0; i < (*sp)->r_nlist; ++i, ++n)
+      if (n >= cache->nmaps || (*sp)->r_list[i] != cache->maps[n])
+	{
+	  cache->valid = 0;
+	  return 0;
+	}
+  if (n != cache->nmaps)
+    {
+      cache->valid = 0;
+      return 0;
+    }
+  cache->gen = _dl_scope_gen;
+  return 1;
+}
+
+/* The entry of CACHE for REF of MAP and TYPE_CLASS, or NULL.  */
+static inline struct bind_entry *
+entry (struct dl_bind_cache *cache, struct link_map *map,
+       const ElfW(Sym) *ref, int type_class)
+{
+  const ElfW(Sym) *symtab = (const void *) D_PTR (map, l_info[DT_SYMTAB]);
+
+  /* Copy relocs exclude the executable, and dlsym looks up names.  */
+  if ((type_class & ELF_RTYPE_CLASS_COPY) != 0
+      || ref < symtab || ref >= symtab + cache->header.nsyms)
+    return NULL;
+  return &cache->entries[2 * (ref - symtab)
+			 + (type_class & ELF_RTYPE_CLASS_PLT)];
+}
+
+int
+internal_function
+_dl_bind_cache_lookup (struct link_map *undef_map, const ElfW(Sym) *ref,
+		       struct r_scope_elem *scope[], int type_class,
+		       const ElfW(Sym) **sym, struct link_map **map)
+{
+  struct dl_bind_cache *cache = undef_map->l_bind_cache;
+  struct bind_entry *e;
+  struct link_map *m;
+  uint32_t mapno, symno;
+
+  if (!scope_current (cache, scope)
+      || (e = entry (cache, undef_map, ref, type_class)) == NULL)
+    return 0;
+
+  mapno = *(volatile uint32_t *) &e->map;
+  if (mapno == 0 || mapno > cache->nmaps)
+    return 0;
+  m = cache->maps[mapno - 1];
+  if (cache->map_nsyms[mapno - 1] == 0)
+    cache->map_nsyms[mapno - 1] = count_syms (m) + 1;
+
+  /* The file may be stale, broken or made up, and two scopes may have
+     the same digest.  */
+  symno = e->sym;
+  if (symno >= cache->map_nsyms[mapno - 1] - 1)
+    return 0;
+  *sym = &((const ElfW(Sym) *) D_PTR (m, l_info[DT_SYMTAB]))[symno];
+  *map = m;
+  return 1;
+}
+
+void
+internal_function
+_dl_bind_cache_record (struct link_map *undef_map, const ElfW(Sym) *ref,
+		       struct r_scope_elem *scope[], int type_class,
+		       const ElfW(Sym) *sym, struct link_map *map)
+{
+  struct dl_bind_cache *cache = undef_map->l_bind_cache;
+  struct bind_entry *e;
+  unsigned int n;
+
+  if (!scope_current (cache, scope)
+      || (e = entry (cache, undef_map, ref, type_class)) == NULL)
+    return;
+
+  for (n = 0; n < cache->nmaps; ++n)
+    if (cache->maps[n] == map)
+      {
+	/* A lookup running meanwhile in another thread must not see the
+	   object without the symbol.  */
+	e->sym = sym - (const ElfW(Sym) *) D_PTR (map, l_info[DT_SYMTAB]);
+	__asm__ __volatile__ ("" : : : "memory");
+	*(volatile uint32_t *) &e->map = n + 1;
+	cache->dirty = 1;
+	return;
+      }
+}
+
+void
+internal_function
+_dl_bind_cache_sync (struct link_map *map)
+{
+  struct dl_bind_cache *cache = map->l_bind_cache;
+  size_t size;
+  char *tmp;
+  int fd, ok;
+
+  if (cache == NULL || !cache->dirty)
+    return;
+  cache->dirty = 0;
+
+  /* Write a file of our own and rename it, so that nobody ever reads
+     a partial one.  O_EXCL, since anybody may have put a symlink by
+     that name into the directory; what is there is left from an
+     earlier process of the same pid, or removing it does no harm.  */
+  tmp = alloca (strlen (cache->path) + 16);
+  sprintf (tmp, "%s.%d", cache->path, (int) getpid ());
+  fd = open (tmp, O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd < 0 && errno == EEXIST && unlink (tmp) == 0)
+    fd = open (tmp, O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    return;
+  size = 2 * (size_t) cache->header.nsyms * sizeof (struct bind_entry);
+  ok = (write (fd, &cache->header, sizeof (cache->header))
+	== sizeof (cache->header)
+	&& write (fd, cache->entries, size) == (ssize_t) size);
+  if (close (fd) != 0 || !ok || rename (tmp, cache->path) != 0)
+    unlink (tmp);
+}
+
+void
+internal_function
+_dl_bind_cache_close (struct link_map *map)
+{
+  struct dl_bind_cache *cache = map->l_bind_cache;
+  struct link_map *l;
+  unsigned int n;
+
+  /* A new object might get the link_map of MAP, so no other cache must
+     take it for MAP any more.  */
+  for (l = _dl_loaded; l != NULL; l = l->l_next)
+    if (l != map && l->l_bind_cache != NULL)
+      for (n = 0; n < l->l_bind_cache->nmaps; ++n)
+	if (l->l_bind_cache->maps[n] == map)
+	  {
+	    l->l_bind_cache->valid = 0;
+	    break;
+	  }
+
+  if (cache == NULL)
+    return;
+  _dl_bind_cache_sync (map);
+  map->l_bind_cache = NULL;
+  free (cache->entries);
+  free (cache->maps);
+  free (cache->map_nsyms);
+  free (cache->path);
+  free (cache);
+}
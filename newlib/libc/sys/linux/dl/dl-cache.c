@@ -18,6 +18,7 @@
    02111-1307 USA.  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <ldsodefs.h>
 #include <sys/mman.h>
@@ -36,6 +37,31 @@ static struct cache_file *cache;
 static struct cache_file_new *cache_new;
 static size_t cachesize;
 
+/* The entries of each name are next to each other in the cache.  Once
+   a program has looked up one name for every
+   CACHE_INDEX_ENTRIES_PER_LOOKUP entries of the file, which is about
+   when the searches it saves would have paid for making it, we make a
+   hash table of the first entry of each name, which then replaces the
+   binary search.  It is kept when the cache is unloaded and used again if the
+   file has as many entries the next time, which is only a guess, so
+   until it is made anew for the file, the binary search still follows
+   if it does not find a name.  */
+#define CACHE_INDEX_ENTRIES_PER_LOOKUP	4
+
+struct cache_index_entry
+{
+  uint32_t hash;		/* _dl_cache_libhash of the name.  */
+  uint32_t first;		/* One more than the index of its first
+				   entry, or 0 if the slot is free.  */
+};
+
+static struct cache_index_entry *cache_index;
+static uint32_t cache_index_mask;
+static uint32_t cache_index_nlibs;	/* Entries of the file it is for.  */
+static int cache_index_new;		/* Nonzero if for the new format.  */
+static int cache_index_current;		/* Nonzero if made for this file.  */
+static unsigned int cache_lookups;
+
 /* 1 if cache_data + PTR points into the cache.  */
 #define _dl_cache_verify_ptr(ptr) (ptr < cache_data_size)
 
@@ -43,13 +69,134 @@ static size_t cachesize;
    binaries.  */
 int _dl_correct_cache_id = _DL_CACHE_DEFAULT_ID;
 
+/* Choose among the entries for NAME, the first of which is MIDDLE.
+   LEFT is the last entry for which we know the name is correct, and
+   RIGHT the last one that may still have it.  */
+#define SELECT_CACHE_ENTRY(cache) \
+do									      \
+  {									      \
+    int flags;								      \
+    __typeof__ (cache->libs[0]) *lib = &cache->libs[middle];		      \
+									      \
+    /* Only perform the name test if necessary.  */			      \
+    if (middle > left							      \
+	/* We haven't seen this string so far.  Test whether the	      \
+	   index is ok and whether the name matches.  Otherwise		      \
+	   we are done.  */						      \
+	&& (! _dl_cache_verify_ptr (lib->key)				      \
+	    || (_dl_cache_libcmp (name, cache_data + lib->key)		      \
+		!= 0)))							      \
+      break;								      \
+									      \
+    flags = lib->flags;							      \
+    if (_dl_cache_check_flags (flags)					      \
+	&& _dl_cache_verify_ptr (lib->value))				      \
+      {									      \
+	if (best == NULL || flags == _dl_correct_cache_id)		      \
+	  {								      \
+	    HWCAP_CHECK;						      \
+	    best = cache_data + lib->value;				      \
+									      \
+	    if (flags == _dl_correct_cache_id)				      \
+	      /* We've found an exact match for the shared		      \
+		 object and no general `ELF' release.  Stop		      \
+		 searching.  */						      \
+	      break;							      \
+	  }								      \
+      }									      \
+  }									      \
+while (++middle <= right)
+
+/* Whether entry I is the first one for NAME.  */
+#define FIRST_CACHE_ENTRY(cache, i) \
+  (_dl_cache_verify_ptr (cache->libs[i].key)				      \
+   && _dl_cache_libcmp (name, cache_data + cache->libs[i].key) == 0	      \
+   && ((i) == 0								      \
+       || ! _dl_cache_verify_ptr (cache->libs[(i) - 1].key)		      \
+       || _dl_cache_libcmp (name, cache_data + cache->libs[(i) - 1].key) != 0))
+
+/* Drop an index that cannot be for CACHE, and make one if it is time,
+   entering the first entry for each name.  */
+#define BUILD_CACHE_INDEX(cache, is_new) \
+do									      \
+  {									      \
+    uint32_t size = 4, i, h, slot;					      \
+									      \
+    if (cache_index != NULL						      \
+	&& (cache_index_nlibs != cache->nlibs				      \
+	    || cache_index_new != (is_new)))				      \
+      {									      \
+	free (cache_index);						      \
+	cache_index = NULL;						      \
+      }									      \
+    if (cache_index != NULL						      \
+	|| cache_lookups < cache->nlibs / CACHE_INDEX_ENTRIES_PER_LOOKUP)     \
+      break;								      \
+									      \
+    while (size < 2 * cache->nlibs && size < 0x40000000)		      \
+      size *= 2;							      \
+    cache_index = calloc (size, sizeof (struct cache_index_entry));	      \
+    if (cache_index == NULL)						      \
+      break;								      \
+    cache_index_mask = size - 1;					      \
+    cache_index_nlibs = cache->nlibs;					      \
+    cache_index_new = (is_new);						      \
+    cache_index_current = 1;						      \
+									      \
+    for (i = 0; i < cache->nlibs; ++i)					      \
+      {									      \
+	uint32_t key = cache->libs[i].key;				      \
+									      \
+	/* Only the first entry of each name is entered.  */		      \
+	if (! _dl_cache_verify_ptr (key)				      \
+	    || (i > 0							      \
+		&& (cache->libs[i - 1].key == key			      \
+		    || (_dl_cache_verify_ptr (cache->libs[i - 1].key)	      \
+			&& (_dl_cache_libcmp (cache_data + key,		      \
+					      cache_data			      \
+					      + cache->libs[i - 1].key)	      \
+			    == 0)))))						      \
+	  continue;							      \
+	h = _dl_cache_libhash (cache_data + key);			      \
+	for (slot = h & cache_index_mask; cache_index[slot].first != 0;	      \
+	     slot = (slot + 1) & cache_index_mask)			      \
+	  ;								      \
+	cache_index[slot].hash = h;					      \
+	cache_index[slot].first = i + 1;				      \
+      }									      \
+  }									      \
+while (0)
+
 #define SEARCH_CACHE(cache) \
-/* We use binary search since the table is sorted in the cache file.	      \
-   The first matching entry in the table is returned.			      \
-   It is important to use the same algorithm as used while generating	      \
-   the cache file.  */							      \
 do									      \
   {									      \
+    /* With the index we only compare NAME with the entries of the	      \
+       names with the same hash.  Each is checked, because the index	      \
+       might have been made for an earlier version of the file, and	      \
+       only in that case is not finding NAME there not the end.  */	      \
+    if (cache_index != NULL)						      \
+      {									      \
+	uint32_t h = _dl_cache_libhash (name), slot;			      \
+									      \
+	for (slot = h & cache_index_mask; cache_index[slot].first != 0;	      \
+	     slot = (slot + 1) & cache_index_mask)			      \
+	  if (cache_index[slot].hash == h				      \
+	      && cache_index[slot].first <= cache->nlibs		      \
+	      && FIRST_CACHE_ENTRY (cache, cache_index[slot].first - 1))     \
+	    {								      \
+	      left = middle = cache_index[slot].first - 1;		      \
+	      right = cache->nlibs - 1;					      \
+	      SELECT_CACHE_ENTRY (cache);				      \
+	      break;							      \
+	    }								      \
+	if (cache_index[slot].first != 0 || cache_index_current)	      \
+	  break;							      \
+      }									      \
+									      \
+    /* We use binary search since the table is sorted in the cache file.    \
+       The first matching entry in the table is returned.		      \
+       It is important to use the same algorithm as used while generating    \
+       the cache file.  */						      \
     left = 0;								      \
     right = cache->nlibs - 1;						      \
 									      \
@@ -93,39 +240,7 @@ do									      \
 		--middle;						      \
 	      }								      \
 									      \
-	    do								      \
-	      {								      \
-		int flags;						      \
-		__typeof__ (cache->libs[0]) *lib = &cache->libs[middle];      \
-									      \
-		/* Only perform the name test if necessary.  */		      \
-		if (middle > left					      \
-		    /* We haven't seen this string so far.  Test whether the  \
-		       index is ok and whether the name matches.  Otherwise   \
-		       we are done.  */					      \
-		    && (! _dl_cache_verify_ptr (lib->key)		      \
-			|| (_dl_cache_libcmp (name, cache_data + lib->key)    \
-			    != 0)))					      \
-		  break;						      \
-									      \
-		flags = lib->flags;					      \
-		if (_dl_cache_check_flags (flags)			      \
-		    && _dl_cache_verify_ptr (lib->value))		      \
-		  {							      \
-		    if (best == NULL || flags == _dl_correct_cache_id)	      \
-		      {							      \
-			HWCAP_CHECK;					      \
-			best = cache_data + lib->value;			      \
-									      \
-			if (flags == _dl_correct_cache_id)		      \
-			  /* We've found an exact match for the shared	      \
-			     object and no general `ELF' release.  Stop	      \
-			     searching.  */				      \
-			  break;					      \
-		      }							      \
-		  }							      \
-	      }								      \
-	    while (++middle <= right);					      \
+	    SELECT_CACHE_ENTRY (cache);					      \
 	    break;							      \
 	}								      \
 									      \
@@ -137,6 +252,26 @@ do									      \
   }									      \
 while (0)
 
+/* A hash of NAME that is the same for all names _dl_cache_libcmp finds
+   equal: numbers count by their value.  */
+static uint32_t
+_dl_cache_libhash (const char *p)
+{
+  uint32_t hash = 0;
+
+  while (*p != '\0')
+    if (*p >= '0' && *p <= '9')
+      {
+	unsigned int val = 0;
+
+	while (*p >= '0' && *p <= '9')
+	  val = val * 10 + *p++ - '0';
+	hash = hash * 33 + val + 256;
+      }
+    else
+      hash = hash * 33 + (unsigned char) *p++;
+  return hash;
+}
 
 
 /* Look up NAME in ld.so.cache and return the file name stored there,
@@ -201,6 +336,8 @@ _dl_load_cache_lookup (const char *name)
     /* Previously looked for the cache file and didn't find it.  */
     return NULL;
 
+  ++cache_lookups;
+
   best = NULL;
 
   if (cache_new != (void *) -1)
@@ -221,6 +358,8 @@ _dl_load_cache_lookup (const char *name)
       if (platform != -1)
 	platform = 1ULL << platform;
 
+      BUILD_CACHE_INDEX (cache_new, 1);
+
       /* Only accept hwcap if it's for the right platform.  */
 #define HWCAP_CHECK \
       if (_dl_osversion	&& cache_new->libs[middle].osversion > _dl_osversion) \
@@ -242,6 +381,8 @@ _dl_load_cache_lookup (const char *name)
       /* Now we can compute how large the string table is.  */
       cache_data_size = (const char *) cache + cachesize - cache_data;
 
+      BUILD_CACHE_INDEX (cache, 0);
+
 #undef HWCAP_CHECK
 #define HWCAP_CHECK do {} while (0)
       SEARCH_CACHE (cache);
@@ -266,6 +407,8 @@ _dl_unload_cache (void)
     {
       munmap (cache, cachesize);
       cache = NULL;
+      /* Whatever is loaded next might be another file.  */
+      cache_index_current = 0;
     }
 }
 #endif
@@ -172,6 +172,8 @@ _dl_close (void *_map)
 	      }
 	  else
 	    ++runp;
+
+	  ++_dl_scope_gen;
 	}
 
       /* Store the new l_opencount value.  */
@@ -210,8 +212,13 @@ _dl_close (void *_map)
 		  = _dl_main_searchlist->r_list[cnt];
 
 	      --_dl_main_searchlist->r_nlist;
+	      ++_dl_scope_gen;
 	    }
 
+	  /* Keep what its lookups found, and make sure nobody else takes
+	     a binding to it from a cache any more.  */
+	  _dl_bind_cache_close (imap);
+
 	  /* We can unmap all the maps at once.  We determined the
 	     start address and length when we loaded the object and
 	     the `munmap' call does the rest.  */
@@ -861,7 +861,7 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
   else
     {
       phdr = alloca (maplength);
-      lseek (fd, SEEK_SET, header->e_phoff);
+      lseek (fd, header->e_phoff, SEEK_SET);
       if (__libc_read (fd, (void *) phdr, maplength) != maplength)
 	{
 	  errstring = N_("cannot read file data");
@@ -950,10 +950,11 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
 	/* This is a position-independent shared object.  We can let the
 	   kernel map it anywhere it likes, but we must have space for all
 	   the segments in their specified positions relative to the first.
-	   So we map the first segment without MAP_FIXED, but with its
-	   extent increased to cover all the segments.  Then we remove
-	   access from excess portion, and there is known sufficient space
-	   there to remap from the later segments.
+	   So we first reserve the whole extent with an inaccessible
+	   anonymous mapping, and then map each segment over its part of
+	   it like those of an object loaded at a fixed address.  What is
+	   not remapped stays inaccessible as if unallocated, and no part
+	   of the file is mapped where no segment wants it.
 
 	   As a refinement, sometimes we have an address that we would
 	   prefer to map such objects at; but this is only a preference,
@@ -964,8 +965,8 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
 
 	/* Remember which part of the address space this object uses.  */
 	l->l_map_start = (ElfW(Addr)) mmap ((void *) mappref, maplength,
-					      c->prot, MAP_COPY | MAP_FILE,
-					      fd, c->mapoff);
+					      PROT_NONE, MAP_ANON|MAP_PRIVATE,
+					      ANONFD, 0);
 	if ((void *) l->l_map_start == MAP_FAILED)
 	  {
 	  map_error:
@@ -973,19 +974,7 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
 	    goto call_lose_errno;
 	  }
 
-	l->l_map_end = l->l_map_start + maplength;
 	l->l_addr = l->l_map_start - c->mapstart;
-
-	/* Change protection on the excess portion to disallow all access;
-	   the portions we do not remap later will be inaccessible as if
-	   unallocated.  Then jump into the normal segment-mapping loop to
-	   handle the portion of the segment past the end of the file
-	   mapping.  */
-	mprotect ((caddr_t) (l->l_addr + c->mapend),
-		    loadcmds[nloadcmds - 1].allocend - c->mapend,
-		    PROT_NONE);
-
-	goto postmap;
       }
     else
       {
@@ -1000,10 +989,11 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
 	/* Notify ELF_PREFERRED_ADDRESS that we have to load this one
 	   fixed.  */
 	ELF_FIXED_ADDRESS (loader, c->mapstart);
+
+	/* Remember which part of the address space this object uses.  */
+	l->l_map_start = c->mapstart + l->l_addr;
       }
 
-    /* Remember which part of the address space this object uses.  */
-    l->l_map_start = c->mapstart + l->l_addr;
     l->l_map_end = l->l_map_start + maplength;
 
     while (c < &loadcmds[nloadcmds])
@@ -1016,7 +1006,6 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
 		== MAP_FAILED))
 	  goto map_error;
 
-      postmap:
 	if (l->l_phdr == 0
 	    && c->mapoff <= header->e_phoff
 	    && (c->mapend - c->mapstart + c->mapoff
@@ -1149,7 +1138,7 @@ _dl_map_object_from_fd (const char *name, int fd, struct filebuf *fbp,
       goto call_lose;
     }
 
-  if (l->l_info[DT_HASH])
+  if (l->l_info[DT_HASH] || l->l_info[ADDRIDX (DT_GNU_HASH)])
     _dl_setup_hash (l);
 
   /* If this object has DT_SYMBOLIC set modify now its scope.  We don't
@@ -1378,7 +1367,7 @@ open_verify (const char *name, struct filebuf *fbp)
       else
 	{
 	  phdr = alloca (maplength);
-	  lseek (fd, SEEK_SET, ehdr->e_phoff);
+	  lseek (fd, ehdr->e_phoff, SEEK_SET);
 	  if (__libc_read (fd, (void *) phdr, maplength) != maplength)
 	    {
 	    read_error:
@@ -1396,7 +1385,7 @@ open_verify (const char *name, struct filebuf *fbp)
 	      abi_note = (void *) (fbp->buf + ph->p_offset);
 	    else
 	      {
-		lseek (fd, SEEK_SET, ph->p_offset);
+		lseek (fd, ph->p_offset, SEEK_SET);
 		if (__libc_read (fd, (void *) abi_note_buf, 32) != 32)
 		  goto read_error;
 
@@ -191,18 +191,90 @@ add_dependency (struct link_map *undef_map, struct link_map *map)
 
 static int
 internal_function
-_dl_do_lookup (const char *undef_name, unsigned long int hash,
-	       const ElfW(Sym) *ref, struct sym_val *result,
-	       struct r_scope_elem *scope, size_t i,
+_dl_do_lookup (const char *undef_name, Elf32_Word new_hash,
+	       unsigned long int *old_hash, const ElfW(Sym) *ref,
+	       struct sym_val *result, struct r_scope_elem *scope, size_t i,
 	       struct link_map *skip, int type_class);
 static int
 internal_function
-_dl_do_lookup_versioned (const char *undef_name, unsigned long int hash,
-			 const ElfW(Sym) *ref, struct sym_val *result,
+_dl_do_lookup_versioned (const char *undef_name, Elf32_Word new_hash,
+			 unsigned long int *old_hash, const ElfW(Sym) *ref,
+			 struct sym_val *result,
 			 struct r_scope_elem *scope, size_t i,
 			 const struct r_found_version *const version,
 			 struct link_map *skip, int type_class);
 
+/* Whether SYM of MAP, which the bind cache gives for REF, is what the
+   search would take there: do_lookup's checks of a match, without the
+   lone non-default version it takes only when the whole object has no
+   other.  */
+static inline int
+cached_match (const char *undef_name, const ElfW(Sym) *ref,
+	      const ElfW(Sym) *sym, struct link_map *map,
+	      const struct r_found_version *version, int type_class)
+{
+  const ElfW(Sym) *symtab = (const void *) D_PTR (map, l_info[DT_SYMTAB]);
+  const char *strtab = (const void *) D_PTR (map, l_info[DT_STRTAB]);
+  int num_versions = 0;
+  const ElfW(Sym) *versioned_sym = NULL;
+
+  if ((type_class & ELF_RTYPE_CLASS_COPY) && map->l_type == lt_executable)
+    return 0;
+
+  if (version != NULL)
+    sym = check_match_versioned (undef_name, ref, symtab, strtab,
+				 map->l_versyms, sym - symtab, version, map,
+				 type_class, &num_versions, &versioned_sym);
+  else
+    sym = check_match (undef_name, ref, symtab, strtab, map->l_versyms,
+		       sym - symtab, map, type_class, &num_versions,
+		       &versioned_sym);
+  if (sym == NULL)
+    return 0;
+
+  switch (ELFW(ST_BIND) (sym->st_info))
+    {
+    case STB_WEAK:
+      /* Only taken for good if no other object has it.  */
+      return ! _dl_dynamic_weak;
+    case STB_GLOBAL:
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/* Take the binding of REF, named UNDEF_NAME, of VERSION if that is not
+   NULL, from the bind cache of UNDEF_MAP into RESULT, if the cache has
+   it.  The cache only tells where to look: what it names must pass the
+   checks the search makes, or we search.  */
+static inline int
+cached_binding (const char *undef_name, struct link_map *undef_map,
+		const ElfW(Sym) *ref, struct r_scope_elem *symbol_scope[],
+		const struct r_found_version *version, int type_class,
+		int explicit, struct sym_val *result)
+{
+  if (undef_map == NULL || undef_map->l_bind_cache == NULL
+      || ! _dl_bind_cache_lookup (undef_map, ref, symbol_scope, type_class,
+				  &result->s, &result->m))
+    return 0;
+
+  if (! cached_match (undef_name, ref, result->s, result->m, version,
+		      type_class)
+      /* The same as for what the search finds.  If that fails, we
+	 search.  */
+      || (__builtin_expect (result->m->l_type == lt_loaded, 0)
+	  && ! explicit
+	  && add_dependency (undef_map, result->m) < 0))
+    {
+      result->s = NULL;
+      result->m = NULL;
+      return 0;
+    }
+  ++_dl_num_bind_cache_hits;
+  return 1;
+}
+
 
 /* Search loaded objects' symbol tables for a definition of the symbol
    UNDEF_NAME.  */
@@ -213,17 +285,22 @@ _dl_lookup_symbol (const char *undef_name, struct link_map *undef_map,
 		   const ElfW(Sym) **ref, struct r_scope_elem *symbol_scope[],
 		   int type_class, int explicit)
 {
-  unsigned long int hash = _dl_elf_hash (undef_name);
+  const Elf32_Word new_hash = _dl_new_hash (undef_name);
+  unsigned long int old_hash = 0xffffffff;
   struct sym_val current_value = { NULL, NULL };
   struct r_scope_elem **scope;
   int protected;
 
   ++_dl_num_relocations;
 
+  if (cached_binding (undef_name, undef_map, *ref, symbol_scope, NULL,
+		      type_class, explicit, &current_value))
+    goto found;
+
   /* Search the relevant loaded objects for a definition.  */
   for (scope = symbol_scope; *scope; ++scope)
-    if (do_lookup (undef_name, hash, *ref, &current_value, *scope, 0, NULL,
-		   type_class))
+    if (do_lookup (undef_name, new_hash, &old_hash, *ref, &current_value,
+		   *scope, 0, NULL, type_class))
       {
 	/* We have to check whether this would bind UNDEF_MAP to an object
 	   in the global scope which was dynamically loaded.  In this case
@@ -259,6 +336,11 @@ _dl_lookup_symbol (const char *undef_name, struct link_map *undef_map,
       return 0;
     }
 
+  if (undef_map != NULL && undef_map->l_bind_cache != NULL)
+    _dl_bind_cache_record (undef_map, *ref, symbol_scope, type_class,
+			   current_value.s, current_value.m);
+
+ found:
   protected = *ref && ELFW(ST_VISIBILITY) ((*ref)->st_other) == STV_PROTECTED;
 
   if (__builtin_expect (_dl_debug_mask & DL_DEBUG_BINDINGS, 0))
@@ -285,8 +367,9 @@ _dl_lookup_symbol (const char *undef_name, struct link_map *undef_map,
       struct sym_val protected_value = { NULL, NULL };
 
       for (scope = symbol_scope; *scope; ++scope)
-	if (_dl_do_lookup (undef_name, hash, *ref, &protected_value, *scope,
-			   0, NULL, ELF_RTYPE_CLASS_PLT))
+	if (_dl_do_lookup (undef_name, new_hash, &old_hash, *ref,
+			   &protected_value, *scope, 0, NULL,
+			   ELF_RTYPE_CLASS_PLT))
 	  break;
 
       if (protected_value.s == NULL || protected_value.m == undef_map)
@@ -313,7 +396,8 @@ _dl_lookup_symbol_skip (const char *undef_name,
 			struct link_map *skip_map)
 {
   const char *reference_name = undef_map ? undef_map->l_name : NULL;
-  const unsigned long int hash = _dl_elf_hash (undef_name);
+  const Elf32_Word new_hash = _dl_new_hash (undef_name);
+  unsigned long int old_hash = 0xffffffff;
   struct sym_val current_value = { NULL, NULL };
   struct r_scope_elem **scope;
   size_t i;
@@ -326,11 +410,11 @@ _dl_lookup_symbol_skip (const char *undef_name,
   for (i = 0; (*scope)->r_list[i] != skip_map; ++i)
     assert (i < (*scope)->r_nlist);
 
-  if (! _dl_do_lookup (undef_name, hash, *ref, &current_value, *scope, i,
-		       skip_map, 0))
+  if (! _dl_do_lookup (undef_name, new_hash, &old_hash, *ref, &current_value,
+		       *scope, i, skip_map, 0))
     while (*++scope)
-      if (_dl_do_lookup (undef_name, hash, *ref, &current_value, *scope, 0,
-			 skip_map, 0))
+      if (_dl_do_lookup (undef_name, new_hash, &old_hash, *ref, &current_value,
+			 *scope, 0, skip_map, 0))
 	break;
 
   if (__builtin_expect (current_value.s == NULL, 0))
@@ -361,11 +445,13 @@ _dl_lookup_symbol_skip (const char *undef_name,
       struct sym_val protected_value = { NULL, NULL };
 
       if (i >= (*scope)->r_nlist
-	  || !_dl_do_lookup (undef_name, hash, *ref, &protected_value, *scope,
-			     i, skip_map, ELF_RTYPE_CLASS_PLT))
+	  || !_dl_do_lookup (undef_name, new_hash, &old_hash, *ref,
+			     &protected_value, *scope, i, skip_map,
+			     ELF_RTYPE_CLASS_PLT))
 	while (*++scope)
-	  if (_dl_do_lookup (undef_name, hash, *ref, &protected_value, *scope,
-			     0, skip_map, ELF_RTYPE_CLASS_PLT))
+	  if (_dl_do_lookup (undef_name, new_hash, &old_hash, *ref,
+			     &protected_value, *scope, 0, skip_map,
+			     ELF_RTYPE_CLASS_PLT))
 	    break;
 
       if (protected_value.s == NULL || protected_value.m == undef_map)
@@ -392,18 +478,24 @@ _dl_lookup_versioned_symbol (const char *undef_name,
 			     const struct r_found_version *version,
 			     int type_class, int explicit)
 {
-  unsigned long int hash = _dl_elf_hash (undef_name);
+  const Elf32_Word new_hash = _dl_new_hash (undef_name);
+  unsigned long int old_hash = 0xffffffff;
   struct sym_val current_value = { NULL, NULL };
   struct r_scope_elem **scope;
   int protected;
 
   ++_dl_num_relocations;
 
+  if (cached_binding (undef_name, undef_map, *ref, symbol_scope, version,
+		      type_class, explicit, &current_value))
+    goto found;
+
   /* Search the relevant loaded objects for a definition.  */
   for (scope = symbol_scope; *scope; ++scope)
     {
-      int res = do_lookup_versioned (undef_name, hash, *ref, &current_value,
-				     *scope, 0, version, NULL, type_class);
+      int res = do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
+				     &current_value, *scope, 0, version, NULL,
+				     type_class);
       if (res > 0)
 	{
 	  /* We have to check whether this would bind UNDEF_MAP to an object
@@ -467,6 +559,11 @@ _dl_lookup_versioned_symbol (const char *undef_name,
       return 0;
     }
 
+  if (undef_map != NULL && undef_map->l_bind_cache != NULL)
+    _dl_bind_cache_record (undef_map, *ref, symbol_scope, type_class,
+			   current_value.s, current_value.m);
+
+ found:
   protected = *ref && ELFW(ST_VISIBILITY) ((*ref)->st_other) == STV_PROTECTED;
 
   if (__builtin_expect (_dl_debug_mask & DL_DEBUG_BINDINGS, 0))
@@ -494,9 +591,9 @@ _dl_lookup_versioned_symbol (const char *undef_name,
       struct sym_val protected_value = { NULL, NULL };
 
       for (scope = symbol_scope; *scope; ++scope)
-	if (_dl_do_lookup_versioned (undef_name, hash, *ref, &protected_value,
-				     *scope, 0, version, NULL,
-				     ELF_RTYPE_CLASS_PLT))
+	if (_dl_do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
+				     &protected_value, *scope, 0, version,
+				     NULL, ELF_RTYPE_CLASS_PLT))
 	  break;
 
       if (protected_value.s == NULL || protected_value.m == undef_map)
@@ -522,7 +619,8 @@ _dl_lookup_versioned_symbol_skip (const char *undef_name,
 				  struct link_map *skip_map)
 {
   const char *reference_name = undef_map ? undef_map->l_name : NULL;
-  const unsigned long int hash = _dl_elf_hash (undef_name);
+  const Elf32_Word new_hash = _dl_new_hash (undef_name);
+  unsigned long int old_hash = 0xffffffff;
   struct sym_val current_value = { NULL, NULL };
   struct r_scope_elem **scope;
   size_t i;
@@ -535,11 +633,13 @@ _dl_lookup_versioned_symbol_skip (const char *undef_name,
   for (i = 0; (*scope)->r_list[i] != skip_map; ++i)
     assert (i < (*scope)->r_nlist);
 
-  if (! _dl_do_lookup_versioned (undef_name, hash, *ref, &current_value,
-				 *scope, i, version, skip_map, 0))
+  if (! _dl_do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
+				 &current_value, *scope, i, version,
+				 skip_map, 0))
     while (*++scope)
-      if (_dl_do_lookup_versioned (undef_name, hash, *ref, &current_value,
-				   *scope, 0, version, skip_map, 0))
+      if (_dl_do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
+				   &current_value, *scope, 0, version,
+				   skip_map, 0))
 	break;
 
   if (__builtin_expect (current_value.s == NULL, 0))
@@ -588,11 +688,11 @@ _dl_lookup_versioned_symbol_skip (const char *undef_name,
       struct sym_val protected_value = { NULL, NULL };
 
       if (i >= (*scope)->r_nlist
-	  || !_dl_do_lookup_versioned (undef_name, hash, *ref,
+	  || !_dl_do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
 				       &protected_value, *scope, i, version,
 				       skip_map, ELF_RTYPE_CLASS_PLT))
 	while (*++scope)
-	  if (_dl_do_lookup_versioned (undef_name, hash, *ref,
+	  if (_dl_do_lookup_versioned (undef_name, new_hash, &old_hash, *ref,
 				       &protected_value, *scope, 0, version,
 				       skip_map, ELF_RTYPE_CLASS_PLT))
 	    break;
@@ -608,7 +708,8 @@ _dl_lookup_versioned_symbol_skip (const char *undef_name,
 }
 
 
-/* Cache the location of MAP's hash table.  */
+/* Cache the location of MAP's hash table, the GNU-style one if MAP has
+   one and the ELF one otherwise.  */
 
 void
 internal_function
@@ -617,6 +718,32 @@ _dl_setup_hash (struct link_map *map)
   Elf_Symndx *hash;
   Elf_Symndx nchain;
 
+  if (map->l_info[ADDRIDX (DT_GNU_HASH)] != NULL)
+    {
+      Elf32_Word *hash32
+	= (void *) (map->l_addr
+		    + map->l_info[ADDRIDX (DT_GNU_HASH)]->d_un.d_ptr);
+      Elf32_Word symbias, bitmask_nwords;
+
+      map->l_nbuckets = *hash32++;
+      symbias = *hash32++;
+      bitmask_nwords = *hash32++;
+      /* Must be a power of two.  */
+      assert ((bitmask_nwords & (bitmask_nwords - 1)) == 0);
+      map->l_gnu_bitmask_idxbits = bitmask_nwords - 1;
+      map->l_gnu_shift = *hash32++;
+
+      map->l_gnu_bitmask = (const ElfW(Addr) *) hash32;
+      hash32 += __ELF_NATIVE_CLASS / 32 * bitmask_nwords;
+
+      map->l_gnu_buckets = hash32;
+      hash32 += map->l_nbuckets;
+      /* The chains leave out the first SYMBIAS symbols, which are not
+	 in the table, so this points SYMBIAS words before them.  */
+      map->l_gnu_chain_zero = hash32 - symbias;
+      return;
+    }
+
   if (!map->l_info[DT_HASH])
     return;
   hash = (void *)(map->l_addr + map->l_info[DT_HASH]->d_un.d_ptr);
@@ -632,23 +759,24 @@ _dl_setup_hash (struct link_map *map)
    case, not everywhere.  */
 static int
 internal_function
-_dl_do_lookup (const char *undef_name, unsigned long int hash,
-	       const ElfW(Sym) *ref, struct sym_val *result,
-	       struct r_scope_elem *scope, size_t i,
+_dl_do_lookup (const char *undef_name, Elf32_Word new_hash,
+	       unsigned long int *old_hash, const ElfW(Sym) *ref,
+	       struct sym_val *result, struct r_scope_elem *scope, size_t i,
 	       struct link_map *skip, int type_class)
 {
-  return do_lookup (undef_name, hash, ref, result, scope, i, skip,
-		    type_class);
+  return do_lookup (undef_name, new_hash, old_hash, ref, result, scope, i,
+		    skip, type_class);
 }
 
 static int
 internal_function
-_dl_do_lookup_versioned (const char *undef_name, unsigned long int hash,
-			 const ElfW(Sym) *ref, struct sym_val *result,
+_dl_do_lookup_versioned (const char *undef_name, Elf32_Word new_hash,
+			 unsigned long int *old_hash, const ElfW(Sym) *ref,
+			 struct sym_val *result,
 			 struct r_scope_elem *scope, size_t i,
 			 const struct r_found_version *const version,
 			 struct link_map *skip, int type_class)
 {
-  return do_lookup_versioned (undef_name, hash, ref, result, scope, i,
-			      version, skip, type_class);
+  return do_lookup_versioned (undef_name, new_hash, old_hash, ref, result,
+			      scope, i, version, skip, type_class);
 }
@@ -83,6 +83,17 @@ _dl_sysdep_read_whole_file (const char *file, size_t *sizep, int prot)
 int _dl_debug_fd = 2;
 
 
+/* Write VALUE in BASE backwards to the characters before BUFLIM and
+   return where it starts.  */
+static char *
+dl_itoa (unsigned long int value, char *buflim, unsigned int base)
+{
+  do
+    *--buflim = "0123456789abcdef"[value % base];
+  while ((value /= base) != 0);
+  return buflim;
+}
+
 /* Bare-bone printf implementation.  This function only knows about
    the formats and flags needed and can handle only up to 64 stripes in
    the output.  */
@@ -105,9 +116,10 @@ _dl_debug_vdprintf (int fd, int tag_p, const char *fmt, va_list arg)
 	     colon followed by a tab.  */
 	  if (pid == 0)
 	    {
-	      char *p = "0";
+	      char *p;
 	      pid = __getpid ();
 	      assert (pid >= 0 && pid < 100000);
+	      p = dl_itoa (pid, &pidbuf[5], 10);
 	      while (p > pidbuf)
 		*--p = '0';
 	      pidbuf[5] = ':';
@@ -187,7 +199,7 @@ _dl_debug_vdprintf (int fd, int tag_p, const char *fmt, va_list arg)
 		   having more than one integer formatting in a call.  */
 		char *buf = (char *) alloca (3 * sizeof (unsigned long int));
 		char *endp = &buf[3 * sizeof (unsigned long int)];
-		char *cp = "0"; 
+		char *cp = dl_itoa (num, endp, *fmt == 'x' ? 16 : 10);
 
 		/* Pad to the width the user specified.  */
 		if (width != -1)
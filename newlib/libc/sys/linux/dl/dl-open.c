@@ -141,6 +141,7 @@ add_to_global (struct link_map *new)
 	  map->l_global = 1;
 	  _dl_main_searchlist->r_list[_dl_main_searchlist->r_nlist] = map;
 	  ++_dl_main_searchlist->r_nlist;
+	  ++_dl_scope_gen;
 	}
     }
 
@@ -348,6 +349,7 @@ dl_open_worker (void *a)
 
 	imap->l_scope[cnt++] = &new->l_searchlist;
 	imap->l_scope[cnt] = NULL;
+	++_dl_scope_gen;
       }
 
   /* Run the initializer functions of new objects.  */
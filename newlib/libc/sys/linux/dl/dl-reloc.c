@@ -25,10 +25,19 @@
 #include <sys/mman.h>
 #include <sys/param.h>
 #include <sys/types.h>
+#include <machine/hp-timing.h>
 #include "dynamic-link.h"
 
 /* Statistics function.  */
 unsigned long int _dl_num_cache_relocations;
+unsigned long int _dl_num_relative_relocations;
+unsigned long int _dl_num_lazy_relocations;
+unsigned long int _dl_num_lazy_fixups;
+
+/* Time spent in _dl_relocate_object.  */
+#ifndef HP_TIMING_NONAVAIL
+hp_timing_t _dl_relocate_time;
+#endif
 
 
 void
@@ -44,10 +53,21 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
   } *textrels = NULL;
   /* Initialize it to make the compiler happy.  */
   const char *errstring = NULL;
+#ifndef HP_TIMING_NONAVAIL
+  hp_timing_t start, stop, diff;
+#endif
 
   if (l->l_relocated)
     return;
 
+#ifndef HP_TIMING_NONAVAIL
+  HP_TIMING_NOW (start);
+#endif
+
+  /* Take the bindings from an earlier run if they were kept.  */
+  if (_dl_bind_cache_dir != NULL)
+    _dl_bind_cache_open (l, scope);
+
   /* If DT_BIND_NOW is set relocate all references in this object.  We
      do not do this if we are profiling, of course.  */
   if (!consider_profiling
@@ -192,6 +212,15 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
 
       textrels = textrels->next;
     }
+
+  /* And keep what the lookups found for the next one.  */
+  _dl_bind_cache_sync (l);
+
+#ifndef HP_TIMING_NONAVAIL
+  HP_TIMING_NOW (stop);
+  HP_TIMING_DIFF (diff, start, stop);
+  HP_TIMING_ACCUM_NT (_dl_relocate_time, diff);
+#endif
 }
 
 #include <machine/dl-machine.h>
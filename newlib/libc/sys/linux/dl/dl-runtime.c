@@ -75,6 +75,8 @@ fixup (
   /* Sanity check that we're really looking at a PLT relocation.  */
   assert (ELFW(R_TYPE)(reloc->r_info) == ELF_MACHINE_JMP_SLOT);
 
+  ++_dl_num_lazy_fixups;
+
    /* Look up the target symbol.  If the normal lookup rules are not
       used don't look in the global scope.  */
   if (__builtin_expect (ELFW(ST_VISIBILITY) (sym->st_other), 0) == 0)
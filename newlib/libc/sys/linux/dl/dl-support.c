@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <libintl.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <pthread.h>
@@ -135,6 +136,81 @@ _dl_aux_init (ElfW(auxv_t) *av)
 }
 #endif
 
+/* Time spent relocating, kept by _dl_relocate_object.  */
+#ifndef HP_TIMING_NONAVAIL
+extern hp_timing_t _dl_relocate_time;
+#endif
+
+/* Set _dl_debug_mask from the value of LD_DEBUG.  */
+static void
+process_dl_debug (const char *dl_debug)
+{
+  static const struct
+  {
+    const char name[11];
+    int mask;
+  } debopts[] =
+    {
+      { "libs", DL_DEBUG_LIBS | DL_DEBUG_IMPCALLS },
+      { "reloc", DL_DEBUG_RELOC | DL_DEBUG_IMPCALLS },
+      { "files", DL_DEBUG_FILES | DL_DEBUG_IMPCALLS },
+      { "symbols", DL_DEBUG_SYMBOLS | DL_DEBUG_IMPCALLS },
+      { "bindings", DL_DEBUG_BINDINGS | DL_DEBUG_IMPCALLS },
+      { "versions", DL_DEBUG_VERSIONS | DL_DEBUG_IMPCALLS },
+      { "statistics", DL_DEBUG_STATISTICS },
+      { "all", (DL_DEBUG_LIBS | DL_DEBUG_RELOC | DL_DEBUG_FILES
+		| DL_DEBUG_SYMBOLS | DL_DEBUG_BINDINGS | DL_DEBUG_VERSIONS
+		| DL_DEBUG_IMPCALLS | DL_DEBUG_STATISTICS) }
+    };
+  size_t len, cnt;
+
+  while (*dl_debug != '\0')
+    {
+      len = strcspn (dl_debug, " ,:");
+      for (cnt = 0; cnt < sizeof (debopts) / sizeof (debopts[0]); ++cnt)
+	if (strlen (debopts[cnt].name) == len
+	    && memcmp (dl_debug, debopts[cnt].name, len) == 0)
+	  {
+	    _dl_debug_mask |= debopts[cnt].mask;
+	    break;
+	  }
+      dl_debug += len;
+      if (*dl_debug != '\0')
+	++dl_debug;
+    }
+}
+
+/* Write back the binding caches and print the statistics at exit.  */
+static void
+dl_exit_report (void)
+{
+  struct link_map *l;
+
+  for (l = _dl_loaded; l != NULL; l = l->l_next)
+    _dl_bind_cache_sync (l);
+
+  if (__builtin_expect (_dl_debug_mask & DL_DEBUG_STATISTICS, 0) == 0)
+    return;
+
+  _dl_debug_printf ("\n");
+  _dl_debug_printf ("                number of symbol lookups: %lu\n",
+		    _dl_num_relocations);
+  _dl_debug_printf ("        number of relocations from cache: %lu\n",
+		    _dl_num_cache_relocations);
+  _dl_debug_printf ("          number of relative relocations: %lu\n",
+		    _dl_num_relative_relocations);
+  _dl_debug_printf ("          number of lazy PLT relocations: %lu\n",
+		    _dl_num_lazy_relocations);
+  _dl_debug_printf ("               number of lazy PLT fixups: %lu\n",
+		    _dl_num_lazy_fixups);
+  _dl_debug_printf ("   number of bindings from LD_BIND_CACHE: %lu\n",
+		    _dl_num_bind_cache_hits);
+#ifndef HP_TIMING_NONAVAIL
+  _dl_debug_printf ("       time in relocation (clock cycles): %lu\n",
+		    (unsigned long int) _dl_relocate_time);
+#endif
+}
+
 void non_dynamic_init (void) __attribute__ ((unused));
 
 void
@@ -158,6 +234,19 @@ non_dynamic_init (void)
 
   _dl_dynamic_weak = *(getenv ("LD_DYNAMIC_WEAK") ?: "") == '\0';
 
+  process_dl_debug (getenv ("LD_DEBUG") ?: "");
+
+  /* A setuid or setgid program must not read or write its bindings
+     where its user says.  */
+  _dl_bind_cache_dir = getenv ("LD_BIND_CACHE");
+  if (_dl_bind_cache_dir != NULL
+      && (*_dl_bind_cache_dir == '\0'
+	  || getuid () != geteuid () || getgid () != getegid ()))
+    _dl_bind_cache_dir = NULL;
+
+  if (_dl_bind_cache_dir != NULL || (_dl_debug_mask & DL_DEBUG_STATISTICS))
+    atexit (dl_exit_report);
+
 #ifdef DL_PLATFORM_INIT
   DL_PLATFORM_INIT;
 #endif
@@ -19,18 +19,104 @@
 
 #if VERSIONED
 # define FCT do_lookup_versioned
+# define CHECK_MATCH check_match_versioned
 # define ARG const struct r_found_version *const version,
 #else
 # define FCT do_lookup
+# define CHECK_MATCH check_match
 # define ARG
 #endif
 
+/* Return SYMTAB[SYMIDX] if it is a definition of UNDEF_NAME we can use,
+   NULL if it is not.  Without a version, a symbol of a version other
+   than the default one is not taken, but counted in *NUM_VERSIONS and
+   kept in *VERSIONED_SYM.  */
+static inline const ElfW(Sym) *
+CHECK_MATCH (const char *undef_name, const ElfW(Sym) *ref,
+	     const ElfW(Sym) *symtab, const char *strtab,
+	     const ElfW(Half) *verstab, Elf_Symndx symidx, ARG
+	     struct link_map *map, int type_class,
+	     int *num_versions, const ElfW(Sym) **versioned_sym)
+{
+  const ElfW(Sym) *sym = &symtab[symidx];
+
+  assert (ELF_RTYPE_CLASS_PLT == 1);
+  if (sym->st_value == 0 || /* No value.  */
+      /* ((type_class & ELF_RTYPE_CLASS_PLT)
+	  && (sym->st_shndx == SHN_UNDEF)) */
+      (type_class & (sym->st_shndx == SHN_UNDEF)))
+    return NULL;
+
+  if (ELFW(ST_TYPE) (sym->st_info) > STT_FUNC
+      && ELFW(ST_TYPE) (sym->st_info) != STT_COMMON)
+    /* Ignore all but STT_NOTYPE, STT_OBJECT, STT_COMMON and
+       STT_FUNC entries since these are no code/data definitions.  */
+    return NULL;
+
+  if (sym != ref && strcmp (strtab + sym->st_name, undef_name))
+    /* Not the symbol we are looking for.  */
+    return NULL;
+
+#if VERSIONED
+  if (__builtin_expect (verstab == NULL, 0))
+    {
+      /* We need a versioned symbol but haven't found any.  If
+	 this is the object which is referenced in the verneed
+	 entry it is a bug in the library since a symbol must
+	 not simply disappear.
+
+	 It would also be a bug in the object since it means that
+	 the list of required versions is incomplete and so the
+	 tests in dl-version.c haven't found a problem.*/
+      assert (version->filename == NULL
+	      || ! _dl_name_match_p (version->filename, map));
+
+      /* Otherwise we accept the symbol.  */
+    }
+  else
+    {
+      /* We can match the version information or use the
+	 default one if it is not hidden.  */
+      ElfW(Half) ndx = verstab[symidx] & 0x7fff;
+      if ((map->l_versions[ndx].hash != version->hash
+	   || strcmp (map->l_versions[ndx].name, version->name))
+	  && (version->hidden || map->l_versions[ndx].hash
+	      || (verstab[symidx] & 0x8000)))
+	/* It's not the version we want.  */
+	return NULL;
+    }
+#else
+  /* No specific version is selected.  When the object file
+     also does not define a version we have a match.
+     Otherwise we accept the default version, or in case there
+     is only one version defined, this one version.  */
+  if (verstab != NULL)
+    {
+      ElfW(Half) ndx = verstab[symidx] & 0x7fff;
+      if (ndx > 2) /* map->l_versions[ndx].hash != 0) */
+	{
+	  /* Don't accept hidden symbols.  */
+	  if ((verstab[symidx] & 0x8000) == 0 && (*num_versions)++ == 0)
+	    /* No version so far.  */
+	    *versioned_sym = sym;
+	  return NULL;
+	}
+    }
+#endif
+
+  return sym;
+}
+
 /* Inner part of the lookup functions.  We return a value > 0 if we
    found the symbol, the value 0 if nothing is found and < 0 if
-   something bad happened.  */
+   something bad happened.  NEW_HASH is the GNU hash of UNDEF_NAME;
+   its ELF hash is computed into *OLD_HASH, which starts out as
+   0xffffffff, the first time an object without a GNU hash table is
+   searched.  */
 static inline int
-FCT (const char *undef_name, unsigned long int hash, const ElfW(Sym) *ref,
-     struct sym_val *result, struct r_scope_elem *scope, size_t i, ARG
+FCT (const char *undef_name, Elf32_Word new_hash, unsigned long int *old_hash,
+     const ElfW(Sym) *ref, struct sym_val *result,
+     struct r_scope_elem *scope, size_t i, ARG
      struct link_map *skip, int type_class)
 {
   struct link_map **list = scope->r_list;
@@ -44,10 +130,9 @@ FCT (const char *undef_name, unsigned long int hash, const ElfW(Sym) *ref,
       const ElfW(Half) *verstab;
       Elf_Symndx symidx;
       const ElfW(Sym) *sym;
-#if ! VERSIONED
       int num_versions = 0;
       const ElfW(Sym) *versioned_sym = NULL;
-#endif
+      const ElfW(Addr) *bitmask;
 
       map = list[i];
 
@@ -67,92 +152,83 @@ FCT (const char *undef_name, unsigned long int hash, const ElfW(Sym) *ref,
       symtab = (const void *) D_PTR (map, l_info[DT_SYMTAB]);
       strtab = (const void *) D_PTR (map, l_info[DT_STRTAB]);
       verstab = map->l_versyms;
+      sym = NULL;
 
-      /* Search the appropriate hash bucket in this object's symbol table
-	 for a definition for the same symbol name.  */
-      for (symidx = map->l_buckets[hash % map->l_nbuckets];
-	   symidx != STN_UNDEF;
-	   symidx = map->l_chain[symidx])
+      bitmask = map->l_gnu_bitmask;
+      if (__builtin_expect (bitmask != NULL, 1))
 	{
-	  sym = &symtab[symidx];
+	  /* Two bits of one word of the Bloom filter, both of which are
+	     set for every symbol of the object, rule most objects out
+	     without looking at their symbols.  */
+	  ElfW(Addr) bitmask_word
+	    = bitmask[(new_hash / __ELF_NATIVE_CLASS)
+		      & map->l_gnu_bitmask_idxbits];
+	  unsigned int hashbit1 = new_hash & (__ELF_NATIVE_CLASS - 1);
+	  unsigned int hashbit2 = ((new_hash >> map->l_gnu_shift)
+				   & (__ELF_NATIVE_CLASS - 1));
 
-	  assert (ELF_RTYPE_CLASS_PLT == 1);
-	  if (sym->st_value == 0 || /* No value.  */
-	      /* ((type_class & ELF_RTYPE_CLASS_PLT)
-		  && (sym->st_shndx == SHN_UNDEF)) */
-	      (type_class & (sym->st_shndx == SHN_UNDEF)))
-	    continue;
-
-	  if (ELFW(ST_TYPE) (sym->st_info) > STT_FUNC
-	      && ELFW(ST_TYPE) (sym->st_info) != STT_COMMON)
-	    /* Ignore all but STT_NOTYPE, STT_OBJECT, STT_COMMON and
-	       STT_FUNC entries since these are no code/data definitions.  */
-	    continue;
-
-	  if (sym != ref && strcmp (strtab + sym->st_name, undef_name))
-	    /* Not the symbol we are looking for.  */
-	    continue;
-
-#if VERSIONED
-	  if (__builtin_expect (verstab == NULL, 0))
-	    {
-	      /* We need a versioned symbol but haven't found any.  If
-		 this is the object which is referenced in the verneed
-		 entry it is a bug in the library since a symbol must
-		 not simply disappear.
-
-		 It would also be a bug in the object since it means that
-		 the list of required versions is incomplete and so the
-		 tests in dl-version.c haven't found a problem.*/
-	      assert (version->filename == NULL
-		      || ! _dl_name_match_p (version->filename, map));
-
-	      /* Otherwise we accept the symbol.  */
-	    }
-	  else
+	  symidx = STN_UNDEF;
+	  if (__builtin_expect ((bitmask_word >> hashbit1)
+				& (bitmask_word >> hashbit2) & 1, 0))
 	    {
-	      /* We can match the version information or use the
-		 default one if it is not hidden.  */
-	      ElfW(Half) ndx = verstab[symidx] & 0x7fff;
-	      if ((map->l_versions[ndx].hash != version->hash
-		   || strcmp (map->l_versions[ndx].name, version->name))
-		  && (version->hidden || map->l_versions[ndx].hash
-		      || (verstab[symidx] & 0x8000)))
-		/* It's not the version we want.  */
-		continue;
-	    }
-#else
-	  /* No specific version is selected.  When the object file
-	     also does not define a version we have a match.
-	     Otherwise we accept the default version, or in case there
-	     is only one version defined, this one version.  */
-	  if (verstab != NULL)
-	    {
-	      ElfW(Half) ndx = verstab[symidx] & 0x7fff;
-	      if (ndx > 2) /* map->l_versions[ndx].hash != 0) */
+	      Elf32_Word bucket = map->l_gnu_buckets[new_hash
+						     % map->l_nbuckets];
+	      if (bucket != 0)
 		{
-		  /* Don't accept hidden symbols.  */
-		  if ((verstab[symidx] & 0x8000) == 0 && num_versions++ == 0)
-		    /* No version so far.  */
-		    versioned_sym = sym;
-		  continue;
+		  /* The chain holds the hash values of the symbols of the
+		     bucket, less the lowest bit, which marks the last.
+		     Only the names of those with our hash are compared.  */
+		  const Elf32_Word *hasharr = &map->l_gnu_chain_zero[bucket];
+
+		  do
+		    if (((*hasharr ^ new_hash) >> 1) == 0)
+		      {
+			symidx = hasharr - map->l_gnu_chain_zero;
+			sym = CHECK_MATCH (undef_name, ref, symtab, strtab,
+					   verstab, symidx,
+#if VERSIONED
+					   version,
+#endif
+					   map, type_class,
+					   &num_versions, &versioned_sym);
+			if (sym != NULL)
+			  goto found_it;
+		      }
+		  while ((*hasharr++ & 1u) == 0);
 		}
+	      symidx = STN_UNDEF;
 	    }
-#endif
+	}
+      else
+	{
+	  if (*old_hash == 0xffffffff)
+	    *old_hash = _dl_elf_hash ((const unsigned char *) undef_name);
 
-	  /* There cannot be another entry for this symbol so stop here.  */
-	  goto found_it;
+	  /* Search the appropriate hash bucket in this object's symbol table
+	     for a definition for the same symbol name.  */
+	  for (symidx = map->l_buckets[*old_hash % map->l_nbuckets];
+	       symidx != STN_UNDEF;
+	       symidx = map->l_chain[symidx])
+	    {
+	      sym = CHECK_MATCH (undef_name, ref, symtab, strtab, verstab,
+				 symidx,
+#if VERSIONED
+				 version,
+#endif
+				 map, type_class,
+				 &num_versions, &versioned_sym);
+	      if (sym != NULL)
+		/* There cannot be another entry for this symbol so stop
+		   here.  */
+		goto found_it;
+	    }
 	}
 
       /* If we have seen exactly one versioned symbol while we are
 	 looking for an unversioned symbol and the version is not the
 	 default version we still accept this symbol since there are
 	 no possible ambiguities.  */
-#if VERSIONED
-      sym = NULL;
-#else
       sym = num_versions == 1 ? versioned_sym : NULL;
-#endif
 
       if (sym != NULL)
 	{
@@ -197,5 +273,6 @@ FCT (const char *undef_name, unsigned long int hash, const ElfW(Sym) *ref,
 }
 
 #undef FCT
+#undef CHECK_MATCH
 #undef ARG
 #undef VERSIONED
@@ -58,6 +58,7 @@ elf_dynamic_do_rel (struct link_map *map,
   if (lazy)
     {
       /* Doing lazy PLT relocations; they need very little info.  */
+      _dl_num_lazy_relocations += end - r;
       for (; r < end; ++r)
 	elf_machine_lazy_rel (map, l_addr, r);
     }
@@ -72,6 +73,8 @@ elf_dynamic_do_rel (struct link_map *map,
       r = MIN (r + nrelative, end);
 
 #ifndef RTLD_BOOTSTRAP
+      _dl_num_relative_relocations += r - relative;
+
       /* This is defined in rtld.c, but nowhere in the static libc.a; make
 	 the reference weak so static programs can still link.  This
 	 declaration cannot be done when compiling rtld.c (i.e. #ifdef
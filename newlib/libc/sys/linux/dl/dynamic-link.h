@@ -61,6 +61,8 @@ elf_get_dynamic_info (struct link_map *l)
       else if ((Elf32_Word) DT_EXTRATAGIDX (dyn->d_tag) < DT_EXTRANUM)
 	info[DT_EXTRATAGIDX (dyn->d_tag) + DT_NUM + DT_THISPROCNUM
 	     + DT_VERSIONTAGNUM] = dyn;
+      else if ((Elf32_Word) DL_ADDRTAGIDX (dyn->d_tag) < DL_ADDRNUM)
+	info[ADDRIDX (dyn->d_tag)] = dyn;
       else
 	assert (! "bad dynamic tag");
       ++dyn;
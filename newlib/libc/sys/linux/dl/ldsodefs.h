@@ -41,6 +41,11 @@ __BEGIN_DECLS
 #define ELFW(type)	_ElfW (ELF, __ELF_NATIVE_CLASS, type)
 
 #define internal_function 
+
+/* Index into l_info of the DT_ADDRRNGLO..DT_ADDRRNGHI tag TAG.  */
+#define ADDRIDX(tag)	(DT_NUM + DT_THISPROCNUM + DT_VERSIONTAGNUM \
+			 + DT_EXTRANUM + DL_ADDRTAGIDX (tag))
+
 /* All references to the value of l_info[DT_PLTGOT],
   l_info[DT_STRTAB], l_info[DT_SYMTAB], l_info[DT_RELA],
   l_info[DT_REL], l_info[DT_JMPREL], and l_info[VERSYMIDX (DT_VERSYM)]
@@ -247,6 +252,22 @@ extern const char _dl_out_of_memory[];
 /* Nonzero if runtime lookups should not update the .got/.plt.  */
 extern int _dl_bind_not;
 
+/* Directory of the persistent cache of symbol bindings (LD_BIND_CACHE),
+   or NULL if there is none.  */
+extern const char *_dl_bind_cache_dir;
+
+/* Bumped whenever objects are added to or removed from a lookup scope
+   of loaded objects, which the binding cache must then check again.  */
+extern unsigned long int _dl_scope_gen;
+
+/* Statistics, printed at exit with LD_DEBUG=statistics.  */
+extern unsigned long int _dl_num_relocations;	/* Symbol lookups.  */
+extern unsigned long int _dl_num_cache_relocations;
+extern unsigned long int _dl_num_relative_relocations;
+extern unsigned long int _dl_num_lazy_relocations;
+extern unsigned long int _dl_num_lazy_fixups;
+extern unsigned long int _dl_num_bind_cache_hits;
+
 /* List of search directories.  */
 extern struct r_search_path_elem *_dl_all_dirs;
 extern struct r_search_path_elem *_dl_init_all_dirs;
@@ -430,6 +451,37 @@ extern void _dl_relocate_object (struct link_map *map,
 				 struct r_scope_elem *scope[],
 				 int lazy, int consider_profiling);
 
+/* Attach to MAP the persistent cache of the bindings of its symbols in
+   SCOPE from the directory _dl_bind_cache_dir, or an empty one.  */
+extern void _dl_bind_cache_open (struct link_map *map,
+				 struct r_scope_elem *scope[])
+     internal_function;
+
+/* Look up the binding of the symbol REF of UNDEF_MAP in SCOPE for
+   TYPE_CLASS in its cache.  Return nonzero and set *SYM and *MAP if it
+   is there; *SYM is one of the symbols of *MAP, but whether it is a
+   definition of REF is for the caller to check.  */
+extern int _dl_bind_cache_lookup (struct link_map *undef_map,
+				  const ElfW(Sym) *ref,
+				  struct r_scope_elem *scope[], int type_class,
+				  const ElfW(Sym) **sym, struct link_map **map)
+     internal_function;
+
+/* Record in the cache of UNDEF_MAP that REF was bound to SYM of MAP.  */
+extern void _dl_bind_cache_record (struct link_map *undef_map,
+				   const ElfW(Sym) *ref,
+				   struct r_scope_elem *scope[],
+				   int type_class, const ElfW(Sym) *sym,
+				   struct link_map *map)
+     internal_function;
+
+/* Write out the cache of MAP if it has new bindings.  */
+extern void _dl_bind_cache_sync (struct link_map *map) internal_function;
+
+/* Write out and free the cache of MAP, which goes away, and keep the
+   caches of other objects from binding to it.  */
+extern void _dl_bind_cache_close (struct link_map *map) internal_function;
+
 /* Call _dl_signal_error with a message about an unhandled reloc type.
    TYPE is the result of ELFW(R_TYPE) (r_info), i.e. an R_<CPU>_* value.
    PLT is nonzero if this was a PLT reloc; it just affects the message.  */
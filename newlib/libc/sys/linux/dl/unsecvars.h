@@ -6,6 +6,7 @@
   "LD_LIBRARY_PATH\0"							      \
   "LD_ORIGIN_PATH\0"							      \
   "LD_DEBUG_OUTPUT\0"							      \
+  "LD_BIND_CACHE\0"							      \
   "LD_PROFILE\0"							      \
   "GCONV_PATH\0"							      \
   "HOSTALIASES\0"							      \
@@ -85,6 +85,25 @@ BUILTIN_TRANSFORMATION ("ANSI_X3.4-1968//", "INTERNAL", 1, "=ascii->INTERNAL",
 BUILTIN_TRANSFORMATION ("INTERNAL", "ANSI_X3.4-1968//", 1, "=INTERNAL->ascii",
 			__gconv_transform_internal_ascii, 4, 4, 1, 1)
 
+BUILTIN_ALIAS ("ISO-IR-100//", "ISO-8859-1//")
+BUILTIN_ALIAS ("ISO_8859-1:1987//", "ISO-8859-1//")
+BUILTIN_ALIAS ("ISO_8859-1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("ISO8859-1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("ISO88591//", "ISO-8859-1//")
+BUILTIN_ALIAS ("LATIN1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("L1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("IBM819//", "ISO-8859-1//")
+BUILTIN_ALIAS ("CP819//", "ISO-8859-1//")
+BUILTIN_ALIAS ("CSISOLATIN1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("8859_1//", "ISO-8859-1//")
+BUILTIN_ALIAS ("OSF00010001//", "ISO-8859-1//")
+
+BUILTIN_TRANSFORMATION ("ISO-8859-1//", "INTERNAL", 1, "=latin1->INTERNAL",
+			__gconv_transform_latin1_internal, 1, 1, 4, 4)
+
+BUILTIN_TRANSFORMATION ("INTERNAL", "ISO-8859-1//", 1, "=INTERNAL->latin1",
+			__gconv_transform_internal_latin1, 4, 4, 1, 1)
+
 
 #if BYTE_ORDER == BIG_ENDIAN
 BUILTIN_ALIAS ("UNICODEBIG//", "ISO-10646/UCS2/")
@@ -113,3 +132,49 @@ BUILTIN_TRANSFORMATION ("INTERNAL", "UNICODEBIG//", 1,
 			"=INTERNAL->ucs2reverse",
 			__gconv_transform_internal_ucs2reverse, 4, 4, 2, 2)
 #endif
+
+
+/* Direct conversions between the Unicode encodings and Latin-1.  They
+   do in one step what would otherwise take two through INTERNAL, and
+   being cheaper they are the ones find_derivation picks.  */
+BUILTIN_TRANSFORMATION ("ISO-10646/UTF8/", "ISO-10646/UCS4/", 1,
+			"=utf8->ucs4", __gconv_transform_utf8_ucs4,
+			1, 6, 4, 4)
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS4/", "ISO-10646/UTF8/", 1,
+			"=ucs4->utf8", __gconv_transform_ucs4_utf8,
+			4, 4, 1, 6)
+
+BUILTIN_TRANSFORMATION ("ISO-10646/UTF8/", "ISO-10646/UCS2/", 1,
+			"=utf8->ucs2", __gconv_transform_utf8_ucs2,
+			1, 6, 2, 2)
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS2/", "ISO-10646/UTF8/", 1,
+			"=ucs2->utf8", __gconv_transform_ucs2_utf8,
+			2, 2, 1, 3)
+
+BUILTIN_TRANSFORMATION ("ISO-10646/UTF8/", "ISO-8859-1//", 1,
+			"=utf8->latin1", __gconv_transform_utf8_latin1,
+			1, 6, 1, 1)
+BUILTIN_TRANSFORMATION ("ISO-8859-1//", "ISO-10646/UTF8/", 1,
+			"=latin1->utf8", __gconv_transform_latin1_utf8,
+			1, 1, 1, 2)
+
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS2/", "ISO-10646/UCS4/", 1,
+			"=ucs2->ucs4", __gconv_transform_ucs2_ucs4,
+			2, 2, 4, 4)
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS4/", "ISO-10646/UCS2/", 1,
+			"=ucs4->ucs2", __gconv_transform_ucs4_ucs2,
+			4, 4, 2, 2)
+
+BUILTIN_TRANSFORMATION ("ISO-8859-1//", "ISO-10646/UCS4/", 1,
+			"=latin1->ucs4", __gconv_transform_latin1_ucs4,
+			1, 1, 4, 4)
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS4/", "ISO-8859-1//", 1,
+			"=ucs4->latin1", __gconv_transform_ucs4_latin1,
+			4, 4, 1, 1)
+
+BUILTIN_TRANSFORMATION ("ISO-8859-1//", "ISO-10646/UCS2/", 1,
+			"=latin1->ucs2", __gconv_transform_latin1_ucs2,
+			1, 1, 2, 2)
+BUILTIN_TRANSFORMATION ("ISO-10646/UCS2/", "ISO-8859-1//", 1,
+			"=ucs2->latin1", __gconv_transform_ucs2_latin1,
+			2, 2, 1, 1)
@@ -18,24 +18,19 @@
    Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
    02111-1307 USA.  */
 
-#include <ctype.h>
-#include <locale.h>
+#include <gconv_int.h>
 
 
 static inline void
 strip (char *wp, const char *s)
 {
   int slash_count = 0;
-  char old_locale[20], *old_locale_p;
 
-  /* Set locale to default C locale. */
-  old_locale_p = setlocale(LC_ALL, "C");
-  strncpy(old_locale, old_locale_p, 20);
   while (*s != '\0')
     {
-      if (isalnum (*s)
+      if (__gconv_isalnum (*s)
 	  || *s == '_' || *s == '-' || *s == '.')
-	*wp++ = toupper (*s);
+	*wp++ = __gconv_toupper (*s);
       else if (*s == '/')
 	{
 	  if (++slash_count == 3)
@@ -49,7 +44,6 @@ strip (char *wp, const char *s)
     *wp++ = '/';
 
   *wp = '\0';
-  setlocale(LC_ALL, old_locale);
 }
 
 
@@ -57,13 +51,8 @@ static char * __attribute__ ((__unused__))
 upstr (char *dst, const char *str)
 {
   char *cp = dst;
-  char old_locale[20], *old_locale_p;
-  /* Set locale to default C locale. */
-  old_locale_p = setlocale(LC_ALL, "C");
-  strncpy(old_locale, old_locale_p, 20);
-  while ((*cp++ = toupper (*str++)) != '\0')
+  while ((*cp++ = __gconv_toupper (*str++)) != '\0')
     /* nothing */;
-  setlocale(LC_ALL, old_locale);
   return dst;
 }
 
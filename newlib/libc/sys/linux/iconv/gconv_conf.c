@@ -19,10 +19,8 @@
    02111-1307 USA.  */
 
 #include <assert.h>
-#include <ctype.h>
 #include <errno.h>
 #include <limits.h>
-#include <locale.h>
 #include <search.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -128,32 +126,25 @@ add_alias (char *rp, void *modules)
      (converted to UPPER case) and strored in the alias database.  */
   struct gconv_alias *new_alias;
   char *from, *to, *wp;
-  char old_locale[20], *old_locale_p;
 
-  /* Set locale to default C locale. */
-  old_locale_p = setlocale(LC_ALL, "C");
-  strncpy(old_locale, old_locale_p, 20);
-
-  while (isspace (*rp))
+  while (__gconv_isspace (*rp))
     ++rp;
   from = wp = rp;
-  while (*rp != '\0' && !isspace (*rp))
-    *wp++ = toupper (*rp++);
+  while (*rp != '\0' && !__gconv_isspace (*rp))
+    *wp++ = __gconv_toupper (*rp++);
   if (*rp == '\0')
     {
-      setlocale(LC_ALL, old_locale);
       /* There is no `to' string on the line.  Ignore it.  */
       return;
     }
   *wp++ = '\0';
   to = ++rp;
-  while (isspace (*rp))
+  while (__gconv_isspace (*rp))
     ++rp;
-  while (*rp != '\0' && !isspace (*rp))
-    *wp++ = toupper (*rp++);
+  while (*rp != '\0' && !__gconv_isspace (*rp))
+    *wp++ = __gconv_toupper (*rp++);
   if (to == wp)
     {
-      setlocale(LC_ALL, old_locale);
       /* No `to' string, ignore the line.  */
       return;
     }
@@ -162,7 +153,6 @@ add_alias (char *rp, void *modules)
   /* Test whether this alias conflicts with any available module.  */
   if (detect_conflict (from))
     {
-      setlocale(LC_ALL, old_locale);
       /* It does conflict, don't add the alias.  */
       return;
     }
@@ -183,7 +173,6 @@ add_alias (char *rp, void *modules)
 	/* Something went wrong, free this entry.  */
 	free (new_alias);
     }
-  setlocale(LC_ALL, old_locale);
 }
 
 
@@ -263,48 +252,34 @@ add_module (char *rp, const char *directory, size_t dir_len, void **modules,
   char *from, *to, *module, *wp;
   int need_ext;
   int cost_hi;
-  char old_locale[20], *old_locale_p;
   char *old;
   size_t len;
   char *new;
 
-  /* Set locale to default C locale. */
-  old_locale_p = setlocale(LC_ALL, "C");
-  strncpy(old_locale, old_locale_p, 20);
-
-  while (isspace (*rp))
+  while (__gconv_isspace (*rp))
     ++rp;
   from = rp;
-  while (*rp != '\0' && !isspace (*rp))
+  while (*rp != '\0' && !__gconv_isspace (*rp))
     {
-      *rp = toupper (*rp);
+      *rp = __gconv_toupper (*rp);
       ++rp;
     }
   if (*rp == '\0')
-    {
-      setlocale(LC_ALL, old_locale);
-      return;
-    }
+    return;
   *rp++ = '\0';
   to = wp = rp;
-  while (isspace (*rp))
-    {
-      setlocale(LC_ALL, old_locale);
-      ++rp;
-    }
-  while (*rp != '\0' && !isspace (*rp))
-    *wp++ = toupper (*rp++);
+  while (__gconv_isspace (*rp))
+    ++rp;
+  while (*rp != '\0' && !__gconv_isspace (*rp))
+    *wp++ = __gconv_toupper (*rp++);
   if (*rp == '\0')
-    {
-      setlocale(LC_ALL, old_locale);
-      return;
-    }
+    return;
   *wp++ = '\0';
   do
     ++rp;
-  while (isspace (*rp));
+  while (__gconv_isspace (*rp));
   module = wp;
-  while (*rp != '\0' && !isspace (*rp))
+  while (*rp != '\0' && !__gconv_isspace (*rp))
     *wp++ = *rp++;
   if (*rp == '\0')
     {
@@ -326,7 +301,6 @@ add_module (char *rp, const char *directory, size_t dir_len, void **modules,
 
   if (module[0] == '\0')
     {
-      setlocale(LC_ALL, old_locale);
       /* No module name given.  */
       return;
     }
@@ -350,7 +324,6 @@ add_module (char *rp, const char *directory, size_t dir_len, void **modules,
 
   if (tfind (&fake_alias, &__gconv_alias_db, __gconv_alias_compare) != NULL)
     {
-      setlocale(LC_ALL, old_locale);
       /* This module duplicates an alias.  */
       return;
     }
@@ -391,7 +364,6 @@ add_module (char *rp, const char *directory, size_t dir_len, void **modules,
       /* Now insert the new module data structure in our search tree.  */
       insert_module (new_module, 1);
     }
-  setlocale(LC_ALL, old_locale);
 }
 
 
@@ -405,17 +377,12 @@ read_conf_file (const char *filename, const char *directory, size_t dir_len,
   char *line = NULL;
   size_t line_len = 0;
   static int modcounter;
-  char old_locale[20], *old_locale_p;
 
   /* Don't complain if a file is not present or readable, simply silently
      ignore it.  */
   if (fp == NULL)
     return;
 
-  /* Set locale to default C locale. */
-  old_locale_p = setlocale(LC_ALL, "C");
-  strncpy(old_locale, old_locale_p, 20);
-
   /* Process the known entries of the file.  Comments start with `#' and
      end with the end of the line.  Empty lines are ignored.  */
   while (!feof (fp))
@@ -436,7 +403,7 @@ read_conf_file (const char *filename, const char *directory, size_t dir_len,
 	if (rp[n - 1] == '\n')
 	  rp[n - 1] = '\0';
 
-      while (isspace (*rp))
+      while (__gconv_isspace (*rp))
 	++rp;
 
       /* If this is an empty line go on with the next one.  */
@@ -444,7 +411,7 @@ read_conf_file (const char *filename, const char *directory, size_t dir_len,
 	continue;
 
       word = rp;
-      while (*rp != '\0' && !isspace (*rp))
+      while (*rp != '\0' && !__gconv_isspace (*rp))
 	++rp;
 
       if (rp - word == sizeof ("alias") - 1
@@ -461,7 +428,6 @@ read_conf_file (const char *filename, const char *directory, size_t dir_len,
 
   fclose (fp);
 
-  setlocale(LC_ALL, old_locale);
 }
 
 
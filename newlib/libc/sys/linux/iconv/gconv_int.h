@@ -125,6 +125,30 @@ extern struct gconv_module *__gconv_modules_db;
 extern const char *__gconv_path_envvar;
 
 
+/* Character set names and the configuration files are ASCII, and are
+   split and upcased as in the C locale whatever the program's locale
+   is.  Switching to the C locale with setlocale for that would change
+   it for every thread of the program.  */
+static inline int
+__gconv_isspace (int c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int
+__gconv_isalnum (int c)
+{
+  return ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z')
+	  || (c >= 'a' && c <= 'z'));
+}
+
+static inline int
+__gconv_toupper (int c)
+{
+  return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
+}
+
+
 /* The gconv functions expects the name to be in upper case and complete,
    including the trailing slashes if necessary.  */
 #define norm_add_slashes(str,suffix) \
@@ -267,6 +291,8 @@ extern int __gconv_transliterate (struct __gconv_step *step,
 
 __BUILTIN_TRANS (__gconv_transform_ascii_internal);
 __BUILTIN_TRANS (__gconv_transform_internal_ascii);
+__BUILTIN_TRANS (__gconv_transform_latin1_internal);
+__BUILTIN_TRANS (__gconv_transform_internal_latin1);
 __BUILTIN_TRANS (__gconv_transform_utf8_internal);
 __BUILTIN_TRANS (__gconv_transform_internal_utf8);
 __BUILTIN_TRANS (__gconv_transform_ucs2_internal);
@@ -279,6 +305,18 @@ __BUILTIN_TRANS (__gconv_transform_internal_ucs4le);
 __BUILTIN_TRANS (__gconv_transform_ucs4le_internal);
 __BUILTIN_TRANS (__gconv_transform_internal_utf16);
 __BUILTIN_TRANS (__gconv_transform_utf16_internal);
+__BUILTIN_TRANS (__gconv_transform_utf8_ucs4);
+__BUILTIN_TRANS (__gconv_transform_ucs4_utf8);
+__BUILTIN_TRANS (__gconv_transform_utf8_ucs2);
+__BUILTIN_TRANS (__gconv_transform_ucs2_utf8);
+__BUILTIN_TRANS (__gconv_transform_utf8_latin1);
+__BUILTIN_TRANS (__gconv_transform_latin1_utf8);
+__BUILTIN_TRANS (__gconv_transform_ucs2_ucs4);
+__BUILTIN_TRANS (__gconv_transform_ucs4_ucs2);
+__BUILTIN_TRANS (__gconv_transform_latin1_ucs4);
+__BUILTIN_TRANS (__gconv_transform_ucs4_latin1);
+__BUILTIN_TRANS (__gconv_transform_latin1_ucs2);
+__BUILTIN_TRANS (__gconv_transform_ucs2_latin1);
 # undef __BUITLIN_TRANS
 
 #endif
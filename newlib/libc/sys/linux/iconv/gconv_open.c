@@ -19,7 +19,6 @@
    02111-1307 USA.  */
 
 #include <errno.h>
-#include <locale.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -39,7 +38,6 @@ __gconv_open (const char *toset, const char *fromset, __gconv_t *handle,
   const char *errhand;
   const char *ignore;
   struct trans_struct *trans = NULL;
-  char old_locale[20], *old_locale_p;
   char *old, *new;
   size_t len;
 
@@ -69,10 +67,6 @@ __gconv_open (const char *toset, const char *fromset, __gconv_t *handle,
 
 	  tok = strtok_r (tok, ",", &ptr);
 
-          /* Set locale to default C locale. */
-          old_locale_p = setlocale(LC_ALL, "C");
-          strncpy(old_locale, old_locale_p, 20);
-
 	  while (tok != NULL)
 	    {
 	      if (strcasecmp (tok, "TRANSLIT") == 0)
@@ -324,6 +318,5 @@ __gconv_open (const char *toset, const char *fromset, __gconv_t *handle,
     }
 
   *handle = result;
-  setlocale(LC_ALL, old_locale);
   return res;
 }
@@ -251,8 +251,11 @@ ucs4_internal_loop (struct __gconv_step *step,
 
 	  if (flags & __GCONV_IGNORE_ERRORS)
 	    {
-	      /* Just ignore this character.  */
+	      /* Just ignore this character.  It takes no room in the
+		 output, so there may be room for one more.  */
 	      *irreversible = *irreversible + 1;
+	      if (n_convert < (size_t) (inend - *inptrp) / 4)
+		++n_convert;
 	      continue;
 	    }
 
@@ -297,7 +300,7 @@ ucs4_internal_loop_unaligned (struct __gconv_step *step,
 
   for (cnt = 0; cnt < n_convert; ++cnt, inptr += 4)
     {
-      if (__builtin_expect (inptr[0] > 0x80, 0))
+      if (__builtin_expect (inptr[0] > 0x7f, 0))
 	{
 	  /* The value is too large.  We don't try transliteration here since
 	     this is not an error because of the lack of possibilities to
@@ -309,8 +312,11 @@ ucs4_internal_loop_unaligned (struct __gconv_step *step,
 
 	  if (flags & __GCONV_IGNORE_ERRORS)
 	    {
-	      /* Just ignore this character.  */
+	      /* Just ignore this character.  It takes no room in the
+		 output, so there may be room for one more.  */
 	      *irreversible = *irreversible + 1;
+	      if (n_convert < (size_t) (inend - *inptrp) / 4)
+		++n_convert;
 	      continue;
 	    }
 
@@ -373,7 +379,7 @@ ucs4_internal_loop_single (struct __gconv_step *step,
       return __GCONV_INCOMPLETE_INPUT;
     }
 
-  if (__builtin_expect (((unsigned char *) state->__value.__wchb)[0] > 0x80,
+  if (__builtin_expect (((unsigned char *) state->__value.__wchb)[0] > 0x7f,
 			0))
     {
       /* The value is too large.  We don't try transliteration here since
@@ -610,8 +616,11 @@ ucs4le_internal_loop (struct __gconv_step *step,
 
 	  if (flags & __GCONV_IGNORE_ERRORS)
 	    {
-	      /* Just ignore this character.  */
+	      /* Just ignore this character.  It takes no room in the
+		 output, so there may be room for one more.  */
 	      ++*irreversible;
+	      if (n_convert < (size_t) (inend - *inptrp) / 4)
+		++n_convert;
 	      continue;
 	    }
 
@@ -654,7 +663,7 @@ ucs4le_internal_loop_unaligned (struct __gconv_step *step,
 
   for (cnt = 0; cnt < n_convert; ++cnt, inptr += 4)
     {
-      if (__builtin_expect (inptr[3] > 0x80, 0))
+      if (__builtin_expect (inptr[3] > 0x7f, 0))
 	{
 	  /* The value is too large.  We don't try transliteration here since
 	     this is not an error because of the lack of possibilities to
@@ -666,8 +675,11 @@ ucs4le_internal_loop_unaligned (struct __gconv_step *step,
 
 	  if (flags & __GCONV_IGNORE_ERRORS)
 	    {
-	      /* Just ignore this character.  */
+	      /* Just ignore this character.  It takes no room in the
+		 output, so there may be room for one more.  */
 	      ++*irreversible;
+	      if (n_convert < (size_t) (inend - *inptrp) / 4)
+		++n_convert;
 	      continue;
 	    }
 
@@ -731,7 +743,7 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
       return __GCONV_INCOMPLETE_INPUT;
     }
 
-  if (__builtin_expect (((unsigned char *) state->__value.__wchb)[3] > 0x80,
+  if (__builtin_expect (((unsigned char *) state->__value.__wchb)[3] > 0x7f,
 			0))
     {
       /* The value is too large.  We don't try transliteration here since
@@ -845,33 +857,79 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #include <iconv/skeleton.c>
 
 
-/* Convert from the internal (UCS4-like) format to UTF-8.  */
+/* Convert from ISO 8859-1 to the internal (UCS4-like) format.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MIN_NEEDED_TO		4
+#define FROM_DIRECTION		1
+#define FROM_LOOP		latin1_internal_loop
+#define TO_LOOP			latin1_internal_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_latin1_internal
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY \
+  {									      \
+    /* Every byte is the character with the same value.  */		      \
+    *((uint32_t *) outptr) = *inptr++;					      \
+    outptr = (unsigned char *)((uint32_t *) outptr + 1);		      \
+  }
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from the internal (UCS4-like) format to ISO 8859-1.  */
 #define DEFINE_INIT		0
 #define DEFINE_FINI		0
 #define MIN_NEEDED_FROM		4
 #define MIN_NEEDED_TO		1
-#define MAX_NEEDED_TO		6
 #define FROM_DIRECTION		1
-#define FROM_LOOP		internal_utf8_loop
-#define TO_LOOP			internal_utf8_loop /* This is not used.  */
-#define FUNCTION_NAME		__gconv_transform_internal_utf8
+#define FROM_LOOP		internal_latin1_loop
+#define TO_LOOP			internal_latin1_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_internal_latin1
 #define ONE_DIRECTION		1
 
 #define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
 #define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
-#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
 #define LOOPFCT			FROM_LOOP
 #define BODY \
   {									      \
-    uint32_t wc = *((const uint32_t *) inptr);				      \
+    uint32_t ch = *((const uint32_t *) inptr);				      \
 									      \
-    if (wc < 0x80)							      \
+    if (__builtin_expect (ch > 0xff, 0))				      \
+      {									      \
+	UNICODE_TAG_HANDLER (ch, 4);					      \
+									      \
+	/* We have an illegal character.  */				      \
+	STANDARD_ERR_HANDLER (4);					      \
+      }									      \
+    else								      \
+      {									      \
+	*outptr++ = (unsigned char) ch;					      \
+	inptr += 4;							      \
+      }									      \
+  }
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Store the character CH, which is at most 0x7fffffff, in UTF-8.  If
+   there is no room for all of its bytes the loop stops with
+   __GCONV_FULL_OUTPUT.  */
+#define UTF8_PUT_CHAR \
+  {									      \
+    if (ch < 0x80)							      \
       /* It's an one byte sequence.  */					      \
-      *outptr++ = (unsigned char) wc;					      \
-    else if (__builtin_expect (wc <= 0x7fffffff, 1))			      \
+      *outptr++ = (unsigned char) ch;					      \
+    else								      \
       {									      \
+	uint32_t wc = ch;						      \
 	size_t step;							      \
-	char *start;							      \
+	unsigned char *start;						      \
 									      \
 	for (step = 2; step < 6; ++step)				      \
 	  if ((wc & (~(uint32_t)0 << (5 * step + 1))) == 0)		      \
@@ -896,60 +954,68 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 	while (--step > 0);						      \
 	start[0] |= wc;							      \
       }									      \
-    else								      \
-      {									      \
-	STANDARD_ERR_HANDLER (4);					      \
-      }									      \
-									      \
-    inptr += 4;								      \
   }
-#define LOOP_NEED_FLAGS
-#include <iconv/loop.c>
-#include <iconv/skeleton.c>
 
 
-/* Convert from UTF-8 to the internal (UCS4-like) format.  */
+/* Convert from the internal (UCS4-like) format to UTF-8.  */
 #define DEFINE_INIT		0
 #define DEFINE_FINI		0
-#define MIN_NEEDED_FROM		1
-#define MAX_NEEDED_FROM		6
-#define MIN_NEEDED_TO		4
+#define MIN_NEEDED_FROM		4
+#define MIN_NEEDED_TO		1
+#define MAX_NEEDED_TO		6
 #define FROM_DIRECTION		1
-#define FROM_LOOP		utf8_internal_loop
-#define TO_LOOP			utf8_internal_loop /* This is not used.  */
-#define FUNCTION_NAME		__gconv_transform_utf8_internal
+#define FROM_LOOP		internal_utf8_loop
+#define TO_LOOP			internal_utf8_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_internal_utf8
 #define ONE_DIRECTION		1
 
 #define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
-#define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
 #define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
 #define LOOPFCT			FROM_LOOP
 #define BODY \
   {									      \
-    uint32_t ch;							      \
-    uint32_t cnt;							      \
-    uint32_t i;							      \
+    uint32_t ch = *((const uint32_t *) inptr);				      \
+									      \
+    if (__builtin_expect (ch > 0x7fffffff, 0))				      \
+      {									      \
+	STANDARD_ERR_HANDLER (4);					      \
+      }									      \
+									      \
+    UTF8_PUT_CHAR							      \
+    inptr += 4;								      \
+  }
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Read the UTF-8 sequence at INPTR into CH and its length into CNT,
+   leaving INPTR at its start.  An ill-formed sequence stops the loop
+   with __GCONV_ILLEGAL_INPUT or, if errors are ignored, is skipped; one
+   cut short by the end of the input stops it with
+   __GCONV_INCOMPLETE_INPUT.  */
+#define UTF8_GET_CHAR \
+  {									      \
+    uint32_t i;								      \
 									      \
     /* Next input byte.  */						      \
     ch = *inptr;							      \
 									      \
     if (ch < 0x80)							      \
-      {									      \
-	/* One byte sequence.  */					      \
-	cnt = 1;							      \
-	++inptr;							      \
-      }									      \
+      /* One byte sequence.  */						      \
+      cnt = 1;								      \
     else								      \
       {									      \
- 	if (ch >= 0xc2 && ch < 0xe0)					      \
+	if (ch >= 0xc2 && ch < 0xe0)					      \
 	  {								      \
- 	    /* We expect two bytes.  The first byte cannot be 0xc0 or 0xc1,   \
- 	       otherwise the wide character could have been represented	      \
- 	       using a single byte.  */					      \
+	    /* We expect two bytes.  The first byte cannot be 0xc0 or 0xc1,   \
+	       otherwise the wide character could have been represented	      \
+	       using a single byte.  */					      \
 	    cnt = 2;							      \
 	    ch &= 0x1f;							      \
 	  }								      \
-        else if (__builtin_expect ((ch & 0xf0) == 0xe0, 1))		      \
+	else if (__builtin_expect ((ch & 0xf0) == 0xe0, 1))		      \
 	  {								      \
 	    /* We expect three bytes.  */				      \
 	    cnt = 3;							      \
@@ -986,15 +1052,15 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 									      \
 	    /* Search the end of this ill-formed UTF-8 character.  This	      \
 	       is the next byte with (x & 0xc0) != 0x80.  */		      \
-	     skipped = 0;						      \
-	     do								      \
-	       {							      \
-		 ++inptr;						      \
-		 ++skipped;						      \
-	       }							      \
-	     while (inptr < inend && (*inptr & 0xc0) == 0x80 && skipped < 5); \
+	    skipped = 0;						      \
+	    do								      \
+	      {								      \
+		++inptr;						      \
+		++skipped;						      \
+	      }								      \
+	    while (inptr < inend && (*inptr & 0xc0) == 0x80 && skipped < 5);  \
 									      \
-	     continue;							      \
+	    continue;							      \
 	  }								      \
 									      \
 	if (__builtin_expect (inptr + cnt > inend, 0))			      \
@@ -1052,17 +1118,13 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 	    result = __GCONV_ILLEGAL_INPUT;				      \
 	    break;							      \
 	  }								      \
-									      \
-	inptr += cnt;							      \
       }									      \
-									      \
-    /* Now adjust the pointers and store the result.  */		      \
-    *((uint32_t *) outptr) = ch;					      \
-    outptr = (unsigned char *)((uint32_t *) outptr + 1);		      \
   }
-#define LOOP_NEED_FLAGS
 
-#define STORE_REST \
+/* An incomplete UTF-8 sequence at the end of the input is kept in the
+   state as the part of the wide character read so far, and the number
+   of its bytes.  */
+#define UTF8_STORE_REST \
   {									      \
     /* We store the remaining bytes while converting them into the UCS4	      \
        format.  We can assume that the first byte in the buffer is	      \
@@ -1122,7 +1184,7 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
     state->__value.__wch = ch;						      \
   }
 
-#define UNPACK_BYTES \
+#define UTF8_UNPACK_BYTES \
   {									      \
     wint_t wch = state->__value.__wch;					      \
     size_t ntotal;							      \
@@ -1165,6 +1227,37 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
     bytebuf[0] |= wch;							      \
   }
 
+/* Convert from UTF-8 to the internal (UCS4-like) format.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MAX_NEEDED_FROM		6
+#define MIN_NEEDED_TO		4
+#define FROM_DIRECTION		1
+#define FROM_LOOP		utf8_internal_loop
+#define TO_LOOP			utf8_internal_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_utf8_internal
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY \
+  {									      \
+    uint32_t ch;							      \
+    uint32_t cnt;							      \
+									      \
+    UTF8_GET_CHAR							      \
+    inptr += cnt;							      \
+									      \
+    /* Now adjust the pointers and store the result.  */		      \
+    *((uint32_t *) outptr) = ch;					      \
+    outptr = (unsigned char *)((uint32_t *) outptr + 1);		      \
+  }
+#define LOOP_NEED_FLAGS
+#define STORE_REST		UTF8_STORE_REST
+#define UNPACK_BYTES		UTF8_UNPACK_BYTES
 #include <iconv/loop.c>
 #include <iconv/skeleton.c>
 
@@ -1352,3 +1445,372 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #define LOOP_NEED_FLAGS
 #include <iconv/loop.c>
 #include <iconv/skeleton.c>
+
+
+/* The conversions below go from one of UTF-8, UCS-2, UCS-4 and ISO 8859-1
+   to another in a single step instead of two through the internal
+   format.  Each character is read into CH, with the length of its
+   encoding in CNT, and written with the checks the two steps would
+   make.  Transliteration is only tried on steps from the internal
+   format, so when a character cannot be written here it is either
+   ignored or an error.  */
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+# define get_ucs4(addr)		bswap_32 (get32 (addr))
+# define put_ucs4(addr, val)	put32 (addr, bswap_32 (val))
+#else
+# define get_ucs4(addr)		get32 (addr)
+# define put_ucs4(addr, val)	put32 (addr, val)
+#endif
+
+#define UCS4_GET_CHAR \
+  {									      \
+    ch = get_ucs4 (inptr);						      \
+    cnt = 4;								      \
+									      \
+    if (__builtin_expect (ch > 0x7fffffff, 0))				      \
+      {									      \
+	/* The value is too large.  This is a genuine bug in the input	      \
+	   since UCS4 does not allow such values.  */			      \
+	if (! ignore_errors_p ())					      \
+	  {								      \
+	    result = __GCONV_ILLEGAL_INPUT;				      \
+	    break;							      \
+	  }								      \
+	inptr += 4;							      \
+	*irreversible = *irreversible + 1;				      \
+	continue;							      \
+      }									      \
+  }
+
+#define UCS4_PUT_CHAR \
+  {									      \
+    put_ucs4 (outptr, ch);						      \
+    outptr += 4;							      \
+  }
+
+#define UCS2_GET_CHAR \
+  {									      \
+    ch = get16 (inptr);							      \
+    cnt = 2;								      \
+									      \
+    if (__builtin_expect (ch >= 0xd800 && ch < 0xe000, 0))		      \
+      {									      \
+	/* Surrogate characters in UCS-2 input are not valid.  */	      \
+	if (! ignore_errors_p ())					      \
+	  {								      \
+	    result = __GCONV_ILLEGAL_INPUT;				      \
+	    break;							      \
+	  }								      \
+	inptr += 2;							      \
+	*irreversible = *irreversible + 1;				      \
+	continue;							      \
+      }									      \
+  }
+
+#define UCS2_PUT_CHAR \
+  {									      \
+    if (__builtin_expect (ch >= 0x10000, 0))				      \
+      {									      \
+	UNICODE_TAG_HANDLER (ch, cnt);					      \
+	STANDARD_ERR_HANDLER (cnt);					      \
+      }									      \
+    else if (__builtin_expect (ch >= 0xd800 && ch < 0xe000, 0))		      \
+      {									      \
+	/* Surrogate characters are not valid, see the conversion from	      \
+	   the internal format to UCS2 above.  */			      \
+	if (! ignore_errors_p ())					      \
+	  {								      \
+	    result = __GCONV_ILLEGAL_INPUT;				      \
+	    break;							      \
+	  }								      \
+	inptr += cnt;							      \
+	*irreversible = *irreversible + 1;				      \
+	continue;							      \
+      }									      \
+									      \
+    put16 (outptr, ch);							      \
+    outptr += 2;							      \
+  }
+
+#define LATIN1_GET_CHAR \
+  {									      \
+    ch = *inptr;							      \
+    cnt = 1;								      \
+  }
+
+#define LATIN1_PUT_CHAR \
+  {									      \
+    if (__builtin_expect (ch > 0xff, 0))				      \
+      {									      \
+	UNICODE_TAG_HANDLER (ch, cnt);					      \
+	STANDARD_ERR_HANDLER (cnt);					      \
+      }									      \
+									      \
+    *outptr++ = (unsigned char) ch;					      \
+  }
+
+#define CONVERT_CHAR(Get, Put) \
+  {									      \
+    uint32_t ch;							      \
+    uint32_t cnt;							      \
+									      \
+    Get									      \
+    Put									      \
+    inptr += cnt;							      \
+  }
+
+
+/* Convert from UTF-8 to UCS4.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MAX_NEEDED_FROM		6
+#define MIN_NEEDED_TO		4
+#define FROM_DIRECTION		1
+#define FROM_LOOP		utf8_ucs4_loop
+#define TO_LOOP			utf8_ucs4_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_utf8_ucs4
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UTF8_GET_CHAR, UCS4_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#define STORE_REST		UTF8_STORE_REST
+#define UNPACK_BYTES		UTF8_UNPACK_BYTES
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS4 to UTF-8.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		4
+#define MIN_NEEDED_TO		1
+#define MAX_NEEDED_TO		6
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs4_utf8_loop
+#define TO_LOOP			ucs4_utf8_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs4_utf8
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS4_GET_CHAR, UTF8_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UTF-8 to UCS2.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MAX_NEEDED_FROM		6
+#define MIN_NEEDED_TO		2
+#define FROM_DIRECTION		1
+#define FROM_LOOP		utf8_ucs2_loop
+#define TO_LOOP			utf8_ucs2_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_utf8_ucs2
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UTF8_GET_CHAR, UCS2_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#define STORE_REST		UTF8_STORE_REST
+#define UNPACK_BYTES		UTF8_UNPACK_BYTES
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS2 to UTF-8.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		2
+#define MIN_NEEDED_TO		1
+#define MAX_NEEDED_TO		3
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs2_utf8_loop
+#define TO_LOOP			ucs2_utf8_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs2_utf8
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS2_GET_CHAR, UTF8_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UTF-8 to ISO 8859-1.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MAX_NEEDED_FROM		6
+#define MIN_NEEDED_TO		1
+#define FROM_DIRECTION		1
+#define FROM_LOOP		utf8_latin1_loop
+#define TO_LOOP			utf8_latin1_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_utf8_latin1
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UTF8_GET_CHAR, LATIN1_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#define STORE_REST		UTF8_STORE_REST
+#define UNPACK_BYTES		UTF8_UNPACK_BYTES
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from ISO 8859-1 to UTF-8.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MIN_NEEDED_TO		1
+#define MAX_NEEDED_TO		2
+#define FROM_DIRECTION		1
+#define FROM_LOOP		latin1_utf8_loop
+#define TO_LOOP			latin1_utf8_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_latin1_utf8
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (LATIN1_GET_CHAR, UTF8_PUT_CHAR)
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS2 to UCS4.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		2
+#define MIN_NEEDED_TO		4
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs2_ucs4_loop
+#define TO_LOOP			ucs2_ucs4_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs2_ucs4
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS2_GET_CHAR, UCS4_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS4 to UCS2.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		4
+#define MIN_NEEDED_TO		2
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs4_ucs2_loop
+#define TO_LOOP			ucs4_ucs2_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs4_ucs2
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS4_GET_CHAR, UCS2_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from ISO 8859-1 to UCS4.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MIN_NEEDED_TO		4
+#define FROM_DIRECTION		1
+#define FROM_LOOP		latin1_ucs4_loop
+#define TO_LOOP			latin1_ucs4_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_latin1_ucs4
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (LATIN1_GET_CHAR, UCS4_PUT_CHAR)
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS4 to ISO 8859-1.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		4
+#define MIN_NEEDED_TO		1
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs4_latin1_loop
+#define TO_LOOP			ucs4_latin1_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs4_latin1
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS4_GET_CHAR, LATIN1_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from ISO 8859-1 to UCS2.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MIN_NEEDED_TO		2
+#define FROM_DIRECTION		1
+#define FROM_LOOP		latin1_ucs2_loop
+#define TO_LOOP			latin1_ucs2_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_latin1_ucs2
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (LATIN1_GET_CHAR, UCS2_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
+/* Convert from UCS2 to ISO 8859-1.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		2
+#define MIN_NEEDED_TO		1
+#define FROM_DIRECTION		1
+#define FROM_LOOP		ucs2_latin1_loop
+#define TO_LOOP			ucs2_latin1_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_ucs2_latin1
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY			CONVERT_CHAR (UCS2_GET_CHAR, LATIN1_PUT_CHAR)
+#define LOOP_NEED_FLAGS
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
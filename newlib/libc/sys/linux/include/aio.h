@@ -0,0 +1,124 @@
+/* libc/sys/linux/include/aio.h - asynchronous I/O */
+
+/* The layout of the control blocks follows glibc, so that the 64-bit
+   variants can share the implementation with the 32-bit ones.  */
+
+#ifndef _AIO_H
+#define _AIO_H
+
+#include <sys/types.h>
+#include <signal.h>
+#include <time.h>
+
+/* Asynchronous I/O control block.  */
+struct aiocb
+{
+  int aio_fildes;		/* File descriptor.  */
+  int aio_lio_opcode;		/* Operation to be performed.  */
+  int aio_reqprio;		/* Request priority offset.  */
+  volatile void *aio_buf;	/* Location of buffer.  */
+  size_t aio_nbytes;		/* Length of transfer.  */
+  struct sigevent aio_sigevent;	/* Signal number and value.  */
+
+  /* Internal members.  */
+  struct aiocb *__next_prio;
+  int __abs_prio;
+  int __policy;
+  int __error_code;
+  ssize_t __return_value;
+
+  off_t aio_offset;		/* File offset.  */
+  char __pad[sizeof (off64_t) - sizeof (off_t)];
+  char __unused[32];
+};
+
+/* The same with 64 bit offsets.  */
+struct aiocb64
+{
+  int aio_fildes;
+  int aio_lio_opcode;
+  int aio_reqprio;
+  volatile void *aio_buf;
+  size_t aio_nbytes;
+  struct sigevent aio_sigevent;
+
+  struct aiocb *__next_prio;
+  int __abs_prio;
+  int __policy;
+  int __error_code;
+  ssize_t __return_value;
+
+  off64_t aio_offset;
+  char __unused[32];
+};
+
+/* Tuning of the implementation, see aio_init.  */
+struct aioinit
+{
+  int aio_threads;		/* Maximum number of worker threads.  */
+  int aio_num;			/* Number of expected simultaneous requests.  */
+  int aio_locks;		/* Not used.  */
+  int aio_usedba;		/* Not used.  */
+  int aio_debug;		/* Not used.  */
+  int aio_numusers;		/* Not used.  */
+  int aio_idle_time;		/* Seconds before an idle thread exits.  */
+  int aio_reserved;
+};
+
+/* Return values of aio_cancel.  */
+enum
+{
+  AIO_CANCELED,
+  AIO_NOTCANCELED,
+  AIO_ALLDONE
+};
+#define AIO_CANCELED AIO_CANCELED
+#define AIO_NOTCANCELED AIO_NOTCANCELED
+#define AIO_ALLDONE AIO_ALLDONE
+
+/* Operation codes for aio_lio_opcode.  */
+enum
+{
+  LIO_READ,
+  LIO_WRITE,
+  LIO_NOP
+};
+#define LIO_READ LIO_READ
+#define LIO_WRITE LIO_WRITE
+#define LIO_NOP LIO_NOP
+
+/* Synchronization modes for lio_listio.  */
+enum
+{
+  LIO_WAIT,
+  LIO_NOWAIT
+};
+#define LIO_WAIT LIO_WAIT
+#define LIO_NOWAIT LIO_NOWAIT
+
+/* prototypes */
+int aio_read (struct aiocb *__aiocbp);
+int aio_write (struct aiocb *__aiocbp);
+int lio_listio (int __mode, struct aiocb *const __list[], int __nent,
+		struct sigevent *__sig);
+int aio_error (const struct aiocb *__aiocbp);
+ssize_t aio_return (struct aiocb *__aiocbp);
+int aio_cancel (int __fildes, struct aiocb *__aiocbp);
+int aio_suspend (const struct aiocb *const __list[], int __nent,
+		 const struct timespec *__timeout);
+int aio_fsync (int __operation, struct aiocb *__aiocbp);
+
+int aio_read64 (struct aiocb64 *__aiocbp);
+int aio_write64 (struct aiocb64 *__aiocbp);
+int lio_listio64 (int __mode, struct aiocb64 *const __list[], int __nent,
+		  struct sigevent *__sig);
+int aio_error64 (const struct aiocb64 *__aiocbp);
+ssize_t aio_return64 (struct aiocb64 *__aiocbp);
+int aio_cancel64 (int __fildes, struct aiocb64 *__aiocbp);
+int aio_suspend64 (const struct aiocb64 *const __list[], int __nent,
+		   const struct timespec *__timeout);
+int aio_fsync64 (int __operation, struct aiocb64 *__aiocbp);
+
+void aio_init (const struct aioinit *__init);
+
+#endif /* _AIO_H */
@@ -71,4 +71,18 @@ _dl_elf_hash (const unsigned char *name)
   return hash;
 }
 
+
+/* This is the hashing function of the GNU-style hash table, the one
+   Dan Bernstein proposed: h * 33 + c, truncated to 32 bits.  */
+static inline Elf32_Word
+_dl_new_hash (const char *name)
+{
+  Elf32_Word hash = 5381;
+  unsigned char c;
+
+  for (c = *name; c != '\0'; c = *++name)
+    hash = hash * 33 + c;
+  return hash;
+}
+
 #endif /* dl-hash.h */
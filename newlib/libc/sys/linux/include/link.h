@@ -27,6 +27,15 @@
 #include <sys/types.h>
 
 #define DT_THISPROCNUM 0
+
+/* The GNU-style symbol hash table; older <elf.h> files lack the tag.  */
+#ifndef DT_GNU_HASH
+# define DT_GNU_HASH	0x6ffffef5
+#endif
+/* The tags of the DT_ADDRRNGLO..DT_ADDRRNGHI range we keep, counted down
+   from DT_ADDRRNGHI.  */
+#define DL_ADDRTAGIDX(tag)	(DT_ADDRRNGHI - (tag))
+#define DL_ADDRNUM		(DL_ADDRTAGIDX (DT_GNU_HASH) + 1)
 /* We use this macro to refer to ELF types independent of the native wordsize.
    `ElfW(TYPE)' is used in place of `Elf32_TYPE' or `Elf64_TYPE'.  */
 #define ElfW(type)	_ElfW (Elf, __ELF_NATIVE_CLASS, type)
@@ -137,10 +146,12 @@ struct link_map
        by DT_EXTRATAGIDX(tagvalue) and
        [DT_NUM+DT_THISPROCNUM+DT_VERSIONTAGNUM,
         DT_NUM+DT_THISPROCNUM+DT_VERSIONTAGNUM+DT_EXTRANUM)
-       are indexed by DT_EXTRATAGIDX(tagvalue) (see <elf.h>).  */
+       are indexed by DT_EXTRATAGIDX(tagvalue) (see <elf.h>) and
+       the DL_ADDRNUM entries after those are indexed by
+       DL_ADDRTAGIDX(tagvalue).  */
 
     ElfW(Dyn) *l_info[DT_NUM + DT_THISPROCNUM + DT_VERSIONTAGNUM
-		     + DT_EXTRANUM];
+		     + DT_EXTRANUM + DL_ADDRNUM];
     const ElfW(Phdr) *l_phdr;	/* Pointer to program header table in core.  */
     ElfW(Addr) l_entry;		/* Entry point location.  */
     ElfW(Half) l_phnum;		/* Number of program header entries.  */
@@ -163,6 +174,16 @@ struct link_map
     Elf_Symndx l_nbuckets;
     const Elf_Symndx *l_buckets, *l_chain;
 
+    /* The GNU-style symbol hash table, if the object has one, which the
+       lookup prefers: a Bloom filter of L_GNU_BITMASK_IDXBITS + 1 words,
+       the buckets, and the chains of 32-bit hash values indexed by
+       symbol index.  */
+    Elf32_Word l_gnu_bitmask_idxbits;
+    Elf32_Word l_gnu_shift;
+    const ElfW(Addr) *l_gnu_bitmask;
+    const Elf32_Word *l_gnu_buckets;
+    const Elf32_Word *l_gnu_chain_zero;
+
     unsigned int l_opencount;	/* Reference count for dlopen/dlclose.  */
     enum			/* Where this object came from.  */
       {
@@ -249,6 +270,10 @@ struct link_map
 #endif
       const ElfW(Sym) *ret;
     } l_lookup_cache;
+
+    /* The bindings of the symbols of this object found in earlier runs,
+       see dl-bindcache.c, or NULL.  */
+    struct dl_bind_cache *l_bind_cache;
   };
 
 struct dl_phdr_info
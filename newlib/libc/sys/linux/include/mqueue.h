@@ -10,6 +10,7 @@
 #include <bits/siginfo.h>
 
 #include <sys/fcntl.h>
+#include <time.h>
 
 /* message queue types */
 typedef int mqd_t;
@@ -28,6 +29,8 @@ mqd_t mq_open (const char *__name, int __oflag, ...);
 int mq_close (mqd_t __msgid);
 int mq_send (mqd_t __msgid, const char *__msg, size_t __msg_len, unsigned int __msg_prio);
 ssize_t mq_receive (mqd_t __msgid, char *__msg, size_t __msg_len, unsigned int *__msg_prio);
+int mq_timedsend (mqd_t __msgid, const char *__msg, size_t __msg_len, unsigned int __msg_prio, const struct timespec *__abs_timeout);
+ssize_t mq_timedreceive (mqd_t __msgid, char *__msg, size_t __msg_len, unsigned int *__msg_prio, const struct timespec *__abs_timeout);
 int mq_notify (mqd_t __msgid, const struct sigevent *__notification);
 int mq_unlink (const char *__name);
 int mq_getattr (mqd_t __msgid, struct mq_attr *__mqstat);
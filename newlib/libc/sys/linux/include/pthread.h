@@ -45,12 +45,12 @@ __BEGIN_DECLS
 
 #ifdef __USE_UNIX98
 # define PTHREAD_RWLOCK_INITIALIZER \
-  { __LOCK_INITIALIZER, 0, NULL, NULL, NULL,				      \
+  { __LOCK_INITIALIZER, 0, NULL, 0, 0,					      \
     PTHREAD_RWLOCK_DEFAULT_NP, PTHREAD_PROCESS_PRIVATE }
 #endif
 #ifdef __USE_GNU
 # define PTHREAD_RWLOCK_WRITER_NONRECURSIVE_INITIALIZER_NP \
-  { __LOCK_INITIALIZER, 0, NULL, NULL, NULL,				      \
+  { __LOCK_INITIALIZER, 0, NULL, 0, 0,					      \
     PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP, PTHREAD_PROCESS_PRIVATE }
 #endif
 
@@ -382,6 +382,31 @@ extern int pthread_mutexattr_gettype (__const pthread_mutexattr_t *__restrict
 				      __attr, int *__restrict __kind) __THROW;
 #endif
 
+#ifdef __USE_GNU
+/* Statistics of the mutexes and of the internal locks of the thread
+   library, summed over all threads.  Times are in nanoseconds.  */
+struct pthread_lockstats
+{
+  unsigned long long int ls_locks;	/* Locks taken.  */
+  unsigned long long int ls_contended;	/* Of those, found taken.  */
+  unsigned long long int ls_spun;	/* Of those, got by spinning.  */
+  unsigned long long int ls_wait_time;	/* Time waited for them.  */
+  unsigned long long int ls_released;	/* Releases with a hold time.  */
+  unsigned long long int ls_hold_time;	/* Time those were held.  */
+};
+
+/* Start keeping the lock statistics if ENABLE is nonzero, stop if it is
+   zero.  They are not kept by default.  */
+extern int pthread_lockstats_enable_np (int __enable) __THROW;
+
+/* Store the lock statistics gathered so far in *STATS.  */
+extern int pthread_lockstats_get_np (struct pthread_lockstats *__stats)
+     __THROW;
+
+/* Clear the lock statistics.  */
+extern int pthread_lockstats_reset_np (void) __THROW;
+#endif
+
 
 /* Functions for handling conditional variables.  */
 
@@ -105,6 +105,7 @@ void free ();
 /* Thread safetyness.  */
 #ifdef _LIBC
 # include <bits/libc-lock.h>
+# include <libc-tsd.h>
 #else
 /* Provide dummy implementation if this is outside glibc.  */
 # define __libc_lock_define_initialized(CLASS, NAME)
@@ -113,6 +114,9 @@ void free ();
 # define __libc_rwlock_define_initialized(CLASS, NAME)
 # define __libc_rwlock_rdlock(NAME)
 # define __libc_rwlock_unlock(NAME)
+# define __libc_tsd_define(CLASS, KEY)	CLASS void *__libc_tsd_##KEY##_data;
+# define __libc_tsd_get(KEY)		(__libc_tsd_##KEY##_data)
+# define __libc_tsd_set(KEY, VALUE)	(__libc_tsd_##KEY##_data = (VALUE))
 #endif
 
 /* Alignment of types.  */
@@ -239,6 +243,11 @@ struct known_translation_t
 
 static void *root;
 
+/* The entry of the tree each thread found last.  Programs mostly look
+   up the same few strings over and over, often the same one in a loop,
+   so it is tried before searching the tree.  */
+__libc_tsd_define (static, INTL)
+
 # ifdef _GLIBC
 #  define tsearch __tsearch
 # endif
@@ -292,7 +301,7 @@ static char *plural_lookup PARAMS ((struct loaded_l10nfile *domain,
 				    const char *translation,
 				    size_t translation_len))
      internal_function;
-static unsigned long int plural_eval PARAMS ((struct expression *pexp,
+static unsigned long int plural_eval PARAMS ((const unsigned long int *code,
 					      unsigned long int n))
      internal_function;
 static const char *category_to_name PARAMS ((int category)) internal_function;
@@ -408,6 +417,7 @@ DCIGETTEXT (domainname, msgid1, msgid2, plural, n, category)
 #if defined HAVE_TSEARCH || defined _LIBC
   struct known_translation_t *search;
   struct known_translation_t **foundp = NULL;
+  struct known_translation_t *found;
   size_t msgid_len;
 #endif
   size_t domainname_len;
@@ -425,25 +435,42 @@ DCIGETTEXT (domainname, msgid1, msgid2, plural, n, category)
     domainname = _nl_current_default_domain;
 
 #if defined HAVE_TSEARCH || defined _LIBC
-  msgid_len = strlen (msgid1) + 1;
-
-  /* Try to find the translation among those which we found at
-     some time.  */
-  search = (struct known_translation_t *)
-	   alloca (offsetof (struct known_translation_t, msgid) + msgid_len);
-  memcpy (search->msgid, msgid1, msgid_len);
-  search->domainname = (char *) domainname;
-  search->category = category;
-
-  foundp = (struct known_translation_t **) tfind (search, &root, transcmp);
-  if (foundp != NULL && (*foundp)->counter == _nl_msg_cat_cntr)
+  /* See first whether this thread asked for the same string last.  The
+     caller may since have put another one at the same address, so the
+     contents are compared and not the pointers.  */
+  found = (struct known_translation_t *) __libc_tsd_get (INTL);
+  if (found == NULL
+      || found->counter != _nl_msg_cat_cntr
+      || found->category != category
+      || strcmp (found->msgid, msgid1) != 0
+      || strcmp (found->domainname, domainname) != 0)
+    {
+      msgid_len = strlen (msgid1) + 1;
+
+      /* Try to find the translation among those which we found at
+	 some time.  */
+      search = (struct known_translation_t *)
+	       alloca (offsetof (struct known_translation_t, msgid)
+		       + msgid_len);
+      memcpy (search->msgid, msgid1, msgid_len);
+      search->domainname = (char *) domainname;
+      search->category = category;
+
+      foundp = (struct known_translation_t **) tfind (search, &root,
+						      transcmp);
+      found = foundp != NULL ? *foundp : NULL;
+      if (found != NULL && found->counter == _nl_msg_cat_cntr)
+	__libc_tsd_set (INTL, found);
+    }
+
+  if (found != NULL && found->counter == _nl_msg_cat_cntr)
     {
       /* Now deal with plural.  */
       if (plural)
-	retval = plural_lookup ((*foundp)->domain, n, (*foundp)->translation,
-				(*foundp)->translation_length);
+	retval = plural_lookup (found->domain, n, found->translation,
+				found->translation_length);
       else
-	retval = (char *) (*foundp)->translation;
+	retval = (char *) found->translation;
 
       __libc_rwlock_unlock (_nl_state_lock);
       return retval;
@@ -634,6 +661,8 @@ DCIGETTEXT (domainname, msgid1, msgid2, plural, n, category)
 			  || __builtin_expect (*foundp != newp, 0))
 			/* The insert failed.  */
 			free (newp);
+		      else
+			__libc_tsd_set (INTL, newp);
 		    }
 		}
 	      else
@@ -643,6 +672,7 @@ DCIGETTEXT (domainname, msgid1, msgid2, plural, n, category)
 		  (*foundp)->domain = domain;
 		  (*foundp)->translation = retval;
 		  (*foundp)->translation_length = retlen;
+		  __libc_tsd_set (INTL, *foundp);
 		}
 #endif
 	      /* Now deal with plural.  */
@@ -989,84 +1019,113 @@ plural_lookup (domain, n, translation, translation_len)
 }
 
 
-/* Function to evaluate the plural expression and return an index value.  */
+/* Function to evaluate the plural expression and return an index value.
+   CODE is the expression as compiled by _nl_load_domain.  */
 static unsigned long int
 internal_function
-plural_eval (pexp, n)
-     struct expression *pexp;
+plural_eval (code, n)
+     const unsigned long int *code;
      unsigned long int n;
 {
-  switch (pexp->nargs)
-    {
-    case 0:
-      switch (pexp->operation)
-	{
-	case var:
-	  return n;
-	case num:
-	  return pexp->val.num;
-	default:
-	  break;
-	}
-      /* NOTREACHED */
-      break;
-    case 1:
-      {
-	/* pexp->operation must be lnot.  */
-	unsigned long int arg = plural_eval (pexp->val.args[0], n);
-	return ! arg;
-      }
-    case 2:
+  unsigned long int stack[PLURAL_STACK_SIZE];
+  unsigned long int *sp = stack;
+  const unsigned long int *pc = code;
+
+  while (1)
+    switch (*pc++)
       {
-	unsigned long int leftarg = plural_eval (pexp->val.args[0], n);
-	if (pexp->operation == lor)
-	  return leftarg || plural_eval (pexp->val.args[1], n);
-	else if (pexp->operation == land)
-	  return leftarg && plural_eval (pexp->val.args[1], n);
+      case PLURAL_END:
+	return sp[-1];
+      case PLURAL_VAR:
+	*sp++ = n;
+	break;
+      case PLURAL_NUM:
+	*sp++ = *pc++;
+	break;
+      case PLURAL_NOT:
+	sp[-1] = ! sp[-1];
+	break;
+      case PLURAL_BOOL:
+	sp[-1] = sp[-1] != 0;
+	break;
+      case PLURAL_MULT:
+	--sp;
+	sp[-1] *= sp[0];
+	break;
+      case PLURAL_DIVIDE:
+	--sp;
+	sp[-1] /= sp[0];
+	break;
+      case PLURAL_MODULE:
+	--sp;
+	sp[-1] %= sp[0];
+	break;
+      case PLURAL_PLUS:
+	--sp;
+	sp[-1] += sp[0];
+	break;
+      case PLURAL_MINUS:
+	--sp;
+	sp[-1] -= sp[0];
+	break;
+      case PLURAL_LESS_THAN:
+	--sp;
+	sp[-1] = sp[-1] < sp[0];
+	break;
+      case PLURAL_GREATER_THAN:
+	--sp;
+	sp[-1] = sp[-1] > sp[0];
+	break;
+      case PLURAL_LESS_OR_EQUAL:
+	--sp;
+	sp[-1] = sp[-1] <= sp[0];
+	break;
+      case PLURAL_GREATER_OR_EQUAL:
+	--sp;
+	sp[-1] = sp[-1] >= sp[0];
+	break;
+      case PLURAL_EQUAL:
+	--sp;
+	sp[-1] = sp[-1] == sp[0];
+	break;
+      case PLURAL_NOT_EQUAL:
+	--sp;
+	sp[-1] = sp[-1] != sp[0];
+	break;
+      case PLURAL_AND:
+	if (sp[-1] == 0)
+	  pc = code + *pc;
 	else
 	  {
-	    unsigned long int rightarg = plural_eval (pexp->val.args[1], n);
-
-	    switch (pexp->operation)
-	      {
-	      case mult:
-		return leftarg * rightarg;
-	      case divide:
-		return leftarg / rightarg;
-	      case module:
-		return leftarg % rightarg;
-	      case plus:
-		return leftarg + rightarg;
-	      case minus:
-		return leftarg - rightarg;
-	      case less_than:
-		return leftarg < rightarg;
-	      case greater_than:
-		return leftarg > rightarg;
-	      case less_or_equal:
-		return leftarg <= rightarg;
-	      case greater_or_equal:
-		return leftarg >= rightarg;
-	      case equal:
-		return leftarg == rightarg;
-	      case not_equal:
-		return leftarg != rightarg;
-	      default:
-		break;
-	      }
+	    --sp;
+	    ++pc;
 	  }
-	/* NOTREACHED */
 	break;
+      case PLURAL_OR:
+	if (sp[-1] != 0)
+	  {
+	    sp[-1] = 1;
+	    pc = code + *pc;
+	  }
+	else
+	  {
+	    --sp;
+	    ++pc;
+	  }
+	break;
+      case PLURAL_JZ:
+	if (*--sp == 0)
+	  pc = code + *pc;
+	else
+	  ++pc;
+	break;
+      case PLURAL_JMP:
+	pc = code + *pc;
+	break;
+      default:
+	/* NOTREACHED */
+	return 0;
       }
-    case 3:
-      {
-	/* pexp->operation must be qmop.  */
-	unsigned long int boolarg = plural_eval (pexp->val.args[0], n);
-	return plural_eval (pexp->val.args[boolarg ? 1 : 2], n);
-      }
-    }
-  /* NOTREACHED */
-  return 0;
 }
 
 
@@ -1230,6 +1289,7 @@ free_mem (void)
   /* Remove the search tree with the known translations.  */
   tdestroy (root, free);
   root = NULL;
+  __libc_tsd_set (INTL, NULL);
 
   while (transmem_list != NULL)
     {
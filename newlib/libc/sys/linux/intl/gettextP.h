@@ -112,6 +112,42 @@ struct expression
   } val;
 };
 
+/* The plural expression of a catalog is compiled when it is loaded into
+   code for a small stack machine, so that looking up a plural form does
+   not walk the expression tree.  Each operation is one word of the code,
+   followed by its operand for PLURAL_NUM and the jumps, which give the
+   index of the word to continue at.  The binary operations replace the
+   two values on top of the stack with their result.  */
+enum plural_code
+{
+  PLURAL_END,			/* Return the value on top of the stack.  */
+  PLURAL_VAR,			/* Push "n".  */
+  PLURAL_NUM,			/* Push the operand.  */
+  PLURAL_NOT,			/* Logical NOT of the top.  */
+  PLURAL_BOOL,			/* Make the top 0 or 1.  */
+  PLURAL_MULT,
+  PLURAL_DIVIDE,
+  PLURAL_MODULE,
+  PLURAL_PLUS,
+  PLURAL_MINUS,
+  PLURAL_LESS_THAN,
+  PLURAL_GREATER_THAN,
+  PLURAL_LESS_OR_EQUAL,
+  PLURAL_GREATER_OR_EQUAL,
+  PLURAL_EQUAL,
+  PLURAL_NOT_EQUAL,
+  PLURAL_AND,			/* Jump, leaving 0, if the top is 0, else pop.  */
+  PLURAL_OR,			/* Jump, leaving 1, if the top is not 0,
+				   else pop.  */
+  PLURAL_JZ,			/* Pop, and jump if it was 0.  */
+  PLURAL_JMP			/* Jump.  */
+};
+
+/* The most values the code of a plural expression may keep on the
+   stack.  An expression which would need more is treated like one
+   which does not parse.  */
+#define PLURAL_STACK_SIZE 32
+
 /* This is the data structure to pass information to the parser and get
    the result in a thread-safe way.  */
 struct parse_args
@@ -133,6 +169,7 @@ struct loaded_domain
   struct string_desc *trans_tab;
   nls_uint32 hash_size;
   nls_uint32 *hash_tab;
+  int hash_tab_malloced;
   int codeset_cntr;
 #ifdef _GLIBC
   __gconv_t conv;
@@ -143,7 +180,7 @@ struct loaded_domain
 #endif
   char **conv_tab;
 
-  struct expression *plural;
+  const unsigned long int *plural;
   unsigned long int nplurals;
 };
 
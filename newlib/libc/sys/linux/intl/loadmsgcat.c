@@ -85,6 +85,7 @@ char *alloca ();
 
 #include "gettext.h"
 #include "gettextP.h"
+#include "hash-string.h"
 
 #ifdef _GLIBC
 # include "localeinfo.h"
@@ -109,8 +110,10 @@ char *alloca ();
    prefix.  So we have to make a difference here.  */
 #ifdef _LIBC
 # define PLURAL_PARSE __gettextparse
+# define FREE_EXPRESSION __gettext_free_exp
 #else
 # define PLURAL_PARSE gettextparse__
+# define FREE_EXPRESSION gettext_free_exp__
 #endif
 
 /* For those losing systems which don't have `alloca' we have to add
@@ -127,72 +130,241 @@ char *alloca ();
    cached by one of GCC's features.  */
 int _nl_msg_cat_cntr;
 
-#if defined __GNUC__ \
-    || (defined __STDC_VERSION__ && __STDC_VERSION__ >= 199901L)
-
-/* These structs are the constant expression for the germanic plural
-   form determination.  It represents the expression  "n != 1".  */
-static const struct expression plvar =
+/* This is the code for the germanic plural form determination.  It
+   represents the expression  "n != 1".  */
+static const unsigned long int germanic_plural[] =
 {
-  .nargs = 0,
-  .operation = var,
+  PLURAL_VAR,
+  PLURAL_NUM, 1,
+  PLURAL_NOT_EQUAL,
+  PLURAL_END
 };
-static const struct expression plone =
+
+/* State while compiling a plural expression.  If CODE is NULL nothing
+   is stored, only the length of the code and the depth of the stack it
+   needs are counted.  */
+struct plural_compiler
 {
-  .nargs = 0,
-  .operation = num,
-  .val =
-  {
-    .num = 1
-  }
+  unsigned long int *code;
+  size_t len;
+  int depth;
+  int max_depth;
 };
-static struct expression germanic_plural =
+
+#define EMIT(pc, word) \
+  do									      \
+    {									      \
+      if ((pc)->code != NULL)						      \
+	(pc)->code[(pc)->len] = (word);					      \
+      ++(pc)->len;							      \
+    }									      \
+  while (0)
+
+/* Make the jump operand at index AT of the code continue at the end.  */
+#define PATCH(pc, at) \
+  do									      \
+    {									      \
+      if ((pc)->code != NULL)						      \
+	(pc)->code[at] = (pc)->len;					      \
+    }									      \
+  while (0)
+
+static void plural_compile PARAMS ((struct plural_compiler *pc,
+				    const struct expression *exp))
+     internal_function;
+
+/* Append the code which evaluates EXP and leaves its value on top of
+   the stack.  */
+static void
+internal_function
+plural_compile (pc, exp)
+     struct plural_compiler *pc;
+     const struct expression *exp;
 {
-  .nargs = 2,
-  .operation = not_equal,
-  .val =
-  {
-    .args =
+  size_t jump, jump2;
+
+  switch (exp->nargs)
     {
-      [0] = (struct expression *) &plvar,
-      [1] = (struct expression *) &plone
+    case 0:
+      if (exp->operation == var)
+	EMIT (pc, PLURAL_VAR);
+      else
+	{
+	  EMIT (pc, PLURAL_NUM);
+	  EMIT (pc, exp->val.num);
+	}
+      if (++pc->depth > pc->max_depth)
+	pc->max_depth = pc->depth;
+      break;
+    case 1:
+      /* exp->operation must be lnot.  */
+      plural_compile (pc, exp->val.args[0]);
+      EMIT (pc, PLURAL_NOT);
+      break;
+    case 2:
+      plural_compile (pc, exp->val.args[0]);
+      if (exp->operation == land || exp->operation == lor)
+	{
+	  /* The right operand is only evaluated if the left one does
+	     not decide the result.  */
+	  EMIT (pc, exp->operation == land ? PLURAL_AND : PLURAL_OR);
+	  jump = pc->len;
+	  EMIT (pc, 0);
+	  --pc->depth;
+	  plural_compile (pc, exp->val.args[1]);
+	  EMIT (pc, PLURAL_BOOL);
+	  PATCH (pc, jump);
+	}
+      else
+	{
+	  plural_compile (pc, exp->val.args[1]);
+	  switch (exp->operation)
+	    {
+	    case mult:
+	      EMIT (pc, PLURAL_MULT);
+	      break;
+	    case divide:
+	      EMIT (pc, PLURAL_DIVIDE);
+	      break;
+	    case module:
+	      EMIT (pc, PLURAL_MODULE);
+	      break;
+	    case plus:
+	      EMIT (pc, PLURAL_PLUS);
+	      break;
+	    case minus:
+	      EMIT (pc, PLURAL_MINUS);
+	      break;
+	    case less_than:
+	      EMIT (pc, PLURAL_LESS_THAN);
+	      break;
+	    case greater_than:
+	      EMIT (pc, PLURAL_GREATER_THAN);
+	      break;
+	    case less_or_equal:
+	      EMIT (pc, PLURAL_LESS_OR_EQUAL);
+	      break;
+	    case greater_or_equal:
+	      EMIT (pc, PLURAL_GREATER_OR_EQUAL);
+	      break;
+	    case equal:
+	      EMIT (pc, PLURAL_EQUAL);
+	      break;
+	    default:
+	      EMIT (pc, PLURAL_NOT_EQUAL);
+	      break;
+	    }
+	  --pc->depth;
+	}
+      break;
+    case 3:
+      /* exp->operation must be qmop.  */
+      plural_compile (pc, exp->val.args[0]);
+      EMIT (pc, PLURAL_JZ);
+      jump = pc->len;
+      EMIT (pc, 0);
+      --pc->depth;
+      plural_compile (pc, exp->val.args[1]);
+      EMIT (pc, PLURAL_JMP);
+      jump2 = pc->len;
+      EMIT (pc, 0);
+      PATCH (pc, jump);
+      --pc->depth;
+      plural_compile (pc, exp->val.args[2]);
+      PATCH (pc, jump2);
+      break;
     }
-  }
-};
-
-# define INIT_GERMANIC_PLURAL()
-
-#else
+}
 
-/* For compilers without support for ISO C 99 struct/union initializers:
-   Initialization at run-time.  */
+/* Compile the plural expression EXP.  Return the code, or NULL if there
+   is not enough memory or it would need more than PLURAL_STACK_SIZE
+   values on the stack.  */
+static unsigned long int *
+internal_function
+compile_plural (exp)
+     const struct expression *exp;
+{
+  struct plural_compiler pc;
+
+  pc.code = NULL;
+  pc.len = 0;
+  pc.depth = 0;
+  pc.max_depth = 0;
+  plural_compile (&pc, exp);
+  if (pc.max_depth > PLURAL_STACK_SIZE)
+    return NULL;
+
+  pc.code = (unsigned long int *) malloc ((pc.len + 1)
+					  * sizeof (unsigned long int));
+  if (pc.code == NULL)
+    return NULL;
+
+  pc.len = 0;
+  pc.depth = 0;
+  plural_compile (&pc, exp);
+  pc.code[pc.len] = PLURAL_END;
+
+  return pc.code;
+}
 
-static struct expression plvar;
-static struct expression plone;
-static struct expression germanic_plural;
 
-static void
-init_germanic_plural ()
+/* Catalogs written without a hash table would be searched by bisection
+   on every lookup.  Give DOMAIN a table laid out like the one msgfmt
+   writes, with the same hash function and double hashing, so that
+   _nl_find_msg treats both alike.  Return nonzero if that worked.  */
+static int
+internal_function
+build_hash_table (domain)
+     struct loaded_domain *domain;
 {
-  if (plone.val.num == 0)
+  nls_uint32 size, cnt;
+  nls_uint32 *tab;
+
+  /* msgfmt uses the first prime not below 4/3 of the number of
+     strings, but at least 3.  */
+  size = domain->nstrings / 3 * 4 + domain->nstrings % 3 * 4 / 3;
+  if (size < 3)
+    size = 3;
+  size |= 1;
+  while (1)
     {
-      plvar.nargs = 0;
-      plvar.operation = var;
+      nls_uint32 div;
+
+      for (div = 3; div * div <= size; div += 2)
+	if (size % div == 0)
+	  break;
+      if (div * div > size)
+	break;
+      size += 2;
+    }
 
-      plone.nargs = 0;
-      plone.operation = num;
-      plone.val.num = 1;
+  tab = (nls_uint32 *) calloc (size, sizeof (nls_uint32));
+  if (tab == NULL)
+    return 0;
 
-      germanic_plural.nargs = 2;
-      germanic_plural.operation = not_equal;
-      germanic_plural.val.args[0] = &plvar;
-      germanic_plural.val.args[1] = &plone;
+  for (cnt = 0; cnt < domain->nstrings; ++cnt)
+    {
+      nls_uint32 hash_val =
+	hash_string (domain->data
+		     + W (domain->must_swap, domain->orig_tab[cnt].offset));
+      nls_uint32 idx = hash_val % size;
+      nls_uint32 incr = 1 + (hash_val % (size - 2));
+
+      while (tab[idx] != 0)
+	if (idx >= size - incr)
+	  idx -= size - incr;
+	else
+	  idx += incr;
+
+      /* The entries are in the byte order of the file.  */
+      tab[idx] = W (domain->must_swap, cnt + 1);
     }
-}
 
-# define INIT_GERMANIC_PLURAL() init_germanic_plural ()
-
-#endif
+  domain->hash_size = size;
+  domain->hash_tab = tab;
+  domain->hash_tab_malloced = 1;
+  return 1;
+}
 
 
 /* Initialize the codeset dependent parts of an opened message catalog.
@@ -466,6 +638,7 @@ _nl_load_domain (domain_file, domainbinding)
       domain->hash_size = W (domain->must_swap, data->hash_tab_size);
       domain->hash_tab = (nls_uint32 *)
 	((char *) data + W (domain->must_swap, data->hash_tab_offset));
+      domain->hash_tab_malloced = 0;
       break;
     default:
       /* This is an invalid revision.  */
@@ -480,6 +653,10 @@ _nl_load_domain (domain_file, domainbinding)
       return;
     }
 
+  if (domain->hash_size <= 2)
+    /* If there is no memory for a table the binary search still works.  */
+    build_hash_table (domain);
+
   /* Now initialize the character set converter from the character set
      the file is encoded with (found in the header entry) to the domain's
      specified character set or the locale's character set.  */
@@ -523,7 +700,12 @@ _nl_load_domain (domain_file, domainbinding)
 	  args.cp = plural;
 	  if (PLURAL_PARSE (&args) != 0)
 	    goto no_plural;
-	  domain->plural = args.res;
+
+	  /* Only the compiled code is kept.  */
+	  domain->plural = compile_plural (args.res);
+	  FREE_EXPRESSION (args.res);
+	  if (domain->plural == NULL)
+	    goto no_plural;
 	}
     }
   else
@@ -532,8 +714,7 @@ _nl_load_domain (domain_file, domainbinding)
          for `one', the plural form otherwise.  Yes, this is also what
          English is using since English is a Germanic language.  */
     no_plural:
-      INIT_GERMANIC_PLURAL ();
-      domain->plural = &germanic_plural;
+      domain->plural = germanic_plural;
       domain->nplurals = 2;
     }
 }
@@ -545,8 +726,11 @@ internal_function
 _nl_unload_domain (domain)
      struct loaded_domain *domain;
 {
-  if (domain->plural != &germanic_plural)
-    __gettext_free_exp (domain->plural);
+  if (domain->plural != germanic_plural)
+    free ((void *) domain->plural);
+
+  if (domain->hash_tab_malloced)
+    free (domain->hash_tab);
 
   _nl_free_domain_conv (domain);
 
@@ -0,0 +1,80 @@
+/* Cancel asynchronous requests.  */
+
+#include <aio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "posix-aio.h"
+
+/* Only the requests still queued can be canceled, the ones a worker
+   has taken run to completion.  */
+static int
+do_aio_cancel (int fildes, union aiocb_union *aiocbp)
+{
+  struct fdqueue *fdq;
+  struct requestlist *req, **p;
+  int canceled = 0;
+  int result;
+
+  /* Fails with EBADF for a closed descriptor.  */
+  if (fcntl (fildes, F_GETFL) == -1)
+    return -1;
+
+  if (aiocbp != NULL && aiocbp->aiocb.aio_fildes != fildes)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  pthread_mutex_lock (&__aio_requests_mutex);
+
+  fdq = __aio_find_queue (fildes);
+  if (fdq != NULL)
+    {
+      p = &fdq->head;
+      fdq->tail = NULL;
+      while ((req = *p) != NULL)
+	{
+	  if (aiocbp == NULL || req->aiocbp == aiocbp)
+	    {
+	      *p = req->next;
+	      __aio_complete_request (req, -1, ECANCELED);
+	      ++canceled;
+	    }
+	  else
+	    {
+	      fdq->tail = req;
+	      p = &req->next;
+	    }
+	}
+    }
+
+  if (aiocbp != NULL)
+    result = (canceled ? AIO_CANCELED
+	      : aiocbp->aiocb.__error_code == EINPROGRESS ? AIO_NOTCANCELED
+	      : AIO_ALLDONE);
+  else
+    result = (fdq != NULL && fdq->busy ? AIO_NOTCANCELED
+	      : canceled ? AIO_CANCELED
+	      : AIO_ALLDONE);
+
+  pthread_mutex_unlock (&__aio_requests_mutex);
+  return result;
+}
+
+int
+aio_cancel (fildes, aiocbp)
+     int fildes;
+     struct aiocb *aiocbp;
+{
+  return do_aio_cancel (fildes, (union aiocb_union *) aiocbp);
+}
+
+int
+aio_cancel64 (fildes, aiocbp)
+     int fildes;
+     struct aiocb64 *aiocbp;
+{
+  return do_aio_cancel (fildes, (union aiocb_union *) aiocbp);
+}
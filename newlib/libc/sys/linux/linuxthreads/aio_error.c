@@ -0,0 +1,22 @@
+/* Status of an asynchronous request.  */
+
+#include <aio.h>
+
+#include "posix-aio.h"
+
+/* The workers store __error_code last, with release semantics, so no
+   lock is needed here; the acquire load makes __return_value visible
+   to aio_return once the request is done.  */
+int
+aio_error (aiocbp)
+     const struct aiocb *aiocbp;
+{
+  return __atomic_load_n (&aiocbp->__error_code, __ATOMIC_ACQUIRE);
+}
+
+int
+aio_error64 (aiocbp)
+     const struct aiocb64 *aiocbp;
+{
+  return __atomic_load_n (&aiocbp->__error_code, __ATOMIC_ACQUIRE);
+}
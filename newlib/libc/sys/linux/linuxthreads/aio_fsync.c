@@ -0,0 +1,44 @@
+/* Asynchronous file synchronization.  */
+
+#include <aio.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include "posix-aio.h"
+
+/* The request is queued behind all the earlier requests for the same
+   descriptor, which are done before it.  */
+static int
+do_aio_fsync (int op, union aiocb_union *aiocbp, int mode64)
+{
+  if (op != O_DSYNC && op != O_SYNC)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  /* Fails with EBADF for a closed descriptor.  */
+  if (fcntl (aiocbp->aiocb.aio_fildes, F_GETFL) == -1)
+    return -1;
+
+  return (__aio_enqueue_request (aiocbp,
+				 (op == O_SYNC ? LIO_SYNC : LIO_DSYNC) | mode64,
+				 NULL)
+	  == NULL ? -1 : 0);
+}
+
+int
+aio_fsync (op, aiocbp)
+     int op;
+     struct aiocb *aiocbp;
+{
+  return do_aio_fsync (op, (union aiocb_union *) aiocbp, 0);
+}
+
+int
+aio_fsync64 (op, aiocbp)
+     int op;
+     struct aiocb64 *aiocbp;
+{
+  return do_aio_fsync (op, (union aiocb_union *) aiocbp, LIO_MODE64);
+}
@@ -0,0 +1,22 @@
+/* Asynchronous read, see aio_routines.c.  */
+
+#include <aio.h>
+
+#include "posix-aio.h"
+
+int
+aio_read (aiocbp)
+     struct aiocb *aiocbp;
+{
+  return (__aio_enqueue_request ((union aiocb_union *) aiocbp, LIO_READ, NULL)
+	  == NULL ? -1 : 0);
+}
+
+int
+aio_read64 (aiocbp)
+     struct aiocb64 *aiocbp;
+{
+  return (__aio_enqueue_request ((union aiocb_union *) aiocbp,
+				 LIO_READ | LIO_MODE64, NULL)
+	  == NULL ? -1 : 0);
+}
@@ -0,0 +1,19 @@
+/* Result of an asynchronous request.  */
+
+#include <aio.h>
+
+#include "posix-aio.h"
+
+ssize_t
+aio_return (aiocbp)
+     struct aiocb *aiocbp;
+{
+  return aiocbp->__return_value;
+}
+
+ssize_t
+aio_return64 (aiocbp)
+     struct aiocb64 *aiocbp;
+{
+  return aiocbp->__return_value;
+}
@@ -0,0 +1,611 @@
+/* Helper code for the POSIX asynchronous I/O implementation on
+   LinuxThreads.
+
+   Requests are queued per file descriptor.  A bounded pool of worker
+   threads takes the queues in turn and runs the requests of one queue
+   in order, so at most one worker does I/O on a descriptor at a time.
+   A read or write is merged with the requests queued right behind it
+   which continue it at the next offset, and the whole run is done with
+   one readv or writev.  Workers exit after being idle for a while.  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysdep.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include "posix-aio.h"
+
+extern ssize_t pread64 (int, void *, size_t, off64_t);
+extern ssize_t pwrite64 (int, const void *, size_t, off64_t);
+extern off64_t lseek64 (int, off64_t, int);
+
+/* Global lock to protect the queues and the requests.  */
+pthread_mutex_t __aio_requests_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Broadcast whenever a request is done.  */
+pthread_cond_t __aio_done_cond = PTHREAD_COND_INITIALIZER;
+
+/* All the queues with queued or running requests.  */
+struct fdqueue *__aio_fdqueues;
+
+/* Queues waiting for a worker, oldest first.  */
+static struct fdqueue *runlist_head;
+static struct fdqueue *runlist_tail;
+static int runlist_length;
+
+/* Signaled when a queue is put on the run list.  */
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+
+/* The worker threads.  */
+static int max_threads = AIO_THREADS_DEFAULT;
+static int idle_time = AIO_IDLE_TIME_DEFAULT;
+static int nthreads;
+static int idle_threads;
+
+/* Unused requests and queues are kept for reuse.  */
+static struct requestlist *free_requests;
+static struct fdqueue *free_queues;
+
+
+static struct requestlist *
+get_request (void)
+{
+  struct requestlist *req = free_requests;
+
+  if (req != NULL)
+    free_requests = req->next;
+  else
+    req = (struct requestlist *) malloc (sizeof (struct requestlist));
+  return req;
+}
+
+
+static void
+release_request (struct requestlist *req)
+{
+  req->next = free_requests;
+  free_requests = req;
+}
+
+
+/* Return the queue of FD, or a new empty one if CREATE is nonzero.  */
+static struct fdqueue *
+find_queue (int fd, int create)
+{
+  struct fdqueue *fdq;
+
+  for (fdq = __aio_fdqueues; fdq != NULL; fdq = fdq->next)
+    if (fdq->fd == fd)
+      return fdq;
+
+  if (!create)
+    return NULL;
+
+  fdq = free_queues;
+  if (fdq != NULL)
+    free_queues = fdq->next;
+  else if ((fdq = (struct fdqueue *) malloc (sizeof (struct fdqueue))) == NULL)
+    return NULL;
+
+  memset (fdq, 0, sizeof (struct fdqueue));
+  fdq->fd = fd;
+  fdq->next = __aio_fdqueues;
+  __aio_fdqueues = fdq;
+  return fdq;
+}
+
+
+static void
+release_queue (struct fdqueue *fdq)
+{
+  struct fdqueue **p;
+
+  for (p = &__aio_fdqueues; *p != fdq; p = &(*p)->next)
+    ;
+  *p = fdq->next;
+  fdq->next = free_queues;
+  free_queues = fdq;
+}
+
+
+static void
+runlist_push (struct fdqueue *fdq)
+{
+  fdq->runnable = 1;
+  fdq->next_run = NULL;
+  if (runlist_tail != NULL)
+    runlist_tail->next_run = fdq;
+  else
+    runlist_head = fdq;
+  runlist_tail = fdq;
+  ++runlist_length;
+}
+
+
+static struct fdqueue *
+runlist_pop (void)
+{
+  struct fdqueue *fdq = runlist_head;
+
+  if (fdq != NULL)
+    {
+      runlist_head = fdq->next_run;
+      if (runlist_head == NULL)
+	runlist_tail = NULL;
+      fdq->runnable = 0;
+      --runlist_length;
+    }
+  return fdq;
+}
+
+
+static off64_t
+request_offset (struct requestlist *req)
+{
+  return ((req->opcode & LIO_MODE64)
+	  ? req->aiocbp->aiocb64.aio_offset
+	  : (off64_t) req->aiocbp->aiocb.aio_offset);
+}
+
+
+/* Take the head request of FDQ and the requests behind it which
+   continue it, at most AIO_COALESCE_MAX in all.  */
+static int
+take_batch (struct fdqueue *fdq, struct requestlist **batch)
+{
+  struct requestlist *req = fdq->head;
+  int op = req->opcode & ~LIO_MODE64;
+  off64_t end;
+  int n = 0;
+
+  do
+    {
+      end = request_offset (req) + req->aiocbp->aiocb.aio_nbytes;
+      batch[n++] = req;
+      req = req->next;
+    }
+  while ((op == LIO_READ || op == LIO_WRITE)
+	 && n < AIO_COALESCE_MAX
+	 && req != NULL
+	 && (req->opcode & ~LIO_MODE64) == op
+	 && req->aiocbp->aiocb.aio_nbytes > 0
+	 && request_offset (req) == end);
+
+  fdq->head = req;
+  if (req == NULL)
+    fdq->tail = NULL;
+  return n;
+}
+
+
+/* readv or writev at OFFSET, leaving the file position alone the way
+   pread and pwrite of this port do.  */
+static ssize_t
+transfer_vector (int fd, int op, struct iovec *iov, int n, off64_t offset)
+{
+  off64_t pos;
+  ssize_t result;
+  int save_errno;
+
+  pos = lseek64 (fd, 0, SEEK_CUR);
+  if (pos == (off64_t) -1)
+    {
+      if (errno != ESPIPE)
+	return -1;
+      return op == LIO_READ ? readv (fd, iov, n) : writev (fd, iov, n);
+    }
+
+  if (lseek64 (fd, offset, SEEK_SET) == (off64_t) -1)
+    return -1;
+  result = op == LIO_READ ? readv (fd, iov, n) : writev (fd, iov, n);
+  save_errno = errno;
+  lseek64 (fd, pos, SEEK_SET);
+  errno = save_errno;
+  return result;
+}
+
+
+/* Do the I/O of the N requests in BATCH, which all use the same
+   descriptor, without holding the lock.  */
+static void
+run_batch (struct requestlist **batch, int n, ssize_t *result, int *error)
+{
+  struct aiocb *cb = &batch[0]->aiocbp->aiocb;
+  int op = batch[0]->opcode & ~LIO_MODE64;
+  int fd = cb->aio_fildes;
+  struct iovec iov[AIO_COALESCE_MAX];
+  ssize_t total;
+  size_t len;
+  int i;
+
+  switch (op)
+    {
+    case LIO_SYNC:
+      total = fsync (fd);
+      break;
+
+    case LIO_DSYNC:
+      total = fdatasync (fd);
+      break;
+
+    default:
+      if (n == 1)
+	{
+	  if (op == LIO_READ)
+	    total = pread64 (fd, (void *) cb->aio_buf, cb->aio_nbytes,
+			     request_offset (batch[0]));
+	  else
+	    total = pwrite64 (fd, (const void *) cb->aio_buf, cb->aio_nbytes,
+			      request_offset (batch[0]));
+	  /* Pipes, sockets and terminals have no offset.  */
+	  if (total == -1 && errno == ESPIPE)
+	    total = (op == LIO_READ
+		     ? read (fd, (void *) cb->aio_buf, cb->aio_nbytes)
+		     : write (fd, (const void *) cb->aio_buf, cb->aio_nbytes));
+	}
+      else
+	{
+	  for (i = 0; i < n; i++)
+	    {
+	      iov[i].iov_base = (void *) batch[i]->aiocbp->aiocb.aio_buf;
+	      iov[i].iov_len = batch[i]->aiocbp->aiocb.aio_nbytes;
+	    }
+	  total = transfer_vector (fd, op, iov, n, request_offset (batch[0]));
+	}
+      break;
+    }
+
+  if (total == -1)
+    {
+      for (i = 0; i < n; i++)
+	{
+	  result[i] = -1;
+	  error[i] = errno;
+	}
+      return;
+    }
+
+  /* A short transfer ends in one of the merged requests, the ones
+     behind it transferred nothing.  */
+  for (i = 0; i < n; i++)
+    {
+      len = batch[i]->aiocbp->aiocb.aio_nbytes;
+      if (op != LIO_READ && op != LIO_WRITE)
+	len = 0;
+      else if ((size_t) total < len)
+	len = total;
+      result[i] = len;
+      error[i] = 0;
+      total -= len;
+    }
+}
+
+
+static void *
+aio_thread (void *arg)
+{
+  struct requestlist *batch[AIO_COALESCE_MAX];
+  ssize_t result[AIO_COALESCE_MAX];
+  int error[AIO_COALESCE_MAX];
+  struct fdqueue *fdq;
+  struct timeval now;
+  struct timespec abstime;
+  sigset_t ss;
+  int n, i, rc;
+
+  /* Signals for the application are not handled in the workers.  */
+  sigfillset (&ss);
+  pthread_sigmask (SIG_SETMASK, &ss, NULL);
+
+  pthread_mutex_lock (&__aio_requests_mutex);
+
+  for (;;)
+    {
+      fdq = runlist_pop ();
+      if (fdq == NULL)
+	{
+	  gettimeofday (&now, NULL);
+	  abstime.tv_sec = now.tv_sec + idle_time;
+	  abstime.tv_nsec = now.tv_usec * 1000;
+	  ++idle_threads;
+	  rc = pthread_cond_timedwait (&work_cond, &__aio_requests_mutex,
+				       &abstime);
+	  --idle_threads;
+	  if (rc == ETIMEDOUT && runlist_head == NULL)
+	    break;
+	  continue;
+	}
+
+      /* All the requests may have been canceled meanwhile.  */
+      if (fdq->head == NULL)
+	{
+	  release_queue (fdq);
+	  continue;
+	}
+
+      fdq->busy = 1;
+      n = take_batch (fdq, batch);
+
+      pthread_mutex_unlock (&__aio_requests_mutex);
+      run_batch (batch, n, result, error);
+      pthread_mutex_lock (&__aio_requests_mutex);
+
+      for (i = 0; i < n; i++)
+	__aio_complete_request (batch[i], result[i], error[i]);
+
+      fdq->busy = 0;
+      if (fdq->head != NULL)
+	runlist_push (fdq);
+      else
+	release_queue (fdq);
+    }
+
+  --nthreads;
+  pthread_mutex_unlock (&__aio_requests_mutex);
+  return NULL;
+}
+
+
+/* Make sure a worker will take the queue just put on the run list.
+   Global lock must be held by caller.  */
+static int
+wake_worker (void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int rc;
+
+  if (idle_threads >= runlist_length)
+    {
+      pthread_cond_signal (&work_cond);
+      return 0;
+    }
+
+  if (nthreads >= max_threads)
+    return 0;
+
+  pthread_attr_init (&attr);
+  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  rc = pthread_create (&thread, &attr, aio_thread, NULL);
+  pthread_attr_destroy (&attr);
+
+  if (rc == 0)
+    {
+      ++nthreads;
+      return 0;
+    }
+
+  /* The running workers get to it eventually.  */
+  return nthreads > 0 ? 0 : -1;
+}
+
+
+/* Queue the request of AIOCBP for OPERATION, counted in GROUP if that
+   is not NULL.  Returns NULL and sets errno if it cannot be queued.  */
+struct requestlist *
+__aio_enqueue_request (union aiocb_union *aiocbp, int operation,
+		       struct aio_group *group)
+{
+  struct aiocb *cb = &aiocbp->aiocb;
+  struct requestlist *req;
+  struct fdqueue *fdq;
+  int err = EAGAIN;
+
+  if (cb->aio_reqprio < 0)
+    {
+      err = EINVAL;
+      goto fail;
+    }
+
+  pthread_mutex_lock (&__aio_requests_mutex);
+
+  req = get_request ();
+  fdq = req != NULL ? find_queue (cb->aio_fildes, 1) : NULL;
+  if (fdq == NULL)
+    {
+      if (req != NULL)
+	release_request (req);
+      pthread_mutex_unlock (&__aio_requests_mutex);
+      goto fail;
+    }
+
+  req->next = NULL;
+  req->aiocbp = aiocbp;
+  req->opcode = operation;
+  req->caller_pid = getpid ();
+  req->group = group;
+
+  cb->__return_value = 0;
+  cb->__error_code = EINPROGRESS;
+
+  if (fdq->tail != NULL)
+    fdq->tail->next = req;
+  else
+    fdq->head = req;
+  fdq->tail = req;
+
+  /* A queue which is neither run nor waiting for a worker was empty.  */
+  if (!fdq->busy && !fdq->runnable)
+    {
+      runlist_push (fdq);
+      if (wake_worker () != 0)
+	{
+	  runlist_pop ();
+	  release_queue (fdq);
+	  release_request (req);
+	  pthread_mutex_unlock (&__aio_requests_mutex);
+	  goto fail;
+	}
+    }
+
+  if (group != NULL)
+    ++group->pending;
+
+  pthread_mutex_unlock (&__aio_requests_mutex);
+  return req;
+
+ fail:
+  cb->__return_value = -1;
+  cb->__error_code = err;
+  errno = err;
+  return NULL;
+}
+
+
+static void
+aio_sigqueue (int sig, const union sigval val, pid_t caller_pid)
+{
+#ifdef __NR_rt_sigqueueinfo
+  siginfo_t info;
+
+  /* First, clear the siginfo_t structure, so that we don't pass our
+     stack content to other tasks.  */
+  memset (&info, 0, sizeof (siginfo_t));
+  info.si_signo = sig;
+  info.si_code = SI_ASYNCIO;
+  info.si_pid = getpid ();
+  info.si_uid = getuid ();
+  info.si_value = val;
+
+  INLINE_SYSCALL (rt_sigqueueinfo, 3, caller_pid, sig, &info);
+#else
+  kill (caller_pid, sig);
+#endif
+}
+
+
+struct notify_func
+{
+  void (*func) (union sigval);
+  union sigval value;
+};
+
+static void *
+notify_func_wrapper (void *arg)
+{
+  struct notify_func *nf = (struct notify_func *) arg;
+  void (*func) (union sigval) = nf->func;
+  union sigval value = nf->value;
+
+  free (nf);
+  func (value);
+  return NULL;
+}
+
+
+/* Send the notification of SIGEV.  A SIGEV_THREAD function runs in a
+   thread of its own so that it cannot hold up the workers.  */
+void
+__aio_notify_only (struct sigevent *sigev, pid_t caller_pid)
+{
+  pthread_attr_t attr, *pattr;
+  struct notify_func *nf;
+  pthread_t thread;
+  int detached = PTHREAD_CREATE_DETACHED;
+
+  switch (sigev->sigev_notify)
+    {
+    case SIGEV_SIGNAL:
+      aio_sigqueue (sigev->sigev_signo, sigev->sigev_value, caller_pid);
+      break;
+
+    case SIGEV_THREAD:
+      nf = (struct notify_func *) malloc (sizeof (struct notify_func));
+      if (nf == NULL)
+	break;
+      nf->func = sigev->sigev_notify_function;
+      nf->value = sigev->sigev_value;
+
+      pattr = (pthread_attr_t *) sigev->sigev_notify_attributes;
+      if (pattr == NULL)
+	{
+	  pthread_attr_init (&attr);
+	  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+	  pattr = &attr;
+	}
+      else
+	pthread_attr_getdetachstate (pattr, &detached);
+
+      if (pthread_create (&thread, pattr, notify_func_wrapper, nf) != 0)
+	free (nf);
+      else if (detached != PTHREAD_CREATE_DETACHED)
+	pthread_detach (thread);
+
+      if (pattr == &attr)
+	pthread_attr_destroy (&attr);
+      break;
+
+    default:
+      break;
+    }
+}
+
+
+/* Record the result of REQ, notify and release it.  Global lock must
+   be held by caller.  */
+void
+__aio_complete_request (struct requestlist *req, ssize_t result, int error)
+{
+  struct aiocb *cb = &req->aiocbp->aiocb;
+  struct aio_group *group = req->group;
+
+  /* aio_error polls __error_code without the lock, so the release
+     store makes __return_value visible before it.  */
+  cb->__return_value = result;
+  __atomic_store_n (&cb->__error_code, error, __ATOMIC_RELEASE);
+
+  __aio_notify_only (&cb->aio_sigevent, req->caller_pid);
+
+  if (group != NULL && --group->pending == 0 && !group->waiting)
+    {
+      __aio_notify_only (&group->sigev, group->caller_pid);
+      free (group);
+    }
+
+  pthread_cond_broadcast (&__aio_done_cond);
+  release_request (req);
+}
+
+
+/* The queue of FD if it has queued or running requests.  Global lock
+   must be held by caller.  */
+struct fdqueue *
+__aio_find_queue (int fd)
+{
+  return find_queue (fd, 0);
+}
+
+
+/* Set the number of worker threads and their idle time, and prepare
+   requests for the expected number of simultaneous ones.  */
+void
+aio_init (const struct aioinit *init)
+{
+  struct requestlist *req;
+  int i;
+
+  pthread_mutex_lock (&__aio_requests_mutex);
+
+  if (init->aio_threads > 0)
+    max_threads = init->aio_threads;
+  if (init->aio_idle_time > 0)
+    idle_time = init->aio_idle_time;
+
+  for (i = 0; i < init->aio_num; i++)
+    {
+      req = (struct requestlist *) malloc (sizeof (struct requestlist));
+      if (req == NULL)
+	break;
+      release_request (req);
+    }
+
+  pthread_mutex_unlock (&__aio_requests_mutex);
+}
@@ -0,0 +1,89 @@
+/* Wait for asynchronous requests.  */
+
+#include <aio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "posix-aio.h"
+
+static int
+do_aio_suspend (const union aiocb_union *const list[], int nent,
+		const struct timespec *timeout)
+{
+  struct timeval now;
+  struct timespec abstime;
+  int i, pending, rc;
+
+  if (nent < 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (timeout != NULL)
+    {
+      gettimeofday (&now, NULL);
+      abstime.tv_sec = now.tv_sec + timeout->tv_sec;
+      abstime.tv_nsec = now.tv_usec * 1000 + timeout->tv_nsec;
+      if (abstime.tv_nsec >= 1000000000)
+	{
+	  abstime.tv_nsec -= 1000000000;
+	  abstime.tv_sec += 1;
+	}
+    }
+
+  pthread_mutex_lock (&__aio_requests_mutex);
+
+  for (;;)
+    {
+      pending = 0;
+      for (i = 0; i < nent; i++)
+	if (list[i] != NULL)
+	  {
+	    if (list[i]->aiocb.__error_code != EINPROGRESS)
+	      break;
+	    pending = 1;
+	  }
+      if (i < nent || !pending)
+	break;
+
+      if (timeout == NULL)
+	pthread_cond_wait (&__aio_done_cond, &__aio_requests_mutex);
+      else
+	{
+	  rc = pthread_cond_timedwait (&__aio_done_cond,
+				       &__aio_requests_mutex, &abstime);
+	  if (rc == ETIMEDOUT)
+	    {
+	      pthread_mutex_unlock (&__aio_requests_mutex);
+	      errno = EAGAIN;
+	      return -1;
+	    }
+	}
+    }
+
+  pthread_mutex_unlock (&__aio_requests_mutex);
+  return 0;
+}
+
+int
+aio_suspend (list, nent, timeout)
+     const struct aiocb *const list[];
+     int nent;
+     const struct timespec *timeout;
+{
+  return do_aio_suspend ((const union aiocb_union *const *) list, nent,
+			 timeout);
+}
+
+int
+aio_suspend64 (list, nent, timeout)
+     const struct aiocb64 *const list[];
+     int nent;
+     const struct timespec *timeout;
+{
+  return do_aio_suspend ((const union aiocb_union *const *) list, nent,
+			 timeout);
+}
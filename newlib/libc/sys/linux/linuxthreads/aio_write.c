@@ -0,0 +1,22 @@
+/* Asynchronous write, see aio_routines.c.  */
+
+#include <aio.h>
+
+#include "posix-aio.h"
+
+int
+aio_write (aiocbp)
+     struct aiocb *aiocbp;
+{
+  return (__aio_enqueue_request ((union aiocb_union *) aiocbp, LIO_WRITE, NULL)
+	  == NULL ? -1 : 0);
+}
+
+int
+aio_write64 (aiocbp)
+     struct aiocb64 *aiocbp;
+{
+  return (__aio_enqueue_request ((union aiocb_union *) aiocbp,
+				 LIO_WRITE | LIO_MODE64, NULL)
+	  == NULL ? -1 : 0);
+}
@@ -189,7 +189,7 @@ int __pthread_attr_setstacksize(pthread_attr_t *attr, size_t stacksize)
 {
 #ifdef FLOATING_STACKS
   /* We have to check against the maximum allowed stack size.  This is no
-     problem if the manager is already started and we determined it.  If
+     problem if a thread was already created and we determined it.  If
      this hasn't happened, we have to find the limit outself.  */
   if (__pthread_max_stacksize == 0)
     __pthread_init_max_stacksize ();
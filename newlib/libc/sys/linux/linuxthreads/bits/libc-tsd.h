@@ -25,6 +25,7 @@
 enum __libc_tsd_key_t { _LIBC_TSD_KEY_MALLOC = 0,
 			_LIBC_TSD_KEY_DL_ERROR,
 			_LIBC_TSD_KEY_RPC_VARS,
+			_LIBC_TSD_KEY_INTL,
 			_LIBC_TSD_KEY_N };
 
 extern void *(*__libc_internal_tsd_get) (enum __libc_tsd_key_t) __THROW;
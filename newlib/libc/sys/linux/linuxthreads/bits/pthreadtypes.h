@@ -55,8 +55,8 @@ typedef struct __pthread_attr_s
 /* Conditions (not abstract because of PTHREAD_COND_INITIALIZER */
 typedef struct
 {
-  struct _pthread_fastlock __c_lock; /* Protect against concurrent access */
-  _pthread_descr __c_waiting;        /* Threads waiting on this condition */
+  struct _pthread_fastlock __c_lock; /* Wakeup sequence and waiter count */
+  void *__c_mutex;                   /* Mutex of the waiters */
 } pthread_cond_t;
 
 
@@ -101,8 +101,8 @@ typedef struct _pthread_rwlock_t
   struct _pthread_fastlock __rw_lock; /* Lock to guarantee mutual exclusion */
   int __rw_readers;                   /* Number of readers */
   _pthread_descr __rw_writer;         /* Identity of writer, or NULL if none */
-  _pthread_descr __rw_read_waiting;   /* Threads waiting for reading */
-  _pthread_descr __rw_write_waiting;  /* Threads waiting for writing */
+  long int __rw_read_waiting;         /* Futex word of waiting readers */
+  long int __rw_write_waiting;        /* Futex word of waiting writers */
   int __rw_kind;                      /* Reader/Writer preference selection */
   int __rw_pshared;                   /* Shared between processes or not */
 } pthread_rwlock_t;
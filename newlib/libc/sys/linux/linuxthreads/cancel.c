@@ -111,7 +111,7 @@ int pthread_cancel(pthread_t thread)
   if (dorestart)
     restart(th);
   else
-    kill(pid, __pthread_sig_cancel);
+    __tkill(pid, __pthread_sig_cancel);
 
   return 0;
 }
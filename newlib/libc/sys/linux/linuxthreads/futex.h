@@ -0,0 +1,134 @@
+/* Waiting on futexes, and the lock built on them that the internal locks,
+   mutexes, condition variables, read-write locks and semaphores use.  */
+
+#ifndef _FUTEX_H
+#define _FUTEX_H	1
+
+#include <errno.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sysdep.h>
+
+#define FUTEX_WAIT	0
+#define FUTEX_WAKE	1
+#define FUTEX_REQUEUE	3
+
+/* Most futex words are long int fields of the types in
+   bits/pthreadtypes.h, which are int sized on the targets.  */
+typedef int __attribute__ ((__may_alias__)) futex_word_t;
+
+/* The futex word of a struct _pthread_fastlock used as a futex lock:
+   0 free, 1 taken, 2 taken and maybe waited for.  */
+#define __futex_word(lock) ((futex_word_t *) &(lock)->__status)
+
+/* Sleep as long as *FUTEX is VAL, but at most RELTIME unless that is
+   NULL.  Returns 0 when woken, EWOULDBLOCK if *FUTEX was not VAL, EINTR
+   or ETIMEDOUT.  errno is left alone.  */
+static inline int
+futex_wait (futex_word_t *futex, int val, const struct timespec *reltime)
+{
+  int saved_errno = errno;
+  int err = 0;
+
+  if (INLINE_SYSCALL (futex, 4, futex, FUTEX_WAIT, val, reltime) < 0)
+    err = errno;
+  __set_errno (saved_errno);
+  return err;
+}
+
+/* Wake up to NR threads sleeping on FUTEX.  */
+static inline void
+futex_wake (futex_word_t *futex, int nr)
+{
+  int saved_errno = errno;
+
+  INLINE_SYSCALL (futex, 3, futex, FUTEX_WAKE, nr);
+  __set_errno (saved_errno);
+}
+
+/* Wake up to NR_WAKE threads sleeping on FUTEX and move up to NR_MOVE
+   of the others over to sleep on FUTEX2.  */
+static inline void
+futex_requeue (futex_word_t *futex, int nr_wake, int nr_move, futex_word_t *futex2)
+{
+  int saved_errno = errno;
+
+  INLINE_SYSCALL (futex, 5, futex, FUTEX_REQUEUE, nr_wake, nr_move, futex2);
+  __set_errno (saved_errno);
+}
+
+/* Store in RELTIME how long it is until ABSTIME.  Returns ETIMEDOUT if
+   that has passed, otherwise 0.  */
+static inline int
+__futex_reltime (const struct timespec *abstime, struct timespec *reltime)
+{
+  struct timeval now;
+
+  __gettimeofday (&now, NULL);
+  reltime->tv_sec = abstime->tv_sec - now.tv_sec;
+  reltime->tv_nsec = abstime->tv_nsec - now.tv_usec * 1000;
+  if (reltime->tv_nsec < 0)
+    {
+      reltime->tv_nsec += 1000000000;
+      reltime->tv_sec--;
+    }
+  return reltime->tv_sec < 0 ? ETIMEDOUT : 0;
+}
+
+static inline int
+__futex_trylock (futex_word_t *futex)
+{
+  return __int_compare_and_exchange (futex, 0, 1) == 0 ? 0 : EBUSY;
+}
+
+/* Take the lock, leaving it marked as waited for, as a thread must that
+   may have been requeued onto FUTEX while others still sleep there.  */
+static inline void
+__futex_lock_contended (futex_word_t *futex)
+{
+  while (__int_exchange (futex, 2) != 0)
+    futex_wait (futex, 2, NULL);
+}
+
+static inline void
+__futex_lock (futex_word_t *futex)
+{
+  int c = __int_compare_and_exchange (futex, 0, 1);
+
+  if (__builtin_expect (c != 0, 0))
+    {
+      if (c == 2 || __int_exchange (futex, 2) != 0)
+	__futex_lock_contended (futex);
+    }
+}
+
+/* Take the lock unless ABSTIME passes first.  Returns 0 or ETIMEDOUT.  */
+static inline int
+__futex_timedlock (futex_word_t *futex, const struct timespec *abstime)
+{
+  struct timespec reltime;
+  int c = __int_compare_and_exchange (futex, 0, 1);
+
+  if (c == 0)
+    return 0;
+  if (c != 2)
+    c = __int_exchange (futex, 2);
+  while (c != 0)
+    {
+      if (__futex_reltime (abstime, &reltime) != 0)
+	return ETIMEDOUT;
+      futex_wait (futex, 2, &reltime);
+      c = __int_exchange (futex, 2);
+    }
+  return 0;
+}
+
+/* Release the lock, waking a waiter only if there may be one.  */
+static inline void
+__futex_unlock (futex_word_t *futex)
+{
+  if (__int_exchange (futex, 0) != 1)
+    futex_wake (futex, 1);
+}
+
+#endif /* futex.h */
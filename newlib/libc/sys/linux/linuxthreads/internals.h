@@ -186,6 +186,11 @@ struct _pthread_descr_struct {
 #if HP_TIMING_AVAIL
   hp_timing_t p_cpuclock_offset; /* Initial CPU clock for thread.  */
 #endif
+  int p_alive;                  /* nonzero until the kernel task is gone;
+				   cleared and woken as a futex by the kernel
+				   (CLONE_CHILD_CLEARTID) */
+  struct pthread_lockstats p_lockstats; /* lock statistics of the thread,
+					   times in lock clock units */
   /* New elements must be added at the end.  */
 } __attribute__ ((__aligned__(32))); /* We need to align the structure so that
 				    doubles are aligned properly.  This is 8
@@ -204,36 +209,6 @@ struct pthread_handle_struct {
   char * h_bottom;              /* Lowest address in the stack thread */
 };
 
-/* The type of messages sent to the thread manager thread */
-
-struct pthread_request {
-  pthread_descr req_thread;     /* Thread doing the request */
-  enum {                        /* Request kind */
-    REQ_CREATE, REQ_FREE, REQ_PROCESS_EXIT, REQ_MAIN_THREAD_EXIT,
-    REQ_POST, REQ_DEBUG, REQ_KICK, REQ_FOR_EACH_THREAD
-  } req_kind;
-  union {                       /* Arguments for request */
-    struct {                    /* For REQ_CREATE: */
-      const pthread_attr_t * attr; /* thread attributes */
-      void * (*fn)(void *);     /*   start function */
-      void * arg;               /*   argument to start function */
-      sigset_t mask;            /*   signal mask */
-    } create;
-    struct {                    /* For REQ_FREE: */
-      pthread_t thread_id;      /*   identifier of thread to free */
-    } free;
-    struct {                    /* For REQ_PROCESS_EXIT: */
-      int code;                 /*   exit status */
-    } exit;
-    void * post;                /* For REQ_POST: the semaphore */
-    struct {			/* For REQ_FOR_EACH_THREAD: callback */
-      void (*fn)(void *, pthread_descr);
-      void *arg;
-    } for_each;
-  } req_args;
-};
-
-
 /* Signals used for suspend/restart and for cancellation notification.  */
 
 extern int __pthread_sig_restart;
@@ -253,7 +228,8 @@ extern struct pthread_handle_struct __pthread_handles[PTHREAD_THREADS_MAX];
 
 extern struct _pthread_descr_struct __pthread_initial_thread;
 
-/* Descriptor of the manager thread */
+/* Descriptor of the former manager thread, still in __pthread_handles[1]
+   for debuggers; its p_pid of 0 tells them it does not run */
 
 extern struct _pthread_descr_struct __pthread_manager_thread;
 
@@ -273,28 +249,30 @@ extern char *__pthread_initial_thread_bos;
 
 extern int __pthread_nonstandard_stacks;
 
-/* File descriptor for sending requests to the thread manager.
-   Initially -1, meaning that __pthread_initialize_manager must be called. */
+/* Nonzero once pthread_create has been called.  Initially 0, meaning
+   that __pthread_initialize_threads must be called. */
 
-extern int __pthread_manager_request;
+extern int __pthread_threads_started;
 
-/* Other end of the pipe for sending requests to the thread manager. */
+/* Lock for the list of live threads, the slots of __pthread_handles
+   and the cache of thread stacks. */
 
-extern int __pthread_manager_reader;
+extern struct _pthread_fastlock __pthread_threads_lock;
 
-/* Limits of the thread manager stack. */
+/* Number of detached threads that have terminated and whose resources
+   the next pthread_create reclaims once their kernel task is gone. */
 
-extern char *__pthread_manager_thread_bos;
-extern char *__pthread_manager_thread_tos;
+extern int __pthread_detached_exits;
 
 #ifdef FLOATING_STACKS
 /* Maximum stack size.  */
 extern size_t __pthread_max_stacksize;
 #endif
 
-/* Pending request for a process-wide exit */
+/* Pending request for a process-wide exit, and the thread making it */
 
 extern int __pthread_exit_requested, __pthread_exit_code;
+extern pthread_descr __pthread_exit_thread;
 
 /* Set to 1 by gdb if we're debugging */
 
@@ -309,6 +287,9 @@ extern volatile pthread_descr __pthread_last_event;
 /* Flag which tells whether we are executing on SMP kernel. */
 extern int __pthread_smp_kernel;
 
+/* Nonzero while the lock statistics are kept, see spinlock.c.  */
+extern int __pthread_lockstats_enabled;
+
 /* Return the handle corresponding to a thread id */
 
 static inline pthread_handle thread_handle(pthread_t id)
@@ -353,10 +334,10 @@ static inline int nonexisting_handle(pthread_handle h, pthread_t id)
 #define INITIAL_STACK_SIZE  (4 * PAGE_SIZE)
 #endif
 
-/* Size of the thread manager stack. The "- 32" avoids wasting space
-   with some malloc() implementations. */
-#ifndef THREAD_MANAGER_STACK_SIZE
-#define THREAD_MANAGER_STACK_SIZE  (2 * PAGE_SIZE - 32)
+/* How many bytes of the stacks of joined threads are kept mapped for
+   new threads to reuse.  */
+#ifndef STACK_CACHE_SIZE
+#define STACK_CACHE_SIZE  (40 * 1024 * 1024)
 #endif
 
 /* The base of the "array" of thread stacks.  The array will grow down from
@@ -385,9 +366,6 @@ static inline pthread_descr thread_self (void)
   char *sp = CURRENT_STACK_FRAME;
   if (sp >= __pthread_initial_thread_bos)
     return &__pthread_initial_thread;
-  else if (sp >= __pthread_manager_thread_bos
-	   && sp < __pthread_manager_thread_tos)
-    return &__pthread_manager_thread;
   else if (__pthread_nonstandard_stacks)
     return __pthread_find_self();
   else
@@ -422,8 +400,9 @@ static inline pthread_descr thread_self (void)
 #define MAX_SPIN_COUNT 50
 #endif
 
-/* Max number of times the spinlock in the adaptive mutex implementation
-   spins actively on SMP systems.  */
+/* Max number of times the internal locks, the adaptive and recursive
+   mutexes and the queue locks spin actively on SMP systems, see
+   spinlock.c.  */
 
 #ifndef MAX_ADAPTIVE_SPIN_COUNT
 #define MAX_ADAPTIVE_SPIN_COUNT 100
@@ -457,11 +436,21 @@ extern void __pthread_do_exit (void *retval, char *currentframe)
 extern void __pthread_destroy_specifics (void);
 extern void __pthread_perform_cleanup (char *currentframe);
 extern void __pthread_init_max_stacksize (void);
-extern int __pthread_initialize_manager (void);
+extern void __pthread_initialize_threads (void);
 extern void __pthread_message (char * fmt, ...);
-extern int __pthread_manager (void *reqfd);
-extern int __pthread_manager_event (void *reqfd);
-extern void __pthread_manager_sighandler (int sig);
+extern int __pthread_handle_create (pthread_t *thread,
+				    const pthread_attr_t *attr,
+				    void * (*start_routine)(void *),
+				    void *arg);
+extern void __pthread_handle_free (pthread_descr th);
+extern void __pthread_handle_exit (pthread_descr issuing_thread,
+				   int exitcode);
+extern void __pthread_wait_for_threads (pthread_descr self);
+extern void __pthread_for_each_thread (void *arg,
+				       void (*fn)(void *, pthread_descr));
+extern void __pthread_reset_threads (void);
+extern void __pthread_lockstats_collect (struct pthread_lockstats *sum,
+					 int reset);
 extern void __pthread_reset_main_thread (void);
 extern void __pthread_once_fork_prepare (void);
 extern void __pthread_once_fork_parent (void);
@@ -469,7 +458,6 @@ extern void __pthread_once_fork_child (void);
 extern void __flockfilelist (void);
 extern void __funlockfilelist (void);
 extern void __fresetlockfiles (void);
-extern void __pthread_manager_adjust_prio (int thread_prio);
 extern void __pthread_initialize_minimal (void);
 
 extern int __pthread_attr_setguardsize (pthread_attr_t *__attr,
@@ -492,6 +480,7 @@ extern int __pthread_getconcurrency (void);
 extern int __pthread_setconcurrency (int __level);
 extern int __pthread_mutex_timedlock (pthread_mutex_t *__mutex,
 				      const struct timespec *__abstime);
+extern void __pthread_mutex_cond_lock (pthread_mutex_t *__mutex);
 extern int __pthread_mutexattr_getpshared (const pthread_mutexattr_t *__attr,
 					   int *__pshared);
 extern int __pthread_mutexattr_setpshared (pthread_mutexattr_t *__attr,
@@ -540,6 +529,15 @@ extern void (*__pthread_restart)(pthread_descr);
 extern void (*__pthread_suspend)(pthread_descr);
 extern int (*__pthread_timedsuspend)(pthread_descr, const struct timespec *);
 
+/* Start a task running FN (ARG) on CHILD_STACK.  The thread id pointers
+   and the TLS descriptor are only used with the CLONE_ flags for them.  */
+extern int __clone (int (*__fn) (void *), void *__child_stack, int __flags,
+		    void *__arg, pid_t *__ptid, void *__tls, pid_t *__ctid);
+
+/* Send SIG to the thread with kernel id TID; all threads are one thread
+   group, to which kill() sends the signal as a whole.  */
+extern int __tkill (pid_t __tid, int __sig);
+
 /* Prototypes for the function without cancelation support when the
    normal version has it.  */
 extern int __libc_close (int fd);
@@ -15,13 +15,15 @@
 /* Thread termination and joining */
 
 #include <errno.h>
+#include <limits.h>
 #include <sched.h>
+#include <setjmp.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include "pthread.h"
 #include "internals.h"
 #include "spinlock.h"
-#include "restart.h"
+#include "futex.h"
 
 void pthread_exit(void * retval)
 {
@@ -31,8 +33,6 @@ void pthread_exit(void * retval)
 void __pthread_do_exit(void *retval, char *currentframe)
 {
   pthread_descr self = thread_self();
-  pthread_descr joining;
-  struct pthread_request request;
 
   /* Reset the cancellation flag to avoid looping if the cleanup handlers
      contain cancellation points */
@@ -64,25 +64,27 @@ void __pthread_do_exit(void *retval, char *currentframe)
 	  __linuxthreads_death_event();
 	}
     }
-  /* Say that we've terminated */
+  /* Say that we've terminated.  A joining thread waits for the kernel
+     to clear p_alive as we exit, a detached thread is freed by a later
+     pthread_create. */
   THREAD_SETMEM(self, p_terminated, 1);
-  /* See if someone is joining on us */
-  joining = THREAD_GETMEM(self, p_joining);
+  if (THREAD_GETMEM(self, p_detached))
+    __int_exchange_and_add(&__pthread_detached_exits, 1);
   __pthread_unlock(THREAD_GETMEM(self, p_lock));
-  /* Restart joining thread if any */
-  if (joining != NULL) restart(joining);
+  /* The kernel task of the main thread lives as long as the process, so
+     we have to wake up those joining us ourselves */
+  if (self == __pthread_main_thread) {
+    THREAD_SETMEM(self, p_alive, 0);
+    futex_wake(&self->p_alive, INT_MAX);
+  }
   /* If this is the initial thread, block until all threads have terminated.
      If another thread calls exit, we'll be terminated from our signal
      handler. */
-  if (self == __pthread_main_thread && __pthread_manager_request >= 0) {
-    request.req_thread = self;
-    request.req_kind = REQ_MAIN_THREAD_EXIT;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *)&request, sizeof(request)));
-    suspend(self);
+  if (self == __pthread_main_thread && __pthread_threads_started) {
+    __pthread_wait_for_threads(self);
     /* Main thread flushes stdio streams and runs atexit functions.
-       It also calls a handler within LinuxThreads which sends a process exit
-       request to the thread manager. */
+       It also calls a handler within LinuxThreads which terminates the
+       threads created meanwhile, if any. */
     exit(0);
   }
   /* Threads other than the main one  terminate without flushing stdio streams
@@ -90,37 +92,13 @@ void __pthread_do_exit(void *retval, char *currentframe)
   _exit(0);
 }
 
-/* Function called by pthread_cancel to remove the thread from
-   waiting on a condition variable queue. */
-
-static int join_extricate_func(void *obj, pthread_descr th)
-{
-  volatile pthread_descr self = thread_self();
-  pthread_handle handle = obj;
-  pthread_descr jo;
-  int did_remove = 0;
-
-  __pthread_lock(&handle->h_lock, self);
-  jo = handle->h_descr;
-  did_remove = jo->p_joining != NULL;
-  jo->p_joining = NULL;
-  __pthread_unlock(&handle->h_lock);
-
-  return did_remove;
-}
-
 int pthread_join(pthread_t thread_id, void ** thread_return)
 {
   volatile pthread_descr self = thread_self();
-  struct pthread_request request;
   pthread_handle handle = thread_handle(thread_id);
   pthread_descr th;
-  pthread_extricate_if extr;
-  int already_canceled = 0;
-
-  /* Set up extrication interface */
-  extr.pu_object = handle;
-  extr.pu_extricate_func = join_extricate_func;
+  sigjmp_buf jmpbuf;
+  int alive;
 
   __pthread_lock(&handle->h_lock, self);
   if (nonexisting_handle(handle, thread_id)) {
@@ -137,52 +115,38 @@ int pthread_join(pthread_t thread_id, void ** thread_return)
     __pthread_unlock(&handle->h_lock);
     return EINVAL;
   }
-  /* If not terminated yet, suspend ourselves. */
-  if (! th->p_terminated) {
-    /* Register extrication interface */
-    __pthread_set_own_extricate_if(self, &extr);
-    if (!(THREAD_GETMEM(self, p_canceled)
-	&& THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE))
-      th->p_joining = self;
-    else
-      already_canceled = 1;
-    __pthread_unlock(&handle->h_lock);
-
-    if (already_canceled) {
-      __pthread_set_own_extricate_if(self, 0);
-      __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
+  th->p_joining = self;
+  __pthread_unlock(&handle->h_lock);
+  /* Wait until the kernel task of the thread is gone, so that its stack
+     is no longer used.  This is a cancellation point. */
+  while ((alive = th->p_alive) != 0) {
+    if (sigsetjmp(jmpbuf, 1) == 0) {
+      THREAD_SETMEM(self, p_cancel_jmp, &jmpbuf);
+      if (!(THREAD_GETMEM(self, p_canceled)
+	    && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE))
+	futex_wait(&th->p_alive, alive, NULL);
     }
-
-    suspend(self);
-    /* Deregister extrication interface */
-    __pthread_set_own_extricate_if(self, 0);
-
-    /* This is a cancellation point */
-    if (THREAD_GETMEM(self, p_woken_by_cancel)
+    THREAD_SETMEM(self, p_cancel_jmp, NULL);
+    if (THREAD_GETMEM(self, p_canceled)
 	&& THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE) {
-      THREAD_SETMEM(self, p_woken_by_cancel, 0);
+      /* The thread may be joined again */
+      __pthread_lock(&handle->h_lock, self);
+      th->p_joining = NULL;
+      __pthread_unlock(&handle->h_lock);
       __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
     }
-    __pthread_lock(&handle->h_lock, self);
   }
   /* Get return value */
   if (thread_return != NULL) *thread_return = th->p_retval;
-  __pthread_unlock(&handle->h_lock);
-  /* Send notification to thread manager */
-  if (__pthread_manager_request >= 0) {
-    request.req_thread = self;
-    request.req_kind = REQ_FREE;
-    request.req_args.free.thread_id = thread_id;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-  }
+  /* Free the thread, unless it is the main thread */
+  if (th != __pthread_main_thread)
+    __pthread_handle_free(th);
   return 0;
 }
 
 int pthread_detach(pthread_t thread_id)
 {
   int terminated;
-  struct pthread_request request;
   pthread_handle handle = thread_handle(thread_id);
   pthread_descr th;
 
@@ -206,13 +170,9 @@ int pthread_detach(pthread_t thread_id)
   th->p_detached = 1;
   terminated = th->p_terminated;
   __pthread_unlock(&handle->h_lock);
-  /* If already terminated, notify thread manager to reclaim resources */
-  if (terminated && __pthread_manager_request >= 0) {
-    request.req_thread = thread_self();
-    request.req_kind = REQ_FREE;
-    request.req_args.free.thread_id = thread_id;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-  }
+  /* If already terminated, have the next pthread_create reclaim the
+     resources, once the kernel is done with the stack */
+  if (terminated)
+    __int_exchange_and_add(&__pthread_detached_exits, 1);
   return 0;
 }
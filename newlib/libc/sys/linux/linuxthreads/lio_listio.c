@@ -0,0 +1,107 @@
+/* Start a list of asynchronous requests.  */
+
+#include <aio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "posix-aio.h"
+
+static int
+do_lio_listio (int mode, union aiocb_union *const list[], int nent,
+	       struct sigevent *sig, int mode64)
+{
+  struct aio_group *group = NULL;
+  int i, op, failed = 0;
+
+  if ((mode != LIO_WAIT && mode != LIO_NOWAIT) || nent < 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  /* The group counts the requests until all of them are done, it
+     starts at one so that it cannot complete while they are queued.  */
+  if (mode == LIO_WAIT || (sig != NULL && sig->sigev_notify != SIGEV_NONE))
+    {
+      group = (struct aio_group *) malloc (sizeof (struct aio_group));
+      if (group == NULL)
+	{
+	  errno = EAGAIN;
+	  return -1;
+	}
+      group->pending = 1;
+      group->waiting = mode == LIO_WAIT;
+      group->caller_pid = getpid ();
+      if (mode == LIO_NOWAIT)
+	group->sigev = *sig;
+      else
+	group->sigev.sigev_notify = SIGEV_NONE;
+    }
+
+  for (i = 0; i < nent; i++)
+    if (list[i] != NULL)
+      {
+	op = list[i]->aiocb.aio_lio_opcode;
+	if (op != LIO_READ && op != LIO_WRITE)
+	  continue;
+	if (__aio_enqueue_request (list[i], op | mode64, group) == NULL)
+	  failed = 1;
+      }
+
+  if (group != NULL)
+    {
+      pthread_mutex_lock (&__aio_requests_mutex);
+      --group->pending;
+      if (mode == LIO_WAIT)
+	{
+	  while (group->pending > 0)
+	    pthread_cond_wait (&__aio_done_cond, &__aio_requests_mutex);
+	  free (group);
+	}
+      else if (group->pending == 0)
+	{
+	  __aio_notify_only (&group->sigev, group->caller_pid);
+	  free (group);
+	}
+      pthread_mutex_unlock (&__aio_requests_mutex);
+    }
+
+  /* With LIO_WAIT, a request that failed also fails the call.  */
+  if (mode == LIO_WAIT && !failed)
+    for (i = 0; i < nent; i++)
+      if (list[i] != NULL
+	  && (list[i]->aiocb.aio_lio_opcode == LIO_READ
+	      || list[i]->aiocb.aio_lio_opcode == LIO_WRITE)
+	  && list[i]->aiocb.__error_code != 0)
+	failed = 1;
+
+  if (failed)
+    {
+      errno = EIO;
+      return -1;
+    }
+  return 0;
+}
+
+int
+lio_listio (mode, list, nent, sig)
+     int mode;
+     struct aiocb *const list[];
+     int nent;
+     struct sigevent *sig;
+{
+  return do_lio_listio (mode, (union aiocb_union *const *) list, nent, sig, 0);
+}
+
+int
+lio_listio64 (mode, list, nent, sig)
+     int mode;
+     struct aiocb64 *const list[];
+     int nent;
+     struct sigevent *sig;
+{
+  return do_lio_listio (mode, (union aiocb_union *const *) list, nent, sig,
+			LIO_MODE64);
+}
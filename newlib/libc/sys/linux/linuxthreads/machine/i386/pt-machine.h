@@ -27,6 +27,10 @@
    of the stack, just something somewhere in the current frame.  */
 #define CURRENT_STACK_FRAME  __builtin_frame_address (0)
 
+/* Tell the processor we are spinning, see spinlock.c.  This is the pause
+   instruction on the Pentium 4 and a plain nop before.  */
+#define BUSY_WAIT_NOP  __asm__ __volatile__ ("rep; nop")
+
 
 /* Spinlock implementation; required.  */
 PT_EI long int
@@ -96,3 +100,46 @@ compare_and_swap_is_available (void)
      Otherwise, it's a 486 or above and it has cmpxchg.  */
   return changed != 0;
 }
+
+
+/* Atomic operations on the int words the futex-based synchronization
+   objects sleep on, see futex.h.  They need cmpxchg and xadd, that is a
+   486, which any kernel with futexes implies anyway.  */
+
+PT_EI int
+__int_compare_and_exchange (int *p, int oldval, int newval)
+{
+  int readval;
+
+  __asm__ __volatile__ ("lock; cmpxchgl %2, %1"
+			: "=a" (readval), "=m" (*p)
+			: "r" (newval), "m" (*p), "0" (oldval)
+			: "memory");
+  return readval;
+}
+
+
+PT_EI int
+__int_exchange (int *p, int newval)
+{
+  int readval;
+
+  __asm__ __volatile__ ("xchgl %0, %1"
+			: "=r" (readval), "=m" (*p)
+			: "0" (newval), "m" (*p)
+			: "memory");
+  return readval;
+}
+
+
+PT_EI int
+__int_exchange_and_add (int *p, int val)
+{
+  int readval;
+
+  __asm__ __volatile__ ("lock; xaddl %0, %1"
+			: "=r" (readval), "=m" (*p)
+			: "0" (val), "m" (*p)
+			: "memory");
+  return readval;
+}
@@ -12,7 +12,9 @@
 /* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        */
 /* GNU Library General Public License for more details.                 */
 
-/* The "thread manager" thread: manages creation and termination of threads */
+/* Creation and termination of threads, which used to be done by a
+   "thread manager" thread.  Now each thread clones the threads it creates
+   itself, and the kernel reports their exit through the p_alive futex. */
 
 #include <errno.h>
 #define __USE_MISC
@@ -22,17 +24,33 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/poll.h>		/* for poll */
 #include <sys/mman.h>           /* for mmap */
 #include <sys/param.h>
 #include <sys/time.h>
-#include <sys/wait.h>           /* for waitpid macros */
 
 #include "pthread.h"
 #include "internals.h"
 #include "spinlock.h"
-#include "restart.h"
-#include "semaphore.h"
+#include "futex.h"
+
+/* Clone flags the kernel headers may not know yet (Linux 2.5.49).  */
+#ifndef CLONE_THREAD
+#define CLONE_THREAD		0x00010000
+#endif
+#ifndef CLONE_PARENT_SETTID
+#define CLONE_PARENT_SETTID	0x00100000
+#endif
+#ifndef CLONE_CHILD_CLEARTID
+#define CLONE_CHILD_CLEARTID	0x00200000
+#endif
+
+/* All threads are one thread group: the kernel frees an exiting thread
+   itself, and a fatal signal kills the whole process.  It stores the
+   thread id in p_pid before clone returns, and clears p_alive and wakes
+   its futex when the thread is gone.  */
+#define THREAD_CLONE_FLAGS (CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND \
+			    | CLONE_THREAD | CLONE_PARENT_SETTID \
+			    | CLONE_CHILD_CLEARTID)
 
 /* Array of active threads. Entry 0 is reserved for the initial thread. */
 struct pthread_handle_struct __pthread_handles[PTHREAD_THREADS_MAX] =
@@ -61,6 +79,13 @@ volatile td_thr_events_t __pthread_threads_events;
 /* Pointer to thread descriptor with last event.  */
 volatile pthread_descr __pthread_last_event;
 
+/* Lock for the list of live threads, the handles and the stack cache.
+   A queue lock, see spinlock.h: every thread creation and join takes it. */
+struct _pthread_fastlock __pthread_threads_lock = __LOCK_INITIALIZER;
+
+/* Detached threads that have terminated but are not freed yet */
+int __pthread_detached_exits;
+
 /* Mapping from stack segment to thread descriptor. */
 /* Stack segment numbers are also indices into the __pthread_handles array. */
 /* Stack segment number 0 is reserved for the initial thread. */
@@ -75,169 +100,22 @@ static inline pthread_descr thread_segment(int seg)
 }
 #endif
 
-/* Flag set in signal handler to record child termination */
-
-static volatile int terminated_children;
-
-/* Flag set when the initial thread is blocked on pthread_exit waiting
-   for all other threads to terminate */
-
-static int main_thread_exiting;
-
 /* Counter used to generate unique thread identifier.
    Thread identifier is pthread_threads_counter + segment. */
 
 static pthread_t pthread_threads_counter;
 
-/* Forward declarations */
-
-static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
-                                 void * (*start_routine)(void *), void *arg,
-                                 sigset_t *mask, int father_pid,
-				 int report_events,
-				 td_thr_events_t *event_maskp);
-static void pthread_handle_free(pthread_t th_id);
-static void pthread_handle_exit(pthread_descr issuing_thread, int exitcode)
-     __attribute__ ((noreturn));
-static void pthread_reap_children(void);
-static void pthread_kill_all_threads(int sig, int main_thread_also);
-static void pthread_for_each_thread(void *arg, 
-    void (*fn)(void *, pthread_descr));
-
-/* The server thread managing requests for thread creation and termination */
-
-int
-__attribute__ ((noreturn))
-__pthread_manager(void *arg)
-{
-  int reqfd = (int) (long int) arg;
-  struct pollfd ufd;
-  sigset_t manager_mask;
-  int n;
-  struct pthread_request request;
-
-  /* If we have special thread_self processing, initialize it.  */
-#ifdef INIT_THREAD_SELF
-  INIT_THREAD_SELF(&__pthread_manager_thread, 1);
-#endif
-  /* Set the error variable.  */
-  __pthread_manager_thread.p_reentp = &__pthread_manager_thread.p_reent;
-  __pthread_manager_thread.p_h_errnop = &__pthread_manager_thread.p_h_errno;
-  /* Block all signals except __pthread_sig_cancel and SIGTRAP */
-  sigfillset(&manager_mask);
-  sigdelset(&manager_mask, __pthread_sig_cancel); /* for thread termination */
-  sigdelset(&manager_mask, SIGTRAP);            /* for debugging purposes */
-  if (__pthread_threads_debug && __pthread_sig_debug > 0)
-    sigdelset(&manager_mask, __pthread_sig_debug);
-  sigprocmask(SIG_SETMASK, &manager_mask, NULL);
-  /* Raise our priority to match that of main thread */
-  __pthread_manager_adjust_prio(__pthread_main_thread->p_priority);
-  /* Synchronize debugging of the thread manager */
-  n = TEMP_FAILURE_RETRY(__libc_read(reqfd, (char *)&request,
-				     sizeof(request)));
-  ASSERT(n == sizeof(request) && request.req_kind == REQ_DEBUG);
-  ufd.fd = reqfd;
-  ufd.events = POLLIN;
-  /* Enter server loop */
-  while(1) {
-    n = __poll(&ufd, 1, 2000);
-
-    /* Check for termination of the main thread */
-    if (getppid() == 1) {
-      pthread_kill_all_threads(SIGKILL, 0);
-      _exit(0);
-    }
-    /* Check for dead children */
-    if (terminated_children) {
-      terminated_children = 0;
-      pthread_reap_children();
-    }
-    /* Read and execute request */
-    if (n == 1 && (ufd.revents & POLLIN)) {
-      n = TEMP_FAILURE_RETRY(__libc_read(reqfd, (char *)&request,
-					 sizeof(request)));
-#ifdef DEBUG
-      if (n < 0) {
-	char d[64];
-	write(STDERR_FILENO, d, snprintf(d, sizeof(d), "*** read err %m\n"));
-      } else if (n != sizeof(request)) {
-	write(STDERR_FILENO, "*** short read in manager\n", 26);
-      }
-#endif
-
-      switch(request.req_kind) {
-      case REQ_CREATE:
-        request.req_thread->p_retcode =
-          pthread_handle_create((pthread_t *) &request.req_thread->p_retval,
-                                request.req_args.create.attr,
-                                request.req_args.create.fn,
-                                request.req_args.create.arg,
-                                &request.req_args.create.mask,
-                                request.req_thread->p_pid,
-				request.req_thread->p_report_events,
-				&request.req_thread->p_eventbuf.eventmask);
-        restart(request.req_thread);
-        break;
-      case REQ_FREE:
-	pthread_handle_free(request.req_args.free.thread_id);
-        break;
-      case REQ_PROCESS_EXIT:
-        pthread_handle_exit(request.req_thread,
-                            request.req_args.exit.code);
-	/* NOTREACHED */
-        break;
-      case REQ_MAIN_THREAD_EXIT:
-        main_thread_exiting = 1;
-	/* Reap children in case all other threads died and the signal handler
-	   went off before we set main_thread_exiting to 1, and therefore did
-	   not do REQ_KICK. */
-	pthread_reap_children();
-
-        if (__pthread_main_thread->p_nextlive == __pthread_main_thread) {
-          restart(__pthread_main_thread);
-	  /* The main thread will now call exit() which will trigger an
-	     __on_exit handler, which in turn will send REQ_PROCESS_EXIT
-	     to the thread manager. In case you are wondering how the
-	     manager terminates from its loop here. */
-	}
-        break;
-      case REQ_POST:
-        __new_sem_post(request.req_args.post);
-        break;
-      case REQ_DEBUG:
-	/* Make gdb aware of new thread and gdb will restart the
-	   new thread when it is ready to handle the new thread. */
-	if (__pthread_threads_debug && __pthread_sig_debug > 0)
-	  raise(__pthread_sig_debug);
-        break;
-      case REQ_KICK:
-	/* This is just a prod to get the manager to reap some
-	   threads right away, avoiding a potential delay at shutdown. */
-	break;
-      case REQ_FOR_EACH_THREAD:
-	pthread_for_each_thread(request.req_args.for_each.arg,
-	                        request.req_args.for_each.fn);
-	restart(request.req_thread);
-	break;
-      }
-    }
-  }
-}
+/* Lock statistics of the threads freed so far */
 
-int __pthread_manager_event(void *arg)
-{
-  /* If we have special thread_self processing, initialize it.  */
-#ifdef INIT_THREAD_SELF
-  INIT_THREAD_SELF(&__pthread_manager_thread, 1);
-#endif
+static struct pthread_lockstats pthread_lockstats_freed;
 
-  /* Get the lock the manager will free once all is correctly set up.  */
-  __pthread_lock (THREAD_GETMEM((&__pthread_manager_thread), p_lock), NULL);
-  /* Free it immediately.  */
-  __pthread_unlock (THREAD_GETMEM((&__pthread_manager_thread), p_lock));
+/* Stacks of freed threads, most recently freed first, linked through the
+   p_nextlive field of their descriptors, and their total size.  Reusing
+   them saves the mmap, the guard page mprotect and the page faults of a
+   fresh stack. */
 
-  return __pthread_manager(arg);
-}
+static pthread_descr pthread_stack_cache;
+static size_t pthread_stack_cache_size;
 
 /* Process creation */
 
@@ -246,7 +124,6 @@ __attribute__ ((noreturn))
 pthread_start_thread(void *arg)
 {
   pthread_descr self = (pthread_descr) arg;
-  struct pthread_request request;
   void * outcome;
 #if HP_TIMING_AVAIL
   hp_timing_t tmpclock;
@@ -259,35 +136,18 @@ pthread_start_thread(void *arg)
   HP_TIMING_NOW (tmpclock);
   THREAD_SETMEM (self, p_cpuclock_offset, tmpclock);
 #endif
-  /* Make sure our pid field is initialized, just in case we get there
-     before our father has initialized it. */
-  THREAD_SETMEM(self, p_pid, __getpid());
-  /* Initial signal mask is that of the creating thread. (Otherwise,
-     we'd just inherit the mask of the thread manager.) */
-  sigprocmask(SIG_SETMASK, &self->p_start_args.mask, NULL);
+  /* Our pid field was set by the kernel before our father returned from
+     clone, and the signal mask is that of our father. */
   /* Set the scheduling policy and priority for the new thread, if needed */
   if (THREAD_GETMEM(self, p_start_args.schedpolicy) >= 0)
     /* Explicit scheduling attributes were provided: apply them */
     __sched_setscheduler(THREAD_GETMEM(self, p_pid),
 			 THREAD_GETMEM(self, p_start_args.schedpolicy),
                          &self->p_start_args.schedparam);
-  else if (__pthread_manager_thread.p_priority > 0)
-    /* Default scheduling required, but thread manager runs in realtime
-       scheduling: switch new thread to SCHED_OTHER policy */
-    {
-      struct sched_param default_params;
-      default_params.sched_priority = 0;
-      __sched_setscheduler(THREAD_GETMEM(self, p_pid),
-                           SCHED_OTHER, &default_params);
-    }
-  /* Make gdb aware of new thread */
-  if (__pthread_threads_debug && __pthread_sig_debug > 0) {
-    request.req_thread = self;
-    request.req_kind = REQ_DEBUG;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-    suspend(self);
-  }
+  /* The process may be exiting already, without us having got the cancel
+     signal: see __pthread_handle_exit. */
+  if (__builtin_expect (__pthread_exit_requested, 0))
+    _exit(__pthread_exit_code);
   /* Run the thread code */
   outcome = self->p_start_args.start_routine(THREAD_GETMEM(self,
 							   p_start_args.arg));
@@ -304,10 +164,7 @@ pthread_start_thread_event(void *arg)
 #ifdef INIT_THREAD_SELF
   INIT_THREAD_SELF(self, self->p_nr);
 #endif
-  /* Make sure our pid field is initialized, just in case we get there
-     before our father has initialized it. */
-  THREAD_SETMEM(self, p_pid, __getpid());
-  /* Get the lock the manager will free once all is correctly set up.  */
+  /* Get the lock our father will free once all is correctly set up.  */
   __pthread_lock (THREAD_GETMEM(self, p_lock), NULL);
   /* Free it immediately.  */
   __pthread_unlock (THREAD_GETMEM(self, p_lock));
@@ -316,9 +173,88 @@ pthread_start_thread_event(void *arg)
   pthread_start_thread (arg);
 }
 
+/* Find the mapping holding the stack, guard area and descriptor of TH,
+   which must be one we allocated.  Returns its size.  */
+
+static size_t pthread_stack_mapping(pthread_descr th, char **addr)
+{
+  size_t guardsize = th->p_guardsize;
+  char *guardaddr = th->p_guardaddr;
+#ifdef _STACK_GROWS_UP
+  size_t stacksize = guardaddr - (char *)th;
+  guardaddr = (char *)th;
+#else
+  /* Guardaddr is always set, even if guardsize is 0.  This allows
+     us to compute everything else.  */
+  size_t stacksize = (char *)(th+1) - guardaddr - guardsize;
+#ifdef NEED_SEPARATE_REGISTER_STACK
+  /* Take account of the register stack, which is below guardaddr.  */
+  guardaddr -= stacksize;
+  stacksize *= 2;
+#endif
+#endif
+  *addr = guardaddr;
+  return stacksize + guardsize;
+}
+
+/* Keep the stack of TH for a new thread, or unmap it if the cache is
+   full.  Called with __pthread_threads_lock held.  */
+
+static void pthread_stack_cache_put(pthread_descr th)
+{
+  char *addr;
+  size_t size = pthread_stack_mapping(th, &addr);
+
+  if (pthread_stack_cache_size + size <= STACK_CACHE_SIZE)
+    {
+      th->p_nextlive = pthread_stack_cache;
+      pthread_stack_cache = th;
+      pthread_stack_cache_size += size;
+    }
+  else
+    munmap(addr, size);
+}
+
+/* Take a cached stack of STACKSIZE bytes with a guard area of GUARDSIZE
+   bytes out of the cache.  Without floating stacks it must be the one of
+   segment SSEG.  Called with __pthread_threads_lock held.  */
+
+static pthread_descr pthread_stack_cache_get(int sseg, size_t stacksize,
+					     size_t guardsize)
+{
+  pthread_descr th, *prev;
+  char *addr;
+  size_t size;
+
+  for (prev = &pthread_stack_cache; (th = *prev) != NULL;
+       prev = &th->p_nextlive)
+    {
+#if !FLOATING_STACKS
+      /* The stack of a segment is always at the same address */
+      if (th->p_nr != sseg)
+	continue;
+#endif
+      size = pthread_stack_mapping(th, &addr);
+      if (th->p_guardsize == guardsize && size == stacksize + guardsize)
+	{
+	  *prev = th->p_nextlive;
+	  pthread_stack_cache_size -= size;
+	  return th;
+	}
+#if !FLOATING_STACKS
+      /* It has another size, and is in the way of the new stack */
+      *prev = th->p_nextlive;
+      pthread_stack_cache_size -= size;
+      munmap(addr, size);
+      break;
+#endif
+    }
+  return NULL;
+}
+
 static int pthread_allocate_stack(const pthread_attr_t *attr,
                                   pthread_descr default_new_thread,
-                                  int pagesize,
+                                  int sseg, int pagesize,
                                   pthread_descr * out_new_thread,
                                   char ** out_new_thread_bottom,
                                   char ** out_guardaddr,
@@ -367,24 +303,46 @@ static int pthread_allocate_stack(const pthread_attr_t *attr,
       /* Try to make stacksize/2 a multiple of pagesize */
 #else
       size_t granularity = pagesize;
+#endif
+#if FLOATING_STACKS
+      size_t maxsize = __pthread_max_stacksize;
+#else
+      size_t maxsize = STACK_SIZE;
 #endif
       void *map_addr;
 
-      /* Allocate space for stack and thread descriptor at default address */
-#if FLOATING_STACKS
       if (attr != NULL)
 	{
 	  guardsize = page_roundup (attr->__guardsize, granularity);
-	  stacksize = __pthread_max_stacksize - guardsize;
+	  stacksize = maxsize - guardsize;
 	  stacksize = MIN (stacksize,
 			   page_roundup (attr->__stacksize, granularity));
 	}
       else
 	{
 	  guardsize = granularity;
-	  stacksize = __pthread_max_stacksize - guardsize;
+	  stacksize = maxsize - guardsize;
+	}
+
+      /* Reuse the stack of a freed thread if there is one of this size */
+      new_thread = pthread_stack_cache_get (sseg, stacksize, guardsize);
+      if (new_thread != NULL)
+	{
+	  guardaddr = new_thread->p_guardaddr;
+#ifdef NEED_SEPARATE_REGISTER_STACK
+	  new_thread_bottom = (char *) (new_thread + 1) - stacksize - guardsize;
+#elif _STACK_GROWS_UP
+	  new_thread_bottom = (char *) (new_thread + 1);
+#else
+	  new_thread_bottom = (char *) (new_thread + 1) - stacksize;
+#endif
+	  /* Clear the thread data structure, as it is in a new mapping.  */
+	  memset (new_thread, '\0', sizeof (*new_thread));
+	  goto done;
 	}
 
+      /* Allocate space for stack and thread descriptor at default address */
+#if FLOATING_STACKS
       map_addr = mmap(NULL, stacksize + guardsize,
 		      PROT_READ | PROT_WRITE | PROT_EXEC,
 		      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
@@ -420,19 +378,6 @@ static int pthread_allocate_stack(const pthread_attr_t *attr,
 #else /* !FLOATING_STACKS */
       void *res_addr;
 
-      if (attr != NULL)
-	{
-	  guardsize = page_roundup (attr->__guardsize, granularity);
-	  stacksize = STACK_SIZE - guardsize;
-	  stacksize = MIN (stacksize,
-			   page_roundup (attr->__stacksize, granularity));
-	}
-      else
-	{
-	  guardsize = granularity;
-	  stacksize = STACK_SIZE - granularity;
-	}
-
 # ifdef NEED_SEPARATE_REGISTER_STACK
       new_thread = default_new_thread;
       new_thread_bottom = (char *) (new_thread + 1) - stacksize - guardsize;
@@ -513,6 +458,7 @@ static int pthread_allocate_stack(const pthread_attr_t *attr,
 # endif  /* !NEED_SEPARATE_REGISTER_STACK */
 #endif   /* !FLOATING_STACKS */
     }
+ done:
   *out_new_thread = new_thread;
   *out_new_thread_bottom = new_thread_bottom;
   *out_guardaddr = guardaddr;
@@ -520,12 +466,135 @@ static int pthread_allocate_stack(const pthread_attr_t *attr,
   return 0;
 }
 
-static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
-				 void * (*start_routine)(void *), void *arg,
-				 sigset_t * mask, int father_pid,
-				 int report_events,
-				 td_thr_events_t *event_maskp)
+/* Start the kernel task of NEW_THREAD, running FN.  */
+
+static int pthread_clone(int (*fn)(void *), pthread_descr new_thread,
+			 char *new_thread_bottom)
+{
+#ifdef NEED_SEPARATE_REGISTER_STACK
+  /* Perhaps this version should be used on all platforms. But
+     this requires that __clone2 be uniformly supported
+     everywhere.
+
+     And there is some argument for changing the __clone2
+     interface to pass sp and bsp instead, making it more IA64
+     specific, but allowing stacks to grow outward from each
+     other, to get less paging and fewer mmaps.  */
+  return __clone2(fn, (void **)new_thread_bottom,
+		  (char *)new_thread - new_thread_bottom,
+		  THREAD_CLONE_FLAGS, new_thread,
+		  &new_thread->p_pid, NULL, &new_thread->p_alive);
+#elif _STACK_GROWS_UP
+  return __clone(fn, (void **) new_thread_bottom, THREAD_CLONE_FLAGS,
+		 new_thread, &new_thread->p_pid, NULL, &new_thread->p_alive);
+#else
+  return __clone(fn, (void **) new_thread, THREAD_CLONE_FLAGS,
+		 new_thread, &new_thread->p_pid, NULL, &new_thread->p_alive);
+#endif
+}
+
+/* Add the lock statistics STATS to SUM */
+
+static void pthread_lockstats_add(struct pthread_lockstats *sum,
+				  const struct pthread_lockstats *stats)
+{
+  sum->ls_locks += stats->ls_locks;
+  sum->ls_contended += stats->ls_contended;
+  sum->ls_spun += stats->ls_spun;
+  sum->ls_wait_time += stats->ls_wait_time;
+  sum->ls_released += stats->ls_released;
+  sum->ls_hold_time += stats->ls_hold_time;
+}
+
+/* Free the resources of TH, whose kernel task is gone.  Called with
+   __pthread_threads_lock held.  */
+
+static void pthread_free(pthread_descr th)
+{
+  pthread_handle handle;
+  pthread_readlock_info *iter, *next;
+
+  /* Remove thread from list of live threads */
+  th->p_nextlive->p_prevlive = th->p_prevlive;
+  th->p_prevlive->p_nextlive = th->p_nextlive;
+  /* Make the handle invalid */
+  handle =  thread_handle(th->p_tid);
+  __pthread_lock(&handle->h_lock, NULL);
+  th->p_exited = 1;
+  handle->h_descr = NULL;
+  handle->h_bottom = (char *)(-1L);
+  __pthread_unlock(&handle->h_lock);
+  /* If we have to signal this event do it now.  */
+  if (th->p_report_events)
+    {
+      /* See whether TD_REAP is in any of the mask.  */
+      int idx = __td_eventword (TD_REAP);
+      uint32_t mask = __td_eventmask (TD_REAP);
+
+      if ((mask & (__pthread_threads_events.event_bits[idx]
+		   | th->p_eventbuf.eventmask.event_bits[idx])) != 0)
+	{
+	  /* Yep, we have to signal the reapage.  */
+	  th->p_eventbuf.eventnum = TD_REAP;
+	  th->p_eventbuf.eventdata = th;
+	  __pthread_last_event = th;
+
+	  /* Now call the function to signal the event.  */
+	  __linuxthreads_reap_event();
+	}
+    }
+#ifdef FREE_THREAD
+  FREE_THREAD(th, th->p_nr);
+#endif
+  /* One fewer threads in __pthread_handles */
+  __pthread_handles_num--;
+  /* Keep its lock statistics */
+  pthread_lockstats_add(&pthread_lockstats_freed, &th->p_lockstats);
+
+  /* Destroy read lock list, and list of free read lock structures.
+     If the former is not empty, it means the thread exited while
+     holding read locks! */
+
+  for (iter = th->p_readlock_list; iter != NULL; iter = next)
+    {
+      next = iter->pr_next;
+      free(iter);
+    }
+
+  for (iter = th->p_readlock_free; iter != NULL; iter = next)
+    {
+      next = iter->pr_next;
+      free(iter);
+    }
+
+  /* Keep the stack for a new thread, unless the user provided it */
+  if (!th->p_userstack)
+    pthread_stack_cache_put(th);
+}
+
+/* Free the detached threads that have terminated and whose kernel task
+   is gone.  Called with __pthread_threads_lock held.  */
+
+static void pthread_reclaim_detached(void)
+{
+  pthread_descr th, next;
+
+  for (th = __pthread_main_thread->p_nextlive;
+       th != __pthread_main_thread;
+       th = next) {
+    next = th->p_nextlive;
+    if (th->p_detached && th->p_terminated && th->p_alive == 0) {
+      __int_exchange_and_add(&__pthread_detached_exits, -1);
+      pthread_free(th);
+    }
+  }
+}
+
+int __pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
+			    void * (*start_routine)(void *), void *arg)
 {
+  pthread_descr self = thread_self();
+  struct _pthread_queue_node node;
   size_t sseg;
   int pid;
   pthread_descr new_thread;
@@ -534,6 +603,7 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
   char *guardaddr = NULL;
   size_t guardsize = 0;
   int pagesize = __getpagesize();
+  int err;
 
   /* First check whether we have to change the policy and if yes, whether
      we can  do this.  Normally this should be done by examining the
@@ -541,15 +611,23 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
      but this is hard to implement.  FIXME  */
   if (attr != NULL && attr->__schedpolicy != SCHED_OTHER && geteuid () != 0)
     return EPERM;
+  __pthread_queue_lock(&__pthread_threads_lock, &node);
+  /* Free the detached threads that are gone: we may reuse their slots
+     and stacks */
+  if (__pthread_detached_exits > 0)
+    pthread_reclaim_detached();
   /* Find a free segment for the thread, and allocate a stack if needed */
   for (sseg = 2; ; sseg++)
     {
       if (sseg >= PTHREAD_THREADS_MAX)
-	return EAGAIN;
+	{
+	  __pthread_queue_unlock(&__pthread_threads_lock, &node);
+	  return EAGAIN;
+	}
       if (__pthread_handles[sseg].h_descr != NULL)
 	continue;
       if (pthread_allocate_stack(attr, thread_segment(sseg),
-				 pagesize,
+				 sseg, pagesize,
                                  &new_thread, &new_thread_bottom,
                                  &guardaddr, &guardsize) == 0)
         break;
@@ -573,10 +651,7 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
   new_thread->p_header.data.self = new_thread;
   new_thread->p_nr = sseg;
   new_thread->p_inheritsched = attr ? attr->__inheritsched : 0;
-  /* Initialize the thread handle */
-  __pthread_init_lock(&__pthread_handles[sseg].h_lock);
-  __pthread_handles[sseg].h_descr = new_thread;
-  __pthread_handles[sseg].h_bottom = new_thread_bottom;
+  new_thread->p_alive = 1;
   /* Determine scheduling parameters for the thread */
   new_thread->p_start_args.schedpolicy = -1;
   if (attr != NULL) {
@@ -590,27 +665,42 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
 	      sizeof (struct sched_param));
       break;
     case PTHREAD_INHERIT_SCHED:
-      new_thread->p_start_args.schedpolicy = __sched_getscheduler(father_pid);
-      __sched_getparam(father_pid, &new_thread->p_start_args.schedparam);
+      new_thread->p_start_args.schedpolicy =
+	__sched_getscheduler(THREAD_GETMEM(self, p_pid));
+      __sched_getparam(THREAD_GETMEM(self, p_pid),
+		       &new_thread->p_start_args.schedparam);
       break;
     }
     new_thread->p_priority =
       new_thread->p_start_args.schedparam.__sched_priority;
+  } else if (THREAD_GETMEM(self, p_priority) > 0) {
+    /* Default scheduling required, but we run in realtime scheduling,
+       which the new thread inherits: switch it to SCHED_OTHER policy */
+    new_thread->p_start_args.schedpolicy = SCHED_OTHER;
+    new_thread->p_start_args.schedparam.__sched_priority = 0;
   }
   /* Finish setting up arguments to pthread_start_thread */
   new_thread->p_start_args.start_routine = start_routine;
   new_thread->p_start_args.arg = arg;
-  new_thread->p_start_args.mask = *mask;
+  /* Initialize the thread handle */
+  __pthread_init_lock(&__pthread_handles[sseg].h_lock);
+  __pthread_handles[sseg].h_descr = new_thread;
+  __pthread_handles[sseg].h_bottom = new_thread_bottom;
+  /* Insert new thread in doubly linked list of live threads.  Its p_pid
+     stays 0 until clone returns, which those walking the list check. */
+  new_thread->p_prevlive = __pthread_main_thread;
+  new_thread->p_nextlive = __pthread_main_thread->p_nextlive;
+  __pthread_main_thread->p_nextlive->p_prevlive = new_thread;
+  __pthread_main_thread->p_nextlive = new_thread;
+  __pthread_queue_unlock(&__pthread_threads_lock, &node);
   /* Make the new thread ID available already now.  If any of the later
      functions fail we return an error value and the caller must not use
      the stored thread ID.  */
   *thread = new_thread_id;
-  /* Raise priority of thread manager if needed */
-  __pthread_manager_adjust_prio(new_thread->p_priority);
   /* Do the cloning.  We have to use two different functions depending
      on whether we are debugging or not.  */
   pid = 0;	/* Note that the thread never can have PID zero.  */
-  if (report_events)
+  if (THREAD_GETMEM(self, p_report_events))
     {
       /* See whether the TD_CREATE event bit is set in any of the
          masks.  */
@@ -618,50 +708,27 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
       uint32_t mask = __td_eventmask (TD_CREATE);
 
       if ((mask & (__pthread_threads_events.event_bits[idx]
-		   | event_maskp->event_bits[idx])) != 0)
+		   | THREAD_GETMEM_NC(self,
+				      p_eventbuf.eventmask.event_bits[idx])))
+	  != 0)
 	{
 	  /* Lock the mutex the child will use now so that it will stop.  */
 	  __pthread_lock(new_thread->p_lock, NULL);
 
 	  /* We have to report this event.  */
-#ifdef NEED_SEPARATE_REGISTER_STACK
-	  /* Perhaps this version should be used on all platforms. But
-	   this requires that __clone2 be uniformly supported
-	   everywhere.
-
-	   And there is some argument for changing the __clone2
-	   interface to pass sp and bsp instead, making it more IA64
-	   specific, but allowing stacks to grow outward from each
-	   other, to get less paging and fewer mmaps.  */
-	  pid = __clone2(pthread_start_thread_event,
-  		 (void **)new_thread_bottom,
-			 (char *)new_thread - new_thread_bottom,
-			 CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-			 __pthread_sig_cancel, new_thread);
-#elif _STACK_GROWS_UP
-	  pid = __clone(pthread_start_thread_event, (void **) new_thread_bottom,
-			CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-			__pthread_sig_cancel, new_thread);
-#else
-	  pid = __clone(pthread_start_thread_event, (void **) new_thread,
-			CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-			__pthread_sig_cancel, new_thread);
-#endif
+	  pid = pthread_clone(pthread_start_thread_event, new_thread,
+			      new_thread_bottom);
 	  if (pid != -1)
 	    {
 	      /* Now fill in the information about the new thread in
 		 the newly created thread's data structure.  We cannot let
 		 the new thread do this since we don't know whether it was
-		 already scheduled when we send the event.  */
+		 already scheduled when we send the event.  The kernel has
+		 set its p_pid, which the debug library needs.  */
 	      new_thread->p_eventbuf.eventdata = new_thread;
 	      new_thread->p_eventbuf.eventnum = TD_CREATE;
 	      __pthread_last_event = new_thread;
 
-	      /* We have to set the PID here since the callback function
-		 in the debug library will need it and we cannot guarantee
-		 the child got scheduled before the debugger.  */
-	      new_thread->p_pid = pid;
-
 	      /* Now call the function which signals the event.  */
 	      __linuxthreads_create_event ();
 
@@ -671,251 +738,118 @@ static int pthread_handle_create(pthread_t *thread, const pthread_attr_t *attr,
 	}
     }
   if (pid == 0)
-    {
-#ifdef NEED_SEPARATE_REGISTER_STACK
-      pid = __clone2(pthread_start_thread,
-		     (void **)new_thread_bottom,
-                     (char *)new_thread - new_thread_bottom,
-		     CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-		     __pthread_sig_cancel, new_thread);
-#elif _STACK_GROWS_UP
-      pid = __clone(pthread_start_thread, (void **) new_thread_bottom,
-		    CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-		    __pthread_sig_cancel, new_thread);
-#else
-      pid = __clone(pthread_start_thread, (void **) new_thread,
-		    CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND |
-		    __pthread_sig_cancel, new_thread);
-#endif /* !NEED_SEPARATE_REGISTER_STACK */
-    }
+    pid = pthread_clone(pthread_start_thread, new_thread, new_thread_bottom);
   /* Check if cloning succeeded */
   if (pid == -1) {
-    /* Free the stack if we allocated it */
-    if (attr == NULL || !attr->__stackaddr_set)
-      {
-#ifdef NEED_SEPARATE_REGISTER_STACK
-	size_t stacksize = ((char *)(new_thread->p_guardaddr)
-			    - new_thread_bottom);
-	munmap((caddr_t)new_thread_bottom,
-	       2 * stacksize + new_thread->p_guardsize);
-#elif _STACK_GROWS_UP
-	size_t stacksize = guardaddr - (char *)new_thread;
-	munmap(new_thread, stacksize + guardsize);
-#else
-	size_t stacksize = (char *)(new_thread+1) - new_thread_bottom;
-	munmap(new_thread_bottom - guardsize, guardsize + stacksize);
-#endif
-      }
+    err = errno;
+    __pthread_queue_lock(&__pthread_threads_lock, &node);
+    new_thread->p_nextlive->p_prevlive = new_thread->p_prevlive;
+    new_thread->p_prevlive->p_nextlive = new_thread->p_nextlive;
     __pthread_handles[sseg].h_descr = NULL;
     __pthread_handles[sseg].h_bottom = NULL;
     __pthread_handles_num--;
-    return errno;
+    /* Keep the stack if we allocated it */
+    if (!new_thread->p_userstack)
+      pthread_stack_cache_put(new_thread);
+    __pthread_queue_unlock(&__pthread_threads_lock, &node);
+    return err;
   }
-  /* Insert new thread in doubly linked list of active threads */
-  new_thread->p_prevlive = __pthread_main_thread;
-  new_thread->p_nextlive = __pthread_main_thread->p_nextlive;
-  __pthread_main_thread->p_nextlive->p_prevlive = new_thread;
-  __pthread_main_thread->p_nextlive = new_thread;
-  /* Set pid field of the new thread, in case we get there before the
-     child starts. */
-  new_thread->p_pid = pid;
+  /* Make gdb aware of new thread */
+  if (__pthread_threads_debug && __pthread_sig_debug > 0)
+    raise(__pthread_sig_debug);
   return 0;
 }
 
+/* Free the resources of TH, which has been joined, once its kernel task
+   is gone. */
 
-/* Try to free the resources of a thread when requested by pthread_join
-   or pthread_detach on a terminated thread. */
-
-static void pthread_free(pthread_descr th)
+void __pthread_handle_free(pthread_descr th)
 {
-  pthread_handle handle;
-  pthread_readlock_info *iter, *next;
-
-  ASSERT(th->p_exited);
-  /* Make the handle invalid */
-  handle =  thread_handle(th->p_tid);
-  __pthread_lock(&handle->h_lock, NULL);
-  handle->h_descr = NULL;
-  handle->h_bottom = (char *)(-1L);
-  __pthread_unlock(&handle->h_lock);
-#ifdef FREE_THREAD
-  FREE_THREAD(th, th->p_nr);
-#endif
-  /* One fewer threads in __pthread_handles */
-  __pthread_handles_num--;
+  struct _pthread_queue_node node;
 
-  /* Destroy read lock list, and list of free read lock structures.
-     If the former is not empty, it means the thread exited while
-     holding read locks! */
-
-  for (iter = th->p_readlock_list; iter != NULL; iter = next)
-    {
-      next = iter->pr_next;
-      free(iter);
-    }
-
-  for (iter = th->p_readlock_free; iter != NULL; iter = next)
-    {
-      next = iter->pr_next;
-      free(iter);
-    }
-
-  /* If initial thread, nothing to free */
-  if (!th->p_userstack)
-    {
-      size_t guardsize = th->p_guardsize;
-      /* Free the stack and thread descriptor area */
-      char *guardaddr = th->p_guardaddr;
-#ifdef _STACK_GROWS_UP
-      size_t stacksize = guardaddr - (char *)th;
-      guardaddr = (char *)th;
-#else
-      /* Guardaddr is always set, even if guardsize is 0.  This allows
-	 us to compute everything else.  */
-      size_t stacksize = (char *)(th+1) - guardaddr - guardsize;
-#ifdef NEED_SEPARATE_REGISTER_STACK
-      /* Take account of the register stack, which is below guardaddr.  */
-      guardaddr -= stacksize;
-      stacksize *= 2;
-#endif
-#endif
-      /* Unmap the stack.  */
-      munmap(guardaddr, stacksize + guardsize);
-    }
+  __pthread_queue_lock(&__pthread_threads_lock, &node);
+  pthread_free(th);
+  __pthread_queue_unlock(&__pthread_threads_lock, &node);
 }
 
-/* Handle threads that have exited */
+/* Call FN on each thread, with the list of threads locked */
 
-static void pthread_exited(pid_t pid)
+void __pthread_for_each_thread(void *arg,
+    void (*fn)(void *, pthread_descr))
 {
+  struct _pthread_queue_node node;
   pthread_descr th;
-  int detached;
-  /* Find thread with that pid */
+
+  __pthread_queue_lock(&__pthread_threads_lock, &node);
   for (th = __pthread_main_thread->p_nextlive;
        th != __pthread_main_thread;
        th = th->p_nextlive) {
-    if (th->p_pid == pid) {
-      /* Remove thread from list of active threads */
-      th->p_nextlive->p_prevlive = th->p_prevlive;
-      th->p_prevlive->p_nextlive = th->p_nextlive;
-      /* Mark thread as exited, and if detached, free its resources */
-      __pthread_lock(th->p_lock, NULL);
-      th->p_exited = 1;
-      /* If we have to signal this event do it now.  */
-      if (th->p_report_events)
-	{
-	  /* See whether TD_REAP is in any of the mask.  */
-	  int idx = __td_eventword (TD_REAP);
-	  uint32_t mask = __td_eventmask (TD_REAP);
-
-	  if ((mask & (__pthread_threads_events.event_bits[idx]
-		       | th->p_eventbuf.eventmask.event_bits[idx])) != 0)
-	    {
-	      /* Yep, we have to signal the reapage.  */
-	      th->p_eventbuf.eventnum = TD_REAP;
-	      th->p_eventbuf.eventdata = th;
-	      __pthread_last_event = th;
-
-	      /* Now call the function to signal the event.  */
-	      __linuxthreads_reap_event();
-	    }
-	}
-      detached = th->p_detached;
-      __pthread_unlock(th->p_lock);
-      if (detached)
-	pthread_free(th);
-      break;
-    }
-  }
-  /* If all threads have exited and the main thread is pending on a
-     pthread_exit, wake up the main thread and terminate ourselves. */
-  if (main_thread_exiting &&
-      __pthread_main_thread->p_nextlive == __pthread_main_thread) {
-    restart(__pthread_main_thread);
-    /* Same logic as REQ_MAIN_THREAD_EXIT. */
+    fn(arg, th);
   }
-}
 
-static void pthread_reap_children(void)
-{
-  pid_t pid;
-  int status;
-
-  while ((pid = __libc___waitpid(-1, &status, WNOHANG | __WCLONE)) > 0) {
-    pthread_exited(pid);
-    if (WIFSIGNALED(status)) {
-      /* If a thread died due to a signal, send the same signal to
-         all other threads, including the main thread. */
-      pthread_kill_all_threads(WTERMSIG(status), 1);
-      _exit(0);
-    }
-  }
+  fn(arg, __pthread_main_thread);
+  __pthread_queue_unlock(&__pthread_threads_lock, &node);
 }
 
-/* Try to free the resources of a thread when requested by pthread_join
-   or pthread_detach on a terminated thread. */
+/* Add up the lock statistics of all threads, the freed ones included, in
+   SUM, and clear them if RESET */
 
-static void pthread_handle_free(pthread_t th_id)
+void __pthread_lockstats_collect(struct pthread_lockstats *sum, int reset)
 {
-  pthread_handle handle = thread_handle(th_id);
+  struct _pthread_queue_node node;
   pthread_descr th;
 
-  __pthread_lock(&handle->h_lock, NULL);
-  if (nonexisting_handle(handle, th_id)) {
-    /* pthread_reap_children has deallocated the thread already,
-       nothing needs to be done */
-    __pthread_unlock(&handle->h_lock);
-    return;
-  }
-  th = handle->h_descr;
-  if (th->p_exited) {
-    __pthread_unlock(&handle->h_lock);
-    pthread_free(th);
-  } else {
-    /* The Unix process of the thread is still running.
-       Mark the thread as detached so that the thread manager will
-       deallocate its resources when the Unix process exits. */
-    th->p_detached = 1;
-    __pthread_unlock(&handle->h_lock);
-  }
+  __pthread_queue_lock(&__pthread_threads_lock, &node);
+  *sum = pthread_lockstats_freed;
+  if (reset)
+    memset(&pthread_lockstats_freed, 0, sizeof(pthread_lockstats_freed));
+  th = __pthread_main_thread;
+  do {
+    pthread_lockstats_add(sum, &th->p_lockstats);
+    if (reset)
+      memset(&th->p_lockstats, 0, sizeof(th->p_lockstats));
+    th = th->p_nextlive;
+  } while (th != __pthread_main_thread);
+  __pthread_queue_unlock(&__pthread_threads_lock, &node);
 }
 
-/* Send a signal to all running threads */
-
-static void pthread_kill_all_threads(int sig, int main_thread_also)
-{
-  pthread_descr th;
-  for (th = __pthread_main_thread->p_nextlive;
-       th != __pthread_main_thread;
-       th = th->p_nextlive) {
-    kill(th->p_pid, sig);
-  }
-  if (main_thread_also) {
-    kill(__pthread_main_thread->p_pid, sig);
-  }
-}
+/* Wait until all threads but SELF, the main thread calling pthread_exit,
+   are gone. */
 
-static void pthread_for_each_thread(void *arg, 
-    void (*fn)(void *, pthread_descr))
+void __pthread_wait_for_threads(pthread_descr self)
 {
+  struct _pthread_queue_node node;
   pthread_descr th;
-
-  for (th = __pthread_main_thread->p_nextlive;
-       th != __pthread_main_thread;
-       th = th->p_nextlive) {
-    fn(arg, th);
+  int alive;
+
+  for (;;) {
+    alive = 0;
+    __pthread_queue_lock(&__pthread_threads_lock, &node);
+    for (th = self->p_nextlive; th != self; th = th->p_nextlive) {
+      alive = th->p_alive;
+      if (th->p_pid != 0 && alive != 0)
+	break;
+    }
+    __pthread_queue_unlock(&__pthread_threads_lock, &node);
+    if (th == self)
+      return;
+    /* TH is not freed before it is gone, so its descriptor stays mapped */
+    futex_wait(&th->p_alive, alive, NULL);
   }
-
-  fn(arg, __pthread_main_thread);
 }
 
 /* Process-wide exit() */
 
-static void pthread_handle_exit(pthread_descr issuing_thread, int exitcode)
+void __pthread_handle_exit(pthread_descr issuing_thread, int exitcode)
 {
+  struct _pthread_queue_node node;
   pthread_descr th;
-  __pthread_exit_requested = 1;
+  int alive;
+
+  __pthread_queue_lock(&__pthread_threads_lock, &node);
   __pthread_exit_code = exitcode;
+  __pthread_exit_thread = issuing_thread;
+  __pthread_exit_requested = 1;
   /* A forced asynchronous cancellation follows.  Make sure we won't
      get stuck later in the main thread with a system lock being held
      by one of the cancelled threads.  Ideally one would use the same
@@ -925,58 +859,38 @@ static void pthread_handle_exit(pthread_descr issuing_thread, int exitcode)
   /* Send the CANCEL signal to all running threads, including the main
      thread, but excluding the thread from which the exit request originated
      (that thread must complete the exit, e.g. calling atexit functions
-     and flushing stdio buffers). */
+     and flushing stdio buffers).  A thread whose clone has not returned
+     yet has no p_pid; it sees __pthread_exit_requested when it starts. */
   for (th = issuing_thread->p_nextlive;
        th != issuing_thread;
        th = th->p_nextlive) {
-    kill(th->p_pid, __pthread_sig_cancel);
+    if (th->p_pid != 0)
+      __tkill(th->p_pid, __pthread_sig_cancel);
   }
-  /* Now, wait for all these threads, so that they don't become zombies
-     and their times are properly added to the thread manager's times. */
+  /* Now, wait for all these threads to be gone, so that none of them
+     runs on while the exit completes.  The main thread, if it is one
+     of them, stays until the process is. */
   for (th = issuing_thread->p_nextlive;
        th != issuing_thread;
        th = th->p_nextlive) {
-    __waitpid(th->p_pid, NULL, __WCLONE);
+    if (th != __pthread_main_thread && th->p_pid != 0)
+      while ((alive = th->p_alive) != 0)
+	futex_wait(&th->p_alive, alive, NULL);
   }
   __fresetlockfiles();
-  restart(issuing_thread);
-  _exit(0);
-}
-
-/* Handler for __pthread_sig_cancel in thread manager thread */
-
-void __pthread_manager_sighandler(int sig)
-{
-  int kick_manager = terminated_children == 0 && main_thread_exiting;
-  terminated_children = 1;
-
-  /* If the main thread is terminating, kick the thread manager loop
-     each time some threads terminate. This eliminates a two second
-     shutdown delay caused by the thread manager sleeping in the
-     call to __poll(). Instead, the thread manager is kicked into
-     action, reaps the outstanding threads and resumes the main thread
-     so that it can complete the shutdown. */
-
-  if (kick_manager) {
-    struct pthread_request request;
-    request.req_thread = 0;
-    request.req_kind = REQ_KICK;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-  }
+  /* Some of them may have died lined up for the lock, with their nodes
+     still in the queue.  Rather than hand it over to them, start it
+     afresh: the other threads will not take it again. */
+  __pthread_init_lock(&__pthread_threads_lock);
 }
 
-/* Adjust priority of thread manager so that it always run at a priority
-   higher than all threads */
+/* Forget the other threads after fork().  Their stacks stay mapped in
+   the child. */
 
-void __pthread_manager_adjust_prio(int thread_prio)
+void __pthread_reset_threads(void)
 {
-  struct sched_param param;
-
-  if (thread_prio <= __pthread_manager_thread.p_priority) return;
-  param.sched_priority =
-    thread_prio < __sched_get_priority_max(SCHED_FIFO)
-    ? thread_prio + 1 : thread_prio;
-  __sched_setscheduler(__pthread_manager_thread.p_pid, SCHED_FIFO, &param);
-  __pthread_manager_thread.p_priority = thread_prio;
+  __pthread_init_lock(&__pthread_threads_lock);
+  pthread_stack_cache = NULL;
+  pthread_stack_cache_size = 0;
+  __pthread_detached_exits = 0;
 }
@@ -1,106 +1,192 @@
 /* Copyright 2002, Red Hat Inc. */
 
 #include <mqueue.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <errno.h>
-#include <sys/ipc.h>
-#include <sys/sem.h>
+#include <stdlib.h>
 #include <string.h>
-
-#include "internals.h"
-#include <sys/lock.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <asm/types.h>
+#include <linux/netlink.h>
 
 #include "mqlocal.h"
 
-static void *mq_notify_process (void *);
+/* SIGEV_THREAD notification runs the function in a thread of its own,
+   created with the attributes given, which sleeps until the notification
+   comes.  Everything else is up to the mq_notify of libc.  */
+
+extern int __libc_mq_notify (mqd_t msgid, const struct sigevent *notification);
+
+struct mq_notify_arg {
+  void (*function) (union sigval);
+  union sigval value;
+  struct mq_shm *shm;	/* own mapping of the queue in shared memory, or */
+  size_t size;
+  int sock;		/* netlink socket the kernel's queue writes to */
+  int seq;		/* notify_seq before registering */
+};
 
 void
 __cleanup_mq_notify (struct libc_mq *info)
 {
-  struct sembuf sb4 = {4, 1, 0};
-  /* kill notification thread and allow other processes to set a notification */
+  /* kill notification thread, if it has not run yet */
   pthread_cancel ((pthread_t)info->th);
-  semop (info->semid, &sb4, 1);
+  __mq_futex (&info->shm->notify_seq, MQ_FUTEX_WAKE, INT_MAX, NULL);
+  info->cleanup_notify = NULL;
 }
-  
+
+static void
+mq_notify_free (void *arg)
+{
+  struct mq_notify_arg *na = (struct mq_notify_arg *)arg;
+
+  if (na->shm != NULL)
+    munmap (na->shm, na->size);
+  else if (na->sock >= 0)
+    close (na->sock);
+  free (na);
+}
+
 static void *
 mq_notify_process (void *arg)
 {
-  struct libc_mq *info = (struct libc_mq *)arg;
-  struct sembuf sb3[2] = {{3, 0, 0}, {5, 0, 0}};
-  struct sembuf sb4 = {4, 1, 0};
-  int rc;
+  struct mq_notify_arg *na = (struct mq_notify_arg *)arg;
+  void (*function) (union sigval) = na->function;
+  union sigval value = na->value;
+  unsigned char cookie[MQ_NOTIFY_COOKIE_LEN];
+  ssize_t n;
+  int fire;
+
+  /* nobody joins us, whatever the attributes said */
+  pthread_detach (pthread_self ());
 
-  /* wait until queue is empty */
-  while (!(rc = semop (info->semid, sb3, 1)) && errno == EINTR)
-    /* empty */ ;
+  pthread_cleanup_push (mq_notify_free, na);
 
-  if (!rc)
+  if (na->shm != NULL)
     {
-      /* now wait until there are 0 readers and the queue has something in it */
-      sb3[0].sem_op = -1;
-      while (!(rc = semop (info->semid, sb3, 2)) && errno == EINTR)
-	/* empty */ ;
-      /* restore value since we have not actually performed a read */
-      sb3[0].sem_op = 1;
-      semop (info->semid, sb3, 1);
-      /* perform desired notification - either run function in this thread or pass signal */
-      if (!rc)
+      /* a sender bumps notify_seq, and mq_close cancels us; we map the
+	 queue ourselves so that it cannot go away under us */
+      do
 	{
-	  if (info->sigevent->sigev_notify == SIGEV_SIGNAL)
-	    raise (info->sigevent->sigev_signo);
-	  else if (info->sigevent->sigev_notify == SIGEV_THREAD)
-	    info->sigevent->sigev_notify_function (info->sigevent->sigev_value);
-	  /* allow other processes to now mq_notify */
-	  semop (info->semid, &sb4, 1);
+	  __mq_futex (&na->shm->notify_seq, MQ_FUTEX_WAIT, na->seq, NULL);
+	  pthread_testcancel ();
 	}
+      while (*(volatile int *)&na->shm->notify_seq == na->seq);
+      fire = 1;
     }
-  pthread_exit (NULL);
+  else
+    {
+      /* the kernel sends the cookie when a message arrives, and also when
+	 the registration goes with mq_notify or mq_close */
+      do
+	n = recv (na->sock, cookie, sizeof(cookie), 0);
+      while (n < 0 && errno == EINTR);
+      fire = n == sizeof(cookie)
+	     && cookie[MQ_NOTIFY_COOKIE_LEN - 1] == MQ_NOTIFY_WOKENUP;
+    }
+
+  pthread_cleanup_pop (1);
+
+  if (fire)
+    function (value);
+  return NULL;
 }
 
 int
 mq_notify (mqd_t msgid, const struct sigevent *notification)
 {
-  struct libc_mq *info;
-  struct sembuf sb4 = {4, -1, IPC_NOWAIT};
-  int rc;
-  pthread_attr_t *attr = NULL;
+  unsigned char cookie[MQ_NOTIFY_COOKIE_LEN];
+  struct __mq_ksigevent ksev;
+  struct mq_notify_arg *na;
+  struct libc_mq *info = NULL;
+  pthread_t th;
+  int rc, saved_errno;
+
+  if (MQ_IS_SHM (msgid))
+    {
+      info = __find_mq (msgid);
+      if (info == NULL)
+	{
+	  errno = EBADF;
+	  return -1;
+	}
+      if (notification == NULL && info->cleanup_notify != NULL)
+	info->cleanup_notify (info);
+    }
 
-  info = __find_mq (msgid);
+  if (notification == NULL || notification->sigev_notify != SIGEV_THREAD)
+    return __libc_mq_notify (msgid, notification);
 
-  if (info == NULL)
+  if ((na = (struct mq_notify_arg *)malloc (sizeof(*na))) == NULL)
     {
-      errno = EBADF;
+      errno = ENOMEM;
       return -1;
     }
+  na->function = notification->sigev_notify_function;
+  na->value = notification->sigev_value;
+  na->shm = NULL;
+  na->sock = -1;
 
-  /* get notification lock */
-  rc = semop (info->semid, &sb4, 1);
+  if (info != NULL)
+    {
+      na->size = info->size;
+      na->shm = (struct mq_shm *)mmap (0, na->size, PROT_READ | PROT_WRITE,
+				       MAP_SHARED, info->fd, 0);
+      if (na->shm == (struct mq_shm *)MAP_FAILED)
+	{
+	  free (na);
+	  return -1;
+	}
+      na->seq = *(volatile int *)&na->shm->notify_seq;
+      rc = __mq_shm_notify (info, 0, na->value);
+    }
+  else
+    {
+      na->sock = socket (PF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+      if (na->sock < 0)
+	{
+	  free (na);
+	  return -1;
+	}
+      memset (cookie, 0, sizeof(cookie));
+      memset (&ksev, 0, sizeof(ksev));
+      ksev.sigev_value.sival_ptr = cookie;
+      ksev.sigev_signo = na->sock;
+      ksev.sigev_notify = MQ_KSIGEV_THREAD;
+      rc = __mq_knotify (msgid, &ksev);
+    }
 
-  if (rc == -1)
+  if (rc != 0)
     {
-      errno = EBUSY;
+      saved_errno = errno;
+      mq_notify_free (na);
+      errno = saved_errno;
       return -1;
     }
 
-  /* to get the notification running we use a pthread - if the user has requested
-     an action in a pthread, we use the user's attributes when setting up the thread */
-  info->sigevent = (struct sigevent *)notification;
-  if (info->sigevent->sigev_notify == SIGEV_THREAD)
-    attr = (pthread_attr_t *)info->sigevent->sigev_notify_attributes;
-  rc = pthread_create ((pthread_t *)&info->th, attr, mq_notify_process, (void *)info);
-
+  /* to get the notification running we use a pthread with the user's
+     attributes */
+  rc = pthread_create (&th, (pthread_attr_t *)notification->sigev_notify_attributes,
+		       mq_notify_process, (void *)na);
   if (rc != 0)
-    rc = -1;
-  else
-    info->cleanup_notify = &__cleanup_mq_notify;
-
-  return rc;
-}
-
-      
-
-
-
+    {
+      if (info != NULL)
+	__mq_shm_unnotify (info);
+      else
+	__mq_knotify (msgid, NULL);
+      mq_notify_free (na);
+      errno = rc;
+      return -1;
+    }
 
+  if (info != NULL)
+    {
+      info->th = (unsigned long)th;
+      info->cleanup_notify = &__cleanup_mq_notify;
+    }
 
+  return 0;
+}
@@ -22,13 +22,82 @@
 #include "pthread.h"
 #include "internals.h"
 #include "spinlock.h"
-#include "queue.h"
-#include "restart.h"
+#include "futex.h"
+
+/* All kinds of mutexes are a futex lock on the status word of __m_lock,
+   see futex.h.  The recursive and error checking kinds also record their
+   owner.  The adaptive and the recursive ones spin for a while before
+   they sleep on SMP, as the internal locks do, see spinlock.c: the locks
+   of stdio and malloc are recursive mutexes.
+
+   While the lock statistics are kept, __m_reserved holds the low bits of
+   the time the mutex was locked at, or 0.  */
+
+static inline void mutex_locked(pthread_mutex_t * mutex)
+{
+  if (__builtin_expect (__pthread_lockstats_enabled, 0))
+    mutex->__m_reserved = (int) __pthread_lockstats_clock() | 1;
+}
+
+static inline void mutex_lock(pthread_mutex_t * mutex, int spin)
+{
+  futex_word_t *futex = __futex_word(&mutex->__m_lock);
+
+  if (__builtin_expect (__futex_trylock(futex) != 0, 0))
+    __pthread_lock_contended(&mutex->__m_lock, NULL, spin);
+  else if (__builtin_expect (__pthread_lockstats_enabled, 0))
+    __pthread_lockstats_locked(NULL, 0, 0);
+  mutex_locked(mutex);
+}
+
+static inline int mutex_trylock(pthread_mutex_t * mutex)
+{
+  if (__futex_trylock(__futex_word(&mutex->__m_lock)) != 0)
+    return EBUSY;
+  if (__builtin_expect (__pthread_lockstats_enabled, 0))
+    __pthread_lockstats_locked(NULL, 0, 0);
+  mutex_locked(mutex);
+  return 0;
+}
+
+static inline int mutex_timedlock(pthread_mutex_t * mutex,
+				  const struct timespec *abstime)
+{
+  futex_word_t *futex = __futex_word(&mutex->__m_lock);
+  unsigned long long waited_since;
+
+  if (__builtin_expect (__futex_trylock(futex) != 0, 0)) {
+    waited_since = 0;
+    if (__builtin_expect (__pthread_lockstats_enabled, 0))
+      waited_since = __pthread_lockstats_clock();
+    if (__futex_timedlock(futex, abstime) != 0)
+      return ETIMEDOUT;
+    if (waited_since != 0)
+      __pthread_lockstats_locked(NULL, waited_since, 0);
+  } else if (__builtin_expect (__pthread_lockstats_enabled, 0))
+    __pthread_lockstats_locked(NULL, 0, 0);
+  mutex_locked(mutex);
+  return 0;
+}
+
+static inline void mutex_unlock(pthread_mutex_t * mutex)
+{
+  unsigned int locked_at = mutex->__m_reserved;
+
+  if (__builtin_expect (locked_at != 0, 0)) {
+    mutex->__m_reserved = 0;
+    if (__pthread_lockstats_enabled)
+      __pthread_lockstats_released(NULL, (unsigned int)
+				   __pthread_lockstats_clock() - locked_at);
+  }
+  __futex_unlock(__futex_word(&mutex->__m_lock));
+}
 
 int __pthread_mutex_init(pthread_mutex_t * mutex,
                        const pthread_mutexattr_t * mutex_attr)
 {
   __pthread_init_lock(&mutex->__m_lock);
+  mutex->__m_reserved = 0;
   mutex->__m_kind =
     mutex_attr == NULL ? PTHREAD_MUTEX_TIMED_NP : mutex_attr->__mutexkind;
   mutex->__m_count = 0;
@@ -42,12 +111,9 @@ int __pthread_mutex_destroy(pthread_mutex_t * mutex)
   switch (mutex->__m_kind) {
   case PTHREAD_MUTEX_ADAPTIVE_NP:
   case PTHREAD_MUTEX_RECURSIVE_NP:
-    if ((mutex->__m_lock.__status & 1) != 0)
-      return EBUSY;
-    return 0;
   case PTHREAD_MUTEX_ERRORCHECK_NP:
   case PTHREAD_MUTEX_TIMED_NP:
-    if (mutex->__m_lock.__status != 0)
+    if (*__futex_word(&mutex->__m_lock) != 0)
       return EBUSY;
     return 0;
   default:
@@ -63,29 +129,26 @@ int __pthread_mutex_trylock(pthread_mutex_t * mutex)
 
   switch(mutex->__m_kind) {
   case PTHREAD_MUTEX_ADAPTIVE_NP:
-    retcode = __pthread_trylock(&mutex->__m_lock);
-    return retcode;
+  case PTHREAD_MUTEX_TIMED_NP:
+    return mutex_trylock(mutex);
   case PTHREAD_MUTEX_RECURSIVE_NP:
     self = thread_self();
     if (mutex->__m_owner == self) {
       mutex->__m_count++;
       return 0;
     }
-    retcode = __pthread_trylock(&mutex->__m_lock);
+    retcode = mutex_trylock(mutex);
     if (retcode == 0) {
       mutex->__m_owner = self;
       mutex->__m_count = 0;
     }
     return retcode;
   case PTHREAD_MUTEX_ERRORCHECK_NP:
-    retcode = __pthread_alt_trylock(&mutex->__m_lock);
+    retcode = mutex_trylock(mutex);
     if (retcode == 0) {
       mutex->__m_owner = thread_self();
     }
     return retcode;
-  case PTHREAD_MUTEX_TIMED_NP:
-    retcode = __pthread_alt_trylock(&mutex->__m_lock);
-    return retcode;
   default:
     return EINVAL;
   }
@@ -98,7 +161,7 @@ int __pthread_mutex_lock(pthread_mutex_t * mutex)
 
   switch(mutex->__m_kind) {
   case PTHREAD_MUTEX_ADAPTIVE_NP:
-    __pthread_lock(&mutex->__m_lock, NULL);
+    mutex_lock(mutex, 1);
     return 0;
   case PTHREAD_MUTEX_RECURSIVE_NP:
     self = thread_self();
@@ -106,18 +169,18 @@ int __pthread_mutex_lock(pthread_mutex_t * mutex)
       mutex->__m_count++;
       return 0;
     }
-    __pthread_lock(&mutex->__m_lock, self);
+    mutex_lock(mutex, 1);
     mutex->__m_owner = self;
     mutex->__m_count = 0;
     return 0;
   case PTHREAD_MUTEX_ERRORCHECK_NP:
     self = thread_self();
     if (mutex->__m_owner == self) return EDEADLK;
-    __pthread_alt_lock(&mutex->__m_lock, self);
+    mutex_lock(mutex, 0);
     mutex->__m_owner = self;
     return 0;
   case PTHREAD_MUTEX_TIMED_NP:
-    __pthread_alt_lock(&mutex->__m_lock, NULL);
+    mutex_lock(mutex, 0);
     return 0;
   default:
     return EINVAL;
@@ -137,32 +200,27 @@ int __pthread_mutex_timedlock (pthread_mutex_t *mutex,
 
   switch(mutex->__m_kind) {
   case PTHREAD_MUTEX_ADAPTIVE_NP:
-    __pthread_lock(&mutex->__m_lock, NULL);
-    return 0;
+  case PTHREAD_MUTEX_TIMED_NP:
+    return mutex_timedlock(mutex, abstime);
   case PTHREAD_MUTEX_RECURSIVE_NP:
     self = thread_self();
     if (mutex->__m_owner == self) {
       mutex->__m_count++;
       return 0;
     }
-    __pthread_lock(&mutex->__m_lock, self);
-    mutex->__m_owner = self;
-    mutex->__m_count = 0;
-    return 0;
+    res = mutex_timedlock(mutex, abstime);
+    if (res == 0) {
+      mutex->__m_owner = self;
+      mutex->__m_count = 0;
+    }
+    return res;
   case PTHREAD_MUTEX_ERRORCHECK_NP:
     self = thread_self();
     if (mutex->__m_owner == self) return EDEADLK;
-    res = __pthread_alt_timedlock(&mutex->__m_lock, self, abstime);
-    if (res != 0)
-      {
-	mutex->__m_owner = self;
-	return 0;
-      }
-    return ETIMEDOUT;
-  case PTHREAD_MUTEX_TIMED_NP:
-    /* Only this type supports timed out lock. */
-    return (__pthread_alt_timedlock(&mutex->__m_lock, NULL, abstime)
-	    ? 0 : ETIMEDOUT);
+    res = mutex_timedlock(mutex, abstime);
+    if (res == 0)
+      mutex->__m_owner = self;
+    return res;
   default:
     return EINVAL;
   }
@@ -173,7 +231,8 @@ int __pthread_mutex_unlock(pthread_mutex_t * mutex)
 {
   switch (mutex->__m_kind) {
   case PTHREAD_MUTEX_ADAPTIVE_NP:
-    __pthread_unlock(&mutex->__m_lock);
+  case PTHREAD_MUTEX_TIMED_NP:
+    mutex_unlock(mutex);
     return 0;
   case PTHREAD_MUTEX_RECURSIVE_NP:
     if (mutex->__m_owner != thread_self())
@@ -183,16 +242,14 @@ int __pthread_mutex_unlock(pthread_mutex_t * mutex)
       return 0;
     }
     mutex->__m_owner = NULL;
-    __pthread_unlock(&mutex->__m_lock);
+    mutex_unlock(mutex);
     return 0;
   case PTHREAD_MUTEX_ERRORCHECK_NP:
-    if (mutex->__m_owner != thread_self() || mutex->__m_lock.__status == 0)
+    if (mutex->__m_owner != thread_self()
+	|| *__futex_word(&mutex->__m_lock) == 0)
       return EPERM;
     mutex->__m_owner = NULL;
-    __pthread_alt_unlock(&mutex->__m_lock);
-    return 0;
-  case PTHREAD_MUTEX_TIMED_NP:
-    __pthread_alt_unlock(&mutex->__m_lock);
+    mutex_unlock(mutex);
     return 0;
   default:
     return EINVAL;
@@ -200,6 +257,25 @@ int __pthread_mutex_unlock(pthread_mutex_t * mutex)
 }
 strong_alias (__pthread_mutex_unlock, pthread_mutex_unlock)
 
+/* Relock MUTEX on return from a condition variable wait.  The waiter may
+   have been requeued onto the futex of the mutex by pthread_cond_broadcast,
+   so it leaves the lock marked as waited for.  */
+void __pthread_mutex_cond_lock(pthread_mutex_t * mutex)
+{
+  __futex_lock_contended(__futex_word(&mutex->__m_lock));
+  if (__builtin_expect (__pthread_lockstats_enabled, 0))
+    __pthread_lockstats_locked(NULL, 0, 0);
+  mutex_locked(mutex);
+  switch (mutex->__m_kind) {
+  case PTHREAD_MUTEX_RECURSIVE_NP:
+    mutex->__m_count = 0;
+    /* fall through */
+  case PTHREAD_MUTEX_ERRORCHECK_NP:
+    mutex->__m_owner = thread_self();
+    break;
+  }
+}
+
 int __pthread_mutexattr_init(pthread_mutexattr_t *attr)
 {
   attr->__mutexkind = PTHREAD_MUTEX_TIMED_NP;
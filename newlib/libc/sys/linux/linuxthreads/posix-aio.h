@@ -0,0 +1,77 @@
+/* Definitions for the POSIX asynchronous I/O implementation on top of
+   LinuxThreads.  */
+
+#include <aio.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+
+/* Internal operation codes, the 64-bit variants are flagged with
+   LIO_MODE64.  */
+#define LIO_DSYNC	(LIO_NOP + 1)
+#define LIO_SYNC	(LIO_NOP + 2)
+#define LIO_MODE64	128
+
+/* Default tuning, see aio_init.  */
+#define AIO_THREADS_DEFAULT	20
+#define AIO_IDLE_TIME_DEFAULT	1
+
+/* At most this many requests on adjacent offsets of the same file
+   descriptor are done in one system call.  */
+#define AIO_COALESCE_MAX	16
+
+/* The control blocks of both sizes share their layout up to aio_offset.  */
+union aiocb_union
+{
+  struct aiocb aiocb;
+  struct aiocb64 aiocb64;
+};
+
+/* The requests of one lio_listio call, for the LIO_WAIT caller or the
+   notification once all of them are done.  */
+struct aio_group
+{
+  int pending;
+  int waiting;
+  pid_t caller_pid;
+  struct sigevent sigev;
+};
+
+/* A queued or running request.  */
+struct requestlist
+{
+  struct requestlist *next;	/* next request for the same fd */
+  union aiocb_union *aiocbp;
+  int opcode;
+  pid_t caller_pid;
+  struct aio_group *group;
+};
+
+/* The requests for one file descriptor.  They are run in order by at
+   most one worker at a time, which the lseek-based pread and pwrite of
+   this port require anyway.  */
+struct fdqueue
+{
+  struct fdqueue *next;		/* next queue in __aio_fdqueues */
+  struct fdqueue *next_run;	/* next queue waiting for a worker */
+  int fd;
+  int busy;			/* a worker runs requests of this fd */
+  int runnable;			/* on the run list */
+  struct requestlist *head;
+  struct requestlist *tail;
+};
+
+/* Global lock and the condition broadcast on every completion.  */
+extern pthread_mutex_t __aio_requests_mutex;
+extern pthread_cond_t __aio_done_cond;
+
+/* The queues with requests.  */
+extern struct fdqueue *__aio_fdqueues;
+
+extern struct requestlist *__aio_enqueue_request (union aiocb_union *aiocbp,
+						  int operation,
+						  struct aio_group *group);
+extern void __aio_complete_request (struct requestlist *req,
+				    ssize_t result, int error);
+extern void __aio_notify_only (struct sigevent *sigev, pid_t caller_pid);
+extern struct fdqueue *__aio_find_queue (int fd);
@@ -35,10 +35,6 @@
 /* for threading we use processes so we require a few EL/IX level 2 and 
    level 3 syscalls.  We only allow this file to see them to preserve
    the interface. */
-#if defined(_ELIX_LEVEL) && _ELIX_LEVEL < 3
-static _syscall1_base(int,pipe,int *,filedes)
-#endif /* _ELIX_LEVEL < 3 */
-
 #if defined(_ELIX_LEVEL) && _ELIX_LEVEL < 2
 static _syscall2_base(int,setrlimit,int,resource,const struct rlimit *,rlp)
 int on_exit (void (*fn)(int, void *), void *arg)
@@ -141,9 +137,9 @@ struct _pthread_descr_struct __pthread_initial_thread = {
   0                           /* int p_untracked_readlock_count; */
 };
 
-/* Descriptor of the manager thread; none of this is used but the error
-   variables, the p_pid and p_priority fields,
-   and the address for identification.  */
+/* Descriptor of the former manager thread, kept in __pthread_handles[1]
+   for the debuggers that expect it there.  Its p_pid of 0 tells them that
+   no thread runs with it.  */
 
 struct _pthread_descr_struct __pthread_manager_thread = {
   {
@@ -178,7 +174,7 @@ struct _pthread_descr_struct __pthread_manager_thread = {
   0,                          /* int p_h_errno */
   NULL,                       /* char * p_in_sighandler */
   0,                          /* char p_sigwaiting */
-  PTHREAD_START_ARGS_INITIALIZER(__pthread_manager),
+  PTHREAD_START_ARGS_INITIALIZER(NULL),
                               /* struct pthread_start_args p_start_args */
   {NULL},                     /* void ** p_specific[PTHREAD_KEY_1STLEVEL_SIZE] */
   {NULL},                     /* void * p_libc_specific[_LIBC_TSD_KEY_N] */
@@ -198,7 +194,7 @@ struct _pthread_descr_struct __pthread_manager_thread = {
   0                           /* int p_untracked_readlock_count; */
 };
 
-/* Pointer to the main thread (the father of the thread manager thread) */
+/* Pointer to the main thread */
 /* Originally, this is the initial thread, but this changes after fork() */
 
 pthread_descr __pthread_main_thread = &__pthread_initial_thread;
@@ -208,24 +204,15 @@ pthread_descr __pthread_main_thread = &__pthread_initial_thread;
 
 char *__pthread_initial_thread_bos;
 
-/* File descriptor for sending requests to the thread manager. */
-/* Initially -1, meaning that the thread manager is not running. */
-
-int __pthread_manager_request = -1;
-
-/* Other end of the pipe for sending requests to the thread manager. */
-
-int __pthread_manager_reader;
-
-/* Limits of the thread manager stack */
+/* Nonzero once the first thread has been created. */
 
-char *__pthread_manager_thread_bos;
-char *__pthread_manager_thread_tos;
+int __pthread_threads_started;
 
 /* For process-wide exit() */
 
 int __pthread_exit_requested;
 int __pthread_exit_code;
+pthread_descr __pthread_exit_thread;
 
 /* Maximum stack size.  */
 size_t __pthread_max_stacksize;
@@ -507,6 +494,8 @@ static void pthread_initialize(void)
 #endif
   /* Update the descriptor for the initial thread. */
   __pthread_initial_thread.p_pid = __getpid();
+  /* It runs until it calls pthread_exit, which clears this itself. */
+  __pthread_initial_thread.p_alive = 1;
   /* Likewise for the resolver state _res.  */
   __pthread_initial_thread.p_resp = &_res;
 #ifdef __SIGRTMIN
@@ -552,12 +541,8 @@ void __pthread_initialize(void)
   pthread_initialize();
 }
 
-int __pthread_initialize_manager(void)
+void __pthread_initialize_threads(void)
 {
-  int manager_pipe[2];
-  int pid;
-  struct pthread_request request;
-
 #ifndef HAVE_Z_NODELETE
   if (__builtin_expect (&__dso_handle != NULL, 1))
     __cxa_atexit ((void (*) (void *)) pthread_atexit_retcode, NULL,
@@ -569,111 +554,7 @@ int __pthread_initialize_manager(void)
   /* If basic initialization not done yet (e.g. we're called from a
      constructor run before our constructor), do it now */
   if (__pthread_initial_thread_bos == NULL) pthread_initialize();
-  /* Setup stack for thread manager */
-  __pthread_manager_thread_bos = malloc(THREAD_MANAGER_STACK_SIZE);
-  if (__pthread_manager_thread_bos == NULL) return -1;
-  __pthread_manager_thread_tos =
-    __pthread_manager_thread_bos + THREAD_MANAGER_STACK_SIZE;
-  /* Setup pipe to communicate with thread manager */
-  if (__libc_pipe(manager_pipe) == -1) {
-    free(__pthread_manager_thread_bos);
-    return -1;
-  }
-  /* Start the thread manager */
-  pid = 0;
-  if (__builtin_expect (__pthread_initial_thread.p_report_events, 0))
-    {
-      /* It's a bit more complicated.  We have to report the creation of
-	 the manager thread.  */
-      int idx = __td_eventword (TD_CREATE);
-      uint32_t mask = __td_eventmask (TD_CREATE);
-
-      if ((mask & (__pthread_threads_events.event_bits[idx]
-		   | __pthread_initial_thread.p_eventbuf.eventmask.event_bits[idx]))
-	  != 0)
-	{
-	  __pthread_lock(__pthread_manager_thread.p_lock, NULL);
-
-#ifdef NEED_SEPARATE_REGISTER_STACK
-	  pid = __clone2(__pthread_manager_event,
-			 (void **) __pthread_manager_thread_bos,
-			 THREAD_MANAGER_STACK_SIZE,
-			 CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-			 (void *)(long)manager_pipe[0]);
-#elif _STACK_GROWS_UP
-	  pid = __clone(__pthread_manager_event,
-			(void **) __pthread_manager_thread_bos,
-			CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-			(void *)(long)manager_pipe[0]);
-#else
-	  pid = __clone(__pthread_manager_event,
-			(void **) __pthread_manager_thread_tos,
-			CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-			(void *)(long)manager_pipe[0]);
-#endif
-
-	  if (pid != -1)
-	    {
-	      /* Now fill in the information about the new thread in
-	         the newly created thread's data structure.  We cannot let
-	         the new thread do this since we don't know whether it was
-	         already scheduled when we send the event.  */
-	      __pthread_manager_thread.p_eventbuf.eventdata =
-		&__pthread_manager_thread;
-	      __pthread_manager_thread.p_eventbuf.eventnum = TD_CREATE;
-	      __pthread_last_event = &__pthread_manager_thread;
-	      __pthread_manager_thread.p_tid = 2* PTHREAD_THREADS_MAX + 1;
-	      __pthread_manager_thread.p_pid = pid;
-
-	      /* Now call the function which signals the event.  */
-	      __linuxthreads_create_event ();
-	    }
-
-	  /* Now restart the thread.  */
-	  __pthread_unlock(__pthread_manager_thread.p_lock);
-	}
-    }
-
-  if (__builtin_expect (pid, 0) == 0)
-    {
-#ifdef NEED_SEPARATE_REGISTER_STACK
-      pid = __clone2(__pthread_manager, (void **) __pthread_manager_thread_bos,
-		     THREAD_MANAGER_STACK_SIZE,
-		     CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-		     (void *)(long)manager_pipe[0]);
-#elif _STACK_GROWS_UP
-      pid = __clone(__pthread_manager, (void **) __pthread_manager_thread_bos,
-		    CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-		    (void *)(long)manager_pipe[0]);
-#else
-      pid = __clone(__pthread_manager, (void **) __pthread_manager_thread_tos,
-		    CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND,
-		    (void *)(long)manager_pipe[0]);
-#endif
-    }
-  if (__builtin_expect (pid, 0) == -1) {
-    free(__pthread_manager_thread_bos);
-    __libc_close(manager_pipe[0]);
-    __libc_close(manager_pipe[1]);
-    return -1;
-  }
-  __pthread_manager_request = manager_pipe[1]; /* writing end */
-  __pthread_manager_reader = manager_pipe[0]; /* reading end */
-  __pthread_manager_thread.p_tid = 2* PTHREAD_THREADS_MAX + 1;
-  __pthread_manager_thread.p_pid = pid;
-  /* Make gdb aware of new thread manager */
-  if (__builtin_expect (__pthread_threads_debug, 0) && __pthread_sig_debug > 0)
-    {
-      raise(__pthread_sig_debug);
-      /* We suspend ourself and gdb will wake us up when it is
-	 ready to handle us. */
-      __pthread_wait_for_restart_signal(thread_self());
-    }
-  /* Synchronize debugging of the thread manager */
-  request.req_kind = REQ_DEBUG;
-  TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				  (char *) &request, sizeof(request)));
-  return 0;
+  __pthread_threads_started = 1;
 }
 
 /* Thread creation */
@@ -681,26 +562,9 @@ int __pthread_initialize_manager(void)
 int __pthread_create_2_1(pthread_t *thread, const pthread_attr_t *attr,
 			 void * (*start_routine)(void *), void *arg)
 {
-  pthread_descr self = thread_self();
-  struct pthread_request request;
-  int retval;
-  if (__builtin_expect (__pthread_manager_request, 0) < 0) {
-    if (__pthread_initialize_manager() < 0) return EAGAIN;
-  }
-  request.req_thread = self;
-  request.req_kind = REQ_CREATE;
-  request.req_args.create.attr = attr;
-  request.req_args.create.fn = start_routine;
-  request.req_args.create.arg = arg;
-  sigprocmask(SIG_SETMASK, (const sigset_t *) NULL,
-              &request.req_args.create.mask);
-  TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				  (char *) &request, sizeof(request)));
-  suspend(self);
-  retval = THREAD_GETMEM(self, p_retcode);
-  if (__builtin_expect (retval, 0) == 0)
-    *thread = (pthread_t) THREAD_GETMEM(self, p_retval);
-  return retval;
+  if (__builtin_expect (__pthread_threads_started, 1) == 0)
+    __pthread_initialize_threads();
+  return __pthread_handle_create(thread, attr, start_routine, arg);
 }
 
 versioned_symbol (libpthread, __pthread_create_2_1, pthread_create, GLIBC_2_1);
@@ -754,28 +618,13 @@ pthread_descr __pthread_find_self(void)
   char * sp = CURRENT_STACK_FRAME;
   pthread_handle h;
 
-  /* __pthread_handles[0] is the initial thread, __pthread_handles[1] is
-     the manager threads handled specially in thread_self(), so start at 2 */
+  /* __pthread_handles[0] is the initial thread, handled specially in
+     thread_self(), and __pthread_handles[1] is unused, so start at 2 */
   h = __pthread_handles + 2;
   while (! (sp <= (char *) h->h_descr && sp >= h->h_bottom)) h++;
   return h->h_descr;
 }
 
-#else
-
-static pthread_descr thread_self_stack(void)
-{
-  char *sp = CURRENT_STACK_FRAME;
-  pthread_handle h;
-
-  if (sp >= __pthread_manager_thread_bos && sp < __pthread_manager_thread_tos)
-    return &__pthread_manager_thread;
-  h = __pthread_handles + 2;
-  while (! (sp <= (char *) h->h_descr && sp >= h->h_bottom))
-    h++;
-  return h->h_descr;
-}
-
 #endif
 
 /* Thread scheduling */
@@ -799,8 +648,6 @@ int pthread_setschedparam(pthread_t thread, int policy,
   }
   th->p_priority = policy == SCHED_OTHER ? 0 : param->sched_priority;
   __pthread_unlock(&handle->h_lock);
-  if (__pthread_manager_request >= 0)
-    __pthread_manager_adjust_prio(th->p_priority);
   return 0;
 }
 
@@ -835,27 +682,8 @@ weak_alias (__pthread_yield, pthread_yield)
 
 static void pthread_onexit_process(int retcode, void *arg)
 {
-  if (__builtin_expect (__pthread_manager_request, 0) >= 0) {
-    struct pthread_request request;
-    pthread_descr self = thread_self();
-
-    request.req_thread = self;
-    request.req_kind = REQ_PROCESS_EXIT;
-    request.req_args.exit.code = retcode;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-    suspend(self);
-    /* Main thread should accumulate times for thread manager and its
-       children, so that timings for main thread account for all threads. */
-    if (self == __pthread_main_thread)
-      {
-	__waitpid(__pthread_manager_thread.p_pid, NULL, __WCLONE);
-	/* Since all threads have been asynchronously terminated
-           (possibly holding locks), free cannot be used any more.  */
-	/*free (__pthread_manager_thread_bos);*/
-	__pthread_manager_thread_bos = __pthread_manager_thread_tos = NULL;
-      }
-  }
+  if (__builtin_expect (__pthread_threads_started, 0))
+    __pthread_handle_exit(thread_self(), retcode);
 }
 
 #ifndef HAVE_Z_NODELETE
@@ -885,45 +713,17 @@ static void pthread_handle_sigrestart(int sig)
 }
 
 /* The handler for the CANCEL signal checks for cancellation
-   (in asynchronous mode), for process-wide exit and exec requests.
-   For the thread manager thread, redirect the signal to
-   __pthread_manager_sighandler. */
+   (in asynchronous mode), for process-wide exit and exec requests. */
 
 static void pthread_handle_sigcancel(int sig)
 {
   pthread_descr self = thread_self();
   sigjmp_buf * jmpbuf;
 
-  if (self == &__pthread_manager_thread)
-    {
-#ifdef THREAD_SELF
-      /* A new thread might get a cancel signal before it is fully
-	 initialized, so that the thread register might still point to the
-	 manager thread.  Double check that this is really the manager
-	 thread.  */
-      pthread_descr real_self = thread_self_stack();
-      if (real_self == &__pthread_manager_thread)
-	{
-	  __pthread_manager_sighandler(sig);
-	  return;
-	}
-      /* Oops, thread_self() isn't working yet..  */
-      self = real_self;
-# ifdef INIT_THREAD_SELF
-      INIT_THREAD_SELF(self, self->p_nr);
-# endif
-#else
-      __pthread_manager_sighandler(sig);
-      return;
-#endif
-    }
-  if (__builtin_expect (__pthread_exit_requested, 0)) {
-    /* Main thread should accumulate times for thread manager and its
-       children, so that timings for main thread account for all threads. */
-    if (self == __pthread_main_thread)
-      __waitpid(__pthread_manager_thread.p_pid, NULL, __WCLONE);
+  /* The thread completing a process-wide exit may still be cancelled */
+  if (__builtin_expect (__pthread_exit_requested, 0)
+      && self != __pthread_exit_thread)
     _exit(__pthread_exit_code);
-  }
   if (__builtin_expect (THREAD_GETMEM(self, p_canceled), 0)
       && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE) {
     if (THREAD_GETMEM(self, p_canceltype) == PTHREAD_CANCEL_ASYNCHRONOUS)
@@ -938,13 +738,12 @@ static void pthread_handle_sigcancel(int sig)
 
 /* Handler for the DEBUG signal.
    The debugging strategy is as follows:
-   On reception of a REQ_DEBUG request (sent by new threads created to
-   the thread manager under debugging mode), the thread manager throws
-   __pthread_sig_debug to itself. The debugger (if active) intercepts
-   this signal, takes into account new threads and continue execution
-   of the thread manager by propagating the signal because it doesn't
-   know what it is specifically done for. In the current implementation,
-   the thread manager simply discards it. */
+   After creating a thread under debugging mode, the creating thread
+   throws __pthread_sig_debug to itself. The debugger (if active)
+   intercepts this signal, takes into account new threads and continue
+   execution of the creating thread by propagating the signal because it
+   doesn't know what it is specifically done for. In the current
+   implementation, the creating thread simply discards it. */
 
 static void pthread_handle_sigdebug(int sig)
 {
@@ -952,7 +751,7 @@ static void pthread_handle_sigdebug(int sig)
 }
 
 /* Reset the state of the thread machinery after a fork().
-   Close the pipe used for requests and set the main thread to the forked
+   Forget the other threads and set the main thread to the forked
    thread.
    Notice that we can't free the stack segments, as the forked thread
    may hold pointers into them. */
@@ -962,16 +761,7 @@ void __pthread_reset_main_thread(void)
   pthread_descr self = thread_self();
   struct rlimit limit;
 
-  if (__pthread_manager_request != -1) {
-    /* Free the thread manager stack */
-    free(__pthread_manager_thread_bos);
-    __pthread_manager_thread_bos = __pthread_manager_thread_tos = NULL;
-    /* Close the two ends of the pipe */
-    __libc_close(__pthread_manager_request);
-    __libc_close(__pthread_manager_reader);
-    __pthread_manager_request = __pthread_manager_reader = -1;
-  }
-
+  __pthread_reset_threads();
   /* Update the pid of the main thread */
   THREAD_SETMEM(self, p_pid, __getpid());
   /* Make the forked thread the main thread */
@@ -995,7 +785,7 @@ void __pthread_reset_main_thread(void)
 void __pthread_kill_other_threads_np(void)
 {
   struct sigaction sa;
-  /* Terminate all other threads and thread manager */
+  /* Terminate all other threads */
   pthread_onexit_process(0, NULL);
   /* Make current thread the main thread in case the calling thread
      changes its mind, does not exec(), and creates new threads instead. */
@@ -1060,7 +850,7 @@ void __pthread_wait_for_restart_signal(pthread_descr self)
 void __pthread_restart_old(pthread_descr th)
 {
   if (atomic_increment(&th->p_resume_count) == -1)
-    kill(th->p_pid, __pthread_sig_restart);
+    __tkill(th->p_pid, __pthread_sig_restart);
 }
 
 void __pthread_suspend_old(pthread_descr self)
@@ -1154,7 +944,7 @@ void __pthread_restart_new(pthread_descr th)
      memory so the woken thread will have a consistent view.  Complementary
      read barriers are present to the suspend functions. */
   WRITE_MEMORY_BARRIER();
-  kill(th->p_pid, __pthread_sig_restart);
+  __tkill(th->p_pid, __pthread_sig_restart);
 }
 
 /* There is no __pthread_suspend_new because it would just
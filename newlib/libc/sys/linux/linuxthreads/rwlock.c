@@ -21,38 +21,61 @@
 
 #include <bits/libc-lock.h>
 #include <errno.h>
+#include <limits.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include "internals.h"
-#include "queue.h"
 #include "spinlock.h"
-#include "restart.h"
+#include "futex.h"
 
-/* Function called by pthread_cancel to remove the thread from
-   waiting inside pthread_rwlock_timedrdlock or pthread_rwlock_timedwrlock. */
+/* The status word of __rw_lock is the futex lock protecting the other
+   fields.  Waiting readers and writers sleep on the futex words
+   __rw_read_waiting and __rw_write_waiting, whose low half counts them
+   and whose high half is bumped on every wakeup, so that a wakeup between
+   dropping the lock and going to sleep is not lost.  */
 
-static int rwlock_rd_extricate_func(void *obj, pthread_descr th)
-{
-  pthread_rwlock_t *rwlock = obj;
-  int did_remove = 0;
+#define RWLOCK_WAITERS		0xffff
+#define RWLOCK_GENERATION	0x10000
 
-  __pthread_lock(&rwlock->__rw_lock, NULL);
-  did_remove = remove_from_queue(&rwlock->__rw_read_waiting, th);
-  __pthread_unlock(&rwlock->__rw_lock);
+#define rwlock_lock(rwlock) __futex_word(&(rwlock)->__rw_lock)
+#define read_wakeup(rwlock) ((futex_word_t *) &(rwlock)->__rw_read_waiting)
+#define write_wakeup(rwlock) ((futex_word_t *) &(rwlock)->__rw_write_waiting)
 
-  return did_remove;
+/* Sleep on WAKEUP until woken or ABSTIME, if not NULL, passes.  The
+   internal lock is held on entry and on return, but not while asleep.
+   This is not a cancellation point.  */
+static int
+rwlock_wait (pthread_rwlock_t *rwlock, futex_word_t *wakeup,
+	     const struct timespec *abstime)
+{
+  struct timespec reltime;
+  int val, err = 0;
+
+  val = *wakeup + 1;
+  *wakeup = val;
+  __futex_unlock (rwlock_lock (rwlock));
+
+  if (abstime == NULL)
+    futex_wait (wakeup, val, NULL);
+  else if (__futex_reltime (abstime, &reltime) != 0
+	   || futex_wait (wakeup, val, &reltime) == ETIMEDOUT)
+    err = ETIMEDOUT;
+
+  __futex_lock (rwlock_lock (rwlock));
+  *wakeup -= 1;
+  return err;
 }
 
-static int rwlock_wr_extricate_func(void *obj, pthread_descr th)
+/* Prepare to wake threads waiting on WAKEUP, with the internal lock held.
+   Returns whether there are any, in which case the caller wakes them with
+   futex_wake once it has released the lock.  */
+static int
+rwlock_prepare_wake (futex_word_t *wakeup)
 {
-  pthread_rwlock_t *rwlock = obj;
-  int did_remove = 0;
-
-  __pthread_lock(&rwlock->__rw_lock, NULL);
-  did_remove = remove_from_queue(&rwlock->__rw_write_waiting, th);
-  __pthread_unlock(&rwlock->__rw_lock);
-
-  return did_remove;
+  if ((*wakeup & RWLOCK_WAITERS) == 0)
+    return 0;
+  *wakeup += RWLOCK_GENERATION;
+  return 1;
 }
 
 /*
@@ -151,7 +174,7 @@ rwlock_can_rdlock(pthread_rwlock_t *rwlock, int have_lock_already)
     return 1;
 
   /* Lock prefers writers, but none are waiting. */
-  if (queue_is_empty(&rwlock->__rw_write_waiting))
+  if ((*write_wakeup(rwlock) & RWLOCK_WAITERS) == 0)
     return 1;
 
   /* Writers are waiting, but this thread already has a read lock */
@@ -218,8 +241,8 @@ __pthread_rwlock_init (pthread_rwlock_t *rwlock,
   __pthread_init_lock(&rwlock->__rw_lock);
   rwlock->__rw_readers = 0;
   rwlock->__rw_writer = NULL;
-  rwlock->__rw_read_waiting = NULL;
-  rwlock->__rw_write_waiting = NULL;
+  rwlock->__rw_read_waiting = 0;
+  rwlock->__rw_write_waiting = 0;
 
   if (attr == NULL)
     {
@@ -243,10 +266,10 @@ __pthread_rwlock_destroy (pthread_rwlock_t *rwlock)
   int readers;
   _pthread_descr writer;
 
-  __pthread_lock (&rwlock->__rw_lock, NULL);
+  __futex_lock (rwlock_lock (rwlock));
   readers = rwlock->__rw_readers;
   writer = rwlock->__rw_writer;
-  __pthread_unlock (&rwlock->__rw_lock);
+  __futex_unlock (rwlock_lock (rwlock));
 
   if (readers > 0 || writer != NULL)
     return EBUSY;
@@ -268,20 +291,12 @@ __pthread_rwlock_rdlock (pthread_rwlock_t *rwlock)
   if (self == NULL)
     self = thread_self ();
 
-  for (;;)
-    {
-      __pthread_lock (&rwlock->__rw_lock, self);
-
-      if (rwlock_can_rdlock(rwlock, have_lock_already))
-	break;
-
-      enqueue (&rwlock->__rw_read_waiting, self);
-      __pthread_unlock (&rwlock->__rw_lock);
-      suspend (self); /* This is not a cancellation point */
-    }
+  __futex_lock (rwlock_lock (rwlock));
+  while (!rwlock_can_rdlock(rwlock, have_lock_already))
+    rwlock_wait (rwlock, read_wakeup (rwlock), NULL);
 
   ++rwlock->__rw_readers;
-  __pthread_unlock (&rwlock->__rw_lock);
+  __futex_unlock (rwlock_lock (rwlock));
 
   if (have_lock_already || out_of_mem)
     {
@@ -302,7 +317,6 @@ __pthread_rwlock_timedrdlock (pthread_rwlock_t *rwlock,
   pthread_descr self = NULL;
   pthread_readlock_info *existing;
   int out_of_mem, have_lock_already;
-  pthread_extricate_if extr;
 
   if (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
     return EINVAL;
@@ -313,46 +327,24 @@ __pthread_rwlock_timedrdlock (pthread_rwlock_t *rwlock,
   if (self == NULL)
     self = thread_self ();
 
-  /* Set up extrication interface */
-  extr.pu_object = rwlock;
-  extr.pu_extricate_func = rwlock_rd_extricate_func;
-
-  /* Register extrication interface */
-  __pthread_set_own_extricate_if (self, &extr);
-
-  for (;;)
-    {
-      __pthread_lock (&rwlock->__rw_lock, self);
-
-      if (rwlock_can_rdlock(rwlock, have_lock_already))
-	break;
-
-      enqueue (&rwlock->__rw_read_waiting, self);
-      __pthread_unlock (&rwlock->__rw_lock);
-      /* This is not a cancellation point */
-      if (timedsuspend (self, abstime) == 0)
-	{
-	  int was_on_queue;
-
-	  __pthread_lock (&rwlock->__rw_lock, self);
-	  was_on_queue = remove_from_queue (&rwlock->__rw_read_waiting, self);
-	  __pthread_unlock (&rwlock->__rw_lock);
-
-	  if (was_on_queue)
-	    {
-	      __pthread_set_own_extricate_if (self, 0);
-	      return ETIMEDOUT;
-	    }
-
-	  /* Eat the outstanding restart() from the signaller */
-	  suspend (self);
-	}
-    }
-
-  __pthread_set_own_extricate_if (self, 0);
+  __futex_lock (rwlock_lock (rwlock));
+  while (!rwlock_can_rdlock(rwlock, have_lock_already))
+    if (rwlock_wait (rwlock, read_wakeup (rwlock), abstime) != 0
+	&& !rwlock_can_rdlock(rwlock, have_lock_already))
+      {
+	__futex_unlock (rwlock_lock (rwlock));
+	if (existing != NULL && !have_lock_already)
+	  {
+	    /* Undo rwlock_have_already.  */
+	    rwlock_remove_from_list (self, rwlock);
+	    existing->pr_next = THREAD_GETMEM (self, p_readlock_free);
+	    THREAD_SETMEM (self, p_readlock_free, existing);
+	  }
+	return ETIMEDOUT;
+      }
 
   ++rwlock->__rw_readers;
-  __pthread_unlock (&rwlock->__rw_lock);
+  __futex_unlock (rwlock_lock (rwlock));
 
   if (have_lock_already || out_of_mem)
     {
@@ -377,7 +369,7 @@ __pthread_rwlock_tryrdlock (pthread_rwlock_t *rwlock)
   have_lock_already = rwlock_have_already(&self, rwlock,
       &existing, &out_of_mem);
 
-  __pthread_lock (&rwlock->__rw_lock, self);
+  __futex_lock (rwlock_lock (rwlock));
 
   /* 0 is passed to here instead of have_lock_already.
      This is to meet Single Unix Spec requirements:
@@ -391,7 +383,7 @@ __pthread_rwlock_tryrdlock (pthread_rwlock_t *rwlock)
       retval = 0;
     }
 
-  __pthread_unlock (&rwlock->__rw_lock);
+  __futex_unlock (rwlock_lock (rwlock));
 
   if (retval == 0)
     {
@@ -414,21 +406,13 @@ __pthread_rwlock_wrlock (pthread_rwlock_t *rwlock)
 {
   pthread_descr self = thread_self ();
 
-  while(1)
-    {
-      __pthread_lock (&rwlock->__rw_lock, self);
-      if (rwlock->__rw_readers == 0 && rwlock->__rw_writer == NULL)
-	{
-	  rwlock->__rw_writer = self;
-	  __pthread_unlock (&rwlock->__rw_lock);
-	  return 0;
-	}
+  __futex_lock (rwlock_lock (rwlock));
+  while (rwlock->__rw_readers != 0 || rwlock->__rw_writer != NULL)
+    rwlock_wait (rwlock, write_wakeup (rwlock), NULL);
 
-      /* Suspend ourselves, then try again */
-      enqueue (&rwlock->__rw_write_waiting, self);
-      __pthread_unlock (&rwlock->__rw_lock);
-      suspend (self); /* This is not a cancellation point */
-    }
+  rwlock->__rw_writer = self;
+  __futex_unlock (rwlock_lock (rwlock));
+  return 0;
 }
 strong_alias (__pthread_rwlock_wrlock, pthread_rwlock_wrlock)
 
@@ -438,54 +422,32 @@ __pthread_rwlock_timedwrlock (pthread_rwlock_t *rwlock,
 			      const struct timespec *abstime)
 {
   pthread_descr self;
-  pthread_extricate_if extr;
+  int wake_readers;
 
   if (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
     return EINVAL;
 
   self = thread_self ();
 
-  /* Set up extrication interface */
-  extr.pu_object = rwlock;
-  extr.pu_extricate_func =  rwlock_wr_extricate_func;
-
-  /* Register extrication interface */
-  __pthread_set_own_extricate_if (self, &extr);
-
-  while(1)
-    {
-      __pthread_lock (&rwlock->__rw_lock, self);
-
-      if (rwlock->__rw_readers == 0 && rwlock->__rw_writer == NULL)
-	{
-	  rwlock->__rw_writer = self;
-	  __pthread_set_own_extricate_if (self, 0);
-	  __pthread_unlock (&rwlock->__rw_lock);
-	  return 0;
-	}
-
-      /* Suspend ourselves, then try again */
-      enqueue (&rwlock->__rw_write_waiting, self);
-      __pthread_unlock (&rwlock->__rw_lock);
-      /* This is not a cancellation point */
-      if (timedsuspend (self, abstime) == 0)
-	{
-	  int was_on_queue;
-
-	  __pthread_lock (&rwlock->__rw_lock, self);
-	  was_on_queue = remove_from_queue (&rwlock->__rw_write_waiting, self);
-	  __pthread_unlock (&rwlock->__rw_lock);
-
-	  if (was_on_queue)
-	    {
-	      __pthread_set_own_extricate_if (self, 0);
-	      return ETIMEDOUT;
-	    }
-
-	  /* Eat the outstanding restart() from the signaller */
-	  suspend (self);
-	}
-    }
+  __futex_lock (rwlock_lock (rwlock));
+  while (rwlock->__rw_readers != 0 || rwlock->__rw_writer != NULL)
+    if (rwlock_wait (rwlock, write_wakeup (rwlock), abstime) != 0
+	&& (rwlock->__rw_readers != 0 || rwlock->__rw_writer != NULL))
+      {
+	/* Readers held back for the writers may go ahead if this was the
+	   last waiting one.  */
+	wake_readers = ((*write_wakeup (rwlock) & RWLOCK_WAITERS) == 0
+			&& rwlock->__rw_writer == NULL
+			&& rwlock_prepare_wake (read_wakeup (rwlock)));
+	__futex_unlock (rwlock_lock (rwlock));
+	if (wake_readers)
+	  futex_wake (read_wakeup (rwlock), INT_MAX);
+	return ETIMEDOUT;
+      }
+
+  rwlock->__rw_writer = self;
+  __futex_unlock (rwlock_lock (rwlock));
+  return 0;
 }
 strong_alias (__pthread_rwlock_timedwrlock, pthread_rwlock_timedwrlock)
 
@@ -495,13 +457,13 @@ __pthread_rwlock_trywrlock (pthread_rwlock_t *rwlock)
 {
   int result = EBUSY;
 
-  __pthread_lock (&rwlock->__rw_lock, NULL);
+  __futex_lock (rwlock_lock (rwlock));
   if (rwlock->__rw_readers == 0 && rwlock->__rw_writer == NULL)
     {
       rwlock->__rw_writer = thread_self ();
       result = 0;
     }
-  __pthread_unlock (&rwlock->__rw_lock);
+  __futex_unlock (rwlock_lock (rwlock));
 
   return result;
 }
@@ -511,57 +473,53 @@ strong_alias (__pthread_rwlock_trywrlock, pthread_rwlock_trywrlock)
 int
 __pthread_rwlock_unlock (pthread_rwlock_t *rwlock)
 {
-  pthread_descr torestart;
-  pthread_descr th;
-
-  __pthread_lock (&rwlock->__rw_lock, NULL);
+  __futex_lock (rwlock_lock (rwlock));
   if (rwlock->__rw_writer != NULL)
     {
       /* Unlocking a write lock.  */
       if (rwlock->__rw_writer != thread_self ())
 	{
-	  __pthread_unlock (&rwlock->__rw_lock);
+	  __futex_unlock (rwlock_lock (rwlock));
 	  return EPERM;
 	}
       rwlock->__rw_writer = NULL;
 
       if ((rwlock->__rw_kind == PTHREAD_RWLOCK_PREFER_READER_NP
-	   && !queue_is_empty(&rwlock->__rw_read_waiting))
-	  || (th = dequeue(&rwlock->__rw_write_waiting)) == NULL)
+	   && (*read_wakeup (rwlock) & RWLOCK_WAITERS) != 0)
+	  || !rwlock_prepare_wake (write_wakeup (rwlock)))
 	{
-	  /* Restart all waiting readers.  */
-	  torestart = rwlock->__rw_read_waiting;
-	  rwlock->__rw_read_waiting = NULL;
-	  __pthread_unlock (&rwlock->__rw_lock);
-	  while ((th = dequeue (&torestart)) != NULL)
-	    restart (th);
+	  /* Wake all waiting readers.  */
+	  int wake = rwlock_prepare_wake (read_wakeup (rwlock));
+	  __futex_unlock (rwlock_lock (rwlock));
+	  if (wake)
+	    futex_wake (read_wakeup (rwlock), INT_MAX);
 	}
       else
 	{
-	  /* Restart one waiting writer.  */
-	  __pthread_unlock (&rwlock->__rw_lock);
-	  restart (th);
+	  /* Wake one waiting writer.  */
+	  __futex_unlock (rwlock_lock (rwlock));
+	  futex_wake (write_wakeup (rwlock), 1);
 	}
     }
   else
     {
+      int wake;
+
       /* Unlocking a read lock.  */
       if (rwlock->__rw_readers == 0)
 	{
-	  __pthread_unlock (&rwlock->__rw_lock);
+	  __futex_unlock (rwlock_lock (rwlock));
 	  return EPERM;
 	}
 
       --rwlock->__rw_readers;
-      if (rwlock->__rw_readers == 0)
-	/* Restart one waiting writer, if any.  */
-	th = dequeue (&rwlock->__rw_write_waiting);
-      else
-	th = NULL;
+      /* Wake one waiting writer, if any.  */
+      wake = (rwlock->__rw_readers == 0
+	      && rwlock_prepare_wake (write_wakeup (rwlock)));
 
-      __pthread_unlock (&rwlock->__rw_lock);
-      if (th != NULL)
-	restart (th);
+      __futex_unlock (rwlock_lock (rwlock));
+      if (wake)
+	futex_wake (write_wakeup (rwlock), 1);
 
       /* Recursive lock fixup */
 
@@ -15,14 +15,20 @@
 /* Semaphores a la POSIX 1003.1b */
 
 #include <errno.h>
+#include <setjmp.h>
 #include "pthread.h"
 #include "semaphore.h"
 #include "internals.h"
 #include "spinlock.h"
-#include "restart.h"
-#include "queue.h"
+#include "futex.h"
 #include <shlib-compat.h>
 
+/* The value of the semaphore is the futex word sem_wait sleeps on when
+   it is 0, the spinlock word of __sem_lock counts the sleepers so that
+   sem_post only makes a system call if there are any.  */
+
+#define sem_waiters(sem) (&(sem)->__sem_lock.__spinlock)
+
 int __new_sem_init(sem_t *sem, int pshared, unsigned int value)
 {
   if (value > SEM_VALUE_MAX) {
@@ -39,138 +45,97 @@ int __new_sem_init(sem_t *sem, int pshared, unsigned int value)
   return 0;
 }
 
-/* Function called by pthread_cancel to remove the thread from
-   waiting inside __new_sem_wait. */
-
-static int new_sem_extricate_func(void *obj, pthread_descr th)
+/* Take one unit of SEM if there is one.  */
+static inline int sem_take(sem_t *sem)
 {
-  volatile pthread_descr self = thread_self();
-  sem_t *sem = obj;
-  int did_remove = 0;
+  int value;
 
-  __pthread_lock(&sem->__sem_lock, self);
-  did_remove = remove_from_queue(&sem->__sem_waiting, th);
-  __pthread_unlock(&sem->__sem_lock);
-
-  return did_remove;
+  while ((value = *(volatile int *) &sem->__sem_value) > 0)
+    if (__int_compare_and_exchange(&sem->__sem_value, value, value - 1)
+	== value)
+      return 0;
+  return EAGAIN;
 }
 
-int __new_sem_wait(sem_t * sem)
+/* Wait for SEM until ABSTIME, or forever if that is NULL.  This is a
+   cancellation point: a cancellation request while asleep makes the
+   cancel signal handler jump back here, as for sigwait, but one that
+   comes once the semaphore is ours is left for later.  */
+static int sem_wait_common(sem_t *sem, const struct timespec *abstime)
 {
   volatile pthread_descr self = thread_self();
-  pthread_extricate_if extr;
-  int already_canceled = 0;
-  int spurious_wakeup_count;
-
-  /* Set up extrication interface */
-  extr.pu_object = sem;
-  extr.pu_extricate_func = new_sem_extricate_func;
+  sigjmp_buf jmpbuf;
+  struct timespec reltime;
+  int err;
 
-  __pthread_lock(&sem->__sem_lock, self);
-  if (sem->__sem_value > 0) {
-    sem->__sem_value--;
-    __pthread_unlock(&sem->__sem_lock);
+  if (sem_take(sem) == 0)
     return 0;
-  }
-  /* Register extrication interface */
-  THREAD_SETMEM(self, p_sem_avail, 0);
-  __pthread_set_own_extricate_if(self, &extr);
-  /* Enqueue only if not already cancelled. */
-  if (!(THREAD_GETMEM(self, p_canceled)
-      && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE))
-    enqueue(&sem->__sem_waiting, self);
-  else
-    already_canceled = 1;
-  __pthread_unlock(&sem->__sem_lock);
 
-  if (already_canceled) {
-    __pthread_set_own_extricate_if(self, 0);
-    __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
-  }
+  if (abstime != NULL
+      && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
+    /* The standard requires that if the function would block and the
+       time value is illegal, the function returns with an error.  */
+    return EINVAL;
 
-  /* Wait for sem_post or cancellation, or fall through if already canceled */
-  spurious_wakeup_count = 0;
-  while (1)
-    {
-      suspend(self);
-      if (THREAD_GETMEM(self, p_sem_avail) == 0
-	  && (THREAD_GETMEM(self, p_woken_by_cancel) == 0
-	      || THREAD_GETMEM(self, p_cancelstate) != PTHREAD_CANCEL_ENABLE))
-	{
-	  /* Count resumes that don't belong to us. */
-	  spurious_wakeup_count++;
-	  continue;
-	}
-      break;
+  __int_exchange_and_add(sem_waiters(sem), 1);
+  err = 0;
+  while (sem_take(sem) != 0) {
+    if (sigsetjmp(jmpbuf, 1) == 0) {
+      THREAD_SETMEM(self, p_cancel_jmp, &jmpbuf);
+      if (!(THREAD_GETMEM(self, p_canceled)
+	    && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE)) {
+	if (abstime == NULL)
+	  futex_wait(&sem->__sem_value, 0, NULL);
+	else if (__futex_reltime(abstime, &reltime) != 0
+		 || futex_wait(&sem->__sem_value, 0, &reltime) == ETIMEDOUT)
+	  err = ETIMEDOUT;
+      }
     }
-  __pthread_set_own_extricate_if(self, 0);
-
-  /* Terminate only if the wakeup came from cancellation. */
-  /* Otherwise ignore cancellation because we got the semaphore. */
-
-  if (THREAD_GETMEM(self, p_woken_by_cancel)
-      && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE) {
-    THREAD_SETMEM(self, p_woken_by_cancel, 0);
-    __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
+    THREAD_SETMEM(self, p_cancel_jmp, NULL);
+    if (THREAD_GETMEM(self, p_canceled)
+	&& THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE) {
+      __int_exchange_and_add(sem_waiters(sem), -1);
+      __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
+    }
+    if (err != 0)
+      break;
   }
-  /* We got the semaphore */
-  return 0;
+  __int_exchange_and_add(sem_waiters(sem), -1);
+  return err;
 }
 
-int __new_sem_trywait(sem_t * sem)
+int __new_sem_wait(sem_t * sem)
 {
-  int retval;
+  return sem_wait_common(sem, NULL);
+}
 
-  __pthread_lock(&sem->__sem_lock, NULL);
-  if (sem->__sem_value == 0) {
+int __new_sem_trywait(sem_t * sem)
+{
+  if (sem_take(sem) != 0) {
     errno = EAGAIN;
-    retval = -1;
-  } else {
-    sem->__sem_value--;
-    retval = 0;
+    return -1;
   }
-  __pthread_unlock(&sem->__sem_lock);
-  return retval;
+  return 0;
 }
 
+/* This is async-signal-safe, unlike with the earlier implementation
+   there is no need to go through the thread manager from a signal
+   handler.  */
 int __new_sem_post(sem_t * sem)
 {
-  pthread_descr self = thread_self();
-  pthread_descr th;
-  struct pthread_request request;
-
-  if (THREAD_GETMEM(self, p_in_sighandler) == NULL) {
-    __pthread_lock(&sem->__sem_lock, self);
-    if (sem->__sem_waiting == NULL) {
-      if (sem->__sem_value >= SEM_VALUE_MAX) {
-        /* Overflow */
-        errno = ERANGE;
-        __pthread_unlock(&sem->__sem_lock);
-        return -1;
-      }
-      sem->__sem_value++;
-      __pthread_unlock(&sem->__sem_lock);
-    } else {
-      th = dequeue(&sem->__sem_waiting);
-      __pthread_unlock(&sem->__sem_lock);
-      th->p_sem_avail = 1;
-      WRITE_MEMORY_BARRIER();
-      restart(th);
+  int value;
+
+  do {
+    value = *(volatile int *) &sem->__sem_value;
+    if (value >= SEM_VALUE_MAX) {
+      /* Overflow */
+      errno = ERANGE;
+      return -1;
     }
-  } else {
-    /* If we're in signal handler, delegate post operation to
-       the thread manager. */
-    if (__pthread_manager_request < 0) {
-      if (__pthread_initialize_manager() < 0) {
-        errno = EAGAIN;
-        return -1;
-      }
-    }
-    request.req_kind = REQ_POST;
-    request.req_args.post = sem;
-    TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				    (char *) &request, sizeof(request)));
-  }
+  } while (__int_compare_and_exchange(&sem->__sem_value, value, value + 1)
+	   != value);
+  if (*(volatile int *) sem_waiters(sem) != 0)
+    futex_wake(&sem->__sem_value, 1);
   return 0;
 }
 
@@ -182,7 +147,7 @@ int __new_sem_getvalue(sem_t * sem, int * sval)
 
 int __new_sem_destroy(sem_t * sem)
 {
-  if (sem->__sem_waiting != NULL) {
+  if (*sem_waiters(sem) != 0) {
     __set_errno (EBUSY);
     return -1;
   }
@@ -209,89 +174,12 @@ int sem_unlink(const char *name)
 
 int sem_timedwait(sem_t *sem, const struct timespec *abstime)
 {
-  pthread_descr self = thread_self();
-  pthread_extricate_if extr;
-  int already_canceled = 0;
-  int spurious_wakeup_count;
-
-  __pthread_lock(&sem->__sem_lock, self);
-  if (sem->__sem_value > 0) {
-    --sem->__sem_value;
-    __pthread_unlock(&sem->__sem_lock);
-    return 0;
-  }
-
-  if (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000) {
-    /* The standard requires that if the function would block and the
-       time value is illegal, the function returns with an error.  */
-    __pthread_unlock(&sem->__sem_lock);
-    return EINVAL;
-  }
+  int err = sem_wait_common(sem, abstime);
 
-  /* Set up extrication interface */
-  extr.pu_object = sem;
-  extr.pu_extricate_func = new_sem_extricate_func;
-
-  /* Register extrication interface */
-  THREAD_SETMEM(self, p_sem_avail, 0);
-  __pthread_set_own_extricate_if(self, &extr);
-  /* Enqueue only if not already cancelled. */
-  if (!(THREAD_GETMEM(self, p_canceled)
-      && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE))
-    enqueue(&sem->__sem_waiting, self);
-  else
-    already_canceled = 1;
-  __pthread_unlock(&sem->__sem_lock);
-
-  if (already_canceled) {
-    __pthread_set_own_extricate_if(self, 0);
-    __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
-  }
-
-  spurious_wakeup_count = 0;
-  while (1)
-    {
-      if (timedsuspend(self, abstime) == 0) {
-	int was_on_queue;
-
-	/* __pthread_lock will queue back any spurious restarts that
-	   may happen to it. */
-
-	__pthread_lock(&sem->__sem_lock, self);
-	was_on_queue = remove_from_queue(&sem->__sem_waiting, self);
-	__pthread_unlock(&sem->__sem_lock);
-
-	if (was_on_queue) {
-	  __pthread_set_own_extricate_if(self, 0);
-	  return ETIMEDOUT;
-	}
-
-	/* Eat the outstanding restart() from the signaller */
-	suspend(self);
-      }
-
-      if (THREAD_GETMEM(self, p_sem_avail) == 0
-	  && (THREAD_GETMEM(self, p_woken_by_cancel) == 0
-	      || THREAD_GETMEM(self, p_cancelstate) != PTHREAD_CANCEL_ENABLE))
-	{
-	  /* Count resumes that don't belong to us. */
-	  spurious_wakeup_count++;
-	  continue;
-	}
-      break;
-    }
-
- __pthread_set_own_extricate_if(self, 0);
-
-  /* Terminate only if the wakeup came from cancellation. */
-  /* Otherwise ignore cancellation because we got the semaphore. */
-
-  if (THREAD_GETMEM(self, p_woken_by_cancel)
-      && THREAD_GETMEM(self, p_cancelstate) == PTHREAD_CANCEL_ENABLE) {
-    THREAD_SETMEM(self, p_woken_by_cancel, 0);
-    __pthread_do_exit(PTHREAD_CANCELED, CURRENT_STACK_FRAME);
+  if (err != 0) {
+    errno = err;
+    return -1;
   }
-  /* We got the semaphore */
   return 0;
 }
 
@@ -62,7 +62,7 @@ int pthread_kill(pthread_t thread, int signo)
   }
   pid = handle->h_descr->p_pid;
   __pthread_unlock(&handle->h_lock);
-  if (kill(pid, signo) == -1)
+  if (__tkill(pid, signo) == -1)
     return errno;
   else
     return 0;
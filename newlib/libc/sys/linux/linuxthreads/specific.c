@@ -20,7 +20,6 @@
 #include "pthread.h"
 #include "internals.h"
 #include "spinlock.h"
-#include "restart.h"
 #include <bits/libc-lock.h>
 
 
@@ -60,7 +59,7 @@ int __pthread_key_create(pthread_key_t * key, destr_function destr)
 strong_alias (__pthread_key_create, pthread_key_create)
 
 /* Reset deleted key's value to NULL in each live thread.
- * NOTE: this executes in the context of the thread manager! */
+ * NOTE: this executes with the list of threads locked! */
 
 struct pthread_key_delete_helper_args {
   /* Damn, we need lexical closures in C! ;) */
@@ -106,23 +105,15 @@ int pthread_key_delete(pthread_key_t key)
 
      Do nothing if no threads have been created yet.  */
 
-  if (__pthread_manager_request != -1)
+  if (__pthread_threads_started)
     {
       struct pthread_key_delete_helper_args args;
-      struct pthread_request request;
 
       args.idx1st = key / PTHREAD_KEY_2NDLEVEL_SIZE;
       args.idx2nd = key % PTHREAD_KEY_2NDLEVEL_SIZE;
-      args.self = 0;
+      args.self = self;
 
-      request.req_thread = self;
-      request.req_kind = REQ_FOR_EACH_THREAD;
-      request.req_args.for_each.arg = &args;
-      request.req_args.for_each.fn = pthread_key_delete_helper;
-
-      TEMP_FAILURE_RETRY(__libc_write(__pthread_manager_request,
-				      (char *) &request, sizeof(request)));
-      suspend(self);
+      __pthread_for_each_thread(&args, pthread_key_delete_helper);
     }
 
   pthread_mutex_unlock(&pthread_keys_mutex);
@@ -13,6 +13,7 @@
 /* GNU Library General Public License for more details.                 */
 
 #include <bits/initspin.h>
+#include "futex.h"
 
 
 /* There are 2 compare and swap synchronization primitives with
@@ -90,12 +91,19 @@ static inline int compare_and_swap(long * ptr, long oldval, long newval,
 #define __compare_and_swap_with_release_semantics __compare_and_swap
 #endif
 
-/* Internal locks */
+/* Internal locks: futex locks on the status word, see futex.h, which spin
+   for a while on SMP before they sleep.  The spinlock word keeps how long
+   the spinning took lately, see spinlock.c.  */
 
 extern void internal_function __pthread_lock(struct _pthread_fastlock * lock,
 					     pthread_descr self);
 extern int __pthread_unlock(struct _pthread_fastlock *lock);
 
+/* Take LOCK, a futex lock found taken, spinning first if SPIN.  */
+extern void internal_function
+__pthread_lock_contended(struct _pthread_fastlock * lock, pthread_descr self,
+			 int spin);
+
 static inline void __pthread_init_lock(struct _pthread_fastlock * lock)
 {
   lock->__status = 0;
@@ -104,72 +112,60 @@ static inline void __pthread_init_lock(struct _pthread_fastlock * lock)
 
 static inline int __pthread_trylock (struct _pthread_fastlock * lock)
 {
-#if defined TEST_FOR_COMPARE_AND_SWAP
-  if (!__pthread_has_cas)
-#endif
-#if !defined HAS_COMPARE_AND_SWAP || defined TEST_FOR_COMPARE_AND_SWAP
-  {
-    return (testandset(&lock->__spinlock) ? EBUSY : 0);
-  }
-#endif
-
-#if defined HAS_COMPARE_AND_SWAP
-  do {
-    if (lock->__status != 0) return EBUSY;
-  } while(! __compare_and_swap(&lock->__status, 0, 1));
-  return 0;
-#endif
+  return __futex_trylock(__futex_word(lock));
 }
 
-/* Variation of internal lock used for pthread_mutex_t, supporting
-   timed-out waits.  Warning: do not mix these operations with the above ones
-   over the same lock object! */
-
-extern void __pthread_alt_lock(struct _pthread_fastlock * lock,
-			       pthread_descr self);
-
-extern int __pthread_alt_timedlock(struct _pthread_fastlock * lock,
-			       pthread_descr self, const struct timespec *abstime);
-
-extern void __pthread_alt_unlock(struct _pthread_fastlock *lock);
-
-static inline void __pthread_alt_init_lock(struct _pthread_fastlock * lock)
+/* Queue locks, for internal locks that many threads contend for.  The
+   waiters line up in a list of nodes on their stacks and each spins, then
+   sleeps, on its own node until the holder before it hands the lock over,
+   so the lock goes round in order and an unlock wakes one thread at most.
+   The status word points to the last node, the spinlock word is as above.
+   The node must be the same for the unlock, and live until then.  */
+
+struct _pthread_queue_node {
+  struct _pthread_queue_node * volatile qn_next;
+  int qn_state;			/* futex word, see spinlock.c */
+  unsigned long long qn_locked_at; /* for the lock statistics */
+};
+
+extern void internal_function
+__pthread_queue_lock(struct _pthread_fastlock * lock,
+		     struct _pthread_queue_node * node);
+extern void internal_function
+__pthread_queue_unlock(struct _pthread_fastlock * lock,
+		       struct _pthread_queue_node * node);
+
+/* Lock statistics, see pthread_lockstats_get_np.  While they are enabled,
+   each thread counts the locks it takes in its descriptor, with the times
+   in units of __pthread_lockstats_clock.  */
+
+/* The time stamp counter in units of 64 ticks where there is one,
+   microseconds otherwise.  */
+static inline unsigned long long __pthread_lockstats_clock(void)
 {
-  lock->__status = 0;
-  lock->__spinlock = __LT_SPINLOCK_INIT;
-}
+#if HP_TIMING_AVAIL
+  hp_timing_t now;
 
-static inline int __pthread_alt_trylock (struct _pthread_fastlock * lock)
-{
-#if defined TEST_FOR_COMPARE_AND_SWAP
-  if (!__pthread_has_cas)
-#endif
-#if !defined HAS_COMPARE_AND_SWAP || defined TEST_FOR_COMPARE_AND_SWAP
-  {
-    int res = EBUSY;
-
-    if (testandset(&lock->__spinlock) == 0)
-      {
-	if (lock->__status == 0)
-	  {
-	    lock->__status = 1;
-	    WRITE_MEMORY_BARRIER();
-	    res = 0;
-	  }
-	lock->__spinlock = __LT_SPINLOCK_INIT;
-      }
-    return res;
-  }
-#endif
+  HP_TIMING_NOW (now);
+  return now >> 6;
+#else
+  struct timeval now;
 
-#if defined HAS_COMPARE_AND_SWAP
-  do {
-    if (lock->__status != 0) return EBUSY;
-  } while(! compare_and_swap(&lock->__status, 0, 1, &lock->__spinlock));
-  return 0;
+  __gettimeofday (&now, NULL);
+  return now.tv_sec * 1000000ULL + now.tv_usec;
 #endif
 }
 
+/* Count a lock taken by SELF (NULL if not known yet), which found it taken
+   at WAITED_SINCE unless that is 0 and got it by spinning if SPUN.  */
+extern void __pthread_lockstats_locked(pthread_descr self,
+				       unsigned long long waited_since,
+				       int spun);
+
+/* Count a lock released by SELF after holding it for HELD.  */
+extern void __pthread_lockstats_released(pthread_descr self,
+					 unsigned long long held);
+
 /* Operations on pthread_atomic, which is defined in internals.h */
 
 static inline long atomic_increment(struct pthread_atomic *pa)
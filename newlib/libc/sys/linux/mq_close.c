@@ -2,10 +2,7 @@
 
 #include <mqueue.h>
 #include <errno.h>
-#include <sys/sem.h>
-#define _LIBC 1
-#include <sys/lock.h>
-#undef _LIBC
+#include <unistd.h>
 
 #include "mqlocal.h"
 
@@ -13,9 +10,9 @@ int
 mq_close (mqd_t msgid)
 {
   struct libc_mq *info;
-  struct sembuf sb0 = {0, -1, 0};
-  int rc;
-  int semid;
+
+  if (!MQ_IS_SHM (msgid))
+    return close ((int)msgid);
 
   info = __find_mq (msgid);
 
@@ -25,24 +22,6 @@ mq_close (mqd_t msgid)
       return -1;
     }
 
-  /* lock message queue */
-  semid = info->semid;
-  rc = semop (semid, &sb0, 1);
-
-  if (rc == 0)
-    {
-      __cleanup_mq (msgid);
-      
-      /* unlock message queue */
-      sb0.sem_op = 1;
-      semop (semid, &sb0, 1);
-    }
-
-  return rc;
+  __cleanup_mq (msgid);
+  return 0;
 }
-      
-
-
-
-
-
@@ -2,21 +2,25 @@
 
 #include <mqueue.h>
 #include <errno.h>
-#include <sys/sem.h>
-#include <string.h>
-#define _LIBC 1
-#include <sys/lock.h>
-#undef _LIBC
 
 #include "mqlocal.h"
 
 int
 mq_getattr (mqd_t msgid, struct mq_attr *mqstat)
 {
+  struct __mq_kattr kattr;
   struct libc_mq *info;
-  struct sembuf sb0 = {0, -1, 0};
-  int num_msgs;
-  int rc = 0;
+
+  if (!MQ_IS_SHM (msgid))
+    {
+      if (__mq_kgetsetattr (msgid, NULL, &kattr) != 0)
+	return -1;
+      mqstat->mq_flags = kattr.mq_flags;
+      mqstat->mq_maxmsg = kattr.mq_maxmsg;
+      mqstat->mq_msgsize = kattr.mq_msgsize;
+      mqstat->mq_curmsgs = kattr.mq_curmsgs;
+      return 0;
+    }
 
   info = __find_mq (msgid);
 
@@ -26,27 +30,10 @@ mq_getattr (mqd_t msgid, struct mq_attr *mqstat)
       return -1;
     }
 
-  /* temporarily lock message queue */
-  semop (info->semid, &sb0, 1);
-
-  num_msgs = semctl (info->semid, 3, GETVAL);
-  if (num_msgs >= 0)
-    {
-      memcpy (mqstat, info->attr, sizeof(struct mq_attr));
-      mqstat->mq_curmsgs = num_msgs;
-    }
-  else
-    rc = -1;
-
-  /* release message queue */
-  sb0.sem_op = 1;
-  semop (info->semid, &sb0, 1);
-
-  return rc;
+  /* the messages sent that no receiver has taken yet */
+  mqstat->mq_flags = info->flags;
+  mqstat->mq_maxmsg = info->shm->maxmsg;
+  mqstat->mq_msgsize = info->shm->msgsize;
+  mqstat->mq_curmsgs = *(volatile int *)&info->shm->avail;
+  return 0;
 }
-      
-
-
-
-
-
@@ -2,21 +2,68 @@
 
 #include <mqueue.h>
 #include <errno.h>
+#include <signal.h>
+#include <string.h>
 #include <machine/weakalias.h>
 
 #include "mqlocal.h"
 
+/* SIGEV_NONE and SIGEV_SIGNAL notification.  SIGEV_THREAD needs a thread
+   to run the function in and is left to the mq_notify of linuxthreads.  */
+
 int
 __libc_mq_notify (mqd_t msgid, const struct sigevent *notification)
 {
-  errno = ENOSYS;
-  return -1;
-}
-weak_alias (__libc_mq_notify, mq_notify)
+  struct __mq_ksigevent ksev;
+  struct libc_mq *info;
 
-      
+  if (notification != NULL)
+    {
+      if (notification->sigev_notify == SIGEV_THREAD)
+	{
+	  errno = ENOSYS;
+	  return -1;
+	}
+      if (notification->sigev_notify != SIGEV_NONE
+	  && (notification->sigev_notify != SIGEV_SIGNAL
+	      || notification->sigev_signo <= 0
+	      || notification->sigev_signo >= NSIG))
+	{
+	  errno = EINVAL;
+	  return -1;
+	}
+    }
 
+  if (!MQ_IS_SHM (msgid))
+    {
+      if (notification == NULL)
+	return __mq_knotify (msgid, NULL);
 
+      memset (&ksev, 0, sizeof(ksev));
+      ksev.sigev_value = notification->sigev_value;
+      ksev.sigev_signo = notification->sigev_signo;
+      ksev.sigev_notify = notification->sigev_notify == SIGEV_SIGNAL
+			  ? MQ_KSIGEV_SIGNAL : MQ_KSIGEV_NONE;
+      return __mq_knotify (msgid, &ksev);
+    }
 
+  info = __find_mq (msgid);
 
+  if (info == NULL)
+    {
+      errno = EBADF;
+      return -1;
+    }
 
+  if (notification == NULL)
+    {
+      __mq_shm_unnotify (info);
+      return 0;
+    }
+
+  return __mq_shm_notify (info,
+			  notification->sigev_notify == SIGEV_SIGNAL
+			  ? notification->sigev_signo : -1,
+			  notification->sigev_value);
+}
+weak_alias (__libc_mq_notify, mq_notify)
@@ -6,8 +6,6 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
-#include <sys/ipc.h>
-#include <sys/sem.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
@@ -27,34 +25,73 @@ static struct	libc_mq *mq_hash[NHASH];   /* Hash list heads for mqopen_infos */
 
 __LOCK_INIT(static, mq_hash_lock);
 
+static mqd_t mq_open_shm (const char *name, int oflag, mode_t mode,
+			  struct mq_attr *user_attr);
+
 mqd_t
 mq_open (const char *name, int oflag, ...)
 {
-  MSG *wrbuf = NULL;
-  MSG *rdbuf = NULL;
-  int msgqid = -1;
-  int rc = -1;
+  struct __mq_kattr kattr;
+  struct mq_attr *user_attr = NULL;
+  mode_t mode = 0;
+  mqd_t mq;
+  int saved_errno;
+
+  if (oflag & O_CREAT)
+    {
+      va_list list;
+      va_start (list, oflag);
+
+      mode = (mode_t)va_arg (list, int);
+      user_attr = va_arg(list,struct mq_attr *);
+      va_end (list);
+    }
+
+  /* ignore opening slash if present */
+  if (*name == '/')
+    ++name;
+
+  /* use the kernel's queues unless it is known to have none */
+  if (__mq_native != 0)
+    {
+      if (user_attr != NULL)
+	{
+	  memset (&kattr, 0, sizeof(kattr));
+	  kattr.mq_maxmsg = user_attr->mq_maxmsg;
+	  kattr.mq_msgsize = user_attr->mq_msgsize;
+	}
+
+      saved_errno = errno;
+      mq = __mq_kopen (name, oflag, mode, user_attr != NULL ? &kattr : NULL);
+      if (mq != (mqd_t)-1 || errno != ENOSYS)
+	{
+	  __mq_native = 1;
+	  return mq;
+	}
+      __mq_native = 0;
+      errno = saved_errno;
+    }
+
+  return mq_open_shm (name, oflag, mode, user_attr);
+}
+
+static mqd_t
+mq_open_shm (const char *name, int oflag, mode_t mode,
+	     struct mq_attr *user_attr)
+{
+  struct mq_shm *shm = (struct mq_shm *)MAP_FAILED;
+  struct libc_mq *info = NULL;
+  struct timespec tms;
+  struct stat st;
+  long maxmsg = MQ_DEFAULT_MAXMSG;
+  long msgsize = MQ_DEFAULT_MSGSIZE;
+  size_t size = 0;
   int fd = -1;
-  int semid = -1;
   int created = 0;
-  key_t key = (key_t)-1;
-  struct mq_attr *attr = (struct mq_attr *)MAP_FAILED;
-  struct sembuf sb = {0, 0, 0};
-  mode_t mode = 0;
-  int size;
   int i, index, saved_errno;
   char *real_name;
-  char *ptr;
-  struct mq_attr *user_attr = NULL;
-  struct libc_mq *info;
-  union semun arg;
-  
-  /* ignore opening slash if present */
-  if (*name == '/')
-    ++name;  
-  size = strlen(name);
 
-  if ((real_name = (char *)malloc (size + sizeof(MSGQ_PREFIX))) == NULL ||
+  if ((real_name = __mq_shm_path (name)) == NULL ||
       (info = (struct libc_mq *)malloc (sizeof(struct libc_mq))) == NULL)
     {
       errno = ENOSPC;
@@ -62,215 +99,128 @@ mq_open (const char *name, int oflag, ...)
 	free (real_name);
       return (mqd_t)-1;
     }
-  
-  /* use given name to create shared memory file name - we convert any
-     slashes to underscores so we don't have to create directories */
-  memcpy (real_name, MSGQ_PREFIX, sizeof(MSGQ_PREFIX) - 1);
-  memcpy (real_name + sizeof(MSGQ_PREFIX) - 1, name, size + 1);
-  ptr = real_name + sizeof(MSGQ_PREFIX) - 1;
-  for (i = 0; i < size; ++i)
-    {
-      if (*ptr == '/')
-	*ptr = '_';
-      ++ptr;
-    }
 
-  /* open shared memory file based on msg queue open flags and then use memory
-     file to create a unique key to use for semaphores, etc.. */
   if (oflag & O_CREAT)
     {
-      va_list list;
-      va_start (list, oflag);
-
-      saved_errno = errno;
-      mode = (mode_t)va_arg (list, int);
-      user_attr = va_arg(list,struct mq_attr *);
-      va_end (list);
+      if (user_attr != NULL)
+	{
+	  maxmsg = user_attr->mq_maxmsg;
+	  msgsize = user_attr->mq_msgsize;
+	}
+      if ((size = __mq_shm_size (maxmsg, msgsize)) == 0)
+	{
+	  errno = EINVAL;
+	  goto fail;
+	}
 
       /* attempt to open the shared memory file for exclusive create so we know
 	 whether we are the owners or not */
+      saved_errno = errno;
       fd = open (real_name, O_RDWR | O_CREAT | O_EXCL, mode);
-      if (fd < 0 && (oflag & O_EXCL))
-	{
-	  /* we failed and the user wanted exclusive create */
-	  free (real_name);
-	  free (info);
-	  return (mqd_t)-1;
-	}
-      errno = saved_errno;
-      /* check if we created the file or not */
       if (fd >= 0)
-        created = 1;
+	created = 1;
+      else if (errno != EEXIST || (oflag & O_EXCL))
+	goto fail;
+      else
+	errno = saved_errno;
     }
-	  
-  if (fd < 0)
-    fd = open (real_name, O_RDWR, 0);
 
-  if (fd >= 0)
-    key = ftok(real_name, 255);
-
-  if (key != (key_t)-1)
-    /* memory map the shared memory file so we have a global shared data area to use */
-    attr = (struct mq_attr *)mmap (0, sizeof(struct mq_attr), PROT_READ | PROT_WRITE,
-				   MAP_SHARED, fd, 0);
-  
-  if (attr != (struct mq_attr *)MAP_FAILED)
+  if (fd < 0 && (fd = open (real_name, O_RDWR, 0)) < 0)
+    goto fail;
+
+  tms.tv_sec = 0;
+  tms.tv_nsec = 10000000; /* 10 milliseconds */
+
+  if (created)
     {
-      /* we need semaphores to prevent multi-process race conditions on the
-	 shared storage which contains a shared structure.  The following
-	 are the ones we need.
-	 
-	 0 = open semaphore
-	 1 = number of opens
-	 2 = number of writes left until queue is full
-	 3 = number of reads available in queue
-	 4 = notify semaphore 
-	 5 = number of readers */
-      arg.val = 0;
-      /* make sure the creator of the shared memory file also is the creator of the
-	 semaphores...this will ensure that it also creates the message queue */
-      if (created)
-	{
-	  saved_errno = errno;
-	  semid = semget (key, 6, IPC_CREAT | IPC_EXCL | mode);
-	  errno = saved_errno;
-	  /* now that we have created the semaphore, we should initialize it */
-	  if (semid != -1)
-	    semctl (semid, 0, SETVAL, arg);
-	}
-      else
+      /* the new file reads as zeroes, which makes empty rings */
+      if (ftruncate (fd, size) != 0)
+	goto fail;
+    }
+  else
+    {
+      /* if we didn't create the file we may have gotten ahead of its
+	 creator, so wait for it to size the file.  We impose a time limit
+	 to ensure something terrible hasn't gone wrong. */
+      for (i = 0; ; ++i)
 	{
-	  /* if we didn't create the shared memory file but have gotten to here, we want
-	     to ensure we haven't gotten ahead of the creator temporarily so we will
-	     loop until the semaphore exists.  This ensures that the creator will be the
-	     one to create the message queue with the correct mode and we will be blocked
-	     by the open semaphore 0.  We impose a time limit to ensure something terrible
-	     hasn't gone wrong. */
-	  struct timespec tms;
-	  int i;
-
-	  tms.tv_sec = 0;
-	  tms.tv_nsec = 10000; /* 10 microseconds */
-	  for (i = 0; i < 100; ++i)
+	  if (fstat (fd, &st) != 0)
+	    goto fail;
+	  if ((size_t)st.st_size >= sizeof(struct mq_shm))
+	    break;
+	  if (i == 100)
 	    {
-	      if ((semid = semget (key, 6, 0)) != -1)
-		break;
-	      /* sleep in case we our a higher priority process */
-	      nanosleep (&tms, NULL);
+	      errno = ENOENT;
+	      goto fail;
 	    }
+	  nanosleep (&tms, NULL);
 	}
+      size = st.st_size;
     }
 
-  if (semid != -1)
-    {
-      /* acquire main open semaphore if we didn't create it */
-      if (!created)
-	{
-	  sb.sem_op = -1;
-	  rc = semop (semid, &sb, 1);
-	}
-      else
-	rc = 0; /* need this to continue below */
-    }
-      
-  if (rc == 0)
+  /* memory map the shared memory file so we have a global shared data area to use */
+  shm = (struct mq_shm *)mmap (0, size, PROT_READ | PROT_WRITE,
+			       MAP_SHARED, fd, 0);
+  if (shm == (struct mq_shm *)MAP_FAILED)
+    goto fail;
+
+  if (created)
+    __mq_shm_init (shm, maxmsg, msgsize);
+  else
     {
-      if (created)
+      /* and then for it to set up the header */
+      saved_errno = errno;
+      for (i = 0; !*(volatile int *)&shm->ready; ++i)
 	{
-	  /* the creator must get here first so the message queue will be created */
-	  msgqid = msgget (key, IPC_CREAT | mode); 
-	  if (msgqid >= 0)
+	  if (i == 100)
 	    {
-	      /* we have created the message queue so check and set the attributes */
-	      if ((wrbuf = (MSG *)malloc (user_attr->mq_msgsize + sizeof(int))) == NULL ||
-		  (rdbuf = (MSG *)malloc (user_attr->mq_msgsize + sizeof(int))) == NULL ||
-		  user_attr == NULL || user_attr->mq_msgsize <= 0 || user_attr->mq_maxmsg <= 0)
-		{
-		  /* we're out of space and we created the message queue so we should
-		     try to remove it */
-		  msgctl (msgqid, IPC_RMID, NULL);
-		  msgqid = -1; /* allow clean up to occur below */
-		  if (wrbuf && rdbuf)
-		    errno = EINVAL;
-		  else
-		    errno = ENOSPC;
-		}
-	      else /* valid attributes */
-		{
-		  write (fd, user_attr, sizeof(struct mq_attr));
-		  attr->mq_curmsgs = 0;
-		  attr->mq_flags = oflag & O_NONBLOCK;
-		  arg.val = 0;
-		  semctl (semid, 1, SETVAL, arg); /* number of opens starts at 0 */
-		  semctl (semid, 3, SETVAL, arg); /* number of reads available starts at 0 */
-		  semctl (semid, 5, SETVAL, arg); /* number of readers starts at 0 */
-		  arg.val = 1;
-		  semctl (semid, 4, SETVAL, arg); /* notify semaphore */
-		  arg.val = user_attr->mq_maxmsg;
-		  semctl (semid, 2, SETVAL, arg); /* number of writes left starts at mq_maxmsg */
-		}
+	      errno = ENOENT;
+	      goto fail;
 	    }
+	  __mq_futex (&shm->ready, MQ_FUTEX_WAIT, 0, &tms);
 	}
-      else /* just open it */
-        {
-	  msgqid = msgget (key, 0);
-	  wrbuf = (MSG *)malloc (attr->mq_msgsize + sizeof(int));
-	  rdbuf = (MSG *)malloc (attr->mq_msgsize + sizeof(int));
-        }
-      
-      /* release semaphore acquired earlier */
-      sb.sem_op = 1;
-      semop (semid, &sb, 1);
-    }
-
-  /* if we get here and we haven't got a message queue id, then we need to clean up 
-     our mess and return failure */
-  if (msgqid < 0)
-    {
-      if (fd >= 0)
-	close (fd);
-      if (attr != (struct mq_attr *)MAP_FAILED)
-	munmap (attr, sizeof(struct mq_attr));
-      if (created)
+      errno = saved_errno;
+      if (size < __mq_shm_size (shm->maxmsg, shm->msgsize))
 	{
-	  unlink (real_name);
-	  if (semid != -1)
-	    semctl (semid, 0, IPC_RMID);
+	  errno = EINVAL;
+	  goto fail;
 	}
-      free (real_name);
-      free (info);
-      if (wrbuf)
-	free (wrbuf);
-      if (rdbuf)
-	free (rdbuf);
-      return (mqd_t)-1;
     }
 
-  /* we are successful so register the message queue */
+  free (real_name);
 
-  /* up the count of msg queue opens */
-  sb.sem_op = 1;
-  sb.sem_num = 1;
-  semop (semid, &sb, 1);
-
-  /* success, translate into index into mq_info array */  
+  /* success, translate into index into mq_info array */
   __lock_acquire(mq_hash_lock);
-  index = mq_index++;
+  index = (mq_index++ & (MQ_SHM_BIT - 1)) | MQ_SHM_BIT;
   info->index = index;
-  info->msgqid = msgqid;
-  info->name = real_name;
-  info->semid = semid;
   info->fd = fd;
   info->oflag = oflag;
-  info->wrbuf = wrbuf;
-  info->rdbuf = rdbuf;
+  info->flags = oflag & O_NONBLOCK;
+  info->th = 0;
+  info->notifying = 0;
+  info->size = size;
+  info->shm = shm;
+  info->sigevent = NULL;
   info->cleanup_notify = NULL;
   info->next = mq_hash[LOCHASH(index)];
-  info->attr = attr;
   mq_hash[LOCHASH(index)] = info;
   __lock_release(mq_hash_lock);
 
   return (mqd_t)index;
+
+ fail:
+  /* clean up our mess and return failure */
+  saved_errno = errno;
+  if (shm != (struct mq_shm *)MAP_FAILED)
+    munmap (shm, size);
+  if (fd >= 0)
+    close (fd);
+  if (created)
+    unlink (real_name);
+  free (real_name);
+  free (info);
+  errno = saved_errno;
+  return (mqd_t)-1;
 }
 
 struct libc_mq *
@@ -278,6 +228,9 @@ __find_mq (mqd_t mq)
 {
   struct libc_mq *ptr;
 
+  if (!MQ_IS_SHM (mq))
+    return NULL;
+
   __lock_acquire(mq_hash_lock);
 
   ptr = mq_hash[LOCHASH((int)mq)];
@@ -293,14 +246,12 @@ __find_mq (mqd_t mq)
 
   return ptr;
 }
-      
+
 void
 __cleanup_mq (mqd_t mq)
 {
   struct libc_mq *ptr;
   struct libc_mq *prev;
-  int semid;
-  struct sembuf sb = {0, 0, 0};
 
   __lock_acquire(mq_hash_lock);
 
@@ -317,30 +268,18 @@ __cleanup_mq (mqd_t mq)
 
   if (ptr != NULL)
     {
+      if (ptr->notifying)
+	__mq_shm_unnotify (ptr);
       if (ptr->cleanup_notify != NULL)
 	ptr->cleanup_notify (ptr);
       if (prev != NULL)
 	prev->next = ptr->next;
       else
-	mq_hash[LOCHASH((int)mq)] = NULL;
-      munmap (ptr->attr, sizeof(struct mq_attr));
+	mq_hash[LOCHASH((int)mq)] = ptr->next;
+      munmap (ptr->shm, ptr->size);
       close (ptr->fd);
-      free (ptr->name);
-      free (ptr->wrbuf);
-      free (ptr->rdbuf);
-      semid = ptr->semid;
       free (ptr);
-      /* lower the count of msg queue opens */
-      sb.sem_op = -1;
-      sb.sem_num = 1;
-      sb.sem_flg = IPC_NOWAIT;
-      semop (semid, &sb, 1);
     }
 
   __lock_release(mq_hash_lock);
 }
-
-
-
-
-
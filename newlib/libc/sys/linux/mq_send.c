@@ -3,26 +3,24 @@
 #include <mqueue.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <sys/ipc.h>
-#include <sys/sem.h>
-#include <string.h>
-#include <stdlib.h>
-#define _LIBC 1
-#include <sys/lock.h>
-#undef _LIBC
+#include <time.h>
 
 #include "mqlocal.h"
 
-__LOCK_INIT(static, mq_wrbuf_lock);
-
 int
-mq_send (mqd_t msgid, const char *msg, size_t msg_len, unsigned int msg_prio)
+mq_timedsend (mqd_t msgid, const char *msg, size_t msg_len,
+	      unsigned int msg_prio, const struct timespec *abs_timeout)
 {
   struct libc_mq *info;
-  struct sembuf sb2 = {2, -1, 0};
-  struct sembuf sb3 = {3, 1, 0};
-  int rc;
-  int ipcflag;
+
+  if (msg_prio >= MQ_PRIO_MAX)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (!MQ_IS_SHM (msgid))
+    return __mq_ktimedsend (msgid, msg, msg_len, msg_prio, abs_timeout);
 
   info = __find_mq (msgid);
 
@@ -32,41 +30,17 @@ mq_send (mqd_t msgid, const char *msg, size_t msg_len, unsigned int msg_prio)
       return -1;
     }
 
-  if (msg_len > info->attr->mq_msgsize)
+  if (msg_len > info->shm->msgsize)
     {
       errno = EMSGSIZE;
       return -1;
     }
 
-  if (msg_prio > MQ_PRIO_MAX)
-    {
-      errno = EINVAL;
-      return -1;
-    }
-
-  __lock_acquire (mq_wrbuf_lock);
-
-  memcpy (info->wrbuf->text, msg, msg_len);
-  info->wrbuf->type = (MQ_PRIO_MAX - msg_prio);
-
-  ipcflag = (info->attr->mq_flags & O_NONBLOCK) ? IPC_NOWAIT : 0;
-  sb2.sem_flg = ipcflag;
-
-  /* check to see if max msgs are on queue */
-  rc = semop (info->semid, &sb2, 1);
-
-  if (rc == 0)
-    rc = msgsnd (info->msgqid, info->wrbuf, msg_len, ipcflag);
-
-  if (rc == 0)
-    semop (info->semid, &sb3, 1);  /* increment number of reads */
-
-  __lock_release (mq_wrbuf_lock);
-  return rc;
+  return __mq_shm_send (info, msg, msg_len, msg_prio, abs_timeout);
 }
-      
-
-
-
-
 
+int
+mq_send (mqd_t msgid, const char *msg, size_t msg_len, unsigned int msg_prio)
+{
+  return mq_timedsend (msgid, msg, msg_len, msg_prio, NULL);
+}
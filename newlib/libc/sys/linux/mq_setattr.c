@@ -1,22 +1,33 @@
 /* Copyright 2002, Red Hat Inc. */
 
 #include <mqueue.h>
+#include <fcntl.h>
 #include <errno.h>
-#include <sys/sem.h>
 #include <string.h>
-#define _LIBC 1
-#include <sys/lock.h>
-#undef _LIBC
 
 #include "mqlocal.h"
 
 int
 mq_setattr (mqd_t msgid, const struct mq_attr *mqstat, struct mq_attr *omqstat)
 {
+  struct __mq_kattr kattr, okattr;
   struct libc_mq *info;
-  struct sembuf sb0 = {0, -1, 0};
-  int num_msgs;
-  int rc = 0;
+
+  if (!MQ_IS_SHM (msgid))
+    {
+      memset (&kattr, 0, sizeof(kattr));
+      kattr.mq_flags = mqstat->mq_flags;
+      if (__mq_kgetsetattr (msgid, &kattr, &okattr) != 0)
+	return -1;
+      if (omqstat != NULL)
+	{
+	  omqstat->mq_flags = okattr.mq_flags;
+	  omqstat->mq_maxmsg = okattr.mq_maxmsg;
+	  omqstat->mq_msgsize = okattr.mq_msgsize;
+	  omqstat->mq_curmsgs = okattr.mq_curmsgs;
+	}
+      return 0;
+    }
 
   info = __find_mq (msgid);
 
@@ -26,34 +37,12 @@ mq_setattr (mqd_t msgid, const struct mq_attr *mqstat, struct mq_attr *omqstat)
       return -1;
     }
 
-  /* temporarily lock message queue */
-  semop (info->semid, &sb0, 1);
-
   /* make copy of old structure */
   if (omqstat != NULL)
-    {
-      num_msgs = semctl (info->semid, 3, GETVAL);
-      if (num_msgs >= 0)
-	{
-	  memcpy (omqstat, info->attr, sizeof(struct mq_attr));
-	  omqstat->mq_curmsgs = num_msgs;
-	}
-      else
-	rc = -1;
-    }
-  
-  /* only the mq_flags field can be changed */
-  info->attr->mq_flags = mqstat->mq_flags;
+    mq_getattr (msgid, omqstat);
 
-  /* release message queue */
-  sb0.sem_op = 1;
-  semop (info->semid, &sb0, 1);
+  /* only the mq_flags field can be changed, and only for this descriptor */
+  info->flags = mqstat->mq_flags & O_NONBLOCK;
 
-  return rc;
+  return 0;
 }
-      
-
-
-
-
-
@@ -0,0 +1,385 @@
+/* libc/sys/linux/mq_shm.c - message queues in shared memory */
+
+#include <mqueue.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <machine/atomic.h>
+
+#include "mqlocal.h"
+
+/*
+ * Where the kernel has no message queues, a queue is a file under
+ * /dev/shm that every process which opens it maps, and nothing in it is
+ * locked.
+ *
+ * The free counter holds a token for each message that may still be
+ * sent, mq_maxmsg of them to begin with, and avail one for each message
+ * that has been sent and not yet taken.  A sender takes a free token,
+ * claims the tail cell of the ring of its priority by moving the tail on
+ * by one, copies the message in, publishes the cell and gives an avail
+ * token.  A receiver takes an avail token, claims the head cell of the
+ * highest priority ring whose head cell is published, copies the message
+ * out, hands the cell back and gives a free token.  Since no more than
+ * mq_maxmsg messages are ever in the rings, none of them ever fills up.
+ *
+ * The turn of a cell says who may have it next.  For the claim of the
+ * cell by the tail or head at position POS of the ring, LAP being POS
+ * less the cell's index, it is LAP while the cell waits for a sender and
+ * LAP + 1 while it waits for a receiver, who leaves it at LAP plus the
+ * size of the ring for the sender of the next lap.  So a file fresh from
+ * ftruncate, all zeroes, is a set of empty rings, and pages of cells that
+ * are never used are never allocated.
+ *
+ * Whoever finds a counter at zero sleeps on it as a futex, and whoever
+ * gives a token wakes one sleeper if there are any.
+ */
+
+/* How often to look for a claimed cell that is not yet published or
+   handed back before yielding the processor to whoever holds it */
+#define MQ_SPIN_COUNT	100
+
+static inline void
+mq_barrier (void)
+{
+  __asm__ __volatile__ ("" : : : "memory");
+}
+
+static inline void
+mq_spin (int *spins)
+{
+  if (++*spins < MQ_SPIN_COUNT)
+    atomic_delay ();
+  else
+    {
+      sched_yield ();
+      *spins = 0;
+    }
+}
+
+static inline struct mq_cell *
+mq_cell (struct mq_shm *shm, unsigned int prio, unsigned int pos)
+{
+  size_t n = (size_t) prio * shm->ring_size + (pos & (shm->ring_size - 1));
+
+  return (struct mq_cell *) ((char *) (shm + 1) + n * shm->cell_size);
+}
+
+char *
+__mq_shm_path (const char *name)
+{
+  size_t size = strlen (name);
+  char *real_name, *ptr;
+
+  if ((real_name = (char *)malloc (size + sizeof(MSGQ_PREFIX))) == NULL)
+    return NULL;
+
+  /* use given name to create shared memory file name - we convert any
+     slashes to underscores so we don't have to create directories */
+  memcpy (real_name, MSGQ_PREFIX, sizeof(MSGQ_PREFIX) - 1);
+  memcpy (real_name + sizeof(MSGQ_PREFIX) - 1, name, size + 1);
+  for (ptr = real_name + sizeof(MSGQ_PREFIX) - 1; *ptr != '\0'; ++ptr)
+    if (*ptr == '/')
+      *ptr = '_';
+
+  return real_name;
+}
+
+static unsigned int
+mq_ring_size (long maxmsg)
+{
+  unsigned int ring_size = 1;
+
+  while (ring_size < maxmsg)
+    ring_size <<= 1;
+  return ring_size;
+}
+
+static unsigned int
+mq_cell_size (long msgsize)
+{
+  return (MQ_CELL_TEXT + msgsize + 7) & ~7;
+}
+
+/* The size of the file of a queue, or 0 if it would be too big */
+size_t
+__mq_shm_size (long maxmsg, long msgsize)
+{
+  size_t ring_size, cell_size;
+
+  if (maxmsg <= 0 || maxmsg > INT_MAX / 2
+      || msgsize <= 0 || msgsize > INT_MAX / 2)
+    return 0;
+
+  ring_size = mq_ring_size (maxmsg);
+  cell_size = mq_cell_size (msgsize);
+  if (ring_size > (SIZE_MAX - sizeof (struct mq_shm))
+		  / MQ_PRIO_MAX / cell_size)
+    return 0;
+
+  return sizeof (struct mq_shm) + MQ_PRIO_MAX * ring_size * cell_size;
+}
+
+/* Set up the header of a queue in a file just sized with ftruncate, and
+   wake whoever opened it meanwhile.  */
+void
+__mq_shm_init (struct mq_shm *shm, long maxmsg, long msgsize)
+{
+  int saved_errno = errno;
+
+  shm->maxmsg = maxmsg;
+  shm->msgsize = msgsize;
+  shm->ring_size = mq_ring_size (maxmsg);
+  shm->cell_size = mq_cell_size (msgsize);
+  shm->free = maxmsg;
+  mq_barrier ();
+  shm->ready = 1;
+  __mq_futex (&shm->ready, MQ_FUTEX_WAKE, INT_MAX, NULL);
+  errno = saved_errno;
+}
+
+/* Take a token from COUNT, sleeping while there is none unless NONBLOCK
+   or until ABSTIME.  Returns 0 or the error number.  */
+static int
+mq_take (int *count, int *waiters, int nonblock,
+	 const struct timespec *abstime)
+{
+  struct timespec reltime;
+  struct timeval now;
+  int c, err, saved_errno;
+
+  for (;;)
+    {
+      c = *(volatile int *) count;
+      if (c > 0)
+	{
+	  if (__arch_compare_and_exchange_val_32_acq (count, c - 1, c) == c)
+	    return 0;
+	  continue;
+	}
+
+      if (nonblock)
+	return EAGAIN;
+
+      if (abstime != NULL)
+	{
+	  if (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
+	    return EINVAL;
+	  gettimeofday (&now, NULL);
+	  reltime.tv_sec = abstime->tv_sec - now.tv_sec;
+	  reltime.tv_nsec = abstime->tv_nsec - now.tv_usec * 1000;
+	  if (reltime.tv_nsec < 0)
+	    {
+	      reltime.tv_nsec += 1000000000;
+	      reltime.tv_sec--;
+	    }
+	  if (reltime.tv_sec < 0)
+	    return ETIMEDOUT;
+	}
+
+      atomic_increment (waiters);
+      saved_errno = errno;
+      err = 0;
+      if (__mq_futex (count, MQ_FUTEX_WAIT, 0,
+		      abstime != NULL ? &reltime : NULL) != 0)
+	err = errno;
+      errno = saved_errno;
+      atomic_decrement (waiters);
+
+      /* the time is checked again at the top */
+      if (err == EINTR)
+	return EINTR;
+    }
+}
+
+/* Give a token to COUNT.  Returns how many it had before.  */
+static int
+mq_give (int *count, int *waiters)
+{
+  int c = atomic_exchange_and_add (count, 1);
+  int saved_errno;
+
+  if (*(volatile int *) waiters > 0)
+    {
+      saved_errno = errno;
+      __mq_futex (count, MQ_FUTEX_WAKE, 1, NULL);
+      errno = saved_errno;
+    }
+  return c;
+}
+
+/* Notify the process registered with mq_notify, if any, that a message
+   has arrived in the empty queue, and unregister it.  */
+static void
+mq_notify_send (struct mq_shm *shm)
+{
+  union sigval value;
+  int pid, signo, saved_errno;
+
+  pid = *(volatile int *) &shm->notify_pid;
+  if (pid <= 0)
+    return;
+
+  /* the signal and value stay put as long as the process is registered */
+  signo = shm->notify_signo;
+  value = shm->notify_value;
+  if (__arch_compare_and_exchange_val_32_acq (&shm->notify_pid, 0, pid)
+      != pid)
+    return;
+
+  saved_errno = errno;
+  if (signo > 0)
+    sigqueue (pid, signo, value);
+  else if (signo == 0)
+    {
+      atomic_increment (&shm->notify_seq);
+      __mq_futex (&shm->notify_seq, MQ_FUTEX_WAKE, INT_MAX, NULL);
+    }
+  errno = saved_errno;
+}
+
+int
+__mq_shm_send (struct libc_mq *info, const char *msg, size_t msg_len,
+	       unsigned int msg_prio, const struct timespec *abstime)
+{
+  struct mq_shm *shm = info->shm;
+  struct mq_ring *ring = &shm->ring[msg_prio];
+  struct mq_cell *cell;
+  unsigned int pos, lap;
+  int err, spins = 0;
+
+  err = mq_take (&shm->free, &shm->free_waiters, info->flags & O_NONBLOCK,
+		 abstime);
+  if (err != 0)
+    {
+      errno = err;
+      return -1;
+    }
+
+  /* claim the tail cell, waiting if a receiver still copies out of it */
+  for (;;)
+    {
+      pos = *(volatile unsigned int *) &ring->tail;
+      lap = pos & ~(shm->ring_size - 1);
+      cell = mq_cell (shm, msg_prio, pos);
+      if (*(volatile unsigned int *) &cell->turn == lap)
+	{
+	  if (__arch_compare_and_exchange_val_32_acq (&ring->tail, pos + 1, pos)
+	      == pos)
+	    break;
+	}
+      else if (*(volatile unsigned int *) &ring->tail == pos)
+	mq_spin (&spins);
+    }
+
+  memcpy (cell->text, msg, msg_len);
+  cell->len = msg_len;
+  mq_barrier ();
+  *(volatile unsigned int *) &cell->turn = lap + 1;
+
+  /* a receiver asleep in mq_receive takes precedence over mq_notify */
+  if (mq_give (&shm->avail, &shm->avail_waiters) == 0
+      && *(volatile int *) &shm->avail_waiters == 0)
+    mq_notify_send (shm);
+
+  return 0;
+}
+
+ssize_t
+__mq_shm_receive (struct libc_mq *info, char *msg, size_t msg_len,
+		  unsigned int *msg_prio, const struct timespec *abstime)
+{
+  struct mq_shm *shm = info->shm;
+  struct mq_ring *ring;
+  struct mq_cell *cell;
+  unsigned int pos, lap, len;
+  int prio, diff, err, spins = 0;
+
+  err = mq_take (&shm->avail, &shm->avail_waiters, info->flags & O_NONBLOCK,
+		 abstime);
+  if (err != 0)
+    {
+      errno = err;
+      return -1;
+    }
+
+  /* The token promises a message, but the sender that claimed the head
+     cell of its ring may not have published it yet.  */
+  for (;;)
+    {
+      for (prio = MQ_PRIO_MAX - 1; prio >= 0; --prio)
+	{
+	  ring = &shm->ring[prio];
+	  pos = *(volatile unsigned int *) &ring->head;
+	  lap = pos & ~(shm->ring_size - 1);
+	  cell = mq_cell (shm, prio, pos);
+	  diff = (int) (*(volatile unsigned int *) &cell->turn - (lap + 1));
+	  if (diff == 0)
+	    {
+	      if (__arch_compare_and_exchange_val_32_acq (&ring->head,
+							  pos + 1, pos)
+		  == pos)
+		goto claimed;
+	      ++prio;	/* look at this ring again */
+	    }
+	  else if (diff > 0)
+	    ++prio;	/* the head moved on meanwhile */
+	}
+      mq_spin (&spins);
+    }
+
+ claimed:
+  mq_barrier ();
+  len = cell->len;
+  if (len > msg_len)
+    len = msg_len;
+  memcpy (msg, cell->text, len);
+  mq_barrier ();
+  *(volatile unsigned int *) &cell->turn = lap + shm->ring_size;
+
+  mq_give (&shm->free, &shm->free_waiters);
+
+  if (msg_prio != NULL)
+    *msg_prio = prio;
+  return len;
+}
+
+/* Register this process for notification, with signal SIGNO, or 0 to
+   bump notify_seq instead, or -1 for none.  */
+int
+__mq_shm_notify (struct libc_mq *info, int signo, union sigval value)
+{
+  struct mq_shm *shm = info->shm;
+
+  if (__arch_compare_and_exchange_val_32_acq (&shm->notify_pid, -1, 0) != 0)
+    {
+      errno = EBUSY;
+      return -1;
+    }
+
+  shm->notify_signo = signo;
+  shm->notify_value = value;
+  mq_barrier ();
+  *(volatile int *) &shm->notify_pid = getpid ();
+  info->notifying = 1;
+  return 0;
+}
+
+/* Unregister this process if it is registered for notification */
+void
+__mq_shm_unnotify (struct libc_mq *info)
+{
+  struct mq_shm *shm = info->shm;
+  int pid = getpid ();
+
+  __arch_compare_and_exchange_val_32_acq (&shm->notify_pid, 0, pid);
+  info->notifying = 0;
+}
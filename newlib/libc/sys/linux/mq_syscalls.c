@@ -0,0 +1,82 @@
+/* libc/sys/linux/mq_syscalls.c - message queue and futex system calls */
+
+#include <mqueue.h>
+#include <errno.h>
+#include <time.h>
+#include <machine/syscall.h>
+
+#include "mqlocal.h"
+
+int __mq_native = -1;
+
+#ifdef __NR_mq_open
+
+#define __NR___mq_kopen __NR_mq_open
+#define __NR___mq_kunlink __NR_mq_unlink
+#define __NR___mq_ktimedsend __NR_mq_timedsend
+#define __NR___mq_ktimedreceive __NR_mq_timedreceive
+#define __NR___mq_knotify __NR_mq_notify
+#define __NR___mq_kgetsetattr __NR_mq_getsetattr
+
+_syscall4(mqd_t,__mq_kopen,const char *,name,int,oflag,mode_t,mode,struct __mq_kattr *,attr)
+_syscall1(int,__mq_kunlink,const char *,name)
+_syscall5(int,__mq_ktimedsend,mqd_t,mq,const char *,msg,size_t,msg_len,unsigned int,msg_prio,const struct timespec *,abstime)
+_syscall5(ssize_t,__mq_ktimedreceive,mqd_t,mq,char *,msg,size_t,msg_len,unsigned int *,msg_prio,const struct timespec *,abstime)
+_syscall2(int,__mq_knotify,mqd_t,mq,const struct __mq_ksigevent *,notification)
+_syscall3(int,__mq_kgetsetattr,mqd_t,mq,const struct __mq_kattr *,mqstat,struct __mq_kattr *,omqstat)
+
+#else /* !__NR_mq_open */
+
+/* Built against kernel headers without message queues: the queues in
+   shared memory are all there is.  */
+
+mqd_t
+__mq_kopen (const char *name, int oflag, mode_t mode, struct __mq_kattr *attr)
+{
+  errno = ENOSYS;
+  return (mqd_t)-1;
+}
+
+int
+__mq_kunlink (const char *name)
+{
+  errno = ENOSYS;
+  return -1;
+}
+
+int
+__mq_ktimedsend (mqd_t mq, const char *msg, size_t msg_len,
+		 unsigned int msg_prio, const struct timespec *abstime)
+{
+  errno = ENOSYS;
+  return -1;
+}
+
+ssize_t
+__mq_ktimedreceive (mqd_t mq, char *msg, size_t msg_len,
+		    unsigned int *msg_prio, const struct timespec *abstime)
+{
+  errno = ENOSYS;
+  return -1;
+}
+
+int
+__mq_knotify (mqd_t mq, const struct __mq_ksigevent *notification)
+{
+  errno = ENOSYS;
+  return -1;
+}
+
+int
+__mq_kgetsetattr (mqd_t mq, const struct __mq_kattr *mqstat,
+		  struct __mq_kattr *omqstat)
+{
+  errno = ENOSYS;
+  return -1;
+}
+
+#endif /* __NR_mq_open */
+
+#define __NR___mq_futex __NR_futex
+
+_syscall4(int,__mq_futex,int *,uaddr,int,op,int,val,const struct timespec *,timeout)
@@ -1,39 +1,128 @@
 /* local definitions needed by mq routines */
 
-#include <sys/msg.h>
 #include <signal.h>
+#include <time.h>
 
-/* a message */
-typedef struct
-{
-  unsigned int type;
-  char text[1];
-} MSG; 
+/*
+ * A message queue descriptor is the kernel's own where the kernel has
+ * message queues.  Where it has not, the queues are kept in shared memory
+ * files instead (see mq_shm.c) and their descriptors have MQ_SHM_BIT set,
+ * which no file descriptor has.
+ */
+
+#define MQ_SHM_BIT	0x40000000
+#define MQ_IS_SHM(mq)	(((int)(mq) & MQ_SHM_BIT) != 0)
+
+/* -1 until the first mq_open or mq_unlink has found out, then 1 if the
+   kernel has message queues and 0 if not */
+extern int __mq_native;
+
+/* The kernel's struct mq_attr, which has room for more fields than ours */
+struct __mq_kattr {
+  long mq_flags;
+  long mq_maxmsg;
+  long mq_msgsize;
+  long mq_curmsgs;
+  long __reserved[4];
+};
+
+/* The kernel's struct sigevent, whose notification types differ from
+   those of <signal.h> */
+struct __mq_ksigevent {
+  union sigval sigev_value;
+  int sigev_signo;
+  int sigev_notify;
+  int __pad[(64 - sizeof (union sigval)) / sizeof (int) - 2];
+};
+
+#define MQ_KSIGEV_SIGNAL	0
+#define MQ_KSIGEV_NONE		1
+#define MQ_KSIGEV_THREAD	2
+
+/* What SIGEV_THREAD sends to the netlink socket named in sigev_signo:
+   the NOTIFY_COOKIE_LEN bytes at sival_ptr, the last of them replaced by
+   MQ_NOTIFY_WOKENUP or MQ_NOTIFY_REMOVED */
+#define MQ_NOTIFY_COOKIE_LEN	32
+#define MQ_NOTIFY_WOKENUP	1
+#define MQ_NOTIFY_REMOVED	2
+
+/* The system calls, see mq_syscalls.c.  Those of the message queues fail
+   with ENOSYS where the kernel or its headers lack them.  */
+extern mqd_t __mq_kopen (const char *name, int oflag, mode_t mode,
+			 struct __mq_kattr *attr);
+extern int __mq_kunlink (const char *name);
+extern int __mq_ktimedsend (mqd_t mq, const char *msg, size_t msg_len,
+			    unsigned int msg_prio,
+			    const struct timespec *abstime);
+extern ssize_t __mq_ktimedreceive (mqd_t mq, char *msg, size_t msg_len,
+				   unsigned int *msg_prio,
+				   const struct timespec *abstime);
+extern int __mq_knotify (mqd_t mq, const struct __mq_ksigevent *notification);
+extern int __mq_kgetsetattr (mqd_t mq, const struct __mq_kattr *mqstat,
+			     struct __mq_kattr *omqstat);
+extern int __mq_futex (int *uaddr, int op, int val,
+		       const struct timespec *timeout);
+
+#define MQ_FUTEX_WAIT	0
+#define MQ_FUTEX_WAKE	1
 
-union semun {
-  int val;
-  struct semid_ds *buf;
-  unsigned short  *array;
-} arg;
+/* Default attributes of a queue created without any, the kernel's */
+#define MQ_DEFAULT_MAXMSG	10
+#define MQ_DEFAULT_MSGSIZE	8192
 
 /*
- * One of these structures is malloced to describe any open message queue
- * each time mq_open is called. 
+ * A queue in shared memory: a header, then a ring of cells for each
+ * priority, each ring big enough for all mq_maxmsg messages.  The free
+ * and avail counters are futexes the senders and the receivers sleep on.
+ */
+
+struct mq_ring {
+  unsigned int head;		   /* next cell to receive from */
+  unsigned int tail;		   /* next cell to send into */
+  char pad[64 - 2 * sizeof (unsigned int)];
+};
+
+struct mq_shm {
+  int              ready;          /* futex, nonzero once set up */
+  long             maxmsg;         /* mq_maxmsg */
+  long             msgsize;        /* mq_msgsize */
+  unsigned int     ring_size;      /* cells per ring, a power of 2 */
+  unsigned int     cell_size;      /* bytes per cell */
+  int              free;           /* futex, messages that may be sent */
+  int              free_waiters;   /* senders waiting for free */
+  int              avail;          /* futex, messages that may be received */
+  int              avail_waiters;  /* receivers waiting for avail */
+  int              notify_pid;     /* process to notify, -1 while set */
+  int              notify_signo;   /* signal, 0 to wake notify_seq, -1 none */
+  union sigval     notify_value;   /* value of the signal */
+  int              notify_seq;     /* futex, bumped by each notification */
+  struct mq_ring   ring[MQ_PRIO_MAX] __attribute__ ((aligned (64)));
+};
+
+struct mq_cell {
+  unsigned int     turn;           /* see mq_shm.c */
+  unsigned int     len;            /* length of the message in text */
+  char             text[1];
+};
+
+#define MQ_CELL_TEXT	((size_t) &((struct mq_cell *) 0)->text)
+
+/*
+ * One of these structures is malloced to describe a queue in shared
+ * memory each time mq_open opens one.
  */
 
 struct libc_mq;
 
 struct libc_mq {
   int              index;          /* index of this message queue */
-  int              msgqid;         /* value returned by msgget */
-  int              semid;          /* semaphore id */
   int              fd;             /* fd of shared memory file */
   int              oflag;          /* original open flag used */
-  int              th;             /* thread id for mq_notify */
-  char            *name;           /* name used */
-  MSG             *wrbuf;          /* msg write buffer */
-  MSG             *rdbuf;          /* msg read buffer */
-  struct mq_attr  *attr;           /* pointer to attribute structure */
+  int              flags;          /* mq_flags, O_NONBLOCK or 0 */
+  unsigned long    th;             /* thread id for mq_notify */
+  int              notifying;      /* mq_notify registered through this */
+  size_t           size;           /* size of the shared memory */
+  struct mq_shm   *shm;            /* the shared memory */
   struct sigevent *sigevent;       /* used for mq_notify */
   void (*cleanup_notify)(struct libc_mq *); /* also used for mq_notify */
   struct libc_mq  *next;           /* next info struct in hash table */
@@ -43,5 +132,18 @@ extern struct libc_mq *__find_mq (mqd_t mq);
 extern void __cleanup_mq (mqd_t mq);
 extern void __cleanup_mq_notify (struct libc_mq *ptr);
 
-#define MSGQ_PREFIX "/dev/shm/__MSGQ__"
+/* The queues in shared memory, see mq_shm.c */
+extern char *__mq_shm_path (const char *name);
+extern size_t __mq_shm_size (long maxmsg, long msgsize);
+extern void __mq_shm_init (struct mq_shm *shm, long maxmsg, long msgsize);
+extern int __mq_shm_send (struct libc_mq *info, const char *msg,
+			  size_t msg_len, unsigned int msg_prio,
+			  const struct timespec *abstime);
+extern ssize_t __mq_shm_receive (struct libc_mq *info, char *msg,
+				 size_t msg_len, unsigned int *msg_prio,
+				 const struct timespec *abstime);
+extern int __mq_shm_notify (struct libc_mq *info, int signo,
+			    union sigval value);
+extern void __mq_shm_unnotify (struct libc_mq *info);
 
+#define MSGQ_PREFIX "/dev/shm/__MSGQ__"
@@ -15,8 +15,10 @@
 #define __NR___rt_sigpending __NR_rt_sigpending
 #define __NR___rt_sigprocmask __NR_rt_sigprocmask
 #define __NR___rt_sigsuspend __NR_rt_sigsuspend
+#define __NR___tkill __NR_tkill
 
 _syscall2(int,kill,pid_t,pid,int,sig)
+_syscall2(int,__tkill,pid_t,tid,int,sig)
 _syscall2(__sighandler_t,signal,int,signum,__sighandler_t,handler)
 _syscall0(int,pause)
 _syscall1(unsigned int,alarm,unsigned int,seconds)
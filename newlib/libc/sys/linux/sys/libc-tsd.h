@@ -36,6 +36,7 @@
 		_LIBC_TSD_KEY_MALLOC
 		_LIBC_TSD_KEY_DL_ERROR
 		_LIBC_TSD_KEY_RPC_VARS
+		_LIBC_TSD_KEY_INTL
    All uses must be the literal _LIBC_TSD_* name in the __libc_tsd_* macros.
    Some implementations may not provide any enum at all and instead
    using string pasting in the macros.  */
@@ -23,7 +23,7 @@ _DEFUN (localtime_r, (tim_p, res),
   long offset;
   int hours, mins, secs;
   int year;
-  __tzinfo_type *_CONST tz = __gettzinfo ();
+  __tzlimits_type tzl;
   _CONST int *ip;
 
   res = gmtime_r (tim_p, res);
@@ -31,25 +31,22 @@ _DEFUN (localtime_r, (tim_p, res),
   year = res->tm_year + YEAR_BASE;
   ip = __month_lengths[isleap(year)];
 
-  TZ_LOCK;
-  _tzset_unlocked ();
-  if (_daylight)
+  __tzget_limits (year, &tzl);
+  if (tzl.daylight)
     {
-      if (year == tz->__tzyear || __tzcalc_limits (year))
-	res->tm_isdst = (tz->__tznorth
-	  ? (*tim_p >= tz->__tzrule[0].change
-	  && *tim_p < tz->__tzrule[1].change)
-	  : (*tim_p >= tz->__tzrule[0].change
-	  || *tim_p < tz->__tzrule[1].change));
+      if (tzl.limits)
+	res->tm_isdst = (tzl.north
+	  ? (*tim_p >= tzl.change[0]
+	  && *tim_p < tzl.change[1])
+	  : (*tim_p >= tzl.change[0]
+	  || *tim_p < tzl.change[1]));
       else
 	res->tm_isdst = -1;
     }
   else
     res->tm_isdst = 0;
 
-  offset = (res->tm_isdst == 1
-    ? tz->__tzrule[1].offset
-    : tz->__tzrule[0].offset);
+  offset = (res->tm_isdst == 1 ? tzl.offset[1] : tzl.offset[0]);
 
   hours = (int) (offset / SECSPERHOUR);
   offset = offset % SECSPERHOUR;
@@ -121,7 +118,6 @@ _DEFUN (localtime_r, (tim_p, res),
 	  res->tm_mday = ip[res->tm_mon];
 	}
     }
-  TZ_UNLOCK;
 
   return (res);
 }
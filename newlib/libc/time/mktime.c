@@ -66,6 +66,24 @@ static _CONST int _DAYS_BEFORE_MONTH[12] =
 #define _ISLEAP(y) (((y) % 4) == 0 && (((y) % 100) != 0 || (((y)+1900) % 400) == 0))
 #define _DAYS_IN_YEAR(year) (_ISLEAP(year) ? 366 : 365)
 
+/* Number of days from 1st January 1970 to 1st January of year (since 1900).
+   Uses the days_from_civil() algorithm also used in gmtime_r, see
+   http://howardhinnant.github.io/date_algorithms.html#days_from_civil */
+static long
+_DEFUN(days_to_year, (year),
+     int year)
+{
+  /* January belongs to the era year starting at the previous 1st March. */
+  long y = (long) year + YEAR_BASE - 1 - ADJUSTED_EPOCH_YEAR;
+  long era = (y >= 0 ? y : y - (YEARS_PER_ERA - 1)) / YEARS_PER_ERA;
+  unsigned long erayear = y - era * YEARS_PER_ERA;	/* [0, 399] */
+  /* 1st January is day 306 of the era year */
+  unsigned long eraday = DAYS_PER_YEAR * erayear + erayear / 4 - erayear / 100
+			 + DAYS_PER_YEAR - DAYS_IN_JANUARY - DAYS_IN_FEBRUARY;
+
+  return era * DAYS_PER_ERA + (long) eraday - EPOCH_ADJUSTMENT_DAYS;
+}
+
 static void 
 _DEFUN(validate_structure, (tim_p),
      struct tm *tim_p)
@@ -160,7 +178,7 @@ _DEFUN(mktime, (tim_p),
   time_t tim = 0;
   long days = 0;
   int year, isdst=0;
-  __tzinfo_type *tz = __gettzinfo ();
+  __tzlimits_type tzl;
 
   /* validate structure */
   validate_structure (tim_p);
@@ -182,49 +200,34 @@ _DEFUN(mktime, (tim_p),
       return (time_t) -1;
 
   /* compute days in other years */
-  if ((year = tim_p->tm_year) > 70)
-    {
-      for (year = 70; year < tim_p->tm_year; year++)
-	days += _DAYS_IN_YEAR (year);
-    }
-  else if (year < 70)
-    {
-      for (year = 69; year > tim_p->tm_year; year--)
-	days -= _DAYS_IN_YEAR (year);
-      days -= _DAYS_IN_YEAR (year);
-    }
+  year = tim_p->tm_year;
+  days += days_to_year (year);
 
   /* compute total seconds */
   tim += (days * _SEC_IN_DAY);
 
-  TZ_LOCK;
+  __tzget_limits (tim_p->tm_year + YEAR_BASE, &tzl);
 
-  _tzset_unlocked ();
-
-  if (_daylight)
+  if (tzl.daylight)
     {
       int tm_isdst;
-      int y = tim_p->tm_year + YEAR_BASE;
       /* Convert user positive into 1 */
       tm_isdst = tim_p->tm_isdst > 0  ?  1 : tim_p->tm_isdst;
       isdst = tm_isdst;
 
-      if (y == tz->__tzyear || __tzcalc_limits (y))
+      if (tzl.limits)
 	{
 	  /* calculate start of dst in dst local time and 
 	     start of std in both std local time and dst local time */
-          time_t startdst_dst = tz->__tzrule[0].change
-	    - (time_t) tz->__tzrule[1].offset;
-	  time_t startstd_dst = tz->__tzrule[1].change
-	    - (time_t) tz->__tzrule[1].offset;
-	  time_t startstd_std = tz->__tzrule[1].change
-	    - (time_t) tz->__tzrule[0].offset;
+          time_t startdst_dst = tzl.change[0] - (time_t) tzl.offset[1];
+	  time_t startstd_dst = tzl.change[1] - (time_t) tzl.offset[1];
+	  time_t startstd_std = tzl.change[1] - (time_t) tzl.offset[0];
 	  /* if the time is in the overlap between dst and std local times */
 	  if (tim >= startstd_std && tim < startstd_dst)
 	    ; /* we let user decide or leave as -1 */
           else
 	    {
-	      isdst = (tz->__tznorth
+	      isdst = (tzl.north
 		       ? (tim >= startdst_dst && tim < startstd_std)
 		       : (tim >= startdst_dst || tim < startstd_std));
  	      /* if user committed and was wrong, perform correction, but not
@@ -237,8 +240,7 @@ _DEFUN(mktime, (tim_p),
 		     wrong. The diff is typically one hour, or 3600 seconds,
 		     and should fit in a 16-bit int, even though offset
 		     is a long to accomodate 12 hours. */
-		  int diff = (int) (tz->__tzrule[0].offset
-				    - tz->__tzrule[1].offset);
+		  int diff = (int) (tzl.offset[0] - tzl.offset[1]);
 		  if (!isdst)
 		    diff = -diff;
 		  tim_p->tm_sec += diff;
@@ -272,11 +274,9 @@ _DEFUN(mktime, (tim_p),
 
   /* add appropriate offset to put time in gmt format */
   if (isdst == 1)
-    tim += (time_t) tz->__tzrule[1].offset;
+    tim += (time_t) tzl.offset[1];
   else /* otherwise assume std time */
-    tim += (time_t) tz->__tzrule[0].offset;
-
-  TZ_UNLOCK;
+    tim += (time_t) tzl.offset[0];
 
   /* reset isdst flag to what we have calculated */
   tim_p->tm_isdst = isdst;
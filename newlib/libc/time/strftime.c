@@ -352,6 +352,74 @@ locale, hard-coding the "C" locale settings.
 static _CONST int dname_len[7] =
 {6, 6, 7, 9, 8, 6, 8};
 
+/* Store num at buf like snprintf (buf, bufsiz, "%.<ndigits>d", num) if
+   padc is '0', or "%<ndigits>d" if padc is ' ', and return the length of
+   the result.  Nothing is stored if it doesn't fit.  Used instead of
+   snprintf for the numeric fields, which are the bulk of most formats. */
+static int
+_DEFUN (conv_to_digits, (buf, bufsiz, num, ndigits, padc),
+	CHAR *buf _AND
+	size_t bufsiz _AND
+	int num _AND
+	int ndigits _AND
+	CHAR padc)
+{
+  CHAR tmp[12];
+  int len = 0;
+
+  if (num < 0 || ndigits > 4)
+    return snprintf (buf, bufsiz, padc == CQ('0') ? CQ("%.*d") : CQ("%*d"),
+		     ndigits, num);
+  do
+    {
+      tmp[len++] = CQ('0') + num % 10;
+      num /= 10;
+    }
+  while (num);
+  while (len < ndigits)
+    tmp[len++] = padc;
+  if ((size_t) len >= bufsiz)
+    return len;
+  for (num = 0; num < len; ++num)
+    buf[num] = tmp[len - 1 - num];
+  return len;
+}
+
+/* Store the first n of the fields a, b and c at buf, separated by sep,
+   like snprintf (buf, bufsiz, "%.2d:%.2d:%.2d", a, b, c) with sep ':'.
+   Returns -1 if the result doesn't fit. */
+static int
+_DEFUN (conv_to_fields, (buf, bufsiz, sep, n, a, b, c),
+	CHAR *buf _AND
+	size_t bufsiz _AND
+	CHAR sep _AND
+	int n _AND
+	int a _AND
+	int b _AND
+	int c)
+{
+  int val[3];
+  size_t count = 0;
+  int i, len;
+
+  val[0] = a;
+  val[1] = b;
+  val[2] = c;
+  for (i = 0; i < n; ++i)
+    {
+      if (i > 0)
+	{
+	  if (count >= bufsiz - 1)
+	    return -1;
+	  buf[count++] = sep;
+	}
+      len = conv_to_digits (&buf[count], bufsiz - count, val[i], 2, CQ('0'));
+      if (len < 0 || (count += len) >= bufsiz)
+	return -1;
+    }
+  return count;
+}
+
 /* Using the tm_year, tm_wday, and tm_yday components of TIM_P, return
    -1, 0, or 1 as the adjustment to add to the year for the ISO week
    numbering used in "%g%G%V", avoiding overflow.  */
@@ -911,18 +979,16 @@ recurse:
 		break;
 	    }
 #endif /* _WANT_C99_TIME_FORMATS */
-	  len = snprintf (&s[count], maxsize - count,
-			  *format == CQ('d') ? CQ("%.2d") : CQ("%2d"),
-			  tim_p->tm_mday);
+	  len = conv_to_digits (&s[count], maxsize - count, tim_p->tm_mday, 2,
+				*format == CQ('d') ? CQ('0') : CQ(' '));
 	  CHECK_LENGTH ();
 	  break;
 	case CQ('D'):
 	  /* %m/%d/%y */
-	  len = snprintf (&s[count], maxsize - count,
-			  CQ("%.2d/%.2d/%.2d"),
-			  tim_p->tm_mon + 1, tim_p->tm_mday,
-			  tim_p->tm_year >= 0 ? tim_p->tm_year % 100
-			  : abs (tim_p->tm_year + YEAR_BASE) % 100);
+	  len = conv_to_fields (&s[count], maxsize - count, CQ('/'), 3,
+				tim_p->tm_mon + 1, tim_p->tm_mday,
+				tim_p->tm_year >= 0 ? tim_p->tm_year % 100
+				: abs (tim_p->tm_year + YEAR_BASE) % 100);
           CHECK_LENGTH ();
 	  break;
 	case CQ('F'):
@@ -966,8 +1032,8 @@ recurse:
 		adjust = 1;
 	    else if (adjust > 0 && tim_p->tm_year < -YEAR_BASE)
 		adjust = -1;
-	    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-			    ((year + adjust) % 100 + 100) % 100);
+	    len = conv_to_digits (&s[count], maxsize - count,
+				  ((year + adjust) % 100 + 100) % 100, 2, CQ('0'));
             CHECK_LENGTH ();
 	  }
           break;
@@ -1032,9 +1098,8 @@ recurse:
 #endif /* _WANT_C99_TIME_FORMATS */
 	  /*FALLTHRU*/
 	case CQ('k'):	/* newlib extension */
-	  len = snprintf (&s[count], maxsize - count,
-			  *format == CQ('k') ? CQ("%2d") : CQ("%.2d"),
-			  tim_p->tm_hour);
+	  len = conv_to_digits (&s[count], maxsize - count, tim_p->tm_hour, 2,
+				*format == CQ('k') ? CQ(' ') : CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('l'):	/* newlib extension */
@@ -1051,14 +1116,14 @@ recurse:
 		|| !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					       h12, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	      len = snprintf (&s[count], maxsize - count,
-			      *format == CQ('I') ? CQ("%.2d") : CQ("%2d"), h12);
+	      len = conv_to_digits (&s[count], maxsize - count, h12, 2,
+				    *format == CQ('I') ? CQ('0') : CQ(' '));
 	    CHECK_LENGTH ();
 	  }
 	  break;
 	case CQ('j'):
-	  len = snprintf (&s[count], maxsize - count, CQ("%.3d"),
-			  tim_p->tm_yday + 1);
+	  len = conv_to_digits (&s[count], maxsize - count,
+				tim_p->tm_yday + 1, 3, CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('m'):
@@ -1067,8 +1132,8 @@ recurse:
 	      || !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					     tim_p->tm_mon + 1, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-			    tim_p->tm_mon + 1);
+	    len = conv_to_digits (&s[count], maxsize - count,
+				  tim_p->tm_mon + 1, 2, CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('M'):
@@ -1077,8 +1142,8 @@ recurse:
 	      || !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					     tim_p->tm_min, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-			    tim_p->tm_min);
+	    len = conv_to_digits (&s[count], maxsize - count,
+				  tim_p->tm_min, 2, CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('n'):
@@ -1100,8 +1165,8 @@ recurse:
 	    }
 	  break;
 	case CQ('R'):
-          len = snprintf (&s[count], maxsize - count, CQ("%.2d:%.2d"),
-			  tim_p->tm_hour, tim_p->tm_min);
+          len = conv_to_fields (&s[count], maxsize - count, CQ(':'), 2,
+				tim_p->tm_hour, tim_p->tm_min, 0);
           CHECK_LENGTH ();
           break;
 	case CQ('s'):
@@ -1178,8 +1243,8 @@ recurse:
 	      || !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					     tim_p->tm_sec, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-			    tim_p->tm_sec);
+	    len = conv_to_digits (&s[count], maxsize - count,
+				  tim_p->tm_sec, 2, CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('t'):
@@ -1189,8 +1254,8 @@ recurse:
 	    return 0;
 	  break;
 	case CQ('T'):
-          len = snprintf (&s[count], maxsize - count, CQ("%.2d:%.2d:%.2d"),
-			  tim_p->tm_hour, tim_p->tm_min, tim_p->tm_sec);
+          len = conv_to_fields (&s[count], maxsize - count, CQ(':'), 3,
+				tim_p->tm_hour, tim_p->tm_min, tim_p->tm_sec);
           CHECK_LENGTH ();
           break;
 	case CQ('u'):
@@ -1224,9 +1289,9 @@ recurse:
 					      tim_p->tm_wday) / 7,
 					     *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-			 (tim_p->tm_yday + 7 -
-			  tim_p->tm_wday) / 7);
+	    len = conv_to_digits (&s[count], maxsize - count,
+				  (tim_p->tm_yday + 7 - tim_p->tm_wday) / 7,
+				  2, CQ('0'));
           CHECK_LENGTH ();
 	  break;
 	case CQ('V'):
@@ -1250,7 +1315,7 @@ recurse:
 		|| !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					       week, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	      len = snprintf (&s[count], maxsize - count, CQ("%.2d"), week);
+	      len = conv_to_digits (&s[count], maxsize - count, week, 2, CQ('0'));
             CHECK_LENGTH ();
 	  }
           break;
@@ -1279,7 +1344,7 @@ recurse:
 		|| !(len = conv_to_alt_digits (&s[count], maxsize - count,
 					       wday, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-	      len = snprintf (&s[count], maxsize - count, CQ("%.2d"), wday);
+	      len = conv_to_digits (&s[count], maxsize - count, wday, 2, CQ('0'));
             CHECK_LENGTH ();
 	  }
 	  break;
@@ -1301,8 +1366,8 @@ recurse:
 		      || !(len = conv_to_alt_digits (&s[count], maxsize - count,
 						     year, *alt_digits)))
 #endif /* _WANT_C99_TIME_FORMATS */
-		    len = snprintf (&s[count], maxsize - count, CQ("%.2d"),
-				    year);
+		    len = conv_to_digits (&s[count], maxsize - count,
+					  year, 2, CQ('0'));
 		}
               CHECK_LENGTH ();
 	    }
@@ -1337,9 +1402,15 @@ recurse:
 	      *fmt++ = CQ('%');
 	      if (pad)
 		*fmt++ = CQ('0');
-	      STRCPY (fmt, CQ(".*u"));
-	      len = snprintf (&s[count], maxsize - count, fmtbuf, width,
-			      year);
+	      if (!sign && year > 0 && year <= 9999 && width <= 4)
+		len = conv_to_digits (&s[count], maxsize - count, (int) year,
+				      (int) width, CQ('0'));
+	      else
+		{
+		  STRCPY (fmt, CQ(".*u"));
+		  len = snprintf (&s[count], maxsize - count, fmtbuf, width,
+				  year);
+		}
 	      CHECK_LENGTH ();
 	    }
 	  break;
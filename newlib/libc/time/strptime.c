@@ -67,16 +67,26 @@ is_leap_year (int year)
     return (year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0);
 }
 
-/* Needed for strptime. */
+/*
+ * Index of the first of the N names in `strs' that `*buf' starts with,
+ * ignoring case, which is skipped, or -1.
+ * Needed for strptime.
+ */
 static int
-match_string (const char *__restrict *buf, const char * const*strs,
+match_string (const char *__restrict *buf, const char * const*strs, int n,
 	      locale_t locale)
 {
     int i = 0;
+    int c = tolower_l ((unsigned char) **buf, locale);
 
-    for (i = 0; strs[i] != NULL; ++i) {
-	int len = strlen (strs[i]);
+    for (i = 0; i < n; ++i) {
+	int len;
 
+	/* Most names already differ in the first character. */
+	if (*strs[i] != '\0'
+	    && tolower_l ((unsigned char) *strs[i], locale) != c)
+	    continue;
+	len = strlen (strs[i]);
 	if (strncasecmp_l (*buf, strs[i], len, locale) == 0) {
 	    *buf += len;
 	    return i;
@@ -85,14 +95,38 @@ match_string (const char *__restrict *buf, const char * const*strs,
     return -1;
 }
 
-/* Needed for strptime. */
+/* Number of leap years from year 1 up to and including `year'. */
+#define LEAPS_THRU(year) ((year) / 4 - (year) / 100 + (year) / 400)
+
+/*
+ * Return the weekday of January 1st of `year', or Thursday for years
+ * before 1970.
+ * Needed for strptime.
+ */
 static int
 first_day (int year)
 {
-    int ret = 4;
+    if (year <= 1970)
+	return 4;
+    /* 365 % 7 == 1, so each year moves the weekday by 1, leap years by 2. */
+    return (4 + (year - 1970) + LEAPS_THRU (year - 1) - LEAPS_THRU (1969)) % 7;
+}
+
+/*
+ * Like strtol_l (buf, end, 10, locale), but without the locale-aware
+ * handling of white space and signs for the usual short run of digits.
+ * Needed for strptime.
+ */
+static int
+conv_num (const char *buf, char **end, locale_t locale)
+{
+    int ret = 0, n;
 
-    while (--year >= 1970)
-	ret = (ret + 365 + is_leap_year (year)) % 7;
+    for (n = 0; n < 9 && buf[n] >= '0' && buf[n] <= '9'; ++n)
+	ret = ret * 10 + buf[n] - '0';
+    if (n == 0 || n == 9)
+	return strtol_l (buf, end, 10, locale);
+    *end = (char *) buf + n;
     return ret;
 }
 
@@ -171,21 +205,21 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		c = *++format;
 	    switch (c) {
 	    case 'A' :
-		ret = match_string (&buf, _ctloc (weekday), locale);
+		ret = match_string (&buf, _ctloc (weekday), 7, locale);
 		if (ret < 0)
 		    return NULL;
 		timeptr->tm_wday = ret;
 		ymd |= SET_WDAY;
 		break;
 	    case 'a' :
-		ret = match_string (&buf, _ctloc (wday), locale);
+		ret = match_string (&buf, _ctloc (wday), 7, locale);
 		if (ret < 0)
 		    return NULL;
 		timeptr->tm_wday = ret;
 		ymd |= SET_WDAY;
 		break;
 	    case 'B' :
-		ret = match_string (&buf, _ctloc (month), locale);
+		ret = match_string (&buf, _ctloc (month), 12, locale);
 		if (ret < 0)
 		    return NULL;
 		timeptr->tm_mon = ret;
@@ -193,14 +227,14 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		break;
 	    case 'b' :
 	    case 'h' :
-		ret = match_string (&buf, _ctloc (mon), locale);
+		ret = match_string (&buf, _ctloc (mon), 12, locale);
 		if (ret < 0)
 		    return NULL;
 		timeptr->tm_mon = ret;
 		ymd |= SET_MON;
 		break;
 	    case 'C' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_year = (ret * 100) - tm_year_base;
@@ -223,7 +257,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		break;
 	    case 'd' :
 	    case 'e' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_mday = ret;
@@ -232,7 +266,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		break;
 	    case 'H' :
 	    case 'k' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_hour = ret;
@@ -240,7 +274,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		break;
 	    case 'I' :
 	    case 'l' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		if (ret == 12)
@@ -250,7 +284,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		buf = s;
 		break;
 	    case 'j' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_yday = ret - 1;
@@ -258,7 +292,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_YDAY;
 		break;
 	    case 'm' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_mon = ret - 1;
@@ -266,7 +300,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_MON;
 		break;
 	    case 'M' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_min = ret;
@@ -279,7 +313,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		    return NULL;
 		break;
 	    case 'p' :
-		ret = match_string (&buf, _ctloc (am_pm), locale);
+		ret = match_string (&buf, _ctloc (am_pm), 2, locale);
 		if (ret < 0)
 		    return NULL;
 		if (timeptr->tm_hour == 0) {
@@ -301,7 +335,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		buf = s;
 		break;
 	    case 'S' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_sec = ret;
@@ -320,7 +354,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		buf = s;
 		break;
 	    case 'u' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_wday = ret - 1;
@@ -328,7 +362,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_WDAY;
 		break;
 	    case 'w' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_wday = ret;
@@ -336,7 +370,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_WDAY;
 		break;
 	    case 'U' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		set_week_number_sun (timeptr, ret);
@@ -344,7 +378,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_YDAY;
 		break;
 	    case 'V' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		set_week_number_mon4 (timeptr, ret);
@@ -352,7 +386,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_YDAY;
 		break;
 	    case 'W' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		set_week_number_mon (timeptr, ret);
@@ -373,7 +407,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		buf = s;
 	    	break;
 	    case 'y' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		if (ret < 70)
@@ -384,7 +418,7 @@ strptime_l (const char *buf, const char *format, struct tm *timeptr,
 		ymd |= SET_YEAR;
 		break;
 	    case 'Y' :
-		ret = strtol_l (buf, &s, 10, locale);
+		ret = conv_num (buf, &s, locale);
 		if (s == buf)
 		    return NULL;
 		timeptr->tm_year = ret - tm_year_base;
@@ -10,6 +10,29 @@
 
 #include "local.h"
 
+/* The change-over times of recently used years are kept in a small
+   direct-mapped cache, so that converting times spread over many years
+   doesn't evaluate the rules again on every call.  The cache is only valid
+   for the rules it was filled with, so it's flushed as soon as tzset or
+   the application changes them.  Callers hold the TZ lock. */
+#define TZCALC_CACHE_SIZE	16
+
+static __tzrule_type tzcalc_rules[2];
+static struct
+{
+  int year;			/* 0 for an unused slot */
+  time_t change[2];
+} tzcalc_cache[TZCALC_CACHE_SIZE];
+
+static int
+_DEFUN (same_rule, (a, b),
+	_CONST __tzrule_type *a _AND
+	_CONST __tzrule_type *b)
+{
+  return a->ch == b->ch && a->m == b->m && a->n == b->n && a->d == b->d
+	 && a->s == b->s && a->offset == b->offset;
+}
+
 int
 _DEFUN (__tzcalc_limits, (year),
 	int year)
@@ -23,6 +46,22 @@ _DEFUN (__tzcalc_limits, (year),
 
   tz->__tzyear = year;
 
+  if (!same_rule (&tz->__tzrule[0], &tzcalc_rules[0])
+      || !same_rule (&tz->__tzrule[1], &tzcalc_rules[1]))
+    {
+      for (i = 0; i < TZCALC_CACHE_SIZE; ++i)
+	tzcalc_cache[i].year = 0;
+      tzcalc_rules[0] = tz->__tzrule[0];
+      tzcalc_rules[1] = tz->__tzrule[1];
+    }
+  else if (tzcalc_cache[year % TZCALC_CACHE_SIZE].year == year)
+    {
+      tz->__tzrule[0].change = tzcalc_cache[year % TZCALC_CACHE_SIZE].change[0];
+      tz->__tzrule[1].change = tzcalc_cache[year % TZCALC_CACHE_SIZE].change[1];
+      tz->__tznorth = (tz->__tzrule[0].change < tz->__tzrule[1].change);
+      return 1;
+    }
+
   years = (year - EPOCH_YEAR);
 
   year_days = years * 365 +
@@ -73,5 +112,9 @@ _DEFUN (__tzcalc_limits, (year),
 
   tz->__tznorth = (tz->__tzrule[0].change < tz->__tzrule[1].change);
 
+  tzcalc_cache[year % TZCALC_CACHE_SIZE].year = year;
+  tzcalc_cache[year % TZCALC_CACHE_SIZE].change[0] = tz->__tzrule[0].change;
+  tzcalc_cache[year % TZCALC_CACHE_SIZE].change[1] = tz->__tzrule[1].change;
+
   return 1;
 }
@@ -13,6 +13,84 @@ static char __tzname_std[11];
 static char __tzname_dst[11];
 static char *prev_tzenv = NULL;
 
+#if !defined(__SINGLE_THREAD__) && !defined(PREFER_SIZE_OVER_SPEED) \
+    && !defined(__OPTIMIZE_SIZE__) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+
+/* Transition table for the current TZ value.  It lets localtime_r and
+   mktime look up the timezone data of the years it covers without taking
+   the TZ lock.  tzset rebuilds it with the TZ lock held and keeps
+   tztable_seq odd while doing so, so readers can detect a torn copy and
+   fall back to the locked path.  Nothing is published while TZ is unset,
+   so applications which fill in __gettzinfo () themselves keep working. */
+#define TZTABLE_YEARS	128
+#define TZTABLE_ENVLEN	63
+
+static unsigned int tztable_seq;
+static struct
+{
+  int valid;
+  int daylight;
+  long offset[2];
+  char tzenv[TZTABLE_ENVLEN + 1];	/* tzenv[TZTABLE_ENVLEN] stays 0 */
+  time_t change[TZTABLE_YEARS][2];
+} tztable;
+
+static _VOID
+_DEFUN_VOID (tztable_begin)
+{
+  __atomic_store_n (&tztable_seq, tztable_seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static _VOID
+_DEFUN_VOID (tztable_end)
+{
+  __atomic_store_n (&tztable_seq, tztable_seq + 1, __ATOMIC_RELEASE);
+}
+
+static _VOID
+_DEFUN_VOID (tztable_invalidate)
+{
+  tztable_begin ();
+  tztable.valid = 0;
+  tztable_end ();
+}
+
+static _VOID
+_DEFUN (tztable_publish, (tzenv, daylight),
+	_CONST char *tzenv _AND
+	int daylight)
+{
+  __tzinfo_type *_CONST tz = __gettzinfo ();
+  int year = tz->__tzyear;
+  size_t len;
+  int i;
+
+  if (tzenv == NULL || (len = strlen (tzenv)) > TZTABLE_ENVLEN)
+    return;
+
+  tztable_begin ();
+  memcpy (tztable.tzenv, tzenv, len + 1);
+  tztable.daylight = daylight;
+  tztable.offset[0] = tz->__tzrule[0].offset;
+  tztable.offset[1] = tz->__tzrule[1].offset;
+  if (daylight)
+    for (i = 0; i < TZTABLE_YEARS; ++i)
+      {
+	__tzcalc_limits (EPOCH_YEAR + i);
+	tztable.change[i][0] = tz->__tzrule[0].change;
+	tztable.change[i][1] = tz->__tzrule[1].change;
+      }
+  tztable.valid = 1;
+  tztable_end ();
+
+  tz->__tzyear = year;
+}
+#else
+#define tztable_invalidate()
+#define tztable_publish(tzenv, daylight)
+#endif
+
 _VOID
 _DEFUN (_tzset_unlocked_r, (reent_ptr),
         struct _reent *reent_ptr)
@@ -29,6 +107,8 @@ _DEFUN (_tzset_unlocked_r, (reent_ptr),
 	_daylight = 0;
 	_tzname[0] = "GMT";
 	_tzname[1] = "GMT";
+	if (prev_tzenv != NULL)
+	  tztable_invalidate ();
 	free(prev_tzenv);
 	prev_tzenv = NULL;
 	return;
@@ -37,6 +117,8 @@ _DEFUN (_tzset_unlocked_r, (reent_ptr),
   if (prev_tzenv != NULL && strcmp(tzenv, prev_tzenv) == 0)
     return;
 
+  tztable_invalidate ();
+
   free(prev_tzenv);
   prev_tzenv = _malloc_r (reent_ptr, strlen(tzenv) + 1);
   if (prev_tzenv != NULL)
@@ -75,6 +157,7 @@ _DEFUN (_tzset_unlocked_r, (reent_ptr),
       _tzname[1] = _tzname[0];
       _timezone = tz->__tzrule[0].offset;
       _daylight = 0;
+      tztable_publish (prev_tzenv, 0);
       return;
     }
   else
@@ -178,9 +261,10 @@ _DEFUN (_tzset_unlocked_r, (reent_ptr),
       tzenv += n;
     }
 
-  __tzcalc_limits (tz->__tzyear);
   _timezone = tz->__tzrule[0].offset;  
   _daylight = tz->__tzrule[0].offset != tz->__tzrule[1].offset;
+  tztable_publish (prev_tzenv, _daylight);
+  __tzcalc_limits (tz->__tzyear);
 }
 
 _VOID
@@ -191,3 +275,50 @@ _DEFUN (_tzset_r, (reent_ptr),
   _tzset_unlocked_r (reent_ptr);
   TZ_UNLOCK;
 }
+
+/* Fill in *tzl with the timezone data needed to convert a time in year,
+   calling tzset first if TZ changed. */
+_VOID
+_DEFUN (__tzget_limits, (year, tzl),
+	int year _AND
+	__tzlimits_type *tzl)
+{
+  __tzinfo_type *_CONST tz = __gettzinfo ();
+#ifdef TZTABLE_YEARS
+  _CONST char *tzenv;
+  unsigned int seq;
+
+  if ((unsigned int) (year - EPOCH_YEAR) < TZTABLE_YEARS
+      && (tzenv = _getenv_r (_REENT, "TZ")) != NULL)
+    {
+      seq = __atomic_load_n (&tztable_seq, __ATOMIC_ACQUIRE);
+      if (!(seq & 1) && tztable.valid && strcmp (tzenv, tztable.tzenv) == 0)
+	{
+	  tzl->daylight = tztable.daylight;
+	  tzl->limits = tzl->daylight;
+	  tzl->change[0] = tztable.change[year - EPOCH_YEAR][0];
+	  tzl->change[1] = tztable.change[year - EPOCH_YEAR][1];
+	  tzl->north = tzl->change[0] < tzl->change[1];
+	  tzl->offset[0] = tztable.offset[0];
+	  tzl->offset[1] = tztable.offset[1];
+	  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+	  if (__atomic_load_n (&tztable_seq, __ATOMIC_RELAXED) == seq)
+	    return;
+	}
+    }
+#endif
+
+  TZ_LOCK;
+  _tzset_unlocked ();
+  tzl->daylight = _daylight;
+  tzl->limits = _daylight && (year == tz->__tzyear || __tzcalc_limits (year));
+  if (tzl->limits)
+    {
+      tzl->north = tz->__tznorth;
+      tzl->change[0] = tz->__tzrule[0].change;
+      tzl->change[1] = tz->__tzrule[1].change;
+    }
+  tzl->offset[0] = tz->__tzrule[0].offset;
+  tzl->offset[1] = tz->__tzrule[1].offset;
+  TZ_UNLOCK;
+}
@@ -19,6 +19,49 @@
 /* REDHAT LOCAL: Default to XOPEN_MODE.  */
 #define _XOPEN_MODE
 
+/* When __OBSOLETE_MATH is 0, exp, exp2, log, log2 and pow come from the
+   table driven implementations in exp.c, exp2.c, log.c, log2.c and pow.c
+   instead of the fdlibm wrappers.  Those rely on double arithmetic being
+   evaluated in double precision and on doubles having the same word order
+   as 64-bit integers, so keep the old code elsewhere.  The SPU port has
+   its own versions of all these in libm/machine/spu.  */
+#ifndef __OBSOLETE_MATH
+#if defined (_DOUBLE_IS_32BITS) || defined (__IEEE_BYTES_LITTLE_ENDIAN) \
+    || (defined (__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0) \
+    || defined (__SPU__)
+#define __OBSOLETE_MATH 1
+#else
+#define __OBSOLETE_MATH 0
+#endif
+#endif
+
+/* When __OBSOLETE_MATH_FLOAT is 0, expf, exp2f, logf, log2f, powf, sinf,
+   cosf and sincosf come from expf.c, exp2f.c, logf.c, log2f.c, powf.c,
+   sinf.c, cosf.c and sincosf.c, which evaluate in double precision, instead
+   of the fdlibm float code.  That needs the same as __OBSOLETE_MATH above
+   plus IEEE single precision, and is only a win with double precision
+   hardware, so soft float targets and those whose FPU only does single
+   precision keep the old code.  Configuring with
+   --enable-newlib-obsolete-float-math or --disable-... sets
+   _OBSOLETE_FLOAT_MATH in newlib.h to override the choice.  */
+#ifndef __OBSOLETE_MATH_FLOAT
+#if defined (_DOUBLE_IS_32BITS) || defined (__IEEE_BYTES_LITTLE_ENDIAN) \
+    || (defined (__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0) \
+    || defined (__SPU__) || defined (_FLT_LARGEST_EXPONENT_IS_NORMAL) \
+    || defined (_FLT_NO_DENORMALS)
+#define __OBSOLETE_MATH_FLOAT 1
+#elif defined (_OBSOLETE_FLOAT_MATH)
+#define __OBSOLETE_MATH_FLOAT _OBSOLETE_FLOAT_MATH
+#elif defined (__SOFTFP__) || defined (_SOFT_FLOAT) \
+    || defined (__mips_soft_float) || defined (__nios2__) \
+    || (defined (__ARM_FP) && !(__ARM_FP & 8)) \
+    || (defined (__riscv) && !(defined (__riscv_flen) && __riscv_flen >= 64))
+#define __OBSOLETE_MATH_FLOAT 1
+#else
+#define __OBSOLETE_MATH_FLOAT __OBSOLETE_MATH
+#endif
+#endif
+
 /* Most routines need to check whether a float is finite, infinite, or not a
    number, and many need to know whether the result of an operation will
    overflow.  These conditions depend on whether the largest exponent is
@@ -185,6 +228,10 @@ extern double __kernel_sin __P((double,double,int));
 extern double __kernel_cos __P((double,double));
 extern double __kernel_tan __P((double,double,int));
 extern int    __kernel_rem_pio2 __P((double*,double*,int,int,int,const __int32_t*));
+extern void   __kernel_sincos_pio4 __P((double,double*,double*));
+extern double __kernel_sin_pio4 __P((double,double,int));
+extern double __kernel_j0 __P((double,double,double,int));
+extern double __kernel_j1 __P((double,double,double,int));
 
 /* Undocumented float functions.  */
 #ifdef _SCALB_INT
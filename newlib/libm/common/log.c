@@ -0,0 +1,111 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Table driven double precision log.  This replaces the fdlibm
+   __ieee754_log and its wrapper in w_log.c unless __OBSOLETE_MATH is set,
+   see fdlibm.h.  It shares the table of pow, but without the extra
+   precision pow needs; the error is still within 0.52 ulp.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH
+
+#include "math_config.h"
+
+#define N (1 << POW_LOG_TABLE_BITS)
+#define OFF 0x3fe6955500000000
+#define T __pow_log_data.tab
+#define B __pow_log_data.log_poly
+#define Ln2hi __pow_log_data.ln2hi
+#define Ln2lo __pow_log_data.ln2lo
+
+double
+log (double x)
+{
+  /* double_t for better performance on targets with FLT_EVAL_METHOD==2.  */
+  double_t w, z, r, r2, r3, y, invc, logc, kd, hi, lo;
+  uint64_t ix, iz, tmp;
+  uint32_t top;
+  int k, i;
+
+  ix = asuint64 (x);
+  top = top12 (x);
+  if (predict_false (top - 0x001 >= 0x7ff - 0x001))
+    {
+      /* x < 0x1p-1022 or inf or nan.  */
+      if (ix * 2 == 0)
+	return __math_err (x, x, __math_divzero (1), 16);
+      if (ix == asuint64 (INFINITY)) /* log(inf) == inf.  */
+	return x;
+      if (ix * 2 > asuint64 (INFINITY) * 2)
+	return x + x;
+      if (top & 0x800)
+	return __math_err (x, x, __math_invalid (x), 17);
+      /* x is subnormal, normalize it.  */
+      ix = asuint64 (x * 0x1p52);
+      ix -= 52ULL << 52;
+    }
+
+  /* x = 2^k z; where z is in range [OFF,2*OFF) and exact.
+     The range is split into N subintervals.
+     The ith subinterval contains z and c is near its center.  */
+  tmp = ix - OFF;
+  i = (tmp >> (52 - POW_LOG_TABLE_BITS)) % N;
+  k = (int64_t) tmp >> 52; /* arithmetic shift */
+  iz = ix - (tmp & 0xfffULL << 52);
+  invc = T[i].invc;
+  logc = T[i].logc;
+  z = asdouble (iz);
+  kd = (double_t) k;
+
+  /* log(x) = k*Ln2 + log(c) + log1p(z/c-1).  r = z/c - 1 is exact, see
+     log_inline in pow.c.  */
+#ifdef __FP_FAST_FMA
+  r = __builtin_fma (z, invc, -1.0);
+#else
+  {
+    double_t zhi = asdouble ((iz + (1ULL << 31)) & (-1ULL << 32));
+    r = (zhi * invc - 1.0) + (z - zhi) * invc;
+  }
+#endif
+
+  /* k*Ln2 + log(c) + r.  */
+  w = kd * Ln2hi + logc;
+  hi = w + r;
+  lo = w - hi + r + kd * Ln2lo + T[i].logctail;
+
+  /* log(x) = lo + (log1p(r) - r) + hi.  Near 1 the table entry is exactly
+     1 and hi == r, elsewhere |hi| > 0x1p-8 so the rounding errors of the
+     polynomial are well below an ulp of the result.  */
+  r2 = r * r;
+  r3 = r * r2;
+  y = (lo + r2 * B[0]
+       + r3 * (B[1] + r * B[2] + r2 * (B[3] + r * B[4] + r2 * (B[5] + r * B[6])))
+       + hi);
+  return eval_as_double (y);
+}
+
+#endif /* !__OBSOLETE_MATH */
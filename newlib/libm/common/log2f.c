@@ -0,0 +1,98 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Single precision log2 evaluated in double precision.  This replaces the
+   logf based log2f in sf_log2.c unless __OBSOLETE_MATH_FLOAT is set, see
+   fdlibm.h.  Errors are still reported as those of logf (x).  The error is
+   below 0.501 ulp.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH_FLOAT
+
+#include "math_config.h"
+
+#undef log2f
+
+#define T __log2f_data.tab
+#define A __log2f_data.poly
+#define InvLn2 __log2f_data.invln2
+#define N (1 << LOG2F_TABLE_BITS)
+#define OFF 0x3f330000
+
+float
+log2f (float x)
+{
+  /* double_t for better performance on targets with FLT_EVAL_METHOD==2.  */
+  double_t z, r, r2, r4, p, y, y0, invc, logc;
+  uint32_t ix, iz, tmp;
+  int k, i;
+
+  ix = asuint (x);
+  if (predict_false (ix - 0x00800000 >= 0x7f800000 - 0x00800000))
+    {
+      /* x < 0x1p-126 or inf or nan.  Errors are those of logf (x), and
+	 so is the value returned for them, scaled to base 2.  */
+      if (ix * 2 == 0)
+	return (float) __math_err (x, x, __math_divzerof (1), 116)
+	       / (float_t) M_LN2;
+      if (ix == 0x7f800000) /* log2(inf) == inf.  */
+	return x;
+      if (ix * 2 > 0xff000000)
+	return x + x;
+      if (ix & 0x80000000)
+	return (float) __math_err (x, x, __math_invalidf (x), 117)
+	       / (float_t) M_LN2;
+      /* x is subnormal, normalize it.  */
+      ix = asuint (x * 0x1p23f);
+      ix -= 23 << 23;
+    }
+
+  /* x = 2^k z; where z is in range [OFF,2*OFF] and exact.
+     The range is split into N subintervals.
+     The ith subinterval contains z and c is near its center.  */
+  tmp = ix - OFF;
+  i = (tmp >> (23 - LOG2F_TABLE_BITS)) % N;
+  k = (int32_t) tmp >> 23; /* arithmetic shift */
+  iz = ix - (tmp & 0x1ff << 23);
+  invc = T[i].invc;
+  logc = T[i].logc;
+  z = (double_t) asfloat (iz);
+
+  /* log2(x) = log1p(z/c-1)/ln2 + log2(c) + k, where r = z/c - 1 is exact
+     because invc has 29 significant bits.  */
+  r = z * invc - 1;
+  y0 = logc + (double_t) k;
+
+  /* Pipelined polynomial evaluation to approximate log1p(r)/ln2 - r/ln2.  */
+  r2 = r * r;
+  r4 = r2 * r2;
+  p = (A[0] + r * A[1]) + r2 * (A[2] + r * A[3]) + r4 * (A[4] + r * A[5]);
+  y = y0 + r * InvLn2 + r2 * p;
+  return eval_as_float (y);
+}
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
@@ -0,0 +1,81 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Shared data between log2f and powf.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH_FLOAT
+
+#include "math_config.h"
+
+const struct log2f_data __log2f_data = {
+/* The same subintervals and invc as in logf_data.c, with logc being
+   log2(c) rounded to double.  */
+{
+{ 0x1.661ec6a000000p+0, -0x1.efec619b26afap-2 },
+{ 0x1.571ed3c000000p+0, -0x1.b0b67f39a28e1p-2 },
+{ 0x1.49539e4000000p+0, -0x1.7418ad01630bep-2 },
+{ 0x1.3c995a4000000p+0, -0x1.39de8df148b77p-2 },
+{ 0x1.30d1901000000p+0, -0x1.01d9bbc0dc7b9p-2 },
+{ 0x1.25e2271000000p+0, -0x1.97c1cb63d9bbbp-3 },
+{ 0x1.1bb4a40000000p+0, -0x1.2f9e32a7954e4p-3 },
+{ 0x1.12358e7000000p+0, -0x1.960caf1d37c86p-4 },
+{ 0x1.0953f39000000p+0, -0x1.a6f9c374fa88cp-5 },
+{ 0x1.0000000000000p+0, 0.0 },
+{ 0x1.e573ac9000000p-1, 0x1.3aa2fdd3f070ap-4 },
+{ 0x1.ca4b305000000p-1, 0x1.476a9fbe7ab31p-3 },
+{ 0x1.b203640000000p-1, 0x1.e840bea311339p-3 },
+{ 0x1.9c2d14f000000p-1, 0x1.406463ab8e9dap-2 },
+{ 0x1.886e5f1000000p-1, 0x1.88e9c71a34d90p-2 },
+{ 0x1.767dce4000000p-1, 0x1.ce0a4930a17ffp-2 },
+},
+/* 1/ln2.  */
+0x1.71547652b82fep+0,
+/* log2(1+r) ~= r/ln2 + r^2*poly[0] + ... + r^7*poly[5] for
+   |r| < 0x1.e6p-6.  */
+{
+-0x1.71547652c0a1cp-1,
+0x1.ec709dc3af433p-2,
+-0x1.7154710ccb506p-2,
+0x1.2776c05f03975p-2,
+-0x1.eced78f6bf7dap-3,
+0x1.a6865ee6d1dc1p-3,
+},
+/* Likewise up to r^8*pow_poly[6], with a relative error below 2^-49 so
+   that y*log2(x) in powf stays accurate when it is close to 150.  */
+{
+-0x1.71547652b82fep-1,
+0x1.ec709dc3d4ce1p-2,
+-0x1.71547652e77d0p-2,
+0x1.2776bdc4205c5p-2,
+-0x1.ec7090a3395a2p-3,
+0x1.a698e141e771ep-3,
+-0x1.71c9025d6623ep-3,
+},
+};
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
@@ -0,0 +1,70 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Data for logf.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH_FLOAT
+
+#include "math_config.h"
+
+const struct logf_data __logf_data = {
+/* For the ith subinterval of [OFF, 2*OFF), see logf.c, invc is 1/c
+   rounded to 29 bits, where c is near the center of the subinterval, so
+   that z*invc is exact, and logc is log(c) rounded to double.  The
+   subinterval containing 1 uses c = 1.  */
+{
+{ 0x1.661ec6a000000p+0, -0x1.57bf752e0d1fbp-2 },
+{ 0x1.571ed3c000000p+0, -0x1.2bef07bec9354p-2 },
+{ 0x1.49539e4000000p+0, -0x1.01eae5716c691p-2 },
+{ 0x1.3c995a4000000p+0, -0x1.b31d8543bce3dp-3 },
+{ 0x1.30d1901000000p+0, -0x1.6574ebd44133ap-3 },
+{ 0x1.25e2271000000p+0, -0x1.1aa2b819bf72ap-3 },
+{ 0x1.1bb4a40000000p+0, -0x1.a4e763cb1bc38p-4 },
+{ 0x1.12358e7000000p+0, -0x1.1973bcbd65567p-4 },
+{ 0x1.0953f39000000p+0, -0x1.252f32f6d183fp-5 },
+{ 0x1.0000000000000p+0, 0.0 },
+{ 0x1.e573ac9000000p-1, 0x1.b42dd713971bfp-5 },
+{ 0x1.ca4b305000000p-1, 0x1.c5e5492abc743p-4 },
+{ 0x1.b203640000000p-1, 0x1.526e5e5a1b438p-3 },
+{ 0x1.9c2d14f000000p-1, 0x1.bc28673a58cd6p-3 },
+{ 0x1.886e5f1000000p-1, 0x1.1058bf8d24ad5p-2 },
+{ 0x1.767dce4000000p-1, 0x1.404308716a7e4p-2 },
+},
+0x1.62e42fefa39efp-1,
+/* log1p(r) ~= r + r^2*poly[0] + ... + r^7*poly[5] for |r| < 0x1.e6p-6.  */
+{
+-0x1.0000000005da8p-1,
+0x1.555555555fbd6p-2,
+-0x1.fffff8b09b2f3p-3,
+0x1.9999931a199d9p-3,
+-0x1.55abe088fb426p-3,
+0x1.24df3702f2590p-3,
+},
+};
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
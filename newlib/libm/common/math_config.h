@@ -0,0 +1,243 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Configuration and shared helpers for the table driven exp, exp2, log,
+   log2 and pow, and for the float functions evaluated in double precision.
+
+   These routines are only used when __OBSOLETE_MATH or __OBSOLETE_MATH_FLOAT
+   is 0, see fdlibm.h.  They rely on double_t being double and on the bit
+   layout of a double matching that of a uint64_t.  */
+
+#ifndef _MATH_CONFIG_H
+#define _MATH_CONFIG_H
+
+#include <math.h>
+#include <stdint.h>
+
+/* Correct special case results in non-nearest rounding modes.  */
+#ifndef WANT_ROUNDING
+# define WANT_ROUNDING 1
+#endif
+
+#ifdef __GNUC__
+# define predict_true(x) __builtin_expect (!!(x), 1)
+# define predict_false(x) __builtin_expect (x, 0)
+#else
+# define predict_true(x) (x)
+# define predict_false(x) (x)
+#endif
+
+static inline uint32_t
+asuint (float f)
+{
+  union
+  {
+    float f;
+    uint32_t i;
+  } u = {f};
+  return u.i;
+}
+
+static inline float
+asfloat (uint32_t i)
+{
+  union
+  {
+    uint32_t i;
+    float f;
+  } u = {i};
+  return u.f;
+}
+
+static inline uint64_t
+asuint64 (double f)
+{
+  union
+  {
+    double f;
+    uint64_t i;
+  } u = {f};
+  return u.i;
+}
+
+static inline double
+asdouble (uint64_t i)
+{
+  union
+  {
+    uint64_t i;
+    double f;
+  } u = {i};
+  return u.f;
+}
+
+/* Top 12 bits of a double (sign and exponent bits).  */
+static inline uint32_t
+top12 (double x)
+{
+  return asuint64 (x) >> 52;
+}
+
+/* Evaluate an expression as the specified type, normally a type cast is
+   enough, but compilers implement non-standard excess-precision handling
+   so when FLT_EVAL_METHOD != 0 then these functions may need to be
+   customized.  */
+static inline float
+eval_as_float (float x)
+{
+  return x;
+}
+
+static inline double
+eval_as_double (double x)
+{
+  return x;
+}
+
+/* Hide X from the optimizer so the computation that uses it is done at
+   run time and raises the expected floating point exceptions.  */
+static inline double
+opt_barrier_double (double x)
+{
+  volatile double y = x;
+  return y;
+}
+
+static inline float
+opt_barrier_float (float x)
+{
+  volatile float y = x;
+  return y;
+}
+
+static inline void
+force_eval_float (float x)
+{
+  volatile float y;
+  y = x;
+  (void) y;
+}
+
+static inline void
+force_eval_double (double x)
+{
+  volatile double y;
+  y = x;
+  (void) y;
+}
+
+/* Error handling.  The __math_oflow, __math_uflow, __math_divzero and
+   __math_invalid helpers return the IEEE result for the respective special
+   case and raise the matching floating point exception.  __math_err then
+   reports the error the way the fdlibm wrappers do, through matherr and
+   errno depending on _LIB_VERSION.  TYPE is the __kernel_standard code of
+   the error, see k_standard.c, and RETVAL the IEEE result.  The float
+   functions use the same codes plus 100 and the helpers with an f suffix,
+   which raise the exceptions in single precision.  */
+double __math_oflow (uint32_t);
+double __math_uflow (uint32_t);
+double __math_divzero (uint32_t);
+double __math_invalid (double);
+float __math_oflowf (uint32_t);
+float __math_uflowf (uint32_t);
+float __math_divzerof (uint32_t);
+float __math_invalidf (float);
+double __math_err (double, double, double, int);
+
+#define EXP_TABLE_BITS 7
+#define EXP_POLY_ORDER 5
+#define EXP2_POLY_ORDER 5
+extern const struct exp_data
+{
+  double invln2N;
+  double shift;
+  double negln2hiN;
+  double negln2loN;
+  double poly[4]; /* Last four coefficients.  */
+  double exp2_shift;
+  double exp2_poly[EXP2_POLY_ORDER];
+  uint64_t tab[2 * (1 << EXP_TABLE_BITS)];
+} __exp_data;
+
+/* exp(X+XTAIL) for |XTAIL| < 2^-15, without error reporting, see exp.c.  */
+double __exp_dd (double, double);
+
+#define POW_LOG_TABLE_BITS 7
+#define POW_LOG_POLY_ORDER 8
+extern const struct pow_log_data
+{
+  double ln2hi;
+  double ln2lo;
+  double invln2hi;
+  double invln2lo;
+  double poly[POW_LOG_POLY_ORDER - 1]; /* First coefficient is 1.  */
+  double log_poly[POW_LOG_POLY_ORDER - 1]; /* Unscaled poly.  */
+  struct
+  {
+    double invc, logc, logctail;
+  } tab[1 << POW_LOG_TABLE_BITS];
+} __pow_log_data;
+
+#define EXP2F_TABLE_BITS 5
+#define EXP2F_POLY_ORDER 5
+extern const struct exp2f_data
+{
+  uint64_t tab[1 << EXP2F_TABLE_BITS];
+  double shift_scaled;
+  double poly[EXP2F_POLY_ORDER - 1]; /* First coefficient is 1.  */
+  double shift;
+  double invln2_scaled;
+  double poly_scaled[EXP2F_POLY_ORDER - 1];
+} __exp2f_data;
+
+#define LOGF_TABLE_BITS 4
+#define LOGF_POLY_ORDER 8
+extern const struct logf_data
+{
+  struct
+  {
+    double invc, logc;
+  } tab[1 << LOGF_TABLE_BITS];
+  double ln2;
+  double poly[LOGF_POLY_ORDER - 2]; /* First coefficient is 1.  */
+} __logf_data;
+
+#define LOG2F_TABLE_BITS 4
+#define LOG2F_POLY_ORDER 8
+#define POWF_LOG2_POLY_ORDER 9
+extern const struct log2f_data
+{
+  struct
+  {
+    double invc, logc;
+  } tab[1 << LOG2F_TABLE_BITS];
+  double invln2;
+  double poly[LOG2F_POLY_ORDER - 2]; /* First coefficient is 1/ln2.  */
+  double pow_poly[POWF_LOG2_POLY_ORDER - 2]; /* More precise, for powf.  */
+} __log2f_data;
+
+#endif /* _MATH_CONFIG_H */
@@ -0,0 +1,200 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Special case handling shared by the table driven exp, exp2, log, log2
+   and pow, and by the float functions evaluated in double precision, see
+   math_config.h.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH || !__OBSOLETE_MATH_FLOAT
+
+#include <errno.h>
+#include "math_config.h"
+
+static double
+xflow (uint32_t sign, double y)
+{
+  y = opt_barrier_double (sign ? -y : y) * y;
+  return y;
+}
+
+double
+__math_uflow (uint32_t sign)
+{
+  return xflow (sign, 0x1p-767);
+}
+
+double
+__math_oflow (uint32_t sign)
+{
+  return xflow (sign, 0x1p769);
+}
+
+double
+__math_divzero (uint32_t sign)
+{
+  double y = opt_barrier_double (sign ? -1.0 : 1.0) / 0.0;
+  return y;
+}
+
+double
+__math_invalid (double x)
+{
+  double y = (x - x) / (x - x);
+  return y;
+}
+
+/* Report the error TYPE for the arguments X and Y exactly as the
+   w_exp.c, w_log.c and w_pow.c wrappers or their float versions do, and
+   return the value they would return.  RETVAL is the IEEE result, which
+   was computed by the caller so that the floating point exceptions are
+   already raised.  */
+double
+__math_err (double x, double y, double retval, int type)
+{
+#ifndef _IEEE_LIBM
+  struct exception exc;
+  int err;
+
+  if (_LIB_VERSION == _IEEE_)
+    return retval;
+  exc.arg1 = x;
+  exc.arg2 = y;
+  exc.err = 0;
+  exc.retval = retval;
+  switch (type)
+    {
+    case 6:
+    case 106:
+      /* exp(finite) overflow */
+      exc.type = OVERFLOW;
+      exc.name = type < 100 ? "exp" : "expf";
+      if (_LIB_VERSION == _SVID_)
+	exc.retval = HUGE;
+      err = ERANGE;
+      break;
+    case 7:
+    case 107:
+      /* exp(finite) underflow */
+      exc.type = UNDERFLOW;
+      exc.name = type < 100 ? "exp" : "expf";
+      exc.retval = 0.0;
+      err = ERANGE;
+      break;
+    case 16:
+    case 116:
+      /* log(0) */
+      exc.type = SING;
+      exc.name = type < 100 ? "log" : "logf";
+      if (_LIB_VERSION == _SVID_)
+	exc.retval = -HUGE;
+      err = ERANGE;
+      break;
+    case 17:
+    case 117:
+      /* log(x<0) */
+      exc.type = DOMAIN;
+      exc.name = type < 100 ? "log" : "logf";
+      if (_LIB_VERSION == _SVID_)
+	exc.retval = -HUGE;
+      else
+	exc.retval = -HUGE_VAL;
+      err = EDOM;
+      break;
+    case 20:
+    case 120:
+      /* pow(0.0,0.0), an error only if _LIB_VERSION == _SVID_ */
+      if (_LIB_VERSION != _SVID_)
+	return 1.0;
+      exc.type = DOMAIN;
+      exc.name = type < 100 ? "pow" : "powf";
+      exc.retval = 0.0;
+      err = EDOM;
+      break;
+    case 21:
+    case 121:
+      /* pow(x,y) overflow */
+      exc.type = OVERFLOW;
+      exc.name = type < 100 ? "pow" : "powf";
+      if (_LIB_VERSION == _SVID_)
+	exc.retval = retval < 0.0 ? -HUGE : HUGE;
+      err = ERANGE;
+      break;
+    case 22:
+    case 122:
+      /* pow(x,y) underflow */
+      exc.type = UNDERFLOW;
+      exc.name = type < 100 ? "pow" : "powf";
+      exc.retval = 0.0;
+      err = ERANGE;
+      break;
+    case 23:
+    case 123:
+      /* 0**neg */
+      exc.type = DOMAIN;
+      exc.name = type < 100 ? "pow" : "powf";
+      exc.retval = _LIB_VERSION == _SVID_ ? 0.0 : -HUGE_VAL;
+      err = EDOM;
+      break;
+    case 24:
+    case 124:
+      /* neg**non-integral */
+      exc.type = DOMAIN;
+      exc.name = type < 100 ? "pow" : "powf";
+      if (_LIB_VERSION == _SVID_)
+	exc.retval = 0.0;
+      err = EDOM;
+      break;
+    case 42:
+    case 142:
+      /* pow(NaN,0.0), an error only if _LIB_VERSION == _SVID_ & _XOPEN_ */
+      if (_LIB_VERSION == _POSIX_)
+	return 1.0;
+      exc.type = DOMAIN;
+      exc.name = type < 100 ? "pow" : "powf";
+      exc.retval = 1.0;
+      err = EDOM;
+      break;
+    default:
+      return retval;
+    }
+  if (_LIB_VERSION == _POSIX_)
+    errno = err;
+  else if (!matherr (&exc))
+    errno = err;
+  if (exc.err != 0)
+    errno = exc.err;
+  /* log(x<0) returns NaN whatever matherr made of it.  */
+  if (type == 17 || type == 117)
+    return retval;
+  return exc.retval;
+#else
+  return retval;
+#endif
+}
+
+#endif /* !__OBSOLETE_MATH || !__OBSOLETE_MATH_FLOAT */
@@ -0,0 +1,217 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Single precision pow evaluated in double precision.  This replaces the
+   fdlibm __ieee754_powf based wrapper in math/wf_pow.c unless
+   __OBSOLETE_MATH_FLOAT is set, see fdlibm.h.
+
+   powf(x,y) = exp2(y * log2(x)), where log2(x) is computed in double with a
+   relative error below 2^-49 and exp2 is the expf/exp2f kernel.  The error
+   is below 0.501 ulp.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH_FLOAT
+
+#include "math_config.h"
+
+#define N (1 << LOG2F_TABLE_BITS)
+#define T __log2f_data.tab
+#define A __log2f_data.pow_poly
+#define InvLn2 __log2f_data.invln2
+#define OFF 0x3f330000
+
+/* Subnormal input is normalized so ix has negative biased exponent.
+   Output is log2(x) with the error described above.  */
+static inline double_t
+log2_inline (uint32_t ix)
+{
+  /* double_t for better performance on targets with FLT_EVAL_METHOD==2.  */
+  double_t z, r, r2, r4, p, y0, invc, logc;
+  uint32_t iz, tmp;
+  int k, i;
+
+  /* x = 2^k z; where z is in range [OFF,2*OFF] and exact.
+     The range is split into N subintervals.
+     The ith subinterval contains z and c is near its center.  */
+  tmp = ix - OFF;
+  i = (tmp >> (23 - LOG2F_TABLE_BITS)) % N;
+  k = (int32_t) tmp >> 23; /* arithmetic shift */
+  iz = ix - (tmp & 0x1ff << 23);
+  invc = T[i].invc;
+  logc = T[i].logc;
+  z = (double_t) asfloat (iz);
+
+  /* log2(x) = log1p(z/c-1)/ln2 + log2(c) + k, with r = z/c - 1 exact.  */
+  r = z * invc - 1;
+  y0 = logc + (double_t) k;
+
+  r2 = r * r;
+  r4 = r2 * r2;
+  p = ((A[0] + r * A[1]) + r2 * (A[2] + r * A[3])
+       + r4 * ((A[4] + r * A[5]) + r2 * A[6]));
+  return y0 + r * InvLn2 + r2 * p;
+}
+
+#undef N
+#undef T
+#define N (1 << EXP2F_TABLE_BITS)
+#define T __exp2f_data.tab
+#define C __exp2f_data.poly
+#define SHIFT __exp2f_data.shift_scaled
+#define SIGN_BIAS (1 << (EXP2F_TABLE_BITS + 11))
+
+/* Return 2^xd for xd in (-150, 128), with the sign of the result set by
+   sign_bias.  */
+static inline double_t
+exp2_inline (double_t xd, uint32_t sign_bias)
+{
+  uint64_t ki, ski, t;
+  /* double_t for better performance on targets with FLT_EVAL_METHOD==2.  */
+  double_t kd, r, r2, y, s;
+
+  /* x = k/N + r with r in [-1/(2N), 1/(2N)] and int k.  */
+  kd = eval_as_double (xd + SHIFT);
+  ki = asuint64 (kd);
+  kd -= SHIFT; /* k/N */
+  r = xd - kd;
+
+  /* exp2(x) = 2^(k/N) * 2^r ~= s * (1 + r*(C0 + r*(C1 + r*(C2 + r*C3)))).  */
+  t = T[ki % N];
+  ski = ki + sign_bias;
+  t += ski << (52 - EXP2F_TABLE_BITS);
+  s = asdouble (t);
+  r2 = r * r;
+  y = (C[0] + r * C[1]) + r2 * (C[2] + r * C[3]);
+  return s + s * r * y;
+}
+
+/* Returns 0 if not int, 1 if odd int, 2 if even int.  The argument is
+   the bit representation of a non-zero finite floating-point value.  */
+static inline int
+checkint (uint32_t iy)
+{
+  int e = iy >> 23 & 0xff;
+  if (e < 0x7f)
+    return 0;
+  if (e > 0x7f + 23)
+    return 2;
+  if (iy & ((1 << (0x7f + 23 - e)) - 1))
+    return 0;
+  if (iy & (1 << (0x7f + 23 - e)))
+    return 1;
+  return 2;
+}
+
+/* Returns 1 if input is the bit representation of 0, infinity or nan.  */
+static inline int
+zeroinfnan (uint32_t ix)
+{
+  return 2 * ix - 1 >= 2u * 0x7f800000 - 1;
+}
+
+float
+powf (float x, float y)
+{
+  uint32_t sign_bias = 0;
+  uint32_t ix, iy;
+  double_t logx, ylogx;
+
+  ix = asuint (x);
+  iy = asuint (y);
+  if (predict_false (ix - 0x00800000 >= 0x7f800000 - 0x00800000
+		     || zeroinfnan (iy)))
+    {
+      /* Either (x < 0x1p-126 or inf or nan) or (y is 0 or inf or nan).  */
+      if (predict_false (zeroinfnan (iy)))
+	{
+	  if (2 * iy == 0)
+	    {
+	      if (2 * ix > 2u * 0x7f800000)
+		return __math_err (x, y, 1.0, 142);
+	      if (2 * ix == 0)
+		return __math_err (x, y, 1.0, 120);
+	      return 1.0f;
+	    }
+	  if (ix == 0x3f800000)
+	    return 1.0f;
+	  if (2 * ix > 2u * 0x7f800000 || 2 * iy > 2u * 0x7f800000)
+	    return x + y;
+	  if (2 * ix == 2 * 0x3f800000)
+	    return 1.0f;
+	  if ((2 * ix < 2 * 0x3f800000) == !(iy & 0x80000000))
+	    return 0.0f; /* |x|<1 && y==inf or |x|>1 && y==-inf.  */
+	  return y * y;
+	}
+      if (predict_false (zeroinfnan (ix)))
+	{
+	  float_t x2 = x * x;
+	  if (ix & 0x80000000 && checkint (iy) == 1)
+	    x2 = -x2;
+	  if (!(iy & 0x80000000))
+	    return x2;
+	  /* Without the barrier some compilers hoist the 1/x2 and thus
+	     division by zero exception can be signaled spuriously.  */
+	  x2 = opt_barrier_float (1 / x2);
+	  if (2 * ix == 0)
+	    return __math_err (x, y, x2, 123);
+	  return x2;
+	}
+      /* x and y are non-zero finite.  */
+      if (ix & 0x80000000)
+	{
+	  /* Finite x < 0.  */
+	  int yint = checkint (iy);
+	  if (yint == 0)
+	    return __math_err (x, y, __math_invalidf (x), 124);
+	  if (yint == 1)
+	    sign_bias = SIGN_BIAS;
+	  ix &= 0x7fffffff;
+	}
+      if (ix < 0x00800000)
+	{
+	  /* Normalize subnormal x so exponent becomes negative.  */
+	  ix = asuint (x * 0x1p23f);
+	  ix &= 0x7fffffff;
+	  ix -= 23 << 23;
+	}
+    }
+  logx = log2_inline (ix);
+  ylogx = y * logx; /* Note: cannot overflow, y is single prec.  */
+  if (predict_false ((asuint64 (ylogx) >> 47 & 0xffff)
+		     >= asuint64 (126.0) >> 47))
+    {
+      /* |y*log(x)| >= 126.  */
+      if (ylogx > 0x1.fffffffd1d571p+6)
+	/* |x^y| > 0x1.ffffffp127.  */
+	return __math_err (x, y, __math_oflowf (sign_bias), 121);
+      if (ylogx <= -150.0)
+	return __math_err (x, y, __math_uflowf (sign_bias), 122);
+    }
+  return eval_as_float (exp2_inline (ylogx, sign_bias));
+}
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
@@ -32,8 +32,11 @@ argument is zero.
 
 The Newlib implementations are not full, intrinisic calculations, but
 rather are derivatives based on <<log>>.  (Accuracy might be slightly off from
-a direct calculation.)  In addition to functions, they are also implemented as
-macros defined in math.h:
+a direct calculation.)  The exception is the <<log2>> function on targets
+which evaluate double expressions in double precision, where it is computed
+directly from the tables used by <<log>> and <<pow>>, and likewise
+<<log2f>> on such targets with double precision hardware.  In addition to
+functions, they are also implemented as macros defined in math.h:
 . #define log2(x) (log (x) / _M_LN2)
 . #define log2f(x) (logf (x) / (float) _M_LN2)
 To use the functions instead, just undefine the macros first.
@@ -70,7 +73,7 @@ C99, POSIX, System V Interface Definition (Issue 6).
 #include <math.h>
 #undef log2
 
-#ifndef _DOUBLE_IS_32BITS
+#if !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH
 
 #ifdef __STDC__
 	double log2(double x)		/* wrapper log2 */
@@ -82,4 +85,4 @@ C99, POSIX, System V Interface Definition (Issue 6).
   return (log(x) / M_LN2);
 }
 
-#endif /* defined(_DOUBLE_IS_32BITS) */
+#endif /* !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH */
@@ -23,6 +23,8 @@
 #undef log2
 #undef log2f
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	float log2f(float x)		/* wrapper log2f */
 #else
@@ -46,3 +48,5 @@
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
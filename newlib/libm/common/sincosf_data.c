@@ -0,0 +1,68 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Data for sinf, cosf and sincosf.  */
+
+#include "fdlibm.h"
+#if !__OBSOLETE_MATH_FLOAT
+
+#include "sincosf.h"
+
+/* The two entries only differ in the sign of the cos polynomial, which
+   lets sincosf_poly produce -cos(x) for the quadrants that need it.  */
+const sincos_t __sincosf_table[2] = {
+  {
+    { 1.0, -1.0, -1.0, 1.0 },
+    0x1.45f306dc9c883p+23,
+    0x1.921fb54442e00p+0, -0x1.cf72cece675d2p-45,
+    0x1.0000000000000p+0, -0x1.fffffffffe3f0p-2, 0x1.55555550fa52ap-5,
+    -0x1.6c16ba7f79559p-10, 0x1.a0124c1dcda1ap-16, -0x1.24634a6bc1a07p-22,
+    -0x1.5555555555103p-3, 0x1.1111110fb9980p-7, -0x1.a019fd5c10f60p-13, 0x1.71d97aaa9764ep-19, -0x1.aa12a8d88773bp-26
+  },
+  {
+    { 1.0, -1.0, -1.0, 1.0 },
+    0x1.45f306dc9c883p+23,
+    0x1.921fb54442e00p+0, -0x1.cf72cece675d2p-45,
+    -0x1.0000000000000p+0, 0x1.fffffffffe3f0p-2, -0x1.55555550fa52ap-5,
+    0x1.6c16ba7f79559p-10, -0x1.a0124c1dcda1ap-16, 0x1.24634a6bc1a07p-22,
+    -0x1.5555555555103p-3, 0x1.1111110fb9980p-7, -0x1.a019fd5c10f60p-13, 0x1.71d97aaa9764ep-19, -0x1.aa12a8d88773bp-26
+  },
+};
+
+/* The bits of 4/PI from its leading one on, that is the fraction of 2/PI,
+   to 192 bit precision.  Entry i holds the 32 bits starting at byte i - 3
+   so that reduce_large can pick the window it needs by exponent.  */
+const uint32_t __inv_pio4[24] = {
+  0x000000a2, 0x0000a2f9, 0x00a2f983, 0xa2f9836e,
+  0xf9836e4e, 0x836e4e44, 0x6e4e4415, 0x4e441529,
+  0x441529fc, 0x1529fc27, 0x29fc2757, 0xfc2757d1,
+  0x2757d1f5, 0x57d1f534, 0xd1f534dd, 0xf534ddc0,
+  0x34ddc0db, 0xddc0db62, 0xc0db6295, 0xdb629599,
+  0x6295993c, 0x95993c43, 0x993c4390, 0x3c439041,
+};
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
@@ -0,0 +1,90 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector double precision exp, the algorithm and table of exp.c.  See
+   v_math.h for how it is built.  */
+
+#ifndef _V_EXP_H
+#define _V_EXP_H
+
+#include "v_math.h"
+
+#if __OBSOLETE_MATH
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f64_t
+v_exp (v_f64_t x)
+{
+  return v_call_f64 (exp, x, x, v_u64 (-1));
+}
+
+#else /* !__OBSOLETE_MATH */
+
+/* exp(X + XTAIL) for |X| < 512 and |XTAIL| < 2^-8/N, where the result is
+   a normal number.  */
+static inline v_f64_t
+v_exp_inline (v_f64_t x, v_f64_t xtail)
+{
+  const double *c = __exp_data.poly;
+  v_f64_t z, kd, r, r2, tail, tmp, scale;
+  v_u64_t ki, idx, sbits;
+
+  /* exp(x) = 2^(k/N) * exp(r), with exp(r) in [2^(-1/2N),2^(1/2N)].  */
+  z = __exp_data.invln2N * x;
+  kd = v_round_f64 (z, &ki);
+  r = x + kd * __exp_data.negln2hiN + kd * __exp_data.negln2loN + xtail;
+
+  /* 2^(k/N) ~= scale * (1 + tail).  */
+  idx = 2 * (ki % (1 << EXP_TABLE_BITS));
+  tail = (v_f64_t) v_lookup_u64 (__exp_data.tab, idx);
+  sbits = v_lookup_u64 (__exp_data.tab, idx + 1) + (ki << (52 - EXP_TABLE_BITS));
+
+  r2 = r * r;
+  tmp = tail + r + r2 * (c[0] + r * c[1]) + r2 * r2 * (c[2] + r * c[3]);
+  scale = (v_f64_t) sbits;
+  return scale + scale * tmp;
+}
+
+static inline v_f64_t
+v_exp (v_f64_t x)
+{
+  v_u64_t special;
+  v_f64_t y;
+
+  /* |x| >= 512 or nan: may overflow, underflow or need the subnormal
+     rounding of the scalar code.  */
+  special = (v_u64_t) v_abs_f64 (x) >= asuint64 (512.0);
+  y = v_exp_inline (x, v_f64 (0));
+  if (predict_false (v_any_u64 (special)))
+    y = v_call_f64 (exp, x, y, special);
+  return y;
+}
+
+#endif /* !__OBSOLETE_MATH */
+
+#endif /* _V_EXP_H */
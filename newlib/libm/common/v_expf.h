@@ -0,0 +1,88 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector single precision exp evaluated in double precision, the
+   algorithm and table of expf.c.  See v_math.h for how it is built.  */
+
+#ifndef _V_EXPF_H
+#define _V_EXPF_H
+
+#include "v_math.h"
+
+#if __OBSOLETE_MATH_FLOAT
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f32_t
+v_expf (v_f32_t x)
+{
+  return v_call_f32 (expf, x, x, v_u32 (-1));
+}
+
+#else /* !__OBSOLETE_MATH_FLOAT */
+
+/* exp(x) for |x| < 88, where the result is a normal float.  */
+static inline v_f64_t
+v_expf_inline (v_f64_t x)
+{
+  const double *c = __exp2f_data.poly_scaled;
+  v_f64_t z, kd, r, r2, s, y;
+  v_u64_t ki, t;
+
+  /* x*N/Ln2 = k + r with r in [-1/2, 1/2] and int k.  */
+  z = __exp2f_data.invln2_scaled * x;
+  kd = v_round_f64 (z, &ki);
+  r = z - kd;
+
+  /* exp(x) = 2^(k/N) * 2^(r/N) ~= s * (1 + r*(C0 + r*(C1 + r*(C2 + r*C3)))).  */
+  t = v_lookup_u64 (__exp2f_data.tab, ki % (1 << EXP2F_TABLE_BITS));
+  t += ki << (52 - EXP2F_TABLE_BITS);
+  s = (v_f64_t) t;
+  r2 = r * r;
+  y = (c[0] + r * c[1]) + r2 * (c[2] + r * c[3]);
+  return s + s * r * y;
+}
+
+static inline v_f32_t
+v_expf (v_f32_t x)
+{
+  v_u32_t special;
+  v_f64_t lo, hi;
+  v_f32_t y;
+
+  /* |x| >= 88 or nan.  */
+  special = (v_u32_t) v_abs_f32 (x) >= asuint (88.0f);
+  v_f32_to_f64 (x, &lo, &hi);
+  y = v_f64_to_f32 (v_expf_inline (lo), v_expf_inline (hi));
+  if (predict_false (v_any_u32 (special)))
+    y = v_call_f32 (expf, x, y, special);
+  return y;
+}
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
+
+#endif /* _V_EXPF_H */
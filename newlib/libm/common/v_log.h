@@ -0,0 +1,99 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector double precision log, the algorithm and table of log.c.  See
+   v_math.h for how it is built.  */
+
+#ifndef _V_LOG_H
+#define _V_LOG_H
+
+#include "v_math.h"
+
+#if __OBSOLETE_MATH
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f64_t
+v_log (v_f64_t x)
+{
+  return v_call_f64 (log, x, x, v_u64 (-1));
+}
+
+#else /* !__OBSOLETE_MATH */
+
+static inline v_f64_t
+v_log (v_f64_t x)
+{
+  const double *b = __pow_log_data.log_poly;
+  v_u64_t ix, tmp, iz, i, special;
+  v_f64_t z, kd, invc, logc, logctail, r, w, hi, lo, r2, r3, y;
+
+  /* x < 0x1p-1022 or inf or nan.  */
+  ix = (v_u64_t) x;
+  special = ix - asuint64 (0x1p-1022)
+	    >= asuint64 (INFINITY) - asuint64 (0x1p-1022);
+
+  /* x = 2^k z; where z is in range [OFF,2*OFF) and exact.  */
+  tmp = ix - 0x3fe6955500000000;
+  i = (tmp >> (52 - POW_LOG_TABLE_BITS)) % (1 << POW_LOG_TABLE_BITS);
+  kd = v_s64_to_f64 ((v_s64_t) tmp >> 52);
+  iz = ix - (tmp & 0xfffULL << 52);
+  z = (v_f64_t) iz;
+  invc = v_lookup_f64 (&__pow_log_data.tab[0].invc,
+		       sizeof (__pow_log_data.tab[0]), i);
+  logc = v_lookup_f64 (&__pow_log_data.tab[0].logc,
+		       sizeof (__pow_log_data.tab[0]), i);
+  logctail = v_lookup_f64 (&__pow_log_data.tab[0].logctail,
+			   sizeof (__pow_log_data.tab[0]), i);
+
+  /* log(x) = k*Ln2 + log(c) + log1p(z/c-1), r = z/c - 1 is exact.  */
+#if V_HAVE_FMA
+  r = v_fma_f64 (z, invc, v_f64 (-1.0));
+#else
+  {
+    v_f64_t zhi = (v_f64_t) ((iz + (1ULL << 31)) & (-1ULL << 32));
+    r = (zhi * invc - 1.0) + (z - zhi) * invc;
+  }
+#endif
+
+  w = kd * __pow_log_data.ln2hi + logc;
+  hi = w + r;
+  lo = w - hi + r + kd * __pow_log_data.ln2lo + logctail;
+
+  r2 = r * r;
+  r3 = r * r2;
+  y = (lo + r2 * b[0]
+       + r3 * (b[1] + r * b[2] + r2 * (b[3] + r * b[4] + r2 * (b[5] + r * b[6])))
+       + hi);
+  if (predict_false (v_any_u64 (special)))
+    y = v_call_f64 (log, x, y, special);
+  return y;
+}
+
+#endif /* !__OBSOLETE_MATH */
+
+#endif /* _V_LOG_H */
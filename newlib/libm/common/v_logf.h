@@ -0,0 +1,95 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector single precision log evaluated in double precision, the
+   algorithm and table of logf.c.  See v_math.h for how it is built.  */
+
+#ifndef _V_LOGF_H
+#define _V_LOGF_H
+
+#include "v_math.h"
+
+#if __OBSOLETE_MATH_FLOAT
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f32_t
+v_logf (v_f32_t x)
+{
+  return v_call_f32 (logf, x, x, v_u32 (-1));
+}
+
+#else /* !__OBSOLETE_MATH_FLOAT */
+
+/* log(2^k z) with the table entries in lanes FIRST.. of I, see logf.c.  */
+static inline v_f64_t
+v_logf_inline (v_f64_t z, v_f64_t k, v_u32_t i, int first)
+{
+  const double *a = __logf_data.poly;
+  v_f64_t invc, logc, r, r2, r4, y0, p;
+
+  invc = v_lookup_f64_u32 (&__logf_data.tab[0].invc,
+			   sizeof (__logf_data.tab[0]), i, first);
+  logc = v_lookup_f64_u32 (&__logf_data.tab[0].logc,
+			   sizeof (__logf_data.tab[0]), i, first);
+
+  /* log(x) = log1p(z/c-1) + log(c) + k*Ln2, r = z/c - 1 is exact.  */
+  r = z * invc - 1.0;
+  y0 = logc + k * __logf_data.ln2;
+  r2 = r * r;
+  r4 = r2 * r2;
+  p = (a[0] + r * a[1]) + r2 * (a[2] + r * a[3]) + r4 * (a[4] + r * a[5]);
+  return y0 + r + r2 * p;
+}
+
+static inline v_f32_t
+v_logf (v_f32_t x)
+{
+  v_u32_t ix, tmp, iz, i, special;
+  v_f64_t zlo, zhi, klo, khi;
+  v_f32_t y;
+
+  /* x < 0x1p-126 or inf or nan.  */
+  ix = (v_u32_t) x;
+  special = ix - 0x00800000 >= 0x7f800000 - 0x00800000;
+
+  /* x = 2^k z; where z is in range [OFF,2*OFF] and exact.  */
+  tmp = ix - 0x3f330000;
+  i = (tmp >> (23 - LOGF_TABLE_BITS)) % (1 << LOGF_TABLE_BITS);
+  iz = ix - (tmp & 0x1ff << 23);
+  v_f32_to_f64 ((v_f32_t) iz, &zlo, &zhi);
+  v_f32_to_f64 (v_s32_to_f32 ((v_s32_t) tmp >> 23), &klo, &khi);
+  y = v_f64_to_f32 (v_logf_inline (zlo, klo, i, 0),
+		    v_logf_inline (zhi, khi, i, V_D));
+  if (predict_false (v_any_u32 (special)))
+    y = v_call_f32 (logf, x, y, special);
+  return y;
+}
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
+
+#endif /* _V_LOGF_H */
@@ -0,0 +1,307 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Helpers for the vector math routines in libm/machine.
+
+   The routines are written once, in terms of the GCC vector types below,
+   and built for each vector width a target supports.  The including file
+   defines V_BITS to that width (128 or 256).  Operations the vector
+   extensions do not cover (fma, conversions between float and double
+   vectors) use the intrinsics of the target.  Lanes that need special
+   handling (overflow, NaN, large trig arguments...) are recomputed with
+   the scalar functions, so that those results and the errors they report
+   are the same as for scalar calls.  */
+
+#ifndef _V_MATH_H
+#define _V_MATH_H
+
+#include <stdint.h>
+#include "fdlibm.h"
+#include "math_config.h"
+
+#if defined (__x86_64__)
+#include <immintrin.h>
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define V_D (V_BITS / 64)	/* Doubles per vector.  */
+#define V_F (V_BITS / 32)	/* Floats per vector.  */
+
+/* Initializer of a vector of doubles from F (lane).  */
+#if V_BITS == 128
+#define V_D_INIT(f) { f (0), f (1) }
+#elif V_BITS == 256
+#define V_D_INIT(f) { f (0), f (1), f (2), f (3) }
+#endif
+
+typedef double v_f64_t __attribute__ ((vector_size (V_BITS / 8)));
+typedef uint64_t v_u64_t __attribute__ ((vector_size (V_BITS / 8)));
+typedef int64_t v_s64_t __attribute__ ((vector_size (V_BITS / 8)));
+typedef float v_f32_t __attribute__ ((vector_size (V_BITS / 8)));
+typedef uint32_t v_u32_t __attribute__ ((vector_size (V_BITS / 8)));
+typedef int32_t v_s32_t __attribute__ ((vector_size (V_BITS / 8)));
+
+#if (defined (__x86_64__) && defined (__FMA__)) || defined (__aarch64__)
+#define V_HAVE_FMA 1
+#else
+#define V_HAVE_FMA 0
+#endif
+
+static inline v_f64_t
+v_f64 (double x)
+{
+  return (v_f64_t) {} + x;
+}
+
+static inline v_u64_t
+v_u64 (uint64_t x)
+{
+  return (v_u64_t) {} + x;
+}
+
+static inline v_f32_t
+v_f32 (float x)
+{
+  return (v_f32_t) {} + x;
+}
+
+static inline v_u32_t
+v_u32 (uint32_t x)
+{
+  return (v_u32_t) {} + x;
+}
+
+static inline v_f64_t
+v_abs_f64 (v_f64_t x)
+{
+  return (v_f64_t) ((v_u64_t) x & 0x7fffffffffffffff);
+}
+
+static inline v_f32_t
+v_abs_f32 (v_f32_t x)
+{
+  return (v_f32_t) ((v_u32_t) x & 0x7fffffff);
+}
+
+/* Lanes of A where MASK is set and of B elsewhere.  */
+static inline v_f64_t
+v_sel_f64 (v_u64_t mask, v_f64_t a, v_f64_t b)
+{
+  return (v_f64_t) ((mask & (v_u64_t) a) | (~mask & (v_u64_t) b));
+}
+
+/* Nonzero if any lane of the mask is set.  */
+static inline int
+v_any_u64 (v_u64_t mask)
+{
+#if defined (__x86_64__) && V_BITS == 128
+  return _mm_movemask_pd ((__m128d) mask);
+#elif defined (__x86_64__) && V_BITS == 256
+  return _mm256_movemask_pd ((__m256d) mask);
+#elif defined (__aarch64__)
+  return vmaxvq_u32 ((uint32x4_t) mask) != 0;
+#else
+  int i;
+  uint64_t r = 0;
+  for (i = 0; i < V_D; i++)
+    r |= mask[i];
+  return r != 0;
+#endif
+}
+
+static inline int
+v_any_u32 (v_u32_t mask)
+{
+#if defined (__x86_64__) && V_BITS == 128
+  return _mm_movemask_ps ((__m128) mask);
+#elif defined (__x86_64__) && V_BITS == 256
+  return _mm256_movemask_ps ((__m256) mask);
+#elif defined (__aarch64__)
+  return vmaxvq_u32 ((uint32x4_t) mask) != 0;
+#else
+  int i;
+  uint32_t r = 0;
+  for (i = 0; i < V_F; i++)
+    r |= mask[i];
+  return r != 0;
+#endif
+}
+
+/* x * y + z, rounded once when V_HAVE_FMA.  */
+static inline v_f64_t
+v_fma_f64 (v_f64_t x, v_f64_t y, v_f64_t z)
+{
+#if defined (__x86_64__) && defined (__FMA__) && V_BITS == 128
+  return _mm_fmadd_pd (x, y, z);
+#elif defined (__x86_64__) && defined (__FMA__) && V_BITS == 256
+  return _mm256_fmadd_pd (x, y, z);
+#elif defined (__aarch64__)
+  return vfmaq_f64 (z, x, y);
+#else
+  return x * y + z;
+#endif
+}
+
+/* Round to the nearest integer, for |x| < 2^51.  The integer is also
+   left in the low bits of *I.  */
+static inline v_f64_t
+v_round_f64 (v_f64_t x, v_u64_t *i)
+{
+  v_f64_t shift = v_f64 (0x1.8p52);
+  v_f64_t k = x + shift;
+  *i = (v_u64_t) k;
+  return k - shift;
+}
+
+/* Signed integers of less than 51 (22 for float) bits to floating
+   point.  */
+static inline v_f64_t
+v_s64_to_f64 (v_s64_t i)
+{
+  v_f64_t shift = v_f64 (0x1.8p52);
+  return (v_f64_t) ((v_u64_t) i + (v_u64_t) shift) - shift;
+}
+
+static inline v_f32_t
+v_s32_to_f32 (v_s32_t i)
+{
+  v_f32_t shift = v_f32 (0x1.8p23f);
+  return (v_f32_t) ((v_u32_t) i + (v_u32_t) shift) - shift;
+}
+
+/* Split a float vector into two double vectors, LO and HI hold the first
+   and last V_F/2 lanes.  */
+static inline void
+v_f32_to_f64 (v_f32_t x, v_f64_t *lo, v_f64_t *hi)
+{
+#if defined (__x86_64__) && V_BITS == 128
+  *lo = _mm_cvtps_pd (x);
+  *hi = _mm_cvtps_pd (_mm_movehl_ps (x, x));
+#elif defined (__x86_64__) && V_BITS == 256
+  *lo = _mm256_cvtps_pd (_mm256_castps256_ps128 (x));
+  *hi = _mm256_cvtps_pd (_mm256_extractf128_ps (x, 1));
+#elif defined (__aarch64__)
+  *lo = vcvt_f64_f32 (vget_low_f32 (x));
+  *hi = vcvt_high_f64_f32 (x);
+#else
+  int i;
+  for (i = 0; i < V_D; i++)
+    {
+      (*lo)[i] = x[i];
+      (*hi)[i] = x[i + V_D];
+    }
+#endif
+}
+
+/* The inverse of v_f32_to_f64, rounding to float.  */
+static inline v_f32_t
+v_f64_to_f32 (v_f64_t lo, v_f64_t hi)
+{
+#if defined (__x86_64__) && V_BITS == 128
+  return _mm_movelh_ps (_mm_cvtpd_ps (lo), _mm_cvtpd_ps (hi));
+#elif defined (__x86_64__) && V_BITS == 256
+  return _mm256_set_m128 (_mm256_cvtpd_ps (hi), _mm256_cvtpd_ps (lo));
+#elif defined (__aarch64__)
+  return vcvt_high_f32_f64 (vcvt_f32_f64 (lo), hi);
+#else
+  v_f32_t r;
+  int i;
+  for (i = 0; i < V_D; i++)
+    {
+      r[i] = lo[i];
+      r[i + V_D] = hi[i];
+    }
+  return r;
+#endif
+}
+
+/* Table lookups.  The vector is built from the loaded values directly,
+   storing them to lanes in memory and loading the vector back would stall
+   on the store forwarding.  Entry I of TAB is STRIDE bytes from entry 0,
+   for the lookup of a member in an array of structs.  */
+static inline v_u64_t
+v_lookup_u64 (const uint64_t *tab, v_u64_t i)
+{
+#define V_LANE(k) tab[i[k]]
+  return (v_u64_t) V_D_INIT (V_LANE);
+#undef V_LANE
+}
+
+static inline v_f64_t
+v_lookup_f64 (const void *tab, size_t stride, v_u64_t i)
+{
+  const char *p = tab;
+#define V_LANE(k) *(const double *) (p + i[k] * stride)
+  return (v_f64_t) V_D_INIT (V_LANE);
+#undef V_LANE
+}
+
+/* The same with the index in lane K + FIRST of a vector of 32-bit
+   integers.  */
+static inline v_f64_t
+v_lookup_f64_u32 (const void *tab, size_t stride, v_u32_t i, int first)
+{
+  const char *p = tab;
+#define V_LANE(k) *(const double *) (p + i[(k) + first] * stride)
+  return (v_f64_t) V_D_INIT (V_LANE);
+#undef V_LANE
+}
+
+/* Recompute the lanes of Y selected by MASK with the scalar F.  */
+static inline v_f64_t
+v_call_f64 (double (*f) (double), v_f64_t x, v_f64_t y, v_u64_t mask)
+{
+  int i;
+  for (i = 0; i < V_D; i++)
+    if (mask[i])
+      y[i] = f (x[i]);
+  return y;
+}
+
+static inline v_f64_t
+v_call2_f64 (double (*f) (double, double), v_f64_t x1, v_f64_t x2,
+	     v_f64_t y, v_u64_t mask)
+{
+  int i;
+  for (i = 0; i < V_D; i++)
+    if (mask[i])
+      y[i] = f (x1[i], x2[i]);
+  return y;
+}
+
+static inline v_f32_t
+v_call_f32 (float (*f) (float), v_f32_t x, v_f32_t y, v_u32_t mask)
+{
+  int i;
+  for (i = 0; i < V_F; i++)
+    if (mask[i])
+      y[i] = f (x[i]);
+  return y;
+}
+
+#endif /* _V_MATH_H */
@@ -0,0 +1,149 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector double precision pow, the algorithm and tables of pow.c.  Only
+   positive normal x, and y and y*log(x) in the range where pow.c needs no
+   special case, are computed in vector lanes.  See v_math.h for how it is
+   built.  */
+
+#ifndef _V_POW_H
+#define _V_POW_H
+
+#include "v_exp.h"
+
+#if __OBSOLETE_MATH
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f64_t
+v_pow (v_f64_t x, v_f64_t y)
+{
+  return v_call2_f64 (pow, x, y, x, v_u64 (-1));
+}
+
+#else /* !__OBSOLETE_MATH */
+
+/* log(x) as y + *TAIL with about 15 bits more than double precision, for
+   positive normal x with bit representation IX.  */
+static inline v_f64_t
+v_pow_log_inline (v_u64_t ix, v_f64_t *tail)
+{
+  const double *a = __pow_log_data.poly;
+  v_u64_t tmp, iz, i;
+  v_f64_t z, kd, invc, logc, logctail, r, t1, t2, lo1, lo2, lo3, lo4;
+  v_f64_t ar, ar2, ar3, hi, p, lo, y;
+
+  tmp = ix - 0x3fe6955500000000;
+  i = (tmp >> (52 - POW_LOG_TABLE_BITS)) % (1 << POW_LOG_TABLE_BITS);
+  kd = v_s64_to_f64 ((v_s64_t) tmp >> 52);
+  iz = ix - (tmp & 0xfffULL << 52);
+  z = (v_f64_t) iz;
+  invc = v_lookup_f64 (&__pow_log_data.tab[0].invc,
+		       sizeof (__pow_log_data.tab[0]), i);
+  logc = v_lookup_f64 (&__pow_log_data.tab[0].logc,
+		       sizeof (__pow_log_data.tab[0]), i);
+  logctail = v_lookup_f64 (&__pow_log_data.tab[0].logctail,
+			   sizeof (__pow_log_data.tab[0]), i);
+
+  /* r = z/c - 1 is exact, see log_inline in pow.c.  */
+#if V_HAVE_FMA
+  r = v_fma_f64 (z, invc, v_f64 (-1.0));
+#else
+  v_f64_t zhi = (v_f64_t) ((iz + (1ULL << 31)) & (-1ULL << 32));
+  v_f64_t rhi = zhi * invc - 1.0;
+  v_f64_t rlo = (z - zhi) * invc;
+  r = rhi + rlo;
+#endif
+
+  /* k*Ln2 + log(c) + r.  */
+  t1 = kd * __pow_log_data.ln2hi + logc;
+  t2 = t1 + r;
+  lo1 = kd * __pow_log_data.ln2lo + logctail;
+  lo2 = t1 - t2 + r;
+
+  /* k*Ln2 + log(c) + r + A[0]*r*r.  */
+  ar = a[0] * r;
+  ar2 = r * ar;
+  ar3 = r * ar2;
+#if V_HAVE_FMA
+  hi = t2 + ar2;
+  lo3 = v_fma_f64 (ar, r, -ar2);
+  lo4 = t2 - hi + ar2;
+#else
+  v_f64_t arhi = a[0] * rhi;
+  v_f64_t arhi2 = rhi * arhi;
+  hi = t2 + arhi2;
+  lo3 = rlo * (ar + arhi);
+  lo4 = t2 - hi + arhi2;
+#endif
+  p = (ar3
+       * (a[1] + r * a[2] + ar2 * (a[3] + r * a[4] + ar2 * (a[5] + r * a[6]))));
+  lo = lo1 + lo2 + lo3 + lo4 + p;
+  y = hi + lo;
+  *tail = hi - y + lo;
+  return y;
+}
+
+static inline v_f64_t
+v_pow (v_f64_t x, v_f64_t y)
+{
+  v_u64_t ix, iy, special;
+  v_f64_t hi, lo, ehi, elo, z;
+
+  ix = (v_u64_t) x;
+  iy = (v_u64_t) y;
+  /* x <= 0, subnormal, inf or nan, or |y| < 2^-65, |y| >= 2^63 or nan.  */
+  special = (ix - asuint64 (0x1p-1022)
+	     >= asuint64 (INFINITY) - asuint64 (0x1p-1022))
+	    | ((iy & 0x7fffffffffffffff) - asuint64 (0x1p-65)
+	       >= asuint64 (0x1p63) - asuint64 (0x1p-65));
+
+  hi = v_pow_log_inline (ix, &lo);
+#if V_HAVE_FMA
+  ehi = y * hi;
+  elo = y * lo + v_fma_f64 (y, hi, -ehi);
+#else
+  {
+    v_f64_t yhi = (v_f64_t) (iy & -1ULL << 27);
+    v_f64_t ylo = y - yhi;
+    v_f64_t lhi = (v_f64_t) ((v_u64_t) hi & -1ULL << 27);
+    v_f64_t llo = hi - lhi + lo;
+    ehi = yhi * lhi;
+    elo = ylo * lhi + y * llo;
+  }
+#endif
+  /* The result may overflow or underflow.  */
+  special |= (v_u64_t) v_abs_f64 (ehi) >= asuint64 (512.0);
+  z = v_exp_inline (ehi, elo);
+  if (predict_false (v_any_u64 (special)))
+    z = v_call2_f64 (pow, x, y, z, special);
+  return z;
+}
+
+#endif /* !__OBSOLETE_MATH */
+
+#endif /* _V_POW_H */
@@ -0,0 +1,172 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector double precision sin, cos and sincos.  The argument reduction is
+   the Cody-Waite reduction of e_rem_pio2.c and the polynomials are those
+   of k_sin.c and k_cos.c, evaluated without branches so that the lanes of
+   a vector can be in different quadrants.  Lanes with |x| >= 2^20, inf or
+   nan use the scalar functions.  See v_math.h for how
+   it is built.  */
+
+#ifndef _V_SIN_H
+#define _V_SIN_H
+
+#include "v_math.h"
+
+static const double
+v_invpio2 =  6.36619772367581382433e-01, /* 0x3FE45F30, 0x6DC9C883 */
+v_pio2_1  =  1.57079632673412561417e+00, /* 0x3FF921FB, 0x54400000 */
+v_pio2_1t =  6.07710050650619224932e-11, /* 0x3DD0B461, 0x1A626331 */
+v_S1  = -1.66666666666666324348e-01, /* 0xBFC55555, 0x55555549 */
+v_S2  =  8.33333333332248946124e-03, /* 0x3F811111, 0x1110F8A6 */
+v_S3  = -1.98412698298579493134e-04, /* 0xBF2A01A0, 0x19C161D5 */
+v_S4  =  2.75573137070700676789e-06, /* 0x3EC71DE3, 0x57B1FE7D */
+v_S5  = -2.50507602534068634195e-08, /* 0xBE5AE5E6, 0x8A2B9CEB */
+v_S6  =  1.58969099521155010221e-10, /* 0x3DE5D93A, 0x5ACFD57C */
+v_C1  =  4.16666666666666019037e-02, /* 0x3FA55555, 0x5555554C */
+v_C2  = -1.38888888888741095749e-03, /* 0xBF56C16C, 0x16C15177 */
+v_C3  =  2.48015872894767294178e-05, /* 0x3EFA01A0, 0x19CB1590 */
+v_C4  = -2.75573143513906633035e-07, /* 0xBE927E4F, 0x809C52AD */
+v_C5  =  2.08757232129817482790e-09, /* 0x3E21EE9E, 0xBDB4B1C4 */
+v_C6  = -1.13596475577881948265e-11; /* 0xBDA8FAE9, 0xBE8838D4 */
+
+/* x = n*pi/2 + y0 + y1 with |y0 + y1| <= pi/4, for |x| < 2^20.  Returns
+   y0, the quadrant is in the low bits of *N.  This is the first step of
+   the medium case of e_rem_pio2.c, which is accurate unless it cancels
+   more than 16 bits of x.  Lanes where that happens are set in *SPECIAL,
+   they are rare and left to the scalar code.  */
+static inline v_f64_t
+v_rem_pio2 (v_f64_t x, v_f64_t *y1, v_u64_t *n, v_u64_t *special)
+{
+  v_f64_t fn, r, w, y0;
+
+  fn = v_round_f64 (x * v_invpio2, n);
+  r = x - fn * v_pio2_1;	/* Exact.  */
+  w = fn * v_pio2_1t;
+  y0 = r - w;
+  *y1 = (r - y0) - w;
+  *special |= (v_u64_t) (v_abs_f64 (y0) < v_abs_f64 (x) * 0x1p-16);
+  return y0;
+}
+
+/* sin(x + y) for |x + y| <= pi/4, see k_sin.c.  */
+static inline v_f64_t
+v_sin_kernel (v_f64_t x, v_f64_t y)
+{
+  v_f64_t z, w, r, v;
+
+  z = x * x;
+  w = z * z;
+  r = v_S2 + z * (v_S3 + z * v_S4) + z * w * (v_S5 + z * v_S6);
+  v = z * x;
+  return x - ((z * (0.5 * y - v * r) - y) - v * v_S1);
+}
+
+/* cos(x + y) for |x + y| <= pi/4.  This is k_cos.c with the branch for
+   |x| > 0.3 replaced by computing 1 - z/2 with its rounding error.  */
+static inline v_f64_t
+v_cos_kernel (v_f64_t x, v_f64_t y)
+{
+  v_f64_t z, w, r, hz;
+
+  z = x * x;
+  w = z * z;
+  r = z * (v_C1 + z * (v_C2 + z * v_C3))
+      + w * w * (v_C4 + z * (v_C5 + z * v_C6));
+  hz = 0.5 * z;
+  w = 1.0 - hz;
+  return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+static inline v_f64_t
+v_neg_if (v_u64_t cond, v_f64_t x)
+{
+  return (v_f64_t) ((v_u64_t) x ^ (cond << 63));
+}
+
+static inline v_f64_t
+v_sin (v_f64_t x)
+{
+  v_u64_t n, odd, special;
+  v_f64_t y0, y1, s, c, r;
+
+  special = ~(v_u64_t) (v_abs_f64 (x) < 0x1p20);
+  y0 = v_rem_pio2 (x, &y1, &n, &special);
+  s = v_sin_kernel (y0, y1);
+  c = v_cos_kernel (y0, y1);
+  odd = -(n & 1);
+  r = v_neg_if ((n >> 1) & 1, v_sel_f64 (odd, c, s));
+  if (predict_false (v_any_u64 (special)))
+    r = v_call_f64 (sin, x, r, special);
+  return r;
+}
+
+static inline v_f64_t
+v_cos (v_f64_t x)
+{
+  v_u64_t n, odd, special;
+  v_f64_t y0, y1, s, c, r;
+
+  special = ~(v_u64_t) (v_abs_f64 (x) < 0x1p20);
+  y0 = v_rem_pio2 (x, &y1, &n, &special);
+  s = v_sin_kernel (y0, y1);
+  c = v_cos_kernel (y0, y1);
+  odd = -(n & 1);
+  r = v_neg_if (((n + 1) >> 1) & 1, v_sel_f64 (odd, s, c));
+  if (predict_false (v_any_u64 (special)))
+    r = v_call_f64 (cos, x, r, special);
+  return r;
+}
+
+static inline void
+v_sincos (v_f64_t x, v_f64_t *sinp, v_f64_t *cosp)
+{
+  v_u64_t n, odd, special;
+  v_f64_t y0, y1, s, c, rs, rc;
+  double s1, c1;
+  int i;
+
+  special = ~(v_u64_t) (v_abs_f64 (x) < 0x1p20);
+  y0 = v_rem_pio2 (x, &y1, &n, &special);
+  s = v_sin_kernel (y0, y1);
+  c = v_cos_kernel (y0, y1);
+  odd = -(n & 1);
+  rs = v_neg_if ((n >> 1) & 1, v_sel_f64 (odd, c, s));
+  rc = v_neg_if (((n + 1) >> 1) & 1, v_sel_f64 (odd, s, c));
+  if (predict_false (v_any_u64 (special)))
+    for (i = 0; i < V_D; i++)
+      if (special[i])
+	{
+	  sincos (x[i], &s1, &c1);
+	  rs[i] = s1;
+	  rc[i] = c1;
+	}
+  *sinp = rs;
+  *cosp = rc;
+}
+
+#endif /* _V_SIN_H */
@@ -0,0 +1,120 @@
+/* Copyright (c) 2018 Arm Ltd.  All rights reserved.
+
+   SPDX-License-Identifier: BSD-3-Clause
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the company may not be used to endorse or promote
+      products derived from this software without specific prior written
+      permission.
+
+   THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+   WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  */
+
+/* Vector single precision sin and cos evaluated in double precision,
+   with the polynomials of sincosf_data.c.  The argument is reduced in
+   double precision by a two step Cody-Waite reduction that is accurate
+   enough for float arguments below 2^20, larger lanes and inf or nan use
+   the scalar functions.  See v_math.h for how it is built.  */
+
+#ifndef _V_SINF_H
+#define _V_SINF_H
+
+#include "v_math.h"
+
+#if __OBSOLETE_MATH_FLOAT
+
+/* Without the tables use the scalar function in each lane.  */
+
+static inline v_f32_t
+v_sinf (v_f32_t x)
+{
+  return v_call_f32 (sinf, x, x, v_u32 (-1));
+}
+
+static inline v_f32_t
+v_cosf (v_f32_t x)
+{
+  return v_call_f32 (cosf, x, x, v_u32 (-1));
+}
+
+#else /* !__OBSOLETE_MATH_FLOAT */
+
+#include "sincosf.h"
+
+/* PI / 2 as a 33 bit high part and a tail, see e_rem_pio2.c.  */
+static const double
+v_f_invpio2 = 6.36619772367581382433e-01,
+v_f_pio2_1 = 1.57079632673412561417e+00,
+v_f_pio2_1t = 6.07710050650619224932e-11;
+
+/* sin (COS == 0) or cos (COS == 1) of x.  */
+static inline v_f64_t
+v_sinf_inline (v_f64_t x, int cos)
+{
+  const sincos_t *p = &__sincosf_table[0];
+  v_u64_t n, odd;
+  v_f64_t fn, r, r2, r4, s, c;
+
+  fn = v_round_f64 (x * v_f_invpio2, &n);
+  r = (x - fn * v_f_pio2_1) - fn * v_f_pio2_1t;
+  n += cos;
+
+  r2 = r * r;
+  r4 = r2 * r2;
+  s = r + r2 * r * (p->s1 + r2 * (p->s2 + r2 * p->s3
+				    + r4 * (p->s4 + r2 * p->s5)));
+  c = p->c0 + r2 * p->c1 + r4 * (p->c2 + r2 * p->c3
+				  + r4 * (p->c4 + r2 * p->c5));
+  odd = -(n & 1);
+  s = v_sel_f64 (odd, c, s);
+  return (v_f64_t) ((v_u64_t) s ^ (((n >> 1) & 1) << 63));
+}
+
+static inline v_f32_t
+v_sinf (v_f32_t x)
+{
+  v_u32_t special;
+  v_f64_t lo, hi;
+  v_f32_t y;
+
+  special = (v_u32_t) v_abs_f32 (x) >= asuint (0x1p20f);
+  v_f32_to_f64 (x, &lo, &hi);
+  y = v_f64_to_f32 (v_sinf_inline (lo, 0), v_sinf_inline (hi, 0));
+  if (predict_false (v_any_u32 (special)))
+    y = v_call_f32 (sinf, x, y, special);
+  return y;
+}
+
+static inline v_f32_t
+v_cosf (v_f32_t x)
+{
+  v_u32_t special;
+  v_f64_t lo, hi;
+  v_f32_t y;
+
+  special = (v_u32_t) v_abs_f32 (x) >= asuint (0x1p20f);
+  v_f32_to_f64 (x, &lo, &hi);
+  y = v_f64_to_f32 (v_sinf_inline (lo, 1), v_sinf_inline (hi, 1));
+  if (predict_false (v_any_u32 (special)))
+    y = v_call_f32 (cosf, x, y, special);
+  return y;
+}
+
+#endif /* !__OBSOLETE_MATH_FLOAT */
+
+#endif /* _V_SINF_H */
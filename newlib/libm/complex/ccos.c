@@ -72,10 +72,9 @@ QUICKREF
 double complex
 ccos(double complex z)
 {
-	double complex w;
-	double ch, sh;
+	double ch, sh, s, c;
 
 	_cchsh(cimag(z), &ch, &sh);
-	w = cos(creal(z)) * ch - (sin(creal(z)) * sh) * I;
-	return w;
+	sincos(creal(z), &s, &c);
+	return _cmplx(c * ch, -(s * sh));
 }
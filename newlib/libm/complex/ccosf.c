@@ -34,15 +34,16 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 #include "cephes_subrf.h"
 
 float complex
 ccosf(float complex z)
 {
-	float complex w;
-	float ch, sh;
+	double ch, sh;
+	float s, c;
 
-	_cchshf(cimagf(z), &ch, &sh);
-	w = cosf(crealf(z)) * ch - (sinf(crealf(z)) * sh) * I;
-	return w;
+	_cchsh(cimagf(z), &ch, &sh);
+	sincosf(crealf(z), &s, &c);
+	return _cmplxf(c * ch, -(s * sh));
 }
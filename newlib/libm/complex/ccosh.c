@@ -67,15 +67,18 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 ccosh(double complex z)
 {
-	double complex w;
-	double x, y;
+	double x, y, ch, sh, s, c;
 
 	x = creal(z);
 	y = cimag(z);
-	w = cosh(x) * cos(y) + (sinh(x) * sin(y)) * I;
-	return w;
+	if (y == 0.0)
+		return _cmplx(cosh(x), __builtin_copysign(0.0, x) * y);
+	_cchsh(x, &ch, &sh);
+	sincos(y, &s, &c);
+	return _cmplx(ch * c, sh * s);
 }
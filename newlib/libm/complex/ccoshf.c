@@ -34,15 +34,20 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
+#include "cephes_subrf.h"
 
 float complex
 ccoshf(float complex z)
 {
-	float complex w;
-	float x, y;
+	double ch, sh;
+	float x, y, s, c;
 
 	x = crealf(z);
 	y = cimagf(z);
-	w = coshf(x) * cosf(y) + (sinhf(x) * sinf(y)) * I;
-	return w;
+	if (y == 0.0f)
+		return _cmplxf(coshf(x), __builtin_copysignf(0.0f, x) * y);
+	_cchsh(x, &ch, &sh);
+	sincosf(y, &s, &c);
+	return _cmplxf(ch * c, sh * s);
 }
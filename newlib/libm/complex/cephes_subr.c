@@ -36,22 +36,29 @@
 #include <math.h>
 #include "cephes_subr.h"
 
-/* calculate cosh and sinh */
+/* calculate cosh and sinh from one exponential */
 
 void
 _cchsh(double x, double *c, double *s)
 {
-	double e, ei;
-
-	if (fabs(x) <= 0.5) {
-		*c = cosh(x);
-		*s = sinh(x);
-	} else {
+	double e, ei, t;
+
+	if (__builtin_fabs(x) <= 0.5) {
+		/* expm1 keeps sinh accurate near 0.  */
+		t = expm1(__builtin_fabs(x));
+		*c = 1.0 + (t * t) / (2.0 * (1.0 + t));
+		*s = __builtin_copysign(0.5 * (t + t / (1.0 + t)), x);
+	} else if (__builtin_fabs(x) < 709.0) {
 		e = exp(x);
 		ei = 0.5 / e;
 		e = 0.5 * e;
 		*s = e - ei;
 		*c = e + ei;
+	} else {
+		/* exp (x) overflows before cosh (x) does.  */
+		e = exp(0.5 * __builtin_fabs(x));
+		*c = (0.5 * e) * e;
+		*s = __builtin_copysign(*c, x);
 	}
 }
 
@@ -61,7 +68,6 @@ _cchsh(double x, double *c, double *s)
 static const double DP1 = 3.14159265160560607910E0;
 static const double DP2 = 1.98418714791870343106E-9;
 static const double DP3 = 1.14423774522196636802E-17;
-#define MACHEP 1.1e-16
 
 double
 _redupi(double x)
@@ -80,47 +86,3 @@ _redupi(double x)
 	t = ((x - t * DP1) - t * DP2) - t * DP3;
 	return t;
 }
-
-/* Taylor series expansion for cosh(2y) - cos(2x) */
-
-double
-_ctans(double complex z)
-{
-	double f, x, x2, y, y2, rn, t;
-	double d;
-
-	x = fabs(2.0 * creal(z));
-	y = fabs(2.0 * cimag(z));
-
-	x = _redupi(x);
-
-	x = x * x;
-	y = y * y;
-	x2 = 1.0;
-	y2 = 1.0;
-	f = 1.0;
-	rn = 0.0;
-	d = 0.0;
-	do {
-		rn += 1.0;
-		f *= rn;
-		rn += 1.0;
-		f *= rn;
-		x2 *= x;
-		y2 *= y;
-		t = y2 + x2;
-		t /= f;
-		d += t;
-
-		rn += 1.0;
-		f *= rn;
-		rn += 1.0;
-		f *= rn;
-		x2 *= x;
-		y2 *= y;
-		t = y2 - x2;
-		t /= f;
-		d += t;
-	} while (fabs(t/d) > MACHEP);
-	return d;
-}
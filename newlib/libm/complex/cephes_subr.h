@@ -2,4 +2,18 @@
 
 void _cchsh(double, double *, double *);
 double _redupi(double);
-double _ctans(double complex);
+
+/* From math.h, where it is a GNU extension.  */
+extern void sincos(double, double *, double *);
+
+/* re + im i.  re + im * I would turn an infinite im into a nan real
+   part.  */
+static __inline double complex
+_cmplx(double re, double im)
+{
+	double complex w;
+
+	__real__ w = re;
+	__imag__ w = im;
+	return w;
+}
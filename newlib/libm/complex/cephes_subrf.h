@@ -1,5 +1,18 @@
 /* $NetBSD: cephes_subrf.h,v 1.1 2007/08/20 16:01:34 drochner Exp $ */
 
-void _cchshf(float, float *, float *);
 float _redupif(float);
-float _ctansf(float complex);
+
+/* From math.h, where it is a GNU extension.  */
+extern void sincosf(float, float *, float *);
+
+/* re + im i.  re + im * I would turn an infinite im into a nan real
+   part.  */
+static __inline float complex
+_cmplxf(float re, float im)
+{
+	float complex w;
+
+	__real__ w = re;
+	__imag__ w = im;
+	return w;
+}
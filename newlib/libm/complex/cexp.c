@@ -67,16 +67,30 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 cexp(double complex z)
 {
-	double complex w;
-	double r, x, y;
+	double r, x, y, s, c;
 
 	x = creal(z);
 	y = cimag(z);
-	r = exp(x);
-	w = r * cos(y) + r * sin(y) * I;
-	return w;
+	/* A real argument gives a real result, also for infinite x.  */
+	if (y == 0.0)
+		return _cmplx(exp(x), y);
+	if (isinf(x) && !isfinite(y)) {
+		/* See C99 G.6.3.1.  */
+		if (x < 0.0)
+			return _cmplx(0.0, __builtin_copysign(0.0, y));
+		return _cmplx(x, y - y);
+	}
+	sincos(y, &s, &c);
+	if (x < 709.0) {
+		r = exp(x);
+		return _cmplx(r * c, r * s);
+	}
+	/* exp (x) overflows before the result does.  */
+	r = exp(0.5 * x);
+	return _cmplx((r * c) * r, (r * s) * r);
 }
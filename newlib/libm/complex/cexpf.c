@@ -34,16 +34,27 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subrf.h"
 
 float complex
 cexpf(float complex z)
 {
-	float complex w;
-	float r, x, y;
+	double r;
+	float x, y, s, c;
 
 	x = crealf(z);
 	y = cimagf(z);
-	r = expf(x);
-	w = r * cosf(y) + r * sinf(y) * I;
-	return w;
+	if (y == 0.0f)
+		return _cmplxf(expf(x), y);
+	if (isinf(x) && !isfinite(y)) {
+		/* See C99 G.6.3.1.  */
+		if (x < 0.0f)
+			return _cmplxf(0.0f, __builtin_copysignf(0.0f, y));
+		return _cmplxf(x, y - y);
+	}
+	sincosf(y, &s, &c);
+	/* In double precision the products overflow only when the result
+	   does.  */
+	r = exp(x);
+	return _cmplxf(r * c, r * s);
 }
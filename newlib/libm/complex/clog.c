@@ -76,16 +76,32 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 clog(double complex z)
 {
-	double complex w;
-	double p, rr;
+	double x, y, ax, ay, r, p;
 
-	rr = cabs(z);
-	p = log(rr);
-	rr = atan2(cimag(z), creal(z));
-	w = p + rr * I;
-	return w;
+	x = creal(z);
+	y = cimag(z);
+	ax = __builtin_fabs(x);
+	ay = __builtin_fabs(y);
+	if (ax < ay) {
+		r = ax;
+		ax = ay;
+		ay = r;
+	}
+	/* log |z| without hypot when the squares can neither overflow nor
+	   underflow, with log1p near the unit circle, where ax - 1 is
+	   exact.  */
+	if (ax > 0x1p-500 && ax < 0x1p500) {
+		r = ax * ax + ay * ay;
+		if (r > 0.5 && r < 2.0)
+			p = 0.5 * log1p((ax - 1.0) * (ax + 1.0) + ay * ay);
+		else
+			p = 0.5 * log(r);
+	} else
+		p = log(hypot(ax, ay));
+	return _cmplx(p, atan2(y, x));
 }
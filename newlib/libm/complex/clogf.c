@@ -34,16 +34,32 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subrf.h"
 
 float complex
 clogf(float complex z)
 {
-	float complex w;
-	float p, rr;
+	double ax, ay, r, p;
+	float x, y;
 
-	rr = cabsf(z);
-	p = logf(rr);
-	rr = atan2f(cimagf(z), crealf(z));
-	w = p + rr * I;
-	return w;
+	x = crealf(z);
+	y = cimagf(z);
+	ax = __builtin_fabsf(x);
+	ay = __builtin_fabsf(y);
+	if (ax < ay) {
+		r = ax;
+		ax = ay;
+		ay = r;
+	}
+	/* The squares of floats are exact in double and can neither
+	   overflow nor underflow, and ax * ax - 1 is exact near the unit
+	   circle.  */
+	r = ax * ax + ay * ay;
+	if (r > 0.5 && r < 2.0)
+		p = 0.5 * log1p((ax * ax - 1.0) + ay * ay);
+	else if (isinf(ax))
+		p = HUGE_VAL;
+	else
+		p = 0.5 * log(r);
+	return _cmplxf(p, atan2f(y, x));
 }
@@ -76,26 +76,28 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 cpow(double complex a, double complex z)
 {
-	double complex w;
-	double x, y, r, theta, absa, arga;
+	double complex l;
+	double x, y, r, theta, s, c;
 
 	x = creal(z);
 	y = cimag(z);
-	absa = cabs(a);
-	if (absa == 0.0) {
-		return (0.0 + 0.0 * I);
+	if (creal(a) == 0.0 && cimag(a) == 0.0)
+		return _cmplx(0.0, 0.0);
+	if (y == 0.0) {
+		/* pow keeps |a|^x accurate for large x.  */
+		r = pow(cabs(a), x);
+		theta = x * carg(a);
+	} else {
+		/* a^z = exp (z log a), with one log and one exp.  */
+		l = clog(a);
+		r = exp(x * creal(l) - y * cimag(l));
+		theta = x * cimag(l) + y * creal(l);
 	}
-	arga = carg(a);
-	r = pow(absa, x);
-	theta = x * arga;
-	if (y != 0.0) {
-		r = r * exp(-y * arga);
-		theta = theta + y * log(absa);
-	}
-	w = r * cos(theta) + (r * sin(theta)) * I;
-	return w;
+	sincos(theta, &s, &c);
+	return _cmplx(r * c, r * s);
 }
@@ -34,26 +34,26 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
+#include "cephes_subrf.h"
 
 float complex
 cpowf(float complex a, float complex z)
 {
-	float complex w;
-	float x, y, r, theta, absa, arga;
+	double x, y, ar, ai, lr, li, r, theta, s, c;
 
 	x = crealf(z);
 	y = cimagf(z);
-	absa = cabsf(a);
-	if (absa == 0.0f) {
-		return (0.0f + 0.0f * I);
-	}
-	arga = cargf(a);
-	r = powf(absa, x);
-	theta = x * arga;
-	if (y != 0.0f) {
-		r = r * expf(-y * arga);
-		theta = theta + y * logf(absa);
-	}
-	w = r * cosf(theta) + (r * sinf(theta)) * I;
-	return w;
+	ar = crealf(a);
+	ai = cimagf(a);
+	if (ar == 0.0 && ai == 0.0)
+		return _cmplxf(0.0f, 0.0f);
+	/* In double precision, where |a|^2 can neither overflow nor
+	   underflow.  */
+	lr = 0.5 * log(ar * ar + ai * ai);
+	li = atan2(ai, ar);
+	r = exp(x * lr - y * li);
+	theta = x * li + y * lr;
+	sincos(theta, &s, &c);
+	return _cmplxf(r * c, r * s);
 }
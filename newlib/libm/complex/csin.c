@@ -72,10 +72,9 @@ QUICKREF
 double complex
 csin(double complex z)
 {
-	double complex w;
-	double ch, sh;
+	double ch, sh, s, c;
 
 	_cchsh(cimag(z), &ch, &sh);
-	w = sin(creal(z)) * ch + (cos(creal(z)) * sh) * I;
-	return w;
+	sincos(creal(z), &s, &c);
+	return _cmplx(s * ch, c * sh);
 }
@@ -34,15 +34,16 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 #include "cephes_subrf.h"
 
 float complex
 csinf(float complex z)
 {
-	float complex w;
-	float ch, sh;
+	double ch, sh;
+	float s, c;
 
-	_cchshf(cimagf(z), &ch, &sh);
-	w = sinf(crealf(z)) * ch + (cosf(crealf(z)) * sh) * I;
-	return w;
+	_cchsh(cimagf(z), &ch, &sh);
+	sincosf(crealf(z), &s, &c);
+	return _cmplxf(s * ch, c * sh);
 }
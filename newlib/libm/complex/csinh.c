@@ -66,15 +66,18 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 csinh(double complex z)
 {
-	double complex w;
-	double x, y;
+	double x, y, ch, sh, s, c;
 
 	x = creal(z);
 	y = cimag(z);
-	w = sinh(x) * cos(y) + (cosh(x) * sin(y)) * I;
-	return w;
+	if (y == 0.0)
+		return _cmplx(sinh(x), y);
+	_cchsh(x, &ch, &sh);
+	sincos(y, &s, &c);
+	return _cmplx(sh * c, ch * s);
 }
@@ -34,15 +34,20 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
+#include "cephes_subrf.h"
 
 float complex
 csinhf(float complex z)
 {
-	float complex w;
-	float x, y;
+	double ch, sh;
+	float x, y, s, c;
 
 	x = crealf(z);
 	y = cimagf(z);
-	w = sinhf(x) * cosf(y) + (coshf(x) * sinf(y)) * I;
-	return w;
+	if (y == 0.0f)
+		return _cmplxf(sinhf(x), y);
+	_cchsh(x, &ch, &sh);
+	sincosf(y, &s, &c);
+	return _cmplxf(sh * c, ch * s);
 }
@@ -69,6 +69,7 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 csqrt(double complex z)
@@ -79,6 +80,15 @@ csqrt(double complex z)
 	x = creal (z);
 	y = cimag (z);
 
+	if (isinf(y))
+		return _cmplx(HUGE_VAL, y);
+	if (isinf(x)) {
+		if (isnan(y))
+			return x > 0 ? _cmplx(x, y) : _cmplx(y, HUGE_VAL);
+		if (x > 0)
+			return _cmplx(x, __builtin_copysign(0.0, y));
+		return _cmplx(0.0, __builtin_copysign(HUGE_VAL, y));
+	}
 	if (y == 0.0) {
 		if (x == 0.0) {
 			w = 0.0 + y * I;
@@ -86,7 +96,7 @@ csqrt(double complex z)
 			r = fabs(x);
 			r = sqrt(r);
 			if (x < 0.0) {
-				w = 0.0 + r * I;
+				w = _cmplx(0.0, __builtin_copysign(r, y));
 			} else {
 				w = r + y * I;
 			}
@@ -102,24 +112,25 @@ csqrt(double complex z)
 			w = r - r * I;
 		return w;
 	}
-	/* Rescale to avoid internal overflow or underflow.  */
-	if ((fabs(x) > 4.0) || (fabs(y) > 4.0)) {
-		x *= 0.25;
-		y *= 0.25;
-		scale = 2.0;
+	if (__builtin_fabs(x) < 0x1p500 && __builtin_fabs(y) < 0x1p500
+	    && (__builtin_fabs(x) > 0x1p-500 || __builtin_fabs(y) > 0x1p-500)) {
+		/* x^2 + y^2 can neither overflow nor underflow.  */
+		r = sqrt(x * x + y * y);
+		scale = 1.0;
 	} else {
-#if 1
-		x *= 1.8014398509481984e16;  /* 2^54 */
-		y *= 1.8014398509481984e16;
-		scale = 7.450580596923828125e-9; /* 2^-27 */
-#else
-		x *= 4.0;
-		y *= 4.0;
-		scale = 0.5;
-#endif
+		/* Rescale to avoid internal overflow or underflow.  */
+		if ((fabs(x) > 4.0) || (fabs(y) > 4.0)) {
+			x *= 0.25;
+			y *= 0.25;
+			scale = 2.0;
+		} else {
+			x *= 1.8014398509481984e16;  /* 2^54 */
+			y *= 1.8014398509481984e16;
+			scale = 7.450580596923828125e-9; /* 2^-27 */
+		}
+		w = x + y * I;
+		r = cabs(w);
 	}
-	w = x + y * I;
-	r = cabs(w);
 	if (x > 0) {
 		t = sqrt(0.5 * r + 0.5 * x);
 		r = scale * fabs((0.5 * y) / t );
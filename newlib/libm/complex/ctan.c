@@ -72,20 +72,19 @@ QUICKREF
 double complex
 ctan(double complex z)
 {
-	double complex w;
-	double d;
-
-	d = cos(2.0 * creal(z)) + cosh(2.0 * cimag(z));
-
-	if (fabs(d) < 0.25)
-		d = _ctans(z);
-
-	if (d == 0.0) {
-		/* mtherr ("ctan", OVERFLOW); */
-		w = HUGE_VAL + HUGE_VAL * I;
-		return w;
+	double x, y, s, c, ch, sh, d, e;
+
+	x = creal(z);
+	y = cimag(z);
+	sincos(x, &s, &c);
+	if (__builtin_fabs(y) > 20.0) {
+		/* tanh (y) rounds to +-1, and the other part is
+		   4 sin x cos x exp (-2 |y|).  */
+		e = exp(-__builtin_fabs(y));
+		return _cmplx(4.0 * s * c * e * e, __builtin_copysign(1.0, y));
 	}
-
-	w = sin(2.0 * creal(z)) / d + (sinh(2.0 * cimag(z)) / d) * I;
-	return w;
+	_cchsh(y, &ch, &sh);
+	/* The denominator is (cos 2x + cosh 2y) / 2, without cancellation.  */
+	d = c * c + sh * sh;
+	return _cmplx(s * c / d, sh * ch / d);
 }
@@ -34,25 +34,25 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 #include "cephes_subrf.h"
 
 float complex
 ctanf(float complex z)
 {
-	float complex w;
-	float d;
+	double x, y, s, c, ch, sh, d, e;
 
-	d = cosf(2.0f * crealf(z)) + coshf(2.0f * cimagf(z));
-
-	if (fabsf(d) < 0.25f)
-		d = _ctansf(z);
-
-	if (d == 0.0f) {
-		/* mtherr ("ctan", OVERFLOW); */
-		w = HUGE_VALF + HUGE_VALF * I;
-		return w;
+	x = crealf(z);
+	y = cimagf(z);
+	sincos(x, &s, &c);
+	if (__builtin_fabs(y) > 20.0) {
+		/* tanh (y) rounds to +-1, and the other part is
+		   4 sin x cos x exp (-2 |y|).  */
+		e = exp(-__builtin_fabs(y));
+		return _cmplxf(4.0 * s * c * e * e, __builtin_copysign(1.0, y));
 	}
-
-	w = sinf(2.0f * crealf(z)) / d + (sinhf(2.0f * cimagf(z)) / d) * I;
-	return w;
+	_cchsh(y, &ch, &sh);
+	/* The denominator is (cos 2x + cosh 2y) / 2, without cancellation.  */
+	d = c * c + sh * sh;
+	return _cmplxf(s * c / d, sh * ch / d);
 }
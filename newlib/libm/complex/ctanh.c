@@ -67,17 +67,24 @@ QUICKREF
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
 
 double complex
 ctanh(double complex z)
 {
-	double complex w;
-	double x, y, d;
+	double x, y, s, c, ch, sh, d, e;
 
 	x = creal(z);
 	y = cimag(z);
-	d = cosh(2.0 * x) + cos(2.0 * y);
-	w = sinh(2.0 * x) / d  +  (sin(2.0 * y) / d) * I;
-
-	return w;
+	sincos(y, &s, &c);
+	if (__builtin_fabs(x) > 20.0) {
+		/* tanh (x) rounds to +-1, and the other part is
+		   4 sin y cos y exp (-2 |x|).  */
+		e = exp(-__builtin_fabs(x));
+		return _cmplx(__builtin_copysign(1.0, x), 4.0 * s * c * e * e);
+	}
+	_cchsh(x, &ch, &sh);
+	/* The denominator is (cos 2y + cosh 2x) / 2, without cancellation.  */
+	d = c * c + sh * sh;
+	return _cmplx(sh * ch / d, s * c / d);
 }
@@ -34,17 +34,25 @@
 
 #include <complex.h>
 #include <math.h>
+#include "cephes_subr.h"
+#include "cephes_subrf.h"
 
 float complex
 ctanhf(float complex z)
 {
-	float complex w;
-	float x, y, d;
+	double x, y, s, c, ch, sh, d, e;
 
 	x = crealf(z);
 	y = cimagf(z);
-	d = coshf(2.0f * x) + cosf(2.0f * y);
-	w = sinhf(2.0f * x) / d  +  (sinf(2.0f * y) / d) * I;
-
-	return w;
+	sincos(y, &s, &c);
+	if (__builtin_fabs(x) > 20.0) {
+		/* tanh (x) rounds to +-1, and the other part is
+		   4 sin y cos y exp (-2 |x|).  */
+		e = exp(-__builtin_fabs(x));
+		return _cmplxf(__builtin_copysign(1.0, x), 4.0 * s * c * e * e);
+	}
+	_cchsh(x, &ch, &sh);
+	/* The denominator is (cos 2y + cosh 2x) / 2, without cancellation.  */
+	d = c * c + sh * sh;
+	return _cmplxf(sh * ch / d, s * c / d);
 }
@@ -0,0 +1,127 @@
+/* Division of double complex numbers, which the compiler calls for a / b
+   unless it may assume a limited range (C99 G.5.1).
+
+   When the parts are well scaled, the plain formula can neither overflow
+   nor underflow and takes two products, a sum and a division per part.
+   Otherwise all four parts are scaled together by a power of 2 and the
+   quotient is taken with Smith's algorithm, as libgcc does, and
+   infinite and zero operands are handled as in the example of G.5.1.  */
+
+#include <complex.h>
+#include <float.h>
+#include <math.h>
+#include "cephes_subr.h"
+
+#define RBIG (DBL_MAX / 2)
+#define RMIN DBL_MIN
+#define RMIN2 DBL_EPSILON
+#define RMINSCAL (1 / DBL_EPSILON)
+#define RMAX2 (RBIG * RMIN2)
+
+static double complex __attribute__ ((__noinline__))
+divdc3_scaled(double a, double b, double c, double d)
+{
+	double ratio, den, x, y;
+
+	/* Divide by the larger part of the divisor.  Halve everything if
+	   the denominator could overflow, and scale up by 2^52 if it or a
+	   product with a tiny part of the dividend could underflow.  */
+	if (__builtin_fabs(c) < __builtin_fabs(d)) {
+		if (__builtin_fabs(d) >= RBIG) {
+			a /= 2;
+			b /= 2;
+			c /= 2;
+			d /= 2;
+		}
+		if (__builtin_fabs(d) < RMIN2
+		    || (__builtin_fabs(d) < RMAX2
+			&& ((__builtin_fabs(a) < RMIN
+			     && __builtin_fabs(b) < RMAX2)
+			    || (__builtin_fabs(b) < RMIN
+				&& __builtin_fabs(a) < RMAX2)))) {
+			a *= RMINSCAL;
+			b *= RMINSCAL;
+			c *= RMINSCAL;
+			d *= RMINSCAL;
+		}
+		ratio = c / d;
+		den = c * ratio + d;
+		/* With a subnormal ratio, divide the dividend first.  */
+		if (__builtin_fabs(ratio) > RMIN) {
+			x = (a * ratio + b) / den;
+			y = (b * ratio - a) / den;
+		} else {
+			x = (c * (a / d) + b) / den;
+			y = (c * (b / d) - a) / den;
+		}
+	} else {
+		if (__builtin_fabs(c) >= RBIG) {
+			a /= 2;
+			b /= 2;
+			c /= 2;
+			d /= 2;
+		}
+		if (__builtin_fabs(c) < RMIN2
+		    || (__builtin_fabs(c) < RMAX2
+			&& ((__builtin_fabs(a) < RMIN
+			     && __builtin_fabs(b) < RMAX2)
+			    || (__builtin_fabs(b) < RMIN
+				&& __builtin_fabs(a) < RMAX2)))) {
+			a *= RMINSCAL;
+			b *= RMINSCAL;
+			c *= RMINSCAL;
+			d *= RMINSCAL;
+		}
+		ratio = d / c;
+		den = d * ratio + c;
+		if (__builtin_fabs(ratio) > RMIN) {
+			x = (b * ratio + a) / den;
+			y = (b - a * ratio) / den;
+		} else {
+			x = (a + d * (b / c)) / den;
+			y = (b - d * (a / c)) / den;
+		}
+	}
+
+	/* Recover infinities and zeros that computed as nan + nan i.  */
+	if (isnan(x) && isnan(y)) {
+		if (c == 0.0 && d == 0.0 && (!isnan(a) || !isnan(b))) {
+			x = __builtin_copysign(HUGE_VAL, c) * a;
+			y = __builtin_copysign(HUGE_VAL, c) * b;
+		} else if ((isinf(a) || isinf(b)) && isfinite(c) && isfinite(d)) {
+			a = __builtin_copysign(isinf(a) ? 1.0 : 0.0, a);
+			b = __builtin_copysign(isinf(b) ? 1.0 : 0.0, b);
+			x = HUGE_VAL * (a * c + b * d);
+			y = HUGE_VAL * (b * c - a * d);
+		} else if ((isinf(c) || isinf(d)) && isfinite(a) && isfinite(b)) {
+			c = __builtin_copysign(isinf(c) ? 1.0 : 0.0, c);
+			d = __builtin_copysign(isinf(d) ? 1.0 : 0.0, d);
+			x = 0.0 * (a * c + b * d);
+			y = 0.0 * (b * c - a * d);
+		}
+	}
+	return _cmplx(x, y);
+}
+
+/* Zero, or far enough from both ends of the range that a product of two
+   such parts and a sum of two such products stay normal.  */
+#define WELL_SCALED(p) \
+	((__builtin_fabs(p) > 0x1p-250 && __builtin_fabs(p) < 0x1p250) \
+	 || (p) == 0.0)
+
+double complex
+__divdc3(double a, double b, double c, double d)
+{
+	double den;
+
+	/* With every part well scaled, and the divisor not zero, neither
+	   the products nor the denominator leave the normal range, and each
+	   part of the quotient is as accurate as the plain formula makes
+	   it.  */
+	if (__builtin_expect(WELL_SCALED(a) && WELL_SCALED(b) && WELL_SCALED(c)
+			     && WELL_SCALED(d) && (c != 0.0 || d != 0.0), 1)) {
+		den = c * c + d * d;
+		return _cmplx((a * c + b * d) / den, (b * c - a * d) / den);
+	}
+	return divdc3_scaled(a, b, c, d);
+}
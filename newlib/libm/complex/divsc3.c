@@ -0,0 +1,23 @@
+/* Division of float complex numbers, see divdc3.c.  In double precision
+   the plain formula can neither overflow nor underflow for finite
+   operands, so only nan results need the scaling and recovery of
+   __divdc3.  */
+
+#include <complex.h>
+#include <math.h>
+#include "cephes_subrf.h"
+
+extern double complex __divdc3(double, double, double, double);
+
+float complex
+__divsc3(float a, float b, float c, float d)
+{
+	double den, x, y;
+
+	den = (double) c * c + (double) d * d;
+	x = ((double) a * c + (double) b * d) / den;
+	y = ((double) b * c - (double) a * d) / den;
+	if (__builtin_expect(isnan(x) && isnan(y), 0))
+		return (float complex) __divdc3(a, b, c, d);
+	return _cmplxf(x, y);
+}
@@ -0,0 +1,64 @@
+/* Multiplication of double complex numbers, which the compiler calls for
+   a * b unless it may assume finite operands (C99 G.5.1).
+
+   The usual case is straight-line arithmetic which the caller's loops
+   do not branch around, and only a nan + nan i result, which may be an
+   infinity computed as inf - inf, goes to the recovery of the infinite
+   operands, out of line.  */
+
+#include <complex.h>
+#include <math.h>
+#include "cephes_subr.h"
+
+/* An infinite part becomes +-1 and a nan part of the other operand +-0,
+   so that the product is recomputed as an infinity of the right
+   direction.  */
+#define BOX(p) ((p) = __builtin_copysign(isinf(p) ? 1.0 : 0.0, (p)))
+#define UNNAN(p) ((p) = isnan(p) ? __builtin_copysign(0.0, (p)) : (p))
+
+static double complex __attribute__ ((__noinline__))
+muldc3_recover(double a, double b, double c, double d, double x, double y)
+{
+	int recalc = 0;
+
+	if (isinf(a) || isinf(b)) {
+		BOX(a);
+		BOX(b);
+		UNNAN(c);
+		UNNAN(d);
+		recalc = 1;
+	}
+	if (isinf(c) || isinf(d)) {
+		BOX(c);
+		BOX(d);
+		UNNAN(a);
+		UNNAN(b);
+		recalc = 1;
+	}
+	if (!recalc && (isinf(a * c) || isinf(b * d)
+			|| isinf(a * d) || isinf(b * c))) {
+		/* Overflow in the products.  */
+		UNNAN(a);
+		UNNAN(b);
+		UNNAN(c);
+		UNNAN(d);
+		recalc = 1;
+	}
+	if (recalc) {
+		x = HUGE_VAL * (a * c - b * d);
+		y = HUGE_VAL * (a * d + b * c);
+	}
+	return _cmplx(x, y);
+}
+
+double complex
+__muldc3(double a, double b, double c, double d)
+{
+	double x, y;
+
+	x = a * c - b * d;
+	y = a * d + b * c;
+	if (__builtin_expect(isnan(x) && isnan(y), 0))
+		return muldc3_recover(a, b, c, d, x, y);
+	return _cmplx(x, y);
+}
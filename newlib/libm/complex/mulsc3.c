@@ -0,0 +1,21 @@
+/* Multiplication of float complex numbers, see muldc3.c.  The products
+   are computed in double precision, where they are exact, so only nan
+   results need the recovery of __muldc3.  */
+
+#include <complex.h>
+#include <math.h>
+#include "cephes_subrf.h"
+
+extern double complex __muldc3(double, double, double, double);
+
+float complex
+__mulsc3(float a, float b, float c, float d)
+{
+	double x, y;
+
+	x = (double) a * c - (double) b * d;
+	y = (double) a * d + (double) b * c;
+	if (__builtin_expect(isnan(x) && isnan(y), 0))
+		return (float complex) __muldc3(a, b, c, d);
+	return _cmplxf(x, y);
+}
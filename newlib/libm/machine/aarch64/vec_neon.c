@@ -0,0 +1,117 @@
+/* Vector math entry points for Advanced SIMD (the AArch64 vector ABI "n"
+   variants that GCC calls for loops vectorized with -ffast-math), see
+   libm/common/v_math.h.  */
+
+#define _GNU_SOURCE
+#define V_BITS 128
+
+#include "v_exp.h"
+#include "v_log.h"
+#include "v_pow.h"
+#include "v_sin.h"
+#include "v_expf.h"
+#include "v_logf.h"
+#include "v_sinf.h"
+
+/* Callers of the vector variants assume that the vector procedure call
+   standard is used, which preserves more of the SIMD registers.  */
+#if __GNUC__ >= 9 || defined (__clang__)
+#define VPCS __attribute__ ((aarch64_vector_pcs))
+#else
+#define VPCS
+#endif
+
+VPCS v_f64_t
+_ZGVnN2v_exp (v_f64_t x)
+{
+  return v_exp (x);
+}
+
+VPCS v_f64_t
+_ZGVnN2v_log (v_f64_t x)
+{
+  return v_log (x);
+}
+
+VPCS v_f64_t
+_ZGVnN2vv_pow (v_f64_t x, v_f64_t y)
+{
+  return v_pow (x, y);
+}
+
+VPCS v_f64_t
+_ZGVnN2v_sin (v_f64_t x)
+{
+  return v_sin (x);
+}
+
+VPCS v_f64_t
+_ZGVnN2v_cos (v_f64_t x)
+{
+  return v_cos (x);
+}
+
+/* sincos with the results stored at SINP and COSP, which point to two
+   consecutive doubles each.  */
+VPCS void
+_ZGVnN2vl8l8_sincos (v_f64_t x, double *sinp, double *cosp)
+{
+  v_f64_t s, c;
+
+  v_sincos (x, &s, &c);
+  vst1q_f64 (sinp, s);
+  vst1q_f64 (cosp, c);
+}
+
+/* sincos with a vector of pointers for each result.  */
+VPCS void
+_ZGVnN2vvv_sincos (v_f64_t x, v_u64_t sinp, v_u64_t cosp)
+{
+  v_f64_t s, c;
+  int i;
+
+  v_sincos (x, &s, &c);
+  for (i = 0; i < V_D; i++)
+    {
+      *(double *) sinp[i] = s[i];
+      *(double *) cosp[i] = c[i];
+    }
+}
+
+VPCS v_f32_t
+_ZGVnN4v_expf (v_f32_t x)
+{
+  return v_expf (x);
+}
+
+VPCS v_f32_t
+_ZGVnN4v_logf (v_f32_t x)
+{
+  return v_logf (x);
+}
+
+VPCS v_f32_t
+_ZGVnN4v_sinf (v_f32_t x)
+{
+  return v_sinf (x);
+}
+
+VPCS v_f32_t
+_ZGVnN4v_cosf (v_f32_t x)
+{
+  return v_cosf (x);
+}
+
+/* The variants for 64-bit vectors of two floats use the ones above on
+   the input duplicated into both halves.  */
+#define WRAP_F2(name)							\
+VPCS float32x2_t							\
+_ZGVnN2v_##name (float32x2_t x)						\
+{									\
+  return vget_low_f32 (v_##name (vcombine_f32 (x, x)));			\
+}
+
+WRAP_F2 (expf)
+WRAP_F2 (logf)
+WRAP_F2 (sinf)
+WRAP_F2 (cosf)
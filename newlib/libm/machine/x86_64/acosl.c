@@ -0,0 +1,10 @@
+/* acosl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+acosl (long double x)
+{
+  return x87_atan2 (x87_sqrt ((1.0L - x) * (1.0L + x)), x);
+}
@@ -0,0 +1,11 @@
+/* asinl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+asinl (long double x)
+{
+  /* 1 - x is exact near 1, and sqrt of a negative raises invalid.  */
+  return x87_atan2 (x, x87_sqrt ((1.0L - x) * (1.0L + x)));
+}
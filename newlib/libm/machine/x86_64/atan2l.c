@@ -0,0 +1,10 @@
+/* atan2l for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+atan2l (long double y, long double x)
+{
+  return x87_atan2 (y, x);
+}
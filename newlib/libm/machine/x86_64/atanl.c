@@ -0,0 +1,10 @@
+/* atanl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+atanl (long double x)
+{
+  return x87_atan2 (x, 1.0L);
+}
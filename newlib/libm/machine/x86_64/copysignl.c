@@ -0,0 +1,10 @@
+/* copysignl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+copysignl (long double x, long double y)
+{
+  return __builtin_copysignl (x, y);
+}
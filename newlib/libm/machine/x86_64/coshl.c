@@ -0,0 +1,26 @@
+/* coshl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+coshl (long double x)
+{
+  long double ax = __builtin_fabsl (x), t, w;
+
+  if (!isfinite (x))
+    return x * x;
+  if (ax < 0.3466L)
+    {
+      t = expm1l (ax);
+      w = 1.0L + t;
+      return 1.0L + (t * t) / (w + w);
+    }
+  if (ax < 11355.0L)
+    {
+      t = expl (ax);
+      return 0.5L * t + 0.5L / t;
+    }
+  t = expl (0.5L * ax);
+  return (0.5L * t) * t;
+}
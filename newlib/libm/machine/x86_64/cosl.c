@@ -0,0 +1,28 @@
+/* cosl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+cosl (long double x)
+{
+  long double r;
+  int n;
+
+  if (__builtin_fabsl (x) <= 0xc.90fdaa22168c235p-4L)
+    return x87_cos (x);
+  if (!isfinite (x))
+    return x - x;
+  r = __x87_rem_pio2l (x, &n);
+  switch (n & 3)
+    {
+    case 0:
+      return x87_cos (r);
+    case 1:
+      return -x87_sin (r);
+    case 2:
+      return -x87_cos (r);
+    default:
+      return x87_sin (r);
+    }
+}
@@ -0,0 +1,19 @@
+/* Run time detection of the instruction set extensions used by the
+   x86_64 libm functions, see x86_64_math.h.  */
+
+#include <cpuid.h>
+#include "x86_64_math.h"
+
+int __x86_64_have_sse4_1 = -1;
+
+int
+__x86_64_init_cpu_features (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  int have = 0;
+
+  if (__get_cpuid (1, &eax, &ebx, &ecx, &edx))
+    have = (ecx & bit_SSE4_1) != 0;
+  __x86_64_have_sse4_1 = have;
+  return have;
+}
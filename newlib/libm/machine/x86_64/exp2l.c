@@ -0,0 +1,18 @@
+/* exp2l for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+exp2l (long double x)
+{
+  long double n;
+
+  if (!isfinite (x))
+    return isinf (x) && x < 0 ? 0.0L : x + x;
+  if (__builtin_fabsl (x) > 17000.0L)
+    x = __builtin_copysignl (17000.0L, x);
+  n = x87_rndint (x);
+  /* x - n is exact.  */
+  return x87_exp2 (n, x - n);
+}
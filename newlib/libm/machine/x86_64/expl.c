@@ -0,0 +1,31 @@
+/* expl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+/* log2(e), and log2(e) split into 32 high bits and the rest.  */
+static const long double
+  log2e = 0xb.8aa3b295c17f0bcp-3L,
+  log2e_hi = 0xb.8aa3b2900000000p-3L,
+  log2e_lo = 0xb.82fe1777d0ffda1p-36L;
+
+long double
+expl (long double x)
+{
+  long double n, f, xh, xl;
+
+  if (!isfinite (x))
+    return isinf (x) && x < 0 ? 0.0L : x + x;
+  /* Beyond the range, keep n representable; the scaling overflows or
+     underflows.  */
+  if (__builtin_fabsl (x) > 12000.0L)
+    x = __builtin_copysignl (12000.0L, x);
+
+  /* x * log2(e) = n + f with f computed to the full precision: xh * log2e_hi
+     is exact, and so is its difference with n.  */
+  n = x87_rndint (x * log2e);
+  xh = x87_trunc_bits (x, 32);
+  xl = x - xh;
+  f = (xh * log2e_hi - n) + (xh * log2e_lo + xl * log2e_hi + xl * log2e_lo);
+  return x87_exp2 (n, f);
+}
@@ -0,0 +1,22 @@
+/* expm1l for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+static const long double log2e = 0xb.8aa3b295c17f0bcp-3L;
+
+long double
+expm1l (long double x)
+{
+  /* |x * log2(e)| < 1.  */
+  if (__builtin_fabsl (x) < 0.5L)
+    return x87_f2xm1 (x * log2e);
+  if (isnan (x))
+    return x + x;
+  /* exp (x) < 2^-66: the result rounds to -1, inexactly.  */
+  if (x < -46.0L)
+    return 0x1p-100L - 1.0L;
+  /* exp (x) is at least 1.6 or at most 0.6, so the subtraction is
+     accurate.  */
+  return expl (x) - 1.0L;
+}
@@ -0,0 +1,10 @@
+/* fabsl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+fabsl (long double x)
+{
+  return __builtin_fabsl (x);
+}
@@ -0,0 +1,10 @@
+/* floorl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+floorl (long double x)
+{
+  return x87_rndint_rc (x, X87_RC_DOWN);
+}
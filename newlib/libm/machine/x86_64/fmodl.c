@@ -0,0 +1,18 @@
+/* fmodl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+fmodl (long double x, long double y)
+{
+  long double r = x;
+  unsigned short sw;
+
+  /* fprem reduces the exponent by at most 63 at a time and sets C2 until the
+     remainder is complete.  */
+  do
+    __asm__ ("fprem; fnstsw %%ax" : "=t" (r), "=a" (sw) : "0" (r), "u" (y));
+  while (sw & 0x0400);
+  return r;
+}
@@ -0,0 +1,21 @@
+/* frexpl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+frexpl (long double x, int *e)
+{
+  long double m, k;
+
+  /* fxtract raises divide by zero for zeros.  */
+  if (x == 0 || !isfinite (x))
+    {
+      *e = 0;
+      return x + x;
+    }
+  /* x = m * 2^k with m in [1, 2), also for subnormals.  */
+  __asm__ ("fxtract" : "=t" (m), "=u" (k) : "0" (x));
+  *e = (int) k + 1;
+  return 0.5L * m;
+}
@@ -0,0 +1,15 @@
+/* ldexpl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include <errno.h>
+#include "x87.h"
+
+long double
+ldexpl (long double x, int n)
+{
+  long double r = x87_scale (x, (long double) n);
+
+  if (isfinite (x) && x != 0 && (!isfinite (r) || r == 0))
+    errno = ERANGE;
+  return r;
+}
@@ -0,0 +1,13 @@
+/* llrintl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long long
+llrintl (long double x)
+{
+  long long r;
+
+  __asm__ ("fistpll %0" : "=m" (r) : "t" (x) : "st");
+  return r;
+}
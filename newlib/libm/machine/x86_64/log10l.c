@@ -0,0 +1,15 @@
+/* log10l for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+/* log10(2).  */
+static const long double lg2 = 0x9.a209a84fbcff799p-5L;
+
+long double
+log10l (long double x)
+{
+  if (__builtin_fabsl (x - 1.0L) < 0.29L)
+    return x87_yl2xp1 (x - 1.0L, lg2);
+  return x87_yl2x (x, lg2);
+}
@@ -0,0 +1,14 @@
+/* log1pl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+static const long double ln2 = 0xb.17217f7d1cf79acp-4L;
+
+long double
+log1pl (long double x)
+{
+  if (__builtin_fabsl (x) < 0.29L)
+    return x87_yl2xp1 (x, ln2);
+  return x87_yl2x (1.0L + x, ln2);
+}
@@ -0,0 +1,12 @@
+/* log2l for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+log2l (long double x)
+{
+  if (__builtin_fabsl (x - 1.0L) < 0.29L)
+    return x87_yl2xp1 (x - 1.0L, 1.0L);
+  return x87_yl2x (x, 1.0L);
+}
@@ -0,0 +1,16 @@
+/* logl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+static const long double ln2 = 0xb.17217f7d1cf79acp-4L;
+
+long double
+logl (long double x)
+{
+  /* fyl2xp1 is more accurate near 1, and x - 1 is exact there.  fyl2x
+     gives the special cases of C99.  */
+  if (__builtin_fabsl (x - 1.0L) < 0.29L)
+    return x87_yl2xp1 (x - 1.0L, ln2);
+  return x87_yl2x (x, ln2);
+}
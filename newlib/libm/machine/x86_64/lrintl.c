@@ -0,0 +1,13 @@
+/* lrintl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long
+lrintl (long double x)
+{
+  long long r;
+
+  __asm__ ("fistpll %0" : "=m" (r) : "t" (x) : "st");
+  return r;
+}
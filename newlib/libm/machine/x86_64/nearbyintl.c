@@ -0,0 +1,24 @@
+/* nearbyintl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+nearbyintl (long double x)
+{
+  unsigned short sw, env[14];
+  long double r;
+
+  __asm__ __volatile__ ("fnstsw %0" : "=a" (sw));
+  __asm__ __volatile__ ("frndint" : "=t" (r) : "0" (x));
+  /* Clear the inexact exception which frndint raised, unless it was
+     already set.  fldenv also restores the control word, which fnstenv
+     changes.  */
+  if (r != x && !(sw & 0x20))
+    {
+      __asm__ __volatile__ ("fnstenv %0" : "=m" (env) : "t" (r));
+      env[2] &= ~0x20;
+      __asm__ __volatile__ ("fldenv %0" : : "m" (env), "t" (r));
+    }
+  return r;
+}
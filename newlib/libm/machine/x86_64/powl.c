@@ -0,0 +1,170 @@
+/* powl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+/* 2/ln(2) split into 32 high bits and the rest.  */
+static const long double
+  k_hi = 0xb.8aa3b2900000000p-2L,
+  k_lo = 0xb.82fe1777d0ffda1p-35L;
+
+/* hi + lo = a * b exactly, by splitting a and b into 32-bit halves.  */
+static inline void
+mul12 (long double a, long double b, long double *hi, long double *lo)
+{
+  long double a1 = x87_trunc_bits (a, 32), a2 = a - a1;
+  long double b1 = x87_trunc_bits (b, 32), b2 = b - b1;
+
+  *hi = a * b;
+  *lo = (((a1 * b1 - *hi) + a1 * b2) + a2 * b1) + a2 * b2;
+}
+
+/* hi + lo = log2 (m) for m in [sqrt(1/2), sqrt(2)), to about 2^-75, from
+   2 atanh (s) / ln(2) with s = (m - 1) / (m + 1).  */
+static void
+log2_ext (long double m, long double *hi, long double *lo)
+{
+  long double u, vh, vl, sh, sl, ph, pl, s2, e, c, d, h, l, q, t;
+  int i;
+
+  /* s = sh + sl, |s| < 0.172.  */
+  u = m - 1.0L;
+  vh = m + 1.0L;
+  vl = m - (vh - 1.0L);
+  sh = u / vh;
+  mul12 (sh, vh, &ph, &pl);
+  sl = (((u - ph) - pl) - sh * vl) / vh;
+
+  /* atanh (s) = s + s^3/3 + s^3 (s^2/5 + ... + s^24/27).  s^3/3 = h + l
+     is computed in extra precision, and the rest only needs to be
+     accurate to a few ulp.  */
+  mul12 (sh, sh, &s2, &e);
+  mul12 (s2, sh, &c, &d);
+  d += e * sh + 3.0L * s2 * sl;
+  h = c / 3.0L;
+  mul12 (h, 3.0L, &ph, &pl);
+  l = (((c - ph) - pl) + d) / 3.0L;
+  q = 1.0L / 27;
+  for (i = 25; i >= 5; i -= 2)
+    q = q * s2 + 1.0L / i;
+  t = sl + l + c * s2 * q;
+
+  /* Multiply sh + h + t by 2/ln(2).  */
+  mul12 (sh, k_hi, &c, &d);
+  mul12 (h, k_hi, &ph, &pl);
+  *hi = c + ph;
+  l = (c - *hi) + ph;
+  l += d + pl + (sh + h) * k_lo + t * (k_hi + k_lo);
+  h = *hi + l;
+  *lo = l - (h - *hi);
+  *hi = h;
+}
+
+/* 0 if y is not an integer, 1 if it is odd and 2 if it is even.  |y| is
+   an integer when it rounds to itself, and odd when y * 0.5, which is
+   exact, does not.  */
+static int
+y_int (long double y)
+{
+  long double h;
+
+  if (x87_rndint (y) != y)
+    return 0;
+  h = 0.5L * y;
+  return x87_rndint (h) != h ? 1 : 2;
+}
+
+long double
+powl (long double x, long double y)
+{
+  long double ax, k, yh, yl, lh, ll, zh, zl, a, b, n, t, f, r;
+  union x87_u u;
+  int yint, neg = 0;
+
+  if (y == 0 || x == 1.0L)
+    return 1.0L;
+  if (isnan (x) || isnan (y))
+    return x + y;
+  ax = __builtin_fabsl (x);
+  yint = y_int (y);
+
+  if (isinf (y))
+    {
+      if (ax == 1.0L)
+	return 1.0L;
+      return (ax < 1.0L) == (y < 0) ? HUGE_VALL : 0.0L;
+    }
+  if (x == 0)
+    {
+      /* 1 / x is an infinity of the sign of x and raises divide by zero.  */
+      if (y < 0)
+	return yint == 1 ? 1.0L / x : 1.0L / ax;
+      return yint == 1 ? x : 0.0L;
+    }
+  if (isinf (x))
+    {
+      if (y < 0)
+	return yint == 1 ? 1.0L / x : 0.0L;
+      return yint == 1 ? x : ax;
+    }
+  if (x < 0)
+    {
+      if (yint == 0)
+	return (x - x) / (x - x);
+      neg = yint == 1;
+      if (ax == 1.0L)
+	return neg ? -1.0L : 1.0L;
+    }
+
+  /* |y * log2 (ax)| >= 2^16 when ax != 1: the result overflows or
+     underflows.  */
+  if (__builtin_fabsl (y) >= 0x1p80L)
+    {
+      r = (ax > 1.0L) == (y > 0) ? 0x1p16000L * 0x1p16000L
+				 : 0x1p-16000L * 0x1p-16000L;
+      return neg ? -r : r;
+    }
+
+  /* ax = m * 2^k with m in [sqrt(1/2), sqrt(2)).  */
+  k = 0;
+  if (x87_exp (ax) == 0)
+    {
+      ax *= 0x1p64L;
+      k = -64;
+    }
+  u.ld = ax;
+  k += (u.p.se & 0x7fff) - 0x3fff;
+  u.p.se = 0x3fff;
+  if (u.ld > 0xb.504f333f9de6484p-3L)
+    {
+      u.p.se = 0x3ffe;
+      k += 1;
+    }
+  log2_ext (u.ld, &lh, &ll);
+
+  /* y * log2 (ax) = y * k + y * (lh + ll).  y is split so that yh * k and
+     yl * k are exact, and y * lh is computed exactly.  The integral parts
+     are taken out of the large terms before they are added.  */
+  yh = x87_trunc_bits (y, 15);
+  yl = y - yh;
+  a = yh * k;
+  b = yl * k;
+  mul12 (y, lh, &zh, &zl);
+  zl += y * ll;
+
+  n = x87_rndint (a);
+  a -= n;
+  t = x87_rndint (zh);
+  zh -= t;
+  n += t;
+  t = x87_rndint (b);
+  b -= t;
+  n += t;
+  f = ((a + zh) + b) + zl;
+  t = x87_rndint (f);
+  f -= t;
+  n += t;
+
+  r = x87_exp2 (n, f);
+  return neg ? -r : r;
+}
@@ -0,0 +1,10 @@
+/* rintl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+rintl (long double x)
+{
+  return x87_rndint (x);
+}
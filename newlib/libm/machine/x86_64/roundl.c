@@ -0,0 +1,15 @@
+/* roundl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+roundl (long double x)
+{
+  long double t = x87_rndint_rc (x, X87_RC_ZERO);
+
+  /* x - t is exact, and nan for infinities.  */
+  if (__builtin_fabsl (x - t) >= 0.5L)
+    t += __builtin_copysignl (1.0L, x);
+  return t;
+}
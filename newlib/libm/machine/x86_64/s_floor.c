@@ -0,0 +1,24 @@
+/* floor for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+double
+floor (double x)
+{
+  double t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSD (t, x, ROUND_FLOOR);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabs (x) < TWO52))
+    return x + 0;
+  t = (double) (long long) x;
+  if (t > x)
+    t -= 1.0;
+  return __builtin_copysign (t, x);
+}
@@ -0,0 +1,11 @@
+/* __fpclassifyd for x86_64, which GCC expands to a few floating point
+   comparisons.  */
+
+#include <math.h>
+
+int
+__fpclassifyd (double x)
+{
+  return __builtin_fpclassify (FP_NAN, FP_INFINITE, FP_NORMAL, FP_SUBNORMAL,
+			       FP_ZERO, x);
+}
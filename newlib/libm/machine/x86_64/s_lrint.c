@@ -0,0 +1,15 @@
+/* lrint for x86_64.  The SSE2 conversion rounds in the current rounding
+   mode and returns the integer indefinite value if the result does not
+   fit.  */
+
+#include <math.h>
+
+
+long int
+lrint (double x)
+{
+  long int r;
+
+  __asm__ __volatile__ ("cvtsd2si %1, %0" : "=r" (r) : "xm" (x));
+  return r;
+}
@@ -0,0 +1,18 @@
+/* nearbyint for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+double
+nearbyint (double x)
+{
+  double t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSD (t, x, ROUND_NEARBYINT);
+      return t;
+    }
+  return rint (x);
+}
@@ -0,0 +1,23 @@
+/* rint for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+double
+rint (double x)
+{
+  double t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSD (t, x, ROUND_NEAREST_INT);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabs (x) < TWO52))
+    return x + 0;
+  /* Adding 2^52 rounds away the fraction in the current rounding mode.  */
+  t = (__builtin_fabs (x) + TWO52) - TWO52;
+  return __builtin_copysign (t, x);
+}
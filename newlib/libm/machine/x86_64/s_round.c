@@ -0,0 +1,25 @@
+/* round for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+double
+round (double x)
+{
+  double t;
+
+  if (have_sse4_1 ())
+    ROUNDSD (t, x, ROUND_TRUNC);
+  else
+    {
+      /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+      if (!(__builtin_fabs (x) < TWO52))
+	return x + 0;
+      t = __builtin_copysign ((double) (long long) x, x);
+    }
+  /* x - t is exact.  */
+  if (__builtin_fabs (x - t) >= 0.5)
+    t += __builtin_copysign (1.0, x);
+  return t;
+}
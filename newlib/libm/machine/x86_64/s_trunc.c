@@ -0,0 +1,22 @@
+/* trunc for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+double
+trunc (double x)
+{
+  double t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSD (t, x, ROUND_TRUNC);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabs (x) < TWO52))
+    return x + 0;
+  t = (double) (long long) x;
+  return __builtin_copysign (t, x);
+}
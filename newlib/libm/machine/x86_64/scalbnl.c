@@ -0,0 +1,10 @@
+/* scalbnl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+scalbnl (long double x, int n)
+{
+  return x87_scale (x, (long double) n);
+}
@@ -0,0 +1,24 @@
+/* floorf for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+float
+floorf (float x)
+{
+  float t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSS (t, x, ROUND_FLOOR);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabsf (x) < TWO23))
+    return x + 0;
+  t = (float) (int) x;
+  if (t > x)
+    t -= 1.0f;
+  return __builtin_copysignf (t, x);
+}
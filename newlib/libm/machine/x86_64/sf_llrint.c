@@ -0,0 +1,15 @@
+/* llrintf for x86_64.  The SSE2 conversion rounds in the current rounding
+   mode and returns the integer indefinite value if the result does not
+   fit.  */
+
+#include <math.h>
+
+
+long long int
+llrintf (float x)
+{
+  long long int r;
+
+  __asm__ __volatile__ ("cvtss2si %1, %0" : "=r" (r) : "xm" (x));
+  return r;
+}
@@ -0,0 +1,18 @@
+/* nearbyintf for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+float
+nearbyintf (float x)
+{
+  float t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSS (t, x, ROUND_NEARBYINT);
+      return t;
+    }
+  return rintf (x);
+}
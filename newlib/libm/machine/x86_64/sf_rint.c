@@ -0,0 +1,23 @@
+/* rintf for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+float
+rintf (float x)
+{
+  float t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSS (t, x, ROUND_NEAREST_INT);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabsf (x) < TWO23))
+    return x + 0;
+  /* Adding 2^23 rounds away the fraction in the current rounding mode.  */
+  t = (__builtin_fabsf (x) + TWO23) - TWO23;
+  return __builtin_copysignf (t, x);
+}
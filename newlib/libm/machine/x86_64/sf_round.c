@@ -0,0 +1,25 @@
+/* roundf for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+float
+roundf (float x)
+{
+  float t;
+
+  if (have_sse4_1 ())
+    ROUNDSS (t, x, ROUND_TRUNC);
+  else
+    {
+      /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+      if (!(__builtin_fabsf (x) < TWO23))
+	return x + 0;
+      t = __builtin_copysignf ((float) (int) x, x);
+    }
+  /* x - t is exact.  */
+  if (__builtin_fabsf (x - t) >= 0.5f)
+    t += __builtin_copysignf (1.0f, x);
+  return t;
+}
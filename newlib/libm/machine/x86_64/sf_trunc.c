@@ -0,0 +1,22 @@
+/* truncf for x86_64, see x86_64_math.h.  */
+
+#include <math.h>
+#include "x86_64_math.h"
+
+
+float
+truncf (float x)
+{
+  float t;
+
+  if (have_sse4_1 ())
+    {
+      ROUNDSS (t, x, ROUND_TRUNC);
+      return t;
+    }
+  /* Integral, inf or nan.  The addition quiets a signaling nan.  */
+  if (!(__builtin_fabsf (x) < TWO23))
+    return x + 0;
+  t = (float) (int) x;
+  return __builtin_copysignf (t, x);
+}
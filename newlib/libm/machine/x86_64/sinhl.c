@@ -0,0 +1,32 @@
+/* sinhl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+sinhl (long double x)
+{
+  long double ax = __builtin_fabsl (x), t, r;
+
+  if (!isfinite (x))
+    return x + x;
+  if (ax < 0x1p-33L)
+    return x;
+  if (ax < 1.0L)
+    {
+      t = expm1l (ax);
+      r = 0.5L * (t + t / (t + 1.0L));
+    }
+  else if (ax < 11355.0L)
+    {
+      t = expl (ax);
+      r = 0.5L * (t - 1.0L / t);
+    }
+  else
+    {
+      /* exp (ax) would overflow before the result does.  */
+      t = expl (0.5L * ax);
+      r = (0.5L * t) * t;
+    }
+  return __builtin_copysignl (r, x);
+}
@@ -0,0 +1,29 @@
+/* sinl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+sinl (long double x)
+{
+  long double r;
+  int n;
+
+  if (__builtin_fabsl (x) <= 0xc.90fdaa22168c235p-4L)
+    return x87_sin (x);
+  /* inf - inf raises invalid.  */
+  if (!isfinite (x))
+    return x - x;
+  r = __x87_rem_pio2l (x, &n);
+  switch (n & 3)
+    {
+    case 0:
+      return x87_sin (r);
+    case 1:
+      return x87_cos (r);
+    case 2:
+      return -x87_sin (r);
+    default:
+      return -x87_cos (r);
+    }
+}
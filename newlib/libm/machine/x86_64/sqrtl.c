@@ -0,0 +1,10 @@
+/* sqrtl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+sqrtl (long double x)
+{
+  return x87_sqrt (x);
+}
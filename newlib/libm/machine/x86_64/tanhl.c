@@ -0,0 +1,29 @@
+/* tanhl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+tanhl (long double x)
+{
+  long double ax = __builtin_fabsl (x), t, r;
+
+  if (isnan (x))
+    return x + x;
+  if (ax < 0x1p-33L)
+    return x;
+  if (ax < 1.0L)
+    {
+      t = expm1l (-2.0L * ax);
+      r = -t / (t + 2.0L);
+    }
+  else if (ax < 23.0L)
+    {
+      t = expm1l (2.0L * ax);
+      r = 1.0L - 2.0L / (t + 2.0L);
+    }
+  else
+    /* 1 - 2^-100 raises inexact and rounds to 1.  */
+    r = 1.0L - 0x1p-100L;
+  return __builtin_copysignl (r, x);
+}
@@ -0,0 +1,30 @@
+/* tanl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+static inline long double
+x87_tan (long double r)
+{
+  long double t;
+
+  /* fptan pushes 1 after the result.  */
+  __asm__ ("fptan; fstp %%st(0)" : "=t" (t) : "0" (r));
+  return t;
+}
+
+long double
+tanl (long double x)
+{
+  long double r;
+  int n;
+
+  if (__builtin_fabsl (x) <= 0xc.90fdaa22168c235p-4L)
+    return x87_tan (x);
+  if (!isfinite (x))
+    return x - x;
+  r = __x87_rem_pio2l (x, &n);
+  if (n & 1)
+    return -1.0L / x87_tan (r);
+  return x87_tan (r);
+}
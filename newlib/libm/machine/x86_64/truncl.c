@@ -0,0 +1,10 @@
+/* truncl for x86_64, see x87.h.  */
+
+#include <math.h>
+#include "x87.h"
+
+long double
+truncl (long double x)
+{
+  return x87_rndint_rc (x, X87_RC_ZERO);
+}
@@ -0,0 +1,72 @@
+/* Vector math entry points for AVX (the x86_64 vector ABI "c" variants).
+   AVX has no 256-bit integer operations, so these split their arguments
+   and call the SSE2 versions in vec_sse2.c on each half.  */
+
+#pragma GCC target ("avx")
+
+#include <immintrin.h>
+
+__m128d _ZGVbN2v_exp (__m128d);
+__m128d _ZGVbN2v_log (__m128d);
+__m128d _ZGVbN2vv_pow (__m128d, __m128d);
+__m128d _ZGVbN2v_sin (__m128d);
+__m128d _ZGVbN2v_cos (__m128d);
+void _ZGVbN2vl8l8_sincos (__m128d, double *, double *);
+void _ZGVbN2vvv_sincos (__m128d, __m128i, __m128i);
+__m128 _ZGVbN4v_expf (__m128);
+__m128 _ZGVbN4v_logf (__m128);
+__m128 _ZGVbN4v_sinf (__m128);
+__m128 _ZGVbN4v_cosf (__m128);
+
+#define LO_PD(x) _mm256_castpd256_pd128 (x)
+#define HI_PD(x) _mm256_extractf128_pd (x, 1)
+#define LO_PS(x) _mm256_castps256_ps128 (x)
+#define HI_PS(x) _mm256_extractf128_ps (x, 1)
+
+#define WRAP_D(name)							\
+__m256d									\
+_ZGVcN4v_##name (__m256d x)						\
+{									\
+  return _mm256_set_m128d (_ZGVbN2v_##name (HI_PD (x)),			\
+			   _ZGVbN2v_##name (LO_PD (x)));		\
+}
+
+#define WRAP_F(name)							\
+__m256									\
+_ZGVcN8v_##name (__m256 x)						\
+{									\
+  return _mm256_set_m128 (_ZGVbN4v_##name (HI_PS (x)),			\
+			  _ZGVbN4v_##name (LO_PS (x)));			\
+}
+
+WRAP_D (exp)
+WRAP_D (log)
+WRAP_D (sin)
+WRAP_D (cos)
+WRAP_F (expf)
+WRAP_F (logf)
+WRAP_F (sinf)
+WRAP_F (cosf)
+
+__m256d
+_ZGVcN4vv_pow (__m256d x, __m256d y)
+{
+  return _mm256_set_m128d (_ZGVbN2vv_pow (HI_PD (x), HI_PD (y)),
+			   _ZGVbN2vv_pow (LO_PD (x), LO_PD (y)));
+}
+
+void
+_ZGVcN4vl8l8_sincos (__m256d x, double *sinp, double *cosp)
+{
+  _ZGVbN2vl8l8_sincos (LO_PD (x), sinp, cosp);
+  _ZGVbN2vl8l8_sincos (HI_PD (x), sinp + 2, cosp + 2);
+}
+
+/* The vectors of four pointers are passed as two halves each.  */
+void
+_ZGVcN4vvv_sincos (__m256d x, __m128i sinp_lo, __m128i sinp_hi,
+		   __m128i cosp_lo, __m128i cosp_hi)
+{
+  _ZGVbN2vvv_sincos (LO_PD (x), sinp_lo, cosp_lo);
+  _ZGVbN2vvv_sincos (HI_PD (x), sinp_hi, cosp_hi);
+}
@@ -0,0 +1,98 @@
+/* Vector math entry points for AVX2 (the x86_64 vector ABI "d" variants),
+   see vec_sse2.c.  These are only called by code compiled for AVX2, so
+   they are built for it and may use fma whatever the compiler options of
+   the library are.  */
+
+#pragma GCC target ("avx2,fma")
+
+#define _GNU_SOURCE
+#define V_BITS 256
+
+#include "v_exp.h"
+#include "v_log.h"
+#include "v_pow.h"
+#include "v_sin.h"
+#include "v_expf.h"
+#include "v_logf.h"
+#include "v_sinf.h"
+
+v_f64_t
+_ZGVdN4v_exp (v_f64_t x)
+{
+  return v_exp (x);
+}
+
+v_f64_t
+_ZGVdN4v_log (v_f64_t x)
+{
+  return v_log (x);
+}
+
+v_f64_t
+_ZGVdN4vv_pow (v_f64_t x, v_f64_t y)
+{
+  return v_pow (x, y);
+}
+
+v_f64_t
+_ZGVdN4v_sin (v_f64_t x)
+{
+  return v_sin (x);
+}
+
+v_f64_t
+_ZGVdN4v_cos (v_f64_t x)
+{
+  return v_cos (x);
+}
+
+/* sincos with the results stored at SINP and COSP, which point to four
+   consecutive doubles each.  */
+void
+_ZGVdN4vl8l8_sincos (v_f64_t x, double *sinp, double *cosp)
+{
+  v_f64_t s, c;
+
+  v_sincos (x, &s, &c);
+  __builtin_memcpy (sinp, &s, sizeof (s));
+  __builtin_memcpy (cosp, &c, sizeof (c));
+}
+
+/* sincos with a vector of pointers for each result.  */
+void
+_ZGVdN4vvv_sincos (v_f64_t x, v_u64_t sinp, v_u64_t cosp)
+{
+  v_f64_t s, c;
+  int i;
+
+  v_sincos (x, &s, &c);
+  for (i = 0; i < V_D; i++)
+    {
+      *(double *) sinp[i] = s[i];
+      *(double *) cosp[i] = c[i];
+    }
+}
+
+v_f32_t
+_ZGVdN8v_expf (v_f32_t x)
+{
+  return v_expf (x);
+}
+
+v_f32_t
+_ZGVdN8v_logf (v_f32_t x)
+{
+  return v_logf (x);
+}
+
+v_f32_t
+_ZGVdN8v_sinf (v_f32_t x)
+{
+  return v_sinf (x);
+}
+
+v_f32_t
+_ZGVdN8v_cosf (v_f32_t x)
+{
+  return v_cosf (x);
+}
@@ -0,0 +1,75 @@
+/* Vector math entry points for AVX-512 (the x86_64 vector ABI "e"
+   variants).  These split their arguments and call the AVX2 versions in
+   vec_avx2.c on each half.  */
+
+#pragma GCC target ("avx512f")
+
+#include <immintrin.h>
+
+__m256d _ZGVdN4v_exp (__m256d);
+__m256d _ZGVdN4v_log (__m256d);
+__m256d _ZGVdN4vv_pow (__m256d, __m256d);
+__m256d _ZGVdN4v_sin (__m256d);
+__m256d _ZGVdN4v_cos (__m256d);
+void _ZGVdN4vl8l8_sincos (__m256d, double *, double *);
+void _ZGVdN4vvv_sincos (__m256d, __m256i, __m256i);
+__m256 _ZGVdN8v_expf (__m256);
+__m256 _ZGVdN8v_logf (__m256);
+__m256 _ZGVdN8v_sinf (__m256);
+__m256 _ZGVdN8v_cosf (__m256);
+
+#define LO_PD(x) _mm512_castpd512_pd256 (x)
+#define HI_PD(x) _mm512_extractf64x4_pd (x, 1)
+#define JOIN_PD(hi, lo) _mm512_insertf64x4 (_mm512_castpd256_pd512 (lo), hi, 1)
+#define LO_PS(x) _mm256_castpd_ps (LO_PD (_mm512_castps_pd (x)))
+#define HI_PS(x) _mm256_castpd_ps (HI_PD (_mm512_castps_pd (x)))
+#define JOIN_PS(hi, lo) \
+  _mm512_castpd_ps (JOIN_PD (_mm256_castps_pd (hi), _mm256_castps_pd (lo)))
+#define LO_EPI(x) _mm512_castsi512_si256 (x)
+#define HI_EPI(x) _mm512_extracti64x4_epi64 (x, 1)
+
+#define WRAP_D(name)							\
+__m512d									\
+_ZGVeN8v_##name (__m512d x)						\
+{									\
+  return JOIN_PD (_ZGVdN4v_##name (HI_PD (x)),				\
+		  _ZGVdN4v_##name (LO_PD (x)));				\
+}
+
+#define WRAP_F(name)							\
+__m512									\
+_ZGVeN16v_##name (__m512 x)						\
+{									\
+  return JOIN_PS (_ZGVdN8v_##name (HI_PS (x)),				\
+		  _ZGVdN8v_##name (LO_PS (x)));				\
+}
+
+WRAP_D (exp)
+WRAP_D (log)
+WRAP_D (sin)
+WRAP_D (cos)
+WRAP_F (expf)
+WRAP_F (logf)
+WRAP_F (sinf)
+WRAP_F (cosf)
+
+__m512d
+_ZGVeN8vv_pow (__m512d x, __m512d y)
+{
+  return JOIN_PD (_ZGVdN4vv_pow (HI_PD (x), HI_PD (y)),
+		  _ZGVdN4vv_pow (LO_PD (x), LO_PD (y)));
+}
+
+void
+_ZGVeN8vl8l8_sincos (__m512d x, double *sinp, double *cosp)
+{
+  _ZGVdN4vl8l8_sincos (LO_PD (x), sinp, cosp);
+  _ZGVdN4vl8l8_sincos (HI_PD (x), sinp + 4, cosp + 4);
+}
+
+void
+_ZGVeN8vvv_sincos (__m512d x, __m512i sinp, __m512i cosp)
+{
+  _ZGVdN4vvv_sincos (LO_PD (x), LO_EPI (sinp), LO_EPI (cosp));
+  _ZGVdN4vvv_sincos (HI_PD (x), HI_EPI (sinp), HI_EPI (cosp));
+}
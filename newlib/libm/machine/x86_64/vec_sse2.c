@@ -0,0 +1,95 @@
+/* Vector math entry points for SSE2 (the x86_64 vector ABI "b" variants
+   that GCC calls for loops vectorized with -ffast-math), see
+   libm/common/v_math.h.  */
+
+#define _GNU_SOURCE
+#define V_BITS 128
+
+#include "v_exp.h"
+#include "v_log.h"
+#include "v_pow.h"
+#include "v_sin.h"
+#include "v_expf.h"
+#include "v_logf.h"
+#include "v_sinf.h"
+
+v_f64_t
+_ZGVbN2v_exp (v_f64_t x)
+{
+  return v_exp (x);
+}
+
+v_f64_t
+_ZGVbN2v_log (v_f64_t x)
+{
+  return v_log (x);
+}
+
+v_f64_t
+_ZGVbN2vv_pow (v_f64_t x, v_f64_t y)
+{
+  return v_pow (x, y);
+}
+
+v_f64_t
+_ZGVbN2v_sin (v_f64_t x)
+{
+  return v_sin (x);
+}
+
+v_f64_t
+_ZGVbN2v_cos (v_f64_t x)
+{
+  return v_cos (x);
+}
+
+/* sincos with the results stored at SINP and COSP, which point to two
+   consecutive doubles each.  */
+void
+_ZGVbN2vl8l8_sincos (v_f64_t x, double *sinp, double *cosp)
+{
+  v_f64_t s, c;
+
+  v_sincos (x, &s, &c);
+  __builtin_memcpy (sinp, &s, sizeof (s));
+  __builtin_memcpy (cosp, &c, sizeof (c));
+}
+
+/* sincos with a vector of pointers for each result.  */
+void
+_ZGVbN2vvv_sincos (v_f64_t x, v_u64_t sinp, v_u64_t cosp)
+{
+  v_f64_t s, c;
+  int i;
+
+  v_sincos (x, &s, &c);
+  for (i = 0; i < V_D; i++)
+    {
+      *(double *) sinp[i] = s[i];
+      *(double *) cosp[i] = c[i];
+    }
+}
+
+v_f32_t
+_ZGVbN4v_expf (v_f32_t x)
+{
+  return v_expf (x);
+}
+
+v_f32_t
+_ZGVbN4v_logf (v_f32_t x)
+{
+  return v_logf (x);
+}
+
+v_f32_t
+_ZGVbN4v_sinf (v_f32_t x)
+{
+  return v_sinf (x);
+}
+
+v_f32_t
+_ZGVbN4v_cosf (v_f32_t x)
+{
+  return v_cosf (x);
+}
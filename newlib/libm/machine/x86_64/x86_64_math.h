@@ -0,0 +1,56 @@
+/* Helpers for the x86_64 rounding and conversion functions.
+
+   The base x86_64 instruction set has SSE2, which only converts to
+   integer with truncation or in the current rounding mode.  SSE4.1 adds
+   roundsd and roundss, which round to an integral value in any mode in
+   one instruction.  When the library is not built for SSE4.1 the
+   functions check the processor at run time and otherwise use the SSE2
+   conversions.  */
+
+#ifndef _X86_64_MATH_H
+#define _X86_64_MATH_H
+
+/* Rounding control immediates of roundsd and roundss.  8 suppresses the
+   inexact exception.  */
+#define ROUND_NEAREST_INT	4
+#define ROUND_NEARBYINT		12
+#define ROUND_FLOOR		9
+#define ROUND_CEIL		10
+#define ROUND_TRUNC		11
+
+/* R = X rounded to an integral value with rounding control MODE.  The
+   modes that round as MXCSR says read it, which the compiler does not
+   see, so the instructions must not be moved across a fesetround.  */
+#define ROUNDSD(r, x, mode) \
+  __asm__ __volatile__ ("roundsd %2, %1, %0" : "=x" (r) \
+			: "x" (x), "i" (mode))
+#define ROUNDSS(r, x, mode) \
+  __asm__ __volatile__ ("roundss %2, %1, %0" : "=x" (r) \
+			: "x" (x), "i" (mode))
+
+/* Set to 1 if the processor has SSE4.1 and 0 if not by
+   __x86_64_init_cpu_features, -1 before that.  */
+extern int __x86_64_have_sse4_1;
+extern int __x86_64_init_cpu_features (void);
+
+static inline int
+have_sse4_1 (void)
+{
+#ifdef __SSE4_1__
+  return 1;
+#else
+  int have = __x86_64_have_sse4_1;
+
+  if (__builtin_expect (have < 0, 0))
+    have = __x86_64_init_cpu_features ();
+  return have;
+#endif
+}
+
+/* Above these magnitudes every double or float is an integer (or inf or
+   nan), and below them the value fits the integer of cvttsd2si and
+   cvttss2si.  */
+#define TWO52	0x1p52
+#define TWO23	0x1p23f
+
+#endif /* _X86_64_MATH_H */
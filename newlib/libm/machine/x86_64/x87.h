@@ -0,0 +1,165 @@
+/* Helpers for the long double functions, which use the x87 unit.
+
+   long double is the x87 80-bit format, and the x87 instructions for
+   logarithms, exponentials, arctangent, square root, rounding and scaling
+   compute these to nearly the full 64-bit precision.  They honour the
+   rounding mode and raise the exceptions of the x87 control and status
+   words, so the functions behave under fenv like the arithmetic does.  */
+
+#ifndef _X87_H
+#define _X87_H
+
+#include <math.h>
+#include <stdint.h>
+
+/* Access to the representation.  */
+union x87_u
+{
+  long double ld;
+  struct
+  {
+    uint64_t m;
+    uint16_t se;
+  } p;
+};
+
+static inline int
+x87_exp (long double x)
+{
+  union x87_u u = { .ld = x };
+
+  return u.p.se & 0x7fff;
+}
+
+/* x with the low BITS bits of the significand cleared, so that products
+   of such values are exact.  */
+static inline long double
+x87_trunc_bits (long double x, int bits)
+{
+  union x87_u u = { .ld = x };
+
+  u.p.m &= ~(((uint64_t) 1 << bits) - 1);
+  return u.ld;
+}
+
+static inline long double
+x87_rndint (long double x)
+{
+  long double r;
+
+  __asm__ ("frndint" : "=t" (r) : "0" (x));
+  return r;
+}
+
+/* x * 2^n for integral n.  */
+static inline long double
+x87_scale (long double x, long double n)
+{
+  long double r;
+
+  __asm__ ("fscale" : "=t" (r) : "0" (x), "u" (n));
+  return r;
+}
+
+/* 2^x - 1 for |x| <= 1.  */
+static inline long double
+x87_f2xm1 (long double x)
+{
+  long double r;
+
+  __asm__ ("f2xm1" : "=t" (r) : "0" (x));
+  return r;
+}
+
+/* y * log2 (x).  */
+static inline long double
+x87_yl2x (long double x, long double y)
+{
+  long double r;
+
+  __asm__ ("fyl2x" : "=t" (r) : "0" (x), "u" (y) : "st(1)");
+  return r;
+}
+
+/* y * log2 (x + 1) for |x| < 1 - sqrt(2)/2.  */
+static inline long double
+x87_yl2xp1 (long double x, long double y)
+{
+  long double r;
+
+  __asm__ ("fyl2xp1" : "=t" (r) : "0" (x), "u" (y) : "st(1)");
+  return r;
+}
+
+/* atan2 (y, x), with the special cases of C99.  */
+static inline long double
+x87_atan2 (long double y, long double x)
+{
+  long double r;
+
+  __asm__ ("fpatan" : "=t" (r) : "0" (x), "u" (y) : "st(1)");
+  return r;
+}
+
+static inline long double
+x87_sqrt (long double x)
+{
+  long double r;
+
+  __asm__ ("fsqrt" : "=t" (r) : "0" (x));
+  return r;
+}
+
+/* The rounding control field of the control word.  */
+#define X87_RC_MASK	0x0c00
+#define X87_RC_DOWN	0x0400
+#define X87_RC_UP	0x0800
+#define X87_RC_ZERO	0x0c00
+
+/* x rounded to an integral value in rounding direction RC.  */
+static inline long double
+x87_rndint_rc (long double x, unsigned short rc)
+{
+  unsigned short cw, tmp;
+  long double r;
+
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (cw));
+  tmp = (cw & ~X87_RC_MASK) | rc;
+  __asm__ __volatile__ ("fldcw %0" : : "m" (tmp));
+  __asm__ __volatile__ ("frndint" : "=t" (r) : "0" (x));
+  __asm__ __volatile__ ("fldcw %0" : : "m" (cw));
+  return r;
+}
+
+/* 2^x, accurate for x which is the sum of an integer and a fraction
+   computed without rounding error.  */
+static inline long double
+x87_exp2 (long double n, long double f)
+{
+  return x87_scale (1.0L + x87_f2xm1 (f), n);
+}
+
+/* The reduced argument r of x for sin, cos and tan, in [-pi/4, pi/4],
+   and the quadrant in *N.  */
+extern long double __x87_rem_pio2l (long double x, int *n);
+
+/* sin and cos of |r| <= pi/4.  */
+static inline long double
+x87_sin (long double r)
+{
+  long double s;
+
+  __asm__ ("fsin" : "=t" (s) : "0" (r));
+  return s;
+}
+
+static inline long double
+x87_cos (long double r)
+{
+  long double c;
+
+  __asm__ ("fcos" : "=t" (c) : "0" (r));
+  return c;
+}
+
+#endif /* _X87_H */
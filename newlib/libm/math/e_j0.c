@@ -21,15 +21,11 @@
  *	   (precision:  |j0-1+z/4-z^2R0/S0 |<2**-63.67 )
  *	   for x in (2,inf)
  * 		j0(x) = sqrt(2/(pi*x))*(p0(x)*cos(x0)-q0(x)*sin(x0))
- * 	   where x0 = x-pi/4. It is better to compute sin(x0),cos(x0)
- *	   as follow:
- *		cos(x0) = cos(x)cos(pi/4)+sin(x)sin(pi/4)
- *			= 1/sqrt(2) * (cos(x) + sin(x))
- *		sin(x0) = sin(x)cos(pi/4)-cos(x)sin(pi/4)
- *			= 1/sqrt(2) * (sin(x) - cos(x))
- * 	   (To avoid cancellation, use
- *		sin(x) +- cos(x) = -cos(2x)/(sin(x) -+ cos(x))
- * 	    to compute the worse one.)
+ * 	   where x0 = x-pi/4.  sin(x0) and cos(x0) are computed
+ *	   together by __kernel_sincos_pio4, with one argument
+ *	   reduction and without cancellation, and then passed to
+ *	   __kernel_j0, which jn and the batch functions in s_jnbatch.c
+ *	   use to share them between j0, j1, y0 and y1 at the same x.
  *	   
  *	3 Special cases
  *		j0(nan)= nan
@@ -51,8 +47,7 @@
  *		y0(tiny) = u0 + (2/pi)*ln(tiny), (choose tiny<2**-27)
  *	2. For x>=2.
  * 		y0(x) = sqrt(2/(pi*x))*(p0(x)*cos(x0)+q0(x)*sin(x0))
- * 	   where x0 = x-pi/4. It is better to compute sin(x0),cos(x0)
- *	   by the method mentioned above.
+ * 	   where x0 = x-pi/4, see above.
  *	3. Special cases: y0(0)=-inf, y0(x<0)=NaN, y0(inf)=0.
  */
 
@@ -73,7 +68,7 @@ static double
 #endif
 huge 	= 1e300,
 one	= 1.0,
-invsqrtpi=  5.64189583547756279280e-01, /* 0x3FE20DD7, 0x50429B6D */
+sqrt2opi =  7.97884560802865405726e-01, /* 0x3FE98845, 0x33D43651 */
 tpi      =  6.36619772367581382433e-01, /* 0x3FE45F30, 0x6DC9C883 */
  		/* R0/S0 on [0, 2.00] */
 R02  =  1.56249999999999947958e-02, /* 0x3F8FFFFF, 0xFFFFFFFD */
@@ -98,7 +93,7 @@ static double zero = 0.0;
 	double x;
 #endif
 {
-	double z, s,c,ss,cc,r,u,v;
+	double z, s,c,r,u;
 	__int32_t hx,ix;
 
 	GET_HIGH_WORD(hx,x);
@@ -106,25 +101,8 @@ static double zero = 0.0;
 	if(ix>=0x7ff00000) return one/(x*x);
 	x = fabs(x);
 	if(ix >= 0x40000000) {	/* |x| >= 2.0 */
-		s = sin(x);
-		c = cos(x);
-		ss = s-c;
-		cc = s+c;
-		if(ix<0x7fe00000) {  /* make sure x+x not overflow */
-		    z = -cos(x+x);
-		    if ((s*c)<zero) cc = z/ss;
-		    else 	    ss = z/cc;
-		}
-	/*
-	 * j0(x) = 1/sqrt(pi) * (P(0,x)*cc - Q(0,x)*ss) / sqrt(x)
-	 * y0(x) = 1/sqrt(pi) * (P(0,x)*ss + Q(0,x)*cc) / sqrt(x)
-	 */
-		if(ix>0x48000000) z = (invsqrtpi*cc)/__ieee754_sqrt(x);
-		else {
-		    u = pzero(x); v = qzero(x);
-		    z = invsqrtpi*(u*cc-v*ss)/__ieee754_sqrt(x);
-		}
-		return z;
+		__kernel_sincos_pio4(x,&s,&c);
+		return __kernel_j0(x,s,c,0);
 	}
 	if(ix<0x3f200000) {	/* |x| < 2**-13 */
 	    if(huge+x>one) {	/* raise inexact if x != 0 */
@@ -167,7 +145,7 @@ v04  =  4.41110311332675467403e-10; /* 0x3DFE5018, 0x3BD6D9EF */
 	double x;
 #endif
 {
-	double z, s,c,ss,cc,u,v;
+	double z, s,c,u,v;
 	__int32_t hx,ix,lx;
 
 	EXTRACT_WORDS(hx,lx,x);
@@ -176,37 +154,9 @@ v04  =  4.41110311332675467403e-10; /* 0x3DFE5018, 0x3BD6D9EF */
 	if(ix>=0x7ff00000) return  one/(x+x*x); 
         if((ix|lx)==0) return -one/zero;
         if(hx<0) return zero/zero;
-        if(ix >= 0x40000000) {  /* |x| >= 2.0 */
-        /* y0(x) = sqrt(2/(pi*x))*(p0(x)*sin(x0)+q0(x)*cos(x0))
-         * where x0 = x-pi/4
-         *      Better formula:
-         *              cos(x0) = cos(x)cos(pi/4)+sin(x)sin(pi/4)
-         *                      =  1/sqrt(2) * (sin(x) + cos(x))
-         *              sin(x0) = sin(x)cos(3pi/4)-cos(x)sin(3pi/4)
-         *                      =  1/sqrt(2) * (sin(x) - cos(x))
-         * To avoid cancellation, use
-         *              sin(x) +- cos(x) = -cos(2x)/(sin(x) -+ cos(x))
-         * to compute the worse one.
-         */
-                s = sin(x);
-                c = cos(x);
-                ss = s-c;
-                cc = s+c;
-	/*
-	 * j0(x) = 1/sqrt(pi) * (P(0,x)*cc - Q(0,x)*ss) / sqrt(x)
-	 * y0(x) = 1/sqrt(pi) * (P(0,x)*ss + Q(0,x)*cc) / sqrt(x)
-	 */
-                if(ix<0x7fe00000) {  /* make sure x+x not overflow */
-                    z = -cos(x+x);
-                    if ((s*c)<zero) cc = z/ss;
-                    else            ss = z/cc;
-                }
-                if(ix>0x48000000) z = (invsqrtpi*ss)/__ieee754_sqrt(x);
-                else {
-                    u = pzero(x); v = qzero(x);
-                    z = invsqrtpi*(u*ss+v*cc)/__ieee754_sqrt(x);
-                }
-                return z;
+	if(ix >= 0x40000000) {	/* |x| >= 2.0 */
+		__kernel_sincos_pio4(x,&s,&c);
+		return __kernel_j0(x,s,c,1);
 	}
 	if(ix<=0x3e400000) {	/* x < 2**-27 */
 	    return(u00 + tpi*__ieee754_log(x));
@@ -217,6 +167,35 @@ v04  =  4.41110311332675467403e-10; /* 0x3DFE5018, 0x3BD6D9EF */
 	return(u/v + tpi*(__ieee754_j0(x)*__ieee754_log(x)));
 }
 
+/* __kernel_j0(x, s, c, k)
+ * j0(x) for k == 0, y0(x) otherwise, for 2 <= x < inf, where
+ * s = sin(x-pi/4) and c = cos(x-pi/4) from __kernel_sincos_pio4.
+ * Where the result is small the sum of the two terms cancels, and
+ * it is recomputed from the phase atan(q/p), see __kernel_sin_pio4.
+ */
+#ifdef __STDC__
+	double __kernel_j0(double x, double s, double c, int k)
+#else
+	double __kernel_j0(x, s, c, k)
+	double x, s, c; int k;
+#endif
+{
+	double u,v,z;
+	__int32_t ix;
+
+	GET_HIGH_WORD(ix,x);
+	if(ix>0x48000000) {
+	    u = one; v = zero;
+	} else {
+	    u = pzero(x); v = qzero(x);
+	}
+	if(k==0) z = u*c-v*s;
+	else	 z = u*s+v*c;
+	if(fabs(z)<0.25&&v!=zero)	/* near a zero, see __kernel_sin_pio4 */
+	    z = __ieee754_sqrt(u*u+v*v)*__kernel_sin_pio4(x,atan(v/u),k==0);
+	return sqrt2opi*z/__ieee754_sqrt(x);
+}
+
 /* The asymptotic expansions of pzero is
  *	1 - 9/128 s^2 + 11025/98304 s^4 - ...,	where s = 1/x.
  * For x >= 2, We approximate pzero by
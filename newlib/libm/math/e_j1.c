@@ -22,15 +22,11 @@
  *	   for x in (2,inf)
  * 		j1(x) = sqrt(2/(pi*x))*(p1(x)*cos(x1)-q1(x)*sin(x1))
  * 		y1(x) = sqrt(2/(pi*x))*(p1(x)*sin(x1)+q1(x)*cos(x1))
- * 	   where x1 = x-3*pi/4. It is better to compute sin(x1),cos(x1)
- *	   as follow:
- *		cos(x1) =  cos(x)cos(3pi/4)+sin(x)sin(3pi/4)
- *			=  1/sqrt(2) * (sin(x) - cos(x))
- *		sin(x1) =  sin(x)cos(3pi/4)-cos(x)sin(3pi/4)
- *			= -1/sqrt(2) * (sin(x) + cos(x))
- * 	   (To avoid cancellation, use
- *		sin(x) +- cos(x) = -cos(2x)/(sin(x) -+ cos(x))
- * 	    to compute the worse one.)
+ * 	   where x1 = x-3*pi/4 = x0-pi/2, x0 = x-pi/4, so that
+ *		cos(x1) =  sin(x0)
+ *		sin(x1) = -cos(x0)
+ *	   with sin(x0) and cos(x0) from __kernel_sincos_pio4 as for
+ *	   j0, see __kernel_j1.
  *	   
  *	3 Special cases
  *		j1(nan)= nan
@@ -52,8 +48,7 @@
  *		y1(tiny) = -2/pi/tiny, (choose tiny<2**-54)
  *	3. For x>=2.
  * 		y1(x) = sqrt(2/(pi*x))*(p1(x)*sin(x1)+q1(x)*cos(x1))
- * 	   where x1 = x-3*pi/4. It is better to compute sin(x1),cos(x1)
- *	   by method mentioned above.
+ * 	   where x1 = x-3*pi/4, see above.
  */
 
 #include "fdlibm.h"
@@ -73,7 +68,7 @@ static double
 #endif
 huge    = 1e300,
 one	= 1.0,
-invsqrtpi=  5.64189583547756279280e-01, /* 0x3FE20DD7, 0x50429B6D */
+sqrt2opi =  7.97884560802865405726e-01, /* 0x3FE98845, 0x33D43651 */
 tpi      =  6.36619772367581382433e-01, /* 0x3FE45F30, 0x6DC9C883 */
 	/* R0/S0 on [0,2] */
 r00  = -6.25000000000000000000e-02, /* 0xBFB00000, 0x00000000 */
@@ -99,7 +94,7 @@ static double zero    = 0.0;
 	double x;
 #endif
 {
-	double z, s,c,ss,cc,r,u,v,y;
+	double z, s,c,r,y;
 	__int32_t hx,ix;
 
 	GET_HIGH_WORD(hx,x);
@@ -107,24 +102,8 @@ static double zero    = 0.0;
 	if(ix>=0x7ff00000) return one/x;
 	y = fabs(x);
 	if(ix >= 0x40000000) {	/* |x| >= 2.0 */
-		s = sin(y);
-		c = cos(y);
-		ss = -s-c;
-		cc = s-c;
-		if(ix<0x7fe00000) {  /* make sure y+y not overflow */
-		    z = cos(y+y);
-		    if ((s*c)>zero) cc = z/ss;
-		    else 	    ss = z/cc;
-		}
-	/*
-	 * j1(x) = 1/__ieee754_sqrt(pi) * (P(1,x)*cc - Q(1,x)*ss) / __ieee754_sqrt(x)
-	 * y1(x) = 1/__ieee754_sqrt(pi) * (P(1,x)*ss + Q(1,x)*cc) / __ieee754_sqrt(x)
-	 */
-		if(ix>0x48000000) z = (invsqrtpi*cc)/__ieee754_sqrt(y);
-		else {
-		    u = pone(y); v = qone(y);
-		    z = invsqrtpi*(u*cc-v*ss)/__ieee754_sqrt(y);
-		}
+		__kernel_sincos_pio4(y,&s,&c);
+		z = __kernel_j1(y,s,c,0);
 		if(hx<0) return -z;
 		else  	 return  z;
 	}
@@ -168,7 +147,7 @@ static double V0[5] = {
 	double x;
 #endif
 {
-	double z, s,c,ss,cc,u,v;
+	double z, s,c,u,v;
 	__int32_t hx,ix,lx;
 
 	EXTRACT_WORDS(hx,lx,x);
@@ -177,34 +156,10 @@ static double V0[5] = {
 	if(ix>=0x7ff00000) return  one/(x+x*x); 
         if((ix|lx)==0) return -one/zero;
         if(hx<0) return zero/zero;
-        if(ix >= 0x40000000) {  /* |x| >= 2.0 */
-                s = sin(x);
-                c = cos(x);
-                ss = -s-c;
-                cc = s-c;
-                if(ix<0x7fe00000) {  /* make sure x+x not overflow */
-                    z = cos(x+x);
-                    if ((s*c)>zero) cc = z/ss;
-                    else            ss = z/cc;
-                }
-        /* y1(x) = sqrt(2/(pi*x))*(p1(x)*sin(x0)+q1(x)*cos(x0))
-         * where x0 = x-3pi/4
-         *      Better formula:
-         *              cos(x0) = cos(x)cos(3pi/4)+sin(x)sin(3pi/4)
-         *                      =  1/sqrt(2) * (sin(x) - cos(x))
-         *              sin(x0) = sin(x)cos(3pi/4)-cos(x)sin(3pi/4)
-         *                      = -1/sqrt(2) * (cos(x) + sin(x))
-         * To avoid cancellation, use
-         *              sin(x) +- cos(x) = -cos(2x)/(sin(x) -+ cos(x))
-         * to compute the worse one.
-         */
-                if(ix>0x48000000) z = (invsqrtpi*ss)/__ieee754_sqrt(x);
-                else {
-                    u = pone(x); v = qone(x);
-                    z = invsqrtpi*(u*ss+v*cc)/__ieee754_sqrt(x);
-                }
-                return z;
-        } 
+	if(ix >= 0x40000000) {	/* |x| >= 2.0 */
+		__kernel_sincos_pio4(x,&s,&c);
+		return __kernel_j1(x,s,c,1);
+	}
         if(ix<=0x3c900000) {    /* x < 2**-54 */
             return(-tpi/x);
         } 
@@ -214,6 +169,35 @@ static double V0[5] = {
         return(x*(u/v) + tpi*(__ieee754_j1(x)*__ieee754_log(x)-one/x));
 }
 
+/* __kernel_j1(x, s, c, k)
+ * j1(x) for k == 0, y1(x) otherwise, for 2 <= x < inf, where
+ * s = sin(x-pi/4) and c = cos(x-pi/4) from __kernel_sincos_pio4.
+ * Where the result is small the sum of the two terms cancels, and
+ * it is recomputed from the phase atan(q/p), see __kernel_sin_pio4.
+ */
+#ifdef __STDC__
+	double __kernel_j1(double x, double s, double c, int k)
+#else
+	double __kernel_j1(x, s, c, k)
+	double x, s, c; int k;
+#endif
+{
+	double u,v,z;
+	__int32_t ix;
+
+	GET_HIGH_WORD(ix,x);
+	if(ix>0x48000000) {
+	    u = one; v = zero;
+	} else {
+	    u = pone(x); v = qone(x);
+	}
+	if(k==0) z = u*s+v*c;
+	else	 z = v*s-u*c;
+	if(fabs(z)<0.25&&v!=zero)	/* near a zero, see __kernel_sin_pio4 */
+	    z = __ieee754_sqrt(u*u+v*v)*__kernel_sin_pio4(x,atan(v/u),k==0?0:3);
+	return sqrt2opi*z/__ieee754_sqrt(x);
+}
+
 /* For x >= 8, the asymptotic expansions of pone is
  *	1 + 15/128 s^2 - 4725/2^15 s^4 - ...,	where s = 1/x.
  * We approximate pone by
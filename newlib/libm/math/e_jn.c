@@ -23,7 +23,8 @@
  *	For n=0, j0(x) is called,
  *	for n=1, j1(x) is called,
  *	for n<x, forward recursion us used starting
- *	from values of j0(x) and j1(x).
+ *	from values of j0(x) and j1(x), which share the argument
+ *	reduction of their asymptotic forms (see __kernel_sincos_pio4).
  *	for n>x, a continued fraction approximation to
  *	j(n,x)/j(n-1,x) is evaluated and then backward
  *	recursion is used starting from a supposed value
@@ -46,7 +47,7 @@ static const double
 #else
 static double
 #endif
-invsqrtpi=  5.64189583547756279280e-01, /* 0x3FE20DD7, 0x50429B6D */
+sqrt2opi =  7.97884560802865405726e-01, /* 0x3FE98845, 0x33D43651 */
 two   =  2.00000000000000000000e+00, /* 0x40000000, 0x00000000 */
 one   =  1.00000000000000000000e+00; /* 0x3FF00000, 0x00000000 */
 
@@ -65,7 +66,7 @@ static double zero  =  0.00000000000000000000e+00;
 {
 	__int32_t i,hx,ix,lx, sgn;
 	double a, b, temp, di;
-	double z, w;
+	double z, w, s, c;
 
     /* J(-n,x) = (-1)^n * J(n, x), J(n, -x) = (-1)^n * J(n, x)
      * Thus, J(-n,x) = J(n,-x)
@@ -88,29 +89,32 @@ static double zero  =  0.00000000000000000000e+00;
 	else if((double)n<=x) {   
 		/* Safe to use J(n+1,x)=2n/x *J(n,x)-J(n-1,x) */
 	    if(ix>=0x52D00000) { /* x > 2**302 */
-    /* (x >> n**2) 
+    /* (x >> n**2)
      *	    Jn(x) = cos(x-(2n+1)*pi/4)*sqrt(2/x*pi)
      *	    Yn(x) = sin(x-(2n+1)*pi/4)*sqrt(2/x*pi)
-     *	    Let s=sin(x), c=cos(x), 
-     *		xn=x-(2n+1)*pi/4, sqt2 = sqrt(2),then
+     *	    Let s=sin(x0), c=cos(x0), x0=x-pi/4, then since
+     *	    x-(2n+1)*pi/4 = x0-n*pi/2,
      *
-     *		   n	sin(xn)*sqt2	cos(xn)*sqt2
+     *		   n	sin(xn)		cos(xn)
      *		----------------------------------
-     *		   0	 s-c		 c+s
-     *		   1	-s-c 		-c+s
-     *		   2	-s+c		-c-s
-     *		   3	 s+c		 c-s
+     *		   0	 s		 c
+     *		   1	-c		 s
+     *		   2	-s		-c
+     *		   3	 c		-s
      */
+		__kernel_sincos_pio4(x,&s,&c);
 		switch(n&3) {
-		    case 0: temp =  cos(x)+sin(x); break;
-		    case 1: temp = -cos(x)+sin(x); break;
-		    case 2: temp = -cos(x)-sin(x); break;
-		    case 3: temp =  cos(x)-sin(x); break;
+		    case 0: temp =  c; break;
+		    case 1: temp =  s; break;
+		    case 2: temp = -c; break;
+		    case 3: temp = -s; break;
 		}
-		b = invsqrtpi*temp/__ieee754_sqrt(x);
-	    } else {	
-	        a = __ieee754_j0(x);
-	        b = __ieee754_j1(x);
+		b = sqrt2opi*temp/__ieee754_sqrt(x);
+	    } else {
+		/* x >= n >= 2, share the argument reduction */
+		__kernel_sincos_pio4(x,&s,&c);
+	        a = __kernel_j0(x,s,c,0);
+	        b = __kernel_j1(x,s,c,0);
 	        for(i=1;i<n;i++){
 		    temp = b;
 		    b = b*((double)(i+i)/x) - a; /* avoid underflow */
@@ -225,7 +229,7 @@ static double zero  =  0.00000000000000000000e+00;
 {
 	__int32_t i,hx,ix,lx;
 	__int32_t sign;
-	double a, b, temp;
+	double a, b, temp, s, c;
 
 	EXTRACT_WORDS(hx,lx,x);
 	ix = 0x7fffffff&hx;
@@ -242,30 +246,25 @@ static double zero  =  0.00000000000000000000e+00;
 	if(n==1) return(sign*__ieee754_y1(x));
 	if(ix==0x7ff00000) return zero;
 	if(ix>=0x52D00000) { /* x > 2**302 */
-    /* (x >> n**2) 
-     *	    Jn(x) = cos(x-(2n+1)*pi/4)*sqrt(2/x*pi)
-     *	    Yn(x) = sin(x-(2n+1)*pi/4)*sqrt(2/x*pi)
-     *	    Let s=sin(x), c=cos(x), 
-     *		xn=x-(2n+1)*pi/4, sqt2 = sqrt(2),then
-     *
-     *		   n	sin(xn)*sqt2	cos(xn)*sqt2
-     *		----------------------------------
-     *		   0	 s-c		 c+s
-     *		   1	-s-c 		-c+s
-     *		   2	-s+c		-c-s
-     *		   3	 s+c		 c-s
-     */
+    /* (x >> n**2), see __ieee754_jn */
+		__kernel_sincos_pio4(x,&s,&c);
 		switch(n&3) {
-		    case 0: temp =  sin(x)-cos(x); break;
-		    case 1: temp = -sin(x)-cos(x); break;
-		    case 2: temp = -sin(x)+cos(x); break;
-		    case 3: temp =  sin(x)+cos(x); break;
+		    case 0: temp =  s; break;
+		    case 1: temp = -c; break;
+		    case 2: temp = -s; break;
+		    case 3: temp =  c; break;
 		}
-		b = invsqrtpi*temp/__ieee754_sqrt(x);
+		b = sqrt2opi*temp/__ieee754_sqrt(x);
 	} else {
 	    __uint32_t high;
-	    a = __ieee754_y0(x);
-	    b = __ieee754_y1(x);
+	    if(ix>=0x40000000) {	/* x >= 2, share the argument reduction */
+		__kernel_sincos_pio4(x,&s,&c);
+		a = __kernel_j0(x,s,c,1);
+		b = __kernel_j1(x,s,c,1);
+	    } else {
+		a = __ieee754_y0(x);
+		b = __ieee754_y1(x);
+	    }
 	/* quit if b is -inf */
 	    GET_HIGH_WORD(high,b);
 	    for(i=1;i<n&&high!=0xfff00000;i++){ 
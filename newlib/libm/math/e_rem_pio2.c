@@ -15,13 +15,30 @@
 /* __ieee754_rem_pio2(x,y)
  * 
  * return the remainder of x rem pi/2 in y[0]+y[1] 
- * use __kernel_rem_pio2()
+ *
+ * Arguments up to 2^20*(pi/2) are reduced with a three part pi/2
+ * (Cody and Waite), where the low parts are only used when the result
+ * cancels.  When the target has a fast fma the first product is exact
+ * with a 53 bit pi/2 and the low parts are needed less often.
+ *
+ * Larger arguments use rem_pio2_large below: the 53 bit mantissa of x
+ * times the 192 bits of 2/pi that matter for its exponent gives the
+ * quadrant and a 190 bit fraction in integer arithmetic, of which the
+ * leading 128 bits are multiplied by pi/2 (Payne and Hanek).  No double
+ * is closer than 2^-62 to a multiple of pi/2, so y[0]+y[1] is always
+ * good to 2^-75 relative.  When __OBSOLETE_MATH is set
+ * __kernel_rem_pio2() is used instead.
  */
 
 #include "fdlibm.h"
+#if !__OBSOLETE_MATH
+#include "math_config.h"
+#endif
 
 #ifndef _DOUBLE_IS_32BITS
 
+#if __OBSOLETE_MATH
+
 /*
  * Table of constants for 2/pi, 396 Hex digits (476 decimal) of 2/pi 
  */
@@ -43,18 +60,117 @@ static __int32_t two_over_pi[] = {
 0x4D7327, 0x310606, 0x1556CA, 0x73A8C9, 0x60E27B, 0xC08C6B, 
 };
 
-#ifdef __STDC__
-static const __int32_t npio2_hw[] = {
+#else /* !__OBSOLETE_MATH */
+
+/*
+ * The bits of 2/pi in 64 bit words, after a zero word for the integer
+ * part, enough for the largest double.
+ */
+static const uint64_t two_over_pi64[] = {
+0,
+0xa2f9836e4e441529, 0xfc2757d1f534ddc0, 0xdb6295993c439041,
+0xfe5163abdebbc561, 0xb7246e3a424dd2e0, 0x06492eea09d1921c,
+0xfe1deb1cb129a73e, 0xe88235f52ebb4484, 0xe99c7026b45f7e41,
+0x3991d639835339f4, 0x9c845f8bbdf9283b, 0x1ff897ffde05980f,
+0xef2f118b5a0a6d1f, 0x6d367ecf27cb09b7, 0x4f463f669e5fea2d,
+0x7527bac7ebe5f17b, 0x3d0739f78a5292ea, 0x6bfb5fb11f8d5d08,
+0x56033046fc7b6bab,
+};
+
+/* pi/4 in 128 bits: pio4_hi*2^-64 + pio4_lo*2^-128.  */
+static const uint64_t
+pio4_hi = 0xc90fdaa22168c234,
+pio4_lo = 0xc4c6628b80dc1cd1;
+
+/* Return the high 64 bits of a*b and store the low 64 bits in *lo.  */
+static inline uint64_t
+mul64 (uint64_t a, uint64_t b, uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 p = (unsigned __int128) a * b;
+	*lo = (uint64_t) p;
+	return (uint64_t) (p >> 64);
 #else
-static __int32_t npio2_hw[] = {
+	uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+	uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+	uint64_t p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+	uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+	*lo = (mid << 32) | (p00 & 0xffffffff);
+	return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
 #endif
-0x3FF921FB, 0x400921FB, 0x4012D97C, 0x401921FB, 0x401F6A7A, 0x4022D97C,
-0x4025FDBB, 0x402921FB, 0x402C463A, 0x402F6A7A, 0x4031475C, 0x4032D97C,
-0x40346B9C, 0x4035FDBB, 0x40378FDB, 0x403921FB, 0x403AB41B, 0x403C463A,
-0x403DD85A, 0x403F6A7A, 0x40407E4C, 0x4041475C, 0x4042106C, 0x4042D97C,
-0x4043A28C, 0x40446B9C, 0x404534AC, 0x4045FDBB, 0x4046C6CB, 0x40478FDB,
-0x404858EB, 0x404921FB,
-};
+}
+
+/*
+ * Reduce a finite x with |x| > 2^20*(pi/2), as __ieee754_rem_pio2.
+ * With |x| = m*2^(e-52), the bits of 2/pi of weight 2^(54-e) and above
+ * only add multiples of 4 to x*2/pi, so the 192 bits after them, w, give
+ * x*2/pi mod 4 = (m*w mod 2^192)*2^-190 with an error below 2^-137.
+ */
+static __int32_t
+rem_pio2_large (double x, double *y)
+{
+	uint64_t ix, m, w0, w1, w2, f0, f1, f2, c, hi, lo, t;
+	double z;
+	int e, q, i, sh, l, neg;
+	__int32_t n;
+
+	ix = asuint64(x);
+	e  = (int)((ix>>52)&0x7ff)-1023;
+	m  = (ix&0x000fffffffffffffULL)|0x0010000000000000ULL;
+
+    /* w starts at bit q of two_over_pi64, 30 <= q <= 1033 */
+	q  = e+10;
+	i  = q>>6;
+	sh = q&63;
+#define W(k) (two_over_pi64[i+k]<<sh | two_over_pi64[i+k+1]>>1>>(63-sh))
+	w0 = W(0); w1 = W(1); w2 = W(2);
+#undef W
+
+    /* f0:f1:f2 = m*w mod 2^192 */
+	c  = mul64(m,w2,&f2);
+	t  = mul64(m,w1,&f1);
+	f1 += c;
+	f0 = m*w0+t+(f1<c);
+
+    /* round to the nearest quadrant, leaving a signed fraction in f */
+	n  = (__int32_t)((f0+(1ULL<<61))>>62);
+	f0 = f0<<2|f1>>62;
+	f1 = f1<<2|f2>>62;
+	f2 = f2<<2;
+	neg = f0>>63;
+	if(neg) {
+	    f2 = ~f2+1;
+	    c  = f2==0;
+	    f1 = ~f1+c;
+	    c  = c&&f1==0;
+	    f0 = ~f0+c;
+	}
+
+    /* normalize the leading 128 bits of the fraction */
+	l = 0;
+	if(f0==0) {f0 = f1; f1 = f2; f2 = 0; l = 64;}
+	sh = __builtin_clzll(f0);
+	f0 = f0<<sh|f1>>1>>(63-sh);
+	f1 = f1<<sh|f2>>1>>(63-sh);
+	l += sh;
+
+    /* hi:lo = f*pi/4 with f0:f1 in [1/2,1), then y = hi:lo*2^(1-l) */
+	hi = mul64(f0,pio4_hi,&lo);
+	c  = mul64(f0,pio4_lo,&t);
+	lo += c; hi += lo<c;
+	c  = mul64(f1,pio4_hi,&t);
+	lo += c; hi += lo<c;
+	y[0] = (double)(hi>>11)*asdouble((uint64_t)(1023-52-l)<<52);
+	y[1] = (double)(hi<<53|lo>>11)*asdouble((uint64_t)(1023-116-l)<<52);
+	z = y[0]+y[1];
+	y[1] -= z-y[0];
+	y[0] = z;
+
+	if(neg^(ix>>63)) {y[0] = -y[0]; y[1] = -y[1];}
+	return (ix>>63) ? -n : n;
+}
+
+#endif /* !__OBSOLETE_MATH */
 
 /*
  * invpio2:  53 bits of 2/pi
@@ -71,16 +187,39 @@ static const double
 #else
 static double 
 #endif
+#if __OBSOLETE_MATH
 zero =  0.00000000000000000000e+00, /* 0x00000000, 0x00000000 */
 half =  5.00000000000000000000e-01, /* 0x3FE00000, 0x00000000 */
 two24 =  1.67772160000000000000e+07, /* 0x41700000, 0x00000000 */
+#else
+toint = 6.75539944105574400000e+15, /* 0x43380000, 0x00000000 */
+#endif
 invpio2 =  6.36619772367581382433e-01, /* 0x3FE45F30, 0x6DC9C883 */
 pio2_1  =  1.57079632673412561417e+00, /* 0x3FF921FB, 0x54400000 */
 pio2_1t =  6.07710050650619224932e-11, /* 0x3DD0B461, 0x1A626331 */
 pio2_2  =  6.07710050630396597660e-11, /* 0x3DD0B461, 0x1A600000 */
-pio2_2t =  2.02226624879595063154e-21, /* 0x3BA3198A, 0x2E037073 */
+pio2_2t =  2.02226624879595063154e-21; /* 0x3BA3198A, 0x2E037073 */
+
+#ifndef __FP_FAST_FMA
+#ifdef __STDC__
+static const double 
+#else
+static double 
+#endif
 pio2_3  =  2.02226624871116645580e-21, /* 0x3BA3198A, 0x2E000000 */
 pio2_3t =  8.47842766036889956997e-32; /* 0x397B839A, 0x252049C1 */
+#else
+/*
+ * With fma, fn*pio2_hi needs no spare bits to be subtracted exactly:
+ * pio2_hi:  53 bits of pi/2
+ * pio2_mid: next 53 bits of pi/2
+ * pio2_lo:  next 53 bits of pi/2
+ */
+static const double
+pio2_hi  =  1.57079632679489655800e+00, /* 0x3FF921FB, 0x54442D18 */
+pio2_mid =  6.12323399573676603587e-17, /* 0x3C91A626, 0x33145C07 */
+pio2_lo  = -1.49738490485916983294e-33; /* 0xB91F1976, 0xB7ED8FBC */
+#endif
 
 #ifdef __STDC__
 	__int32_t __ieee754_rem_pio2(double x, double *y)
@@ -90,10 +229,13 @@ pio2_3t =  8.47842766036889956997e-32; /* 0x397B839A, 0x252049C1 */
 #endif
 {
 	double z = 0.0,w,t,r,fn;
-	double tx[3];
 	__int32_t i,j,n,ix,hx;
+	__uint32_t high;
+#if __OBSOLETE_MATH
+	double tx[3];
 	int e0,nx;
 	__uint32_t low;
+#endif
 
 	GET_HIGH_WORD(hx,x);		/* high word of x */
 	ix = hx&0x7fffffff;
@@ -124,37 +266,54 @@ pio2_3t =  8.47842766036889956997e-32; /* 0x397B839A, 0x252049C1 */
 		return -1;
 	    }
 	}
-	if(ix<=0x413921fb) { /* |x| ~<= 2^19*(pi/2), medium size */
-	    t  = fabs(x);
+	if(ix<=0x413921fb) { /* |x| ~<= 2^20*(pi/2), medium size */
+	    t  = hx<0 ? -x : x;
+#if !__OBSOLETE_MATH
+	    fn = eval_as_double(t*invpio2+toint);
+	    fn -= toint;
+	    n  = (__int32_t) fn;
+#else
 	    n  = (__int32_t) (t*invpio2+half);
 	    fn = (double)n;
+#endif
+	    j  = ix>>20;
+#ifdef __FP_FAST_FMA
+	    r  = __builtin_fma(-fn,pio2_hi,t);	/* exact */
+	    w  = fn*pio2_mid;	/* 1st round good to 106 bit */
+	    y[0] = r-w;
+	    GET_HIGH_WORD(high,y[0]);
+	    i = j-((high>>20)&0x7ff);
+	    if(i>36) {  /* 2nd round needed, good to 159 bits */
+		z  = y[0]-r;	/* y[0]+t = r-w exactly */
+		t  = (r-(y[0]-z))-(w+z);
+		t -= __builtin_fma(fn,pio2_mid,-w)+fn*pio2_lo;
+		r  = y[0];
+		y[0] = r+t;
+		w  = -t;
+	    }
+#else
 	    r  = t-fn*pio2_1;
 	    w  = fn*pio2_1t;	/* 1st round good to 85 bit */
-	    if(n<32&&ix!=npio2_hw[n-1]) {	
-		y[0] = r-w;	/* quick check no cancellation */
-	    } else {
-	        __uint32_t high;
-	        j  = ix>>20;
-	        y[0] = r-w; 
+	    y[0] = r-w; 
+	    GET_HIGH_WORD(high,y[0]);
+	    i = j-((high>>20)&0x7ff);
+	    if(i>16) {  /* 2nd iteration needed, good to 118 */
+		t  = r;
+		w  = fn*pio2_2;	
+		r  = t-w;
+		w  = fn*pio2_2t-((t-r)-w);	
+		y[0] = r-w;
 		GET_HIGH_WORD(high,y[0]);
-	        i = j-((high>>20)&0x7ff);
-	        if(i>16) {  /* 2nd iteration needed, good to 118 */
-		    t  = r;
-		    w  = fn*pio2_2;	
+		i = j-((high>>20)&0x7ff);
+		if(i>49)  {	/* 3rd iteration need, 151 bits acc */
+		    t  = r;	/* will cover all possible cases */
+		    w  = fn*pio2_3;	
 		    r  = t-w;
-		    w  = fn*pio2_2t-((t-r)-w);	
+		    w  = fn*pio2_3t-((t-r)-w);	
 		    y[0] = r-w;
-		    GET_HIGH_WORD(high,y[0]);
-		    i = j-((high>>20)&0x7ff);
-		    if(i>49)  {	/* 3rd iteration need, 151 bits acc */
-		    	t  = r;	/* will cover all possible cases */
-		    	w  = fn*pio2_3;	
-		    	r  = t-w;
-		    	w  = fn*pio2_3t-((t-r)-w);	
-		    	y[0] = r-w;
-		    }
 		}
 	    }
+#endif
 	    y[1] = (r-y[0])-w;
 	    if(hx<0) 	{y[0] = -y[0]; y[1] = -y[1]; return -n;}
 	    else	 return n;
@@ -165,6 +324,9 @@ pio2_3t =  8.47842766036889956997e-32; /* 0x397B839A, 0x252049C1 */
 	if(ix>=0x7ff00000) {		/* x is inf or NaN */
 	    y[0]=y[1]=x-x; return 0;
 	}
+#if !__OBSOLETE_MATH
+	return rem_pio2_large(x,y);
+#else
     /* set z = scalbn(|x|,ilogb(x)-23) */
 	GET_LOW_WORD(low,x);
 	SET_LOW_WORD(z,low);
@@ -180,6 +342,7 @@ pio2_3t =  8.47842766036889956997e-32; /* 0x397B839A, 0x252049C1 */
 	n  =  __kernel_rem_pio2(tx,y,e0,nx,2,two_over_pi);
 	if(hx<0) {y[0] = -y[0]; y[1] = -y[1]; return -n;}
 	return n;
+#endif
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
@@ -6,20 +6,180 @@
  *
  * Developed at SunPro, a Sun Microsystems, Inc. business.
  * Permission to use, copy, modify, and distribute this
- * software is freely granted, provided that this notice 
+ * software is freely granted, provided that this notice
  * is preserved.
  * ====================================================
  *
  */
 
 /* __ieee754_gamma_r(x, signgamp)
- * Reentrant version of the logarithm of the Gamma function 
- * with user provide pointer for the sign of Gamma(x). 
+ * Reentrant version of the Gamma function with user provided pointer
+ * for the sign of Gamma(x).  Returns |Gamma(x)|.
  *
- * Method: See __ieee754_lgamma_r
+ * Method:
+ *   1. For positive integers x <= 23, Gamma(x) = (x-1)! from a table.
+ *   2. For 12 <= y < 184, Stirling's series
+ *		Gamma(y) = sqrt(2pi) * y^(y-0.5) * exp(-y+S(1/y))
+ *	where
+ *		S(w) = w/12 - w^3/360 + w^5/1260 - ... + w^13/156
+ *	are the first seven terms of the asymptotic series of lgamma,
+ *	with |error| < 2**-58 for y >= 12.  -y+S is split into hi+lo
+ *	and y^(y-0.5) is computed as t*t, t = pow(y,(y-0.5)/2), so that
+ *	neither loses precision nor overflows before the result does.
+ *   3. For 0 < x < 12, Gamma(x) = Gamma(y)/(x*(x+1)*...*(x+n-1)) with
+ *	y = x+n in (12,13].  y is rounded, y+dy = x+n exactly, and
+ *		Gamma(y+dy) ~ Gamma(y)*exp(dy*psi(y)),
+ *		psi(y) ~ log(y)-0.5/y
+ *	is added to the exponent, where a linear approximation of log(y)
+ *	on (12,13] is good enough.
+ *   4. For x < 0, since -x*Gamma(-x)*Gamma(x) = pi/sin(pi*x),
+ *		Gamma(x) = -pi/(-x*sin(-pi*x)*Gamma(-x))
+ *	computed from the parts r, t of Gamma(-x) so that it underflows
+ *	gracefully where Gamma(-x) overflows.
+ *   5. Special cases
+ *		Gamma(x) ~ 1/x for tiny x
+ *		Gamma(+-0) = +-inf
+ *		Gamma(-integer) = inf
+ *		Gamma(inf) = inf, Gamma(-inf) = nan
+ *		Gamma(x) overflows for x > 171.6 and underflows for x < -184.
+ *
+ * Unlike exp(lgamma(x)), this keeps the error within a few ulp where
+ * lgamma(x) is large.
  */
 
 #include "fdlibm.h"
+#if !__OBSOLETE_MATH
+#include "math_config.h"
+#endif
+
+#ifndef _DOUBLE_IS_32BITS
+
+#ifdef __STDC__
+static const double
+#else
+static double
+#endif
+zero    =  0.00000000000000000000e+00,
+half    =  5.00000000000000000000e-01, /* 0x3FE00000, 0x00000000 */
+one     =  1.00000000000000000000e+00, /* 0x3FF00000, 0x00000000 */
+huge    =  1.0e300,
+tiny    =  1.0e-300,
+pi      =  3.14159265358979311600e+00, /* 0x400921FB, 0x54442D18 */
+sqrt2pi =  2.50662827463100068570e+00, /* 0x40040D93, 0x1FF62706 */
+ln12p5  =  2.52572864430825543978e+00, /* log(12.5) */
+/* Coefficients of the asymptotic series of lgamma(y)-(y-0.5)*log(y)+y.  */
+S0      =  8.33333333333333287074e-02, /* 0x3FB55555, 0x55555555 */
+S1      = -2.77777777777777788379e-03, /* 0xBF66C16C, 0x16C16C17 */
+S2      =  7.93650793650793650105e-04, /* 0x3F4A01A0, 0x1A01A01A */
+S3      = -5.95238095238095291789e-04, /* 0xBF438138, 0x13813814 */
+S4      =  8.41750841750841713972e-04, /* 0x3F4B951E, 0x2B18FF23 */
+S5      = -1.91752691752691763367e-03, /* 0xBF5F6AB0, 0xD9993C7D */
+S6      =  6.41025641025641003401e-03; /* 0x3F7A41A4, 0x1A41A41A */
+
+/* Gamma(1) ... Gamma(23), all exact.  */
+#ifdef __STDC__
+static const double
+#else
+static double
+#endif
+fact[] = {
+  1.0, 1.0, 2.0, 6.0, 24.0, 120.0, 720.0, 5040.0, 40320.0, 362880.0,
+  3628800.0, 39916800.0, 479001600.0, 6227020800.0, 87178291200.0,
+  1307674368000.0, 20922789888000.0, 355687428096000.0,
+  6402373705728000.0, 121645100408832000.0, 2432902008176640000.0,
+  51090942171709440000.0, 1124000727777607680000.0,
+};
+
+#if __OBSOLETE_MATH
+#define exp_dd(hi,lo) (__ieee754_exp(hi)*(one+(lo)))
+#define pow_r(x,y) __ieee754_pow(x,y)
+#else
+#define exp_dd(hi,lo) __exp_dd(hi,lo)
+/* Neither overflows nor underflows here.  */
+#define pow_r(x,y) pow(x,y)
+#endif
+
+/* sin(pi*x) for 0 < x < 2**52 not an integer.  */
+#ifdef __STDC__
+	static double sin_pi(double x)
+#else
+	static double sin_pi(x)
+	double x;
+#endif
+{
+	double y;
+	__int32_t n;
+
+	y = x*half;
+	y = 2.0*(y-floor(y));		/* y = x mod 2.0, exact */
+	n = (__int32_t) (y*4.0);
+	switch (n) {
+	    case 0:   y =  __kernel_sin(pi*y,zero,0); break;
+	    case 1:
+	    case 2:   y =  __kernel_cos(pi*(half-y),zero); break;
+	    case 3:
+	    case 4:   y =  __kernel_sin(pi*(one-y),zero,0); break;
+	    case 5:
+	    case 6:   y = -__kernel_cos(pi*(y-1.5),zero); break;
+	    default:  y =  __kernel_sin(pi*(y-2.0),zero,0); break;
+	    }
+	return y;
+}
+
+/* Gamma(x) = r*t*t for 2**-54 <= x < 184, returns r and stores t.  */
+#ifdef __STDC__
+	static double gamma_pos(double x, double *tp)
+#else
+	static double gamma_pos(x,tp)
+	double x; double *tp;
+#endif
+{
+	double y,dy,q,w,z,s,hi,lo;
+	__int32_t i,n;
+
+	q = one;
+	dy = zero;
+	lo = zero;
+	y = x;
+	if(x<12.0) {
+	    n = (__int32_t) (12.0-x)+1;
+	    y = x+n;
+	    w = y-x;
+	    dy = (x-(y-w))+(n-w);	/* x+n = y+dy exactly */
+	    q = x;
+#if __FP_FAST_FMA
+	    /* With a fast fma the rounding errors of the sums and products
+	       are accumulated in e, q+e = x*(x+1)*...*(x+n-1), off the
+	       dependency chain of q.  */
+	    {
+		double e,a,ea,p;
+
+		e = zero;
+		for(i=1;i<n;i++) {
+		    a = x+i;
+		    w = a-x;
+		    ea = (x-(a-w))+(i-w);
+		    p = q*a;
+		    e = __builtin_fma(e,a,__builtin_fma(q,ea,
+							__builtin_fma(q,a,-p)));
+		    q = p;
+		}
+		lo -= e/q;
+	    }
+#else
+	    for(i=1;i<n;i++) q *= x+i;
+#endif
+	}
+	w = one/y;
+	z = w*w;
+	s = w*(S0+z*(S1+z*(S2+z*(S3+z*(S4+z*(S5+z*S6))))));
+	hi = s-y;
+	lo += ((-y)-hi)+s;
+	if(dy!=zero)
+	    lo += dy*(ln12p5+(y-12.5)*0.08-half*w);
+	*tp = pow_r(y,half*(y-half));
+	return sqrt2pi*exp_dd(hi,lo)/q;
+}
 
 #ifdef __STDC__
 	double __ieee754_gamma_r(double x, int *signgamp)
@@ -28,5 +188,41 @@
 	double x; int *signgamp;
 #endif
 {
-	return __ieee754_exp (__ieee754_lgamma_r(x,signgamp));
+	double ax,r,s,t;
+	__int32_t hx,ix,i;
+	__uint32_t lx;
+
+	EXTRACT_WORDS(hx,lx,x);
+	ix = hx&0x7fffffff;
+	*signgamp = 1;
+	if(ix>=0x7ff00000) {
+	    if(hx<0&&((ix-0x7ff00000)|lx)==0)
+		return (x-x)/(x-x);	/* Gamma(-inf) is nan */
+	    return x*x;
+	}
+	if(ix<0x3c900000) {		/* |x|<2**-54 */
+	    if(hx<0) *signgamp = -1;
+	    return one/fabs(x);
+	}
+	if(hx<0) {
+	    if(ix>=0x43300000) return one/zero;	/* -integer */
+	    ax = -x;
+	    if(floor(ax)==ax) return one/zero;	/* -integer */
+	    s = sin_pi(ax);
+	    if(s>zero) *signgamp = -1;
+	    if(ix>=0x40670000)			/* x <= -184 */
+		return tiny*tiny;
+	    r = gamma_pos(ax,&t);
+	    return pi/(ax*fabs(s)*r*t)/t;
+	}
+	if(ix<0x40380000) {		/* x < 24 */
+	    i = (__int32_t) x;
+	    if((double) i==x) return fact[i-1];
+	}
+	if(ix>=0x40670000)		/* x >= 184 */
+	    return huge*huge;
+	r = gamma_pos(x,&t);
+	return r*t*t;
 }
+
+#endif /* defined(_DOUBLE_IS_32BITS) */
@@ -18,7 +18,9 @@
  * Reentrant version of the logarithm of the Gamma function 
  * with user provide pointer for the sign of Gamma(x). 
  *
- * Method: See __ieee754_lgammaf_r
+ * Method: See __ieee754_lgammaf_r, or where double is wider than
+ * float, Gamma(x) is computed by __ieee754_gamma_r in double and
+ * rounded once.
  */
 
 #include "fdlibm.h"
@@ -30,5 +32,9 @@
 	float x; int *signgamp;
 #endif
 {
+#if !__OBSOLETE_MATH_FLOAT && !defined(_DOUBLE_IS_32BITS)
+	return (float) __ieee754_gamma_r((double) x,signgamp);
+#else
 	return __ieee754_expf (__ieee754_lgammaf_r(x,signgamp));
+#endif
 }
@@ -161,7 +161,7 @@ static float zero=  0.0000000000e+00;
 	ix = hx&0x7fffffff;
 	if(ix>=0x7f800000) return x*x;
 	if(ix==0) return one/zero;
-	if(ix<0x1c800000) {	/* |x|<2**-70, return -log(|x|) */
+	if(ix<0x33800000) {	/* |x|<2**-24, return -log(|x|) */
 	    if(hx<0) {
 	        *signgamp = -1;
 	        return -__ieee754_logf(-x);
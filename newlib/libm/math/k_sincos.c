@@ -0,0 +1,116 @@
+
+/*
+ * ====================================================
+ * Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+ *
+ * Developed at SunPro, a Sun Microsystems, Inc. business.
+ * Permission to use, copy, modify, and distribute this
+ * software is freely granted, provided that this notice
+ * is preserved.
+ * ====================================================
+ */
+
+/* __kernel_sincos_pio4(x, s, c)
+ * sin and cos of x-pi/4 for finite x, as needed by the asymptotic
+ * forms of the Bessel functions (see e_j0.c, e_j1.c and e_jn.c).
+ *
+ * Method:
+ *	Let x = n*pi/2 + y with |y| <= pi/4 from __ieee754_rem_pio2.
+ *	Then x-pi/4 = n*pi/2 + (y-pi/4) = (n-1)*pi/2 + (y+pi/4),
+ *	and for y >= 0 (resp. y < 0) the first (resp. second) form
+ *	has a reduced argument r in [-pi/4,pi/4] again.  r is formed
+ *	with its tail, so that unlike sin(x)-cos(x) or sin(x)+cos(x)
+ *	there is no cancellation, and one argument reduction serves
+ *	both results instead of the three of sin(x), cos(x), cos(2x).
+ *
+ * __kernel_sin_pio4(x, p, k)
+ * sin(x-pi/4+p+k*pi/2) for finite x and a small phase p.
+ *
+ * Method:
+ *	As above, with p added to the reduced argument and its tail
+ *	before the polynomial.  The Bessel kernels use this near the
+ *	zeros of their asymptotic forms p0*sin(x0)+q0*cos(x0), ...,
+ *	which equal sqrt(p0^2+q0^2)*sin(x0+atan(q0/p0)), ...; there the
+ *	sum cancels, while here the only error left is that of p.
+ *	Since the quadrant is chosen before p is added, the argument of
+ *	the polynomial may exceed pi/4 by |p| (|p| < 0.2 for the Bessel
+ *	functions); they only call this where the result, and so the
+ *	argument, is small.
+ */
+
+#include "fdlibm.h"
+
+#ifndef _DOUBLE_IS_32BITS
+
+#ifdef __STDC__
+static const double
+#else
+static double
+#endif
+pio4   =  7.85398163397448278999e-01, /* 0x3FE921FB, 0x54442D18 */
+pio4lo =  3.06161699786838301793e-17; /* 0x3C81A626, 0x33145C07 */
+
+#ifdef __STDC__
+	void __kernel_sincos_pio4(double x, double *sinp, double *cosp)
+#else
+	void __kernel_sincos_pio4(x, sinp, cosp)
+	double x; double *sinp; double *cosp;
+#endif
+{
+	double y[2],hi,lo,w,s,c;
+	__int32_t n;
+
+	n = __ieee754_rem_pio2(x,y);
+	if(y[0]>=0.0) {
+	    hi = y[0]-pio4;
+	    lo = (y[0]-(hi+pio4))+(y[1]-pio4lo);
+	} else {
+	    hi = y[0]+pio4;
+	    lo = (y[0]-(hi-pio4))+(y[1]+pio4lo);
+	    n -= 1;
+	}
+	w  = hi+lo;
+	lo = lo-(w-hi);
+	s  = __kernel_sin(w,lo,1);
+	c  = __kernel_cos(w,lo);
+	switch(n&3) {
+	    case 0:  *sinp =  s; *cosp =  c; break;
+	    case 1:  *sinp =  c; *cosp = -s; break;
+	    case 2:  *sinp = -s; *cosp = -c; break;
+	    default: *sinp = -c; *cosp =  s; break;
+	}
+}
+
+#ifdef __STDC__
+	double __kernel_sin_pio4(double x, double p, int k)
+#else
+	double __kernel_sin_pio4(x, p, k)
+	double x; double p; int k;
+#endif
+{
+	double y[2],hi,lo,w;
+	__int32_t n;
+
+	n = __ieee754_rem_pio2(x,y);
+	if(y[0]>=0.0) {
+	    hi = y[0]-pio4;
+	    lo = (y[0]-(hi+pio4))+(y[1]-pio4lo);
+	} else {
+	    hi = y[0]+pio4;
+	    lo = (y[0]-(hi-pio4))+(y[1]+pio4lo);
+	    n -= 1;
+	}
+	w = hi+p;
+	if(fabs(hi)>=fabs(p)) lo += p-(w-hi);
+	else		      lo += hi-(w-p);
+	hi = w+lo;
+	lo = lo-(hi-w);
+	switch((n+k)&3) {
+	    case 0:  return  __kernel_sin(hi,lo,1);
+	    case 1:  return  __kernel_cos(hi,lo);
+	    case 2:  return -__kernel_sin(hi,lo,1);
+	    default: return -__kernel_cos(hi,lo);
+	}
+}
+
+#endif /* defined(_DOUBLE_IS_32BITS) */
@@ -140,8 +140,10 @@ PORTABILITY
  *	   To compute exp(-x*x-0.5625+R/S), let s be a single
  *	   precision number and s := x; then
  *		-x*x = -s*s + (s-x)*(s+x)
- *	        exp(-x*x-0.5626+R/S) = 
- *			exp(-s*s-0.5625)*exp((s-x)*(s+x)+R/S);
+ *	   where s*s is exact, so that
+ *		-x*x-0.5625+R/S = hi + lo,  |lo| <= ulp(hi)/2
+ *	   with hi = -s*s+v, lo = (-s*s-hi)+v, v = (s-x)*(s+x)-0.5625+R/S,
+ *	   and one exponential of hi with the tail lo (see erfc_exp).
  *      Note2:
  *	   Here 4 and 5 make use of the asymptotic series
  *			  exp(-x*x)
@@ -166,6 +168,9 @@ PORTABILITY
 
 
 #include "fdlibm.h"
+#if !__OBSOLETE_MATH
+#include "math_config.h"
+#endif
 
 #ifndef _DOUBLE_IS_32BITS
 
@@ -248,6 +253,27 @@ sb5  =  2.55305040643316442583e+03, /* 0x40A3F219, 0xCEDF3BE6 */
 sb6  =  4.74528541206955367215e+02, /* 0x407DA874, 0xE79FE763 */
 sb7  = -2.24409524465858183362e+01; /* 0xC03670E2, 0x42712D62 */
 
+/* exp(-x*x-0.5625+R/S) for 1.25 <= x < 28, see Note1.  */
+#ifdef __STDC__
+static double erfc_exp(double x, double rs)
+#else
+static double erfc_exp(x, rs)
+double x, rs;
+#endif
+{
+	double z,v,hi,lo;
+	z  = x;
+	SET_LOW_WORD(z,0);
+	v  = (z-x)*(z+x)+(rs-0.5625);
+	hi = v-z*z;
+	lo = (-z*z-hi)+v;
+#if __OBSOLETE_MATH
+	return __ieee754_exp(hi)*(one+lo);
+#else
+	return __exp_dd(hi,lo);
+#endif
+}
+
 #ifdef __STDC__
 	double erf(double x) 
 #else
@@ -298,9 +324,7 @@ sb7  = -2.24409524465858183362e+01; /* 0xC03670E2, 0x42712D62 */
 	    S=one+s*(sb1+s*(sb2+s*(sb3+s*(sb4+s*(
 				sb5+s*(sb6+s*sb7))))));
 	}
-	z  = x;  
-	SET_LOW_WORD(z,0);
-	r  =  __ieee754_exp(-z*z-0.5625)*__ieee754_exp((z-x)*(z+x)+R/S);
+	r  =  erfc_exp(x,R/S);
 	if(hx>=0) return one-r/x; else return  r/x-one;
 }
 
@@ -360,10 +384,7 @@ sb7  = -2.24409524465858183362e+01; /* 0xC03670E2, 0x42712D62 */
 	        S=one+s*(sb1+s*(sb2+s*(sb3+s*(sb4+s*(
 				sb5+s*(sb6+s*sb7))))));
 	    }
-	    z  = x;
-	    SET_LOW_WORD(z,0);
-	    r  =  __ieee754_exp(-z*z-0.5625)*
-			__ieee754_exp((z-x)*(z+x)+R/S);
+	    r  =  erfc_exp(x,R/S);
 	    if(hx>0) return r/x; else return two-r/x;
 	} else {
 	    if(hx>0) return tiny*tiny; else return two-tiny;
@@ -0,0 +1,255 @@
+
+/*
+ * ====================================================
+ * Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+ *
+ * Developed at SunPro, a Sun Microsystems, Inc. business.
+ * Permission to use, copy, modify, and distribute this
+ * software is freely granted, provided that this notice
+ * is preserved.
+ * ====================================================
+ */
+
+/*
+ * jn_orders(n, x, r), yn_orders(n, x, r)
+ *	r[k] = jn(k,x) (resp. yn(k,x)) for k = 0, 1, ..., n.
+ * jn_array(n, x, r, count), yn_array(n, x, r, count)
+ *	r[i] = jn(n,x[i]) (resp. yn(n,x[i])) for i = 0, ..., count-1.
+ *
+ * Method:
+ *	Calling jn(k,x) for each k repeats the recurrence from order 0
+ *	or from far above k, which is O(n^2) work for all the orders.
+ *	jn_orders runs each recurrence once and stores every order it
+ *	passes:
+ *	1. j0(x) and j1(x) share one argument reduction for x >= 2
+ *	   (see __kernel_sincos_pio4).
+ *	2. Forward recursion J(k+1,x) = 2k/x*J(k,x)-J(k-1,x) is stable
+ *	   for k <= x and gives the orders up to min(n,x).
+ *	3. The orders above x come from one backward recursion started
+ *	   at order n by the continued fraction of __ieee754_jn, which
+ *	   is scaled to the forward value at the larger of the two
+ *	   orders where the recursions meet.
+ *	4. For tiny x, J(k,x) = (x/2)^k/k! is a running product, and
+ *	   for huge x the asymptotic form repeats with period 4 in k.
+ *	yn_orders needs only the forward recursion, which is stable for
+ *	all orders of Y.
+ *	jn_array and yn_array are loops over the ieee754 functions
+ *	without the wrapper checks.
+ *
+ *	None of these report errors through errno or matherr; the
+ *	results are those of jn and yn in _IEEE_ mode.
+ */
+
+#include "fdlibm.h"
+
+#ifndef _DOUBLE_IS_32BITS
+
+#ifdef __STDC__
+static const double
+#else
+static double
+#endif
+sqrt2opi =  7.97884560802865405726e-01, /* 0x3FE98845, 0x33D43651 */
+two   =  2.00000000000000000000e+00, /* 0x40000000, 0x00000000 */
+one   =  1.00000000000000000000e+00, /* 0x3FF00000, 0x00000000 */
+zero  =  0.00000000000000000000e+00;
+
+#ifdef __STDC__
+	void jn_orders(int n, double x, double *r)
+#else
+	void jn_orders(n,x,r)
+	int n; double x; double *r;
+#endif
+{
+	__int32_t i,hx,ix,lx,k,kf,m,top;
+	double a, b, t, temp, di, s, c, w, h, z, q0, q1;
+
+	if(n<0) return;
+	EXTRACT_WORDS(hx,lx,x);
+	ix = 0x7fffffff&hx;
+    /* J(k,NaN) is NaN */
+	if((ix|((__uint32_t)(lx|-lx))>>31)>0x7ff00000) {
+	    for(i=0;i<=n;i++) r[i] = x+x;
+	    return;
+	}
+	x = fabs(x);
+	if((ix|lx)==0||ix>=0x7ff00000) {	/* x is 0 or inf */
+	    r[0] = ((ix|lx)==0) ? one : zero;
+	    for(i=1;i<=n;i++) r[i] = zero;
+	} else if(ix>=0x52D00000) {	/* x > 2**302, see __ieee754_jn */
+	    __kernel_sincos_pio4(x,&s,&c);
+	    w = sqrt2opi/__ieee754_sqrt(x);
+	    for(i=0;i<=n;i++) {
+		switch(i&3) {
+		    case 0: r[i] =  w*c; break;
+		    case 1: r[i] =  w*s; break;
+		    case 2: r[i] = -w*c; break;
+		    case 3: r[i] = -w*s; break;
+		}
+	    }
+	} else if(ix<0x3e100000) {	/* x < 2**-29 */
+	    r[0] = __ieee754_j0(x);
+	    t = x*0.5;
+	    for(b=one,i=1;i<=n;i++) {
+		b = (b*t)/(double)i;	/* (x/2)^i/i! */
+		r[i] = b;
+	    }
+	} else {
+	    if(ix>=0x40000000) {
+		__kernel_sincos_pio4(x,&s,&c);
+		a = __kernel_j0(x,s,c,0);
+		b = __kernel_j1(x,s,c,0);
+	    } else {
+		a = __ieee754_j0(x);
+		b = __ieee754_j1(x);
+	    }
+	    r[0] = a;
+	    if(n>=1) r[1] = b;
+	    kf = ((double)n<=x) ? n : (__int32_t)x;
+	    if(kf<1) kf = 1;
+	    for(i=1;i<kf;i++) {
+		temp = b;
+		b = b*((double)(i+i)/x) - a;
+		a = temp;
+		r[i+1] = b;
+	    }
+	    if(n>kf) {
+	    /* J(n,x)/J(n-1,x) by the continued fraction, see __ieee754_jn */
+		w  = (n+n)/x; h = two/x;
+		q0 = w;  z = w+h; q1 = w*z - one; k=1;
+		while(q1<1.0e9) {
+		    k += 1; z += h;
+		    temp = z*q1 - q0;
+		    q0 = q1;
+		    q1 = temp;
+		}
+		m = n+n;
+		for(t=zero, i = 2*(n+k); i>=m; i -= 2) t = one/(i/x-t);
+	    /* unnormalized J(i,x) for i = n, n-1, ..., kf+1 in r[i], then
+	     * a = J(kf+1,x), b = J(kf,x) on the same scale */
+		a = t;
+		b = one;
+		r[n] = a;
+		top = n;
+		for(i=n-1,di=(double)(i+i);i>kf;i--) {
+		    r[i] = b;
+		    temp = b;
+		    b *= di;
+		    b  = b/x - a;
+		    a = temp;
+		    di -= two;
+		/* scale to avoid spurious overflow, the orders far above
+		 * underflow to zero and need no more scaling */
+		    if(b>1e100) {
+			a /= b;
+			for(m=i;m<=top;m++) r[m] /= b;
+			while(top>i&&r[top]==zero) top--;
+			b = one;
+		    }
+		}
+	    /* normalize with whichever of J(kf,x), J(kf-1,x) is larger */
+		if(fabs(r[kf])>=fabs(r[kf-1]))
+		    t = r[kf]/b;
+		else
+		    t = r[kf-1]/(b*(di/x) - a);
+		for(i=kf+1;i<=top;i++) r[i] *= t;
+		for(;i<=n;i++) r[i] = zero;
+	    }
+	}
+	if(hx<0)
+	    for(i=1;i<=n;i+=2) r[i] = -r[i];
+}
+
+#ifdef __STDC__
+	void yn_orders(int n, double x, double *r)
+#else
+	void yn_orders(n,x,r)
+	int n; double x; double *r;
+#endif
+{
+	__int32_t i,hx,ix,lx;
+	double a, b, temp, s, c, w;
+	__uint32_t high;
+
+	if(n<0) return;
+	EXTRACT_WORDS(hx,lx,x);
+	ix = 0x7fffffff&hx;
+    /* Y(k,NaN) is NaN, Y(k,0) = -inf, Y(k,-x) is NaN, Y(k,inf) = 0 */
+	if((ix|((__uint32_t)(lx|-lx))>>31)>0x7ff00000) b = x+x;
+	else if((ix|lx)==0) b = -one/zero;
+	else if(hx<0) b = zero/zero;
+	else if(ix==0x7ff00000) b = zero;
+	else if(ix>=0x52D00000) {	/* x > 2**302, see __ieee754_jn */
+	    __kernel_sincos_pio4(x,&s,&c);
+	    w = sqrt2opi/__ieee754_sqrt(x);
+	    for(i=0;i<=n;i++) {
+		switch(i&3) {
+		    case 0: r[i] =  w*s; break;
+		    case 1: r[i] = -w*c; break;
+		    case 2: r[i] = -w*s; break;
+		    case 3: r[i] =  w*c; break;
+		}
+	    }
+	    return;
+	} else {
+	    if(ix>=0x40000000) {
+		__kernel_sincos_pio4(x,&s,&c);
+		a = __kernel_j0(x,s,c,1);
+		b = __kernel_j1(x,s,c,1);
+	    } else {
+		a = __ieee754_y0(x);
+		b = __ieee754_y1(x);
+	    }
+	    r[0] = a;
+	    if(n==0) return;
+	    r[1] = b;
+	/* once b is -inf, so are all higher orders */
+	    GET_HIGH_WORD(high,b);
+	    for(i=1;i<n&&high!=0xfff00000;i++) {
+		temp = b;
+		b = ((double)(i+i)/x)*b - a;
+		GET_HIGH_WORD(high,b);
+		a = temp;
+		r[i+1] = b;
+	    }
+	    for(i++;i<=n;i++) r[i] = b;
+	    return;
+	}
+	for(i=0;i<=n;i++) r[i] = b;
+}
+
+#ifdef __STDC__
+	void jn_array(int n, const double *x, double *r, int count)
+#else
+	void jn_array(n,x,r,count)
+	int n; const double *x; double *r; int count;
+#endif
+{
+	int i;
+
+	if(n==0)
+	    for(i=0;i<count;i++) r[i] = __ieee754_j0(x[i]);
+	else if(n==1)
+	    for(i=0;i<count;i++) r[i] = __ieee754_j1(x[i]);
+	else
+	    for(i=0;i<count;i++) r[i] = __ieee754_jn(n,x[i]);
+}
+
+#ifdef __STDC__
+	void yn_array(int n, const double *x, double *r, int count)
+#else
+	void yn_array(n,x,r,count)
+	int n; const double *x; double *r; int count;
+#endif
+{
+	int i;
+
+	if(n==0)
+	    for(i=0;i<count;i++) r[i] = __ieee754_y0(x[i]);
+	else if(n==1)
+	    for(i=0;i<count;i++) r[i] = __ieee754_y1(x[i]);
+	else
+	    for(i=0;i<count;i++) r[i] = __ieee754_yn(n,x[i]);
+}
+
+#endif /* defined(_DOUBLE_IS_32BITS) */
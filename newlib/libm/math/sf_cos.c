@@ -15,6 +15,8 @@
 
 #include "fdlibm.h"
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 static const float one=1.0;
 #else
@@ -66,3 +68,5 @@ static float one=1.0;
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
@@ -0,0 +1,229 @@
+/* sf_jnbatch.c -- float version of s_jnbatch.c.
+ */
+
+/*
+ * ====================================================
+ * Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+ *
+ * Developed at SunPro, a Sun Microsystems, Inc. business.
+ * Permission to use, copy, modify, and distribute this
+ * software is freely granted, provided that this notice
+ * is preserved.
+ * ====================================================
+ */
+
+#include "fdlibm.h"
+
+#ifdef __STDC__
+static const float
+#else
+static float
+#endif
+two   =  2.0000000000e+00, /* 0x40000000 */
+one   =  1.0000000000e+00, /* 0x3F800000 */
+zero  =  0.0000000000e+00;
+
+#ifdef __STDC__
+	void jnf_orders(int n, float x, float *r)
+#else
+	void jnf_orders(n,x,r)
+	int n; float x; float *r;
+#endif
+{
+	__int32_t i,hx,ix,k,kf,m,top;
+	float a, b, t, temp, di, w, h, z, q0, q1;
+
+	if(n<0) return;
+	GET_FLOAT_WORD(hx,x);
+	ix = 0x7fffffff&hx;
+    /* J(k,NaN) is NaN */
+	if(FLT_UWORD_IS_NAN(ix)) {
+	    for(i=0;i<=n;i++) r[i] = x+x;
+	    return;
+	}
+	x = fabsf(x);
+	if(FLT_UWORD_IS_ZERO(ix)||FLT_UWORD_IS_INFINITE(ix)) {
+	    r[0] = FLT_UWORD_IS_ZERO(ix) ? one : zero;
+	    for(i=1;i<=n;i++) r[i] = zero;
+	} else if(ix<0x30800000) {	/* x < 2**-29 */
+	    r[0] = __ieee754_j0f(x);
+	    t = x*(float)0.5;
+	    for(b=one,i=1;i<=n;i++) {
+		b = (b*t)/(float)i;	/* (x/2)^i/i! */
+		r[i] = b;
+	    }
+	} else {
+	    a = __ieee754_j0f(x);
+	    b = __ieee754_j1f(x);
+	    r[0] = a;
+	    if(n>=1) r[1] = b;
+	    kf = ((float)n<=x) ? n : (__int32_t)x;
+	    if(kf<1) kf = 1;
+	    for(i=1;i<kf;i++) {
+		temp = b;
+		b = b*((float)(i+i)/x) - a;
+		a = temp;
+		r[i+1] = b;
+	    }
+	    if(n>kf) {
+	    /* J(n,x)/J(n-1,x) by the continued fraction, see __ieee754_jnf */
+		w  = (n+n)/x; h = two/x;
+		q0 = w;  z = w+h; q1 = w*z - one; k=1;
+		while(q1<(float)1.0e9) {
+		    k += 1; z += h;
+		    temp = z*q1 - q0;
+		    q0 = q1;
+		    q1 = temp;
+		}
+		m = n+n;
+		for(t=zero, i = 2*(n+k); i>=m; i -= 2) t = one/(i/x-t);
+	    /* unnormalized J(i,x) for i = n, n-1, ..., kf+1 in r[i], then
+	     * a = J(kf+1,x), b = J(kf,x) on the same scale */
+		a = t;
+		b = one;
+		r[n] = a;
+		top = n;
+		for(i=n-1,di=(float)(i+i);i>kf;i--) {
+		    r[i] = b;
+		    temp = b;
+		    b *= di;
+		    b  = b/x - a;
+		    a = temp;
+		    di -= two;
+		/* scale to avoid spurious overflow */
+		    if(b>(float)1e10) {
+			a /= b;
+			for(m=i;m<=top;m++) r[m] /= b;
+			while(top>i&&r[top]==zero) top--;
+			b = one;
+		    }
+		}
+	    /* normalize with whichever of J(kf,x), J(kf-1,x) is larger */
+		if(fabsf(r[kf])>=fabsf(r[kf-1]))
+		    t = r[kf]/b;
+		else
+		    t = r[kf-1]/(b*(di/x) - a);
+		for(i=kf+1;i<=top;i++) r[i] *= t;
+		for(;i<=n;i++) r[i] = zero;
+	    }
+	}
+	if(hx<0)
+	    for(i=1;i<=n;i+=2) r[i] = -r[i];
+}
+
+#ifdef __STDC__
+	void ynf_orders(int n, float x, float *r)
+#else
+	void ynf_orders(n,x,r)
+	int n; float x; float *r;
+#endif
+{
+	__int32_t i,hx,ix,ib;
+	float a, b, temp;
+
+	if(n<0) return;
+	GET_FLOAT_WORD(hx,x);
+	ix = 0x7fffffff&hx;
+    /* Y(k,NaN) is NaN, Y(k,0) = -inf, Y(k,-x) is NaN, Y(k,inf) = 0 */
+	if(FLT_UWORD_IS_NAN(ix)) b = x+x;
+	else if(FLT_UWORD_IS_ZERO(ix)) b = -one/zero;
+	else if(hx<0) b = zero/zero;
+	else if(FLT_UWORD_IS_INFINITE(ix)) b = zero;
+	else {
+	    a = __ieee754_y0f(x);
+	    b = __ieee754_y1f(x);
+	    r[0] = a;
+	    if(n==0) return;
+	    r[1] = b;
+	/* once b is -inf, so are all higher orders */
+	    GET_FLOAT_WORD(ib,b);
+	    for(i=1;i<n&&ib!=0xff800000;i++) {
+		temp = b;
+		b = ((float)(i+i)/x)*b - a;
+		GET_FLOAT_WORD(ib,b);
+		a = temp;
+		r[i+1] = b;
+	    }
+	    for(i++;i<=n;i++) r[i] = b;
+	    return;
+	}
+	for(i=0;i<=n;i++) r[i] = b;
+}
+
+#ifdef __STDC__
+	void jnf_array(int n, const float *x, float *r, int count)
+#else
+	void jnf_array(n,x,r,count)
+	int n; const float *x; float *r; int count;
+#endif
+{
+	int i;
+
+	if(n==0)
+	    for(i=0;i<count;i++) r[i] = __ieee754_j0f(x[i]);
+	else if(n==1)
+	    for(i=0;i<count;i++) r[i] = __ieee754_j1f(x[i]);
+	else
+	    for(i=0;i<count;i++) r[i] = __ieee754_jnf(n,x[i]);
+}
+
+#ifdef __STDC__
+	void ynf_array(int n, const float *x, float *r, int count)
+#else
+	void ynf_array(n,x,r,count)
+	int n; const float *x; float *r; int count;
+#endif
+{
+	int i;
+
+	if(n==0)
+	    for(i=0;i<count;i++) r[i] = __ieee754_y0f(x[i]);
+	else if(n==1)
+	    for(i=0;i<count;i++) r[i] = __ieee754_y1f(x[i]);
+	else
+	    for(i=0;i<count;i++) r[i] = __ieee754_ynf(n,x[i]);
+}
+
+#ifdef _DOUBLE_IS_32BITS
+
+#ifdef __STDC__
+	void jn_orders(int n, double x, double *r)
+#else
+	void jn_orders(n,x,r)
+	int n; double x; double *r;
+#endif
+{
+	jnf_orders(n, (float) x, (float *) r);
+}
+
+#ifdef __STDC__
+	void yn_orders(int n, double x, double *r)
+#else
+	void yn_orders(n,x,r)
+	int n; double x; double *r;
+#endif
+{
+	ynf_orders(n, (float) x, (float *) r);
+}
+
+#ifdef __STDC__
+	void jn_array(int n, const double *x, double *r, int count)
+#else
+	void jn_array(n,x,r,count)
+	int n; const double *x; double *r; int count;
+#endif
+{
+	jnf_array(n, (const float *) x, (float *) r, count);
+}
+
+#ifdef __STDC__
+	void yn_array(int n, const double *x, double *r, int count)
+#else
+	void yn_array(n,x,r,count)
+	int n; const double *x; double *r; int count;
+#endif
+{
+	ynf_array(n, (const float *) x, (float *) r, count);
+}
+
+#endif /* defined(_DOUBLE_IS_32BITS) */
@@ -15,6 +15,8 @@
 
 #include "fdlibm.h"
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	float sinf(float x)
 #else
@@ -60,3 +62,5 @@
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
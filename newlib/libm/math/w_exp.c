@@ -63,7 +63,7 @@ PORTABILITY
 #include "fdlibm.h"
 #include <errno.h>
 
-#ifndef _DOUBLE_IS_32BITS
+#if !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH
 
 #ifdef __STDC__
 static const double
@@ -133,4 +133,4 @@ u_threshold= -7.45133219101941108420e+02;  /* 0xc0874910, 0xD52D3051 */
 #endif
 }
 
-#endif /* defined(_DOUBLE_IS_32BITS) */
+#endif /* !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH */
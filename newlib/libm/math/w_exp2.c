@@ -55,7 +55,7 @@ PORTABILITY
 #include <errno.h>
 #include <math.h>
 
-#ifndef _DOUBLE_IS_32BITS
+#if !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH
 
 #ifdef __STDC__
 	double exp2(double x)		/* wrapper exp2 */
@@ -67,4 +67,4 @@ PORTABILITY
   return pow(2.0, x);
 }
 
-#endif /* defined(_DOUBLE_IS_32BITS) */
+#endif /* !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH */
@@ -39,6 +39,22 @@ INDEX
 yn
 INDEX
 ynf
+INDEX
+jn_orders
+INDEX
+jnf_orders
+INDEX
+yn_orders
+INDEX
+ynf_orders
+INDEX
+jn_array
+INDEX
+jnf_array
+INDEX
+yn_array
+INDEX
+ynf_array
 
 ANSI_SYNOPSIS
 #include <math.h>
@@ -54,6 +70,14 @@ double y1(double <[x]>);
 float y1f(float <[x]>);
 double yn(int <[n]>, double <[x]>);
 float ynf(int <[n]>, float <[x]>);
+void jn_orders(int <[n]>, double <[x]>, double *<[r]>);
+void jnf_orders(int <[n]>, float <[x]>, float *<[r]>);
+void yn_orders(int <[n]>, double <[x]>, double *<[r]>);
+void ynf_orders(int <[n]>, float <[x]>, float *<[r]>);
+void jn_array(int <[n]>, const double *<[x]>, double *<[r]>, int <[count]>);
+void jnf_array(int <[n]>, const float *<[x]>, float *<[r]>, int <[count]>);
+void yn_array(int <[n]>, const double *<[x]>, double *<[r]>, int <[count]>);
+void ynf_array(int <[n]>, const float *<[x]>, float *<[r]>, int <[count]>);
 
 TRAD_SYNOPSIS
 #include <math.h>
@@ -88,6 +112,43 @@ float ynf(<[n]>, <[x]>)
 int <[n]>;
 float <[x]>;
 
+void jn_orders(<[n]>, <[x]>, <[r]>)
+int <[n]>;
+double <[x]>;
+double *<[r]>;
+void jnf_orders(<[n]>, <[x]>, <[r]>)
+int <[n]>;
+float <[x]>;
+float *<[r]>;
+void yn_orders(<[n]>, <[x]>, <[r]>)
+int <[n]>;
+double <[x]>;
+double *<[r]>;
+void ynf_orders(<[n]>, <[x]>, <[r]>)
+int <[n]>;
+float <[x]>;
+float *<[r]>;
+void jn_array(<[n]>, <[x]>, <[r]>, <[count]>)
+int <[n]>;
+const double *<[x]>;
+double *<[r]>;
+int <[count]>;
+void jnf_array(<[n]>, <[x]>, <[r]>, <[count]>)
+int <[n]>;
+const float *<[x]>;
+float *<[r]>;
+int <[count]>;
+void yn_array(<[n]>, <[x]>, <[r]>, <[count]>)
+int <[n]>;
+const double *<[x]>;
+double *<[r]>;
+int <[count]>;
+void ynf_array(<[n]>, <[x]>, <[r]>, <[count]>)
+int <[n]>;
+const float *<[x]>;
+float *<[r]>;
+int <[count]>;
+
 DESCRIPTION
 The Bessel functions are a family of functions that solve the
 differential equation 
@@ -111,11 +172,23 @@ order <[n]>, and <<y0>> and <<y1>> are special cases for order 0 and
 <<jnf>>, <<j0f>>, <<j1f>>, <<ynf>>, <<y0f>>, and <<y1f>> perform the
 same calculations, but on <<float>> rather than <<double>> values.
 
+<<jn_orders>> stores <<jn(<[k]>, <[x]>)>> in <[r]>[<[k]>] for every
+order <[k]> from 0 to <[n]>, and <<yn_orders>> does the same for
+<<yn>>.  Each runs its recurrence once, which is much faster than
+calling <<jn>> or <<yn>> for each order.  <<jn_array>> and
+<<yn_array>> store <<jn(<[n]>, <[x]>[<[i]>])>> (resp. <<yn>>) in
+<[r]>[<[i]>] for <[i]> from 0 to <[count]>-1.  These functions do not
+set <<errno>> or call <<matherr>>; their results are those of
+<<jn>> and <<yn>> in IEEE mode.  <<jnf_orders>>, <<ynf_orders>>,
+<<jnf_array>> and <<ynf_array>> are the <<float>> versions.
+
 RETURNS
-The value of each Bessel function at <[x]> is returned.
+The value of each Bessel function at <[x]> is returned.  The
+<<_orders>> and <<_array>> functions return their results in <[r]>.
 
 PORTABILITY
-None of the Bessel functions are in ANSI C.
+None of the Bessel functions are in ANSI C.  The <<_orders>> and
+<<_array>> functions are newlib extensions.
 */
 
 /*
@@ -59,7 +59,7 @@ PORTABILITY
 #include "fdlibm.h"
 #include <errno.h>
 
-#ifndef _DOUBLE_IS_32BITS
+#if !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH
 
 #ifdef __STDC__
 	double log(double x)		/* wrapper log */
@@ -113,4 +113,4 @@ PORTABILITY
 #endif
 }
 
-#endif /* defined(_DOUBLE_IS_32BITS) */
+#endif /* !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH */
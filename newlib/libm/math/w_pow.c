@@ -62,7 +62,7 @@ PORTABILITY
 #include "fdlibm.h"
 #include <errno.h>
 
-#ifndef _DOUBLE_IS_32BITS
+#if !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH
 
 #ifdef __STDC__
 	double pow(double x, double y)	/* wrapper pow */
@@ -214,7 +214,7 @@ PORTABILITY
 #endif
 }
 
-#endif /* defined(_DOUBLE_IS_32BITS) */
+#endif /* !defined (_DOUBLE_IS_32BITS) && __OBSOLETE_MATH */
 
 
 
@@ -1,8 +1,6 @@
-/* sincos -- currently no more efficient than two separate calls to
-   sin and cos. */
+/* sincos -- sin and cos of x with a single argument reduction. */
 
 #include "fdlibm.h"
-#include <errno.h>
 
 #ifndef _DOUBLE_IS_32BITS
 
@@ -15,8 +13,44 @@
         double *cosx;
 #endif
 {
-  *sinx = sin (x);
-  *cosx = cos (x);
+	double y[2],z=0.0;
+	__int32_t n,ix;
+
+    /* High word of x. */
+	GET_HIGH_WORD(ix,x);
+
+    /* |x| ~< pi/4 */
+	ix &= 0x7fffffff;
+	if(ix <= 0x3fe921fb) {
+	    *sinx = __kernel_sin(x,z,0);
+	    *cosx = __kernel_cos(x,z);
+	}
+
+    /* sin and cos of Inf or NaN are NaN */
+	else if (ix>=0x7ff00000) *sinx = *cosx = x-x;
+
+    /* argument reduction needed, see s_sin.c for the quadrants */
+	else {
+	    n = __ieee754_rem_pio2(x,y);
+	    switch(n&3) {
+		case 0:
+		    *sinx =  __kernel_sin(y[0],y[1],1);
+		    *cosx =  __kernel_cos(y[0],y[1]);
+		    break;
+		case 1:
+		    *sinx =  __kernel_cos(y[0],y[1]);
+		    *cosx = -__kernel_sin(y[0],y[1],1);
+		    break;
+		case 2:
+		    *sinx = -__kernel_sin(y[0],y[1],1);
+		    *cosx = -__kernel_cos(y[0],y[1]);
+		    break;
+		default:
+		    *sinx = -__kernel_cos(y[0],y[1]);
+		    *cosx =  __kernel_sin(y[0],y[1],1);
+		    break;
+	    }
+	}
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
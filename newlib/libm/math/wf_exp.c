@@ -20,6 +20,8 @@
 #include "fdlibm.h"
 #include <errno.h>
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 static const float
 #else
@@ -101,3 +103,5 @@ u_threshold= -1.0397208405e+02;  /* 0xc2cff1b5 */
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
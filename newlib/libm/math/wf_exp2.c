@@ -21,6 +21,8 @@
 #include <errno.h>
 #include <math.h>
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	float exp2f(float x)		/* wrapper exp2f */
 #else
@@ -44,3 +46,5 @@
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
@@ -20,6 +20,8 @@
 #include "fdlibm.h"
 #include <errno.h>
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	float logf(float x)		/* wrapper logf */
 #else
@@ -84,3 +86,5 @@
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
@@ -20,6 +20,8 @@
 #include "fdlibm.h"
 #include <errno.h>
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	float powf(float x, float y)	/* wrapper powf */
 #else
@@ -177,3 +179,5 @@
 }
 
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
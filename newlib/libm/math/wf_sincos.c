@@ -3,6 +3,8 @@
 #include "fdlibm.h"
 #include <errno.h>
 
+#if __OBSOLETE_MATH_FLOAT
+
 #ifdef __STDC__
 	void sincosf(float x, float *sinx, float *cosx)
 #else
@@ -31,3 +33,5 @@
   *cosx = cosf((float) x);
 }
 #endif /* defined(_DOUBLE_IS_32BITS) */
+
+#endif /* __OBSOLETE_MATH_FLOAT */
@@ -202,3 +202,11 @@
 {61,0,123,__LINE__, 0x3f9fc826, 0xafa66438, 0x40100000, 0x00000000, 0x3fff3333, 0x33333338},
 0,};
 test_jn(m)   {run_vector_1(m,jn_vec,(char *)(jn),"jn","did");   }	
+
+/* The batch entry points must agree with jn on the same vector.  */
+static double jn_by_orders(n, x) int n; double x;
+{ double r[33]; if (n < 0 || n > 32) return jn(n, x); jn_orders(n, x, r); return r[n]; }
+static double jn_by_array(n, x) int n; double x;
+{ double r[1]; jn_array(n, &x, r, 1); return r[0]; }
+test_jn_orders(m)   {run_vector_1(m,jn_vec,(char *)(jn_by_orders),"jn_orders","did");   }
+test_jn_array(m)   {run_vector_1(m,jn_vec,(char *)(jn_by_array),"jn_array","did");   }
@@ -202,3 +202,11 @@
 {32,0,123,__LINE__, 0x3f9fc826, 0xafa66438, 0x40100000, 0x00000000, 0x3fff3333, 0x33333338},
 0,};
 test_jnf(m)   {run_vector_1(m,jnf_vec,(char *)(jnf),"jnf","fif");   }	
+
+/* The batch entry points must agree with jnf on the same vector.  */
+static float jnf_by_orders(n, x) int n; float x;
+{ float r[33]; if (n < 0 || n > 32) return jnf(n, x); jnf_orders(n, x, r); return r[n]; }
+static float jnf_by_array(n, x) int n; float x;
+{ float r[1]; jnf_array(n, &x, r, 1); return r[0]; }
+test_jnf_orders(m)   {run_vector_1(m,jnf_vec,(char *)(jnf_by_orders),"jnf_orders","fif");   }
+test_jnf_array(m)   {run_vector_1(m,jnf_vec,(char *)(jnf_by_array),"jnf_array","fif");   }
@@ -398,6 +398,10 @@ _DEFUN_VOID(test_math)
   test_j1f(0);
   test_jn(0);
   test_jnf(0);
+  test_jn_orders(0);
+  test_jnf_orders(0);
+  test_jn_array(0);
+  test_jnf_array(0);
   test_log(0);
   test_log10(0);
   test_log10f(0);
@@ -422,6 +426,7 @@ _DEFUN_VOID(test_math)
   test_y1f(0);
   test_y1f(0);
   test_ynf(0);
+  test_simd();
 }
 
 /* These have to be played with to get to compile on machines which
@@ -0,0 +1,496 @@
+/* Check the vector versions of exp, log, pow, sin, cos, sincos, expf,
+   logf, sinf and cosf (the _ZGV functions GCC calls for the loops it
+   vectorizes) against the scalar functions.  The arguments are those of
+   the vectors of the scalar functions, and nans, infinities, zeros and
+   the arguments around the overflow and underflow thresholds, and each
+   of them is passed in every lane.  Every lane must be within 1 ulp of
+   the scalar result, and be a nan or an infinity where that is.  The
+   variants the processor cannot run are skipped.  */
+
+#include "test.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern int inacc;
+
+#ifdef __x86_64__
+
+#include <cpuid.h>
+
+extern one_line_type exp_vec[], log_vec[], sin_vec[], cos_vec[];
+extern one_line_type expf_vec[], logf_vec[], sinf_vec[], cosf_vec[];
+
+typedef double vd2 __attribute__ ((vector_size (16)));
+typedef double vd4 __attribute__ ((vector_size (32)));
+typedef double vd8 __attribute__ ((vector_size (64)));
+typedef float vf4 __attribute__ ((vector_size (16)));
+typedef float vf8 __attribute__ ((vector_size (32)));
+typedef float vf16 __attribute__ ((vector_size (64)));
+typedef long long vl2 __attribute__ ((vector_size (16)));
+typedef long long vl4 __attribute__ ((vector_size (32)));
+typedef long long vl8 __attribute__ ((vector_size (64)));
+
+#define MAXLANES 16
+
+enum { EXP, LOG, SIN, COS };
+
+/* The entry points of the variant ISA, with vectors of ND doubles and NF
+   floats, and functions that call them on arrays, compiled for TGT.  */
+#define VARIANT(isa, nd, nf, tgt)  					\
+__attribute__ ((target (tgt))) vd##nd				\
+  _ZGV##isa##N##nd##v_exp (vd##nd);					\
+__attribute__ ((target (tgt))) vd##nd				\
+  _ZGV##isa##N##nd##v_log (vd##nd);					\
+__attribute__ ((target (tgt))) vd##nd				\
+  _ZGV##isa##N##nd##v_sin (vd##nd);					\
+__attribute__ ((target (tgt))) vd##nd				\
+  _ZGV##isa##N##nd##v_cos (vd##nd);					\
+__attribute__ ((target (tgt))) vd##nd				\
+  _ZGV##isa##N##nd##vv_pow (vd##nd, vd##nd);				\
+__attribute__ ((target (tgt))) void					\
+  _ZGV##isa##N##nd##vl8l8_sincos (vd##nd, double *, double *);		\
+__attribute__ ((target (tgt))) vf##nf				\
+  _ZGV##isa##N##nf##v_expf (vf##nf);					\
+__attribute__ ((target (tgt))) vf##nf				\
+  _ZGV##isa##N##nf##v_logf (vf##nf);					\
+__attribute__ ((target (tgt))) vf##nf				\
+  _ZGV##isa##N##nf##v_sinf (vf##nf);					\
+__attribute__ ((target (tgt))) vf##nf				\
+  _ZGV##isa##N##nf##v_cosf (vf##nf);					\
+									\
+static __attribute__ ((target (tgt))) void				\
+isa##_d (int fn, const double *x, double *r)				\
+{									\
+  vd##nd v, y;								\
+									\
+  memcpy (&v, x, sizeof (v));						\
+  switch (fn)								\
+    {									\
+    case EXP: y = _ZGV##isa##N##nd##v_exp (v); break;			\
+    case LOG: y = _ZGV##isa##N##nd##v_log (v); break;			\
+    case SIN: y = _ZGV##isa##N##nd##v_sin (v); break;			\
+    default: y = _ZGV##isa##N##nd##v_cos (v); break;			\
+    }									\
+  memcpy (r, &y, sizeof (y));						\
+}									\
+									\
+static __attribute__ ((target (tgt))) void				\
+isa##_pow (const double *x, const double *y, double *r)		\
+{									\
+  vd##nd v, w;								\
+									\
+  memcpy (&v, x, sizeof (v));						\
+  memcpy (&w, y, sizeof (w));						\
+  v = _ZGV##isa##N##nd##vv_pow (v, w);					\
+  memcpy (r, &v, sizeof (v));						\
+}									\
+									\
+static __attribute__ ((target (tgt))) void				\
+isa##_sincos (const double *x, double *s, double *c)			\
+{									\
+  vd##nd v;								\
+									\
+  memcpy (&v, x, sizeof (v));						\
+  _ZGV##isa##N##nd##vl8l8_sincos (v, s, c);				\
+}									\
+									\
+static __attribute__ ((target (tgt))) void				\
+isa##_f (int fn, const float *x, float *r)				\
+{									\
+  vf##nf v, y;								\
+									\
+  memcpy (&v, x, sizeof (v));						\
+  switch (fn)								\
+    {									\
+    case EXP: y = _ZGV##isa##N##nf##v_expf (v); break;			\
+    case LOG: y = _ZGV##isa##N##nf##v_logf (v); break;			\
+    case SIN: y = _ZGV##isa##N##nf##v_sinf (v); break;			\
+    default: y = _ZGV##isa##N##nf##v_cosf (v); break;			\
+    }									\
+  memcpy (r, &y, sizeof (y));						\
+}
+
+VARIANT (b, 2, 4, "sse2")
+VARIANT (c, 4, 8, "avx")
+VARIANT (d, 4, 8, "avx2,fma")
+VARIANT (e, 8, 16, "avx512f")
+
+/* The sincos that takes a vector of pointers for each result.  The AVX
+   one gets each of them as two halves.  */
+__attribute__ ((target ("sse2"))) void _ZGVbN2vvv_sincos (vd2, vl2, vl2);
+__attribute__ ((target ("avx"))) void _ZGVcN4vvv_sincos (vd4, vl2, vl2,
+							 vl2, vl2);
+__attribute__ ((target ("avx2,fma"))) void _ZGVdN4vvv_sincos (vd4, vl4, vl4);
+__attribute__ ((target ("avx512f"))) void _ZGVeN8vvv_sincos (vd8, vl8, vl8);
+
+static __attribute__ ((target ("sse2"))) void
+b_sincos_vvv (const double *x, double **s, double **c)
+{
+  vd2 v;
+  vl2 sp, cp;
+
+  memcpy (&v, x, sizeof (v));
+  memcpy (&sp, s, sizeof (sp));
+  memcpy (&cp, c, sizeof (cp));
+  _ZGVbN2vvv_sincos (v, sp, cp);
+}
+
+static __attribute__ ((target ("avx"))) void
+c_sincos_vvv (const double *x, double **s, double **c)
+{
+  vd4 v;
+  vl2 sp[2], cp[2];
+
+  memcpy (&v, x, sizeof (v));
+  memcpy (sp, s, sizeof (sp));
+  memcpy (cp, c, sizeof (cp));
+  _ZGVcN4vvv_sincos (v, sp[0], sp[1], cp[0], cp[1]);
+}
+
+static __attribute__ ((target ("avx2,fma"))) void
+d_sincos_vvv (const double *x, double **s, double **c)
+{
+  vd4 v;
+  vl4 sp, cp;
+
+  memcpy (&v, x, sizeof (v));
+  memcpy (&sp, s, sizeof (sp));
+  memcpy (&cp, c, sizeof (cp));
+  _ZGVdN4vvv_sincos (v, sp, cp);
+}
+
+static __attribute__ ((target ("avx512f"))) void
+e_sincos_vvv (const double *x, double **s, double **c)
+{
+  vd8 v;
+  vl8 sp, cp;
+
+  memcpy (&v, x, sizeof (v));
+  memcpy (&sp, s, sizeof (sp));
+  memcpy (&cp, c, sizeof (cp));
+  _ZGVeN8vvv_sincos (v, sp, cp);
+}
+
+struct variant
+{
+  const char *name;
+  int nd, nf;
+  void (*d) (int, const double *, double *);
+  void (*pow) (const double *, const double *, double *);
+  void (*sincos) (const double *, double *, double *);
+  void (*sincos_vvv) (const double *, double **, double **);
+  void (*f) (int, const float *, float *);
+};
+
+static const struct variant variants[] = {
+  { "sse2", 2, 4, b_d, b_pow, b_sincos, b_sincos_vvv, b_f },
+  { "avx", 4, 8, c_d, c_pow, c_sincos, c_sincos_vvv, c_f },
+  { "avx2", 4, 8, d_d, d_pow, d_sincos, d_sincos_vvv, d_f },
+  { "avx512", 8, 16, e_d, e_pow, e_sincos, e_sincos_vvv, e_f },
+};
+
+/* Whether the processor and the system run the Ith variant.  The
+   AVX-512 one calls the AVX2 one.  */
+static int
+supported (int i)
+{
+  unsigned int eax, ebx = 0, ecx = 0, edx, xcr0 = 0;
+  int avx, fma, avx2, avx512;
+
+  __get_cpuid (1, &eax, &ebx, &ecx, &edx);
+  if (ecx & bit_OSXSAVE)
+    __asm__ ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+  avx = (ecx & bit_AVX) && (xcr0 & 6) == 6;
+  fma = avx && (ecx & bit_FMA);
+  __get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx);
+  avx2 = fma && (ebx & bit_AVX2);
+  avx512 = avx2 && (ebx & bit_AVX512F) && (xcr0 & 0xe6) == 0xe6;
+
+  switch (i)
+    {
+    case 0:
+      return 1;
+    case 1:
+      return avx;
+    case 2:
+      return avx2;
+    default:
+      return avx512;
+    }
+}
+
+/* The doubles and floats in the order of their values.  */
+static int64_t
+order_d (double x)
+{
+  int64_t i;
+
+  memcpy (&i, &x, sizeof (i));
+  return i < 0 ? INT64_MIN - i : i;
+}
+
+static int32_t
+order_f (float x)
+{
+  int32_t i;
+
+  memcpy (&i, &x, sizeof (i));
+  return i < 0 ? INT32_MIN - i : i;
+}
+
+static int
+close_d (double v, double s)
+{
+  if (isnan (s) || isnan (v))
+    return isnan (s) && isnan (v);
+  if (isinf (s) || isinf (v))
+    return v == s;
+  return llabs (order_d (v) - order_d (s)) <= 1;
+}
+
+static int
+close_f (float v, float s)
+{
+  if (isnan (s) || isnan (v))
+    return isnan (s) && isnan (v);
+  if (isinf (s) || isinf (v))
+    return v == s;
+  return labs ((long) order_f (v) - order_f (s)) <= 1;
+}
+
+static void
+check_d (const char *isa, const char *fn, int lane, double x, double y,
+	 double v, double s)
+{
+  if (!close_d (v, s))
+    {
+      printf ("%s %s (%a, %a) in lane %d, inacurate answer: "
+	      "(%a should be %a)\n", isa, fn, x, y, lane, v, s);
+      inacc++;
+    }
+}
+
+static void
+check_f (const char *isa, const char *fn, int lane, float x, float v,
+	 float s)
+{
+  if (!close_f (v, s))
+    {
+      printf ("%s %s (%a) in lane %d, inacurate answer: (%a should be %a)\n",
+	      isa, fn, x, lane, v, s);
+      inacc++;
+    }
+}
+
+#define MAXARGS 400
+
+/* The arguments of the vector P followed by the N of MORE.  */
+static int
+args (double *a, const one_line_type *p, const double *more, int n)
+{
+  int i = 0, j;
+
+  for (; p->line != 0; ++p)
+    {
+      uint64_t bits = ((uint64_t) (uint32_t) p->qs[1].msw << 32)
+		      | (uint32_t) p->qs[1].lsw;
+
+      memcpy (&a[i++], &bits, sizeof (bits));
+    }
+  for (j = 0; j < n; ++j)
+    a[i + j] = more[j];
+  return i + n;
+}
+
+#define NELEMS(a) ((int) (sizeof (a) / sizeof ((a)[0])))
+
+static const double exp_more[] = {
+  NAN, -NAN, INFINITY, -INFINITY, 0.0, -0.0, 0x1p-1074, -0x1p-1074,
+  0x1.62e42fefa39efp+9, 0x1.62e42fefa39f0p+9, 1000.0, DBL_MAX,
+  -0x1.6232bdd7abcd2p+9, -0x1.6232bdd7abcd3p+9, -0x1.74385446d71c3p+9,
+  -0x1.74910d52d3051p+9, -0x1.74910d52d3052p+9, -1000.0, -DBL_MAX,
+};
+
+static const double log_more[] = {
+  NAN, INFINITY, -INFINITY, 0.0, -0.0, -1.0, -DBL_MIN, 1.0,
+  0x1.0000000000001p+0, 0x1.fffffffffffffp-1, 0x1p-1074, 0x1.8p-1073,
+  0x1p-1022, 0x1.fffffffffffffp-1023, DBL_MAX,
+};
+
+static const double sin_more[] = {
+  NAN, INFINITY, -INFINITY, 0.0, -0.0, 0x1p-1074, 0x1p-1022, 0x1p-27,
+  M_PI, -M_PI_2, 0x1.fffffffffffffp+19, 0x1p20, -0x1.0000000000001p+20,
+  1e22, 0x1p1023, DBL_MAX,
+};
+
+static const double pow_more[][2] = {
+  { NAN, 1.0 }, { 1.0, NAN }, { NAN, 0.0 }, { -NAN, 2.0 },
+  { 0.0, -1.0 }, { -0.0, -1.0 }, { -0.0, -2.0 }, { 0.0, 1.0 },
+  { -0.0, 3.0 }, { 0.0, 0.0 }, { -1.0, INFINITY }, { -1.0, -INFINITY },
+  { 0.5, INFINITY }, { 2.0, -INFINITY }, { INFINITY, -1.0 },
+  { -INFINITY, 3.0 }, { -INFINITY, -2.0 }, { 2.0, 1023.0 },
+  { 2.0, 1024.0 }, { 2.0, -1022.0 }, { 2.0, -1074.0 }, { 2.0, -1075.0 },
+  { 2.0, -1076.0 }, { 0.5, 2000.0 }, { 10.0, 308.25 }, { 10.0, 308.26 },
+  { 10.0, -323.5 }, { -2.0, 3.0 }, { -2.0, 0.5 }, { -2.0, -1025.0 },
+  { -8.0, 1.0 / 3 }, { DBL_MAX, 2.0 }, { 0x1p-1074, 0.5 },
+  { 0x1p-1074, -1.0 }, { 1.0000001, 1e10 }, { 0.9999999, 1e10 },
+  { 1.0, 1e300 }, { 0x1.fffffffffffffp-1, 0x1p62 },
+};
+
+static const double expf_more[] = {
+  NAN, -NAN, INFINITY, -INFINITY, 0.0, -0.0, 0x1p-149, 0x1.62e42ep+6,
+  0x1.62e430p+6, 100.0, FLT_MAX, -0x1.5d589ep+6, -0x1.5d58a0p+6,
+  -0x1.9fe368p+6, -0x1.9fe36ap+6, -104.0, -FLT_MAX,
+};
+
+static const double logf_more[] = {
+  NAN, INFINITY, -INFINITY, 0.0, -0.0, -1.0, -FLT_MIN, 1.0,
+  0x1.000002p+0, 0x1.fffffep-1, 0x1p-149, 0x1p-126, FLT_MAX,
+};
+
+static const double sinf_more[] = {
+  NAN, INFINITY, -INFINITY, 0.0, -0.0, 0x1p-149, 0x1p-126, 0x1p-12,
+  0x1.921fb6p+0, -0x1.921fb6p+1, 0x1.fffffep+19, 0x1p20, -0x1.000002p+20,
+  1e10, FLT_MAX,
+};
+
+static double (*const scalar_d[]) (double) = { exp, log, sin, cos };
+static float (*const scalar_f[]) (float) = { expf, logf, sinf, cosf };
+static const char *const names_d[] = { "exp", "log", "sin", "cos" };
+static const char *const names_f[] = { "expf", "logf", "sinf", "cosf" };
+
+/* Each of the N arguments A in every lane of variant V of FN.  */
+static void
+test_d (const struct variant *v, int fn, const double *a, int n)
+{
+  double x[MAXLANES], r[MAXLANES];
+  int i, k;
+
+  for (i = 0; i < n; ++i)
+    {
+      for (k = 0; k < v->nd; ++k)
+	x[k] = a[(i + k) % n];
+      v->d (fn, x, r);
+      for (k = 0; k < v->nd; ++k)
+	check_d (v->name, names_d[fn], k, x[k], 0, r[k], scalar_d[fn] (x[k]));
+    }
+}
+
+static void
+test_f (const struct variant *v, int fn, const double *a, int n)
+{
+  float x[MAXLANES], r[MAXLANES];
+  int i, k;
+
+  for (i = 0; i < n; ++i)
+    {
+      for (k = 0; k < v->nf; ++k)
+	x[k] = a[(i + k) % n];
+      v->f (fn, x, r);
+      for (k = 0; k < v->nf; ++k)
+	check_f (v->name, names_f[fn], k, x[k], r[k], scalar_f[fn] (x[k]));
+    }
+}
+
+static void
+test_pow (const struct variant *v, const double *a, const double *b, int n)
+{
+  double x[MAXLANES], y[MAXLANES], r[MAXLANES];
+  int i, k;
+
+  for (i = 0; i < n; ++i)
+    {
+      for (k = 0; k < v->nd; ++k)
+	{
+	  x[k] = a[(i + k) % n];
+	  y[k] = b[(i + k) % n];
+	}
+      v->pow (x, y, r);
+      for (k = 0; k < v->nd; ++k)
+	check_d (v->name, "pow", k, x[k], y[k], r[k], pow (x[k], y[k]));
+    }
+}
+
+/* sincos with the results stored in arrays, and stored through vectors
+   of pointers, which point to the lanes in the reverse order.  */
+static void
+test_sincos (const struct variant *v, const double *a, int n)
+{
+  double x[MAXLANES], s[MAXLANES], c[MAXLANES];
+  double *sp[MAXLANES], *cp[MAXLANES];
+  int i, k;
+
+  for (i = 0; i < n; ++i)
+    {
+      for (k = 0; k < v->nd; ++k)
+	x[k] = a[(i + k) % n];
+      v->sincos (x, s, c);
+      for (k = 0; k < v->nd; ++k)
+	{
+	  check_d (v->name, "sincos", k, x[k], 0, s[k], sin (x[k]));
+	  check_d (v->name, "sincos", k, x[k], 0, c[k], cos (x[k]));
+	}
+
+      for (k = 0; k < v->nd; ++k)
+	{
+	  sp[k] = &s[v->nd - 1 - k];
+	  cp[k] = &c[v->nd - 1 - k];
+	}
+      v->sincos_vvv (x, sp, cp);
+      for (k = 0; k < v->nd; ++k)
+	{
+	  check_d (v->name, "sincos vvv", k, x[k], 0, *sp[k], sin (x[k]));
+	  check_d (v->name, "sincos vvv", k, x[k], 0, *cp[k], cos (x[k]));
+	}
+    }
+}
+
+void
+_DEFUN_VOID(test_simd)
+{
+  static double a[MAXARGS], b[MAXARGS];
+  const struct variant *v;
+  int n, m, i;
+
+  for (i = 0; i < NELEMS (variants); ++i)
+    {
+      if (!supported (i))
+	continue;
+      v = &variants[i];
+      newfunc (v->name);
+
+      test_d (v, EXP, a, args (a, exp_vec, exp_more, NELEMS (exp_more)));
+      test_d (v, LOG, a, args (a, log_vec, log_more, NELEMS (log_more)));
+      test_d (v, SIN, a, args (a, sin_vec, sin_more, NELEMS (sin_more)));
+      test_d (v, COS, a, args (a, cos_vec, sin_more, NELEMS (sin_more)));
+      test_sincos (v, a, args (a, sin_vec, sin_more, NELEMS (sin_more)));
+
+      /* pow of the arguments of the log vector to the powers of the exp
+	 vector, then the special cases.  */
+      n = args (a, log_vec, NULL, 0);
+      m = args (b, exp_vec, NULL, 0);
+      if (m < n)
+	n = m;
+      for (m = 0; m < NELEMS (pow_more); ++m)
+	{
+	  a[n + m] = pow_more[m][0];
+	  b[n + m] = pow_more[m][1];
+	}
+      test_pow (v, a, b, n + NELEMS (pow_more));
+
+      test_f (v, EXP, a, args (a, expf_vec, expf_more, NELEMS (expf_more)));
+      test_f (v, LOG, a, args (a, logf_vec, logf_more, NELEMS (logf_more)));
+      test_f (v, SIN, a, args (a, sinf_vec, sinf_more, NELEMS (sinf_more)));
+      test_f (v, COS, a, args (a, cosf_vec, sinf_more, NELEMS (sinf_more)));
+    }
+}
+
+#else
+
+void
+_DEFUN_VOID(test_simd)
+{
+}
+
+#endif /* __x86_64__ */
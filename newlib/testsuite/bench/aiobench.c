@@ -0,0 +1,213 @@
+/* Benchmark of the asynchronous I/O of linuxthreads, see README.  */
+
+#define _GNU_SOURCE
+
+#include <aio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+static const char *path = "aiobench.dat";
+static long file_mib = 64;
+static size_t block = 4096;
+static int max_depth = 64;
+static int cold;
+
+/* The byte at OFFSET of the test pattern.  */
+static unsigned char
+pattern (off_t offset)
+{
+  return (unsigned char) ((offset >> 12) * 7 + offset * 13);
+}
+
+static void
+fill (unsigned char *buf, off_t offset, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    buf[i] = pattern (offset + i);
+}
+
+static void
+init_cb (struct aiocb *cb, int fd, void *buf, size_t n, off_t offset)
+{
+  memset (cb, 0, sizeof (struct aiocb));
+  cb->aio_fildes = fd;
+  cb->aio_buf = buf;
+  cb->aio_nbytes = n;
+  cb->aio_offset = offset;
+  cb->aio_sigevent.sigev_notify = SIGEV_NONE;
+}
+
+static int
+make_file (void)
+{
+  unsigned char *buf = malloc (1 << 20);
+  long i;
+  int fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0 || buf == NULL)
+    {
+      perror (path);
+      exit (1);
+    }
+  for (i = 0; i < file_mib; i++)
+    {
+      fill (buf, (off_t) i << 20, 1 << 20);
+      if (write (fd, buf, 1 << 20) != 1 << 20)
+	{
+	  perror ("write");
+	  exit (1);
+	}
+    }
+  fsync (fd);
+  free (buf);
+  return fd;
+}
+
+static void
+drop_cache (int fd)
+{
+  if (cold)
+    posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+/* Read the whole file in blocks at OFFSETS keeping DEPTH requests in
+   flight.  Returns the time taken, or -1 on an error.  */
+static double
+run_depth (int fd, int depth, off_t *offsets, long nblocks)
+{
+  struct aiocb *cb = calloc (depth, sizeof (struct aiocb));
+  const struct aiocb **list = calloc (depth, sizeof (struct aiocb *));
+  unsigned char *bufs = malloc ((size_t) depth * block);
+  long next = 0, done = 0;
+  double t0;
+  int i, bad = 0;
+
+  drop_cache (fd);
+  t0 = bench_now ();
+  for (i = 0; i < depth && next < nblocks; i++, next++)
+    {
+      init_cb (&cb[i], fd, bufs + (size_t) i * block, block, offsets[next]);
+      list[i] = &cb[i];
+      if (aio_read (&cb[i]) != 0)
+	bad = 1;
+    }
+  while (done < nblocks && !bad)
+    {
+      aio_suspend (list, depth, NULL);
+      for (i = 0; i < depth; i++)
+	if (list[i] != NULL && aio_error (&cb[i]) != EINPROGRESS)
+	  {
+	    if (aio_return (&cb[i]) != (ssize_t) block)
+	      bad = 1;
+	    ++done;
+	    if (next < nblocks)
+	      {
+		cb[i].aio_offset = offsets[next++];
+		if (aio_read (&cb[i]) != 0)
+		  bad = 1;
+	      }
+	    else
+	      list[i] = NULL;
+	  }
+    }
+  t0 = bench_now () - t0;
+  free (cb);
+  free (list);
+  free (bufs);
+  return bad ? -1 : t0;
+}
+
+static double
+run_pread (int fd, off_t *offsets, long nblocks)
+{
+  unsigned char *buf = malloc (block);
+  double t0;
+  long i;
+
+  drop_cache (fd);
+  t0 = bench_now ();
+  for (i = 0; i < nblocks; i++)
+    if (pread (fd, buf, block, offsets[i]) != (ssize_t) block)
+      return -1;
+  t0 = bench_now () - t0;
+  free (buf);
+  return t0;
+}
+
+static void
+report (const char *order, int depth, const char *what, double t,
+	long nblocks)
+{
+  if (t < 0)
+    printf ("%3d %-6s %-5s error\n", depth, order, what);
+  else
+    printf ("%3d %-6s %-5s %9.1f MiB/s %10.0f req/s\n", depth, order, what,
+	    nblocks * (double) block / t / (1 << 20), nblocks / t);
+}
+
+static void
+run_bench (void)
+{
+  long nblocks = (file_mib << 20) / block, i, j;
+  off_t *seq = malloc (nblocks * sizeof (off_t));
+  off_t *rnd = malloc (nblocks * sizeof (off_t));
+  int fd = make_file ();
+  int depth, r;
+
+  for (i = 0; i < nblocks; i++)
+    seq[i] = rnd[i] = (off_t) i * block;
+  for (i = nblocks - 1; i > 0; i--)
+    {
+      off_t t;
+
+      j = rand () % (i + 1);
+      t = rnd[i];
+      rnd[i] = rnd[j];
+      rnd[j] = t;
+    }
+
+  printf ("depth order  impl  throughput\n");
+  for (r = 0; r < 2; r++)
+    {
+      off_t *offsets = r ? rnd : seq;
+      const char *order = r ? "random" : "seq";
+
+      report (order, 1, "pread", run_pread (fd, offsets, nblocks), nblocks);
+      for (depth = 1; depth <= max_depth; depth *= 2)
+	report (order, depth, "aio", run_depth (fd, depth, offsets, nblocks),
+		nblocks);
+    }
+  close (fd);
+  unlink (path);
+}
+
+int
+main (int argc, char **argv)
+{
+  int c;
+
+  while ((c = getopt (argc, argv, "b:cd:f:s:")) != -1)
+    switch (c)
+      {
+      case 'b': block = strtoul (optarg, NULL, 0); break;
+      case 'c': cold = 1; break;
+      case 'd': max_depth = atoi (optarg); break;
+      case 'f': path = optarg; break;
+      case 's': file_mib = atol (optarg); break;
+      default:
+	fprintf (stderr, "usage: %s [-c] [-b block] [-d depth] [-f file]"
+		 " [-s MiB]\n", argv[0]);
+	return 2;
+      }
+  run_bench ();
+  return 0;
+}
@@ -0,0 +1,19 @@
+/* What the benchmarks share, see README.  */
+
+#include <time.h>
+#include <unistd.h>
+
+/* Seconds on the monotonic clock, or of processor time where there is
+   none.  */
+static double
+bench_now (void)
+{
+#ifdef _POSIX_MONOTONIC_CLOCK
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,191 @@
+/* Benchmark of the symbol lookup of the dynamic linker, see README.  */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+static const char *dir = "objs-gnu";
+static int rounds = 5;
+
+static void *
+open_object (const char *name, int mode)
+{
+  char path[512];
+  void *h;
+
+  snprintf (path, sizeof path, "%s/%s", dir, name);
+  h = dlopen (path, mode);
+  if (h == NULL)
+    {
+      fprintf (stderr, "dlbench: %s\n", dlerror ());
+      exit (1);
+    }
+  return h;
+}
+
+/* The best time of ROUNDS relocations of NAME, which refers to NREFS
+   symbols of the objects loaded before it, in nanoseconds per symbol.  */
+static double
+relocate (const char *name, long nrefs, int n)
+{
+  double t, best = 0;
+  void *h;
+  int r;
+
+  for (r = 0; r < n; r++)
+    {
+      t = bench_now ();
+      h = open_object (name, RTLD_NOW);
+      t = bench_now () - t;
+      dlclose (h);
+      if (r == 0 || t < best)
+	best = t;
+    }
+  return best * 1e9 / nrefs;
+}
+
+static void
+empty_dir (const char *path)
+{
+  char file[PATH_MAX];
+  struct dirent *d;
+  DIR *dp = opendir (path);
+
+  if (dp == NULL)
+    return;
+  while ((d = readdir (dp)) != NULL)
+    if (d->d_name[0] != '.')
+      {
+	snprintf (file, sizeof file, "%s/%s", path, d->d_name);
+	unlink (file);
+      }
+  closedir (dp);
+}
+
+/* The time of one relocation of hit.so in a run of this program with
+   LD_BIND_CACHE set to CACHE, which -1 makes it do and print.  */
+static double
+relocate_cached (const char *cache)
+{
+  char self[PATH_MAX], out[64];
+  int fds[2], status;
+  ssize_t n, len = 0;
+  pid_t pid;
+
+  n = readlink ("/proc/self/exe", self, sizeof self - 1);
+  if (n < 0 || pipe (fds) != 0 || (pid = fork ()) == -1)
+    {
+      perror ("dlbench");
+      exit (1);
+    }
+  self[n] = '\0';
+  if (pid == 0)
+    {
+      dup2 (fds[1], 1);
+      close (fds[0]);
+      close (fds[1]);
+      setenv ("LD_BIND_CACHE", cache, 1);
+      execl (self, self, "-d", dir, "-1", (char *) NULL);
+      _exit (127);
+    }
+  close (fds[1]);
+  while (len < (ssize_t) sizeof out - 1
+	 && (n = read (fds[0], out + len, sizeof out - 1 - len)) > 0)
+    len += n;
+  out[len] = '\0';
+  close (fds[0]);
+  if (waitpid (pid, &status, 0) != pid || !WIFEXITED (status)
+      || WEXITSTATUS (status) != 0)
+    {
+      fprintf (stderr, "dlbench: run with LD_BIND_CACHE failed\n");
+      exit (1);
+    }
+  return atof (out);
+}
+
+int
+main (int argc, char **argv)
+{
+  char path[512], cache[] = "/tmp/dlbenchXXXXXX";
+  int nobjs, nsyms, i, c, once = 0;
+  double t, best;
+  FILE *f;
+
+  while ((c = getopt (argc, argv, "d:r:1")) != -1)
+    switch (c)
+      {
+      case 'd': dir = optarg; break;
+      case 'r': rounds = atoi (optarg); break;
+      case '1': once = 1; break;
+      default:
+	fprintf (stderr, "usage: %s [-d dir] [-r rounds]\n", argv[0]);
+	return 2;
+      }
+
+  snprintf (path, sizeof path, "%s/stamp", dir);
+  f = fopen (path, "r");
+  if (f == NULL || fscanf (f, "%d %d", &nobjs, &nsyms) != 2)
+    {
+      fprintf (stderr, "dlbench: no objects in %s, see README\n", dir);
+      return 1;
+    }
+  fclose (f);
+
+  t = bench_now ();
+  for (i = 0; i < nobjs; i++)
+    {
+      snprintf (path, sizeof path, "lib%04d.so", i);
+      open_object (path, RTLD_NOW | RTLD_GLOBAL);
+    }
+  t = bench_now () - t;
+
+  if (once)
+    {
+      t = bench_now ();
+      open_object ("hit.so", RTLD_NOW);
+      printf ("%.9f\n", bench_now () - t);
+      return 0;
+    }
+
+  printf ("%s: %d objects of %d symbols, loaded in %.1fms\n", dir, nobjs,
+	  nsyms, t * 1e3);
+  printf ("%-12s %8.1f ns/symbol\n", "hit",
+	  relocate ("hit.so", (long) nobjs * nsyms + 1, rounds));
+  printf ("%-12s %8.1f ns/symbol\n", "miss",
+	  relocate ("miss.so", (long) nobjs * (nsyms / 4), rounds));
+
+  if (mkdtemp (cache) == NULL)
+    {
+      perror ("dlbench");
+      return 1;
+    }
+  for (i = 0, best = 0; i < rounds; i++)
+    {
+      empty_dir (cache);
+      t = relocate_cached (cache);
+      if (i == 0 || t < best)
+	best = t;
+    }
+  printf ("%-12s %8.1f ns/symbol\n", "cache write",
+	  best * 1e9 / ((long) nobjs * nsyms + 1));
+  for (i = 0, best = 0; i < rounds; i++)
+    {
+      t = relocate_cached (cache);
+      if (i == 0 || t < best)
+	best = t;
+    }
+  printf ("%-12s %8.1f ns/symbol\n", "cache read",
+	  best * 1e9 / ((long) nobjs * nsyms + 1));
+  empty_dir (cache);
+  rmdir (cache);
+  return 0;
+}
@@ -0,0 +1,183 @@
+/* Benchmark of iconv_open and of the builtin conversions of iconv, see
+   README.  */
+
+#include <iconv.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+enum { UTF8, UCS4, UCS2, LATIN1, INTERNAL, NKINDS };
+
+static const struct
+{
+  const char *name;
+  const char *label;
+  uint32_t max;			/* Largest character it can carry.  */
+} kinds[NKINDS] =
+{
+  { "UTF-8", "utf8", 0x7fffffff },
+  { "UCS-4", "ucs4", 0x7fffffff },
+  { "UCS-2", "ucs2", 0xffff },
+  { "ISO-8859-1", "latin1", 0xff },
+  { "WCHAR_T", "internal", 0x7fffffff }
+};
+
+#define NCHARS (1 << 18)
+
+static unsigned char in[NCHARS * 6], out[NCHARS * 6];
+
+/* A random character of at most MAX, mostly ASCII as in real text,
+   without surrogates.  */
+static uint32_t
+rand_char (uint32_t max)
+{
+  int r = random () % 100;
+  uint32_t ch;
+
+  if (r < 60)
+    ch = 0x20 + random () % 0x5f;
+  else if (r < 75)
+    ch = 0x80 + random () % 0x80;
+  else if (r < 85)
+    ch = 0x100 + random () % 0x700;
+  else if (r < 95)
+    ch = 0x800 + random () % 0xf800;
+  else
+    ch = 0x10000 + random () % 0x100000;
+
+  if (ch > max)
+    ch %= max + 1;
+  if (ch >= 0xd800 && ch < 0xe000)
+    ch -= 0x800;
+  return ch;
+}
+
+/* Write NCHARS random characters that both FROM and TO can carry into
+   IN, in FROM.  */
+static size_t
+make_input (int from, int to)
+{
+  uint32_t max = kinds[from].max < kinds[to].max
+		 ? kinds[from].max : kinds[to].max;
+  unsigned char *p = in;
+  uint16_t u;
+  uint32_t ch;
+  int i, len, j;
+
+  for (i = 0; i < NCHARS; i++)
+    {
+      ch = rand_char (max);
+      switch (from)
+	{
+	case UTF8:
+	  if (ch < 0x80)
+	    {
+	      *p++ = ch;
+	      break;
+	    }
+	  len = ch < 0x800 ? 2 : ch < 0x10000 ? 3 : 4;
+	  p[0] = ~0xff >> len;
+	  for (j = len - 1; j > 0; j--, ch >>= 6)
+	    p[j] = 0x80 | (ch & 0x3f);
+	  p[0] |= ch;
+	  p += len;
+	  break;
+	case UCS4:
+	  *p++ = ch >> 24;
+	  *p++ = ch >> 16;
+	  *p++ = ch >> 8;
+	  *p++ = ch;
+	  break;
+	case UCS2:
+	  u = ch;
+	  memcpy (p, &u, 2);
+	  p += 2;
+	  break;
+	case LATIN1:
+	  *p++ = ch;
+	  break;
+	case INTERNAL:
+	  memcpy (p, &ch, 4);
+	  p += 4;
+	  break;
+	}
+    }
+  return p - in;
+}
+
+static iconv_t
+open_or_die (const char *to, const char *from)
+{
+  iconv_t cd = iconv_open (to, from);
+
+  if (cd == (iconv_t) -1)
+    {
+      fprintf (stderr, "iconvbench: no conversion from %s to %s\n", from,
+	       to);
+      exit (1);
+    }
+  return cd;
+}
+
+/* Nanoseconds for an iconv_open and iconv_close.  */
+static void
+bench_open (const char *to, const char *from, int n)
+{
+  double t = bench_now ();
+  int i;
+
+  for (i = 0; i < n; i++)
+    iconv_close (open_or_die (to, from));
+  printf ("open  %-10s %-16s %8.0f ns\n", from, to,
+	  (bench_now () - t) / n * 1e9);
+}
+
+/* Megabytes of input per second that iconv converts.  */
+static void
+bench_convert (int from, int to)
+{
+  iconv_t cd = open_or_die (kinds[to].name, kinds[from].name);
+  size_t len = make_input (from, to), il, ol;
+  double t0 = bench_now (), t1;
+  char *ip, *op;
+  int rounds = 0;
+
+  do
+    {
+      ip = (char *) in;
+      op = (char *) out;
+      il = len;
+      ol = sizeof out;
+      iconv (cd, NULL, NULL, NULL, NULL);
+      if (iconv (cd, &ip, &il, &op, &ol) == (size_t) -1 || il != 0)
+	{
+	  fprintf (stderr, "iconvbench: %s to %s failed\n", kinds[from].label,
+		   kinds[to].label);
+	  exit (1);
+	}
+      rounds++;
+    }
+  while ((t1 = bench_now ()) - t0 < 0.2);
+  iconv_close (cd);
+  printf ("conv  %-10s %-16s %8.0f MB/s\n", kinds[from].label,
+	  kinds[to].label, len * (double) rounds / (t1 - t0) / 1e6);
+}
+
+int
+main (void)
+{
+  int from, to;
+
+  bench_open ("UCS-2", "UTF-8", 100000);
+  bench_open ("UCS-4", "UCS-2", 100000);
+  bench_open ("UTF-8", "LATIN1", 100000);
+  bench_open ("WCHAR_T//IGNORE", "UTF-8", 100000);
+  for (from = 0; from < NKINDS; from++)
+    for (to = 0; to < NKINDS; to++)
+      if (from != to)
+	bench_convert (from, to);
+  return 0;
+}
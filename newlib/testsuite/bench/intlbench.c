@@ -0,0 +1,328 @@
+/* Benchmark of the message lookup of gettext, see README.  */
+
+#include <libintl.h>
+#include <limits.h>
+#include <locale.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "bench.h"
+
+#define NSTRINGS 2000		/* Messages in the large catalogs.  */
+
+/* Writing catalogs, as newlib.linux/gettext.c does.  */
+
+struct entry
+{
+  char *msgid;			/* With the plural after its NUL.  */
+  size_t msgid_len;		/* Up to the last NUL.  */
+  char *msgstr;
+  size_t msgstr_len;
+};
+
+static int
+entry_cmp (const void *p1, const void *p2)
+{
+  return strcmp (((const struct entry *) p1)->msgid,
+		 ((const struct entry *) p2)->msgid);
+}
+
+static uint32_t
+hashpjw (const char *str)
+{
+  uint32_t hval = 0, g;
+
+  while (*str != '\0')
+    {
+      hval <<= 4;
+      hval += (unsigned char) *str++;
+      g = hval & ((uint32_t) 0xf << 28);
+      if (g != 0)
+	{
+	  hval ^= g >> 24;
+	  hval ^= g;
+	}
+    }
+  return hval;
+}
+
+static uint32_t
+next_prime (uint32_t n)
+{
+  uint32_t d;
+
+  if (n < 3)
+    return 3;
+  n |= 1;
+  for (;;)
+    {
+      for (d = 3; d * d <= n && n % d != 0; d += 2)
+	;
+      if (d * d > n)
+	return n;
+      n += 2;
+    }
+}
+
+static void
+put32 (FILE *fp, uint32_t w, int swap)
+{
+  if (swap)
+    w = __builtin_bswap32 (w);
+  fwrite (&w, 4, 1, fp);
+}
+
+/* Write the N entries at E as the catalog PATH, as msgfmt does with a
+   hash table if HASH, in the other byte order if SWAP.  */
+static void
+write_mo (const char *path, struct entry *e, size_t n, int hash, int swap)
+{
+  uint32_t hash_size = hash ? next_prime (n * 4 / 3) : 0;
+  uint32_t *hash_tab = calloc (hash_size + 1, 4);
+  uint32_t orig_off = 28, trans_off = orig_off + n * 8;
+  uint32_t hash_off = trans_off + n * 8;
+  uint32_t str_off = hash_off + hash_size * 4;
+  uint32_t h, idx, incr;
+  FILE *fp;
+  size_t i;
+
+  qsort (e, n, sizeof *e, entry_cmp);
+  for (i = 0; hash && i < n; i++)
+    {
+      h = hashpjw (e[i].msgid);
+      idx = h % hash_size;
+      incr = 1 + h % (hash_size - 2);
+      while (hash_tab[idx] != 0)
+	idx = idx >= hash_size - incr ? idx - (hash_size - incr) : idx + incr;
+      hash_tab[idx] = i + 1;
+    }
+
+  fp = fopen (path, "wb");
+  if (fp == NULL)
+    {
+      perror (path);
+      exit (1);
+    }
+  put32 (fp, 0x950412de, swap);
+  put32 (fp, 0, swap);
+  put32 (fp, n, swap);
+  put32 (fp, orig_off, swap);
+  put32 (fp, trans_off, swap);
+  put32 (fp, hash_size, swap);
+  put32 (fp, hash_off, swap);
+  for (i = 0; i < n; i++)
+    {
+      put32 (fp, e[i].msgid_len, swap);
+      put32 (fp, str_off, swap);
+      str_off += e[i].msgid_len + 1;
+    }
+  for (i = 0; i < n; i++)
+    {
+      put32 (fp, e[i].msgstr_len, swap);
+      put32 (fp, str_off, swap);
+      str_off += e[i].msgstr_len + 1;
+    }
+  for (i = 0; i < hash_size; i++)
+    put32 (fp, hash_tab[i], swap);
+  for (i = 0; i < n; i++)
+    fwrite (e[i].msgid, e[i].msgid_len + 1, 1, fp);
+  for (i = 0; i < n; i++)
+    fwrite (e[i].msgstr, e[i].msgstr_len + 1, 1, fp);
+  if (fclose (fp) != 0)
+    {
+      perror (path);
+      exit (1);
+    }
+  free (hash_tab);
+}
+
+static void
+set_entry (struct entry *e, const char *msgid, size_t msgid_len,
+	   const char *msgstr, size_t msgstr_len)
+{
+  e->msgid = malloc (msgid_len + 1);
+  e->msgstr = malloc (msgstr_len + 1);
+  memcpy (e->msgid, msgid, msgid_len + 1);
+  e->msgid_len = msgid_len;
+  memcpy (e->msgstr, msgstr, msgstr_len + 1);
+  e->msgstr_len = msgstr_len;
+}
+
+static void
+free_entries (struct entry *e, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      free (e[i].msgid);
+      free (e[i].msgstr);
+    }
+}
+
+static char *msgids[NSTRINGS];
+
+static const char *
+msgid (int i)
+{
+  char buf[100];
+
+  if (msgids[i] == NULL)
+    {
+      snprintf (buf, sizeof buf, "message %05d: the file could not be "
+		"opened", i);
+      msgids[i] = strdup (buf);
+    }
+  return msgids[i];
+}
+
+static void
+translation (char *buf, size_t size, const char *domain, int i)
+{
+  snprintf (buf, size, "[%s] Meldung %05d: die Datei konnte nicht "
+	    "ge\303\266ffnet werden", domain, i);
+}
+
+static char dir[] = "/tmp/intlbenchXXXXXX";
+
+static void
+catalog_path (char *path, size_t size, const char *domain)
+{
+  snprintf (path, size, "%s/xx/LC_MESSAGES/%s.mo", dir, domain);
+}
+
+/* The large catalog DOMAIN, with every third message not translated.  */
+static void
+write_large (const char *domain, int hash, int swap)
+{
+  static struct entry e[NSTRINGS + 1];
+  const char *header = "Content-Type: text/plain; charset=UTF-8\n";
+  char path[PATH_MAX], buf[200];
+  size_t n = 0;
+  int i;
+
+  set_entry (&e[n++], "", 0, header, strlen (header));
+  for (i = 0; i < NSTRINGS; i++)
+    if (i % 3 != 2)
+      {
+	translation (buf, sizeof buf, domain, i);
+	set_entry (&e[n++], msgid (i), strlen (msgid (i)), buf, strlen (buf));
+      }
+  catalog_path (path, sizeof path, domain);
+  write_mo (path, e, n, hash, swap);
+  free_entries (e, n);
+}
+
+static const char plural_header[] =
+  "Content-Type: text/plain; charset=UTF-8\n"
+  "Plural-Forms: nplurals=6; plural=n==0 ? 0 : n==1 ? 1 : n==2 ? 2 : "
+  "n%100>=3 && n%100<=10 ? 3 : n%100>=11 ? 4 : 5;";
+static const char plural_msgid[] = "%lu file\0%lu files";
+static const char plural_forms[] = "0\0001\0002\0003\0004\0005";
+
+static const char *large_domains[] = { "hashed", "nohash", "swapped" };
+#define NLARGE 3
+
+static volatile const char *sink;
+
+static void
+bench (void)
+{
+  const char *msgid2 = plural_msgid + strlen (plural_msgid) + 1;
+  int rounds, d, i, k;
+  double t;
+
+  /* The same message again and again, as in a loop.  */
+  rounds = 2000000;
+  t = bench_now ();
+  for (k = 0; k < rounds; k++)
+    sink = dcgettext ("hashed", msgid (7), LC_MESSAGES);
+  printf ("same      %8.1f ns\n", (bench_now () - t) * 1e9 / rounds);
+
+  /* All messages in turn, all known already.  */
+  rounds = 500;
+  t = bench_now ();
+  for (k = 0; k < rounds; k++)
+    for (i = 0; i < NSTRINGS; i++)
+      sink = dcgettext ("hashed", msgid (i), LC_MESSAGES);
+  printf ("cycle     %8.1f ns\n",
+	  (bench_now () - t) * 1e9 / rounds / NSTRINGS);
+
+  /* A plural form each time, of the same message.  */
+  rounds = 2000000;
+  t = bench_now ();
+  for (k = 0; k < rounds; k++)
+    sink = dcngettext ("arabic", plural_msgid, msgid2, k % 1000,
+		       LC_MESSAGES);
+  printf ("plural    %8.1f ns\n", (bench_now () - t) * 1e9 / rounds);
+
+  /* Everything looked up anew in the catalogs, as after textdomain.  */
+  for (d = 0; d < NLARGE; d++)
+    {
+      rounds = 50;
+      t = bench_now ();
+      for (k = 0; k < rounds; k++)
+	{
+	  textdomain ("");
+	  for (i = 0; i < NSTRINGS; i++)
+	    if (i % 3 != 2)
+	      sink = dcgettext (large_domains[d], msgid (i), LC_MESSAGES);
+	}
+      printf ("anew %-7s %6.1f ns\n", large_domains[d],
+	      (bench_now () - t) * 1e9 / rounds / (NSTRINGS - NSTRINGS / 3));
+    }
+}
+
+int
+main (void)
+{
+  struct entry e[2];
+  char path[PATH_MAX];
+  int d;
+
+  /* The catalogs are those of LANGUAGE, which is not looked at in the C
+     locale.  */
+  if (setlocale (LC_ALL, "C.UTF-8") == NULL || mkdtemp (dir) == NULL)
+    {
+      perror ("intlbench");
+      return 1;
+    }
+  setenv ("LANGUAGE", "xx", 1);
+  snprintf (path, sizeof path, "%s/xx", dir);
+  mkdir (path, 0700);
+  snprintf (path, sizeof path, "%s/xx/LC_MESSAGES", dir);
+  mkdir (path, 0700);
+  write_large ("hashed", 1, 0);
+  write_large ("nohash", 0, 0);
+  write_large ("swapped", 0, 1);
+  set_entry (&e[0], "", 0, plural_header, sizeof plural_header - 1);
+  set_entry (&e[1], plural_msgid, sizeof plural_msgid - 1, plural_forms,
+	     sizeof plural_forms - 1);
+  catalog_path (path, sizeof path, "arabic");
+  write_mo (path, e, 2, 1, 0);
+  free_entries (e, 2);
+
+  for (d = 0; d < NLARGE; d++)
+    bindtextdomain (large_domains[d], dir);
+  bindtextdomain ("arabic", dir);
+
+  bench ();
+
+  for (d = 0; d < NLARGE; d++)
+    {
+      catalog_path (path, sizeof path, large_domains[d]);
+      unlink (path);
+    }
+  catalog_path (path, sizeof path, "arabic");
+  unlink (path);
+  snprintf (path, sizeof path, "%s/xx/LC_MESSAGES", dir);
+  rmdir (path);
+  snprintf (path, sizeof path, "%s/xx", dir);
+  rmdir (path);
+  rmdir (dir);
+  return 0;
+}
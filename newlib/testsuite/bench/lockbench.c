@@ -0,0 +1,276 @@
+/* Benchmark of the synchronization objects of linuxthreads, see README.  */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+static int max_threads = 32;
+static double seconds = 0.5;
+
+/* Each object on a cache line of its own.  */
+union sync_object
+{
+  pthread_mutex_t m;
+  pthread_cond_t c;
+  pthread_rwlock_t rw;
+  sem_t s;
+  char pad[64];
+} __attribute__ ((aligned (64)));
+
+struct bench
+{
+  union sync_object mutex, rmutex, cond1, cond2, rwlock, sem1, sem2;
+  volatile int stop;
+  int items;
+  long shared[8];
+};
+
+struct worker
+{
+  struct bench *b;
+  int id;
+  long ops;
+  pthread_t thread;
+} __attribute__ ((aligned (64)));
+
+/* A short critical section on one mutex.  */
+static void *
+bench_mutex (void *arg)
+{
+  struct worker *w = arg;
+  struct bench *b = w->b;
+
+  while (!b->stop)
+    {
+      pthread_mutex_lock (&b->mutex.m);
+      b->shared[0]++;
+      pthread_mutex_unlock (&b->mutex.m);
+      w->ops++;
+    }
+  return NULL;
+}
+
+/* The same on a recursive mutex taken twice, as stdio takes the lock of
+   a stream under flockfile.  */
+static void *
+bench_rmutex (void *arg)
+{
+  struct worker *w = arg;
+  struct bench *b = w->b;
+
+  while (!b->stop)
+    {
+      pthread_mutex_lock (&b->rmutex.m);
+      pthread_mutex_lock (&b->rmutex.m);
+      b->shared[0]++;
+      pthread_mutex_unlock (&b->rmutex.m);
+      pthread_mutex_unlock (&b->rmutex.m);
+      w->ops++;
+    }
+  return NULL;
+}
+
+/* Half the threads produce into a queue of at most 16 items, the other
+   half consume from it.  */
+static void *
+bench_cond (void *arg)
+{
+  struct worker *w = arg;
+  struct bench *b = w->b;
+  int produce = w->id % 2 == 0;
+
+  while (!b->stop)
+    {
+      pthread_mutex_lock (&b->mutex.m);
+      if (produce)
+	{
+	  while (b->items == 16 && !b->stop)
+	    pthread_cond_wait (&b->cond1.c, &b->mutex.m);
+	  b->items++;
+	  pthread_cond_signal (&b->cond2.c);
+	}
+      else
+	{
+	  while (b->items == 0 && !b->stop)
+	    pthread_cond_wait (&b->cond2.c, &b->mutex.m);
+	  b->items--;
+	  pthread_cond_signal (&b->cond1.c);
+	}
+      pthread_mutex_unlock (&b->mutex.m);
+      w->ops++;
+    }
+  return NULL;
+}
+
+/* Mostly readers, one operation in 16 writes.  */
+static void *
+bench_rwlock (void *arg)
+{
+  struct worker *w = arg;
+  struct bench *b = w->b;
+  volatile long sum;
+  int i;
+
+  while (!b->stop)
+    {
+      if ((w->ops & 15) == 0)
+	{
+	  pthread_rwlock_wrlock (&b->rwlock.rw);
+	  b->shared[0]++;
+	  pthread_rwlock_unlock (&b->rwlock.rw);
+	}
+      else
+	{
+	  pthread_rwlock_rdlock (&b->rwlock.rw);
+	  for (sum = 0, i = 0; i < 8; i++)
+	    sum += b->shared[i];
+	  pthread_rwlock_unlock (&b->rwlock.rw);
+	}
+      w->ops++;
+    }
+  return NULL;
+}
+
+/* Threads hand a token on through a ring of two semaphores: even ones
+   wait on the first and post the second, odd ones the other way.  */
+static void *
+bench_sem (void *arg)
+{
+  struct worker *w = arg;
+  struct bench *b = w->b;
+  sem_t *from = w->id % 2 ? &b->sem2.s : &b->sem1.s;
+  sem_t *to = w->id % 2 ? &b->sem1.s : &b->sem2.s;
+
+  while (!b->stop)
+    {
+      sem_wait (from);
+      sem_post (to);
+      w->ops++;
+    }
+  return NULL;
+}
+
+/* Run FN in NTHREADS threads for the configured time and return the
+   operations per second.  */
+static double
+run_bench (void *(*fn) (void *), int nthreads)
+{
+  struct bench *b;
+  struct worker *w;
+  pthread_mutexattr_t attr;
+  struct timespec ts;
+  double start, t;
+  long total = 0;
+  int i;
+
+  if (posix_memalign ((void **) &b, 64, sizeof *b) != 0
+      || posix_memalign ((void **) &w, 64, nthreads * sizeof *w) != 0)
+    {
+      perror ("posix_memalign");
+      exit (1);
+    }
+  memset (b, 0, sizeof *b);
+  memset (w, 0, nthreads * sizeof *w);
+  pthread_mutex_init (&b->mutex.m, NULL);
+  pthread_mutexattr_init (&attr);
+  pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init (&b->rmutex.m, &attr);
+  pthread_cond_init (&b->cond1.c, NULL);
+  pthread_cond_init (&b->cond2.c, NULL);
+  pthread_rwlock_init (&b->rwlock.rw, NULL);
+  sem_init (&b->sem1.s, 0, nthreads);
+  sem_init (&b->sem2.s, 0, 0);
+
+  start = bench_now ();
+  for (i = 0; i < nthreads; i++)
+    {
+      w[i].b = b;
+      w[i].id = i;
+      if (pthread_create (&w[i].thread, NULL, fn, &w[i]) != 0)
+	{
+	  perror ("pthread_create");
+	  exit (1);
+	}
+    }
+  ts.tv_sec = (time_t) seconds;
+  ts.tv_nsec = (long) ((seconds - ts.tv_sec) * 1e9);
+  nanosleep (&ts, NULL);
+  b->stop = 1;
+
+  /* Let blocked threads see the stop flag.  */
+  for (i = 0; i < nthreads; i++)
+    {
+      pthread_mutex_lock (&b->mutex.m);
+      b->items = 8;
+      pthread_mutex_unlock (&b->mutex.m);
+      pthread_cond_signal (&b->cond1.c);
+      pthread_cond_signal (&b->cond2.c);
+      sem_post (&b->sem1.s);
+      sem_post (&b->sem2.s);
+    }
+  for (i = 0; i < nthreads; i++)
+    {
+      pthread_join (w[i].thread, NULL);
+      total += w[i].ops;
+    }
+  t = bench_now () - start;
+  pthread_mutex_destroy (&b->mutex.m);
+  pthread_mutex_destroy (&b->rmutex.m);
+  pthread_cond_destroy (&b->cond1.c);
+  pthread_cond_destroy (&b->cond2.c);
+  pthread_rwlock_destroy (&b->rwlock.rw);
+  sem_destroy (&b->sem1.s);
+  sem_destroy (&b->sem2.s);
+  free (w);
+  free (b);
+  return total / t;
+}
+
+int
+main (int argc, char **argv)
+{
+  static const struct
+  {
+    const char *name;
+    void *(*fn) (void *);
+    int min_threads;
+  } workloads[] =
+    {
+      { "mutex", bench_mutex, 1 },
+      { "rmutex", bench_rmutex, 1 },
+      { "cond", bench_cond, 2 },
+      { "rwlock", bench_rwlock, 1 },
+      { "sem", bench_sem, 2 },
+    };
+  unsigned int i;
+  int c, n;
+
+  while ((c = getopt (argc, argv, "n:s:")) != -1)
+    switch (c)
+      {
+      case 'n': max_threads = atoi (optarg); break;
+      case 's': seconds = atof (optarg); break;
+      default:
+	fprintf (stderr, "usage: %s [-n max-threads] [-s seconds]\n",
+		 argv[0]);
+	return 2;
+      }
+
+  printf ("%-8s %7s %14s\n", "object", "threads", "ops/s");
+  for (i = 0; i < sizeof workloads / sizeof workloads[0]; i++)
+    for (n = workloads[i].min_threads; n <= max_threads; n *= 2)
+      {
+	printf ("%-8s %7d %14.0f\n", workloads[i].name, n,
+		run_bench (workloads[i].fn, n));
+	fflush (stdout);
+      }
+  return 0;
+}
@@ -0,0 +1,861 @@
+/* Accuracy and speed of the functions of libm, run on the host.
+
+   Each function of newlib's libm is called on random arguments spread
+   over a few intervals and on special arguments, and its result is
+   compared with the host's long double function on the same argument.
+   The error is measured in ulp of the result type.  Then the latency
+   (each call depending on the previous result) and the reciprocal
+   throughput (independent calls) are measured on the arguments of the
+   first interval.  See README for how it is built and how results of two
+   runs are compared; the special results C99 Annex G requires are checked
+   by newlib.math/complex.c.
+
+   The complex functions, and the multiplication and division which the
+   compiler calls __muldc3 and __divdc3 for, take random arguments with
+   both parts in the intervals.  Their error is that of the worse part in
+   ulp of the larger part of the result, since a small part can have a
+   large relative error in an accurate result.  */
+
+#define _GNU_SOURCE
+#include <complex.h>
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+
+#ifdef HOST_LIBM
+/* Measure the host libm itself, to check the harness.  */
+#define T(f) f
+#else
+/* The functions of newlib's libm have been renamed with an nl_ prefix
+   so that they do not clash with the host's.  */
+#define T(f) nl_##f
+/* newlib's libm sets errno through __errno, and lgamma keeps signgam
+   in the reentrancy structure, which only needs to be large enough.  */
+int *__errno (void) { return &errno; }
+static long long impure_data[1024];
+void *_impure_ptr = impure_data;
+#endif
+
+#define DFUNCS(X) \
+  X (exp) X (exp2) X (expm1) X (log) X (log2) X (log10) X (log1p) \
+  X (sin) X (cos) X (tan) X (asin) X (acos) X (atan) X (sinh) X (cosh) \
+  X (tanh) X (asinh) X (acosh) X (atanh) X (cbrt) X (sqrt) X (erf) \
+  X (erfc) X (lgamma) X (tgamma)
+#define DFUNCS2(X) X (pow) X (atan2) X (hypot)
+#define CFUNCS(X) \
+  X (cexp) X (clog) X (csqrt) X (csin) X (ccos) X (ctan) X (csinh) \
+  X (ccosh) X (ctanh)
+#define CFUNCS2(X) X (cpow)
+
+#ifndef HOST_LIBM
+#define DECL_D(fn) double nl_##fn (double); float nl_##fn##f (float);
+#define DECL_D2(fn) \
+  double nl_##fn (double, double); float nl_##fn##f (float, float);
+#define DECL_C(fn) \
+  double complex nl_##fn (double complex); \
+  float complex nl_##fn##f (float complex);
+#define DECL_C2(fn) \
+  double complex nl_##fn (double complex, double complex); \
+  float complex nl_##fn##f (float complex, float complex);
+DFUNCS (DECL_D)
+DFUNCS2 (DECL_D2)
+CFUNCS (DECL_C)
+CFUNCS2 (DECL_C2)
+#endif
+
+/* From libgcc on the host.  */
+double complex T (__muldc3) (double, double, double, double);
+double complex T (__divdc3) (double, double, double, double);
+float complex T (__mulsc3) (float, float, float, float);
+float complex T (__divsc3) (float, float, float, float);
+
+static double complex
+muld (double complex a, double complex b)
+{
+  return T (__muldc3) (creal (a), cimag (a), creal (b), cimag (b));
+}
+
+static double complex
+divd (double complex a, double complex b)
+{
+  return T (__divdc3) (creal (a), cimag (a), creal (b), cimag (b));
+}
+
+static float complex
+mulf (float complex a, float complex b)
+{
+  return T (__mulsc3) (crealf (a), cimagf (a), crealf (b), cimagf (b));
+}
+
+static float complex
+divf (float complex a, float complex b)
+{
+  return T (__divsc3) (crealf (a), cimagf (a), crealf (b), cimagf (b));
+}
+
+/* The references, which the compiler computes with __mulxc3 and
+   __divxc3 of libgcc, with the infinities of Annex G.  */
+static long double complex
+mull (long double complex a, long double complex b)
+{
+  return a * b;
+}
+
+static long double complex
+divl (long double complex a, long double complex b)
+{
+  return a / b;
+}
+
+/* The complex kinds come last.  */
+enum kind { D1, D2, F1, F2, C1, C2, CF1, CF2 };
+
+/* Arguments are drawn from [LO, HI], and the second argument of two
+   argument functions from [LO2, HI2].  Both parts of complex arguments
+   are.  */
+struct range
+{
+  double lo, hi, lo2, hi2;
+};
+
+#define NRANGES 3
+
+struct func
+{
+  const char *name;
+  enum kind kind;
+  union
+  {
+    double (*d1) (double);
+    double (*d2) (double, double);
+    float (*f1) (float);
+    float (*f2) (float, float);
+    double complex (*c1) (double complex);
+    double complex (*c2) (double complex, double complex);
+    float complex (*cf1) (float complex);
+    float complex (*cf2) (float complex, float complex);
+  } f;
+  union
+  {
+    long double (*l1) (long double);
+    long double (*l2) (long double, long double);
+    long double complex (*lc1) (long double complex);
+    long double complex (*lc2) (long double complex, long double complex);
+  } ref;
+  /* The first range has typical arguments, which are also used for the
+     timing, so the results in it must be finite.  */
+  struct range r[NRANGES];
+};
+
+#define R(lo, hi) { lo, hi, 0, 0 }
+#define R2(lo, hi, lo2, hi2) { lo, hi, lo2, hi2 }
+#define FN_D1(fn, ...) \
+  { #fn, D1, { .d1 = T (fn) }, { .l1 = fn##l }, { __VA_ARGS__ } }
+#define FN_D2(fn, ...) \
+  { #fn, D2, { .d2 = T (fn) }, { .l2 = fn##l }, { __VA_ARGS__ } }
+#define FN_F1(fn, ...) \
+  { #fn "f", F1, { .f1 = T (fn##f) }, { .l1 = fn##l }, { __VA_ARGS__ } }
+#define FN_F2(fn, ...) \
+  { #fn "f", F2, { .f2 = T (fn##f) }, { .l2 = fn##l }, { __VA_ARGS__ } }
+#define FN_C1(fn, ...) \
+  { #fn, C1, { .c1 = T (fn) }, { .lc1 = fn##l }, { __VA_ARGS__ } }
+#define FN_C2(fn, ...) \
+  { #fn, C2, { .c2 = T (fn) }, { .lc2 = fn##l }, { __VA_ARGS__ } }
+#define FN_CF1(fn, ...) \
+  { #fn "f", CF1, { .cf1 = T (fn##f) }, { .lc1 = fn##l }, { __VA_ARGS__ } }
+#define FN_CF2(fn, ...) \
+  { #fn "f", CF2, { .cf2 = T (fn##f) }, { .lc2 = fn##l }, { __VA_ARGS__ } }
+
+static const struct func funcs[] =
+{
+  FN_D1 (exp, R (-9.9, 9.9), R (-745.2, 709.8)),
+  FN_D1 (exp2, R (-9.9, 9.9), R (-1075, 1024)),
+  FN_D1 (expm1, R (-9.9, 9.9), R (-40, 709.8)),
+  FN_D1 (log, R (0.01, 11.1), R (0x1p-1074, DBL_MAX)),
+  FN_D1 (log2, R (0.01, 11.1), R (0x1p-1074, DBL_MAX)),
+  FN_D1 (log10, R (0.01, 11.1), R (0x1p-1074, DBL_MAX)),
+  FN_D1 (log1p, R (-0.9, 10), R (-1, DBL_MAX)),
+  FN_D2 (pow, R2 (0.01, 11.1, -10, 10), R2 (0x1p-1074, DBL_MAX, -100, 100),
+	 R2 (0.99, 1.01, -1e6, 1e6)),
+  FN_D1 (sin, R (-3.1, 3.1), R (-1e6, 1e6), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (cos, R (-3.1, 3.1), R (-1e6, 1e6), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (tan, R (-3.1, 3.1), R (-1e6, 1e6), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (asin, R (-1, 1)),
+  FN_D1 (acos, R (-1, 1)),
+  FN_D1 (atan, R (-10, 10), R (-DBL_MAX, DBL_MAX)),
+  FN_D2 (atan2, R2 (-10, 10, -10, 10),
+	 R2 (-DBL_MAX, DBL_MAX, -DBL_MAX, DBL_MAX)),
+  FN_D1 (sinh, R (-10, 10), R (-711, 711)),
+  FN_D1 (cosh, R (-10, 10), R (-711, 711)),
+  FN_D1 (tanh, R (-10, 10), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (asinh, R (-10, 10), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (acosh, R (1, 10), R (1, DBL_MAX)),
+  FN_D1 (atanh, R (-0.9, 0.9), R (-1, 1)),
+  FN_D1 (cbrt, R (-10, 10), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (sqrt, R (0, 10), R (0, DBL_MAX)),
+  FN_D1 (erf, R (-6, 6), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (erfc, R (-6, 28), R (-DBL_MAX, DBL_MAX)),
+  FN_D1 (lgamma, R (0.1, 10), R (-100, 0), R (0, DBL_MAX)),
+  FN_D1 (tgamma, R (0.1, 10), R (-171, 171.7)),
+  FN_D2 (hypot, R2 (-10, 10, -10, 10),
+	 R2 (-DBL_MAX, DBL_MAX, -DBL_MAX, DBL_MAX)),
+
+  FN_F1 (exp, R (-9.9, 9.9), R (-104, 88.8)),
+  FN_F1 (exp2, R (-9.9, 9.9), R (-150, 128)),
+  FN_F1 (expm1, R (-9.9, 9.9), R (-20, 88.8)),
+  FN_F1 (log, R (0.01, 11.1), R (0x1p-149, FLT_MAX)),
+  FN_F1 (log2, R (0.01, 11.1), R (0x1p-149, FLT_MAX)),
+  FN_F1 (log10, R (0.01, 11.1), R (0x1p-149, FLT_MAX)),
+  FN_F1 (log1p, R (-0.9, 10), R (-1, FLT_MAX)),
+  FN_F2 (pow, R2 (0.01, 11.1, -10, 10), R2 (0x1p-149, FLT_MAX, -100, 100),
+	 R2 (0.99, 1.01, -1e4, 1e4)),
+  FN_F1 (sin, R (-3.1, 3.1), R (-1e6, 1e6), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (cos, R (-3.1, 3.1), R (-1e6, 1e6), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (tan, R (-3.1, 3.1), R (-1e6, 1e6), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (asin, R (-1, 1)),
+  FN_F1 (acos, R (-1, 1)),
+  FN_F1 (atan, R (-10, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_F2 (atan2, R2 (-10, 10, -10, 10),
+	 R2 (-FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX)),
+  FN_F1 (sinh, R (-10, 10), R (-90, 90)),
+  FN_F1 (cosh, R (-10, 10), R (-90, 90)),
+  FN_F1 (tanh, R (-10, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (asinh, R (-10, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (acosh, R (1, 10), R (1, FLT_MAX)),
+  FN_F1 (atanh, R (-0.9, 0.9), R (-1, 1)),
+  FN_F1 (cbrt, R (-10, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (sqrt, R (0, 10), R (0, FLT_MAX)),
+  FN_F1 (erf, R (-4, 4), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (erfc, R (-4, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_F1 (lgamma, R (0.1, 10), R (-40, 0), R (0, FLT_MAX)),
+  FN_F1 (tgamma, R (0.1, 10), R (-40, 35.1)),
+  FN_F2 (hypot, R2 (-10, 10, -10, 10),
+	 R2 (-FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX)),
+
+  FN_C1 (cexp, R (-9.9, 9.9), R (-745, 709), R (-1e6, 1e6)),
+  FN_C1 (clog, R (-10, 10), R (0.5, 2), R (-DBL_MAX, DBL_MAX)),
+  FN_C1 (csqrt, R (-10, 10), R (-DBL_MAX, DBL_MAX)),
+  FN_C2 (cpow, R2 (0.1, 10, -3, 3), R2 (-10, 10, -10, 10)),
+  FN_C1 (csin, R (-3.1, 3.1), R (-20, 20), R (-1e6, 1e6)),
+  FN_C1 (ccos, R (-3.1, 3.1), R (-20, 20), R (-1e6, 1e6)),
+  FN_C1 (ctan, R (-3.1, 3.1), R (-30, 30), R (-1e6, 1e6)),
+  FN_C1 (csinh, R (-3.1, 3.1), R (-20, 20), R (-1e6, 1e6)),
+  FN_C1 (ccosh, R (-3.1, 3.1), R (-20, 20), R (-1e6, 1e6)),
+  FN_C1 (ctanh, R (-3.1, 3.1), R (-30, 30), R (-1e6, 1e6)),
+  { "__muldc3", C2, { .c2 = muld }, { .lc2 = mull },
+    { R2 (-10, 10, -10, 10), R2 (-1e150, 1e150, -1e150, 1e150) } },
+  { "__divdc3", C2, { .c2 = divd }, { .lc2 = divl },
+    { R2 (-10, 10, -10, 10), R2 (-DBL_MAX, DBL_MAX, -DBL_MAX, DBL_MAX) } },
+
+  FN_CF1 (cexp, R (-9.9, 9.9), R (-104, 88), R (-1e4, 1e4)),
+  FN_CF1 (clog, R (-10, 10), R (0.5, 2), R (-FLT_MAX, FLT_MAX)),
+  FN_CF1 (csqrt, R (-10, 10), R (-FLT_MAX, FLT_MAX)),
+  FN_CF2 (cpow, R2 (0.1, 10, -3, 3), R2 (-10, 10, -10, 10)),
+  FN_CF1 (csin, R (-3.1, 3.1), R (-20, 20), R (-1e4, 1e4)),
+  FN_CF1 (ccos, R (-3.1, 3.1), R (-20, 20), R (-1e4, 1e4)),
+  FN_CF1 (ctan, R (-3.1, 3.1), R (-30, 30), R (-1e4, 1e4)),
+  FN_CF1 (csinh, R (-3.1, 3.1), R (-20, 20), R (-1e4, 1e4)),
+  FN_CF1 (ccosh, R (-3.1, 3.1), R (-20, 20), R (-1e4, 1e4)),
+  FN_CF1 (ctanh, R (-3.1, 3.1), R (-30, 30), R (-1e4, 1e4)),
+  { "__mulsc3", CF2, { .cf2 = mulf }, { .lc2 = mull },
+    { R2 (-10, 10, -10, 10), R2 (-1e19, 1e19, -1e19, 1e19) } },
+  { "__divsc3", CF2, { .cf2 = divf }, { .lc2 = divl },
+    { R2 (-10, 10, -10, 10), R2 (-FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX) } },
+};
+
+#define NFUNCS (sizeof (funcs) / sizeof (funcs[0]))
+
+/* Special arguments; all pairs of them are used for two argument
+   functions.  */
+static const double specials[] =
+{
+  0.0, -0.0, 0x1p-1074, -0x1p-1074, 0x1p-149, -0x1p-149, DBL_MIN, FLT_MIN,
+  0.5, -0.5, 1.0, -1.0, 2.0, -2.0, 3.0, -3.0, 0x1.921fb54442d18p0,
+  0x1.921fb6p0, 1e10, -1e10, 1e300, -1e300, FLT_MAX, -FLT_MAX, DBL_MAX,
+  -DBL_MAX, INFINITY, -INFINITY, NAN
+};
+
+#define NSPECIALS (sizeof (specials) / sizeof (specials[0]))
+
+/* Results of one function.  */
+struct result
+{
+  double ulp_max;
+  double ulp_sum;
+  long count;
+  double worst[4];
+  double edge_ulp_max;
+  int special_fail;
+  double lat_ns, thru_ns;
+};
+
+static uint64_t seed = 0x243f6a8885a308d3;
+
+static uint64_t
+rnd (void)
+{
+  /* xorshift64*.  */
+  seed ^= seed >> 12;
+  seed ^= seed << 25;
+  seed ^= seed >> 27;
+  return seed * 0x2545f4914f6cdd1d;
+}
+
+/* Map doubles onto integers in the same order, so that drawing integers
+   uniformly gives the same density of arguments in every binade.  */
+static int64_t
+d2ord (double x)
+{
+  int64_t i;
+
+  memcpy (&i, &x, sizeof (i));
+  return i < 0 ? INT64_MIN - i : i;
+}
+
+static double
+ord2d (int64_t o)
+{
+  double x;
+
+  if (o < 0)
+    o = INT64_MIN - o;
+  memcpy (&x, &o, sizeof (x));
+  return x;
+}
+
+static double
+sample (double lo, double hi)
+{
+  int64_t a = d2ord (lo), b = d2ord (hi);
+  uint64_t span = (uint64_t) b - (uint64_t) a;
+
+  if (span == UINT64_MAX)
+    return ord2d ((int64_t) rnd ());
+  return ord2d ((int64_t) ((uint64_t) a + rnd () % (span + 1)));
+}
+
+/* The same for float arguments, which would mostly be zero if they were
+   rounded from a sample of the doubles.  */
+static double
+samplef (double lo, double hi)
+{
+  float l = fmax (lo, -FLT_MAX), h = fmin (hi, FLT_MAX);
+  int32_t a, b;
+  uint32_t span;
+  float x;
+
+  memcpy (&a, &l, sizeof (a));
+  memcpy (&b, &h, sizeof (b));
+  a = a < 0 ? INT32_MIN - a : a;
+  b = b < 0 ? INT32_MIN - b : b;
+  span = (uint32_t) b - (uint32_t) a;
+  a = (int32_t) ((uint32_t) a + (uint32_t) (rnd () % ((uint64_t) span + 1)));
+  a = a < 0 ? INT32_MIN - a : a;
+  memcpy (&x, &a, sizeof (x));
+  return x;
+}
+
+/* Error of GOT in ulp of a result type with MANT bits of precision and
+   minimum normal exponent EMIN, compared with REF.  Returns -1 for a
+   wrong special result (nan, infinity or sign of zero).  */
+static double
+ulp_error (long double ref, long double got, int mant, int emin,
+	   long double max)
+{
+  int e;
+
+  if (isnan (ref) || isnan (got))
+    return isnan (ref) && isnan (got) ? 0 : -1;
+  if (isinf (got))
+    {
+      /* Overflow is right if the reference rounds to infinity.  */
+      if (fabsl (ref) > max && signbit (ref) == signbit (got))
+	return 0;
+      return -1;
+    }
+  if (isinf (ref))
+    return -1;
+  if (ref == 0 && got == 0)
+    return signbit (ref) == signbit (got) ? 0 : -1;
+  e = ilogbl (ref);
+  if (ref == 0 || e < emin)
+    e = emin;
+  return fabsl (got - ref) / ldexpl (1, e - (mant - 1));
+}
+
+/* The error of a complex result, in ulp of the larger part of REF, or -1
+   for a wrong special result of either part.  Next to a nan part the sign
+   of the other part is not specified by Annex G and is not checked.  */
+static double
+culp_error (long double complex ref, long double complex got, int mant,
+	    int emin, long double max)
+{
+  long double rr = creall (ref), ri = cimagl (ref);
+  long double gr = creall (got), gi = cimagl (got);
+  long double big = fmaxl (fabsl (rr), fabsl (ri));
+  double er, ei;
+  int e;
+
+  if (isnan (rr) && isnan (gr))
+    {
+      ri = fabsl (ri);
+      gi = fabsl (gi);
+    }
+  if (isnan (ri) && isnan (gi))
+    {
+      rr = fabsl (rr);
+      gr = fabsl (gr);
+    }
+  if (!isfinite (rr) || !isfinite (ri) || !isfinite (gr) || !isfinite (gi)
+      || big > max)
+    {
+      er = ulp_error (rr, gr, mant, emin, max);
+      ei = ulp_error (ri, gi, mant, emin, max);
+      return er < 0 || ei < 0 ? -1 : fmax (er, ei);
+    }
+  if ((rr == 0 && gr == 0 && signbit (rr) != signbit (gr))
+      || (ri == 0 && gi == 0 && signbit (ri) != signbit (gi)))
+    return -1;
+  e = big == 0 ? emin : ilogbl (big);
+  if (e < emin)
+    e = emin;
+  return fmaxl (fabsl (gr - rr), fabsl (gi - ri)) / ldexpl (1, e - (mant - 1));
+}
+
+static double
+check (const struct func *fn, const double *a)
+{
+  long double ref, got;
+  long double complex cref, cgot;
+  double complex z, w;
+  float complex zf, wf;
+  double x = a[0], y = a[1];
+
+  switch (fn->kind)
+    {
+    case C1:
+    case C2:
+      __real__ z = a[0];
+      __imag__ z = a[1];
+      __real__ w = a[2];
+      __imag__ w = a[3];
+      if (fn->kind == C1)
+	{
+	  cref = fn->ref.lc1 (z);
+	  cgot = fn->f.c1 (z);
+	}
+      else
+	{
+	  cref = fn->ref.lc2 (z, w);
+	  cgot = fn->f.c2 (z, w);
+	}
+      return culp_error (cref, cgot, DBL_MANT_DIG, DBL_MIN_EXP - 1, DBL_MAX);
+    case CF1:
+    case CF2:
+      __real__ zf = a[0];
+      __imag__ zf = a[1];
+      __real__ wf = a[2];
+      __imag__ wf = a[3];
+      if (fn->kind == CF1)
+	{
+	  cref = fn->ref.lc1 (zf);
+	  cgot = fn->f.cf1 (zf);
+	}
+      else
+	{
+	  cref = fn->ref.lc2 (zf, wf);
+	  cgot = fn->f.cf2 (zf, wf);
+	}
+      return culp_error (cref, cgot, FLT_MANT_DIG, FLT_MIN_EXP - 1, FLT_MAX);
+    case D1:
+      ref = fn->ref.l1 (x);
+      got = fn->f.d1 (x);
+      return ulp_error (ref, got, DBL_MANT_DIG, DBL_MIN_EXP - 1, DBL_MAX);
+    case D2:
+      ref = fn->ref.l2 (x, y);
+      got = fn->f.d2 (x, y);
+      return ulp_error (ref, got, DBL_MANT_DIG, DBL_MIN_EXP - 1, DBL_MAX);
+    case F1:
+      x = (float) x;
+      ref = fn->ref.l1 (x);
+      got = fn->f.f1 (x);
+      return ulp_error (ref, got, FLT_MANT_DIG, FLT_MIN_EXP - 1, FLT_MAX);
+    case F2:
+      x = (float) x;
+      y = (float) y;
+      ref = fn->ref.l2 (x, y);
+      got = fn->f.f2 (x, y);
+      return ulp_error (ref, got, FLT_MANT_DIG, FLT_MIN_EXP - 1, FLT_MAX);
+    }
+  return -1;
+}
+
+/* The number of double or float arguments, counting parts.  */
+static int
+nargs (const struct func *fn)
+{
+  switch (fn->kind)
+    {
+    case D1:
+    case F1:
+      return 1;
+    case C2:
+    case CF2:
+      return 4;
+    default:
+      return 2;
+    }
+}
+
+static int
+is_float (const struct func *fn)
+{
+  return fn->kind == F1 || fn->kind == F2 || fn->kind == CF1
+	 || fn->kind == CF2;
+}
+
+static void
+accuracy (const struct func *fn, long n, struct result *res)
+{
+  int na = nargs (fn), flt = is_float (fn);
+  int nr, r, m;
+  long i;
+  size_t j, k;
+  double a[4], err;
+
+  for (nr = 0; nr < NRANGES && fn->r[nr].lo != fn->r[nr].hi; nr++)
+    ;
+  for (r = 0; r < nr; r++)
+    for (i = 0; i < n / nr; i++)
+      {
+	const struct range *rg = &fn->r[r];
+
+	/* Both parts of a complex argument are in the same interval.  */
+	memset (a, 0, sizeof (a));
+	for (m = 0; m < na; m++)
+	  {
+	    int arg = fn->kind >= C1 ? m / 2 : m;
+
+	    if (flt)
+	      a[m] = arg ? samplef (rg->lo2, rg->hi2)
+			 : samplef (rg->lo, rg->hi);
+	    else
+	      a[m] = arg ? sample (rg->lo2, rg->hi2) : sample (rg->lo, rg->hi);
+	  }
+	err = check (fn, a);
+	if (err < 0)
+	  {
+	    res->special_fail++;
+	    continue;
+	  }
+	res->ulp_sum += err;
+	res->count++;
+	if (err > res->ulp_max)
+	  {
+	    res->ulp_max = err;
+	    memcpy (res->worst, a, sizeof (a));
+	  }
+      }
+
+  /* Pairs of special values, which for two complex arguments are the
+     parts of the first, and the other way round of the second.  */
+  for (j = 0; j < NSPECIALS; j++)
+    for (k = 0; k < (na > 1 ? NSPECIALS : 1); k++)
+      {
+	a[0] = a[3] = specials[j];
+	a[1] = a[2] = specials[k];
+	if (flt)
+	  for (m = 0; m < 4; m++)
+	    a[m] = (float) a[m];
+	err = check (fn, a);
+	if (err < 0)
+	  res->special_fail++;
+	else if (err > res->edge_ulp_max)
+	  res->edge_ulp_max = err;
+      }
+}
+
+#define NT 4096
+#define REPEAT 16
+#define TRIALS 8
+
+static double tx[NT], ty[NT], tout[NT];
+static float txf[NT], tyf[NT], toutf[NT];
+static double complex tz[NT], tw[NT], tzout[NT];
+static float complex tzf[NT], twf[NT], tzoutf[NT];
+
+/* Run LOOP REPEAT times over the NT arguments, TRIALS times, and return
+   the shortest time per call.  */
+#define TIME(best, loop)						\
+  do									\
+    {									\
+      int t_, r_;							\
+      for (t_ = 0; t_ < TRIALS; t_++)					\
+	{								\
+	  double t0_ = bench_now (), t1_;				\
+	  for (r_ = 0; r_ < REPEAT; r_++)				\
+	    loop;							\
+	  t1_ = (bench_now () - t0_) * 1e9 / (NT * REPEAT);		\
+	  if (t_ == 0 || t1_ < best)					\
+	    best = t1_;							\
+	}								\
+    }									\
+  while (0)
+
+static void
+speed (const struct func *fn, struct result *res)
+{
+  const struct range *rg = &fn->r[0];
+  double lat = 0, thru = 0;
+  volatile double sink;
+  double d = 0;
+  float f = 0;
+  double complex z = 0;
+  float complex zf = 0;
+  int i;
+
+  for (i = 0; i < NT; i++)
+    {
+      tx[i] = sample (rg->lo, rg->hi);
+      ty[i] = sample (rg->lo2, rg->hi2);
+      txf[i] = samplef (rg->lo, rg->hi);
+      tyf[i] = samplef (rg->lo2, rg->hi2);
+      __real__ tz[i] = tx[i];
+      __imag__ tz[i] = sample (rg->lo, rg->hi);
+      __real__ tw[i] = ty[i];
+      __imag__ tw[i] = sample (rg->lo2, rg->hi2);
+      __real__ tzf[i] = txf[i];
+      __imag__ tzf[i] = samplef (rg->lo, rg->hi);
+      __real__ twf[i] = tyf[i];
+      __imag__ twf[i] = samplef (rg->lo2, rg->hi2);
+    }
+
+  /* For the latency each argument depends on the previous result.  */
+  switch (fn->kind)
+    {
+    case D1:
+      TIME (lat, for (i = 0; i < NT; i++) d = fn->f.d1 (tx[i] + d * 0));
+      TIME (thru, for (i = 0; i < NT; i++) tout[i] = fn->f.d1 (tx[i]));
+      break;
+    case D2:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   d = fn->f.d2 (tx[i] + d * 0, ty[i]));
+      TIME (thru, for (i = 0; i < NT; i++)
+		    tout[i] = fn->f.d2 (tx[i], ty[i]));
+      break;
+    case F1:
+      TIME (lat, for (i = 0; i < NT; i++) f = fn->f.f1 (txf[i] + f * 0));
+      TIME (thru, for (i = 0; i < NT; i++) toutf[i] = fn->f.f1 (txf[i]));
+      break;
+    case F2:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   f = fn->f.f2 (txf[i] + f * 0, tyf[i]));
+      TIME (thru, for (i = 0; i < NT; i++)
+		    toutf[i] = fn->f.f2 (txf[i], tyf[i]));
+      break;
+    case C1:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   z = fn->f.c1 (tz[i] + creal (z) * 0));
+      TIME (thru, for (i = 0; i < NT; i++) tzout[i] = fn->f.c1 (tz[i]));
+      break;
+    case C2:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   z = fn->f.c2 (tz[i] + creal (z) * 0, tw[i]));
+      TIME (thru, for (i = 0; i < NT; i++)
+		    tzout[i] = fn->f.c2 (tz[i], tw[i]));
+      break;
+    case CF1:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   zf = fn->f.cf1 (tzf[i] + crealf (zf) * 0));
+      TIME (thru, for (i = 0; i < NT; i++)
+		    tzoutf[i] = fn->f.cf1 (tzf[i]));
+      break;
+    case CF2:
+      TIME (lat, for (i = 0; i < NT; i++)
+		   zf = fn->f.cf2 (tzf[i] + crealf (zf) * 0, twf[i]));
+      TIME (thru, for (i = 0; i < NT; i++)
+		    tzoutf[i] = fn->f.cf2 (tzf[i], twf[i]));
+      break;
+    }
+  sink = d + f + tout[0] + toutf[0] + creal (z) + crealf (zf)
+	 + creal (tzout[0]) + crealf (tzoutf[0]);
+  (void) sink;
+  res->lat_ns = lat;
+  res->thru_ns = thru;
+}
+
+/* One line per function: the name followed by pairs of key and value.  */
+static void
+print_result (const struct func *fn, const struct result *res)
+{
+  int i;
+
+  printf ("%s ulp_max %.4f ulp_mean %.4f worst %a", fn->name, res->ulp_max,
+	  res->count ? res->ulp_sum / res->count : 0.0, res->worst[0]);
+  for (i = 1; i < nargs (fn); i++)
+    printf (",%a", res->worst[i]);
+  printf (" edge_ulp_max %.4f special_fail %d", res->edge_ulp_max,
+	  res->special_fail);
+  if (res->lat_ns > 0)
+    printf (" lat_ns %.2f thru_ns %.2f", res->lat_ns, res->thru_ns);
+  putchar ('\n');
+}
+
+/* Comparison of the results of two runs.  */
+
+#define MAXLINES 256
+
+struct line
+{
+  char name[32];
+  double ulp_max, special_fail, lat_ns, thru_ns;
+};
+
+static int
+read_results (const char *file, struct line *lines)
+{
+  char buf[512], key[32], val[256];
+  FILE *fp = fopen (file, "r");
+  int n = 0, off, len;
+
+  if (fp == NULL)
+    {
+      perror (file);
+      exit (2);
+    }
+  while (n < MAXLINES && fgets (buf, sizeof (buf), fp) != NULL)
+    {
+      struct line *l = &lines[n];
+
+      memset (l, 0, sizeof (*l));
+      if (sscanf (buf, "%31s%n", l->name, &off) != 1 || l->name[0] == '#')
+	continue;
+      while (sscanf (buf + off, "%31s %255s%n", key, val, &len) == 2)
+	{
+	  off += len;
+	  if (strcmp (key, "ulp_max") == 0)
+	    l->ulp_max = strtod (val, NULL);
+	  else if (strcmp (key, "special_fail") == 0)
+	    l->special_fail = strtod (val, NULL);
+	  else if (strcmp (key, "lat_ns") == 0)
+	    l->lat_ns = strtod (val, NULL);
+	  else if (strcmp (key, "thru_ns") == 0)
+	    l->thru_ns = strtod (val, NULL);
+	}
+      n++;
+    }
+  fclose (fp);
+  return n;
+}
+
+/* Print the changes from the results in OLD to those in NEW and return
+   the number of regressions: a larger maximum error, more wrong special
+   results, or a time more than TOL percent longer.  */
+static int
+compare (const char *old, const char *new, double tol)
+{
+  static struct line a[MAXLINES], b[MAXLINES];
+  int na = read_results (old, a), nb = read_results (new, b);
+  int i, j, bad = 0;
+
+  printf ("%-10s %17s %17s %15s %15s\n", "function", "ulp_max",
+	  "special_fail", "lat_ns", "thru_ns");
+  for (j = 0; j < nb; j++)
+    for (i = 0; i < na; i++)
+      if (strcmp (a[i].name, b[j].name) == 0)
+	{
+	  const char *flag = "";
+
+	  if (b[j].ulp_max > a[i].ulp_max + 0.005
+	      || b[j].special_fail > a[i].special_fail
+	      || (a[i].lat_ns > 0
+		  && (b[j].lat_ns > a[i].lat_ns * (1 + tol / 100)
+		      || b[j].thru_ns > a[i].thru_ns * (1 + tol / 100))))
+	    {
+	      flag = "  REGRESSION";
+	      bad++;
+	    }
+	  printf ("%-10s %8.4f %8.4f %8g %8g %7.2f %7.2f %7.2f %7.2f%s\n",
+		  b[j].name, a[i].ulp_max, b[j].ulp_max, a[i].special_fail,
+		  b[j].special_fail, a[i].lat_ns, b[j].lat_ns, a[i].thru_ns,
+		  b[j].thru_ns, flag);
+	  break;
+	}
+  return bad;
+}
+
+static void
+usage (void)
+{
+  fprintf (stderr,
+	   "usage: mathbench [-a | -s] [-n samples] [function...]\n"
+	   "       mathbench -c [-t percent] old-results new-results\n"
+	   "  -a  only measure the accuracy\n"
+	   "  -s  only measure the speed\n"
+	   "  -n  random arguments per function (default 1000000)\n"
+	   "  -c  compare the results of two runs\n"
+	   "  -t  tolerated slowdown in percent for -c (default 5)\n");
+  exit (2);
+}
+
+int
+main (int argc, char **argv)
+{
+  int do_accuracy = 1, do_speed = 1, do_compare = 0;
+  double tol = 5;
+  long n = 1000000;
+  size_t i;
+  int a, j;
+
+  for (a = 1; a < argc && argv[a][0] == '-'; a++)
+    {
+      if (strcmp (argv[a], "-a") == 0)
+	do_speed = 0;
+      else if (strcmp (argv[a], "-s") == 0)
+	do_accuracy = 0;
+      else if (strcmp (argv[a], "-c") == 0)
+	do_compare = 1;
+      else if (strcmp (argv[a], "-n") == 0 && a + 1 < argc)
+	n = atol (argv[++a]);
+      else if (strcmp (argv[a], "-t") == 0 && a + 1 < argc)
+	tol = atof (argv[++a]);
+      else
+	usage ();
+    }
+
+  if (do_compare)
+    {
+      if (argc - a != 2)
+	usage ();
+      return compare (argv[a], argv[a + 1], tol) != 0;
+    }
+
+  for (i = 0; i < NFUNCS; i++)
+    {
+      struct result res;
+
+      if (a < argc)
+	{
+	  for (j = a; j < argc; j++)
+	    if (strcmp (argv[j], funcs[i].name) == 0)
+	      break;
+	  if (j == argc)
+	    continue;
+	}
+      memset (&res, 0, sizeof (res));
+      if (do_accuracy)
+	accuracy (&funcs[i], n, &res);
+      if (do_speed)
+	speed (&funcs[i], &res);
+      print_result (&funcs[i], &res);
+      fflush (stdout);
+    }
+  return 0;
+}
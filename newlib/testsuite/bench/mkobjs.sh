@@ -0,0 +1,57 @@
+#!/bin/sh
+# Generate and build the shared objects dlbench loads, see README.
+# Usage: mkobjs.sh DIR NOBJS NSYMS HASH CC
+#
+# Object I defines NSYMS functions with names the length of those of
+# C++ methods, and all of them dlbench::common(), with hash tables of
+# style HASH (gnu, sysv or both).  DIR/hit.so refers to all functions of
+# the NOBJS objects, DIR/miss.so weakly to a quarter as many that none
+# defines.  All have a build ID.
+
+dir=$1 nobjs=$2 nsyms=$3 hash=$4 cc=$5
+
+mkdir -p "$dir" || exit 1
+
+build () {
+  $cc -shared -fPIC -nostdlib -Wl,--hash-style=$hash -Wl,--build-id \
+    -o "$1.so" "$1.c" || exit 1
+}
+
+i=0
+while [ $i -lt "$nobjs" ]; do
+  n=$(printf '%04d' $i)
+  awk -v obj="$i" -v nsyms="$nsyms" 'BEGIN {
+    printf "int _ZN7dlbench6commonEv (void) { return %d; }\n", obj;
+    for (s = 0; s < nsyms; s++)
+      printf "int _ZN7dlbench3lib%04d9Component%05d6updateERKNS_7ContextE (void) { return %d; }\n", obj, s, s;
+  }' > "$dir/lib$n.c"
+  build "$dir/lib$n"
+  i=$((i + 1))
+done
+
+awk -v nobjs="$nobjs" -v nsyms="$nsyms" 'BEGIN {
+  printf "extern int _ZN7dlbench6commonEv (void);\n";
+  for (o = 0; o < nobjs; o++)
+    for (s = 0; s < nsyms; s++)
+      printf "extern int _ZN7dlbench3lib%04d9Component%05d6updateERKNS_7ContextE (void);\n", o, s;
+  printf "int (*const dlbench_refs[]) (void) = {\n  _ZN7dlbench6commonEv,\n";
+  for (o = 0; o < nobjs; o++)
+    for (s = 0; s < nsyms; s++)
+      printf "  _ZN7dlbench3lib%04d9Component%05d6updateERKNS_7ContextE,\n", o, s;
+  printf "};\n";
+}' > "$dir/hit.c"
+build "$dir/hit"
+
+awk -v nobjs="$nobjs" -v nsyms="$nsyms" 'BEGIN {
+  for (o = 0; o < nobjs; o++)
+    for (s = 0; s < nsyms / 4; s++)
+      printf "extern int _ZN7dlbench4miss%04d9Component%05d6updateERKNS_7ContextE (void) __attribute__ ((weak));\n", o, s;
+  printf "int (*const dlbench_refs[]) (void) = {\n";
+  for (o = 0; o < nobjs; o++)
+    for (s = 0; s < nsyms / 4; s++)
+      printf "  _ZN7dlbench4miss%04d9Component%05d6updateERKNS_7ContextE,\n", o, s;
+  printf "};\n";
+}' > "$dir/miss.c"
+build "$dir/miss"
+
+echo "$nobjs $nsyms" > "$dir/stamp"
@@ -0,0 +1,173 @@
+/* Benchmark of the POSIX message queues, see README.  */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <mqueue.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+#ifdef MQ_SHM
+/* Whether mq_open of the Linux port uses the kernel's queues, 0 having
+   it use the ones in shared memory.  */
+extern int __mq_native;
+#endif
+
+static mqd_t
+open_queue (const char *name, long size)
+{
+  struct mq_attr attr;
+  mqd_t mq;
+
+  memset (&attr, 0, sizeof (attr));
+  attr.mq_maxmsg = 8;
+  attr.mq_msgsize = size;
+  mq_unlink (name);
+  mq = mq_open (name, O_RDWR | O_CREAT | O_EXCL, 0600, &attr);
+  if (mq == (mqd_t) -1)
+    {
+      perror (name);
+      exit (1);
+    }
+  return mq;
+}
+
+/* Ping-pong between two processes over two queues, and a stream of
+   messages from one to the other.  Gives the round trip time in
+   microseconds and the messages per second.  */
+static void
+bench_mq (int count, size_t size, double *rtt, double *rate)
+{
+  char *buf = calloc (1, size);
+  mqd_t ping = open_queue ("/mqbench-ping", size);
+  mqd_t pong = open_queue ("/mqbench-pong", size);
+  pid_t pid;
+  double t;
+  int i;
+
+  pid = fork ();
+  if (pid == 0)
+    {
+      for (i = 0; i < count; i++)
+	{
+	  mq_receive (ping, buf, size, NULL);
+	  mq_send (pong, buf, size, 0);
+	}
+      for (i = 0; i < count; i++)
+	mq_receive (ping, buf, size, NULL);
+      mq_send (pong, buf, size, 0);
+      _exit (0);
+    }
+
+  t = bench_now ();
+  for (i = 0; i < count; i++)
+    {
+      mq_send (ping, buf, size, 0);
+      mq_receive (pong, buf, size, NULL);
+    }
+  *rtt = (bench_now () - t) / count * 1e6;
+
+  t = bench_now ();
+  for (i = 0; i < count; i++)
+    mq_send (ping, buf, size, 0);
+  mq_receive (pong, buf, size, NULL);
+  *rate = count / (bench_now () - t);
+
+  waitpid (pid, NULL, 0);
+  mq_close (ping);
+  mq_close (pong);
+  mq_unlink ("/mqbench-ping");
+  mq_unlink ("/mqbench-pong");
+  free (buf);
+}
+
+/* The same over a System V message queue, for reference: every mq_send
+   and mq_receive of the emulation the Linux port had before did as much
+   and more.  */
+static void
+bench_sysv (int count, size_t size, double *rtt, double *rate)
+{
+  struct { long type; char text[1]; } *msg = calloc (1, sizeof (long) + size);
+  int ping = msgget (IPC_PRIVATE, IPC_CREAT | 0600);
+  int pong = msgget (IPC_PRIVATE, IPC_CREAT | 0600);
+  pid_t pid;
+  double t;
+  int i;
+
+  msg->type = 1;
+  pid = fork ();
+  if (pid == 0)
+    {
+      for (i = 0; i < count; i++)
+	{
+	  msgrcv (ping, msg, size, 0, 0);
+	  msgsnd (pong, msg, size, 0);
+	}
+      for (i = 0; i < count; i++)
+	msgrcv (ping, msg, size, 0, 0);
+      msgsnd (pong, msg, size, 0);
+      _exit (0);
+    }
+
+  t = bench_now ();
+  for (i = 0; i < count; i++)
+    {
+      msgsnd (ping, msg, size, 0);
+      msgrcv (pong, msg, size, 0, 0);
+    }
+  *rtt = (bench_now () - t) / count * 1e6;
+
+  t = bench_now ();
+  for (i = 0; i < count; i++)
+    msgsnd (ping, msg, size, 0);
+  msgrcv (pong, msg, size, 0, 0);
+  *rate = count / (bench_now () - t);
+
+  waitpid (pid, NULL, 0);
+  msgctl (ping, IPC_RMID, NULL);
+  msgctl (pong, IPC_RMID, NULL);
+  free (msg);
+}
+
+int
+main (int argc, char **argv)
+{
+  static const size_t sizes[] = { 16, 256, 4096 };
+  double rtt, rate;
+  int count = 100000;
+  unsigned int i;
+  int c;
+
+  while ((c = getopt (argc, argv, "n:")) != -1)
+    switch (c)
+      {
+      case 'n': count = atoi (optarg); break;
+      default:
+	fprintf (stderr, "usage: %s [-n count]\n", argv[0]);
+	return 2;
+      }
+
+  printf ("%6s %-8s %10s %12s\n", "size", "queue", "rtt us", "msgs/s");
+  for (i = 0; i < sizeof sizes / sizeof sizes[0]; i++)
+    {
+      bench_mq (count, sizes[i], &rtt, &rate);
+      printf ("%6zu %-8s %10.2f %12.0f\n", sizes[i], "mq", rtt, rate);
+#ifdef MQ_SHM
+      __mq_native = 0;
+      bench_mq (count, sizes[i], &rtt, &rate);
+      printf ("%6zu %-8s %10.2f %12.0f\n", sizes[i], "mq shm", rtt, rate);
+      __mq_native = -1;
+#endif
+      bench_sysv (count, sizes[i], &rtt, &rate);
+      printf ("%6zu %-8s %10.2f %12.0f\n", sizes[i], "sysv", rtt, rate);
+      fflush (stdout);
+    }
+  return 0;
+}
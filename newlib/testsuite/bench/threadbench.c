@@ -0,0 +1,149 @@
+/* Benchmark of thread creation and join, see README.  */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+static int max_threads = 32;
+static double seconds = 0.5;
+static volatile int stop;
+
+struct spawner
+{
+  long pairs;
+  pthread_t thread;
+} __attribute__ ((aligned (64)));
+
+static void *
+return_arg (void *arg)
+{
+  return arg;
+}
+
+/* Create and join threads that return at once until told to stop.  */
+static void *
+spawner (void *arg)
+{
+  struct spawner *s = arg;
+  pthread_t t;
+  long n = 0;
+
+  while (!stop)
+    {
+      if (pthread_create (&t, NULL, return_arg, NULL) != 0
+	  || pthread_join (t, NULL) != 0)
+	break;
+      n++;
+    }
+  s->pairs = n;
+  return NULL;
+}
+
+/* The pairs per second of NTHREADS spawners.  */
+static double
+run_spawners (int nthreads)
+{
+  struct spawner *s;
+  struct timespec ts;
+  double start, elapsed;
+  long total = 0;
+  int i;
+
+  if (posix_memalign ((void **) &s, 64, nthreads * sizeof *s) != 0)
+    {
+      perror ("posix_memalign");
+      exit (1);
+    }
+  stop = 0;
+  start = bench_now ();
+  for (i = 0; i < nthreads; i++)
+    if (pthread_create (&s[i].thread, NULL, spawner, &s[i]) != 0)
+      {
+	perror ("pthread_create");
+	exit (1);
+      }
+  ts.tv_sec = (time_t) seconds;
+  ts.tv_nsec = (long) ((seconds - ts.tv_sec) * 1e9);
+  nanosleep (&ts, NULL);
+  stop = 1;
+  for (i = 0; i < nthreads; i++)
+    pthread_join (s[i].thread, NULL);
+  elapsed = bench_now () - start;
+  for (i = 0; i < nthreads; i++)
+    total += s[i].pairs;
+  free (s);
+  return total / elapsed;
+}
+
+/* The time of one create and join from the main thread, in
+   microseconds.  */
+static double
+latency (void)
+{
+  double start = bench_now (), elapsed;
+  long n = 0;
+  pthread_t t;
+  int i;
+
+  do
+    {
+      for (i = 0; i < 100; i++)
+	{
+	  pthread_create (&t, NULL, return_arg, NULL);
+	  pthread_join (t, NULL);
+	}
+      n += 100;
+    }
+  while ((elapsed = bench_now () - start) < seconds);
+  return elapsed / n * 1e6;
+}
+
+int
+main (int argc, char **argv)
+{
+#ifdef LOCKSTATS
+  struct pthread_lockstats ls;
+  double pairs;
+#endif
+  int c, n;
+
+  while ((c = getopt (argc, argv, "n:s:")) != -1)
+    switch (c)
+      {
+      case 'n': max_threads = atoi (optarg); break;
+      case 's': seconds = atof (optarg); break;
+      default:
+	fprintf (stderr, "usage: %s [-n max-threads] [-s seconds]\n",
+		 argv[0]);
+	return 2;
+      }
+
+  printf ("create+join latency %.2fus\n", latency ());
+  printf ("%8s %14s\n", "spawners", "pairs/s");
+  for (n = 1; n <= max_threads; n *= 2)
+    {
+      printf ("%8d %14.0f\n", n, run_spawners (n));
+      fflush (stdout);
+    }
+
+#ifdef LOCKSTATS
+  /* What the lock statistics of linuxthreads say of the spawners.  */
+  pthread_lockstats_reset_np ();
+  pthread_lockstats_enable_np (1);
+  pairs = run_spawners (4);
+  pthread_lockstats_enable_np (0);
+  pthread_lockstats_get_np (&ls);
+  printf ("lockstats of 4 spawners: %.0f pairs/s, %llu locks, %llu contended,"
+	  " %llu spun,\n  %.0fns waited and %.0fns held on average\n", pairs,
+	  ls.ls_locks, ls.ls_contended, ls.ls_spun,
+	  ls.ls_contended ? (double) ls.ls_wait_time / ls.ls_contended : 0.0,
+	  ls.ls_released ? (double) ls.ls_hold_time / ls.ls_released : 0.0);
+#endif
+  return 0;
+}
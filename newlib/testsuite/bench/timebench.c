@@ -0,0 +1,208 @@
+/* Benchmark of the time conversions, see README.  */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <wchar.h>
+#ifdef _POSIX_THREADS
+#include <pthread.h>
+#endif
+
+#include "bench.h"
+
+/* ns per conversion of times spread over 1970 to 2100 and over 1970
+   to 2300.  */
+static void
+bench_convert (void)
+{
+  static const char *const zones[] =
+  {
+    "UTC0", "AAA5BBB,M3.2.0,M11.1.0", "EEE-10FFF,M10.1.0,M4.1.0/3"
+  };
+  static const long long ends[] = { 4102444800LL, 10413792000LL };
+  enum { N = 1000000 };
+  struct tm tm;
+  volatile time_t sink;
+  double t0, res[2];
+  time_t step;
+  unsigned int z, e, i;
+
+  printf ("%-28s %5s %9s %9s\n", "ns per call", "to", "localtime",
+	  "mktime");
+  for (z = 0; z < sizeof zones / sizeof zones[0]; ++z)
+    for (e = 0; e < 2; ++e)
+      {
+	if ((time_t) ends[e] != ends[e])
+	  continue;
+	setenv ("TZ", zones[z], 1);
+	tzset ();
+	step = (time_t) (ends[e] / N);
+
+	t0 = bench_now ();
+	for (i = 0; i < N; ++i)
+	  {
+	    time_t t = i * step;
+	    localtime_r (&t, &tm);
+	  }
+	res[0] = bench_now () - t0;
+
+	t0 = bench_now ();
+	for (i = 0; i < N; ++i)
+	  {
+	    time_t t = i * step;
+	    gmtime_r (&t, &tm);
+	    tm.tm_isdst = -1;
+	    sink = mktime (&tm);
+	  }
+	res[1] = bench_now () - t0;
+
+	printf ("%-28s %5d %9.1f %9.1f\n", zones[z], e ? 2300 : 2100,
+		res[0] * 1e9 / N, res[1] * 1e9 / N);
+      }
+  (void) sink;
+}
+
+/* ns per strftime and wcsftime call in formats loggers use, for times
+   spread over 1970 to 2100.  */
+static void
+bench_strftime (void)
+{
+  static const char *const formats[] =
+  {
+    "%Y-%m-%dT%H:%M:%S", "[%d/%b/%Y:%H:%M:%S]", "%c", "%D %T",
+    "%j %U %V %W"
+  };
+  enum { N = 1000000 };
+  struct tm tm[64];
+  char buf[64];
+  wchar_t wbuf[64], wformat[64];
+  double t0, res[2];
+  unsigned int f, i;
+
+  for (i = 0; i < 64; ++i)
+    {
+      time_t t = (time_t) (i * (4102444800LL / 64) + i * 3607);
+      gmtime_r (&t, &tm[i]);
+    }
+  printf ("\n%-28s %9s %9s\n", "ns per call", "strftime", "wcsftime");
+  for (f = 0; f < sizeof formats / sizeof formats[0]; ++f)
+    {
+      mbstowcs (wformat, formats[f], 64);
+
+      t0 = bench_now ();
+      for (i = 0; i < N; ++i)
+	strftime (buf, sizeof buf, formats[f], &tm[i % 64]);
+      res[0] = bench_now () - t0;
+
+      t0 = bench_now ();
+      for (i = 0; i < N; ++i)
+	wcsftime (wbuf, 64, wformat, &tm[i % 64]);
+      res[1] = bench_now () - t0;
+
+      printf ("%-28s %9.1f %9.1f\n", formats[f], res[0] * 1e9 / N,
+	      res[1] * 1e9 / N);
+    }
+}
+
+/* ns per strptime call, for what strftime writes for times spread over
+   1970 to 2100.  */
+static void
+bench_strptime (void)
+{
+  static const char *const formats[] =
+  {
+    "%Y-%m-%dT%H:%M:%S", "[%d/%b/%Y:%H:%M:%S]", "%c", "%A, %d %B %Y %T"
+  };
+  enum { N = 1000000 };
+  char bufs[64][64];
+  struct tm tm;
+  double t0;
+  unsigned int f, i;
+
+  printf ("\n%-28s %9s\n", "ns per call", "strptime");
+  for (f = 0; f < sizeof formats / sizeof formats[0]; ++f)
+    {
+      for (i = 0; i < 64; ++i)
+	{
+	  time_t t = (time_t) (i * (4102444800LL / 64) + i * 3607);
+	  gmtime_r (&t, &tm);
+	  strftime (bufs[i], sizeof bufs[i], formats[f], &tm);
+	}
+
+      t0 = bench_now ();
+      for (i = 0; i < N; ++i)
+	strptime (bufs[i % 64], formats[f], &tm);
+      printf ("%-28s %9.1f\n", formats[f], (bench_now () - t0) * 1e9 / N);
+    }
+}
+
+#ifdef _POSIX_THREADS
+#define NTHREADS 8
+#define THREAD_CALLS 200000
+
+static void *
+bench_reader (void *arg)
+{
+  time_t step = (time_t) (4102444800LL / THREAD_CALLS);
+  struct tm tm;
+  unsigned int i;
+
+  for (i = 0; i < THREAD_CALLS; ++i)
+    {
+      time_t t = i * step + (unsigned long) arg;
+      localtime_r (&t, &tm);
+    }
+  return NULL;
+}
+
+/* ns per localtime_r, counted over all threads, when 1 to NTHREADS
+   threads convert at once: with a zone tzset keeps the changes of, and
+   with one whose names are too long for that, which takes the TZ lock.  */
+static void
+bench_threads (void)
+{
+  static const char *const zones[] =
+  {
+    "AAA5BBB,M3.2.0,M11.1.0",
+    "NNNNNNNNNN+06:00:00OOOOOOOOOO+05:00:00,M4.1.0/02:00:00,"
+    "M10.5.0/02:00:00"
+  };
+  pthread_t threads[NTHREADS];
+  unsigned long i, n;
+  unsigned int z;
+  double t0;
+
+  printf ("\n%-28s %9s %9s\n", "ns per localtime_r", "table", "lock");
+  for (n = 1; n <= NTHREADS; n *= 2)
+    {
+      printf ("%-25lu %s", n, n == 1 ? "thread " : "threads");
+      for (z = 0; z < 2; ++z)
+	{
+	  setenv ("TZ", zones[z], 1);
+	  tzset ();
+	  t0 = bench_now ();
+	  for (i = 0; i < n; ++i)
+	    pthread_create (&threads[i], NULL, bench_reader, (void *) i);
+	  for (i = 0; i < n; ++i)
+	    pthread_join (threads[i], NULL);
+	  printf (" %9.1f", (bench_now () - t0) * 1e9 / (THREAD_CALLS * n));
+	}
+      printf ("\n");
+    }
+}
+#endif
+
+int
+main (void)
+{
+  bench_convert ();
+  bench_strftime ();
+  bench_strptime ();
+#ifdef _POSIX_THREADS
+  bench_threads ();
+#endif
+  return 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * Check the asynchronous I/O of linuxthreads on a scratch file: reads and
+ * writes of adjacent blocks, which are merged, and in random order, short
+ * reads at the end of the file, aio_fsync, the 64-bit functions beyond
+ * 4 GiB, aio_suspend with a timeout and aio_cancel of queued and running
+ * requests on a pipe, SIGEV_SIGNAL and SIGEV_THREAD notification, and
+ * lio_listio in both modes.
+ */
+
+#define _GNU_SOURCE
+
+#include <aio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "check.h"
+
+static const char path[] = "aio.dat";
+
+/* The byte at OFFSET of the test pattern.  */
+static unsigned char
+pattern (off_t offset)
+{
+  return (unsigned char) ((offset >> 12) * 7 + offset * 13);
+}
+
+static void
+fill (unsigned char *buf, off_t offset, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    buf[i] = pattern (offset + i);
+}
+
+static int
+matches (const unsigned char *buf, off_t offset, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    if (buf[i] != pattern (offset + i))
+      return 0;
+  return 1;
+}
+
+/* Wait for CB with the engine and return its result.  */
+static ssize_t
+wait_one (struct aiocb *cb)
+{
+  const struct aiocb *list[1];
+
+  list[0] = cb;
+  while (aio_error (cb) == EINPROGRESS)
+    aio_suspend (list, 1, NULL);
+  return aio_return (cb);
+}
+
+static void
+init_cb (struct aiocb *cb, int fd, void *buf, size_t n, off_t offset)
+{
+  memset (cb, 0, sizeof (struct aiocb));
+  cb->aio_fildes = fd;
+  cb->aio_buf = buf;
+  cb->aio_nbytes = n;
+  cb->aio_offset = offset;
+  cb->aio_sigevent.sigev_notify = SIGEV_NONE;
+}
+
+#define NBLK 64
+#define BLK 4096
+
+/* Writes of adjacent blocks, which the engine merges, and reads in
+   random order.  */
+static void
+test_read_write (int fd)
+{
+  static unsigned char buf[NBLK][BLK];
+  struct aiocb cb[NBLK];
+  int i, j, t, order[NBLK];
+
+  for (i = 0; i < NBLK; i++)
+    {
+      fill (buf[i], (off_t) i * BLK, BLK);
+      init_cb (&cb[i], fd, buf[i], BLK, (off_t) i * BLK);
+      CHECK (aio_write (&cb[i]) == 0);
+    }
+  for (i = 0; i < NBLK; i++)
+    {
+      CHECK (wait_one (&cb[i]) == BLK);
+      CHECK (aio_error (&cb[i]) == 0);
+    }
+
+  for (i = 0; i < NBLK; i++)
+    order[i] = i;
+  for (i = NBLK - 1; i > 0; i--)
+    {
+      j = rand () % (i + 1);
+      t = order[i];
+      order[i] = order[j];
+      order[j] = t;
+    }
+  memset (buf, 0, sizeof (buf));
+  for (i = 0; i < NBLK; i++)
+    {
+      init_cb (&cb[i], fd, buf[i], BLK, (off_t) order[i] * BLK);
+      CHECK (aio_read (&cb[i]) == 0);
+    }
+  for (i = 0; i < NBLK; i++)
+    {
+      CHECK (wait_one (&cb[i]) == BLK);
+      CHECK (matches (buf[i], (off_t) order[i] * BLK, BLK));
+    }
+
+  /* Adjacent reads, the last two of which end beyond the end of file.  */
+  memset (buf, 0, sizeof (buf));
+  for (i = 0; i < 4; i++)
+    {
+      init_cb (&cb[i], fd, buf[i], BLK,
+	       (off_t) (NBLK - 2) * BLK + i * BLK - BLK / 2);
+      CHECK (aio_read (&cb[i]) == 0);
+    }
+  CHECK (wait_one (&cb[0]) == BLK);
+  CHECK (wait_one (&cb[1]) == BLK);
+  CHECK (wait_one (&cb[2]) == BLK / 2);
+  CHECK (wait_one (&cb[3]) == 0);
+  CHECK (matches (buf[0], (off_t) (NBLK - 2) * BLK - BLK / 2, BLK));
+  CHECK (matches (buf[2], (off_t) NBLK * BLK - BLK / 2, BLK / 2));
+}
+
+static void
+test_fsync (int fd)
+{
+  static unsigned char buf[BLK];
+  struct aiocb w, s;
+
+  fill (buf, 0, BLK);
+  init_cb (&w, fd, buf, BLK, 0);
+  init_cb (&s, fd, NULL, 0, 0);
+  CHECK (aio_write (&w) == 0);
+  CHECK (aio_fsync (O_SYNC, &s) == 0);
+  CHECK (wait_one (&s) == 0);
+  /* The write was queued first and is done before the fsync.  */
+  CHECK (aio_error (&w) == 0);
+  CHECK (aio_fsync (12345, &s) == -1 && errno == EINVAL);
+}
+
+static void
+test_64 (int fd)
+{
+  static unsigned char buf[BLK], back[BLK];
+  struct aiocb64 cb;
+  off64_t offset = ((off64_t) 5 << 30) + 123;
+
+  fill (buf, 77, BLK);
+  memset (&cb, 0, sizeof (cb));
+  cb.aio_fildes = fd;
+  cb.aio_buf = buf;
+  cb.aio_nbytes = BLK;
+  cb.aio_offset = offset;
+  CHECK (aio_write64 (&cb) == 0);
+  while (aio_error64 (&cb) == EINPROGRESS)
+    usleep (100);
+  CHECK (aio_return64 (&cb) == BLK);
+
+  cb.aio_buf = back;
+  CHECK (aio_read64 (&cb) == 0);
+  while (aio_error64 (&cb) == EINPROGRESS)
+    usleep (100);
+  CHECK (aio_return64 (&cb) == BLK);
+  CHECK (memcmp (buf, back, BLK) == 0);
+  CHECK (ftruncate (fd, (off_t) NBLK * BLK) == 0);
+}
+
+/* A read of an empty pipe blocks in the worker until the pipe is
+   written, the read queued behind it can still be canceled.  */
+static void
+test_pipe (void)
+{
+  char a[8], b[8];
+  struct aiocb ca, cbk;
+  const struct aiocb *list[1];
+  struct timespec ts = { 0, 50000000 };
+  int p[2];
+
+  CHECK (pipe (p) == 0);
+  init_cb (&ca, p[0], a, sizeof (a), 0);
+  init_cb (&cbk, p[0], b, sizeof (b), 0);
+  CHECK (aio_read (&ca) == 0);
+  CHECK (aio_read (&cbk) == 0);
+
+  list[0] = &ca;
+  CHECK (aio_suspend (list, 1, &ts) == -1 && errno == EAGAIN);
+
+  /* Give the worker time to start the first read.  */
+  usleep (20000);
+  CHECK (aio_cancel (p[0], &cbk) == AIO_CANCELED);
+  CHECK (aio_error (&cbk) == ECANCELED);
+  CHECK (aio_return (&cbk) == -1);
+  CHECK (aio_cancel (p[0], &ca) == AIO_NOTCANCELED);
+  CHECK (aio_cancel (p[0], NULL) == AIO_NOTCANCELED);
+
+  CHECK (write (p[1], "abcdefgh", 8) == 8);
+  CHECK (wait_one (&ca) == 8);
+  CHECK (memcmp (a, "abcdefgh", 8) == 0);
+  CHECK (aio_cancel (p[0], &ca) == AIO_ALLDONE);
+  CHECK (aio_cancel (p[0], NULL) == AIO_ALLDONE);
+  close (p[0]);
+  close (p[1]);
+  CHECK (aio_cancel (p[0], NULL) == -1 && errno == EBADF);
+}
+
+static volatile sig_atomic_t signal_value;
+static volatile int thread_value;
+static volatile int group_value;
+static pthread_mutex_t notify_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+handler (int sig, siginfo_t *info, void *ctx)
+{
+  signal_value = info->si_value.sival_int;
+}
+
+static void
+notify_thread (union sigval v)
+{
+  pthread_mutex_lock (&notify_lock);
+  thread_value = v.sival_int;
+  pthread_mutex_unlock (&notify_lock);
+}
+
+static void
+notify_group (union sigval v)
+{
+  pthread_mutex_lock (&notify_lock);
+  group_value = v.sival_int;
+  pthread_mutex_unlock (&notify_lock);
+}
+
+static int
+wait_for (volatile int *p, int value)
+{
+  int i;
+
+  for (i = 0; i < 2000; i++)
+    {
+      pthread_mutex_lock (&notify_lock);
+      if (*p == value)
+	{
+	  pthread_mutex_unlock (&notify_lock);
+	  return 1;
+	}
+      pthread_mutex_unlock (&notify_lock);
+      usleep (1000);
+    }
+  return 0;
+}
+
+static void
+test_notify (int fd)
+{
+  static unsigned char buf[NBLK][BLK];
+  struct aiocb cb[NBLK], *list[NBLK];
+  struct sigaction sa;
+  struct sigevent sev;
+  int i;
+
+  memset (&sa, 0, sizeof (sa));
+  sa.sa_sigaction = handler;
+  sa.sa_flags = SA_SIGINFO;
+  sigaction (SIGUSR1, &sa, NULL);
+
+  init_cb (&cb[0], fd, buf[0], BLK, 0);
+  cb[0].aio_sigevent.sigev_notify = SIGEV_SIGNAL;
+  cb[0].aio_sigevent.sigev_signo = SIGUSR1;
+  cb[0].aio_sigevent.sigev_value.sival_int = 42;
+  CHECK (aio_read (&cb[0]) == 0);
+  for (i = 0; i < 2000 && signal_value != 42; i++)
+    usleep (1000);
+  CHECK (signal_value == 42);
+  CHECK (aio_return (&cb[0]) == BLK);
+
+  init_cb (&cb[1], fd, buf[1], BLK, BLK);
+  cb[1].aio_sigevent.sigev_notify = SIGEV_THREAD;
+  cb[1].aio_sigevent.sigev_notify_function = notify_thread;
+  cb[1].aio_sigevent.sigev_value.sival_int = 43;
+  CHECK (aio_read (&cb[1]) == 0);
+  CHECK (wait_for (&thread_value, 43));
+
+  /* lio_listio waiting for all, with a NOP and a NULL entry.  */
+  memset (buf, 0, sizeof (buf));
+  for (i = 0; i < NBLK; i++)
+    {
+      init_cb (&cb[i], fd, buf[i], BLK, (off_t) i * BLK);
+      cb[i].aio_lio_opcode = i == 5 ? LIO_NOP : LIO_READ;
+      list[i] = i == 7 ? NULL : &cb[i];
+    }
+  CHECK (lio_listio (LIO_WAIT, list, NBLK, NULL) == 0);
+  for (i = 0; i < NBLK; i++)
+    if (i != 5 && i != 7)
+      {
+	CHECK (aio_error (&cb[i]) == 0);
+	CHECK (aio_return (&cb[i]) == BLK);
+	CHECK (matches (buf[i], (off_t) i * BLK, BLK));
+      }
+
+  /* lio_listio notifying once all are done.  */
+  memset (&sev, 0, sizeof (sev));
+  sev.sigev_notify = SIGEV_THREAD;
+  sev.sigev_notify_function = notify_group;
+  sev.sigev_value.sival_int = 44;
+  for (i = 0; i < NBLK; i++)
+    {
+      init_cb (&cb[i], fd, buf[i], BLK, (off_t) i * BLK);
+      cb[i].aio_lio_opcode = LIO_READ;
+      list[i] = &cb[i];
+    }
+  CHECK (lio_listio (LIO_NOWAIT, list, NBLK, &sev) == 0);
+  CHECK (wait_for (&group_value, 44));
+  for (i = 0; i < NBLK; i++)
+    CHECK (aio_error (&cb[i]) == 0);
+
+  /* An empty list notifies at once.  */
+  sev.sigev_value.sival_int = 45;
+  CHECK (lio_listio (LIO_NOWAIT, list, 0, &sev) == 0);
+  CHECK (wait_for (&group_value, 45));
+  CHECK (lio_listio (7, list, 0, NULL) == -1 && errno == EINVAL);
+}
+
+int
+main (void)
+{
+  int fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+  CHECK (fd >= 0);
+  test_read_write (fd);
+  test_fsync (fd);
+  test_64 (fd);
+  test_pipe ();
+  test_notify (fd);
+  close (fd);
+  unlink (path);
+  exit (0);
+}
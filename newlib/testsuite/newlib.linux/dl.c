@@ -0,0 +1,121 @@
+/*
+ * Check the symbol lookup of dlsym in shared objects with both hash
+ * tables, with the GNU one only and with the ELF one only, which
+ * linux.exp builds from dlobj.c: every symbol of each is found and is
+ * the function it names, the one all of them define is that of the
+ * object dlsym is given, and names that are not there are not found,
+ * among them one with the same GNU hash as one that is.
+ */
+
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "check.h"
+#include "dlobj.h"
+
+typedef int (*function) (void);
+
+/* The directory of this program, where the objects are.  */
+static char dir[PATH_MAX];
+
+static void
+find_dir (void)
+{
+  ssize_t n = readlink ("/proc/self/exe", dir, sizeof dir - 1);
+  char *slash;
+
+  CHECK (n > 0);
+  dir[n] = '\0';
+  slash = strrchr (dir, '/');
+  CHECK (slash != NULL);
+  *slash = '\0';
+}
+
+static void *
+open_object (const char *name, int mode)
+{
+  char path[PATH_MAX + 32];
+  void *h;
+
+  snprintf (path, sizeof path, "%s/%s", dir, name);
+  h = dlopen (path, mode);
+  if (h == NULL)
+    printf ("%s\n", dlerror ());
+  CHECK (h != NULL);
+  return h;
+}
+
+static void
+not_found (void *h, const char *name)
+{
+  dlerror ();
+  CHECK (dlsym (h, name) == NULL);
+  CHECK (dlerror () != NULL);
+}
+
+static void
+check_object (void *h, int obj)
+{
+  char name[64];
+  function f;
+  int s;
+
+  for (s = DLOBJ_FIRST; s <= DLOBJ_LAST; s++)
+    {
+      snprintf (name, sizeof name, "dltest_%d_%d", obj, s);
+      f = (function) dlsym (h, name);
+      CHECK (f != NULL);
+      CHECK (f () == obj * 100 + s);
+    }
+  f = (function) dlsym (h, "dltest_common");
+  CHECK (f != NULL && f () == obj);
+
+  snprintf (name, sizeof name, "dltest_%d_%d", obj, DLOBJ_LAST + 1);
+  not_found (h, name);
+  snprintf (name, sizeof name, "dltest_%d_%d", obj + 1, DLOBJ_FIRST);
+  not_found (h, name);
+  /* "0Q" hashes as "10" does: '1' * 33 + '0' == '0' * 33 + 'Q'.  */
+  snprintf (name, sizeof name, "dltest_%d_0Q", obj);
+  not_found (h, name);
+  not_found (h, "dltest_");
+  not_found (h, "");
+}
+
+int
+main (void)
+{
+  void *h[4], *gnu, *sysv;
+  char name[16];
+  int i;
+
+  find_dir ();
+
+  for (i = 0; i < 4; i++)
+    {
+      snprintf (name, sizeof name, "dlobj%d.so", i);
+      h[i] = open_object (name, RTLD_NOW);
+    }
+  gnu = open_object ("dlgnu.so", RTLD_NOW);
+  sysv = open_object ("dlsysv.so", RTLD_LAZY);
+  for (i = 0; i < 4; i++)
+    check_object (h[i], i);
+  check_object (gnu, 8);
+  check_object (sysv, 9);
+
+  /* Closed and opened again.  */
+  CHECK (dlclose (gnu) == 0);
+  gnu = open_object ("dlgnu.so", RTLD_NOW);
+  check_object (gnu, 8);
+
+  CHECK (dlclose (gnu) == 0);
+  CHECK (dlclose (sysv) == 0);
+  for (i = 0; i < 4; i++)
+    CHECK (dlclose (h[i]) == 0);
+
+  CHECK (dlopen ("/nonexistent/dlobj0.so", RTLD_NOW) == NULL);
+  CHECK (dlerror () != NULL);
+  exit (0);
+}
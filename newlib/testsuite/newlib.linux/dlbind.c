@@ -0,0 +1,207 @@
+/*
+ * Check the cache of bindings that LD_BIND_CACHE names.  This program
+ * runs itself with LD_BIND_CACHE set to a new directory and with
+ * LD_DEBUG=statistics, whose report at exit says how many bindings came
+ * from the cache.  Each run loads dlobj0.so to dlobj3.so in some order
+ * and then dluser.so, which refers to all their functions, and checks
+ * that every reference was bound to the first definition in that order.
+ * The first run must write the cache and the second take all bindings
+ * from it, and another order must not share them.  Files cut short or
+ * replaced by a symlink must be ignored and written afresh, without
+ * writing through the symlink.
+ */
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "check.h"
+#include "dlobj.h"
+
+typedef int (*function) (void);
+
+/* The references of dluser.so to the functions of the objects.  */
+#define NREFS (4 * (DLOBJ_LAST - DLOBJ_FIRST + 1) + 1)
+
+static char exe[PATH_MAX], dir[PATH_MAX];
+
+static void
+find_dir (void)
+{
+  ssize_t n = readlink ("/proc/self/exe", exe, sizeof exe - 1);
+  char *slash;
+
+  CHECK (n > 0);
+  exe[n] = '\0';
+  strcpy (dir, exe);
+  slash = strrchr (dir, '/');
+  CHECK (slash != NULL);
+  *slash = '\0';
+}
+
+static void *
+open_object (const char *name, int mode)
+{
+  char path[PATH_MAX + 32];
+  void *h;
+
+  snprintf (path, sizeof path, "%s/%s", dir, name);
+  h = dlopen (path, mode);
+  if (h == NULL)
+    printf ("%s\n", dlerror ());
+  CHECK (h != NULL);
+  return h;
+}
+
+/* A run: load the objects in ORDER, a string of their numbers, and
+   dluser.so, and check its references.  */
+static void
+run (const char *order)
+{
+  function const *user;
+  function sum;
+  char name[16];
+  void *h;
+  int i, o, s;
+
+  for (i = 0; i < 4; i++)
+    {
+      snprintf (name, sizeof name, "dlobj%c.so", order[i]);
+      open_object (name, RTLD_NOW | RTLD_GLOBAL);
+    }
+  h = open_object ("dluser.so", RTLD_LAZY);
+  user = (function const *) dlsym (h, "dltest_user");
+  sum = (function) dlsym (h, "dltest_user_sum");
+  CHECK (user != NULL && sum != NULL);
+
+  CHECK (user[0] () == order[0] - '0');
+  for (i = 1, o = 0; o < 4; o++)
+    for (s = DLOBJ_FIRST; s <= DLOBJ_LAST; s++, i++)
+      CHECK (user[i] () == o * 100 + s);
+  CHECK (sum () == order[0] - '0' + 10 + 369);
+}
+
+/* Run this program in ORDER with the cache in CACHE, and give the
+   number of bindings that came from it.  */
+static unsigned long
+run_child (const char *cache, const char *order)
+{
+  static const char key[] = "number of bindings from LD_BIND_CACHE:";
+  char report[8192], *p;
+  int fds[2], status;
+  size_t len = 0;
+  ssize_t n;
+  pid_t pid;
+
+  CHECK (pipe (fds) == 0);
+  pid = fork ();
+  CHECK (pid != -1);
+  if (pid == 0)
+    {
+      dup2 (fds[1], 2);
+      close (fds[0]);
+      close (fds[1]);
+      setenv ("LD_BIND_CACHE", cache, 1);
+      setenv ("LD_DEBUG", "statistics", 1);
+      execl (exe, exe, order, (char *) NULL);
+      _exit (127);
+    }
+  close (fds[1]);
+  while (len < sizeof report - 1
+	 && (n = read (fds[0], report + len, sizeof report - 1 - len)) > 0)
+    len += n;
+  report[len] = '\0';
+  close (fds[0]);
+  CHECK (waitpid (pid, &status, 0) == pid);
+  CHECK (WIFEXITED (status) && WEXITSTATUS (status) == 0);
+
+  p = strstr (report, key);
+  CHECK (p != NULL);
+  return strtoul (p + sizeof key - 1, NULL, 10);
+}
+
+/* Apply FN to the path of every file of the cache in CACHE.  */
+static void
+each_file (const char *cache, void (*fn) (const char *))
+{
+  char path[PATH_MAX];
+  struct dirent *d;
+  DIR *dp = opendir (cache);
+
+  CHECK (dp != NULL);
+  while ((d = readdir (dp)) != NULL)
+    if (d->d_name[0] != '.')
+      {
+	snprintf (path, sizeof path, "%s/%s", cache, d->d_name);
+	fn (path);
+      }
+  closedir (dp);
+}
+
+static void
+cut_short (const char *path)
+{
+  struct stat st;
+
+  CHECK (stat (path, &st) == 0);
+  CHECK (truncate (path, st.st_size / 2) == 0);
+}
+
+static char victim[PATH_MAX];
+
+static void
+symlink_to_victim (const char *path)
+{
+  CHECK (unlink (path) == 0);
+  CHECK (symlink (victim, path) == 0);
+}
+
+static void
+remove_file (const char *path)
+{
+  unlink (path);
+}
+
+int
+main (int argc, char **argv)
+{
+  char cache[] = "/tmp/dlbindXXXXXX";
+  struct stat st;
+  int fd;
+
+  find_dir ();
+  if (argc > 1)
+    {
+      run (argv[1]);
+      exit (0);
+    }
+
+  CHECK (mkdtemp (cache) != NULL);
+  CHECK (run_child (cache, "0123") == 0);
+  CHECK (run_child (cache, "0123") >= NREFS);
+  CHECK (run_child (cache, "3210") == 0);
+  CHECK (run_child (cache, "0123") >= NREFS);
+
+  each_file (cache, cut_short);
+  CHECK (run_child (cache, "0123") == 0);
+  CHECK (run_child (cache, "0123") >= NREFS);
+
+  snprintf (victim, sizeof victim, "%s.victim", cache);
+  fd = open (victim, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  CHECK (fd >= 0);
+  close (fd);
+  each_file (cache, symlink_to_victim);
+  CHECK (run_child (cache, "0123") == 0);
+  CHECK (stat (victim, &st) == 0 && st.st_size == 0);
+
+  unlink (victim);
+  each_file (cache, remove_file);
+  CHECK (rmdir (cache) == 0);
+  exit (0);
+}
@@ -0,0 +1,278 @@
+/*
+ * Check how dlopen maps shared objects, which dl_iterate_phdr tells:
+ * the program headers are those of the file, the segments hold what
+ * the file has, with zeros after it up to their ends, and have the
+ * protections their headers give, and the space between them is
+ * inaccessible anonymous memory.  The objects are some of those
+ * linux.exp builds and a copy of one with its program headers at the
+ * end of the file, where they have to be read separately.  Names that
+ * are not found in ld.so.cache are not found however often they are
+ * looked for.
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <link.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "check.h"
+
+/* The directory of this program, where the objects are.  */
+static char dir[PATH_MAX];
+
+static void
+find_dir (void)
+{
+  ssize_t n = readlink ("/proc/self/exe", dir, sizeof dir - 1);
+  char *slash;
+
+  CHECK (n > 0);
+  dir[n] = '\0';
+  slash = strrchr (dir, '/');
+  CHECK (slash != NULL);
+  *slash = '\0';
+}
+
+static void *
+open_path (const char *path, int mode)
+{
+  void *h = dlopen (path, mode);
+
+  if (h == NULL)
+    printf ("%s\n", dlerror ());
+  CHECK (h != NULL);
+  return h;
+}
+
+/* The contents of the file PATH, of *SIZEP bytes.  */
+static char *
+read_file (const char *path, size_t *sizep)
+{
+  struct stat st;
+  char *buf;
+  int fd;
+
+  fd = open (path, O_RDONLY);
+  CHECK (fd >= 0);
+  CHECK (fstat (fd, &st) == 0);
+  buf = malloc (st.st_size);
+  CHECK (buf != NULL);
+  CHECK (pread (fd, buf, st.st_size, 0) == st.st_size);
+  close (fd);
+  *sizep = st.st_size;
+  return buf;
+}
+
+/* What dl_iterate_phdr tells of the object one of whose segments has
+   ADDR.  */
+struct object
+{
+  ElfW(Addr) addr;
+  ElfW(Addr) base;
+  const ElfW(Phdr) *phdr;
+  int phnum;
+};
+
+static int
+find_object (struct dl_phdr_info *info, size_t size, void *data)
+{
+  struct object *obj = data;
+  int i;
+
+  for (i = 0; i < info->dlpi_phnum; i++)
+    if (info->dlpi_phdr[i].p_type == PT_LOAD
+	&& obj->addr >= info->dlpi_addr + info->dlpi_phdr[i].p_vaddr
+	&& obj->addr < (info->dlpi_addr + info->dlpi_phdr[i].p_vaddr
+			+ info->dlpi_phdr[i].p_memsz))
+      {
+	obj->base = info->dlpi_addr;
+	obj->phdr = info->dlpi_phdr;
+	obj->phnum = info->dlpi_phnum;
+	return 1;
+      }
+  return 0;
+}
+
+/* Whether the pages from START to END are within the segment PH of an
+   object at BASE.  */
+static int
+in_segment (unsigned long start, unsigned long end, ElfW(Addr) base,
+	    const ElfW(Phdr) *ph)
+{
+  unsigned long pagesize = getpagesize ();
+
+  return (start >= ((base + ph->p_vaddr) & ~(pagesize - 1))
+	  && end <= ((base + ph->p_vaddr + ph->p_memsz + pagesize - 1)
+		     & ~(pagesize - 1)));
+}
+
+/* Check the object that H is a handle of and SYMBOL is defined in,
+   loaded from PATH.  */
+static void
+check_object (void *h, const char *symbol, const char *path)
+{
+  struct object obj;
+  size_t size;
+  char *file = read_file (path, &size);
+  ElfW(Ehdr) *ehdr = (ElfW(Ehdr) *) file;
+  ElfW(Phdr) *phdr = (ElfW(Phdr) *) (file + ehdr->e_phoff);
+  const ElfW(Phdr) *relro = NULL;
+  unsigned long start, end, inode, map_start = -1UL, map_end = 0;
+  char line[512], perms[8];
+  const char *p, *seg_end;
+  int i, inseg;
+  FILE *maps;
+
+  memset (&obj, 0, sizeof obj);
+  obj.addr = (ElfW(Addr)) dlsym (h, symbol);
+  CHECK (obj.addr != 0);
+  CHECK (dl_iterate_phdr (find_object, &obj) == 1);
+
+  CHECK (obj.phnum == ehdr->e_phnum);
+  CHECK (memcmp (obj.phdr, phdr, obj.phnum * sizeof *phdr) == 0);
+
+  for (i = 0; i < ehdr->e_phnum; i++)
+    if (phdr[i].p_type == PT_GNU_RELRO)
+      relro = &phdr[i];
+    else if (phdr[i].p_type == PT_LOAD)
+      {
+	p = (const char *) obj.base + phdr[i].p_vaddr;
+	seg_end = p + phdr[i].p_memsz;
+	if (obj.base + phdr[i].p_vaddr < map_start)
+	  map_start = obj.base + phdr[i].p_vaddr;
+	if ((unsigned long) seg_end > map_end)
+	  map_end = (unsigned long) seg_end;
+	/* Relocation changes the writable ones.  */
+	if (!(phdr[i].p_flags & PF_W))
+	  {
+	    CHECK (memcmp (p, file + phdr[i].p_offset, phdr[i].p_filesz) == 0);
+	  }
+	for (p += phdr[i].p_filesz; p < seg_end && *p == 0; p++)
+	  ;
+	CHECK (p == seg_end);
+      }
+
+  maps = fopen ("/proc/self/maps", "r");
+  CHECK (maps != NULL);
+  while (fgets (line, sizeof line, maps) != NULL)
+    {
+      if (sscanf (line, "%lx-%lx %7s %*s %*s %lu", &start, &end, perms,
+		  &inode) != 4
+	  || end <= map_start || start >= map_end)
+	continue;
+      /* The kernel may have merged the first or the last mapping with
+	 one next to the object.  */
+      if (start < map_start)
+	start = map_start;
+      if (end > map_end)
+	end = map_end;
+      inseg = 0;
+      for (i = 0; i < ehdr->e_phnum; i++)
+	if (phdr[i].p_type == PT_LOAD
+	    && in_segment (start, end, obj.base, &phdr[i]))
+	  {
+	    inseg = 1;
+	    CHECK (perms[0] == (phdr[i].p_flags & PF_R ? 'r' : '-'));
+	    CHECK (perms[2] == (phdr[i].p_flags & PF_X ? 'x' : '-'));
+	    /* Other dynamic linkers make what PT_GNU_RELRO covers read
+	       only once it is relocated.  */
+	    if (relro == NULL || !in_segment (start, end, obj.base, relro)
+		|| perms[1] == 'w')
+	      {
+		CHECK (perms[1] == (phdr[i].p_flags & PF_W ? 'w' : '-'));
+	      }
+	  }
+      if (!inseg)
+	{
+	  CHECK (strcmp (perms, "---p") == 0 && inode == 0);
+	}
+    }
+  fclose (maps);
+  free (file);
+}
+
+/* Write a copy of the object FROM to TO with its program headers moved
+   to the end of the file, past what is read of it at first.  */
+static void
+move_phdrs (const char *from, const char *to)
+{
+  size_t size, phsize, off;
+  char *file = read_file (from, &size), *copy;
+  ElfW(Ehdr) *ehdr = (ElfW(Ehdr) *) file;
+  ElfW(Phdr) *phdr;
+  FILE *f;
+  int i;
+
+  phsize = ehdr->e_phnum * sizeof (ElfW(Phdr));
+  off = (size + 4095) & ~4095;
+  copy = calloc (off + phsize, 1);
+  CHECK (copy != NULL);
+  memcpy (copy, file, size);
+  memcpy (copy + off, file + ehdr->e_phoff, phsize);
+  ehdr = (ElfW(Ehdr) *) copy;
+  ehdr->e_phoff = off;
+  phdr = (ElfW(Phdr) *) (copy + off);
+  for (i = 0; i < ehdr->e_phnum; i++)
+    if (phdr[i].p_type == PT_PHDR)
+      phdr[i].p_type = PT_NULL;
+
+  f = fopen (to, "w");
+  CHECK (f != NULL);
+  CHECK (fwrite (copy, off + phsize, 1, f) == 1);
+  CHECK (fclose (f) == 0);
+  free (copy);
+  free (file);
+}
+
+int
+main (void)
+{
+  static const char *const objects[][2] =
+    {
+      { "dlobj0.so", "dltest_0_10" },
+      { "dlobj1.so", "dltest_1_10" },
+      { "dlobj2.so", "dltest_2_10" },
+      { "dlobj3.so", "dltest_3_10" },
+      { "dlgnu.so", "dltest_8_10" },
+      { "dlsysv.so", "dltest_9_10" },
+      { "dluser.so", "dltest_user" }
+    };
+  char path[PATH_MAX + 32], from[PATH_MAX + 32];
+  char tmp[] = "/tmp/dlloadXXXXXX";
+  void *h;
+  int i;
+
+  find_dir ();
+
+  /* dluser.so refers to the functions of dlobj0.so to dlobj3.so.  */
+  for (i = 0; i < 7; i++)
+    {
+      snprintf (path, sizeof path, "%s/%s", dir, objects[i][0]);
+      h = open_path (path, RTLD_NOW | RTLD_GLOBAL);
+      check_object (h, objects[i][1], path);
+    }
+
+  CHECK (mkdtemp (tmp) != NULL);
+  snprintf (from, sizeof from, "%s/dlgnu.so", dir);
+  snprintf (path, sizeof path, "%s/dlphdr.so", tmp);
+  move_phdrs (from, path);
+  h = open_path (path, RTLD_NOW | RTLD_LOCAL);
+  check_object (h, "dltest_8_10", path);
+  CHECK (dlsym (h, "dltest_8_69") != NULL);
+  CHECK (dlclose (h) == 0);
+  CHECK (unlink (path) == 0);
+  CHECK (rmdir (tmp) == 0);
+
+  for (i = 0; i < 3; i++)
+    {
+      CHECK (dlopen ("libdltest-missing.so.1", RTLD_NOW) == NULL);
+      CHECK (dlerror () != NULL);
+    }
+  exit (0);
+}
@@ -0,0 +1,18 @@
+/*
+ * A shared object for the dl tests, which linux.exp builds with OBJ set
+ * to its number: dltest_OBJ_S for S from DLOBJ_FIRST to DLOBJ_LAST
+ * returns OBJ * 100 + S, and dltest_common, which every object defines,
+ * returns OBJ.
+ */
+
+#include "dlobj.h"
+
+#define DEFINE(o, s) int dltest_##o##_##s (void) { return o * 100 + s; }
+
+EACH (DEFINE, OBJ)
+
+int
+dltest_common (void)
+{
+  return OBJ;
+}
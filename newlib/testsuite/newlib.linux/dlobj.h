@@ -0,0 +1,13 @@
+/* The functions of the shared objects the dl tests load, see dlobj.c.
+   EACH (F, O) is F (O, S) for every S from DLOBJ_FIRST to DLOBJ_LAST,
+   which F pastes into the names.  */
+
+#define DLOBJ_FIRST 10
+#define DLOBJ_LAST 69
+
+#define EACH10(f, o, t) \
+  f (o, t##0) f (o, t##1) f (o, t##2) f (o, t##3) f (o, t##4) \
+  f (o, t##5) f (o, t##6) f (o, t##7) f (o, t##8) f (o, t##9)
+#define EACH(f, o) \
+  EACH10 (f, o, 1) EACH10 (f, o, 2) EACH10 (f, o, 3) \
+  EACH10 (f, o, 4) EACH10 (f, o, 5) EACH10 (f, o, 6)
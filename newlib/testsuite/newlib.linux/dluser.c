@@ -0,0 +1,32 @@
+/*
+ * A shared object for the tests of the bind cache, which linux.exp
+ * builds and which refers to all the functions of dlobj0.so to
+ * dlobj3.so: dltest_user holds their addresses, dltest_common's first,
+ * and dltest_user_sum calls some of them through the PLT.
+ */
+
+#include "dlobj.h"
+
+#define DECLARE(o, s) extern int dltest_##o##_##s (void);
+#define ADDRESS(o, s) dltest_##o##_##s,
+
+extern int dltest_common (void);
+EACH (DECLARE, 0)
+EACH (DECLARE, 1)
+EACH (DECLARE, 2)
+EACH (DECLARE, 3)
+
+int (*const dltest_user[]) (void) =
+{
+  dltest_common,
+  EACH (ADDRESS, 0)
+  EACH (ADDRESS, 1)
+  EACH (ADDRESS, 2)
+  EACH (ADDRESS, 3)
+};
+
+int
+dltest_user_sum (void)
+{
+  return dltest_common () + dltest_0_10 () + dltest_3_69 ();
+}
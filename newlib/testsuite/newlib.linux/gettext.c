@@ -0,0 +1,485 @@
+/*
+ * Check the message lookup of gettext.  This program writes catalogs
+ * for the language "xx" into a new directory: three of 2000 messages,
+ * of which every third is not translated, one with a hash table as
+ * msgfmt writes it, one without and one without in the other byte
+ * order, and for each of a few plural rules, and for none, one with a
+ * single plural message.  Every message must translate, twice, in each
+ * of the three, and the others not; the same message must translate
+ * differently in another domain, another category, after textdomain and
+ * when another is put at the same address; and for n up to 10000 and a
+ * few large ones the plural forms must be those that the rule, written
+ * in C, selects.  8 threads then look up messages at random and must
+ * get their translations.
+ */
+
+#include <libintl.h>
+#include <limits.h>
+#include <locale.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "check.h"
+
+#define NSTRINGS 2000		/* Messages in the large catalogs.  */
+#define NTHREADS 8
+
+/* Writing catalogs.  */
+
+struct entry
+{
+  char *msgid;			/* With the plural after its NUL.  */
+  size_t msgid_len;		/* Up to the last NUL.  */
+  char *msgstr;
+  size_t msgstr_len;
+};
+
+static int
+entry_cmp (const void *p1, const void *p2)
+{
+  return strcmp (((const struct entry *) p1)->msgid,
+		 ((const struct entry *) p2)->msgid);
+}
+
+static uint32_t
+hashpjw (const char *str)
+{
+  uint32_t hval = 0, g;
+
+  while (*str != '\0')
+    {
+      hval <<= 4;
+      hval += (unsigned char) *str++;
+      g = hval & ((uint32_t) 0xf << 28);
+      if (g != 0)
+	{
+	  hval ^= g >> 24;
+	  hval ^= g;
+	}
+    }
+  return hval;
+}
+
+static uint32_t
+next_prime (uint32_t n)
+{
+  uint32_t d;
+
+  if (n < 3)
+    return 3;
+  n |= 1;
+  for (;;)
+    {
+      for (d = 3; d * d <= n && n % d != 0; d += 2)
+	;
+      if (d * d > n)
+	return n;
+      n += 2;
+    }
+}
+
+static void
+put32 (FILE *fp, uint32_t w, int swap)
+{
+  if (swap)
+    w = __builtin_bswap32 (w);
+  CHECK (fwrite (&w, 4, 1, fp) == 1);
+}
+
+/* Write the N entries at E as the catalog PATH, as msgfmt does with a
+   hash table if HASH, in the other byte order if SWAP.  */
+static void
+write_mo (const char *path, struct entry *e, size_t n, int hash, int swap)
+{
+  uint32_t hash_size = hash ? next_prime (n * 4 / 3) : 0;
+  uint32_t *hash_tab = calloc (hash_size + 1, 4);
+  uint32_t orig_off = 28, trans_off = orig_off + n * 8;
+  uint32_t hash_off = trans_off + n * 8;
+  uint32_t str_off = hash_off + hash_size * 4;
+  uint32_t h, idx, incr;
+  FILE *fp;
+  size_t i;
+
+  CHECK (hash_tab != NULL);
+  qsort (e, n, sizeof *e, entry_cmp);
+  for (i = 0; hash && i < n; i++)
+    {
+      h = hashpjw (e[i].msgid);
+      idx = h % hash_size;
+      incr = 1 + h % (hash_size - 2);
+      while (hash_tab[idx] != 0)
+	idx = idx >= hash_size - incr ? idx - (hash_size - incr) : idx + incr;
+      hash_tab[idx] = i + 1;
+    }
+
+  fp = fopen (path, "wb");
+  CHECK (fp != NULL);
+  put32 (fp, 0x950412de, swap);
+  put32 (fp, 0, swap);
+  put32 (fp, n, swap);
+  put32 (fp, orig_off, swap);
+  put32 (fp, trans_off, swap);
+  put32 (fp, hash_size, swap);
+  put32 (fp, hash_off, swap);
+  for (i = 0; i < n; i++)
+    {
+      put32 (fp, e[i].msgid_len, swap);
+      put32 (fp, str_off, swap);
+      str_off += e[i].msgid_len + 1;
+    }
+  for (i = 0; i < n; i++)
+    {
+      put32 (fp, e[i].msgstr_len, swap);
+      put32 (fp, str_off, swap);
+      str_off += e[i].msgstr_len + 1;
+    }
+  for (i = 0; i < hash_size; i++)
+    put32 (fp, hash_tab[i], swap);
+  for (i = 0; i < n; i++)
+    CHECK (fwrite (e[i].msgid, e[i].msgid_len + 1, 1, fp) == 1);
+  for (i = 0; i < n; i++)
+    CHECK (fwrite (e[i].msgstr, e[i].msgstr_len + 1, 1, fp) == 1);
+  CHECK (fclose (fp) == 0);
+  free (hash_tab);
+}
+
+static void
+set_entry (struct entry *e, const char *msgid, size_t msgid_len,
+	   const char *msgstr, size_t msgstr_len)
+{
+  e->msgid = malloc (msgid_len + 1);
+  e->msgstr = malloc (msgstr_len + 1);
+  CHECK (e->msgid != NULL && e->msgstr != NULL);
+  memcpy (e->msgid, msgid, msgid_len + 1);
+  e->msgid_len = msgid_len;
+  memcpy (e->msgstr, msgstr, msgstr_len + 1);
+  e->msgstr_len = msgstr_len;
+}
+
+static void
+free_entries (struct entry *e, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      free (e[i].msgid);
+      free (e[i].msgstr);
+    }
+}
+
+static char *msgids[NSTRINGS];
+
+static const char *
+msgid (int i)
+{
+  char buf[100];
+
+  if (msgids[i] == NULL)
+    {
+      snprintf (buf, sizeof buf, "message %05d: the file could not be "
+		"opened", i);
+      msgids[i] = strdup (buf);
+      CHECK (msgids[i] != NULL);
+    }
+  return msgids[i];
+}
+
+static void
+translation (char *buf, size_t size, const char *domain, int i)
+{
+  snprintf (buf, size, "[%s] Meldung %05d: die Datei konnte nicht "
+	    "ge\303\266ffnet werden", domain, i);
+}
+
+static char dir[] = "/tmp/gettextXXXXXX";
+
+static void
+catalog_path (char *path, size_t size, const char *domain)
+{
+  snprintf (path, size, "%s/xx/LC_MESSAGES/%s.mo", dir, domain);
+}
+
+/* The large catalog DOMAIN, with every third message not translated.  */
+static void
+write_large (const char *domain, int hash, int swap)
+{
+  static struct entry e[NSTRINGS + 1];
+  const char *header = "Content-Type: text/plain; charset=UTF-8\n";
+  char path[PATH_MAX], buf[200];
+  size_t n = 0;
+  int i;
+
+  set_entry (&e[n++], "", 0, header, strlen (header));
+  for (i = 0; i < NSTRINGS; i++)
+    if (i % 3 != 2)
+      {
+	translation (buf, sizeof buf, domain, i);
+	set_entry (&e[n++], msgid (i), strlen (msgid (i)), buf, strlen (buf));
+      }
+  catalog_path (path, sizeof path, domain);
+  write_mo (path, e, n, hash, swap);
+  free_entries (e, n);
+}
+
+/* The plural rules, with the same expression in C.  */
+
+static unsigned long int
+rule_germanic (unsigned long int n)
+{
+  return n != 1;
+}
+
+static unsigned long int
+rule_polish (unsigned long int n)
+{
+  return (n == 1 ? 0 : n % 10 >= 2 && n % 10 <= 4
+	  && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2);
+}
+
+static unsigned long int
+rule_russian (unsigned long int n)
+{
+  return (n % 10 == 1 && n % 100 != 11 ? 0
+	  : n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20)
+	  ? 1 : 2);
+}
+
+static unsigned long int
+rule_arabic (unsigned long int n)
+{
+  return (n == 0 ? 0 : n == 1 ? 1 : n == 2 ? 2
+	  : n % 100 >= 3 && n % 100 <= 10 ? 3 : n % 100 >= 11 ? 4 : 5);
+}
+
+static unsigned long int
+rule_arith (unsigned long int n)
+{
+  return (!(n / 3) ? 0 : (n * 2 - 1) % 7 > 3 || n + 1 <= 5 ? 1
+	  : n >= 100 && !(n - 100 < 7) ? 2 : 3);
+}
+
+static const struct rule
+{
+  const char *domain;
+  const char *header;
+  unsigned long int (*eval) (unsigned long int);
+  int nplurals;
+} rules[] =
+{
+  { "germanic", NULL, rule_germanic, 2 },
+  { "polish", "nplurals=3; plural=n==1 ? 0 : n%10>=2 && n%10<=4 && "
+    "(n%100<10 || n%100>=20) ? 1 : 2;", rule_polish, 3 },
+  { "russian", "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : n%10>=2 "
+    "&& n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);", rule_russian, 3 },
+  { "arabic", "nplurals=6; plural=n==0 ? 0 : n==1 ? 1 : n==2 ? 2 : "
+    "n%100>=3 && n%100<=10 ? 3 : n%100>=11 ? 4 : 5;", rule_arabic, 6 },
+  { "arith", "nplurals=4; plural=!(n/3) ? 0 : (n*2-1)%7 > 3 || n+1 <= 5 "
+    "? 1 : n >= 100 && !(n-100 < 7) ? 2 : 3;", rule_arith, 4 },
+};
+#define NRULES (sizeof rules / sizeof rules[0])
+
+static const char plural_msgid[] = "%lu file\0%lu files";
+
+static void
+write_plural (const struct rule *r)
+{
+  struct entry e[2];
+  char header[300], forms[200], path[PATH_MAX];
+  size_t len = 0;
+  int i;
+
+  snprintf (header, sizeof header,
+	    "Content-Type: text/plain; charset=UTF-8\n%s%s",
+	    r->header != NULL ? "Plural-Forms: " : "",
+	    r->header != NULL ? r->header : "");
+  set_entry (&e[0], "", 0, header, strlen (header));
+  for (i = 0; i < r->nplurals; i++)
+    len += sprintf (forms + len, "form %d", i) + 1;
+  set_entry (&e[1], plural_msgid, sizeof plural_msgid - 1, forms, len - 1);
+  catalog_path (path, sizeof path, r->domain);
+  write_mo (path, e, 2, 1, 0);
+  free_entries (e, 2);
+}
+
+/* Tests.  */
+
+static const char *large_domains[] = { "hashed", "nohash", "swapped" };
+#define NLARGE 3
+
+static int
+lookup_ok (const char *domain, const char *id, int i, int category)
+{
+  char expect[200];
+  const char *res = dcgettext (domain, id, category);
+
+  if (i % 3 == 2 || category != LC_MESSAGES)
+    return res == id;
+  translation (expect, sizeof expect, domain, i);
+  return strcmp (res, expect) == 0;
+}
+
+static void
+test_large (void)
+{
+  char buf[100], expect[200];
+  const char *domain;
+  int d, i;
+
+  for (d = 0; d < NLARGE; d++)
+    for (i = 0; i < NSTRINGS; i++)
+      {
+	CHECK (lookup_ok (large_domains[d], msgid (i), i, LC_MESSAGES));
+	/* Once more, now from what the first lookup keeps.  */
+	CHECK (lookup_ok (large_domains[d], msgid (i), i, LC_MESSAGES));
+      }
+
+  /* The same string again, but in another domain or category.  */
+  for (i = 0; i < 30; i++)
+    {
+      CHECK (lookup_ok ("hashed", msgid (i), i, LC_MESSAGES));
+      CHECK (lookup_ok ("nohash", msgid (i), i, LC_MESSAGES));
+      CHECK (lookup_ok ("nohash", msgid (i), i, LC_TIME));
+    }
+
+  /* Other strings at the same address.  */
+  for (i = 0; i < 30; i++)
+    {
+      strcpy (buf, msgid (i));
+      CHECK (lookup_ok ("hashed", buf, i, LC_MESSAGES));
+      strcpy (buf, msgid (i + 1));
+      CHECK (lookup_ok ("hashed", buf, i + 1, LC_MESSAGES));
+    }
+
+  /* The default domain changes.  */
+  for (i = 0; i < 30; i++)
+    {
+      domain = large_domains[i % NLARGE];
+      CHECK (textdomain (domain) != NULL);
+      translation (expect, sizeof expect, domain, i & 1);
+      CHECK (strcmp (gettext (msgid (i & 1)), expect) == 0);
+    }
+  textdomain ("");
+}
+
+static void
+test_plural (void)
+{
+  static const unsigned long int big[] =
+    { ULONG_MAX, ULONG_MAX - 1, LONG_MAX, 1000001, 1000011, 1000101 };
+  const char *msgid2 = plural_msgid + strlen (plural_msgid) + 1;
+  const char *res;
+  unsigned long int n, v;
+  unsigned int r;
+  char expect[20];
+
+  for (r = 0; r < NRULES; r++)
+    for (n = 0; n < 10000 + sizeof big / sizeof big[0]; n++)
+      {
+	v = n < 10000 ? n : big[n - 10000];
+	res = dcngettext (rules[r].domain, plural_msgid, msgid2, v,
+			  LC_MESSAGES);
+	snprintf (expect, sizeof expect, "form %lu", rules[r].eval (v));
+	if (strcmp (res, expect) != 0)
+	  printf ("%s: n = %lu gives \"%s\", not \"%s\"\n", rules[r].domain,
+		  v, res, expect);
+	CHECK (strcmp (res, expect) == 0);
+
+	/* Not translated, so English.  */
+	res = dcngettext (rules[r].domain, "no such file", "no such files", v,
+			  LC_MESSAGES);
+	CHECK (strcmp (res, v == 1 ? "no such file" : "no such files") == 0);
+      }
+}
+
+static void *
+thread_test (void *arg)
+{
+  unsigned int seed = (uintptr_t) arg;
+  const char *domain;
+  long int bad = 0;
+  int i, k;
+
+  for (k = 0; k < 50000; k++)
+    {
+      i = rand_r (&seed) % (k % 2 ? 10 : NSTRINGS);
+      domain = large_domains[rand_r (&seed) % NLARGE];
+      if (!lookup_ok (domain, msgid (i), i, LC_MESSAGES))
+	bad++;
+    }
+  return (void *) bad;
+}
+
+static void
+test_threads (void)
+{
+  pthread_t th[NTHREADS];
+  uintptr_t t;
+  void *bad;
+  int i;
+
+  /* The threads share the messages.  */
+  for (i = 0; i < NSTRINGS; i++)
+    msgid (i);
+  for (t = 0; t < NTHREADS; t++)
+    CHECK (pthread_create (&th[t], NULL, thread_test, (void *) (t + 1)) == 0);
+  for (t = 0; t < NTHREADS; t++)
+    {
+      CHECK (pthread_join (th[t], &bad) == 0);
+      CHECK (bad == NULL);
+    }
+}
+
+int
+main (void)
+{
+  char path[PATH_MAX];
+  unsigned int r;
+  int d;
+
+  /* The catalogs are those of LANGUAGE, which is not looked at in the C
+     locale.  */
+  CHECK (setlocale (LC_ALL, "C.UTF-8") != NULL);
+  CHECK (setenv ("LANGUAGE", "xx", 1) == 0);
+
+  CHECK (mkdtemp (dir) != NULL);
+  snprintf (path, sizeof path, "%s/xx", dir);
+  CHECK (mkdir (path, 0700) == 0);
+  snprintf (path, sizeof path, "%s/xx/LC_MESSAGES", dir);
+  CHECK (mkdir (path, 0700) == 0);
+  write_large ("hashed", 1, 0);
+  write_large ("nohash", 0, 0);
+  write_large ("swapped", 0, 1);
+  for (r = 0; r < NRULES; r++)
+    write_plural (&rules[r]);
+
+  for (d = 0; d < NLARGE; d++)
+    CHECK (bindtextdomain (large_domains[d], dir) != NULL);
+  for (r = 0; r < NRULES; r++)
+    CHECK (bindtextdomain (rules[r].domain, dir) != NULL);
+
+  test_large ();
+  test_plural ();
+  test_threads ();
+
+  for (d = 0; d < NLARGE; d++)
+    {
+      catalog_path (path, sizeof path, large_domains[d]);
+      unlink (path);
+    }
+  for (r = 0; r < NRULES; r++)
+    {
+      catalog_path (path, sizeof path, rules[r].domain);
+      unlink (path);
+    }
+  snprintf (path, sizeof path, "%s/xx/LC_MESSAGES", dir);
+  rmdir (path);
+  snprintf (path, sizeof path, "%s/xx", dir);
+  rmdir (path);
+  CHECK (rmdir (dir) == 0);
+  exit (0);
+}
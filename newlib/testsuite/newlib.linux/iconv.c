@@ -0,0 +1,419 @@
+/*
+ * Check the builtin conversions of iconv between UTF-8, UCS-4, UCS-2,
+ * ISO-8859-1 and WCHAR_T, the internal encoding.  For every pair,
+ * random text, some of it broken, with and without //IGNORE, must
+ * convert as it does through WCHAR_T with two descriptors and as it
+ * does when given a few bytes of input and room for a few bytes of
+ * output at a time, and valid text must convert to what encoding its
+ * characters gives.  The pairs without WCHAR_T take one step.
+ * ISO-8859-1 opens by its aliases, and iconv_open leaves the locale
+ * alone.
+ */
+
+#include <errno.h>
+#include <gconv.h>
+#include <iconv.h>
+#include <locale.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+enum { UTF8, UCS4, UCS2, LATIN1, INTERNAL, NKINDS };
+
+static const struct
+{
+  const char *name;
+  const char *label;
+  uint32_t max;			/* Largest character it can carry.  */
+} kinds[NKINDS] =
+{
+  { "UTF-8", "utf8", 0x7fffffff },
+  { "UCS-4", "ucs4", 0x7fffffff },
+  { "UCS-2", "ucs2", 0xffff },
+  { "ISO-8859-1", "latin1", 0xff },
+  { "WCHAR_T", "internal", 0x7fffffff }
+};
+
+#define MAXCHARS 20000
+#define BUFSIZE (MAXCHARS * 6 + 64)
+
+static uint32_t chars[MAXCHARS];
+static unsigned char inbuf[BUFSIZE], bufa[BUFSIZE], bufb[BUFSIZE];
+static unsigned char midbuf[MAXCHARS * 4 + 64];
+
+static void
+check (int ok, const char *what, int from, int to)
+{
+  if (!ok)
+    printf ("%s: %s to %s\n", what, kinds[from].label, kinds[to].label);
+  CHECK (ok);
+}
+
+/* A random character of at most MAX, mostly ASCII as in real text.
+   Unless ANY, only those Unicode assigns, without surrogates or tags.  */
+static uint32_t
+rand_char (uint32_t max, int any)
+{
+  int r = random () % 100;
+  uint32_t ch;
+
+  if (r < 55)
+    ch = 0x20 + random () % 0x5f;
+  else if (r < 60)
+    ch = random () % 0x80;
+  else if (r < 75)
+    ch = 0x80 + random () % 0x80;
+  else if (r < 85)
+    ch = 0x100 + random () % 0x700;
+  else if (r < 93)
+    ch = 0x800 + random () % 0xf800;
+  else if (r < 97)
+    ch = 0x10000 + random () % 0x100000;
+  else if (r < 98 && any)
+    ch = 0xe0000 + random () % 0x80;
+  else if (any)
+    ch = 0x110000 + random () % (0x80000000 - 0x110000);
+  else
+    ch = 0x20 + random () % 0x5f;
+
+  if (ch > max)
+    ch %= max + 1;
+  if (!any && ch >= 0xd800 && ch < 0xe000)
+    ch -= 0x800;
+  return ch;
+}
+
+/* Encode the N characters of CHARS in KIND into OUT.  */
+static size_t
+encode (int kind, size_t n, unsigned char *out)
+{
+  unsigned char *p = out;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      uint32_t ch = chars[i];
+
+      switch (kind)
+	{
+	case UTF8:
+	  if (ch < 0x80)
+	    *p++ = ch;
+	  else
+	    {
+	      int len, j;
+
+	      for (len = 2; len < 6; len++)
+		if ((ch & (~(uint32_t) 0 << (5 * len + 1))) == 0)
+		  break;
+	      p[0] = ~0xff >> len;
+	      for (j = len - 1; j > 0; j--, ch >>= 6)
+		p[j] = 0x80 | (ch & 0x3f);
+	      p[0] |= ch;
+	      p += len;
+	    }
+	  break;
+	case UCS4:
+	  *p++ = ch >> 24;
+	  *p++ = ch >> 16;
+	  *p++ = ch >> 8;
+	  *p++ = ch;
+	  break;
+	case UCS2:
+	  {
+	    uint16_t u = ch;
+
+	    memcpy (p, &u, 2);
+	    p += 2;
+	  }
+	  break;
+	case LATIN1:
+	  *p++ = ch;
+	  break;
+	case INTERNAL:
+	  memcpy (p, &ch, 4);
+	  p += 4;
+	  break;
+	}
+    }
+  return p - out;
+}
+
+/* Random characters in CHARS up to MAX, up to MAXCHARS of them but
+   mostly few, and with ANY also those Unicode does not assign.  */
+static size_t
+make_chars (uint32_t max, int any)
+{
+  size_t n = random () % 8 == 0 ? random () % MAXCHARS : random () % 64;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    chars[i] = rand_char (max, any);
+  return n;
+}
+
+/* Random text in INBUF in FROM, some of it broken.  */
+static size_t
+make_input (int from)
+{
+  size_t len = encode (from, make_chars (kinds[from].max, 1), inbuf);
+
+  if (len > 0 && random () % 3 == 0)
+    {
+      int k = 1 + random () % 3;
+
+      while (k-- > 0)
+	if (random () % 4 == 0)
+	  len -= random () % (len < 3 ? len : 3);
+	else
+	  inbuf[random () % len] = random ();
+    }
+  return len;
+}
+
+/* What one conversion did.  */
+struct result
+{
+  size_t outlen;
+  size_t consumed;
+  size_t ret;			/* Irreversible conversions.  */
+  int err;			/* 0, EILSEQ, EINVAL or E2BIG.  */
+};
+
+/* Whether A and B made the same output from the same input.  With
+   //IGNORE a call that skipped something can fail with EILSEQ at its
+   end, so not for how a call ends unless STRICT; nor, unless STRICT is
+   2, for how many characters were converted irreversibly, which only
+   the last step of several counts.  */
+static int
+same (const struct result *a, const unsigned char *outa,
+      const struct result *b, const unsigned char *outb, int strict)
+{
+  return (a->outlen == b->outlen && a->consumed == b->consumed
+	  && (strict < 1 || a->err == b->err)
+	  && (strict < 2 || a->ret == b->ret)
+	  && memcmp (outa, outb, a->outlen) == 0);
+}
+
+static size_t
+nsteps (iconv_t cd)
+{
+  return ((__gconv_t) cd)->__nsteps;
+}
+
+static void
+convert (iconv_t cd, const unsigned char *in, size_t len,
+	 unsigned char *out, size_t outsize, struct result *r)
+{
+  char *ip = (char *) in, *op = (char *) out;
+  size_t il = len, ol = outsize;
+
+  iconv (cd, NULL, NULL, NULL, NULL);
+  r->ret = iconv (cd, &ip, &il, &op, &ol);
+  r->err = r->ret == (size_t) -1 ? errno : 0;
+  if (r->err)
+    r->ret = 0;
+  r->consumed = len - il;
+  r->outlen = outsize - ol;
+}
+
+/* What the conversion through the internal encoding, by two
+   descriptors, does.  */
+static void
+convert_chain (iconv_t cd1, iconv_t cd2, const unsigned char *in,
+	       size_t len, unsigned char *out, struct result *r)
+{
+  struct result r1, r2;
+
+  convert (cd1, in, len, midbuf, sizeof midbuf, &r1);
+  convert (cd2, midbuf, r1.outlen, out, BUFSIZE, &r2);
+  if (r2.err && r2.consumed < r1.outlen)
+    {
+      /* Find where in the input the character begins which the second
+	 one stopped at.  */
+      struct result r3;
+
+      convert (cd1, in, len, midbuf, r2.consumed, &r3);
+      r->consumed = r3.consumed;
+      r->ret = 0;
+      r->err = r2.err;
+    }
+  else
+    {
+      r->consumed = r1.consumed;
+      r->ret = r1.err || r2.err ? 0 : r1.ret + r2.ret;
+      r->err = r1.err ? r1.err : r2.err;
+    }
+  r->outlen = r2.outlen;
+}
+
+/* Convert by pieces of input and output of a few bytes each.  */
+static void
+convert_pieces (iconv_t cd, const unsigned char *in, size_t len,
+		unsigned char *out, int ign, struct result *r)
+{
+  size_t pos = 0, outpos = 0;
+  int rounds = 0;
+
+  iconv (cd, NULL, NULL, NULL, NULL);
+  r->ret = 0;
+  r->err = 0;
+  while (pos < len && ++rounds < 100000)
+    {
+      size_t end = pos + 1 + random () % 17;
+      char *ip = (char *) in + pos, *op = (char *) out + outpos;
+      size_t il, ol = 1 + random () % 9, ret;
+
+      if (end > len)
+	end = len;
+      il = end - pos;
+      ret = iconv (cd, &ip, &il, &op, &ol);
+      pos = (unsigned char *) ip - in;
+      outpos = (unsigned char *) op - out;
+      if (ret != (size_t) -1)
+	r->ret += ret;
+      else if ((errno == EILSEQ && !ign) || (errno == EINVAL && end == len))
+	{
+	  r->err = errno;
+	  r->ret = 0;
+	  break;
+	}
+    }
+  r->consumed = pos;
+  r->outlen = outpos;
+}
+
+static iconv_t
+open_kinds (int to, const char *to_name, int from, const char *from_name,
+	    int ign)
+{
+  char name[64];
+  iconv_t cd;
+
+  snprintf (name, sizeof name, "%s%s", to_name, ign ? "//IGNORE" : "");
+  cd = iconv_open (name, from_name);
+  check (cd != (iconv_t) -1, "iconv_open", from, to);
+  return cd;
+}
+
+static void
+test_pair (int from, int to, int iters)
+{
+  iconv_t cd[2], cd1[2], cd2[2];
+  int chain = from != INTERNAL && to != INTERNAL;
+  uint32_t max;
+  int ign, i;
+
+  for (ign = 0; ign < 2; ign++)
+    {
+      cd[ign] = open_kinds (to, kinds[to].name, from, kinds[from].name, ign);
+      if (chain)
+	{
+	  cd1[ign] = open_kinds (INTERNAL, "WCHAR_T", from, kinds[from].name,
+				 ign);
+	  cd2[ign] = open_kinds (to, kinds[to].name, INTERNAL, "WCHAR_T",
+				 ign);
+	}
+    }
+  if (chain)
+    check (nsteps (cd[0]) == 1 && nsteps (cd[1]) == 1, "not in one step",
+	   from, to);
+  max = kinds[from].max < kinds[to].max ? kinds[from].max : kinds[to].max;
+
+  for (i = 0; i < iters; i++)
+    {
+      struct result ra, rb;
+      size_t len, n;
+
+      ign = random () % 2;
+      len = make_input (from);
+      convert (cd[ign], inbuf, len, bufa, BUFSIZE, &ra);
+
+      /* The same as through the internal encoding.  */
+      if (chain)
+	{
+	  convert_chain (cd1[ign], cd2[ign], inbuf, len, bufb, &rb);
+	  check (same (&ra, bufa, &rb, bufb, ign ? 0 : 2),
+		 ign ? "differs from two steps with //IGNORE"
+		 : "differs from two steps", from, to);
+	}
+
+      /* The same when converted a few bytes at a time.  */
+      convert_pieces (cd[ign], inbuf, len, bufb, ign, &rb);
+      check (same (&ra, bufa, &rb, bufb, ign ? 0 : 2),
+	     ign ? "differs by pieces with //IGNORE" : "differs by pieces",
+	     from, to);
+
+      /* Valid text converts to what its characters encode to.  */
+      n = make_chars (max, 0);
+      len = encode (from, n, inbuf);
+      rb.outlen = encode (to, n, bufb);
+      convert (cd[0], inbuf, len, bufa, BUFSIZE, &ra);
+      check (ra.err == 0 && ra.consumed == len && ra.outlen == rb.outlen
+	     && memcmp (bufa, bufb, ra.outlen) == 0, "converted wrongly",
+	     from, to);
+    }
+
+  for (ign = 0; ign < 2; ign++)
+    {
+      CHECK (iconv_close (cd[ign]) == 0);
+      if (chain)
+	{
+	  CHECK (iconv_close (cd1[ign]) == 0);
+	  CHECK (iconv_close (cd2[ign]) == 0);
+	}
+    }
+}
+
+/* iconv_open knows Latin-1 by its usual names and, whatever the
+   locale, leaves it alone.  */
+static void
+test_names (void)
+{
+  static const char *const latin1[] =
+  {
+    "ISO-8859-1", "iso-8859-1", "ISO_8859-1", "ISO8859-1", "LATIN1",
+    "latin1", "L1", "IBM819", "CP819", "csISOLatin1", "ISO-IR-100"
+  };
+  char before[256];
+  const char *after;
+  struct result r;
+  iconv_t cd;
+  size_t i;
+
+  for (i = 0; i < sizeof latin1 / sizeof latin1[0]; i++)
+    {
+      cd = iconv_open ("UTF-8", latin1[i]);
+      check (cd != (iconv_t) -1, "iconv_open by an alias", LATIN1, UTF8);
+      convert (cd, (const unsigned char *) "\xe9", 1, bufa, BUFSIZE, &r);
+      check (r.err == 0 && r.outlen == 2
+	     && memcmp (bufa, "\xc3\xa9", 2) == 0,
+	     "converted wrongly by an alias", LATIN1, UTF8);
+      iconv_close (cd);
+    }
+
+  if (setlocale (LC_ALL, "C.UTF-8") == NULL)
+    setlocale (LC_ALL, "");
+  snprintf (before, sizeof before, "%s", setlocale (LC_ALL, NULL));
+  iconv_close (iconv_open ("UCS-2", "UTF-8"));
+  iconv_close (iconv_open ("UCS-2//IGNORE", "UTF-8"));
+  iconv_close (iconv_open ("ucs-2//translit", "utf-8"));
+  after = setlocale (LC_ALL, NULL);
+  CHECK (strcmp (before, after) == 0);
+  setlocale (LC_ALL, "C");
+}
+
+int
+main (void)
+{
+  int from, to;
+
+  for (from = 0; from < NKINDS; from++)
+    for (to = 0; to < NKINDS; to++)
+      if (from != to)
+	test_pair (from, to, 500);
+  test_names ();
+  exit (0);
+}
@@ -0,0 +1,102 @@
+/*
+ * Check the lock statistics of linuxthreads: a mutex waited for and held
+ * shows in the counts and the times, as do the creations and joins of
+ * threads, whose counts stay after they are freed, nothing counts while
+ * they are not kept, and a reset clears them.  They are summed over all
+ * threads and include the internal locks of the library, so while they
+ * are kept only lower bounds are checked.
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int holding;
+
+static void
+msleep (long ms)
+{
+  struct timespec ts = { ms / 1000, (ms % 1000) * 1000000 };
+
+  nanosleep (&ts, NULL);
+}
+
+/* Hold the mutex for 40ms.  */
+static void *
+holder (void *arg)
+{
+  pthread_mutex_lock (&mutex);
+  holding = 1;
+  msleep (40);
+  pthread_mutex_unlock (&mutex);
+  return NULL;
+}
+
+static void *
+return_arg (void *arg)
+{
+  return arg;
+}
+
+int
+main (void)
+{
+  struct pthread_lockstats ls, ls2;
+  pthread_t t;
+  int i;
+
+  CHECK (pthread_lockstats_enable_np (1) == 0);
+  CHECK (pthread_lockstats_reset_np () == 0);
+
+  /* Waited for while the other thread has it, then held for 20ms.  */
+  CHECK (pthread_create (&t, NULL, holder, NULL) == 0);
+  while (!holding)
+    msleep (1);
+  CHECK (pthread_mutex_lock (&mutex) == 0);
+  msleep (20);
+  CHECK (pthread_mutex_unlock (&mutex) == 0);
+  CHECK (pthread_join (t, NULL) == 0);
+  CHECK (pthread_lockstats_get_np (&ls) == 0);
+  CHECK (ls.ls_locks >= 2 && ls.ls_contended >= 1);
+  CHECK (ls.ls_contended <= ls.ls_locks && ls.ls_spun <= ls.ls_contended);
+  CHECK (ls.ls_released >= 2);
+  CHECK (ls.ls_wait_time >= 10000000 && ls.ls_wait_time < 1000000000);
+  CHECK (ls.ls_hold_time >= 50000000 && ls.ls_hold_time < 1000000000);
+
+  CHECK (pthread_mutex_trylock (&mutex) == 0);
+  CHECK (pthread_mutex_unlock (&mutex) == 0);
+  CHECK (pthread_lockstats_get_np (&ls2) == 0);
+  CHECK (ls2.ls_locks > ls.ls_locks && ls2.ls_released > ls.ls_released);
+
+  /* Each creation and join takes the lock of the threads, and each
+     thread its own.  */
+  for (i = 0; i < 50; i++)
+    {
+      CHECK (pthread_create (&t, NULL, return_arg, NULL) == 0);
+      CHECK (pthread_join (t, NULL) == 0);
+    }
+  CHECK (pthread_lockstats_get_np (&ls) == 0);
+  CHECK (ls.ls_locks >= ls2.ls_locks + 50 * 2);
+
+  /* Nothing counts while they are not kept.  */
+  CHECK (pthread_lockstats_enable_np (0) == 0);
+  CHECK (pthread_lockstats_get_np (&ls) == 0);
+  CHECK (pthread_mutex_lock (&mutex) == 0);
+  CHECK (pthread_mutex_unlock (&mutex) == 0);
+  CHECK (pthread_lockstats_get_np (&ls2) == 0);
+  CHECK (memcmp (&ls, &ls2, sizeof ls) == 0);
+
+  CHECK (pthread_lockstats_reset_np () == 0);
+  CHECK (pthread_lockstats_get_np (&ls) == 0);
+  CHECK (ls.ls_locks == 0 && ls.ls_contended == 0 && ls.ls_spun == 0);
+  CHECK (ls.ls_wait_time == 0 && ls.ls_released == 0);
+  CHECK (ls.ls_hold_time == 0);
+
+  exit (0);
+}
@@ -0,0 +1,409 @@
+/*
+ * Check the POSIX message queues of the Linux port, once on the kernel's
+ * queues and once on the queues in shared memory files the port falls
+ * back to where the kernel has none: receiving by priority and in order
+ * within one, EMSGSIZE, EINVAL and EBADF, mq_timedsend and
+ * mq_timedreceive timing out, O_NONBLOCK per descriptor and mq_setattr,
+ * SIGEV_SIGNAL and SIGEV_THREAD notification with EBUSY and
+ * unregistration, four sending and four receiving threads on one queue,
+ * and a child process opening a queue by name and sending to it.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "check.h"
+
+/* Whether mq_open uses the kernel's queues, 0 having it use the ones in
+   shared memory, see mq_open.c.  */
+extern int __mq_native;
+
+/* The descriptors of the queues in shared memory have this bit.  */
+#define MQ_SHM_BIT 0x40000000
+
+static void
+abstime_in (struct timespec *ts, long ms)
+{
+  clock_gettime (CLOCK_REALTIME, ts);
+  ts->tv_sec += ms / 1000;
+  ts->tv_nsec += (ms % 1000) * 1000000;
+  if (ts->tv_nsec >= 1000000000)
+    {
+      ts->tv_nsec -= 1000000000;
+      ts->tv_sec++;
+    }
+}
+
+static double
+seconds_since (const struct timespec *start)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec - start->tv_sec + (ts.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static mqd_t
+open_queue (const char *name, int oflag, long maxmsg, long msgsize)
+{
+  struct mq_attr attr;
+  mqd_t mq;
+
+  memset (&attr, 0, sizeof (attr));
+  attr.mq_maxmsg = maxmsg;
+  attr.mq_msgsize = msgsize;
+  mq_unlink (name);
+  mq = mq_open (name, oflag | O_CREAT | O_EXCL, 0600, &attr);
+  CHECK (mq != (mqd_t) -1);
+  return mq;
+}
+
+static void
+test_order (int shm)
+{
+  static const unsigned int prios[] = { 1, 5, 3, 5, 0, 15, 3 };
+  static const char *const texts[] = { "a", "b", "c", "d", "e", "f", "g" };
+  static const char *const expect[] = { "f", "b", "d", "c", "g", "a", "e" };
+  static const unsigned int expect_prio[] = { 15, 5, 5, 3, 3, 1, 0 };
+  struct mq_attr attr;
+  char buf[64];
+  unsigned int prio;
+  mqd_t mq;
+  int i;
+
+  mq = open_queue ("/mqtest-order", O_RDWR, 8, 64);
+  if (shm)
+    {
+      CHECK ((mq & MQ_SHM_BIT) != 0);
+    }
+  CHECK (mq_getattr (mq, &attr) == 0);
+  CHECK (attr.mq_maxmsg == 8 && attr.mq_msgsize == 64);
+  CHECK (attr.mq_curmsgs == 0 && attr.mq_flags == 0);
+
+  for (i = 0; i < 7; i++)
+    CHECK (mq_send (mq, texts[i], 2, prios[i]) == 0);
+  CHECK (mq_getattr (mq, &attr) == 0 && attr.mq_curmsgs == 7);
+
+  /* Highest priority first, first in first out within one.  */
+  for (i = 0; i < 7; i++)
+    {
+      CHECK (mq_receive (mq, buf, sizeof (buf), &prio) == 2);
+      CHECK (strcmp (buf, expect[i]) == 0 && prio == expect_prio[i]);
+    }
+
+  /* Bad priority, sizes and access.  */
+  CHECK (mq_send (mq, "x", 1, MQ_PRIO_MAX) == -1 && errno == EINVAL);
+  memset (buf, 'x', sizeof (buf));
+  CHECK (mq_send (mq, buf, 65, 0) == -1 && errno == EMSGSIZE);
+  CHECK (mq_send (mq, buf, 64, 0) == 0);
+  CHECK (mq_receive (mq, buf, 63, NULL) == -1 && errno == EMSGSIZE);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 64);
+  CHECK (mq_send (mq, buf, 0, 0) == 0);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 0);
+
+  mq_close (mq);
+  mq = mq_open ("/mqtest-order", O_RDONLY);
+  CHECK (mq != (mqd_t) -1);
+  CHECK (mq_send (mq, "x", 1, 0) == -1 && errno == EBADF);
+  mq_close (mq);
+  CHECK (mq_send (mq, "x", 1, 0) == -1 && errno == EBADF);
+
+  CHECK (mq_unlink ("/mqtest-order") == 0);
+  CHECK (mq_open ("/mqtest-order", O_RDWR) == (mqd_t) -1 && errno == ENOENT);
+  mq = mq_open ("/mqtest-order", O_RDWR | O_CREAT, 0600, NULL);
+  CHECK (mq != (mqd_t) -1);
+  mq_close (mq);
+  CHECK (mq_unlink ("/mqtest-order") == 0);
+}
+
+static void
+test_blocking (void)
+{
+  struct mq_attr attr, oattr;
+  struct timespec ts, start;
+  char buf[64];
+  mqd_t mq, mq2;
+  int i;
+
+  mq = open_queue ("/mqtest-block", O_RDWR, 4, 64);
+
+  /* An empty queue times out, a full one too.  */
+  abstime_in (&ts, 50);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  CHECK (mq_timedreceive (mq, buf, 64, NULL, &ts) == -1
+	 && errno == ETIMEDOUT);
+  CHECK (seconds_since (&start) > 0.04);
+  for (i = 0; i < 4; i++)
+    CHECK (mq_send (mq, "x", 1, 0) == 0);
+  abstime_in (&ts, 20);
+  CHECK (mq_timedsend (mq, "x", 1, 0, &ts) == -1 && errno == ETIMEDOUT);
+  ts.tv_nsec = 1000000000;
+  CHECK (mq_timedsend (mq, "x", 1, 0, &ts) == -1 && errno == EINVAL);
+
+  /* O_NONBLOCK belongs to the descriptor.  */
+  mq2 = mq_open ("/mqtest-block", O_RDWR | O_NONBLOCK);
+  CHECK (mq2 != (mqd_t) -1);
+  CHECK (mq_send (mq2, "x", 1, 0) == -1 && errno == EAGAIN);
+  CHECK (mq_getattr (mq2, &attr) == 0);
+  CHECK (attr.mq_flags == O_NONBLOCK && attr.mq_curmsgs == 4);
+  CHECK (mq_getattr (mq, &attr) == 0 && attr.mq_flags == 0);
+  for (i = 0; i < 4; i++)
+    CHECK (mq_receive (mq2, buf, 64, NULL) == 1);
+  CHECK (mq_receive (mq2, buf, 64, NULL) == -1 && errno == EAGAIN);
+
+  attr.mq_flags = O_NONBLOCK;
+  CHECK (mq_setattr (mq, &attr, &oattr) == 0);
+  CHECK (oattr.mq_flags == 0 && oattr.mq_maxmsg == 4
+	 && oattr.mq_msgsize == 64);
+  CHECK (mq_receive (mq, buf, 64, NULL) == -1 && errno == EAGAIN);
+  attr.mq_flags = 0;
+  CHECK (mq_setattr (mq, &attr, NULL) == 0);
+
+  mq_close (mq2);
+  mq_close (mq);
+  mq_unlink ("/mqtest-block");
+}
+
+static sem_t notified;
+static union sigval notified_value;
+
+static void
+notify_function (union sigval value)
+{
+  notified_value = value;
+  sem_post (&notified);
+}
+
+static int
+wait_notified (void)
+{
+  struct timespec ts;
+
+  abstime_in (&ts, 2000);
+  return sem_timedwait (&notified, &ts);
+}
+
+static void
+test_notify (void)
+{
+  struct sigevent sev;
+  struct timespec ts = { 2, 0 };
+  struct timespec short_ts = { 0, 20000000 };
+  siginfo_t info;
+  sigset_t set;
+  char buf[64];
+  mqd_t mq;
+
+  mq = open_queue ("/mqtest-notify", O_RDWR, 4, 64);
+
+  /* A signal with its value, once.  */
+  sigemptyset (&set);
+  sigaddset (&set, SIGUSR1);
+  sigprocmask (SIG_BLOCK, &set, NULL);
+  memset (&sev, 0, sizeof (sev));
+  sev.sigev_notify = SIGEV_SIGNAL;
+  sev.sigev_signo = SIGUSR1;
+  sev.sigev_value.sival_int = 42;
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_notify (mq, &sev) == -1 && errno == EBUSY);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (sigtimedwait (&set, &info, &ts) == SIGUSR1);
+  CHECK (info.si_value.sival_int == 42);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (sigtimedwait (&set, &info, &short_ts) == -1);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+
+  /* Only on the arrival of a message in an empty queue.  */
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (sigtimedwait (&set, &info, &short_ts) == -1);
+  CHECK (mq_notify (mq, NULL) == 0);
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_notify (mq, NULL) == 0);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (sigtimedwait (&set, &info, &short_ts) == -1);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+  sigprocmask (SIG_UNBLOCK, &set, NULL);
+
+  /* A function in a thread of its own.  */
+  sem_init (&notified, 0, 0);
+  sev.sigev_notify = SIGEV_THREAD;
+  sev.sigev_notify_function = notify_function;
+  sev.sigev_notify_attributes = NULL;
+  sev.sigev_value.sival_int = 7;
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_notify (mq, &sev) == -1 && errno == EBUSY);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  CHECK (wait_notified () == 0 && notified_value.sival_int == 7);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+
+  /* And none after mq_notify (NULL).  */
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_notify (mq, NULL) == 0);
+  CHECK (mq_send (mq, "x", 1, 0) == 0);
+  usleep (20000);
+  CHECK (sem_trywait (&notified) == -1);
+  CHECK (mq_receive (mq, buf, 64, NULL) == 1);
+
+  /* mq_close takes the registration away.  */
+  CHECK (mq_notify (mq, &sev) == 0);
+  mq_close (mq);
+  mq = mq_open ("/mqtest-notify", O_RDWR);
+  CHECK (mq_notify (mq, &sev) == 0);
+  CHECK (mq_notify (mq, NULL) == 0);
+  mq_close (mq);
+  mq_unlink ("/mqtest-notify");
+  sem_destroy (&notified);
+}
+
+/* Messages carry their sender, a sequence number and their priority,
+   which the receivers check.  */
+#define STRESS_THREADS	4
+#define STRESS_MSGS	20000
+
+struct stress
+{
+  mqd_t mq;
+  unsigned int id;
+  long sum;
+  int bad;
+};
+
+static void *
+stress_sender (void *arg)
+{
+  struct stress *s = arg;
+  unsigned int msg[3];
+  int i;
+
+  for (i = 0; i < STRESS_MSGS; i++)
+    {
+      msg[0] = s->id;
+      msg[1] = i;
+      msg[2] = (i * 7 + s->id) % MQ_PRIO_MAX;
+      if (mq_send (s->mq, (char *) msg, sizeof (msg), msg[2]) != 0)
+	s->bad++;
+    }
+  return NULL;
+}
+
+static void *
+stress_receiver (void *arg)
+{
+  struct stress *s = arg;
+  unsigned int msg[16], prio;
+  int i;
+
+  for (i = 0; i < STRESS_MSGS; i++)
+    {
+      if (mq_receive (s->mq, (char *) msg, sizeof (msg), &prio)
+	  != 3 * sizeof (unsigned int) || prio != msg[2])
+	s->bad++;
+      s->sum += msg[1];
+    }
+  return NULL;
+}
+
+static void
+test_stress (void)
+{
+  struct stress senders[STRESS_THREADS], receivers[STRESS_THREADS];
+  pthread_t th[2 * STRESS_THREADS];
+  long sum = 0;
+  int i, bad = 0;
+  mqd_t mq;
+
+  mq = open_queue ("/mqtest-stress", O_RDWR, 8, 64);
+  memset (senders, 0, sizeof (senders));
+  memset (receivers, 0, sizeof (receivers));
+  for (i = 0; i < STRESS_THREADS; i++)
+    {
+      senders[i].mq = receivers[i].mq = mq;
+      senders[i].id = receivers[i].id = i;
+      CHECK (pthread_create (&th[i], NULL, stress_receiver,
+			     &receivers[i]) == 0);
+      CHECK (pthread_create (&th[STRESS_THREADS + i], NULL, stress_sender,
+			     &senders[i]) == 0);
+    }
+  for (i = 0; i < 2 * STRESS_THREADS; i++)
+    pthread_join (th[i], NULL);
+  for (i = 0; i < STRESS_THREADS; i++)
+    {
+      sum += receivers[i].sum;
+      bad += senders[i].bad + receivers[i].bad;
+    }
+  CHECK (bad == 0);
+  CHECK (sum == (long) STRESS_THREADS * STRESS_MSGS * (STRESS_MSGS - 1) / 2);
+
+  mq_close (mq);
+  mq_unlink ("/mqtest-stress");
+}
+
+/* Another process opens the queue by name and sends to it.  */
+static void
+test_fork (void)
+{
+  unsigned int prio;
+  char buf[64];
+  int i, status;
+  pid_t pid;
+  mqd_t mq, w;
+
+  mq = open_queue ("/mqtest-fork", O_RDONLY, 8, 64);
+  pid = fork ();
+  CHECK (pid != -1);
+  if (pid == 0)
+    {
+      w = mq_open ("/mqtest-fork", O_WRONLY);
+      for (i = 0; i < 10000; i++)
+	if (w == (mqd_t) -1 || mq_send (w, (char *) &i, sizeof (i), 3) != 0)
+	  _exit (1);
+      _exit (0);
+    }
+
+  for (i = 0; i < 10000; i++)
+    {
+      CHECK (mq_receive (mq, buf, sizeof (buf), &prio) == sizeof (i));
+      CHECK (memcmp (buf, &i, sizeof (i)) == 0 && prio == 3);
+    }
+  CHECK (waitpid (pid, &status, 0) == pid && status == 0);
+
+  mq_close (mq);
+  mq_unlink ("/mqtest-fork");
+}
+
+static void
+run_tests (int shm)
+{
+  test_order (shm);
+  test_blocking ();
+  test_notify ();
+  test_stress ();
+  test_fork ();
+}
+
+int
+main (void)
+{
+  /* The kernel's queues, or those in shared memory if it has none.  */
+  run_tests (0);
+  __mq_native = 0;
+  run_tests (1);
+  exit (0);
+}
@@ -0,0 +1,652 @@
+/*
+ * Check the mutexes, condition variables, read-write locks and semaphores
+ * of linuxthreads, which sleep on futexes: locking, trylock and timedlock
+ * of the four mutex kinds with the errors of the recursive and error
+ * checking ones, pthread_once, signal and broadcast with several waiters,
+ * timedwait, cancellation of a thread in pthread_cond_wait and sem_wait,
+ * a bounded queue, semaphore counting and time-outs, and the read-write
+ * locks of all three kinds, including readers held back for a waiting
+ * writer and let in when its timedwrlock gives up.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+/* The absolute time MS milliseconds from now, as the timed functions
+   take it.  */
+static struct timespec
+deadline (long ms)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_REALTIME, &ts);
+  ts.tv_sec += ms / 1000;
+  ts.tv_nsec += (ms % 1000) * 1000000;
+  if (ts.tv_nsec >= 1000000000)
+    {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+    }
+  return ts;
+}
+
+static void
+msleep (long ms)
+{
+  struct timespec ts = { ms / 1000, (ms % 1000) * 1000000 };
+
+  nanosleep (&ts, NULL);
+}
+
+static pthread_t
+spawn (void *(*fn) (void *), void *arg)
+{
+  pthread_t t;
+
+  CHECK (pthread_create (&t, NULL, fn, arg) == 0);
+  return t;
+}
+
+/* Wait until *P is at least VALUE, for the threads under test to get
+   to where they block.  */
+static void
+wait_for (volatile int *p, int value)
+{
+  int i;
+
+  for (i = 0; i < 5000 && *p < value; i++)
+    msleep (1);
+  msleep (20);
+}
+
+/* Mutexes.  */
+
+static pthread_mutex_t test_mutex;
+
+static void *
+try_other (void *arg)
+{
+  return (void *) (long) pthread_mutex_trylock (&test_mutex);
+}
+
+static void *
+unlock_other (void *arg)
+{
+  return (void *) (long) pthread_mutex_unlock (&test_mutex);
+}
+
+static void *
+timedlock_other (void *arg)
+{
+  struct timespec ts = deadline (50);
+  int err = pthread_mutex_timedlock (&test_mutex, &ts);
+
+  if (err == 0)
+    pthread_mutex_unlock (&test_mutex);
+  return (void *) (long) err;
+}
+
+static int
+in_other (void *(*fn) (void *))
+{
+  void *ret;
+
+  pthread_join (spawn (fn, NULL), &ret);
+  return (int) (long) ret;
+}
+
+struct counter
+{
+  pthread_mutex_t *mutex;
+  long count;
+  int iterations;
+};
+
+static void *
+count_up (void *arg)
+{
+  struct counter *c = arg;
+  int i;
+
+  for (i = 0; i < c->iterations; i++)
+    {
+      pthread_mutex_lock (c->mutex);
+      c->count++;
+      pthread_mutex_unlock (c->mutex);
+    }
+  return NULL;
+}
+
+static void
+test_mutex_kind (int kind)
+{
+  pthread_mutexattr_t attr;
+  struct counter c;
+  pthread_t t[8];
+  int i;
+
+  pthread_mutexattr_init (&attr);
+  CHECK (pthread_mutexattr_settype (&attr, kind) == 0);
+  CHECK (pthread_mutex_init (&test_mutex, &attr) == 0);
+
+  CHECK (pthread_mutex_lock (&test_mutex) == 0);
+  CHECK (in_other (try_other) == EBUSY);
+  CHECK (in_other (timedlock_other) == ETIMEDOUT);
+  CHECK (pthread_mutex_destroy (&test_mutex) == EBUSY);
+  switch (kind)
+    {
+    case PTHREAD_MUTEX_RECURSIVE_NP:
+      CHECK (pthread_mutex_lock (&test_mutex) == 0);
+      CHECK (pthread_mutex_trylock (&test_mutex) == 0);
+      CHECK (pthread_mutex_unlock (&test_mutex) == 0);
+      CHECK (pthread_mutex_unlock (&test_mutex) == 0);
+      CHECK (in_other (try_other) == EBUSY);
+      break;
+    case PTHREAD_MUTEX_ERRORCHECK_NP:
+      CHECK (pthread_mutex_lock (&test_mutex) == EDEADLK);
+      CHECK (pthread_mutex_trylock (&test_mutex) == EBUSY);
+      CHECK (in_other (unlock_other) == EPERM);
+      break;
+    default:
+      CHECK (pthread_mutex_trylock (&test_mutex) == EBUSY);
+      break;
+    }
+  CHECK (pthread_mutex_unlock (&test_mutex) == 0);
+  if (kind == PTHREAD_MUTEX_ERRORCHECK_NP)
+    {
+      CHECK (pthread_mutex_unlock (&test_mutex) == EPERM);
+    }
+  CHECK (in_other (timedlock_other) == 0);
+
+  c.mutex = &test_mutex;
+  c.count = 0;
+  c.iterations = 100000;
+  for (i = 0; i < 8; i++)
+    t[i] = spawn (count_up, &c);
+  for (i = 0; i < 8; i++)
+    pthread_join (t[i], NULL);
+  CHECK (c.count == 8 * 100000L);
+  CHECK (pthread_mutex_destroy (&test_mutex) == 0);
+}
+
+static void
+test_mutexes (void)
+{
+  pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+  struct timespec ts = { 0, 1000000000 };
+
+  test_mutex_kind (PTHREAD_MUTEX_TIMED_NP);
+  test_mutex_kind (PTHREAD_MUTEX_ADAPTIVE_NP);
+  test_mutex_kind (PTHREAD_MUTEX_RECURSIVE_NP);
+  test_mutex_kind (PTHREAD_MUTEX_ERRORCHECK_NP);
+
+  CHECK (pthread_mutex_lock (&m) == 0);
+  CHECK (pthread_mutex_timedlock (&m, &ts) == EINVAL);
+  CHECK (pthread_mutex_unlock (&m) == 0);
+}
+
+static pthread_once_t once_control;
+static int once_runs;
+
+static void
+once_routine (void)
+{
+  msleep (20);
+  once_runs++;
+}
+
+static void *
+run_once (void *arg)
+{
+  pthread_once (&once_control, once_routine);
+  return NULL;
+}
+
+static void
+test_once (void)
+{
+  pthread_t t[4];
+  int i;
+
+  for (i = 0; i < 4; i++)
+    t[i] = spawn (run_once, NULL);
+  for (i = 0; i < 4; i++)
+    pthread_join (t[i], NULL);
+  CHECK (once_runs == 1);
+}
+
+/* Condition variables.  */
+
+static pthread_mutex_t cond_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static volatile int waiting, woken, go;
+
+static void *
+cond_waiter (void *arg)
+{
+  pthread_mutex_lock (&cond_mutex);
+  waiting++;
+  while (!go)
+    pthread_cond_wait (&cond, &cond_mutex);
+  woken++;
+  pthread_mutex_unlock (&cond_mutex);
+  return NULL;
+}
+
+static void *
+cond_cancel_waiter (void *arg)
+{
+  pthread_mutex_lock (&cond_mutex);
+  waiting++;
+  for (;;)
+    pthread_cond_wait (&cond, &cond_mutex);
+  return NULL;
+}
+
+struct queue
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t nonempty;
+  pthread_cond_t nonfull;
+  int items;
+  long sum;
+};
+
+static void *
+producer (void *arg)
+{
+  struct queue *q = arg;
+  int i;
+
+  for (i = 1; i <= 20000; i++)
+    {
+      pthread_mutex_lock (&q->mutex);
+      while (q->items == 4)
+	pthread_cond_wait (&q->nonfull, &q->mutex);
+      q->items++;
+      pthread_cond_signal (&q->nonempty);
+      pthread_mutex_unlock (&q->mutex);
+    }
+  return NULL;
+}
+
+static void *
+consumer (void *arg)
+{
+  struct queue *q = arg;
+  int i;
+
+  for (i = 1; i <= 20000; i++)
+    {
+      pthread_mutex_lock (&q->mutex);
+      while (q->items == 0)
+	pthread_cond_wait (&q->nonempty, &q->mutex);
+      q->items--;
+      q->sum++;
+      pthread_cond_signal (&q->nonfull);
+      pthread_mutex_unlock (&q->mutex);
+    }
+  return NULL;
+}
+
+static void
+test_cond (void)
+{
+  struct queue q;
+  struct timespec ts;
+  struct timespec start, end;
+  pthread_t t[8];
+  void *ret;
+  int i;
+
+  /* Signal wakes one waiter, broadcast the rest.  */
+  waiting = woken = go = 0;
+  for (i = 0; i < 8; i++)
+    t[i] = spawn (cond_waiter, NULL);
+  wait_for (&waiting, 8);
+  pthread_mutex_lock (&cond_mutex);
+  go = 1;
+  CHECK (pthread_cond_destroy (&cond) == EBUSY);
+  pthread_cond_signal (&cond);
+  pthread_mutex_unlock (&cond_mutex);
+  wait_for (&woken, 1);
+  CHECK (woken == 1);
+  pthread_mutex_lock (&cond_mutex);
+  pthread_cond_broadcast (&cond);
+  pthread_mutex_unlock (&cond_mutex);
+  for (i = 0; i < 8; i++)
+    pthread_join (t[i], NULL);
+  CHECK (woken == 8);
+
+  /* Time-outs return with the mutex held again.  */
+  pthread_mutex_lock (&cond_mutex);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  ts = deadline (50);
+  CHECK (pthread_cond_timedwait (&cond, &cond_mutex, &ts) == ETIMEDOUT);
+  clock_gettime (CLOCK_MONOTONIC, &end);
+  CHECK ((end.tv_sec - start.tv_sec) * 1000000000L
+	 + (end.tv_nsec - start.tv_nsec) >= 45000000L);
+  ts.tv_nsec = 1000000000;
+  CHECK (pthread_cond_timedwait (&cond, &cond_mutex, &ts) == EINVAL);
+  CHECK (pthread_mutex_unlock (&cond_mutex) == 0);
+
+  /* A canceled waiter exits with the mutex taken again.  */
+  waiting = 0;
+  t[0] = spawn (cond_cancel_waiter, NULL);
+  wait_for (&waiting, 1);
+  pthread_cancel (t[0]);
+  pthread_join (t[0], &ret);
+  CHECK (ret == PTHREAD_CANCELED);
+  CHECK (pthread_mutex_trylock (&cond_mutex) == EBUSY);
+  pthread_mutex_unlock (&cond_mutex);
+  CHECK (pthread_cond_destroy (&cond) == 0);
+
+  /* A bounded queue, which has every thread block and wake up often.  */
+  memset (&q, 0, sizeof q);
+  pthread_mutex_init (&q.mutex, NULL);
+  pthread_cond_init (&q.nonempty, NULL);
+  pthread_cond_init (&q.nonfull, NULL);
+  for (i = 0; i < 8; i++)
+    t[i] = spawn (i % 2 ? consumer : producer, &q);
+  for (i = 0; i < 8; i++)
+    pthread_join (t[i], NULL);
+  CHECK (q.items == 0 && q.sum == 4 * 20000L);
+}
+
+/* Semaphores.  */
+
+static sem_t test_sem;
+
+static void *
+sem_waiter (void *arg)
+{
+  waiting++;
+  CHECK (sem_wait (&test_sem) == 0);
+  woken++;
+  return NULL;
+}
+
+static void *
+sem_cancel_waiter (void *arg)
+{
+  waiting++;
+  sem_wait (&test_sem);
+  return NULL;
+}
+
+static void *
+sem_counter (void *arg)
+{
+  int i;
+
+  for (i = 0; i < 50000; i++)
+    {
+      sem_wait (&test_sem);
+      (*(long *) arg)++;
+      sem_post (&test_sem);
+    }
+  return NULL;
+}
+
+static void
+test_semaphores (void)
+{
+  struct timespec ts;
+  pthread_t t[4];
+  long count = 0;
+  void *ret;
+  int i, val;
+
+  CHECK (sem_init (&test_sem, 0, (unsigned) INT_MAX + 1) == -1
+	 && errno == EINVAL);
+  CHECK (sem_init (&test_sem, 0, 2) == 0);
+  CHECK (sem_trywait (&test_sem) == 0);
+  CHECK (sem_wait (&test_sem) == 0);
+  CHECK (sem_trywait (&test_sem) == -1 && errno == EAGAIN);
+  ts = deadline (30);
+  CHECK (sem_timedwait (&test_sem, &ts) == -1 && errno == ETIMEDOUT);
+  ts.tv_nsec = -1;
+  CHECK (sem_timedwait (&test_sem, &ts) == -1 && errno == EINVAL);
+
+  waiting = woken = 0;
+  for (i = 0; i < 4; i++)
+    t[i] = spawn (sem_waiter, NULL);
+  wait_for (&waiting, 4);
+  CHECK (sem_destroy (&test_sem) == -1 && errno == EBUSY);
+  for (i = 0; i < 4; i++)
+    sem_post (&test_sem);
+  for (i = 0; i < 4; i++)
+    pthread_join (t[i], NULL);
+  CHECK (woken == 4);
+  CHECK (sem_getvalue (&test_sem, &val) == 0 && val == 0);
+
+  waiting = 0;
+  t[0] = spawn (sem_cancel_waiter, NULL);
+  wait_for (&waiting, 1);
+  pthread_cancel (t[0]);
+  pthread_join (t[0], &ret);
+  CHECK (ret == PTHREAD_CANCELED);
+  CHECK (sem_destroy (&test_sem) == 0);
+
+  /* A binary semaphore used as a lock.  */
+  sem_init (&test_sem, 0, 1);
+  for (i = 0; i < 4; i++)
+    t[i] = spawn (sem_counter, &count);
+  for (i = 0; i < 4; i++)
+    pthread_join (t[i], NULL);
+  CHECK (count == 4 * 50000L);
+  CHECK (sem_getvalue (&test_sem, &val) == 0 && val == 1);
+  sem_destroy (&test_sem);
+}
+
+/* Read-write locks.  */
+
+static pthread_rwlock_t test_rwlock;
+
+static void *
+tryrd_other (void *arg)
+{
+  int err = pthread_rwlock_tryrdlock (&test_rwlock);
+
+  if (err == 0)
+    pthread_rwlock_unlock (&test_rwlock);
+  return (void *) (long) err;
+}
+
+static void *
+trywr_other (void *arg)
+{
+  int err = pthread_rwlock_trywrlock (&test_rwlock);
+
+  if (err == 0)
+    pthread_rwlock_unlock (&test_rwlock);
+  return (void *) (long) err;
+}
+
+static void *
+timedrd_other (void *arg)
+{
+  struct timespec ts = deadline (30);
+  int err = pthread_rwlock_timedrdlock (&test_rwlock, &ts);
+
+  if (err == 0)
+    pthread_rwlock_unlock (&test_rwlock);
+  return (void *) (long) err;
+}
+
+static void *
+rd_other (void *arg)
+{
+  waiting++;
+  CHECK (pthread_rwlock_rdlock (&test_rwlock) == 0);
+  woken++;
+  pthread_rwlock_unlock (&test_rwlock);
+  return NULL;
+}
+
+static void *
+wr_other (void *arg)
+{
+  waiting++;
+  CHECK (pthread_rwlock_wrlock (&test_rwlock) == 0);
+  woken++;
+  pthread_rwlock_unlock (&test_rwlock);
+  return NULL;
+}
+
+static void *
+timedwr_other (void *arg)
+{
+  struct timespec ts = deadline ((long) arg);
+  int err;
+
+  waiting++;
+  err = pthread_rwlock_timedwrlock (&test_rwlock, &ts);
+  if (err == 0)
+    pthread_rwlock_unlock (&test_rwlock);
+  return (void *) (long) err;
+}
+
+struct rwcounter
+{
+  pthread_rwlock_t *rwlock;
+  long a, b;
+};
+
+static void *
+rw_mix (void *arg)
+{
+  struct rwcounter *c = arg;
+  int i;
+
+  for (i = 0; i < 50000; i++)
+    if (i % 8 == 0)
+      {
+	pthread_rwlock_wrlock (c->rwlock);
+	c->a++;
+	c->b++;
+	pthread_rwlock_unlock (c->rwlock);
+      }
+    else
+      {
+	pthread_rwlock_rdlock (c->rwlock);
+	CHECK (c->a == c->b);
+	pthread_rwlock_unlock (c->rwlock);
+      }
+  return NULL;
+}
+
+static void
+test_rwlock_kind (int kind)
+{
+  pthread_rwlockattr_t attr;
+  struct rwcounter c;
+  pthread_t t[8];
+  void *ret;
+  int i;
+
+  pthread_rwlockattr_init (&attr);
+  pthread_rwlockattr_setkind_np (&attr, kind);
+  CHECK (pthread_rwlock_init (&test_rwlock, &attr) == 0);
+  CHECK (pthread_rwlock_unlock (&test_rwlock) == EPERM);
+
+  /* Readers share, writers do not.  */
+  CHECK (pthread_rwlock_rdlock (&test_rwlock) == 0);
+  CHECK (in_other (tryrd_other) == 0);
+  CHECK (in_other (trywr_other) == EBUSY);
+  CHECK (pthread_rwlock_destroy (&test_rwlock) == EBUSY);
+  CHECK (pthread_rwlock_unlock (&test_rwlock) == 0);
+  CHECK (pthread_rwlock_wrlock (&test_rwlock) == 0);
+  CHECK (in_other (tryrd_other) == EBUSY);
+  CHECK (in_other (timedrd_other) == ETIMEDOUT);
+
+  /* Unlocking a writer lets all the readers in.  */
+  waiting = woken = 0;
+  for (i = 0; i < 4; i++)
+    t[i] = spawn (rd_other, NULL);
+  wait_for (&waiting, 4);
+  CHECK (woken == 0);
+  CHECK (pthread_rwlock_unlock (&test_rwlock) == 0);
+  for (i = 0; i < 4; i++)
+    pthread_join (t[i], NULL);
+  CHECK (woken == 4);
+
+  /* A reader holds the lock and a writer waits for it.  */
+  waiting = woken = 0;
+  CHECK (pthread_rwlock_rdlock (&test_rwlock) == 0);
+  t[0] = spawn (wr_other, NULL);
+  wait_for (&waiting, 1);
+  if (kind == PTHREAD_RWLOCK_PREFER_READER_NP)
+    {
+      CHECK (in_other (tryrd_other) == 0);
+    }
+  else
+    {
+      /* New readers are held back, and unless the lock is of the
+	 nonrecursive kind the recursive ones are not.  */
+      CHECK (in_other (tryrd_other) == EBUSY);
+      if (kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+	{
+	  CHECK (pthread_rwlock_rdlock (&test_rwlock) == 0);
+	  CHECK (pthread_rwlock_unlock (&test_rwlock) == 0);
+	}
+    }
+  CHECK (woken == 0);
+  CHECK (pthread_rwlock_unlock (&test_rwlock) == 0);
+  pthread_join (t[0], NULL);
+  CHECK (woken == 1);
+
+  /* Readers held back for a writer get the lock when it gives up.  */
+  if (kind != PTHREAD_RWLOCK_PREFER_READER_NP)
+    {
+      waiting = woken = 0;
+      CHECK (pthread_rwlock_rdlock (&test_rwlock) == 0);
+      t[0] = spawn (timedwr_other, (void *) 100L);
+      wait_for (&waiting, 1);
+      t[1] = spawn (rd_other, NULL);
+      wait_for (&waiting, 2);
+      CHECK (woken == 0);
+      pthread_join (t[0], &ret);
+      CHECK ((long) ret == ETIMEDOUT);
+      pthread_join (t[1], NULL);
+      CHECK (woken == 1);
+      CHECK (pthread_rwlock_unlock (&test_rwlock) == 0);
+    }
+
+  c.rwlock = &test_rwlock;
+  c.a = c.b = 0;
+  for (i = 0; i < 8; i++)
+    t[i] = spawn (rw_mix, &c);
+  for (i = 0; i < 8; i++)
+    pthread_join (t[i], NULL);
+  CHECK (c.a == 8 * 50000L / 8);
+  CHECK (pthread_rwlock_destroy (&test_rwlock) == 0);
+}
+
+static void
+test_rwlocks (void)
+{
+  test_rwlock_kind (PTHREAD_RWLOCK_DEFAULT_NP);
+  test_rwlock_kind (PTHREAD_RWLOCK_PREFER_READER_NP);
+  test_rwlock_kind (PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+}
+
+int
+main (void)
+{
+  test_mutexes ();
+  test_once ();
+  test_cond ();
+  test_semaphores ();
+  test_rwlocks ();
+  exit (0);
+}
@@ -0,0 +1,236 @@
+/*
+ * Check the creation, exit and join of threads in linuxthreads, which
+ * clones them straight into the thread group of the process and waits
+ * for their end on the futex the kernel clears: a thread sees the process
+ * id of the process and a thread id of its own, its return value comes
+ * back from pthread_join, a second join fails, 200 threads run at once,
+ * detached threads are freed for later creations whether detached at
+ * creation or after they ended, and 8 threads each create and join 500
+ * more.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "check.h"
+
+static void
+msleep (long ms)
+{
+  struct timespec ts = { ms / 1000, (ms % 1000) * 1000000 };
+
+  nanosleep (&ts, NULL);
+}
+
+static pthread_t
+spawn (const pthread_attr_t *attr, void *(*fn) (void *), void *arg)
+{
+  pthread_t t;
+
+  CHECK (pthread_create (&t, attr, fn, arg) == 0);
+  return t;
+}
+
+struct probe
+{
+  long value;
+  pid_t pid, tid;
+};
+
+static void *
+probe_thread (void *arg)
+{
+  struct probe *p = arg;
+
+  p->pid = getpid ();
+  p->tid = syscall (SYS_gettid);
+  return (void *) (p->value + 1);
+}
+
+static void *
+return_arg (void *arg)
+{
+  return arg;
+}
+
+static void *
+join_self (void *arg)
+{
+  return (void *) (long) pthread_join (pthread_self (), NULL);
+}
+
+static void
+test_create_join (void)
+{
+  struct probe p = { 41 };
+  pthread_t t;
+  void *ret;
+
+  t = spawn (NULL, probe_thread, &p);
+  CHECK (pthread_join (t, &ret) == 0);
+  CHECK (ret == (void *) 42);
+  /* One thread group: the process id is shared, the thread id not.  */
+  CHECK (p.pid == getpid ());
+  CHECK (p.tid != 0 && p.tid != syscall (SYS_gettid));
+  CHECK (pthread_join (t, NULL) == ESRCH);
+
+  CHECK (pthread_join (spawn (NULL, join_self, NULL), &ret) == 0);
+  CHECK ((long) ret == EDEADLK);
+}
+
+static volatile int go;
+static int started;
+
+static void *
+wait_for_go (void *arg)
+{
+  __atomic_add_fetch (&started, 1, __ATOMIC_SEQ_CST);
+  while (!go)
+    sched_yield ();
+  return arg;
+}
+
+static void
+test_many (void)
+{
+  enum { N = 200 };
+  pthread_t t[N];
+  void *ret;
+  int i;
+
+  go = 0;
+  started = 0;
+  for (i = 0; i < N; i++)
+    t[i] = spawn (NULL, wait_for_go, (void *) (long) i);
+  while (__atomic_load_n (&started, __ATOMIC_SEQ_CST) < N)
+    sched_yield ();
+  go = 1;
+  for (i = N - 1; i >= 0; i--)
+    {
+      CHECK (pthread_join (t[i], &ret) == 0);
+      CHECK (ret == (void *) (long) i);
+    }
+}
+
+static int counted;
+
+static void *
+count_up (void *arg)
+{
+  __atomic_add_fetch (&counted, 1, __ATOMIC_SEQ_CST);
+  return arg;
+}
+
+/* Create a detached thread, waiting for those that ended to be freed
+   if there is no room for it.  */
+static void
+spawn_detached (const pthread_attr_t *attr)
+{
+  pthread_t t;
+  int i, err;
+
+  for (i = 0; i < 1000; i++)
+    {
+      err = pthread_create (&t, attr, count_up, NULL);
+      if (err != EAGAIN)
+	break;
+      msleep (1);
+    }
+  CHECK (err == 0);
+}
+
+static void
+test_detached (void)
+{
+  /* More threads than there is room for at once.  */
+  enum { ROUNDS = 8, EACH = 500 };
+  pthread_attr_t attr;
+  pthread_t t;
+  int i, j;
+
+  CHECK (pthread_attr_init (&attr) == 0);
+  CHECK (pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED) == 0);
+  counted = 0;
+  t = spawn (&attr, count_up, NULL);
+  CHECK (pthread_join (t, NULL) == EINVAL);
+  while (__atomic_load_n (&counted, __ATOMIC_SEQ_CST) < 1)
+    sched_yield ();
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      counted = 0;
+      for (j = 0; j < EACH; j++)
+	spawn_detached (&attr);
+      while (__atomic_load_n (&counted, __ATOMIC_SEQ_CST) < EACH)
+	sched_yield ();
+    }
+
+  /* Detached after they have ended.  */
+  for (i = 0; i < ROUNDS; i++)
+    {
+      counted = 0;
+      for (j = 0; j < EACH; j++)
+	{
+	  t = spawn (NULL, count_up, NULL);
+	  while (__atomic_load_n (&counted, __ATOMIC_SEQ_CST) <= j)
+	    sched_yield ();
+	  CHECK (pthread_detach (t) == 0);
+	}
+    }
+  pthread_attr_destroy (&attr);
+}
+
+static long nested_sum;
+
+static void *
+spawn_some (void *arg)
+{
+  long n = (long) arg, i;
+  pthread_t t;
+  void *ret;
+
+  for (i = 0; i < n; i++)
+    {
+      if (pthread_create (&t, NULL, return_arg, (void *) i) != 0
+	  || pthread_join (t, &ret) != 0)
+	return (void *) -1L;
+      __atomic_add_fetch (&nested_sum, (long) ret, __ATOMIC_SEQ_CST);
+    }
+  return NULL;
+}
+
+static void
+test_nested (void)
+{
+  enum { SPAWNERS = 8, EACH = 500 };
+  pthread_t t[SPAWNERS];
+  void *ret;
+  int i;
+
+  nested_sum = 0;
+  for (i = 0; i < SPAWNERS; i++)
+    t[i] = spawn (NULL, spawn_some, (void *) (long) EACH);
+  for (i = 0; i < SPAWNERS; i++)
+    {
+      CHECK (pthread_join (t[i], &ret) == 0);
+      CHECK (ret == NULL);
+    }
+  CHECK (nested_sum == (long) SPAWNERS * EACH * (EACH - 1) / 2);
+}
+
+int
+main (void)
+{
+  test_create_join ();
+  test_many ();
+  test_detached ();
+  test_nested ();
+  exit (0);
+}
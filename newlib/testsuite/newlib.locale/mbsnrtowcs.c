@@ -0,0 +1,101 @@
+/*
+ * Check that the bulk conversion paths in mbsnrtowcs/wcsnrtombs and
+ * mbstowcs/wcstombs agree with the per-character conversion functions,
+ * including the hand-off at input and output limits which end in the
+ * middle of a multibyte character.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <newlib.h>
+#include <locale.h>
+#include "check.h"
+
+static const char utf8[] =
+  "plain ASCII run which is long enough for the word-at-a-time path, "
+  "caf\xc3\xa9 \xe2\x82\xac" "5, \xf0\x9f\x98\x80 and more ASCII at the end";
+
+static size_t
+slow_mbs (wchar_t *dst, const char *src, size_t nms)
+{
+  mbstate_t ps;
+  size_t cnt = 0, n;
+
+  memset (&ps, 0, sizeof ps);
+  while (nms > 0 && (n = mbrtowc (dst + cnt, src, nms, &ps)) > 0)
+    {
+      if (n == (size_t) -2)
+	break;
+      CHECK (n != (size_t) -1);
+      src += n;
+      nms -= n;
+      ++cnt;
+    }
+  return cnt;
+}
+
+int main()
+{
+#if !defined(_ELIX_LEVEL) || _ELIX_LEVEL > 1
+  wchar_t wbuf[256], ref[256];
+  char mbuf[256];
+  const char *src;
+  const wchar_t *wsrc;
+  mbstate_t ps;
+  size_t nms, n, cnt;
+
+  if (_MB_LEN_MAX == 1 || !setlocale (LC_CTYPE, "C.UTF-8"))
+    return 0;
+
+  for (nms = 0; nms <= sizeof utf8; ++nms)
+    {
+      memset (&ps, 0, sizeof ps);
+      src = utf8;
+      n = mbsnrtowcs (wbuf, &src, nms, 256, &ps);
+      cnt = slow_mbs (ref, utf8, nms);
+      if (nms == sizeof utf8)
+	CHECK (src == NULL);
+      CHECK (n == cnt);
+      CHECK (!memcmp (wbuf, ref, n * sizeof (wchar_t)));
+      /* Restart from a partial character using the saved state. */
+      if (src && src < utf8 + sizeof utf8 - 1)
+	{
+	  size_t rest = mbsnrtowcs (wbuf + n, &src, sizeof utf8, 256 - n, &ps);
+	  CHECK (rest != (size_t) -1);
+	  CHECK (n + rest == slow_mbs (ref, utf8, sizeof utf8));
+	  CHECK (!memcmp (wbuf, ref, (n + rest) * sizeof (wchar_t)));
+	}
+    }
+
+  n = mbstowcs (wbuf, utf8, 256);
+  CHECK (n != (size_t) -1);
+  CHECK (n == mbstowcs (NULL, utf8, 0));
+  CHECK (n == slow_mbs (ref, utf8, sizeof utf8));
+  CHECK (!memcmp (wbuf, ref, n * sizeof (wchar_t)));
+
+  CHECK (wcstombs (NULL, wbuf, 0) == strlen (utf8));
+  CHECK (wcstombs (mbuf, wbuf, sizeof mbuf) == strlen (utf8));
+  CHECK (!strcmp (mbuf, utf8));
+
+  /* Output buffers which end in the middle of a character. */
+  for (n = 0; n < strlen (utf8); ++n)
+    {
+      memset (&ps, 0, sizeof ps);
+      memset (mbuf, 0, sizeof mbuf);
+      wsrc = wbuf;
+      cnt = wcsnrtombs (mbuf, &wsrc, 256, n, &ps);
+      CHECK (cnt <= n);
+      CHECK (!strncmp (mbuf, utf8, cnt));
+      CHECK (cnt == n || (utf8[cnt] & 0xc0) != 0x80);
+    }
+
+  /* Invalid input must still be reported. */
+  memset (&ps, 0, sizeof ps);
+  src = "abc\xc3(";
+  CHECK (mbsnrtowcs (wbuf, &src, 5, 256, &ps) == (size_t) -1);
+#endif
+
+  exit (0);
+}
@@ -0,0 +1,193 @@
+/*
+ * Check the special results C99 Annex G requires of the complex functions
+ * and of the multiplication and division the compiler calls __muldc3 and
+ * __divdc3 for, in double and in float: on the branch cuts, at signed
+ * zeros and at infinities.  Finite nonzero parts may be 2 ulp of the
+ * larger part off; next to a nan part the sign of the other is not
+ * specified and is not checked.
+ */
+
+#include <complex.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+extern double complex __muldc3 (double, double, double, double);
+extern double complex __divdc3 (double, double, double, double);
+extern float complex __mulsc3 (float, float, float, float);
+extern float complex __divsc3 (float, float, float, float);
+
+static double complex
+muld (double complex z, double complex w)
+{
+  return __muldc3 (creal (z), cimag (z), creal (w), cimag (w));
+}
+
+static double complex
+divd (double complex z, double complex w)
+{
+  return __divdc3 (creal (z), cimag (z), creal (w), cimag (w));
+}
+
+static float complex
+mulf (float complex z, float complex w)
+{
+  return __mulsc3 (crealf (z), cimagf (z), crealf (w), cimagf (w));
+}
+
+static float complex
+divf (float complex z, float complex w)
+{
+  return __divsc3 (crealf (z), cimagf (z), crealf (w), cimagf (w));
+}
+
+static const struct
+{
+  const char *name;
+  double complex (*d1) (double complex);
+  float complex (*f1) (float complex);
+  double complex (*d2) (double complex, double complex);
+  float complex (*f2) (float complex, float complex);
+} funcs[] =
+{
+  { "csqrt", csqrt, csqrtf, NULL, NULL },
+  { "clog", clog, clogf, NULL, NULL },
+  { "cexp", cexp, cexpf, NULL, NULL },
+  { "csin", csin, csinf, NULL, NULL },
+  { "ccos", ccos, ccosf, NULL, NULL },
+  { "ctan", ctan, ctanf, NULL, NULL },
+  { "csinh", csinh, csinhf, NULL, NULL },
+  { "ccosh", ccosh, ccoshf, NULL, NULL },
+  { "ctanh", ctanh, ctanhf, NULL, NULL },
+  { "cpow", NULL, NULL, cpow, cpowf },
+  { "mul", NULL, NULL, muld, mulf },
+  { "div", NULL, NULL, divd, divf },
+};
+#define NFUNCS (sizeof funcs / sizeof funcs[0])
+
+/* The second argument is only used by the functions of two.  */
+static const struct
+{
+  const char *name;
+  double a[4];
+  double re, im;
+} tests[] =
+{
+  { "csqrt", { -4, 0.0 }, 0, 2 },
+  { "csqrt", { -4, -0.0 }, 0, -2 },
+  { "csqrt", { 0.0, 0.0 }, 0.0, 0.0 },
+  { "csqrt", { -0.0, -0.0 }, 0.0, -0.0 },
+  { "csqrt", { 1, INFINITY }, INFINITY, INFINITY },
+  { "csqrt", { NAN, INFINITY }, INFINITY, INFINITY },
+  { "csqrt", { -INFINITY, 1 }, 0.0, INFINITY },
+  { "csqrt", { INFINITY, -1 }, INFINITY, -0.0 },
+  { "clog", { -1, 0.0 }, 0.0, M_PI },
+  { "clog", { -1, -0.0 }, 0.0, -M_PI },
+  { "clog", { 1, 0.0 }, 0.0, 0.0 },
+  { "clog", { 0.0, 0.0 }, -INFINITY, 0.0 },
+  { "clog", { -0.0, 0.0 }, -INFINITY, M_PI },
+  { "clog", { INFINITY, NAN }, INFINITY, NAN },
+  { "cpow", { -8, 0.0, 1.0 / 3, 0.0 }, 1, 0x1.bb67ae8584caap0 },
+  { "cpow", { -8, -0.0, 1.0 / 3, 0.0 }, 1, -0x1.bb67ae8584caap0 },
+  { "cexp", { 0.0, 0.0 }, 1, 0.0 },
+  { "cexp", { 2, -0.0 }, 0x1.d8e64b8d4ddaep2, -0.0 },
+  { "cexp", { INFINITY, 0.0 }, INFINITY, 0.0 },
+  { "cexp", { -INFINITY, 1 }, 0.0, 0.0 },
+  { "csin", { 0.0, 0.0 }, 0.0, 0.0 },
+  { "ccos", { 0.0, 0.0 }, 1, -0.0 },
+  { "csinh", { -0.0, 0.0 }, -0.0, 0.0 },
+  { "ccosh", { 0.0, 0.0 }, 1, 0.0 },
+  { "ctan", { 0.0, -0.0 }, 0.0, -0.0 },
+  { "ctan", { 1, INFINITY }, 0.0, 1 },
+  { "ctanh", { INFINITY, 1 }, 1, 0.0 },
+  { "ctanh", { -0.0, 0.0 }, -0.0, 0.0 },
+  { "mul", { INFINITY, NAN, 1, 1 }, INFINITY, INFINITY },
+  { "mul", { 0.0, -0.0, 1, 1 }, 0.0, 0.0 },
+  { "div", { 1, 1, 0.0, 0.0 }, INFINITY, INFINITY },
+  { "div", { 1, 1, INFINITY, NAN }, 0.0, 0.0 },
+  { "div", { INFINITY, 1, 1, 1 }, INFINITY, -INFINITY },
+};
+#define NTESTS (sizeof tests / sizeof tests[0])
+
+static double complex
+make (double re, double im)
+{
+  double complex z;
+
+  __real__ z = re;
+  __imag__ z = im;
+  return z;
+}
+
+/* Whether part GOT of a result is WANT, or within TOL of it if both are
+   finite and WANT is not zero.  */
+static int
+part_ok (double want, double got, double tol, int check_sign)
+{
+  if (isnan (want))
+    return isnan (got);
+  if (want == 0 || isinf (want))
+    return got == want && (!check_sign || signbit (got) == signbit (want));
+  return fabs (got - want) <= tol;
+}
+
+/* Whether GOT is WANT, with finite parts within 2 ulp of the larger
+   finite part in a type of MANT bits of precision.  */
+static int
+result_ok (double complex want, double complex got, int mant)
+{
+  double re = creal (want), im = cimag (want);
+  double big = fmax (isfinite (re) ? fabs (re) : 0,
+		     isfinite (im) ? fabs (im) : 0);
+  double tol = big == 0 ? 0 : 2 * ldexp (1, ilogb (big) - (mant - 1));
+
+  return part_ok (re, creal (got), tol, !isnan (im))
+	 && part_ok (im, cimag (got), tol, !isnan (re));
+}
+
+static void
+check (unsigned int f, unsigned int t)
+{
+  const double *a = tests[t].a;
+  double complex want = make (tests[t].re, tests[t].im), got;
+  double complex z = make (a[0], a[1]), w = make (a[2], a[3]);
+  float complex zf = (float complex) z, wf = (float complex) w, gotf;
+
+  if (funcs[f].d1 != NULL)
+    {
+      got = funcs[f].d1 (z);
+      gotf = funcs[f].f1 (zf);
+    }
+  else
+    {
+      got = funcs[f].d2 (z, w);
+      gotf = funcs[f].f2 (zf, wf);
+    }
+  if (!result_ok (want, got, DBL_MANT_DIG))
+    printf ("%s (%g%+gi, %g%+gi) = %.9g%+.9gi\n", funcs[f].name, a[0], a[1],
+	    a[2], a[3], creal (got), cimag (got));
+  if (!result_ok (want, gotf, FLT_MANT_DIG))
+    printf ("%sf (%g%+gi, %g%+gi) = %.9g%+.9gi\n", funcs[f].name, a[0], a[1],
+	    a[2], a[3], crealf (gotf), cimagf (gotf));
+  CHECK (result_ok (want, got, DBL_MANT_DIG));
+  CHECK (result_ok (want, gotf, FLT_MANT_DIG));
+}
+
+int
+main (void)
+{
+  unsigned int f, t;
+
+  for (t = 0; t < NTESTS; ++t)
+    {
+      for (f = 0; f < NFUNCS && strcmp (funcs[f].name, tests[t].name) != 0;
+	   ++f)
+	;
+      CHECK (f < NFUNCS);
+      check (f, t);
+    }
+  exit (0);
+}
@@ -0,0 +1,58 @@
+/*
+ * Check __divdc3, which the compiler calls for double complex division,
+ * on operands whose parts are far apart in magnitude, where the quotient
+ * or one of its parts is only right if the dividend is scaled together
+ * with the divisor, and on the infinite and zero operands of C99 G.5.1.
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "check.h"
+
+extern double complex __divdc3 (double, double, double, double);
+
+static int
+same (double x, double y)
+{
+  return (isnan (x) && isnan (y)) || x == y;
+}
+
+static void
+check_div (double a, double b, double c, double d, double x, double y)
+{
+  double complex z = __divdc3 (a, b, c, d);
+
+  if (!same (creal (z), x) || !same (cimag (z), y))
+    printf ("(%a%+ai) / (%a%+ai) = %a%+ai, not %a%+ai\n", a, b, c, d,
+	    creal (z), cimag (z), x, y);
+  CHECK (same (creal (z), x) && same (cimag (z), y));
+}
+
+int main()
+{
+  /* A subnormal divisor with a subnormal dividend.  */
+  check_div (0.0, 0x1p-1074, 0x1p-1074, 0x1p-1074, 0.5, 0.5);
+  check_div (0x1p-1074, 0.0, 0.0, 0x1p-1074, 0.0, -1.0);
+  /* A part of the quotient far below the other one, that must not
+     underflow before the scaling is undone.  */
+  check_div (0.0, 0x1p1023, 0x1p-1074, 3.0, 0x1.5555555555555p+1021,
+	     0x1.c71c71c71c71cp-55);
+  check_div (0.0, 0x1p-60, 0x1p-1074, 0x1p-60, 1.0, 0x1p-1014);
+  /* Parts near the top of the range.  */
+  check_div (0x1p1023, 0x1p1023, 0x1p1023, 0x1p1023, 1.0, 0.0);
+  check_div (0x1p1023, -0x1p1023, 0x1p1023, 0x1p1023, 0.0, -1.0);
+  check_div (1.0, 1.0, 0x1p1023, 0x1p1023, 0x1p-1023, 0.0);
+  /* The well scaled case.  */
+  check_div (1.0, 2.0, 3.0, 4.0, 0.44, 0.08);
+  check_div (4.0, 2.0, 2.0, 0.0, 2.0, 1.0);
+
+  /* Infinite and zero operands (G.5.1).  */
+  check_div (1.0, 1.0, 0.0, 0.0, HUGE_VAL, HUGE_VAL);
+  check_div (1.0, 1.0, HUGE_VAL, NAN, 0.0, 0.0);
+  check_div (HUGE_VAL, 1.0, 1.0, 1.0, HUGE_VAL, -HUGE_VAL);
+  check_div (NAN, NAN, 1.0, 1.0, NAN, NAN);
+
+  exit (0);
+}
@@ -0,0 +1,64 @@
+/*
+ * Check mktime against localtime_r for dates spread over the positive 32 bit
+ * time_t range, jumping between years so that the per-year cache of DST
+ * change-over times has to be refilled and reused.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+static void
+check_zone (const char *zone)
+{
+  struct tm tm, tm2;
+  time_t t, t2;
+  long i;
+
+  setenv ("TZ", zone, 1);
+  tzset ();
+
+  for (i = 0; i < 19999; ++i)
+    {
+      /* Alternate between the lower and upper end of the range. */
+      t = (time_t) ((i & 1) ? i * 107377L + 3607L : 2147483647L - i * 107377L);
+      CHECK (localtime_r (&t, &tm) != NULL);
+      tm2 = tm;
+      t2 = mktime (&tm2);
+      CHECK (t2 == t);
+      CHECK (tm2.tm_year == tm.tm_year);
+      CHECK (tm2.tm_yday == tm.tm_yday);
+      CHECK (tm2.tm_wday == tm.tm_wday);
+      CHECK (tm2.tm_hour == tm.tm_hour);
+      CHECK (tm2.tm_isdst == tm.tm_isdst);
+    }
+}
+
+int main()
+{
+  struct tm tm;
+
+  setenv ("TZ", "GMT0", 1);
+  tzset ();
+  memset (&tm, 0, sizeof tm);
+  tm.tm_year = 100;
+  tm.tm_mday = 1;
+  CHECK (mktime (&tm) == (time_t) 946684800L);
+  CHECK (tm.tm_wday == 6);
+  tm.tm_year = 1;
+  tm.tm_mon = 11;
+  tm.tm_mday = 13;
+  tm.tm_hour = 20;
+  tm.tm_min = 45;
+  tm.tm_sec = 52;
+  CHECK (mktime (&tm) == (time_t) -2147483648L);
+  CHECK (tm.tm_yday == 346);
+
+  check_zone ("EST5EDT,M3.2.0,M11.1.0");
+  check_zone ("CET-1CEST,M3.5.0,M10.5.0/3");
+  check_zone ("AEST-10AEDT,M10.1.0,M4.1.0/3");
+
+  exit (0);
+}
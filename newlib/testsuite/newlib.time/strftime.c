@@ -0,0 +1,272 @@
+/*
+ * Check strftime and wcsftime in the "C" locale: each conversion for
+ * times from year 1000 to 9999 as C and POSIX have it, the week numbers
+ * of any date against the rules for them, and fields out of range,
+ * negative or with more digits than the conversion pads to, as snprintf
+ * formats them.  A buffer just long enough must hold the result and one
+ * that is one shorter must give 0.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+#include "check.h"
+
+/* Every conversion except %s, %z and %Z, which depend on the zone.  */
+static const char all[] =
+  "%a %A %b %B %C %d %D %e %F %g %G %h %H %I %j %k %l %m %M %p %r %R %S "
+  "%T %u %U %V %w %W %y %Y %%";
+static const char all2[] = "%c|%x|%X|%n|%t";
+
+static const struct
+{
+  /* tm_sec, tm_min, tm_hour, tm_mday, tm_mon, tm_year, tm_wday and
+     tm_yday */
+  int tm[8];
+  const char *all, *all2;
+} known[] =
+{
+  { { 0, 0, 0, 1, 0, 70, 4, 0 },
+    "Thu Thursday Jan January 19 01 01/01/70  1 1970-01-01 70 1970 Jan 00 12 001  0 12 01 00 AM 12:00:00 AM 00:00 00 00:00:00 4 00 01 4 00 70 1970 %",
+    "Thu Jan  1 00:00:00 1970|01/01/70|00:00:00|\n|\t" },
+  { { 59, 59, 23, 31, 11, 99, 5, 364 },
+    "Fri Friday Dec December 19 31 12/31/99 31 1999-12-31 99 1999 Dec 23 11 365 23 11 12 59 PM 11:59:59 PM 23:59 59 23:59:59 5 52 52 5 52 99 1999 %",
+    "Fri Dec 31 23:59:59 1999|12/31/99|23:59:59|\n|\t" },
+  { { 0, 0, 12, 29, 1, 100, 2, 59 },
+    "Tue Tuesday Feb February 20 29 02/29/00 29 2000-02-29 00 2000 Feb 12 12 060 12 12 02 00 PM 12:00:00 PM 12:00 00 12:00:00 2 09 09 2 09 00 2000 %",
+    "Tue Feb 29 12:00:00 2000|02/29/00|12:00:00|\n|\t" },
+  { { 9, 5, 13, 31, 11, 104, 5, 365 },
+    "Fri Friday Dec December 20 31 12/31/04 31 2004-12-31 04 2004 Dec 13 01 366 13  1 12 05 PM 01:05:09 PM 13:05 09 13:05:09 5 52 53 5 52 04 2004 %",
+    "Fri Dec 31 13:05:09 2004|12/31/04|13:05:09|\n|\t" },
+  { { 0, 30, 1, 2, 0, 105, 0, 1 },
+    "Sun Sunday Jan January 20 02 01/02/05  2 2005-01-02 04 2004 Jan 01 01 002  1  1 01 30 AM 01:30:00 AM 01:30 00 01:30:00 7 01 53 0 00 05 2005 %",
+    "Sun Jan  2 01:30:00 2005|01/02/05|01:30:00|\n|\t" },
+  { { 59, 59, 11, 29, 11, 108, 1, 363 },
+    "Mon Monday Dec December 20 29 12/29/08 29 2008-12-29 09 2009 Dec 11 11 364 11 11 12 59 AM 11:59:59 AM 11:59 59 11:59:59 1 52 01 1 52 08 2008 %",
+    "Mon Dec 29 11:59:59 2008|12/29/08|11:59:59|\n|\t" },
+  { { 7, 8, 9, 3, 0, 110, 0, 2 },
+    "Sun Sunday Jan January 20 03 01/03/10  3 2010-01-03 09 2009 Jan 09 09 003  9  9 01 08 AM 09:08:07 AM 09:08 07 09:08:07 7 01 53 0 00 10 2010 %",
+    "Sun Jan  3 09:08:07 2010|01/03/10|09:08:07|\n|\t" },
+  { { 0, 59, 12, 1, 0, 112, 0, 0 },
+    "Sun Sunday Jan January 20 01 01/01/12  1 2012-01-01 11 2011 Jan 12 12 001 12 12 01 59 PM 12:59:00 PM 12:59 00 12:59:00 7 01 52 0 00 12 2012 %",
+    "Sun Jan  1 12:59:00 2012|01/01/12|12:59:00|\n|\t" },
+  { { 1, 0, 20, 3, 0, 121, 0, 2 },
+    "Sun Sunday Jan January 20 03 01/03/21  3 2021-01-03 20 2020 Jan 20 08 003 20  8 01 00 PM 08:00:01 PM 20:00 01 20:00:01 7 01 53 0 00 21 2021 %",
+    "Sun Jan  3 20:00:01 2021|01/03/21|20:00:01|\n|\t" },
+  { { 30, 59, 0, 30, 11, 124, 1, 364 },
+    "Mon Monday Dec December 20 30 12/30/24 30 2024-12-30 25 2025 Dec 00 12 365  0 12 12 59 AM 12:59:30 AM 00:59 30 00:59:30 1 52 01 1 53 24 2024 %",
+    "Mon Dec 30 00:59:30 2024|12/30/24|00:59:30|\n|\t" },
+  { { 0, 0, 6, 1, 2, 200, 1, 59 },
+    "Mon Monday Mar March 21 01 03/01/00  1 2100-03-01 00 2100 Mar 06 06 060  6  6 03 00 AM 06:00:00 AM 06:00 00 06:00:00 1 09 09 1 09 00 2100 %",
+    "Mon Mar  1 06:00:00 2100|03/01/00|06:00:00|\n|\t" },
+  { { 0, 0, 0, 1, 0, -900, 3, 0 },
+    "Wed Wednesday Jan January 10 01 01/01/00  1 1000-01-01 00 1000 Jan 00 12 001  0 12 01 00 AM 12:00:00 AM 00:00 00 00:00:00 3 00 01 3 00 00 1000 %",
+    "Wed Jan  1 00:00:00 1000|01/01/00|00:00:00|\n|\t" },
+  { { 3, 45, 17, 15, 5, -317, 3, 165 },
+    "Wed Wednesday Jun June 15 15 06/15/83 15 1583-06-15 83 1583 Jun 17 05 166 17  5 06 45 PM 05:45:03 PM 17:45 03 17:45:03 3 24 24 3 24 83 1583 %",
+    "Wed Jun 15 17:45:03 1583|06/15/83|17:45:03|\n|\t" },
+  { { 59, 59, 23, 31, 11, 8099, 5, 364 },
+    "Fri Friday Dec December 99 31 12/31/99 31 9999-12-31 99 9999 Dec 23 11 365 23 11 12 59 PM 11:59:59 PM 23:59 59 23:59:59 5 52 52 5 52 99 9999 %",
+    "Fri Dec 31 23:59:59 9999|12/31/99|23:59:59|\n|\t" },
+  { { 52, 45, 20, 13, 11, 1, 5, 346 },
+    "Fri Friday Dec December 19 13 12/13/01 13 1901-12-13 01 1901 Dec 20 08 347 20  8 12 45 PM 08:45:52 PM 20:45 52 20:45:52 5 49 50 5 49 01 1901 %",
+    "Fri Dec 13 20:45:52 1901|12/13/01|20:45:52|\n|\t" },
+  { { 8, 14, 3, 19, 0, 138, 2, 18 },
+    "Tue Tuesday Jan January 20 19 01/19/38 19 2038-01-19 38 2038 Jan 03 03 019  3  3 01 14 AM 03:14:08 AM 03:14 08 03:14:08 2 03 03 2 03 38 2038 %",
+    "Tue Jan 19 03:14:08 2038|01/19/38|03:14:08|\n|\t" },
+};
+#define NKNOWN (sizeof known / sizeof known[0])
+
+/* Format TM with FORMAT, as char and as wide characters, and compare with
+   EXPECT, or if it is NULL, compare the two.  */
+static void
+check_format (const char *format, const struct tm *tm, const char *expect)
+{
+  char buf[256], own[256];
+  wchar_t wbuf[256], wformat[128];
+  size_t len, n, i;
+
+  n = strftime (buf, sizeof buf, format, tm);
+  if (expect == NULL)
+    expect = strcpy (own, buf);
+  len = strlen (expect);
+  CHECK (n == len);
+  CHECK (strcmp (buf, expect) == 0);
+  CHECK (strftime (buf, len + 1, format, tm) == len);
+  CHECK (strncmp (buf, expect, len) == 0);
+  CHECK (len == 0 || strftime (buf, len, format, tm) == 0);
+
+  CHECK (mbstowcs (wformat, format, 128) == strlen (format));
+  CHECK (wcsftime (wbuf, 256, wformat, tm) == len);
+  for (i = 0; i <= len; ++i)
+    CHECK (wbuf[i] == (unsigned char) expect[i]);
+  CHECK (wcsftime (wbuf, len + 1, wformat, tm) == len);
+  CHECK (len == 0 || wcsftime (wbuf, len, wformat, tm) == 0);
+}
+
+static void
+set_tm (struct tm *tm, const int *f)
+{
+  memset (tm, 0, sizeof *tm);
+  tm->tm_sec = f[0];
+  tm->tm_min = f[1];
+  tm->tm_hour = f[2];
+  tm->tm_mday = f[3];
+  tm->tm_mon = f[4];
+  tm->tm_year = f[5];
+  tm->tm_wday = f[6];
+  tm->tm_yday = f[7];
+}
+
+static void
+test_known (void)
+{
+  char format[4] = "%";
+  struct tm tm;
+  unsigned int k;
+  const char *p;
+
+  for (k = 0; k < NKNOWN; ++k)
+    {
+      set_tm (&tm, known[k].tm);
+      check_format (all, &tm, known[k].all);
+      check_format (all2, &tm, known[k].all2);
+      /* Each conversion alone, for the buffer lengths.  */
+      for (p = all; *p != '\0'; ++p)
+	if (*p == '%')
+	  {
+	    format[1] = *++p;
+	    check_format (format, &tm, NULL);
+	  }
+      for (p = all2; *p != '\0'; ++p)
+	if (*p == '%')
+	  {
+	    format[1] = *++p;
+	    check_format (format, &tm, NULL);
+	  }
+    }
+}
+
+static int
+is_leap (long y)
+{
+  return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+/* Days from 1970-01-01 to the start of year Y.  */
+static long
+days_to_year (long y)
+{
+  --y;
+  return (y - 1969) * 365 + y / 4 - y / 100 + y / 400 - (1969 / 4 - 1969 / 100
+							  + 1969 / 400);
+}
+
+/* Weeks in ISO 8601 year Y: 53 if it starts on a Thursday, or on a
+   Wednesday in a leap year.  */
+static int
+iso_weeks (long y)
+{
+  int jan1 = (int) (((days_to_year (y) + 4) % 7 + 7) % 7);
+
+  return jan1 == 4 || (jan1 == 3 && is_leap (y)) ? 53 : 52;
+}
+
+/* The year and week conversions of random dates from 1000 to 9999.  */
+static void
+test_weeks (void)
+{
+  static const int month_days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30,
+				    31, 30, 31 };
+  unsigned int seed = 1, k;
+  char expect[64];
+  struct tm tm;
+  long y, g;
+  int m, v, wday, yday, iwday;
+
+  memset (&tm, 0, sizeof tm);
+  for (k = 0; k < 100000; ++k)
+    {
+      y = 1000 + rand_r (&seed) % 9000;
+      yday = rand_r (&seed) % (365 + is_leap (y));
+      wday = (int) (((days_to_year (y) + yday + 4) % 7 + 7) % 7);
+      iwday = wday == 0 ? 7 : wday;
+
+      tm.tm_year = (int) (y - 1900);
+      tm.tm_yday = yday;
+      tm.tm_wday = wday;
+      for (m = 0, v = yday; v >= month_days[m] + (m == 1 && is_leap (y)); ++m)
+	v -= month_days[m] + (m == 1 && is_leap (y));
+      tm.tm_mon = m;
+      tm.tm_mday = v + 1;
+
+      /* The ISO 8601 week has the year's first Thursday in week 1.  */
+      g = y;
+      v = (yday + 1 - iwday + 10) / 7;
+      if (v < 1)
+	v = iso_weeks (--g);
+      else if (v > iso_weeks (y))
+	{
+	  v = 1;
+	  ++g;
+	}
+      snprintf (expect, sizeof expect,
+		"%ld %02ld %02ld %03d %d %d %02d %02d %ld %02ld %02d",
+		y, y / 100, y % 100, yday + 1, iwday, wday,
+		(yday + 7 - wday) / 7, (yday + 7 - (wday + 6) % 7) / 7,
+		g, g % 100, v);
+      check_format ("%Y %C %y %j %u %w %U %W %G %g %V", &tm, expect);
+    }
+}
+
+/* The numeric conversions that take a field as it is, with the
+   snprintf format that gives what they must give for any value.  */
+static const struct
+{
+  const char *format, *printf_format;
+  size_t offset;
+  int add;
+} fields[] =
+{
+  { "%d", "%.2d", offsetof (struct tm, tm_mday), 0 },
+  { "%e", "%2d", offsetof (struct tm, tm_mday), 0 },
+  { "%H", "%.2d", offsetof (struct tm, tm_hour), 0 },
+  { "%k", "%2d", offsetof (struct tm, tm_hour), 0 },
+  { "%j", "%.3d", offsetof (struct tm, tm_yday), 1 },
+  { "%m", "%.2d", offsetof (struct tm, tm_mon), 1 },
+  { "%M", "%.2d", offsetof (struct tm, tm_min), 0 },
+  { "%S", "%.2d", offsetof (struct tm, tm_sec), 0 },
+};
+#define NFIELDS (sizeof fields / sizeof fields[0])
+
+static void
+test_fields (void)
+{
+  char expect[64];
+  unsigned int f;
+  struct tm tm;
+  int v;
+
+  memset (&tm, 0, sizeof tm);
+  for (f = 0; f < NFIELDS; ++f)
+    for (v = -1500; v <= 1500; ++v)
+      {
+	*(int *) ((char *) &tm + fields[f].offset) = v;
+	snprintf (expect, sizeof expect, fields[f].printf_format,
+		  v + fields[f].add);
+	check_format (fields[f].format, &tm, expect);
+	*(int *) ((char *) &tm + fields[f].offset) = 0;
+      }
+}
+
+int
+main (void)
+{
+  test_known ();
+  test_weeks ();
+  test_fields ();
+  exit (0);
+}
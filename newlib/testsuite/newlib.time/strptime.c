@@ -0,0 +1,243 @@
+/*
+ * Check strptime in the "C" locale: what strftime writes for dates from
+ * 1970 to 9999 must read back, names in any case, the days week numbers
+ * give, and numbers as strtol reads them.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+#define P_DATE 1	/* sets tm_year, tm_mon, tm_mday, tm_yday, tm_wday */
+#define P_TIME 2	/* sets tm_hour, tm_min, tm_sec */
+#define P_YY 4		/* only from 1970 to 2068, as %y has no century */
+
+/* Formats strptime reads back what strftime writes with.  */
+static const struct
+{
+  const char *format;
+  int sets;
+} formats[] =
+{
+  { "%Y-%m-%dT%H:%M:%S", P_DATE | P_TIME },
+  { "[%d/%b/%Y:%H:%M:%S]", P_DATE | P_TIME },
+  { "%c", P_DATE | P_TIME },
+  { "%A, %d %B %Y %T", P_DATE | P_TIME },
+  { "%x %X", P_DATE | P_TIME | P_YY },
+  { "%D %R:%S", P_DATE | P_TIME | P_YY },
+  { "%j %Y %k %M %S", P_DATE | P_TIME },
+};
+#define NFORMATS (sizeof formats / sizeof formats[0])
+
+static int
+is_leap (int y)
+{
+  return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+/* Parse BUF with FORMAT and check that it all is read and gives what
+   EXPECT has in the fields the format sets.  */
+static void
+check_parse (const char *buf, const char *format, int sets,
+	     const struct tm *expect)
+{
+  struct tm tm;
+  char *end;
+
+  memset (&tm, 0, sizeof tm);
+  end = strptime (buf, format, &tm);
+  CHECK (end != NULL && *end == '\0');
+  if (sets & P_DATE)
+    {
+      CHECK (tm.tm_year == expect->tm_year);
+      CHECK (tm.tm_mon == expect->tm_mon);
+      CHECK (tm.tm_mday == expect->tm_mday);
+      CHECK (tm.tm_yday == expect->tm_yday);
+      CHECK (tm.tm_wday == expect->tm_wday);
+    }
+  if (sets & P_TIME)
+    {
+      CHECK (tm.tm_hour == expect->tm_hour);
+      CHECK (tm.tm_min == expect->tm_min);
+      CHECK (tm.tm_sec == expect->tm_sec);
+    }
+}
+
+/* Random dates and times, every fourth from 1970 to 2068.  */
+static void
+test_round_trip (void)
+{
+  static const int month_days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30,
+				    31, 30, 31 };
+  unsigned int seed = 2, k, f;
+  char buf[256];
+  struct tm tm;
+  int y, m, d, wday;
+
+  memset (&tm, 0, sizeof tm);
+  /* The weekday of January 1st, 1970.  */
+  wday = 4;
+  for (y = 1970, k = 0; k < 20000; ++k)
+    {
+      /* Walk through the years, keeping the weekday of January 1st.  */
+      int next = 1970 + rand_r (&seed) % (k % 4 == 0 ? 99 : 8030);
+
+      for (; y < next; ++y)
+	wday = (wday + 365 + is_leap (y)) % 7;
+      for (; y > next; --y)
+	wday = (wday + 7 * 53 - 365 - is_leap (y - 1)) % 7;
+
+      tm.tm_year = y - 1900;
+      tm.tm_yday = rand_r (&seed) % (365 + is_leap (y));
+      tm.tm_wday = (wday + tm.tm_yday) % 7;
+      for (m = 0, d = tm.tm_yday; d >= month_days[m] + (m == 1 && is_leap (y));
+	   ++m)
+	d -= month_days[m] + (m == 1 && is_leap (y));
+      tm.tm_mon = m;
+      tm.tm_mday = d + 1;
+      tm.tm_hour = rand_r (&seed) % 24;
+      tm.tm_min = rand_r (&seed) % 60;
+      tm.tm_sec = rand_r (&seed) % 60;
+
+      for (f = 0; f < NFORMATS; ++f)
+	{
+	  if ((formats[f].sets & P_YY) && y > 2068)
+	    continue;
+	  CHECK (strftime (buf, sizeof buf, formats[f].format, &tm) != 0);
+	  check_parse (buf, formats[f].format, formats[f].sets, &tm);
+	}
+    }
+}
+
+/* Names in any case, and where a name ends the input that follows.
+   Most names differ in their first character, but Sunday and Saturday,
+   or January, June and July, only in later ones.  */
+static void
+test_names (void)
+{
+  static const char *const days[] =
+  {
+    "Sunday", "MONDAY", "tuesday", "wEdNeSdAy", "Thursday", "Friday",
+    "Saturday"
+  };
+  static const char *const months[] =
+  {
+    "January", "february", "MARCH", "April", "May", "June", "July",
+    "August", "September", "OCTOBER", "November", "December"
+  };
+  char buf[32];
+  struct tm tm;
+  char *end;
+  int i;
+
+  for (i = 0; i < 7; ++i)
+    {
+      end = strptime (days[i], "%A", &tm);
+      CHECK (end != NULL && *end == '\0' && tm.tm_wday == i);
+      snprintf (buf, sizeof buf, "%.3s!", days[i]);
+      end = strptime (buf, "%a", &tm);
+      CHECK (end != NULL && *end == '!' && tm.tm_wday == i);
+      end = strptime (days[i], "%a", &tm);
+      CHECK (end == days[i] + 3 && tm.tm_wday == i);
+    }
+  for (i = 0; i < 12; ++i)
+    {
+      end = strptime (months[i], "%B", &tm);
+      CHECK (end != NULL && *end == '\0' && tm.tm_mon == i);
+      end = strptime (months[i], "%h", &tm);
+      CHECK (end == months[i] + 3 && tm.tm_mon == i);
+    }
+  end = strptime ("12 pm", "%I %p", &tm);
+  CHECK (end != NULL && *end == '\0' && tm.tm_hour == 12);
+  end = strptime ("12 AM", "%I %p", &tm);
+  CHECK (end != NULL && *end == '\0' && tm.tm_hour == 0);
+  end = strptime ("1 Pm", "%l %p", &tm);
+  CHECK (end != NULL && *end == '\0' && tm.tm_hour == 13);
+}
+
+/* %U, %W and %V count from the weekday of January 1st, which strptime
+   takes as Thursday before 1970, and the day they give is that many
+   weeks and days from it, or January 1st if that is before it.  */
+static void
+test_weeks (void)
+{
+  static const int weeks[] = { 0, 1, 2, 26, 52, 53 };
+  static const char *const formats[] =
+  {
+    "%Y %w %U", "%Y %w %W", "%Y %w %V"
+  };
+  char buf[32];
+  struct tm tm;
+  int year, fday = 4, mday, w, wday, yday, expect_wday;
+
+  for (year = 1900; year <= 9999; ++year)
+    {
+      if (year > 1970)
+	fday = (fday + 365 + is_leap (year - 1)) % 7;
+      mday = (fday + 6) % 7;		/* counted from Monday */
+      for (w = 0; w < 6; ++w)
+	for (wday = 0; wday < 7; ++wday)
+	  {
+	    snprintf (buf, sizeof buf, "%d %d %d", year, wday, weeks[w]);
+
+	    yday = weeks[w] * 7 + wday - fday;
+	    expect_wday = yday < 0 ? fday : wday;
+	    CHECK (strptime (buf, formats[0], &tm) != NULL);
+	    CHECK (tm.tm_yday == (yday < 0 ? 0 : yday));
+	    CHECK (tm.tm_wday == expect_wday);
+
+	    yday = weeks[w] * 7 + (wday + 6) % 7 - mday;
+	    expect_wday = yday < 0 ? (mday + 1) % 7 : wday;
+	    CHECK (strptime (buf, formats[1], &tm) != NULL);
+	    CHECK (tm.tm_yday == (yday < 0 ? 0 : yday));
+	    CHECK (tm.tm_wday == expect_wday);
+
+	    yday = (mday < 4 ? 7 : 0) + (weeks[w] - 1) * 7 + wday - mday;
+	    expect_wday = yday < 0 ? mday : wday;
+	    CHECK (strptime (buf, formats[2], &tm) != NULL);
+	    CHECK (tm.tm_yday == (yday < 0 ? 0 : yday));
+	    CHECK (tm.tm_wday == expect_wday);
+	  }
+    }
+}
+
+/* Numbers as strtol reads them, short runs of digits, with spaces or
+   a sign before them, or too long for an int.  */
+static void
+test_numbers (void)
+{
+  static const char *const prefixes[] = { "", "0", "00000", " ", "\t +", "-" };
+  char buf[32], *end, *expect_end;
+  struct tm tm;
+  long expect;
+  unsigned int p;
+  int v;
+
+  for (p = 0; p < sizeof prefixes / sizeof prefixes[0]; ++p)
+    for (v = 0; v <= 1000000; v = v < 100 ? v + 1 : v * 3 + 1)
+      {
+	snprintf (buf, sizeof buf, "%s%d:", prefixes[p], v);
+	expect = strtol (buf, &expect_end, 10);
+	end = strptime (buf, "%Y", &tm);
+	CHECK (end == expect_end);
+	CHECK (tm.tm_year == expect - 1900);
+      }
+  end = strptime ("2147483647 ", "%Y", &tm);
+  CHECK (end != NULL && *end == ' ' && tm.tm_year == 2147483647 - 1900);
+  end = strptime (":", "%Y", &tm);
+  CHECK (end == NULL);
+}
+
+int
+main (void)
+{
+  test_round_trip ();
+  test_names ();
+  test_weeks ();
+  test_numbers ();
+  exit (0);
+}
@@ -0,0 +1,69 @@
+/*
+ * Check that localtime_r and mktime convert in the zone TZ has when they
+ * are called, also when it was changed without calling tzset, so that
+ * what tzset kept of the zone before is not used.  The last zone is too
+ * long for tzset to keep a table of its changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+static const char *const zones[] =
+{
+  "AAA5BBB,M3.2.0,M11.1.0",
+  "EEE-10FFF,M10.1.0,M4.1.0/3",
+  "KKK-5:45",
+  "NNNNNNNNNN+06:00:00OOOOOOOOOO+05:00:00,M4.1.0/02:00:00,M10.5.0/02:00:00",
+};
+#define NZONES (sizeof zones / sizeof zones[0])
+#define NTIMES 64
+
+static struct tm local[NZONES][NTIMES];
+
+static time_t
+time_of (int i)
+{
+  return (time_t) i * 33554393 + 1234;
+}
+
+int
+main (void)
+{
+  unsigned int z, prev;
+  struct tm tm;
+  time_t t;
+  int i;
+
+  for (z = 0; z < NZONES; ++z)
+    {
+      setenv ("TZ", zones[z], 1);
+      tzset ();
+      for (i = 0; i < NTIMES; ++i)
+	{
+	  t = time_of (i);
+	  CHECK (localtime_r (&t, &local[z][i]) != NULL);
+	}
+    }
+
+  /* Each zone after each other one, without tzset.  */
+  for (prev = 0; prev < NZONES; ++prev)
+    for (z = 0; z < NZONES; ++z)
+      {
+	setenv ("TZ", zones[prev], 1);
+	tzset ();
+	setenv ("TZ", zones[z], 1);
+	for (i = 0; i < NTIMES; ++i)
+	  {
+	    t = time_of (i);
+	    CHECK (localtime_r (&t, &tm) != NULL);
+	    CHECK (memcmp (&tm, &local[z][i], sizeof tm) == 0);
+	    CHECK (mktime (&tm) == t);
+	    CHECK (memcmp (&tm, &local[z][i], sizeof tm) == 0);
+	  }
+      }
+
+  exit (0);
+}
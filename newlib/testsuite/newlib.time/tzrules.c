@@ -0,0 +1,205 @@
+/*
+ * Check localtime_r and mktime with TZ rules in each of the forms POSIX
+ * has, north and south of the equator and with offsets that are not whole
+ * hours: every result must have the offset of the zone for its tm_isdst,
+ * the changes must fall on the times the rules give, and mktime must
+ * convert each result back, as it is and with its fields out of range.
+ * Without rules, gmtime_r and mktime must convert times up to 9900 years
+ * either side of 1970 where time_t has 64 bits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+struct zone
+{
+  const char *tz;
+  long std, dst;		/* seconds east of UTC */
+  /* Times at which tm_isdst changes, in 1971, 2037, 2100 and 2200, with
+     tm_isdst and the hour and minute just before each of them, and the
+     hour and minute at it.  */
+  struct
+  {
+    long long t;
+    int isdst0, hour0, min0, hour1, min1;
+  } changes[8];
+};
+
+static const struct zone zones[] =
+{
+  { "UTC0", 0, 0, { { 0 } } },
+  { "KKK-5:45", 20700, 20700, { { 0 } } },
+  { "AAA5BBB,M3.2.0,M11.1.0", -18000, -14400,
+    { { 37782000LL, 0, 1, 59, 3, 0 }, { 58341600LL, 1, 1, 59, 1, 0 },
+      { 2120108400LL, 0, 1, 59, 3, 0 }, { 2140668000LL, 1, 1, 59, 1, 0 },
+      { 4108690800LL, 0, 1, 59, 3, 0 }, { 4129250400LL, 1, 1, 59, 1, 0 },
+      { 7263932400LL, 0, 1, 59, 3, 0 }, { 7284492000LL, 1, 1, 59, 1, 0 } } },
+  { "CCC-1DDD,M3.5.0,M10.5.0/3", 3600, 7200,
+    { { 38970000LL, 0, 1, 59, 3, 0 }, { 57718800LL, 1, 2, 59, 2, 0 },
+      { 2121901200LL, 0, 1, 59, 3, 0 }, { 2140045200LL, 1, 2, 59, 2, 0 },
+      { 4109878800LL, 0, 1, 59, 3, 0 }, { 4128627600LL, 1, 2, 59, 2, 0 },
+      { 7265725200LL, 0, 1, 59, 3, 0 }, { 7283869200LL, 1, 2, 59, 2, 0 } } },
+  { "EEE-10FFF,M10.1.0,M4.1.0/3", 36000, 39600,
+    { { 39542400LL, 1, 2, 59, 2, 0 }, { 55267200LL, 0, 1, 59, 3, 0 },
+      { 2122473600LL, 1, 2, 59, 2, 0 }, { 2138198400LL, 0, 1, 59, 3, 0 },
+      { 4110451200LL, 1, 2, 59, 2, 0 }, { 4126176000LL, 0, 1, 59, 3, 0 },
+      { 7266297600LL, 1, 2, 59, 2, 0 }, { 7282022400LL, 0, 1, 59, 3, 0 } } },
+  { "GGG3HHH,J60/2,J300/2", -10800, -7200,
+    { { 36651600LL, 0, 1, 59, 3, 0 }, { 57384000LL, 1, 1, 59, 1, 0 },
+      { 2119496400LL, 0, 1, 59, 3, 0 }, { 2140228800LL, 1, 1, 59, 1, 0 },
+      { 4107560400LL, 0, 1, 59, 3, 0 }, { 4128292800LL, 1, 1, 59, 1, 0 },
+      { 7263234000LL, 0, 1, 59, 3, 0 }, { 7283966400LL, 1, 1, 59, 1, 0 } } },
+  { "III-2JJJ-3,100/1:30,280/4", 7200, 10800,
+    { { 40174200LL, 0, 1, 29, 2, 30 }, { 55731600LL, 1, 3, 59, 3, 0 },
+      { 2123019000LL, 0, 1, 29, 2, 30 }, { 2138576400LL, 1, 3, 59, 3, 0 },
+      { 4111083000LL, 0, 1, 29, 2, 30 }, { 4126640400LL, 1, 3, 59, 3, 0 },
+      { 7266756600LL, 0, 1, 29, 2, 30 }, { 7282314000LL, 1, 3, 59, 3, 0 } } },
+  { "LLL3:30MMM2:30,M3.2.0/2:30,M11.1.0/1:30", -12600, -9000,
+    { { 37778400LL, 0, 2, 29, 3, 30 }, { 58334400LL, 1, 1, 29, 0, 30 },
+      { 2120104800LL, 0, 2, 29, 3, 30 }, { 2140660800LL, 1, 1, 29, 0, 30 },
+      { 4108687200LL, 0, 2, 29, 3, 30 }, { 4129243200LL, 1, 1, 29, 0, 30 },
+      { 7263928800LL, 0, 2, 29, 3, 30 }, { 7284484800LL, 1, 1, 29, 0, 30 } } },
+};
+#define NZONES (sizeof zones / sizeof zones[0])
+
+/* Whether T fits time_t.  */
+static int
+fits (long long t)
+{
+  return (long long) (time_t) t == t;
+}
+
+/* Days from 1970-01-01 to year Y (since 1900), month M and day D.  */
+static long long
+days_from_civil (long long y, int m, int d)
+{
+  long long era;
+  int yoe, doy;
+
+  y += 1900;
+  if (m < 2)
+    --y;
+  era = (y >= 0 ? y : y - 399) / 400;
+  yoe = (int) (y - era * 400);
+  doy = (153 * (m + (m > 1 ? -2 : 10)) + 2) / 5 + d - 1;
+  return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+/* TM as seconds since the epoch, taking it as UTC, and check the weekday
+   and the day of the year.  */
+static long long
+utc_of (const struct tm *tm)
+{
+  long long days = days_from_civil (tm->tm_year, tm->tm_mon, tm->tm_mday);
+  int wday = (int) (((days + 4) % 7 + 7) % 7);
+
+  CHECK (tm->tm_wday == wday);
+  CHECK (tm->tm_yday
+	 == (int) (days - days_from_civil (tm->tm_year, 0, 1)));
+  return days * 86400 + tm->tm_hour * 3600 + tm->tm_min * 60 + tm->tm_sec;
+}
+
+static int
+same_tm (const struct tm *a, const struct tm *b)
+{
+  return a->tm_sec == b->tm_sec && a->tm_min == b->tm_min
+	 && a->tm_hour == b->tm_hour && a->tm_mday == b->tm_mday
+	 && a->tm_mon == b->tm_mon && a->tm_year == b->tm_year
+	 && a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday
+	 && a->tm_isdst == b->tm_isdst;
+}
+
+/* Convert T in zone Z, check the offset and convert back, once as it is
+   and once with the fields out of range.  */
+static void
+check_time (const struct zone *z, time_t t, struct tm *tm)
+{
+  struct tm denorm;
+
+  CHECK (localtime_r (&t, tm) != NULL);
+  CHECK (utc_of (tm) - t == (tm->tm_isdst > 0 ? z->dst : z->std));
+
+  denorm = *tm;
+  CHECK (mktime (&denorm) == t);
+  CHECK (same_tm (&denorm, tm));
+
+  denorm = *tm;
+  denorm.tm_mday += 400;
+  denorm.tm_hour -= 400 * 24 - 30;
+  denorm.tm_min -= 30 * 60;
+  denorm.tm_mon += 24;
+  denorm.tm_year -= 2;
+  CHECK (mktime (&denorm) == t);
+  CHECK (same_tm (&denorm, tm));
+}
+
+static void
+check_zone (const struct zone *z)
+{
+  long long t, end = 7258118400LL;	/* 2200-01-01 */
+  struct tm tm;
+  int i;
+
+  setenv ("TZ", z->tz, 1);
+  tzset ();
+
+  for (t = 0; t < end && fits (t); t += 1000003)
+    check_time (z, (time_t) t, &tm);
+
+  for (i = 0; i < 8 && z->changes[i].t != 0; ++i)
+    {
+      t = z->changes[i].t;
+      if (!fits (t))
+	continue;
+      check_time (z, (time_t) (t - 1), &tm);
+      CHECK (tm.tm_hour == z->changes[i].hour0);
+      CHECK (tm.tm_min == z->changes[i].min0);
+      CHECK (tm.tm_sec == 59);
+      CHECK (tm.tm_isdst == z->changes[i].isdst0);
+      check_time (z, (time_t) t, &tm);
+      CHECK (tm.tm_hour == z->changes[i].hour1);
+      CHECK (tm.tm_min == z->changes[i].min1);
+      CHECK (tm.tm_sec == 0);
+      CHECK (tm.tm_isdst == !z->changes[i].isdst0);
+    }
+}
+
+/* Without rules, all years convert, up to where tm_year fits mktime.  */
+static void
+check_years (void)
+{
+  struct tm tm, tm2;
+  long long t;
+  time_t t2;
+  long k;
+
+  setenv ("TZ", "UTC0", 1);
+  tzset ();
+  for (k = -5000; k <= 5000; ++k)
+    {
+      t = k * 62591113LL + 41;		/* up to 9900 years either way */
+      if (!fits (t))
+	continue;
+      t2 = (time_t) t;
+      CHECK (gmtime_r (&t2, &tm) != NULL);
+      CHECK (utc_of (&tm) == t);
+      CHECK (tm.tm_isdst == 0);
+      tm2 = tm;
+      CHECK (mktime (&tm2) == t2);
+      CHECK (same_tm (&tm2, &tm));
+    }
+}
+
+int
+main (void)
+{
+  unsigned int z;
+
+  for (z = 0; z < NZONES; ++z)
+    check_zone (&zones[z]);
+  check_years ();
+  exit (0);
+}
@@ -0,0 +1,163 @@
+/*
+ * Threads converting times with localtime_r and mktime while TZ keeps
+ * changing between four zones, the last too long for tzset to keep a
+ * table of its changes, with tzset called after every other change.
+ * Each result must be that of the zone TZ had when the call started, or,
+ * if TZ changed during the call, that of one of the four.  TZ is changed
+ * by pointing environ at another environment, which readers see whole.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "check.h"
+
+extern char **environ;
+
+static char *envs[][2] =
+{
+  { "TZ=AAA5BBB,M3.2.0,M11.1.0", NULL },
+  { "TZ=EEE-10FFF,M10.1.0,M4.1.0/3", NULL },
+  { "TZ=KKK-5:45", NULL },
+  { "TZ=NNNNNNNNNN+06:00:00OOOOOOOOOO+05:00:00,M4.1.0/02:00:00,"
+    "M10.5.0/02:00:00", NULL },
+};
+#define NZONES (sizeof envs / sizeof envs[0])
+#define NTIMES 256
+#define NTHREADS 4
+
+static time_t times[NTIMES];
+/* localtime_r of each time in each zone, and mktime of each of those
+   in each zone, with the time it gives.  */
+static struct tm local[NZONES][NTIMES];
+static struct tm mk[NZONES][NZONES][NTIMES];
+static time_t mk_time[NZONES][NZONES][NTIMES];
+
+/* Odd while TZ is being changed, and otherwise twice the number of
+   changes, the last of which set it to envs[changes % NZONES].  */
+static unsigned long gen;
+static volatile int stop;
+static int failed;
+
+static void
+set_zone (unsigned int z)
+{
+  __atomic_store_n (&environ, envs[z], __ATOMIC_SEQ_CST);
+}
+
+static int
+same_tm (const struct tm *a, const struct tm *b)
+{
+  return a->tm_sec == b->tm_sec && a->tm_min == b->tm_min
+	 && a->tm_hour == b->tm_hour && a->tm_mday == b->tm_mday
+	 && a->tm_mon == b->tm_mon && a->tm_year == b->tm_year
+	 && a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday
+	 && a->tm_isdst == b->tm_isdst;
+}
+
+/* Whether a conversion of time I that started with gen G and gave TM,
+   and T if EXPECT_T is not NULL, converted in one of the zones as
+   EXPECT and EXPECT_T have it, and in that of G if TZ did not change
+   meanwhile.  */
+static int
+converted_ok (unsigned long g, const struct tm *tm, time_t t,
+	      struct tm (*expect)[NTIMES], time_t (*expect_t)[NTIMES],
+	      unsigned int i)
+{
+  unsigned int z = 0, last = NZONES - 1;
+
+  if (!(g & 1) && __atomic_load_n (&gen, __ATOMIC_SEQ_CST) == g)
+    z = last = g / 2 % NZONES;
+  for (; z <= last; ++z)
+    if (same_tm (tm, &expect[z][i])
+	&& (expect_t == NULL || t == expect_t[z][i]))
+      return 1;
+  return 0;
+}
+
+static void *
+reader (void *arg)
+{
+  unsigned long n = 0, g;
+  unsigned int i = (unsigned long) arg * 97, z;
+  struct tm tm;
+  time_t t;
+
+  while (!stop)
+    {
+      i = (i + 1) % NTIMES;
+
+      g = __atomic_load_n (&gen, __ATOMIC_SEQ_CST);
+      localtime_r (&times[i], &tm);
+      if (!converted_ok (g, &tm, 0, local, NULL, i))
+	__atomic_store_n (&failed, 1, __ATOMIC_RELAXED);
+
+      z = n % NZONES;
+      tm = local[z][i];
+      g = __atomic_load_n (&gen, __ATOMIC_SEQ_CST);
+      t = mktime (&tm);
+      if (!converted_ok (g, &tm, t, mk[z], mk_time[z], i))
+	__atomic_store_n (&failed, 1, __ATOMIC_RELAXED);
+      ++n;
+    }
+  return (void *) n;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  /* Up to 2119 where time_t has 64 bits, beyond the years tzset keeps
+     the changes of.  */
+  time_t step = sizeof (time_t) > 4 ? 18486022 : 8388593;
+  unsigned long i, changes = 0;
+  unsigned int z, zz;
+  void *n;
+  time_t t0;
+
+  for (i = 0; i < NTIMES; ++i)
+    times[i] = i * step + 1234;
+  for (z = 0; z < NZONES; ++z)
+    {
+      set_zone (z);
+      tzset ();
+      for (i = 0; i < NTIMES; ++i)
+	CHECK (localtime_r (&times[i], &local[z][i]) != NULL);
+    }
+  for (zz = 0; zz < NZONES; ++zz)
+    {
+      set_zone (zz);
+      tzset ();
+      for (z = 0; z < NZONES; ++z)
+	for (i = 0; i < NTIMES; ++i)
+	  {
+	    mk[z][zz][i] = local[z][i];
+	    mk_time[z][zz][i] = mktime (&mk[z][zz][i]);
+	  }
+    }
+
+  set_zone (0);
+  for (i = 0; i < NTHREADS; ++i)
+    CHECK (pthread_create (&threads[i], NULL, reader, (void *) i) == 0);
+  t0 = time (NULL);
+  while (time (NULL) - t0 < 2)
+    {
+      ++changes;
+      __atomic_store_n (&gen, 2 * changes - 1, __ATOMIC_SEQ_CST);
+      set_zone (changes % NZONES);
+      __atomic_store_n (&gen, 2 * changes, __ATOMIC_SEQ_CST);
+      if (changes & 1)
+	tzset ();
+    }
+  stop = 1;
+  for (i = 0; i < NTHREADS; ++i)
+    {
+      CHECK (pthread_join (threads[i], &n) == 0);
+      CHECK (n != NULL);
+    }
+  CHECK (!failed);
+
+  exit (0);
+}
@@ -291,14 +291,17 @@ is_leap_year (int year)
   return (year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0);
 }
 
+/* Number of leap years from year 1 up to and including year. */
+#define LEAPS_THRU(year) ((year) / 4 - (year) / 100 + (year) / 400)
+
+/* Weekday of January 1st of year, or Thursday for years before 1970. */
 static int
 first_day (int year)
 {
-  int ret = 4;
-
-  while (--year >= 1970)
-    ret = (ret + 365 + is_leap_year (year)) % 7;
-  return ret;
+  if (year <= 1970)
+    return 4;
+  /* 365 % 7 == 1, so each year moves the weekday by 1, leap years by 2. */
+  return (4 + (year - 1970) + LEAPS_THRU (year - 1) - LEAPS_THRU (1969)) % 7;
 }
 
 /* This simplifies the calls to conv_num enormously. */
@@ -850,10 +853,15 @@ find_string(const unsigned char *bp, int *tgt, const char * const *n1,
 {
 	int i;
 	unsigned int len;
+	int ch = tolower_l(*bp, locale);
 
 	/* check full name - then abbreviated ones */
 	for (; n1 != NULL; n1 = n2, n2 = NULL) {
 		for (i = 0; i < c; i++, n1++) {
+			/* Most names already differ in the first character. */
+			if (**n1 != '\0'
+			    && tolower_l((unsigned char) **n1, locale) != ch)
+				continue;
 			len = strlen(*n1);
 			if (strncasecmp_l(*n1, (const char *)bp, len,
 					  locale) == 0) {